@@ -534,6 +534,9 @@ struct AsmSingleVReg // key for regvar
     /// not equal operator
     bool operator!=(const AsmSingleVReg& r2) const
     { return regVar == r2.regVar && index == r2.index; }
+    /// less operator
+    bool operator<(const AsmSingleVReg& r2) const
+    { return regVar < r2.regVar || (regVar == r2.regVar && index < r2.index); }
 };
 
 /// regvar map
@@ -608,6 +611,55 @@ struct AsmCodeFlowEntry
     AsmCodeFlowType type;   ///< type of code flow entry
 };
 
+enum : cxbyte
+{
+    ASMSCHED_BARRIER = 1,   ///< instruction can not be moved (splits code block)
+    ASMSCHED_FLOW = 2,      ///< barrier that changes code flow or depends on position
+    ASMSCHED_MEMORY = 4,    ///< memory operation (ordered by ASMSCHEDMEM_* and counters)
+    ASMSCHED_STOP = 8       ///< disables scheduling in whole section
+};
+
+/// memory access flags for scheduler
+enum : cxbyte
+{
+    ASMSCHEDMEM_GLOBAL = 1, ///< accesses global memory (by scalar or vector unit)
+    ASMSCHEDMEM_LOCAL = 2,  ///< accesses local memory (LDS, GDS)
+    ASMSCHEDMEM_EXPORT = 4, ///< writes to export
+    ASMSCHEDMEM_STORE = 8   ///< writes memory (store or atomic)
+};
+
+/// instruction info for scheduler
+struct AsmInstrSchedInfo
+{
+    cxuint size;    ///< instruction size in bytes
+    cxbyte flags;   ///< scheduling flags (ASMSCHED_*)
+    cxbyte memFlags;    ///< memory access flags (ASMSCHEDMEM_*)
+    /// bit mask of wait counters used by memory operation
+    /** memory operations that use same counter keep their order */
+    cxbyte waitCounters;
+    cxuint issueCycles; ///< cycles to issue instruction
+    cxuint latency; ///< cycles until result is available
+    cxuint implicitRegsNum; ///< number of implicit register usages
+    AsmRegUsage2Int implicitRegs[4];    ///< implicit register usages
+};
+
+/// scratch buffer for spilled vector registers (set by '.spillscratch')
+struct AsmSpillScratch
+{
+    bool enabled;   ///< true if scratch buffer is set
+    uint16_t srsrc; ///< first SGPR of buffer resource (4 SGPRs)
+    uint16_t soffset;   ///< SGPR with offset of wave in buffer
+    uint32_t offset;    ///< offset of first spill slot in buffer
+};
+
+/// spilled register (stored to or reloaded from spill slot)
+struct AsmSpill
+{
+    cxuint regType;     ///< register type
+    uint16_t reg;       ///< register (index in register ranges)
+    uint32_t slot;      ///< spill slot
+};
+
 /// assembler macro map
 typedef std::unordered_map<CString, RefPtr<const AsmMacro> > AsmMacroMap;
 
@@ -700,6 +752,11 @@ struct AsmKernel
     const char* name;   ///< name of kernel
     AsmSourcePos sourcePos; ///< source position of definition
     std::vector<std::pair<size_t, size_t> > codeRegions; ///< code regions
+    cxuint occupancy;   ///< target occupancy for register allocation (0 - not set)
+    AsmSourcePos occupancyPos;  ///< source position of '.occupancy'
+    AsmSpillScratch spillScratch;   ///< scratch buffer for spilled registers
+    /// numbers of registers used by register allocator (include spill registers)
+    cxuint usedRegsNums[MAX_REGTYPES_NUM];
     
     /// open kernel region in code
     void openCodeRegion(size_t offset);
@@ -53,15 +53,22 @@ enum: Flags
     ASM_BUGGYFPLIT = 8, ///< buggy handling of fpliterals (including fp constants)
     ASM_MACRONOCASE = 16, /// disable case-insensitive naming (default)
     ASM_OLDMODPARAM = 32,   ///< use old modifier parametrization (values 0 and 1 only)
+    ASM_SCHEDULE = 64,  ///< schedule instructions in code blocks
+    ASM_TIMEREPORT = 128,   ///< collect times of assembler phases and counters
     ASM_TESTRESOLVE = (1U<<30), ///< enable resolving symbols if ASM_TESTRUN enabled
     ASM_TESTRUN = (1U<<31), ///< only for running tests
     ASM_ALL = FLAGS_ALL&~(ASM_TESTRUN|ASM_TESTRESOLVE|ASM_BUGGYFPLIT|ASM_MACRONOCASE|
-                    ASM_OLDMODPARAM)  ///< all flags
+                    ASM_OLDMODPARAM|ASM_SCHEDULE|ASM_TIMEREPORT)  ///< all flags
 };
 
 struct AsmRegVar;
+struct GCNEncodingEntry;
 
 /// ISA (register and regvar) Usage handler
+/**
+ * Sparse index holds read positions of first instruction in every code chunk,
+ * hence seek to any offset reads only small part of usages.
+ */
 class ISAUsageHandler
 {
 public:
@@ -74,13 +81,17 @@ public:
         size_t regUsages2Pos;   ///< position in regUsage2
         size_t regVarUsagesPos;    ///< position in regVarUsage
         uint16_t pushedArgs;    ///< pushed argds number
+        cxbyte argPos;          ///< argument position
         bool useRegMode;        ///< true if in usereg mode
     };
+    /// shift of code chunk size in sparse index of read positions
+    static const cxuint usageIndexShift = 9;
 protected:
     std::vector<cxbyte> instrStruct;    ///< structure of register usage
     std::vector<AsmRegUsageInt> regUsages;  ///< register usage
     std::vector<AsmRegUsage2Int> regUsages2;  ///< register usage (by .usereg)
     std::vector<AsmRegVarUsageInt> regVarUsages;    ///< regvar usage
+    std::vector<ReadPos> usageIndex;    ///< read positions of code chunks (from second)
     const std::vector<cxbyte>& content; ///< code content
     size_t lastOffset;  ///< last offset
     size_t readOffset;  ///< read offset
@@ -118,12 +129,14 @@ public:
     { return isNext; }
     /// get next usage
     AsmRegVarUsage nextUsage();
+    /// set reading position to first usage at or after code offset
+    void seekTo(size_t offset);
     
     /// get reading position
     ReadPos getReadPos() const
     {
         return { readOffset, instrStructPos, regUsagesPos, regUsages2Pos,
-            regVarUsagesPos, pushedArgs, useRegMode };
+            regVarUsagesPos, pushedArgs, argPos, useRegMode };
     }
     /// set reading position
     void setReadPos(const ReadPos rpos)
@@ -134,12 +147,20 @@ public:
         regUsages2Pos = rpos.regUsages2Pos;
         regVarUsagesPos = rpos.regVarUsagesPos;
         pushedArgs = rpos.pushedArgs;
+        argPos = rpos.argPos;
         useRegMode = rpos.useRegMode;
+        isNext = (instrStructPos < instrStruct.size());
     }
     
     /// push regvar or register from usereg pseudo-op
     void pushUseRegUsage(const AsmRegVarUsage& rvu);
     
+    /// move usages of instructions to new offsets (used by scheduler)
+    /**
+     * \param moves pairs of old and new offset of instruction, sorted by old offset
+     */
+    void moveInstructions(const std::vector<std::pair<size_t, size_t> >& moves);
+    
     /// get RW flags (used by assembler)
     virtual cxbyte getRwFlags(AsmRegField regField, uint16_t rstart,
                       uint16_t rend) const = 0;
@@ -149,6 +170,9 @@ public:
     /// get usage dependencies around single instruction
     virtual void getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage* rvus,
                     cxbyte* linearDeps, cxbyte* equalToDeps) const = 0;
+    /// set first register in register field of instruction (used by register allocator)
+    virtual void setRegStart(cxbyte* code, AsmRegField regField,
+                    uint16_t rstart) const = 0;
 };
 
 /// GCN (register and regvar) Usage handler
@@ -169,6 +193,7 @@ public:
     std::pair<uint16_t,uint16_t> getRegPair(AsmRegField regField, cxbyte rwFlags) const;
     void getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage* rvus,
                     cxbyte* linearDeps, cxbyte* equalToDeps) const;
+    void setRegStart(cxbyte* code, AsmRegField regField, uint16_t rstart) const;
 };
 
 /// ISA assembler class
@@ -229,6 +254,26 @@ public:
                        const char* end, cxuint& type) = 0;
     /// get size of instruction
     virtual size_t getInstructionSize(size_t codeSize, const cxbyte* code) const = 0;
+    /// get instruction info for scheduler (returns false if no instruction)
+    virtual bool getInstrSchedInfo(size_t codeSize, const cxbyte* code,
+                AsmInstrSchedInfo& info) const = 0;
+    /// put code that stores spilled registers to spill slots or reloads them
+    /**
+     * \param store true if registers will be stored, false if they will be reloaded
+     * \param waitForMemory wait for memory operations before storing
+     * \param spillsNum number of spilled registers
+     * \param spills spilled registers
+     * \param laneRegStart first vector register that holds spilled scalar registers
+     * \param scratch scratch buffer for spilled vector registers
+     * \param output output code
+     * \return number of put instructions
+     */
+    virtual cxuint putSpillCode(bool store, bool waitForMemory, size_t spillsNum,
+                const AsmSpill* spills, cxuint laneRegStart,
+                const AsmSpillScratch& scratch, std::vector<cxbyte>& output) const = 0;
+    /// update target of branch after moving code (returns false if not encoded)
+    virtual bool moveBranchTarget(cxbyte* code, size_t oldOffset, size_t oldTarget,
+                size_t offset, size_t target) const = 0;
 };
 
 /// GCN arch assembler
@@ -248,6 +293,7 @@ private:
         cxuint regTable[2];
     };
     uint16_t curArchMask;
+    const GCNEncodingEntry* encTable;   // encoding table for current architecture
     cxbyte currentRVUIndex;
     AsmRegVarUsage instrRVUs[6];
     
@@ -293,6 +339,210 @@ public:
     bool relocationIsFit(cxuint bits, AsmExprTargetType tgtType);
     bool parseRegisterType(const char*& linePtr, const char* end, cxuint& type);
     size_t getInstructionSize(size_t codeSize, const cxbyte* code) const;
+    bool getInstrSchedInfo(size_t codeSize, const cxbyte* code,
+                AsmInstrSchedInfo& info) const;
+    cxuint putSpillCode(bool store, bool waitForMemory, size_t spillsNum,
+                const AsmSpill* spills, cxuint laneRegStart,
+                const AsmSpillScratch& scratch, std::vector<cxbyte>& output) const;
+    bool moveBranchTarget(cxbyte* code, size_t oldOffset, size_t oldTarget,
+                size_t offset, size_t target) const;
+};
+
+/// interference graph (used by register allocator)
+/** graph is built from cliques (sets of nodes that interfere each other).
+ * small graphs are stored as symmetric bit matrix (with summary of nonzero words
+ * of every row), greater graphs as sorted adjacency lists in compressed sparse
+ * row (CSR) form */
+class AsmInterGraph
+{
+public:
+    /// max number of nodes for bit matrix form (row summary must fit in 64 bits)
+    static const size_t bitMatrixMaxNodes = 4096;
+    
+    /// group of nodes that must have consecutive colors (register range)
+    struct ColorGroup
+    {
+        std::vector<std::pair<size_t, cxuint> > nodes; ///< node and its position
+        std::vector<std::pair<cxuint, cxuint> > aligns; ///< position and its alignment
+    };
+
+    /// neighbor iterator
+    class NeighborIterator
+    {
+    private:
+        const AsmInterGraph* graph;
+        size_t node;
+        size_t pos;
+
+        // find next set bit in row of node (from pos), skip zero words by summary
+        void skipToNeighbor()
+        {
+            const uint64_t* row = graph->bitMatrix.data() + node*graph->rowWords;
+            size_t w = pos>>6;
+            if (w < graph->rowWords)
+            {
+                const uint64_t word = row[w] & (~0ULL << (pos&63));
+                if (word != 0)
+                {
+                    pos = (w<<6) + CTZ64(word);
+                    return;
+                }
+                const uint64_t summary = (w < 63) ?
+                        graph->rowSummaries[node] & (~0ULL << (w+1)) : 0;
+                if (summary != 0)
+                {
+                    w = CTZ64(summary);
+                    pos = (w<<6) + CTZ64(row[w]);
+                    return;
+                }
+            }
+            pos = graph->nodesNum;
+        }
+    public:
+        /// constructor
+        NeighborIterator(const AsmInterGraph* _graph, size_t _node, size_t _pos)
+                : graph(_graph), node(_node), pos(_pos)
+        {
+            if (graph->bitMatrixMode)
+                skipToNeighbor();
+        }
+        /// get neighbor
+        size_t operator*() const
+        { return graph->bitMatrixMode ? pos : graph->adjacency[pos]; }
+        /// go to next neighbor
+        NeighborIterator& operator++()
+        {
+            pos++;
+            if (graph->bitMatrixMode)
+                skipToNeighbor();
+            return *this;
+        }
+        /// equal to
+        bool operator==(const NeighborIterator& it) const
+        { return pos == it.pos; }
+        /// not equal to
+        bool operator!=(const NeighborIterator& it) const
+        { return pos != it.pos; }
+    };
+
+    /// neighbors of node
+    class Neighbors
+    {
+    private:
+        const AsmInterGraph* graph;
+        size_t node;
+    public:
+        /// constructor
+        Neighbors(const AsmInterGraph* _graph, size_t _node)
+                : graph(_graph), node(_node)
+        { }
+        /// first neighbor
+        NeighborIterator begin() const
+        { return NeighborIterator(graph, node, graph->bitMatrixMode ? 0 :
+                    graph->adjOffsets[node]); }
+        /// end of neighbors
+        NeighborIterator end() const
+        { return NeighborIterator(graph, node, graph->bitMatrixMode ? graph->nodesNum :
+                    graph->adjOffsets[node+1]); }
+        /// number of neighbors
+        size_t size() const
+        { return graph->degrees[node]; }
+    };
+private:
+    size_t nodesNum;
+    bool bitMatrixMode;
+    size_t rowWords;    // number of words of bit matrix row
+    std::vector<cxuint> degrees;
+    std::vector<uint64_t> bitMatrix;
+    std::vector<uint64_t> rowSummaries; // bit per nonzero word of bit matrix row
+    std::vector<size_t> adjOffsets;
+    std::vector<cxuint> adjacency;
+    // cliques (only while building graph)
+    std::vector<size_t> cliqueOffsets;
+    std::vector<cxuint> cliqueNodes;
+
+    bool bitMatrixTest(size_t a, size_t b) const
+    { return (bitMatrix[a*rowWords + (b>>6)] & (1ULL<<(b&63))) != 0; }
+    // set bit in row and update row summary
+    void bitMatrixSet(size_t a, size_t b)
+    {
+        bitMatrix[a*rowWords + (b>>6)] |= 1ULL<<(b&63);
+        rowSummaries[a] |= 1ULL<<(b>>6);
+    }
+public:
+    /// constructor
+    AsmInterGraph() : nodesNum(0), bitMatrixMode(true), rowWords(0)
+    { }
+
+    /// clear graph and set number of nodes (start building)
+    void resize(size_t nodesNum);
+    /// clear graph
+    void clear()
+    { resize(0); }
+    /// add clique (all nodes interfere each other), only while building
+    void addClique(const std::vector<size_t>& nodes);
+    /// finish building graph
+    void finish();
+
+    /// get number of nodes
+    size_t size() const
+    { return nodesNum; }
+    /// return true if graph in bit matrix form
+    bool isBitMatrix() const
+    { return bitMatrixMode; }
+    /// get degree of node
+    size_t degree(size_t node) const
+    { return degrees[node]; }
+    /// get neighbors of node
+    Neighbors operator[](size_t node) const
+    { return Neighbors(this, node); }
+    /// return true if nodes interfere
+    bool isEdge(size_t a, size_t b) const;
+    /// get memory usage in bytes
+    size_t getMemoryUsage() const;
+    /// get number of edges
+    size_t edgesNum() const;
+
+    /// color graph (DSatur algorithm)
+    /**
+     * \param colors colors of nodes (UINT_MAX - not colored yet)
+     * \param maxColorsNum maximal number of colors
+     * \param equalSetList list of sets of nodes that must have same color
+     * \param equalSetMap map of node to index of its equal set
+     * \param groups groups of nodes that must have consecutive colors
+     * \return number of used colors
+     */
+    cxuint color(Array<cxuint>& colors, cxuint maxColorsNum,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<ColorGroup>& groups = std::vector<ColorGroup>()) const;
+};
+
+/// register allocation mode
+enum class AsmRegAllocMode: cxbyte
+{
+    GRAPH_COLORING = 0, ///< coloring of interference graph (default)
+    LINEAR_SCAN     ///< linear scan over live intervals (fast for huge kernels)
+};
+
+/// statistics of register allocation passes (times in seconds)
+struct AsmRegAllocStats
+{
+    cxuint sectionId;           ///< section id
+    AsmRegAllocMode mode;       ///< allocation mode
+    cxuint regTypesNum;         ///< number of register types
+    double codeStructureTime;   ///< time of createCodeStructure
+    double ssaDataTime;         ///< time of createSSAData
+    double ssaReplacesTime;     ///< time of applySSAReplaces
+    double livenessesTime;      ///< time of createLivenesses
+    double interGraphTimes[MAX_REGTYPES_NUM];   ///< time of createInterferenceGraph
+    double colorTimes[MAX_REGTYPES_NUM];    ///< time of coloring (or linear scan)
+    double totalTime;           ///< time of whole allocation
+    size_t codeBlocksNum;       ///< number of code blocks
+    size_t ssaValuesNums[MAX_REGTYPES_NUM];  ///< number of SSA values (variables)
+    size_t graphNodesNums[MAX_REGTYPES_NUM];    ///< number of interference graph nodes
+    size_t graphEdgesNums[MAX_REGTYPES_NUM];    ///< number of interference graph edges
+    cxuint colorsNums[MAX_REGTYPES_NUM];     ///< number of used colors (registers)
 };
 
 class AsmRegAllocator
@@ -317,10 +567,13 @@ public:
                 size_t _ssaId = SIZE_MAX, size_t _ssaIdL = SIZE_MAX,
                 size_t _ssaIdChange = 0, bool _readBeforeWrite = false)
             : ssaIdBefore(_bssaId), ssaIdFirst(_ssaIdF), ssaId(_ssaId),
-              ssaIdLast(_ssaIdL), ssaIdChange(_ssaIdChange),
+              ssaIdLast(_ssaIdL), ssaIdChange(_ssaIdChange), firstPos(0), lastPos(0),
               readBeforeWrite(_readBeforeWrite)
         { }
     };
+    /// SSA infos of code block (array map sorted by regvar)
+    typedef std::vector<std::pair<AsmSingleVReg, SSAInfo> > SSAInfoMap;
+    
     struct CodeBlock
     {
         size_t start, end; // place in code
@@ -328,16 +581,15 @@ public:
         bool haveCalls;
         bool haveReturn;
         bool haveEnd;
-        // key - regvar, value - SSA info for this regvar
-        std::unordered_map<AsmSingleVReg, SSAInfo> ssaInfoMap;
-        ISAUsageHandler::ReadPos usagePos;
+        // key - regvar, value - SSA info for this regvar (sorted by regvar)
+        SSAInfoMap ssaInfoMap;
     };
     
      // first - orig ssaid, second - dest ssaid
     typedef std::pair<size_t, size_t> SSAReplace;
     typedef std::unordered_map<AsmSingleVReg, std::vector<SSAReplace> > SSAReplacesMap;
     // interference graph type
-    typedef Array<std::unordered_set<size_t> > InterGraph;
+    typedef AsmInterGraph InterGraph;
     typedef std::unordered_map<AsmSingleVReg, std::vector<size_t> > VarIndexMap;
     struct LinearDep
     {
@@ -350,35 +602,240 @@ public:
         std::vector<size_t> prevVidxes;
         std::vector<size_t> nextVidxes;
     };
+    /// live block of variable (range in code)
+    struct LiveBlock
+    {
+        size_t start;
+        size_t end;
+        size_t vidx;
+        
+        bool operator==(const LiveBlock& b) const
+        { return start==b.start && end==b.end && vidx==b.vidx; }
+        
+        bool operator<(const LiveBlock& b) const
+        { return start<b.start || (start==b.start &&
+                (end<b.end || (end==b.end && vidx<b.vidx))); }
+    };
 private:
+    /// usage of regvar in instruction (to set allocated registers and to spill)
+    struct VarUsage
+    {
+        size_t offset;      ///< offset of instruction
+        size_t liveTime;    ///< live time of instruction
+        size_t vidx;        ///< variable index of first register
+        AsmRegField regField;   ///< register field
+        cxbyte rwFlags;     ///< read-write flags
+        uint16_t regsNum;   ///< number of registers
+    };
+    /// reload or store of spilled variable around instruction
+    struct VarSpill
+    {
+        size_t offset;      ///< offset of instruction
+        size_t vidx;        ///< temporary variable that holds value
+        uint32_t slot;      ///< spill slot
+        bool store;         ///< true if store after instruction, false if reload
+    };
+    
     Assembler& assembler;
+    AsmRegAllocMode mode;
     std::vector<CodeBlock> codeBlocks;
     SSAReplacesMap ssaReplacesMap;
     size_t regTypesNum;
     
     VarIndexMap vregIndexMaps[MAX_REGTYPES_NUM]; // indices to igraph for 2 reg types
+    size_t vregsCounts[MAX_REGTYPES_NUM];
+    // live blocks sorted by start
+    std::vector<LiveBlock> liveBlocks[MAX_REGTYPES_NUM];
     InterGraph interGraphs[MAX_REGTYPES_NUM]; // for 2 register 
     Array<cxuint> graphColorMaps[MAX_REGTYPES_NUM];
     std::unordered_map<size_t, LinearDep> linearDepMaps[MAX_REGTYPES_NUM];
     std::unordered_map<size_t, EqualToDep> equalToDepMaps[MAX_REGTYPES_NUM];
     std::unordered_map<size_t, size_t> equalSetMaps[MAX_REGTYPES_NUM];
     std::vector<std::vector<size_t> > equalSetLists[MAX_REGTYPES_NUM];
+    cxuint usedRegsNums[MAX_REGTYPES_NUM];
+    std::vector<VarUsage> varUsages[MAX_REGTYPES_NUM];
+    std::vector<VarSpill> varSpills[MAX_REGTYPES_NUM];
+    size_t spilledVarsNums[MAX_REGTYPES_NUM];
+    size_t tempVarsStarts[MAX_REGTYPES_NUM];    // first temporary variable of spills
+    size_t spillInstrsNum;
+    cxuint laneRegStart;    // first vector register that holds spilled scalar registers
+    AsmSpillScratch spillScratch;
+    cxuint sectionId;
+    bool allocated;
+    cxuint occupancy;
+    cxuint achievedOccupancy;
+    cxuint threadsNum;
+    bool timePasses;
+    AsmRegAllocStats stats;
+    
+    bool isParallelByRegTypes() const;
+    void createInterferenceGraph(size_t regType);
+    cxuint colorInterferenceGraph(size_t regType, cxuint maxColorsNum);
+    cxuint allocateLinearScan(size_t regType, cxuint maxRegsNum);
+    void allocateRegType(size_t regType, cxuint maxRegsNum);
+    void reserveSpillScratch();
+    size_t spillVariables(size_t regType, cxuint targetRegsNum);
+    void allocateRegTypeWithSpills(size_t regType, cxuint maxRegsNum);
+    void allocateForBudgets(const cxuint* regsBudgets, cxuint wavesNum);
 public:
-    AsmRegAllocator(Assembler& assembler);
+    /// constructor (mode from '.regalloc' pseudo-op)
+    explicit AsmRegAllocator(Assembler& assembler);
+    /// constructor
+    AsmRegAllocator(Assembler& assembler, AsmRegAllocMode mode);
     
     void createCodeStructure(const std::vector<AsmCodeFlowEntry>& codeFlow,
              size_t codeSize, const cxbyte* code);
     void createSSAData(ISAUsageHandler& usageHandler);
     void applySSAReplaces();
-    void createInterferenceGraph(ISAUsageHandler& usageHandler);
+    void createLivenesses(ISAUsageHandler& usageHandler);
+    void createInterferenceGraph();
     void colorInterferenceGraph();
+    /// allocate registers by linear scan (instead graph coloring)
+    void allocateLinearScan();
     
     void allocateRegisters(cxuint sectionId);
     
+    /// allocate registers for many sections concurrently
+    /**
+     * \param sectionsNum number of sections
+     * \param regAllocs register allocators (one per section, must be distinct)
+     * \param sectionIds section ids (must be distinct)
+     * \param threadsNum number of threads (0 - number of hardware threads)
+     *
+     * Results are same as results of sequential allocation. If allocation of any
+     * section fails, then exception from first failed section is rethrown.
+     */
+    static void allocateRegisters(size_t sectionsNum, AsmRegAllocator** regAllocs,
+            const cxuint* sectionIds, cxuint threadsNum = 0);
+    
+    /// apply allocation to section: set registers in code and insert spill code
+    /**
+     * Spill code changes offsets of instructions, hence symbols, relocations,
+     * code flow, branches and code regions of kernels are updated. Kernels get
+     * numbers of used registers.
+     */
+    void applyAllocation();
+    /// return true if registers have been allocated
+    bool isAllocated() const
+    { return allocated; }
+    
+    /// get number of threads (0 - number of hardware threads)
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set number of threads used to allocate register types concurrently
+    /** 0 - number of hardware threads, 1 - sequential allocation */
+    void setThreadsNum(cxuint _threadsNum)
+    { threadsNum = _threadsNum; }
+    
+    /// return true if timing of passes and statistics are enabled
+    bool isTimePasses() const
+    { return timePasses; }
+    /// enable timing of passes and statistics (times are zero if HAVE_TIME_PASSES
+    /// is not defined)
+    void setTimePasses(bool _timePasses)
+    { timePasses = _timePasses; }
+    /// get statistics of passes (after allocation with enabled timing)
+    const AsmRegAllocStats& getStats() const
+    { return stats; }
+    /// print statistics of passes in '--time-passes' style
+    void printTimePasses(std::ostream& os) const
+    { printStats(os, stats); }
+    /// print register allocation statistics in '--time-passes' style
+    static void printStats(std::ostream& os, const AsmRegAllocStats& stats);
+    
+    /// get target occupancy (0 - from '.occupancy' pseudo-op)
+    cxuint getOccupancy() const
+    { return occupancy; }
+    /// set target occupancy (waves per SIMD, 0 - from '.occupancy' pseudo-op)
+    void setOccupancy(cxuint wavesNum)
+    { occupancy = wavesNum; }
+    /// get achieved occupancy (waves per SIMD, after allocation)
+    cxuint getAchievedOccupancy() const
+    { return achievedOccupancy; }
+    
+    /// get register allocation mode
+    AsmRegAllocMode getMode() const
+    { return mode; }
+    /// set register allocation mode
+    void setMode(AsmRegAllocMode _mode)
+    { mode = _mode; }
+    
+    /// get number of used registers of specified type (after allocation)
+    /** number of vector registers includes registers for spilled scalar registers */
+    cxuint getUsedRegsNum(cxuint regType) const
+    { return usedRegsNums[regType]; }
+    /// get number of spilled variables of specified type (after allocation)
+    size_t getSpilledVarsNum(cxuint regType) const
+    { return spilledVarsNums[regType]; }
+    /// get number of inserted spill instructions (after applying allocation)
+    size_t getSpillInstrsNum() const
+    { return spillInstrsNum; }
+    
     const std::vector<CodeBlock>& getCodeBlocks() const
     { return codeBlocks; }
     const SSAReplacesMap& getSSAReplacesMap() const
     { return ssaReplacesMap; }
+    const VarIndexMap* getVregIndexMaps() const
+    { return vregIndexMaps; }
+    const InterGraph* getInterGraphs() const
+    { return interGraphs; }
+    const Array<cxuint>* getGraphColorMaps() const
+    { return graphColorMaps; }
+    const std::vector<LiveBlock>* getLiveBlocks() const
+    { return liveBlocks; }
+    const std::unordered_map<size_t, LinearDep>* getLinearDepMaps() const
+    { return linearDepMaps; }
+    const std::unordered_map<size_t, EqualToDep>* getEqualToDepMaps() const
+    { return equalToDepMaps; }
+};
+
+/// scheduling statistics for single section
+struct AsmScheduleStats
+{
+    cxuint sectionId;   ///< section id
+    size_t blocksNum;   ///< number of code blocks
+    size_t scheduledBlocksNum;  ///< number of rescheduled code blocks
+    size_t instrsNum;   ///< number of instructions in code blocks
+    size_t movedInstrsNum;  ///< number of moved instructions
+    uint64_t stallCyclesBefore; ///< estimated stall cycles before scheduling
+    uint64_t stallCyclesAfter;  ///< estimated stall cycles after scheduling
+};
+
+/// report of assembler phases (times in seconds) and counters
+/** times are zero if HAVE_TIME_PASSES is not defined or ASM_TIMEREPORT is not set.
+ * time of pseudo-ops includes reading bodies of macros and repetitions */
+struct AsmTimeReport
+{
+    double inputTime;       ///< time of reading lines from source files
+    double macroTime;       ///< time of reading lines from macros and repetitions
+    double pseudoOpsTime;   ///< time of handling pseudo-ops
+    double encodingTime;    ///< time of encoding instructions
+    double symbolsTime;     ///< time of symbol assignments and final resolving
+    double schedulingTime;  ///< time of instruction scheduling
+    double regAllocTime;    ///< time of register allocation
+    double prepareBinaryTime;   ///< time of prepareBinary in format handler
+    double writeBinaryTime; ///< time of binary generation (writeBinary)
+    double totalTime;       ///< time of whole assembling (without writeBinary)
+    uint64_t linesNum;      ///< number of read lines
+    uint64_t instrsNum;     ///< number of assembled instructions
+    uint64_t pseudoOpsNum;  ///< number of handled pseudo-ops
+    uint64_t macroSubstsNum;    ///< number of macro substitutions
+    uint64_t repetitionsNum;    ///< number of iterations of repetitions
+    uint64_t expressionsNum;    ///< number of parsed expressions (except literals)
+    uint64_t relocationsNum;    ///< number of relocations
+};
+
+/// basic block instruction scheduler
+class AsmScheduler
+{
+private:
+    Assembler& assembler;
+public:
+    /// constructor
+    explicit AsmScheduler(Assembler& assembler);
+    
+    /// schedule instructions in code blocks of section
+    AsmScheduleStats schedule(cxuint sectionId);
 };
 
 /// type of clause
@@ -411,7 +868,9 @@ public:
 private:
     friend class AsmStreamInputFilter;
     friend class AsmMacroInputFilter;
+    friend class AsmRepeatInputFilter;
     friend class AsmForInputFilter;
+    friend class AsmIRPInputFilter;
     friend class AsmExpression;
     friend class AsmFormatHandler;
     friend class AsmRawCodeHandler;
@@ -421,6 +880,7 @@ private:
     friend class AsmROCmHandler;
     friend class ISAAssembler;
     friend class AsmRegAllocator;
+    friend class AsmScheduler;
     
     friend struct AsmParseUtils; // INTERNAL LOGIC
     friend struct AsmPseudoOps; // INTERNAL LOGIC
@@ -459,6 +919,20 @@ private:
     bool buggyFPLit;
     bool macroCase;
     bool oldModParam;
+    bool scheduling;
+    bool schedulingUsed;    // if scheduling enabled in any place
+    cxuint occupancy;   // global target occupancy for register allocation
+    AsmSourcePos occupancyPos;
+    AsmSpillScratch spillScratch;   // global scratch buffer for spilled registers
+    bool regAllocUsed;  // if register usages are collected for register allocation
+    AsmRegAllocMode regAllocMode;
+    std::vector<AsmScheduleStats> scheduleStats;
+    std::vector<AsmRegAllocStats> regAllocStats;
+    bool timeReporting;
+    // mutable, because writeBinary also measures own time
+    mutable AsmTimeReport timeReport;
+    // section and offset of all local labels (to split code blocks by scheduler)
+    std::vector<std::pair<cxuint, size_t> > localLabelOffsets;
     
     cxuint inclusionLevel;
     cxuint macroSubstLevel;
@@ -741,6 +1215,39 @@ public:
     /// get true if buggyFPLit enabled
     bool isBuggyFPLit() const
     { return buggyFPLit; }
+    /// get true if scheduling of instructions enabled
+    bool isScheduling() const
+    { return scheduling; }
+    /// get true if register usages are collected for register allocation
+    /** set by '.regvar' or '.occupancy' */
+    bool isRegAllocUsed() const
+    { return regAllocUsed; }
+    /// get scheduling statistics (filled after assembling)
+    const std::vector<AsmScheduleStats>& getScheduleStats() const
+    { return scheduleStats; }
+    /// get register allocation statistics of sections (filled after assembling)
+    /** pass times and counts are collected only if time report enabled */
+    const std::vector<AsmRegAllocStats>& getRegAllocStats() const
+    { return regAllocStats; }
+    /// get true if time report enabled (ASM_TIMEREPORT)
+    bool isTimeReporting() const
+    { return timeReporting; }
+    /// get time report (counters are always collected)
+    const AsmTimeReport& getTimeReport() const
+    { return timeReport; }
+    /// print time report in text form
+    void printTimeReport(std::ostream& os) const;
+    /// print time report in JSON form
+    void printTimeReportJSON(std::ostream& os) const;
+    /// get global target occupancy for register allocation (0 - not set)
+    cxuint getOccupancy() const
+    { return occupancy; }
+    /// get global scratch buffer for spilled registers (set by '.spillscratch')
+    const AsmSpillScratch& getSpillScratch() const
+    { return spillScratch; }
+    /// get register allocation mode (set by '.regalloc' pseudo-op)
+    AsmRegAllocMode getRegAllocMode() const
+    { return regAllocMode; }
     /// get include directory list
     const std::vector<CString>& getIncludeDirs() const
     { return includeDirs; }
@@ -24,6 +24,7 @@
 #define __CLRX_DISASSEMBLER_H__
 
 #include <CLRX/Config.h>
+#include <cstdint>
 #include <string>
 #include <istream>
 #include <ostream>
@@ -37,6 +38,7 @@
 #include <CLRX/amdbin/AmdBinGen.h>
 #include <CLRX/amdasm/Commons.h>
 #include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
 #include <CLRX/utils/InputOutput.h>
 
 /// main namespace
@@ -55,6 +57,265 @@ public:
     virtual ~DisasmException() noexcept = default;
 };
 
+/*
+ * disassembler output sinks
+ */
+
+/// disassembler output sink (receives output in chunks)
+class DisasmOutput: public NonCopyableAndNonMovable
+{
+public:
+    /// destructor
+    virtual ~DisasmOutput();
+
+    /// write chunk of output
+    virtual void write(size_t size, const char* data) = 0;
+    /// flush written output (default implementation does nothing)
+    virtual void flush();
+    
+    /// write single character
+    void put(char c)
+    { write(1, &c); }
+};
+
+/// disassembler output to growable memory buffer
+class DisasmMemoryOutput: public DisasmOutput
+{
+private:
+    std::vector<char> buffer;
+public:
+    /// constructor
+    /**
+     * \param initialCapacity initial capacity of buffer (presize)
+     */
+    explicit DisasmMemoryOutput(size_t initialCapacity = 0);
+    /// destructor
+    ~DisasmMemoryOutput();
+
+    /// write chunk of output
+    void write(size_t size, const char* data);
+
+    /// get size of output
+    size_t size() const
+    { return buffer.size(); }
+    /// get output data
+    const char* data() const
+    { return buffer.data(); }
+    /// get buffer
+    const std::vector<char>& getBuffer() const
+    { return buffer; }
+    /// get buffer
+    std::vector<char>& getBuffer()
+    { return buffer; }
+    /// clear buffer (capacity is retained)
+    void clear()
+    { buffer.clear(); }
+};
+
+/// disassembler output to file descriptor
+/** output is collected in buffer, big chunks are written directly */
+class DisasmFileOutput: public DisasmOutput
+{
+private:
+    int fd;
+    size_t bufSize;
+    size_t endPos;
+    std::unique_ptr<char[]> buffer;
+
+    void writeToFile(size_t size, const char* data);
+public:
+    /// default size of buffer
+    static const size_t defaultBufferSize = 0x10000;
+
+    /// constructor
+    /**
+     * \param fd file descriptor (is not closed by destructor)
+     * \param bufSize size of buffer (0 - write directly to file)
+     */
+    explicit DisasmFileOutput(int fd, size_t bufSize = defaultBufferSize);
+    /// destructor (writes rest of output to file)
+    ~DisasmFileOutput();
+
+    /// write chunk of output (throws Exception if failed)
+    void write(size_t size, const char* data);
+    /// write buffered output to file
+    void flush();
+
+    /// get file descriptor
+    int getFileDescriptor() const
+    { return fd; }
+};
+
+/// disassembler output callback (size of chunk, chunk, user data)
+typedef void (*DisasmOutputCallback)(size_t size, const char* data, void* userData);
+
+/// disassembler output that passes chunks to user callback
+class DisasmCallbackOutput: public DisasmOutput
+{
+private:
+    DisasmOutputCallback callback;
+    void* userData;
+public:
+    /// constructor
+    DisasmCallbackOutput(DisasmOutputCallback callback, void* userData = nullptr);
+    /// destructor
+    ~DisasmCallbackOutput();
+
+    /// write chunk of output
+    void write(size_t size, const char* data);
+};
+
+/// disassembler output to output stream
+/** used by disassembler constructors that take output stream */
+class DisasmStreamOutput: public DisasmOutput
+{
+private:
+    std::ostream& os;
+public:
+    /// constructor
+    explicit DisasmStreamOutput(std::ostream& os);
+    /// destructor
+    ~DisasmStreamOutput();
+
+    /// write chunk of output to output stream
+    void write(size_t size, const char* data);
+    /// flush output stream
+    void flush();
+
+    /// get output stream
+    std::ostream& getOStream() const
+    { return os; }
+};
+
+/// output buffer for ISA disassembler (collects instructions and writes them to sink)
+class DisasmOutputBuffer: public NonCopyableAndNonMovable
+{
+private:
+    DisasmOutput& sink;
+    cxuint endPos;
+    cxuint bufSize;
+    std::unique_ptr<char[]> buffer;
+public:
+    /// constructor
+    /**
+     * \param bufSize max buffer size
+     * \param sink output sink
+     */
+    DisasmOutputBuffer(cxuint _bufSize, DisasmOutput& _sink) : sink(_sink), endPos(0),
+            bufSize(_bufSize), buffer(new char[_bufSize])
+    { }
+    
+    /// get output sink
+    DisasmOutput& getOutput() const
+    { return sink; }
+    
+    /// write output buffer to sink
+    void flush()
+    {
+        if (endPos != 0)
+            sink.write(endPos, buffer.get());
+        endPos = 0;
+    }
+    
+    /// reserve and write out buffer if too few free bytes in buffer
+    char* reserve(cxuint toReserve)
+    {
+        if (toReserve > bufSize-endPos)
+            flush();
+        return buffer.get() + endPos;
+    }
+    
+    /// finish reservation and go forward
+    void forward(cxuint toWrite)
+    { endPos += toWrite; }
+    
+    /// write sequence of characters
+    void write(size_t length, const char* string)
+    {
+        if (length > bufSize-endPos)
+        {
+            flush();
+            sink.write(length, string);
+        }
+        else
+        {
+            ::memcpy(buffer.get()+endPos, string, length);
+            endPos += length;
+        }
+    }
+    
+    /// write string
+    void writeString(const char* string)
+    { write(::strlen(string), string); }
+    
+    /// put single character
+    void put(char c)
+    {
+        if (endPos == bufSize)
+            flush();
+        buffer[endPos++] = c;
+    }
+};
+
+/// stream buffer that collects output in buffer and writes it to output sink
+class DisasmOutputStreamBuf: public std::streambuf
+{
+private:
+    DisasmOutput& sink;
+    size_t bufSize;
+    std::unique_ptr<char[]> buffer;
+
+    void flushBuffer();
+public:
+    /// constructor
+    /**
+     * \param sink output sink
+     * \param bufSize size of buffer (0 - write directly to sink)
+     */
+    DisasmOutputStreamBuf(DisasmOutput& sink, size_t bufSize);
+    /// destructor (writes rest of output to sink)
+    ~DisasmOutputStreamBuf();
+
+    /// get output sink
+    DisasmOutput& getSink() const
+    { return sink; }
+    /// get buffer size
+    size_t getBufferSize() const
+    { return bufSize; }
+protected:
+    /// overflow implementation
+    int_type overflow(int_type ch);
+    /// xsputn implementation
+    std::streamsize xsputn(const char_type* s, std::streamsize n);
+    /// sync implementation
+    int sync();
+};
+
+/// output stream that writes to disassembler output sink
+/** for code that writes to std::ostream (disassembler takes sinks directly) */
+class DisasmOutputStream: public std::ostream
+{
+private:
+    DisasmOutputStreamBuf buffer;
+public:
+    /// default size of buffer
+    static const size_t defaultBufferSize = 0x10000;
+
+    /// constructor
+    /**
+     * \param sink output sink
+     * \param bufSize size of buffer (0 - write directly to sink)
+     */
+    explicit DisasmOutputStream(DisasmOutput& sink,
+                size_t bufSize = defaultBufferSize);
+    /// destructor
+    ~DisasmOutputStream();
+
+    /// get output sink
+    DisasmOutput& getSink() const
+    { return buffer.getSink(); }
+};
+
 class Disassembler;
 
 enum: Flags
@@ -70,9 +331,11 @@ enum: Flags
     DISASM_BUGGYFPLIT = 0x100,
     DISASM_CODEPOS = 0x200,   ///< print code position
     DISASM_HSACONFIG = 0x400,  ///< print HSA configuration
+    DISASM_JSON = 0x800,    ///< write JSON Lines records instead of assembler source
     
     ///< all disassembler flags (without config)
-    DISASM_ALL = FLAGS_ALL&(~(DISASM_CONFIG|DISASM_BUGGYFPLIT|DISASM_HSACONFIG))
+    DISASM_ALL = FLAGS_ALL&(~(DISASM_CONFIG|DISASM_BUGGYFPLIT|DISASM_HSACONFIG|
+                DISASM_JSON))
 };
 
 struct GCNDisasmUtils;
@@ -104,15 +367,22 @@ protected:
     size_t labelStartOffset; /// < start offset of labels
     size_t inputSize;   ///< size of input
     const cxbyte* input;    ///< input code
+    size_t sectionIndex;    ///< index of section (used by numbered labels)
     bool dontPrintLabelsAfterCode;
     std::vector<size_t> labels; ///< list of local labels
+    size_t labelBitmapStart;    ///< position of first word of label bitmap
+    size_t labelBitmapSize;     ///< number of words in label bitmap
+    std::vector<uint64_t> labelBitmap;  ///< local labels in code (bit per word)
     std::vector<std::pair<size_t, CString> > namedLabels;   ///< named labels
     std::vector<CString> relSymbols;    ///< symbols used by relocations
     std::vector<std::pair<size_t, Relocation> > relocations;    ///< relocations
-    FastOutputBuffer output;    ///< output buffer
+    DisasmOutputBuffer output;    ///< output buffer
     
     /// constructor
     explicit ISADisassembler(Disassembler& disassembler, cxuint outBufSize = 600);
+    /// constructor with own output sink
+    ISADisassembler(Disassembler& disassembler, DisasmOutput& output,
+                cxuint outBufSize = 600);
     
     /// write location in the code
     void writeLocation(size_t pos);
@@ -123,8 +393,9 @@ public:
     virtual ~ISADisassembler();
     
     /// write all labels before specified position
+    /** if onlyBefore is true, then labels at this position will not be written */
     void writeLabelsToPosition(size_t pos, LabelIter& labelIter,
-               NamedLabelIter& namedLabelIter);
+               NamedLabelIter& namedLabelIter, bool onlyBefore = false);
     /// write all labels to end
     void writeLabelsToEnd(size_t start, LabelIter labelIter, NamedLabelIter namedLabelIter);
     
@@ -141,6 +412,14 @@ public:
     void setDontPrintLabels(bool after)
     { dontPrintLabelsAfterCode = after; }
     
+    /// set section index (suffix of numbered labels)
+    void setSectionIndex(size_t index)
+    { sectionIndex = index; }
+    
+    /// create new disassembler for same ISA that writes to specified output
+    /** used to disassemble many codes in parallel */
+    virtual ISADisassembler* createInstance(DisasmOutput& output) const = 0;
+    
     /// analyze code before disassemblying
     virtual void analyzeBeforeDisassemble() = 0;
     
@@ -153,6 +432,21 @@ public:
     /// disassembles input code
     virtual void disassemble() = 0;
 
+    /// extend label bitmap to cover current input code
+    /** should be called by analyzeBeforeDisassemble before adding labels */
+    void extendLabelBitmap();
+    
+    /// add numbered label (must be called before disassembly)
+    /** labels at words of code are stored in bitmap, others in list */
+    void addLabel(size_t pos)
+    {
+        const size_t bytePos = pos - labelBitmapStart;
+        if ((bytePos&3) == 0 && (bytePos>>2) < labelBitmapSize)
+            labelBitmap[bytePos>>8] |= uint64_t(1)<<((bytePos>>2)&63);
+        else
+            labels.push_back(pos);
+    }
+    
     /// add named label to list (must be called before disassembly)
     void addNamedLabel(size_t pos, const CString& name)
     { namedLabels.push_back(std::make_pair(pos, name)); }
@@ -192,20 +486,183 @@ class GCNDisassembler: public ISADisassembler
 {
 private:
     bool instrOutOfCode;
+    cxuint threadsNum;
     
     friend struct GCNDisasmUtils; // INTERNAL LOGIC
+    
+    void disassembleRange(size_t start, size_t end);
 public:
     /// constructor
     GCNDisassembler(Disassembler& disassembler);
+    /// constructor with own output sink
+    GCNDisassembler(Disassembler& disassembler, DisasmOutput& output);
     /// destructor
     ~GCNDisassembler();
     
+    /// create new GCN disassembler that writes to specified output
+    ISADisassembler* createInstance(DisasmOutput& output) const;
+    
+    /// get threads number used to disassemble code in chunks
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set threads number used to disassemble code in chunks
+    /** 1 - sequential disassembling, 0 - use all hardware threads.
+     * large code is splitted into chunks that are disassembled in parallel,
+     * output is same as in sequential disassembling */
+    void setThreadsNum(cxuint threadsNum)
+    { this->threadsNum = threadsNum; }
+    
     /// analyze code before disassemblying
     void analyzeBeforeDisassemble();
     /// disassemble code
     void disassemble();
 };
 
+/// maximal number of operands of decoded GCN instruction
+static const cxuint GCNDecodedMaxOperands = 6;
+
+/// mnemonic id of illegal GCN instruction
+static const uint16_t GCNDecodedIllegal = 0xffff;
+
+/// flags of operand of decoded GCN instruction
+enum : cxbyte
+{
+    GCNDOP_DST = 1,     ///< destination operand
+    GCNDOP_SRC = 2,     ///< source operand
+    GCNDOP_NEG = 4,     ///< negation (or neg_lo for VOP3P)
+    GCNDOP_ABS = 8,     ///< absolute value
+    GCNDOP_SEXT = 16,   ///< sign extension (SDWA)
+    GCNDOP_NEG_HI = 32  ///< negation of high part (VOP3P)
+};
+
+/// type of extra dword of decoded GCN instruction
+enum : cxbyte
+{
+    GCNDEXTRA_NONE = 0, ///< no extra dword
+    GCNDEXTRA_LITERAL,  ///< literal constant
+    GCNDEXTRA_DPP,      ///< DPP word
+    GCNDEXTRA_SDWA      ///< SDWA word
+};
+
+/// modifiers of decoded GCN instruction
+enum : uint32_t
+{
+    GCNDMOD_CLAMP = 1,
+    GCNDMOD_GLC = 2,
+    GCNDMOD_SLC = 4,
+    GCNDMOD_TFE = 8,
+    GCNDMOD_LDS = 0x10,
+    GCNDMOD_OFFEN = 0x20,
+    GCNDMOD_IDXEN = 0x40,
+    GCNDMOD_ADDR64 = 0x80,
+    GCNDMOD_GDS = 0x100,
+    GCNDMOD_UNORM = 0x200,
+    GCNDMOD_DA = 0x400,
+    GCNDMOD_R128 = 0x800,   ///< r128 (a16 for GCN 1.4)
+    GCNDMOD_LWE = 0x1000,
+    GCNDMOD_D16 = 0x2000,
+    GCNDMOD_DONE = 0x4000,
+    GCNDMOD_COMPR = 0x8000,
+    GCNDMOD_VM = 0x10000,
+    GCNDMOD_NV = 0x20000,
+    GCNDMOD_HIGH = 0x40000,
+    GCNDMOD_BOUND_CTRL = 0x80000,
+    GCNDMOD_IMM_OFFSET = 0x100000   ///< immediate offset (SMRD/SMEM)
+};
+
+/// operand of decoded GCN instruction
+struct GCNDecodedOperand
+{
+    /// operand code
+    /** 0-255 - scalar operand (code as in SRC0 field of VOP encodings),
+     * 256-511 - vector register */
+    uint16_t code;
+    cxbyte regsNum; ///< number of registers in range
+    cxbyte flags;   ///< GCNDOP_* flags
+};
+
+/// DPP fields of decoded GCN instruction
+struct GCNDecodedDPP
+{
+    uint16_t dppCtrl;   ///< DPP control
+    cxbyte rowMask;     ///< row mask
+    cxbyte bankMask;    ///< bank mask
+};
+
+/// SDWA fields of decoded GCN instruction
+struct GCNDecodedSDWA
+{
+    cxbyte dstSel;      ///< destination select
+    cxbyte dstUnused;   ///< destination unused bits
+    cxbyte src0Sel;     ///< source 0 select
+    cxbyte src1Sel;     ///< source 1 select
+};
+
+/// decoded GCN instruction
+struct GCNDecodedInstr
+{
+    size_t offset;      ///< offset in code (in bytes)
+    /// mnemonic id (GCNDecodedIllegal if illegal)
+    /** operands of illegal instruction are decoded in standard mode */
+    uint16_t mnemonicId;
+    uint16_t opcode;    ///< opcode
+    cxbyte encoding;    ///< encoding (GCNENC_*)
+    cxbyte wordsNum;    ///< number of dwords (with literal, DPP or SDWA)
+    cxbyte operandsNum; ///< number of operands
+    cxbyte extra;       ///< extra dword type (GCNDEXTRA_*)
+    GCNDecodedOperand operands[GCNDecodedMaxOperands];  ///< operands
+    uint32_t literal;   ///< literal constant (if extra is GCNDEXTRA_LITERAL)
+    uint32_t imm;       ///< immediate (SIMM16, offset, VINTRP param)
+    uint32_t modifiers; ///< GCNDMOD_* flags
+    cxbyte omod;        ///< output modifier (VOP3, SDWA)
+    cxbyte opsel;       ///< op_sel (bits 0-3), op_sel_hi (bits 4-6, VOP3P)
+    cxbyte mask;        ///< dmask (MIMG), enable (EXP), immediate SDATA (SMEM)
+    /// format (MTBUF: dfmt|(nfmt<<4)), target (EXP), attr|(chan<<6) (VINTRP)
+    cxbyte format;
+    union
+    {
+        GCNDecodedDPP dpp;      ///< DPP fields (if extra is GCNDEXTRA_DPP)
+        GCNDecodedSDWA sdwa;    ///< SDWA fields (if extra is GCNDEXTRA_SDWA)
+    };
+};
+
+struct GCNEncodingEntry;
+
+/// GCN instruction decoder
+/** decodes instructions to compact records without producing any text.
+ * GCN disassembler formats its text output from these records */
+class GCNDecoder
+{
+private:
+    GPUArchitecture arch;
+    const GCNEncodingEntry* encTable;
+public:
+    /// constructor
+    explicit GCNDecoder(GPUArchitecture arch);
+
+    /// get architecture
+    GPUArchitecture getArchitecture() const
+    { return arch; }
+
+    /// decode instruction at position pos (in bytes)
+    /** returns position of next instruction (can be beyond code size if
+     * instruction is unfinished) */
+    size_t decode(size_t codeSize, const cxbyte* code, size_t pos,
+                GCNDecodedInstr& instr) const;
+
+    /// decode all instructions of code
+    void decodeAll(size_t codeSize, const cxbyte* code,
+                std::vector<GCNDecodedInstr>& instrs) const;
+
+    /// get mnemonic by id (returns null if illegal)
+    static const char* getMnemonic(uint16_t mnemonicId);
+    
+    /// print operand (register, constant or literal) of decoded instruction
+    /** buffer should have at least 32 characters.
+     * returns number of written characters */
+    size_t printOperand(const GCNDecodedInstr& instr, cxuint index, char* buf) const;
+};
+
 /// single kernel input for disassembler
 /** all pointer members holds only pointers that should be freed by your routines.
  * No management of data */
@@ -221,6 +678,8 @@ struct AmdDisasmKernelInput
     const cxbyte* data; ///< data from inner binary
     size_t codeSize;    ///< size of code of kernel
     const cxbyte* code; ///< code of kernel
+    /// tokenized metadata from binary (optional, can be null)
+    const AmdKernelMetadataView* metadataView;
 };
 
 /// whole disassembler input (for AMD Catalyst driver GPU binaries)
@@ -375,9 +834,14 @@ private:
         const ROCmDisasmInput* rocmInput;
         const RawCodeInput* rawInput;
     };
-    std::ostream& output;
+    std::unique_ptr<DisasmStreamOutput> streamOutput; // sink for output stream
+    DisasmOutput& output;
     Flags flags;
     size_t sectionCount;
+    cxuint threadsNum;
+    
+    void disassembleJSON();
+    void disassembleToOutput();
 public:
     /// constructor for 32-bit GPU binary
     /**
@@ -387,6 +851,14 @@ public:
      */
     Disassembler(const AmdMainGPUBinary32& binary, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for 32-bit GPU binary (output to sink)
+    /**
+     * \param binary main GPU binary
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const AmdMainGPUBinary32& binary, DisasmOutput& output,
+                 Flags flags = 0);
     /// constructor for 64-bit GPU binary
     /**
      * \param binary main GPU binary
@@ -395,6 +867,14 @@ public:
      */
     Disassembler(const AmdMainGPUBinary64& binary, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for 64-bit GPU binary (output to sink)
+    /**
+     * \param binary main GPU binary
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const AmdMainGPUBinary64& binary, DisasmOutput& output,
+                 Flags flags = 0);
     /// constructor for AMD OpenCL 2.0 GPU binary 32-bit
     /**
      * \param binary main GPU binary
@@ -404,6 +884,15 @@ public:
      */
     Disassembler(const AmdCL2MainGPUBinary32& binary, std::ostream& output,
                  Flags flags = 0, cxuint driverVersion = 0);
+    /// constructor for AMD OpenCL 2.0 GPU binary 32-bit (output to sink)
+    /**
+     * \param binary main GPU binary
+     * \param output output sink
+     * \param flags flags for disassembler
+     * \param driverVersion driverVersion (0 - detected by disassembler)
+     */
+    Disassembler(const AmdCL2MainGPUBinary32& binary, DisasmOutput& output,
+                 Flags flags = 0, cxuint driverVersion = 0);
     /// constructor for AMD OpenCL 2.0 GPU binary 64-bit
     /**
      * \param binary main GPU binary
@@ -413,6 +902,15 @@ public:
      */
     Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& output,
                  Flags flags = 0, cxuint driverVersion = 0);
+    /// constructor for AMD OpenCL 2.0 GPU binary 64-bit (output to sink)
+    /**
+     * \param binary main GPU binary
+     * \param output output sink
+     * \param flags flags for disassembler
+     * \param driverVersion driverVersion (0 - detected by disassembler)
+     */
+    Disassembler(const AmdCL2MainGPUBinary64& binary, DisasmOutput& output,
+                 Flags flags = 0, cxuint driverVersion = 0);
     /// constructor for ROCm GPU binary
     /**
      * \param binary main GPU binary
@@ -420,6 +918,13 @@ public:
      * \param flags flags for disassembler
      */
     Disassembler(const ROCmBinary& binary, std::ostream& output, Flags flags = 0);
+    /// constructor for ROCm GPU binary (output to sink)
+    /**
+     * \param binary main GPU binary
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const ROCmBinary& binary, DisasmOutput& output, Flags flags = 0);
     /// constructor for AMD disassembler input
     /**
      * \param disasmInput disassembler input object
@@ -428,6 +933,14 @@ public:
      */
     Disassembler(const AmdDisasmInput* disasmInput, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for AMD disassembler input (output to sink)
+    /**
+     * \param disasmInput disassembler input object
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const AmdDisasmInput* disasmInput, DisasmOutput& output,
+                 Flags flags = 0);
     /// constructor for AMD OpenCL 2.0 disassembler input
     /**
      * \param disasmInput disassembler input object
@@ -436,6 +949,14 @@ public:
      */
     Disassembler(const AmdCL2DisasmInput* disasmInput, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for AMD OpenCL 2.0 disassembler input (output to sink)
+    /**
+     * \param disasmInput disassembler input object
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const AmdCL2DisasmInput* disasmInput, DisasmOutput& output,
+                 Flags flags = 0);
     /// constructor for ROCMm disassembler input
     /**
      * \param disasmInput disassembler input object
@@ -444,6 +965,14 @@ public:
      */
     Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for ROCMm disassembler input (output to sink)
+    /**
+     * \param disasmInput disassembler input object
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const ROCmDisasmInput* disasmInput, DisasmOutput& output,
+                 Flags flags = 0);
     
     /// constructor for bit GPU binary from Gallium
     /**
@@ -455,6 +984,16 @@ public:
      */
     Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
                  std::ostream& output, Flags flags = 0, cxuint llvmVersion = 0);
+    /// constructor for bit GPU binary from Gallium (output to sink)
+    /**
+     * \param deviceType GPU device type
+     * \param binary main GPU binary
+     * \param output output sink
+     * \param flags flags for disassembler
+     * \param llvmVersion LLVM version
+     */
+    Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
+                 DisasmOutput& output, Flags flags = 0, cxuint llvmVersion = 0);
     
     /// constructor for Gallium disassembler input
     /**
@@ -464,14 +1003,27 @@ public:
      */
     Disassembler(const GalliumDisasmInput* disasmInput, std::ostream& output,
                  Flags flags = 0);
+    /// constructor for Gallium disassembler input (output to sink)
+    /**
+     * \param disasmInput disassembler input object
+     * \param output output sink
+     * \param flags flags for disassembler
+     */
+    Disassembler(const GalliumDisasmInput* disasmInput, DisasmOutput& output,
+                 Flags flags = 0);
     
     /// constructor for raw code
     Disassembler(GPUDeviceType deviceType, size_t rawCodeSize, const cxbyte* rawCode,
                  std::ostream& output, Flags flags = 0);
+    /// constructor for raw code (output to sink)
+    Disassembler(GPUDeviceType deviceType, size_t rawCodeSize, const cxbyte* rawCode,
+                 DisasmOutput& output, Flags flags = 0);
     
     ~Disassembler();
     
     /// disassembles input
+    /** if DISASM_JSON flag is set, then writes JSON Lines records
+     * (binary, sections, kernels and instructions) instead of assembler source */
     void disassemble();
     
     /// get disassemblers flags
@@ -481,6 +1033,15 @@ public:
     void setFlags(Flags flags)
     { this->flags = flags; }
     
+    /// get number of threads used to disassemble kernels (1 - sequential)
+    cxuint getThreadsNum() const
+    { return threadsNum; }
+    /// set number of threads used to disassemble kernels
+    /** 0 - number of hardware threads, 1 - sequential disassembly (default).
+     * output is same for any number of threads */
+    void setThreadsNum(cxuint _threadsNum)
+    { threadsNum = _threadsNum; }
+    
     /// get deviceType
     GPUDeviceType getDeviceType() const;
     
@@ -496,11 +1057,11 @@ public:
     const GalliumDisasmInput* getGalliumInput() const
     { return galliumInput; }
     
-    /// get output stream
-    const std::ostream& getOutput() const
+    /// get output sink
+    const DisasmOutput& getOutput() const
     { return output; }
-    /// get output stream
-    std::ostream& getOutput()
+    /// get output sink
+    DisasmOutput& getOutput()
     { return output; }
 };
 
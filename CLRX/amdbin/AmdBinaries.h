@@ -26,6 +26,7 @@
 #include <CLRX/Config.h>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <memory>
@@ -61,6 +62,12 @@ enum : Flags {
     AMDBIN_INNER_CREATE_CALNOTES = 0x10000, ///< create CAL notes for AMD inner GPU binary
     
     AMDBIN_CREATE_ALL = ELF_CREATE_ALL | 0xffff0, ///< all AMD binaries creation flags
+    /** parse inner binaries and kernel informations on first access
+     * (only for AMD main GPU binaries) */
+    AMDBIN_CREATE_LAZY = 0x100000,
+    /** create hash index of sections and symbols for inner binaries
+     * (not in AMDBIN_CREATE_ALL) */
+    AMDBIN_INNER_CREATE_HASHINDEX = 0x200000,
     AMDBIN_INNER_SHIFT = 12 ///< shift for convert inner binary flags into elf binary flags
 };
 
@@ -422,9 +429,16 @@ protected:
     
     CString driverInfo; ///< driver info string
     CString compileOptions; ///< compiler options string
+    MappedFile mappedFile;  ///< mapped file that holds binary code
+    bool lazyKernelInfos;   ///< if true, kernel infos are parsed on first access
     
     /// constructor
     explicit AmdMainBinaryBase(AmdMainType type);
+    
+    /// parse kernel information in lazy mode (if not parsed yet)
+    virtual void loadKernelInfo(size_t index) const;
+    /// parse all kernel informations in lazy mode
+    void loadKernelInfos() const;
 public:
     virtual ~AmdMainBinaryBase();
     
@@ -438,11 +452,19 @@ public:
     
     /// get kernel informations array
     const KernelInfo* getKernelInfos() const
-    { return kernelInfos.data(); }
+    {
+        if (lazyKernelInfos)
+            loadKernelInfos();
+        return kernelInfos.data();
+    }
     
     /// get kernel information with specified index
     const KernelInfo& getKernelInfo(size_t index) const
-    { return kernelInfos[index]; }
+    {
+        if (lazyKernelInfos)
+            loadKernelInfo(index);
+        return kernelInfos[index];
+    }
     
     /// get kernel information with specified kernel name (requires kernel info map)
     const KernelInfo& getKernelInfo(const char* name) const;
@@ -454,6 +476,52 @@ public:
     /// get compile options string
     const CString& getCompileOptions() const
     { return compileOptions; }
+    
+    /// set mapped file with binary code (binary owns mapping)
+    void setMappedFile(MappedFile&& file)
+    { mappedFile = std::move(file); }
+    /// get mapped file with binary code
+    const MappedFile& getMappedFile() const
+    { return mappedFile; }
+};
+
+/// field of AMD kernel metadata line (points to metadata text)
+struct AmdMetadataField
+{
+    const char* ptr;    ///< field text (unterminated)
+    size_t size;        ///< field size
+    
+    /// return true if field is equal to string
+    bool equal(const char* str) const
+    { return ::strlen(str) == size && ::memcmp(ptr, str, size) == 0; }
+    /// return true if field is equal to other field
+    bool equal(const AmdMetadataField& field) const
+    { return size == field.size && ::memcmp(ptr, field.ptr, size) == 0; }
+};
+
+/// AMD kernel metadata line (fields are separated by ':')
+struct AmdMetadataLine
+{
+    const char* ptr;    ///< line text with leading ';' (without newline)
+    size_t size;        ///< line size
+    size_t fieldsIndex; ///< first field index in metadata view
+    size_t fieldsNum;   ///< fields number
+    bool entry;         ///< true if line begins with ';' (fields skip it)
+    bool newline;       ///< true if line is terminated by newline
+};
+
+/// tokenized AMD kernel metadata (lines and fields point to metadata text)
+struct AmdKernelMetadataView
+{
+    Array<AmdMetadataLine> lines;   ///< lines
+    Array<AmdMetadataField> fields; ///< fields of all lines
+    
+    /// split metadata into lines and fields (single pass, no copying)
+    void parse(size_t metadataSize, const char* metadata);
+    
+    /// get field of line
+    const AmdMetadataField& getField(const AmdMetadataLine& line, size_t index) const
+    { return fields[line.fieldsIndex + index]; }
 };
 
 /// AMD GPU metadata for kernel
@@ -461,6 +529,7 @@ struct AmdGPUKernelMetadata
 {
     size_t size;    ///< size
     char* data;     ///< data (unterminated string)
+    AmdKernelMetadataView view; ///< tokenized metadata (if kernel info created)
 };
 
 /// AMD GPU header for kernel
@@ -488,39 +557,82 @@ protected:
     size_t globalDataSize;  ///< global data size
     cxbyte* globalData; ///< global data content
     
+    struct LazyState;
+    std::unique_ptr<LazyState> lazyState;   ///< symbol index for lazy mode
+    
     /// constructor
     explicit AmdMainGPUBinaryBase(AmdMainType type);
     
     /// initialize main gpu binary (internal use only)
     template<typename Types>
     void initMainGPUBinary(typename Types::ElfBinary& binary);
+    /// parse inner binary or kernel info in lazy mode (internal use only)
+    template<typename Types>
+    void loadLazyEntry(const typename Types::ElfBinary& binary, size_t index,
+                bool kernelInfo) const;
+    
+    /// parse inner binary in lazy mode (if not parsed yet)
+    void loadInnerBinary(size_t index) const;
+    /// parse kernel information and metadata in lazy mode (if not parsed yet)
+    void loadKernelInfo(size_t index) const;
 public:
+    /// destructor
+    ~AmdMainGPUBinaryBase();
+    
     /// get number of inner binaries
     size_t getInnerBinariesNum() const
     { return innerBinaries.size(); }
     
     /// get inner binary with specified index
     AmdInnerGPUBinary32& getInnerBinary(size_t index)
-    { return innerBinaries[index]; }
+    {
+        if (lazyState)
+            loadInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified index
     const AmdInnerGPUBinary32& getInnerBinary(size_t index) const
-    { return innerBinaries[index]; }
+    {
+        if (lazyState)
+            loadInnerBinary(index);
+        return innerBinaries[index];
+    }
     
     /// get inner binary with specified name (requires inner binary map)
     const AmdInnerGPUBinary32& getInnerBinary(const char* name) const;
     
     /// get metadata size for specified inner binary
     size_t getMetadataSize(size_t index) const
-    { return metadatas[index].size; }
+    {
+        if (lazyState)
+            loadKernelInfo(index);
+        return metadatas[index].size;
+    }
     
     /// get metadata for specified inner binary
     const char* getMetadata(size_t index) const
-    { return metadatas[index].data; }
+    {
+        if (lazyState)
+            loadKernelInfo(index);
+        return metadatas[index].data;
+    }
     
     /// get metadata for specified inner binary
     char* getMetadata(size_t index)
-    { return metadatas[index].data; }
+    {
+        if (lazyState)
+            loadKernelInfo(index);
+        return metadatas[index].data;
+    }
+    
+    /// get tokenized metadata for specified inner binary (requires kernel info)
+    const AmdKernelMetadataView& getMetadataView(size_t index) const
+    {
+        if (lazyState)
+            loadKernelInfo(index);
+        return metadatas[index].view;
+    }
     
     /// get global data size
     size_t getGlobalDataSize() const
@@ -603,6 +715,10 @@ public:
     /// return true if binary has kernel header map
     bool hasKernelHeaderMap() const
     { return (creationFlags & AMDBIN_CREATE_KERNELHEADERMAP) != 0; }
+    
+    /// returns true if inner binaries and kernel infos are parsed on first access
+    bool isLazy() const
+    { return (creationFlags & AMDBIN_CREATE_LAZY) != 0; }
 };
 
 /// AMD main binary for GPU for 64-bit mode
@@ -647,6 +763,10 @@ public:
     /// return true if binary has kernel header map
     bool hasKernelHeaderMap() const
     { return (creationFlags & AMDBIN_CREATE_KERNELHEADERMAP) != 0; }
+    
+    /// returns true if inner binaries and kernel infos are parsed on first access
+    bool isLazy() const
+    { return (creationFlags & AMDBIN_CREATE_LAZY) != 0; }
 };
 
 /// AMD main binary for X86 systems
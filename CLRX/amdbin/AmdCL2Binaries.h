@@ -49,6 +49,27 @@ enum : Flags {
     AMDCL2BIN_INNER_CREATE_KERNELSTUBS = 0x40000    ///< create kernel stub
 };
 
+/// AMD OpenCL 2.0 kernel setup data (part of AMD HSA config, at offset 48 of setup)
+struct AmdCL2SetupData
+{
+    uint32_t pgmRSRC1;  ///< PGM_RSRC1 register value
+    uint32_t pgmRSRC2;  ///< PGM_RSRC2 register value
+    uint16_t setup1;    ///< setup flags (user data)
+    uint16_t archInd;   ///< architecture indicator
+    uint32_t scratchBufferSize; ///< scratch buffer size
+    uint32_t localSize; ///< local size in bytes
+    uint32_t gdsSize;   ///< GDS size in bytes
+    uint32_t kernelArgsSize;    ///< kernel arguments size
+    uint32_t zeroes[2]; ///< zeroes
+    // really is, reserved Xgprs, but filled by driver
+    uint16_t sgprsNumAll;   ///< number of all SGPRs
+    uint16_t vgprsNum16;    ///< number of VGPRs (16-bit)
+    uint32_t vgprsNum;  ///< number of VGPRs
+    uint32_t sgprsNum;  ///< number of SGPRs
+    uint32_t zero3;     ///< zero
+    uint32_t version;   ///< version (?)
+};
+
 /// AMD OpenCL 2.0 GPU metadata for kernel
 struct AmdCL2GPUKernel
 {
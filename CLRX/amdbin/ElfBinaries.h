@@ -70,7 +70,9 @@ enum : Flags {
     ELF_CREATE_SECTIONMAP = 1,  ///< create map of sections
     ELF_CREATE_SYMBOLMAP = 2,   ///< create map of symbols
     ELF_CREATE_DYNSYMMAP = 4,   ///< create map of dynamic symbols
-    ELF_CREATE_ALL = 0xf  ///< creation flags for ELF binaries
+    ELF_CREATE_ALL = 0xf,  ///< creation flags for ELF binaries
+    /// create hash index of sections, symbols and dynamic symbols (not in CREATE_ALL)
+    ELF_CREATE_HASHINDEX = 0x80000000U
 };
 
 /// Bin exception class
@@ -115,6 +117,7 @@ struct Elf32Types
     static const cxuint bitness;    ///< ELF bitness
     static const char* bitName;     ///< bitness name
     static const Word nobase = Word(0)-1;   ///< address with zero base
+    static const Size nosymbol = Size(0)-1; ///< symbol index if symbol not found
     static const cxuint relSymShift = 8;
 };
 
@@ -136,9 +139,21 @@ struct Elf64Types
     static const cxuint bitness;    ///< ELF bitness
     static const char* bitName;     ///< bitness name
     static const Word nobase = Word(0)-1;   ///< address with zero base
+    static const Size nosymbol = Size(0)-1; ///< symbol index if symbol not found
     static const cxuint relSymShift = 32;
 };
 
+/// entry of ELF hash index
+struct ElfHashIndexEntry
+{
+    uint32_t hash;  ///< hash of name
+    uint32_t index; ///< index of section or symbol (UINT32_MAX if entry is empty)
+    uint32_t nameOffset;    ///< offset of name in string table
+};
+
+/// ELF hash index (open addressing hash table with linear probing)
+typedef Array<ElfHashIndexEntry> ElfHashIndex;
+
 /// ELF binary class
 /** This object doesn't copy binary code content.
  * Only it takes and uses a binary code.
@@ -147,6 +162,8 @@ template<typename Types>
 class ElfBinaryTemplate
 {
 public:
+    /// ELF types
+    typedef Types ElfTypes;
     /// section index map
     typedef Array<std::pair<const char*, size_t> > SectionIndexMap;
     /// symbol index map
@@ -165,6 +182,11 @@ protected:
     SectionIndexMap sectionIndexMap;    ///< section's index map
     SymbolIndexMap symbolIndexMap;      ///< symbol's index map
     SymbolIndexMap dynSymIndexMap;      ///< dynamic symbol's index map
+    ElfHashIndex sectionHashIndex;  ///< section's hash index
+    ElfHashIndex symbolHashIndex;   ///< symbol's hash index
+    ElfHashIndex dynSymHashIndex;   ///< dynamic symbol's hash index
+    const cxbyte* symbolElfHash;    ///< ELF hash table ('.hash') of symbols
+    const cxbyte* dynSymElfHash;    ///< ELF hash table ('.hash') of dynamic symbols
     
     typename Types::Size symbolsNum;    ///< symbols number
     typename Types::Size dynSymbolsNum; ///< dynamic symbols number
@@ -201,6 +223,10 @@ public:
     bool hasDynSymbolMap() const
     { return (creationFlags & ELF_CREATE_DYNSYMMAP) != 0; }
     
+    /// returns true if object has a hash index of sections and symbols
+    bool hasHashIndex() const
+    { return (creationFlags & ELF_CREATE_HASHINDEX) != 0; }
+    
     /// get size of binaries
     size_t getSize() const
     { return binaryCodeSize; }
@@ -342,12 +368,25 @@ public:
     /// get section index with specified name
     uint16_t getSectionIndex(const char* name) const;
     
-    /// get symbol index with specified name (requires symbol index map)
+    /// get symbol index with specified name (requires symbol index map or hash index)
     typename Types::Size getSymbolIndex(const char* name) const;
     
-    /// get dynamic symbol index with specified name (requires dynamic symbol index map)
+    /// get dynamic symbol index with specified name
+    /** requires dynamic symbol index map or hash index */
     typename Types::Size getDynSymbolIndex(const char* name) const;
     
+    /// find section index with specified name, returns SHN_UNDEF if not found
+    uint16_t findSectionIndex(const char* name) const;
+    
+    /// find symbol index with specified name, returns Types::nosymbol if not found
+    /** requires symbol index map or hash index */
+    typename Types::Size findSymbolIndex(const char* name) const;
+    
+    /// find dynamic symbol index with specified name
+    /** requires dynamic symbol index map or hash index.
+     * \return dynamic symbol index or Types::nosymbol if not found */
+    typename Types::Size findDynSymbolIndex(const char* name) const;
+    
     /// get end iterator of symbol index map
     SymbolIndexMap::const_iterator getSymbolIterEnd() const
     { return symbolIndexMap.end(); }
@@ -452,6 +491,8 @@ public:
     
     static uint32_t getElfRelType(typename Types::Word info);
     static uint32_t getElfRelSym(typename Types::Word info);
+private:
+    size_t findSectionIndexInt(const char* name) const;
 };
 
 template<>
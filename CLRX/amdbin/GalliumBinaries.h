@@ -53,6 +53,9 @@ enum : Flags {
     GALLIUM_ELF_CREATE_PROGINFOMAP = 0x10,  ///< create elf proginfomap
     
     GALLIUM_CREATE_ALL = ELF_CREATE_ALL | 0xfff0, ///< all Gallium binaries flags
+    /** create hash index of sections and symbols for inner binaries
+     * (not in GALLIUM_CREATE_ALL) */
+    GALLIUM_INNER_CREATE_HASHINDEX = 0x10000,
     GALLIUM_INNER_SHIFT = 4 ///< shift for convert inner binary flags into elf binary flags
 };
 
@@ -305,6 +308,7 @@ private:
     bool elf64BitBinary;
     std::unique_ptr<GalliumElfBinaryBase> elfBinary;
     bool mesa170;
+    MappedFile mappedFile;
     
 public:
     /// constructor
@@ -320,6 +324,13 @@ public:
     size_t getSize() const
     { return binaryCodeSize; }
     
+    /// set mapped file (binary will unmap it when destroyed)
+    void setMappedFile(MappedFile&& file)
+    { mappedFile = std::move(file); }
+    /// get mapped file
+    const MappedFile& getMappedFile() const
+    { return mappedFile; }
+    
     /// returns true if object is initialized
     operator bool() const
     { return binaryCode!=nullptr; }
@@ -511,6 +522,9 @@ public:
     void generate(std::vector<char>& vector) const;
 };
 
+/// check whether binary code is Gallium binary
+extern bool isGalliumBinary(size_t binarySize, const cxbyte* binary);
+
 /// detect driver version in the system
 extern uint32_t detectMesaDriverVersion();
 /// detect LLVM compiler version in the system
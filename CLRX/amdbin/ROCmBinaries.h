@@ -28,6 +28,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <CLRX/amdbin/Elf.h>
 #include <CLRX/amdbin/ElfBinaries.h>
@@ -46,6 +47,7 @@ enum : Flags {
     ROCMBIN_CREATE_REGIONMAP = 0x10,    ///< create region map
     ROCMBIN_CREATE_METADATAINFO = 0x20,     ///< create metadata info object
     ROCMBIN_CREATE_KERNELINFOMAP = 0x40,    ///< create kernel metadata info map
+    ROCMBIN_CREATE_METADATAVIEW = 0x80,     ///< create metadata view object
     ROCMBIN_CREATE_ALL = ELF_CREATE_ALL | 0xfff0 ///< all ROCm binaries flags
 };
 
@@ -190,6 +192,97 @@ struct ROCmMetadata
     void parse(size_t metadataSize, const char* metadata);
 };
 
+/// kind of ROCm metadata string view
+enum : cxbyte
+{
+    ROCMSTRVIEW_PLAIN = 0,  ///< plain text, value is same as text
+    ROCMSTRVIEW_QUOTED,     ///< quoted string with escapes
+    ROCMSTRVIEW_BLOCK       ///< YAML block string ('|' or '>')
+};
+
+/// ROCm metadata string view
+/** This object doesn't hold string content, it points to value text in metadata.
+ * Quoted and block strings are decoded only while converting to CString.
+ */
+struct ROCmStringView
+{
+    const char* ptr;    ///< pointer to value text in metadata
+    size_t size;        ///< size of value text
+    cxuint prevIndent;  ///< indentation of parent (for block strings)
+    cxbyte kind;        ///< kind of string view
+    
+    /// get decoded string value
+    CString toCString() const;
+};
+
+/// ROCm kernel argument (view of metadata)
+struct ROCmKernelArgInfoView
+{
+    ROCmStringView name;       ///< name
+    ROCmStringView typeName;   ///< type name
+    uint64_t size;      ///< argument size in bytes
+    uint64_t align;     ///< argument alignment in bytes
+    uint64_t pointeeAlign;      ///< alignemnt of pointed data of pointer
+    ROCmValueKind valueKind;    ///< value kind
+    ROCmValueType valueType;    ///< value type
+    ROCmAddressSpace addressSpace;  ///< pointer address space
+    ROCmAccessQual accessQual;      ///< access qualifier (for images and values)
+    ROCmAccessQual actualAccessQual;    ///< actual access qualifier
+    bool isConst;       ///< is constant
+    bool isRestrict;    ///< is restrict
+    bool isVolatile;    ///< is volatile
+    bool isPipe;        ///< is pipe
+};
+
+/// ROCm kernel metadata (view of metadata)
+struct ROCmKernelMetadataView
+{
+    ROCmStringView name;       ///< kernel name
+    ROCmStringView symbolName; ///< symbol name
+    size_t argInfosStart;   ///< index of first argument in ROCmMetadataView::argInfos
+    size_t argInfosNum;     ///< arguments number
+    ROCmStringView language;       ///< language
+    cxuint langVersion[2];  ///< language version
+    cxuint reqdWorkGroupSize[3];    ///< required work group size
+    cxuint workGroupSizeHint[3];    ///< work group size hint
+    ROCmStringView vecTypeHint;    ///< vector type hint
+    ROCmStringView runtimeHandle;  ///< symbol of runtime handle
+    uint64_t kernargSegmentSize;    ///< kernel argument segment size
+    uint64_t groupSegmentFixedSize; ///< group segment size (fixed)
+    uint64_t privateSegmentFixedSize;   ///< private segment size (fixed)
+    uint64_t kernargSegmentAlign;       ///< alignment of kernel argument segment
+    cxuint wavefrontSize;       ///< wavefront size
+    cxuint sgprsNum;        ///< number of SGPRs
+    cxuint vgprsNum;        ///< number of VGPRs
+    uint64_t maxFlatWorkGroupSize;
+    cxuint fixedWorkGroupSize[3];
+    cxuint spilledSgprs;    ///< number of spilled SGPRs
+    cxuint spilledVgprs;    ///< number of spilled VGPRs
+    
+    void initialize();
+};
+
+/// ROCm binary metadata (view of metadata)
+/** This object doesn't copy string values, it points to the metadata text,
+ * hence metadata text must be kept while this object is used.
+ */
+struct ROCmMetadataView
+{
+    cxuint version[2];  ///< version
+    std::vector<ROCmPrintfInfo> printfInfos;  ///< printf calls infos
+    std::vector<ROCmKernelMetadataView> kernels;  ///< kernel metadatas
+    std::vector<ROCmKernelArgInfoView> argInfos;  ///< arguments of all kernels
+    
+    /// initialize metadata view
+    void initialize();
+    /// parse metadata view from metadata string
+    void parse(size_t metadataSize, const char* metadata);
+    /// get kernel metadata (with decoded strings)
+    void getKernelMetadata(size_t index, ROCmKernelMetadata& kernel) const;
+    /// convert to metadata info (with decoded strings)
+    void toMetadata(ROCmMetadata& metadata) const;
+};
+
 /// ROCm main binary for GPU for 64-bit mode
 /** This object doesn't copy binary code content.
  * Only it takes and uses a binary code.
@@ -211,8 +304,10 @@ private:
     size_t metadataSize;
     char* metadata;
     std::unique_ptr<ROCmMetadata> metadataInfo;
+    std::unique_ptr<ROCmMetadataView> metadataView;
     RegionMap kernelInfosMap;
     bool newBinFormat;
+    MappedFile mappedFile;
 public:
     /// constructor
     ROCmBinary(size_t binaryCodeSize, cxbyte* binaryCode,
@@ -224,6 +319,13 @@ public:
     GPUDeviceType determineGPUDeviceType(uint32_t& archMinor,
                      uint32_t& archStepping) const;
     
+    /// set mapped file that holds binary code (binary takes ownership)
+    void setMappedFile(MappedFile&& file)
+    { mappedFile = std::move(file); }
+    /// get mapped file that holds binary code
+    const MappedFile& getMappedFile() const
+    { return mappedFile; }
+    
     /// get regions number
     size_t getRegionsNum() const
     { return regionsNum; }
@@ -274,6 +376,14 @@ public:
     const ROCmMetadata& getMetadataInfo() const
     { return *metadataInfo; }
     
+    /// has metadata view
+    bool hasMetadataView() const
+    { return metadataView!=nullptr; }
+    
+    /// get metadata view
+    const ROCmMetadataView& getMetadataView() const
+    { return *metadataView; }
+    
     /// get kernel metadata infos number
     size_t getKernelInfosNum() const
     { return metadataInfo->kernels.size(); }
@@ -0,0 +1,113 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+/*! \file GCNEncoding.h
+ * \brief GCN instruction encoding classifier
+ */
+
+#ifndef __CLRX_GCNENCODING_H__
+#define __CLRX_GCNENCODING_H__
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+
+/// main namespace
+namespace CLRX
+{
+
+/// GCN encodings
+enum : cxbyte
+{
+    GCNENC_NONE,
+    GCNENC_SOPC,    /* 0x17e<<23, opcode = (7bit)<<16 */
+    GCNENC_SOPP,    /* 0x17f<<23, opcode = (7bit)<<16 */
+    GCNENC_SOP1,    /* 0x17d<<23, opcode = (8bit)<<8 */
+    GCNENC_SOP2,    /* 0x2<<30,   opcode = (7bit)<<23 */
+    GCNENC_SOPK,    /* 0xb<<28,   opcode = (5bit)<<23 */
+    GCNENC_SMRD,    /* 0x18<<27,  opcode = (6bit)<<22 */
+    GCNENC_SMEM = GCNENC_SMRD,    /* 0x18<<27,  opcode = (6bit)<<22 */
+    GCNENC_VOPC,    /* 0x3e<<25,  opcode = (8bit)<<17 */
+    GCNENC_VOP1,    /* 0x3f<<25,  opcode = (8bit)<<9 */
+    GCNENC_VOP2,    /* 0x0<<31,   opcode = (6bit)<<25 */
+    GCNENC_VOP3A,   /* 0x34<<26,  opcode = (9bit)<<17 */
+    GCNENC_VOP3B,   /* 0x34<<26,  opcode = (9bit)<<17 */
+    GCNENC_VINTRP,  /* 0x32<<26,  opcode = (2bit)<<16 */
+    GCNENC_DS,      /* 0x36<<26,  opcode = (8bit)<<18 */
+    GCNENC_MUBUF,   /* 0x38<<26,  opcode = (7bit)<<18 */
+    GCNENC_MTBUF,   /* 0x3a<<26,  opcode = (3bit)<<16 */
+    GCNENC_MIMG,    /* 0x3c<<26,  opcode = (7bit)<<18 */
+    GCNENC_EXP,     /* 0x3e<<26,  opcode = none */
+    GCNENC_FLAT,    /* 0x37<<26,  opcode = (8bit)<<18 (???8bit) */
+    GCNENC_MAXVAL = GCNENC_FLAT
+};
+
+/// check of additional dword (literal, DPP or SDWA) after instruction
+enum : cxbyte
+{
+    GCNLIT_NONE = 0,    ///< no additional dword
+    GCNLIT_SSRC0,       ///< literal if SSRC0 is 0xff
+    GCNLIT_SSRC01,      ///< literal if SSRC0 or SSRC1 is 0xff
+    GCNLIT_VSRC0,       ///< literal if SRC0 is 0xff
+    GCNLIT_VSRC0_EXT    ///< literal, SDWA or DPP if SRC0 is 0xff, 0xf9 or 0xfa
+};
+
+/// entry of GCN encoding table
+struct GCNEncodingEntry
+{
+    cxbyte encoding;    ///< GCN encoding (GCNENC_*, VOP3A for VOP3A/VOP3B)
+    cxbyte wordsNum;    ///< base number of dwords (1 or 2)
+    cxbyte literal;     ///< check of additional dword (GCNLIT_*)
+};
+
+/// number of entries of GCN encoding table (indexed by high 9 bits of first dword)
+static const size_t GCNEncodingTableSize = 512;
+
+/// get GCN encoding table for architecture (index is first dword >> 23)
+extern const GCNEncodingEntry* getGCNEncodingTable(GPUArchitecture arch);
+
+/// get GCN encoding entry for first dword of instruction
+inline const GCNEncodingEntry& getGCNEncodingEntry(const GCNEncodingEntry* table,
+                uint32_t insnCode)
+{ return table[insnCode>>23]; }
+
+/// get number of dwords of instruction (with literal, SDWA or DPP)
+inline cxuint getGCNInstrWordsNum(const GCNEncodingEntry& entry, uint32_t insnCode)
+{
+    switch (entry.literal)
+    {
+        case GCNLIT_NONE:
+            return entry.wordsNum;
+        case GCNLIT_SSRC0:
+            return 1 + ((insnCode&0xff) == 0xff);
+        case GCNLIT_SSRC01:
+            return 1 + ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00);
+        case GCNLIT_VSRC0:
+            return 1 + ((insnCode&0x1ff) == 0xff);
+        default:
+        {
+            const uint32_t src0 = insnCode&0x1ff;
+            return 1 + (src0 == 0xff || src0 == 0xf9 || src0 == 0xfa);
+        }
+    }
+}
+
+}
+
+#endif
@@ -151,6 +151,20 @@ extern cxuint getGPUMaxRegistersNum(GPUArchitecture architecture, cxuint regType
 /// get maximum available registers for GPU (type: 0 - scalar, 1 - vector)
 extern cxuint getGPUMaxRegsNumByArchMask(uint16_t archMask, cxuint regType);
 
+/// get maximum number of registers (with extra registers) for specified occupancy
+/**
+ * \param architecture GPU architecture
+ * \param regType register type (0 - scalar, 1 - vector)
+ * \param wavesNum number of waves per SIMD
+ * \return maximum number of registers (with extra registers)
+ */
+extern cxuint getGPUMaxRegsNumByWaves(GPUArchitecture architecture, cxuint regType,
+              cxuint wavesNum);
+
+/// get occupancy (number of waves per SIMD) for specified number of registers
+extern cxuint getGPUWavesNumByRegsNum(GPUArchitecture architecture, cxuint regType,
+              cxuint regsNum);
+
 /// get minimal number of required registers
 extern void getGPUSetupMinRegistersNum(GPUArchitecture architecture, cxuint dimMask,
                cxuint userDataNum, Flags flags, cxuint* gprsOut);
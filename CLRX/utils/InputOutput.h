@@ -375,6 +375,10 @@ public:
     uint64_t getWritten() const
     { return written; }
     
+    /// get output stream
+    std::ostream& getOutput() const
+    { return os; }
+    
     /// write output buffer
     void flush()
     {
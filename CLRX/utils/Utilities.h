@@ -27,11 +27,13 @@
 #include <exception>
 #include <string>
 #include <vector>
+#include <utility>
 #include <cstdlib>
 #include <cstring>
 #include <cstdint>
 #include <mutex>
 #include <atomic>
+#include <functional>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/utils/CString.h>
 
@@ -373,6 +375,18 @@ inline cxuint CLZ64(uint64_t v)
 #endif
 }
 
+/// counts trailing zeroes for 64-bit unsigned integer. For zero behavior is undefined
+inline cxuint CTZ64(uint64_t v)
+{
+#ifdef __GNUC__
+    return __builtin_ctzll(v);
+#else
+    cxuint count = 0;
+    for (; (v&1)==0; v>>=1, count++);
+    return count;
+#endif
+}
+
 /// safely compares sum of two unsigned integers with other unsigned integer
 template<typename T, typename T2>
 inline bool usumGt(T a, T b, T2 c)
@@ -694,9 +708,15 @@ inline size_t dtocstrCStyle(double value, char* str, size_t maxSize, bool scient
 
 /// returns true if path refers to directory
 extern bool isDirectory(const char* path);
+/// returns true if path refers to symbolic link (false if not exists)
+extern bool isSymbolicLink(const char* path);
 /// returns true if file exists
 extern bool isFileExists(const char* path);
 
+/// list names of directory entries (without '.' and '..'), unsorted
+/** throws Exception if directory can't be opened */
+extern std::vector<std::string> listDirectory(const char* dirname);
+
 /// load data from file (any regular or pipe or device)
 /**
  * \param filename filename
@@ -704,6 +724,69 @@ extern bool isFileExists(const char* path);
  */
 extern Array<cxbyte> loadDataFromFile(const char* filename);
 
+/// memory mapped file
+/** maps whole regular file to memory. Read-only mapping should be used if data
+ * will be only read, copy-on-write mapping if data can be modified
+ * (changes are private and they are not written to file). Object unmaps file
+ * in destructor */
+class MappedFile
+{
+private:
+    cxbyte* mapData;
+    size_t mapSize;
+    bool copyOnWrite;
+#ifdef HAVE_WINDOWS
+    void* mapHandle;
+#endif
+public:
+    /// empty constructor
+    MappedFile();
+    /// constructor (maps file, throws Exception if file can't be mapped)
+    /**
+     * \param filename filename
+     * \param copyOnWrite if true then private copy-on-write mapping is created,
+     * otherwise read-only mapping is created
+     */
+    explicit MappedFile(const char* filename, bool copyOnWrite = false);
+    /// move constructor
+    MappedFile(MappedFile&& file) noexcept;
+    /// destructor
+    ~MappedFile();
+
+    /// move assignment
+    MappedFile& operator=(MappedFile&& file) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// get size of mapped data
+    size_t size() const
+    { return mapSize; }
+    /// get mapped data (writable only if copy-on-write mapping)
+    cxbyte* data() const
+    { return mapData; }
+    /// returns true if mapping is copy-on-write mapping
+    bool isCopyOnWrite() const
+    { return copyOnWrite; }
+    /// returns true if nothing is mapped
+    bool empty() const
+    { return mapData == nullptr; }
+    /// unmap file
+    void reset();
+};
+
+/// load data from file, maps regular file to memory
+/** regular file is mapped into mappedFile, other files (pipes, devices) are loaded
+ * into data array.
+ * \param filename filename
+ * \param mappedFile mapped file (filled if file has been mapped)
+ * \param data loaded data (filled if file has not been mapped)
+ * \param copyOnWrite if true then copy-on-write mapping is created (for mutable data)
+ * \return pointer to data and size of data
+ */
+extern std::pair<cxbyte*, size_t> loadDataFromFile(const char* filename,
+            MappedFile& mappedFile, Array<cxbyte>& data, bool copyOnWrite = false);
+
 /// convert to filesystem from unified path (with slashes)
 extern void filesystemPath(char* path);
 /// convert to filesystem from unified path (with slashes)
@@ -984,6 +1067,23 @@ inline void callOnce(OnceFlag& flag, Callable&& f, Args&&... args)
 }
 #endif
 
+/* parallel run */
+
+/// get number of hardware threads (at least 1)
+extern cxuint getHardwareThreadsNum();
+
+/// run func for each item index (0..itemsNum-1) on threadsNum threads
+/**
+ * \param itemsNum number of items
+ * \param threadsNum number of threads (0 - number of hardware threads)
+ * \param func function called with item index
+ *
+ * If any call throws exception, then exception from lowest item index is rethrown
+ * after finishing all threads.
+ */
+extern void runParallel(size_t itemsNum, cxuint threadsNum,
+            const std::function<void(size_t)>& func);
+
 };
 
 #endif
@@ -1862,6 +1862,11 @@ bool AsmAmdCL2Handler::prepareBinary()
             output.driverVersion = assembler.driverVersion;
     }
     
+    // include registers used by register allocator
+    for (size_t i = 0; i < kernelStates.size(); i++)
+        for (cxuint k = 0; k < 2; k++)
+            kernelStates[i]->allocRegs[k] = std::max(kernelStates[i]->allocRegs[k],
+                        assembler.kernels[i].usedRegsNums[k]);
     // set up number of the allocated SGPRs and VGPRs for kernel
     for (size_t i = 0; i < kernelsNum; i++)
     {
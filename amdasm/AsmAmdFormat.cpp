@@ -1778,6 +1778,11 @@ bool AsmAmdHandler::prepareBinary()
     // determine max SGPRs number for architecture excluding VCC
     const cxuint maxSGPRsNumWithoutVCC = getGPUMaxRegistersNum(arch, REGTYPE_SGPR,
                 REGCOUNT_NO_VCC);
+    // include registers used by register allocator
+    for (size_t i = 0; i < kernelStates.size(); i++)
+        for (cxuint k = 0; k < 2; k++)
+            kernelStates[i]->allocRegs[k] = std::max(kernelStates[i]->allocRegs[k],
+                        assembler.kernels[i].usedRegsNums[k]);
     // set up number of the allocated SGPRs and VGPRs for kernel
     for (size_t i = 0; i < kernelsNum; i++)
     {
@@ -1130,6 +1130,7 @@ AsmExpression* AsmExpression::parse(Assembler& assembler, const char*& linePtr,
         size_t lineColPos;
     };
 
+    assembler.timeReport.expressionsNum++;
     std::stack<ConExprOpEntry> stack;
     std::vector<AsmExprOp> ops;
     std::vector<AsmExprArg> args;
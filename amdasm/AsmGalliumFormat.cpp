@@ -1763,6 +1763,11 @@ bool AsmGalliumHandler::prepareBinary()
         llvmVersion = detectedLLVMVersion;
     
     GPUArchitecture arch = getGPUArchitectureFromDeviceType(assembler.deviceType);
+    // include registers used by register allocator
+    for (size_t i = 0; i < kernelStates.size(); i++)
+        for (cxuint k = 0; k < 2; k++)
+            kernelStates[i]->allocRegs[k] = std::max(kernelStates[i]->allocRegs[k],
+                        assembler.kernels[i].usedRegsNums[k]);
     // set up number of the allocated SGPRs and VGPRs for kernel
     cxuint maxSGPRsNum = getGPUMaxRegistersNum(arch, REGTYPE_SGPR, 0);
     
@@ -26,6 +26,7 @@
 #include <unordered_set>
 #include <utility>
 #include <memory>
+#include <chrono>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdasm/Assembler.h>
 #include "GCNInternals.h"
@@ -33,6 +34,35 @@
 namespace CLRX
 {
 
+#ifdef HAVE_TIME_PASSES
+// measure time of pass and add it to time (only if enabled)
+class PassTimer
+{
+private:
+    double* time;
+    std::chrono::steady_clock::time_point start;
+public:
+    PassTimer(bool enabled, double& _time) : time(enabled ? &_time : nullptr)
+    {
+        if (time != nullptr)
+            start = std::chrono::steady_clock::now();
+    }
+    ~PassTimer()
+    {
+        if (time != nullptr)
+            *time += std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - start).count();
+    }
+};
+#else
+// timing of passes disabled
+struct PassTimer
+{
+    PassTimer(bool enabled, double& time)
+    { }
+};
+#endif
+
 static inline void skipCharAndSpacesToEnd(const char*& string, const char* end)
 {
     ++string;
@@ -311,6 +341,13 @@ struct CLRX_INTERNAL AsmPseudoOps: AsmParseUtils
                      const char* linePtr, AsmCodeFlowType type);
     
     static void setAbsoluteOffset(Assembler& asmr, const char* linePtr);
+    // set target occupancy for register allocation
+    static void setOccupancy(Assembler& asmr, const char* pseudoOpPlace,
+                      const char* linePtr);
+    // set register allocation mode
+    static void setRegAllocMode(Assembler& asmr, const char* linePtr);
+    // set scratch buffer for spilled registers
+    static void setSpillScratch(Assembler& asmr, const char* linePtr);
     
     static void getPredefinedValue(Assembler& asmr, const char* linePtr,
                         AsmPredefined predefined);
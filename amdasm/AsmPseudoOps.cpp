@@ -120,13 +120,13 @@ static const char* pseudoOpNamesTbl[] =
     "include", "int", "irp", "irpc", "kernel", "lflags",
     "line", "ln", "local", "long",
     "macro", "macrocase", "main", "noaltmacro",
-    "nobuggyfplit", "nomacrocase", "nooldmodparam", "octa",
-    "offset", "oldmodparam", "org",
+    "nobuggyfplit", "nomacrocase", "nooldmodparam", "noschedule", "occupancy",
+    "octa", "offset", "oldmodparam", "org",
     "p2align", "print", "purgem", "quad",
-    "rawcode", "regvar", "rept", "rocm", "rodata",
-    "sbttl", "scope", "section", "set",
+    "rawcode", "regalloc", "regvar", "rept", "rocm", "rodata",
+    "sbttl", "schedule", "scope", "section", "set",
     "short", "single", "size", "skip",
-    "space", "string", "string16", "string32",
+    "space", "spillscratch", "string", "string16", "string32",
     "string64", "struct", "text", "title",
     "undef", "unusing", "usereg", "using", "version",
     "warning", "weak", "while", "word"
@@ -163,13 +163,14 @@ enum
     ASMOP_INCLUDE, ASMOP_INT, ASMOP_IRP, ASMOP_IRPC, ASMOP_KERNEL, ASMOP_LFLAGS,
     ASMOP_LINE, ASMOP_LN, ASMOP_LOCAL, ASMOP_LONG,
     ASMOP_MACRO, ASMOP_MACROCASE, ASMOP_MAIN, ASMOP_NOALTMACRO,
-    ASMOP_NOBUGGYFPLIT, ASMOP_NOMACROCASE, ASMOP_NOOLDMODPARAM, ASMOP_OCTA,
+    ASMOP_NOBUGGYFPLIT, ASMOP_NOMACROCASE, ASMOP_NOOLDMODPARAM, ASMOP_NOSCHEDULE,
+    ASMOP_OCCUPANCY, ASMOP_OCTA,
     ASMOP_OFFSET, ASMOP_OLDMODPARAM, ASMOP_ORG,
     ASMOP_P2ALIGN, ASMOP_PRINT, ASMOP_PURGEM, ASMOP_QUAD,
-    ASMOP_RAWCODE, ASMOP_REGVAR, ASMOP_REPT, ASMOP_ROCM, ASMOP_RODATA,
-    ASMOP_SBTTL, ASMOP_SCOPE, ASMOP_SECTION, ASMOP_SET,
+    ASMOP_RAWCODE, ASMOP_REGALLOC, ASMOP_REGVAR, ASMOP_REPT, ASMOP_ROCM, ASMOP_RODATA,
+    ASMOP_SBTTL, ASMOP_SCHEDULE, ASMOP_SCOPE, ASMOP_SECTION, ASMOP_SET,
     ASMOP_SHORT, ASMOP_SINGLE, ASMOP_SIZE, ASMOP_SKIP,
-    ASMOP_SPACE, ASMOP_STRING, ASMOP_STRING16, ASMOP_STRING32,
+    ASMOP_SPACE, ASMOP_SPILLSCRATCH, ASMOP_STRING, ASMOP_STRING16, ASMOP_STRING32,
     ASMOP_STRING64, ASMOP_STRUCT, ASMOP_TEXT, ASMOP_TITLE,
     ASMOP_UNDEF, ASMOP_UNUSING, ASMOP_USEREG, ASMOP_USING, ASMOP_VERSION,
     ASMOP_WARNING, ASMOP_WEAK, ASMOP_WHILE, ASMOP_WORD
@@ -534,6 +535,7 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
     std::ifstream ifs;
     sysfilename = filename;
     filesystemPath(sysfilename);
+    std::string filePath = sysfilename;
     // try in this directory
     ifs.open(sysfilename.c_str(), std::ios::binary);
     if (!ifs)
@@ -543,7 +545,8 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
         {
             std::string incDirPath(incDir.c_str());
             filesystemPath(incDirPath);
-            ifs.open(joinPaths(incDirPath.c_str(), sysfilename).c_str(), std::ios::binary);
+            filePath = joinPaths(incDirPath.c_str(), sysfilename);
+            ifs.open(filePath.c_str(), std::ios::binary);
             if (ifs)
                 break;
         }
@@ -569,9 +572,20 @@ void AsmPseudoOps::includeBinFile(Assembler& asmr, const char* pseudoOpPlace,
         const uint64_t size = ifs.tellg();
         if (size < offset)
             return; // do nothing
+        const uint64_t toRead = std::min(size-offset, count);
+        // copy directly from mapped file if file can be mapped
+        MappedFile mappedFile;
+        try
+        { mappedFile = MappedFile(filePath.c_str()); }
+        catch(const Exception&)
+        { } // read file by stream
+        if (!mappedFile.empty() && mappedFile.size() == size)
+        {
+            asmr.putData(toRead, mappedFile.data() + offset);
+            return;
+        }
         // skip offset bytes
         ifs.seekg(offset, std::ios::beg);
-        const uint64_t toRead = std::min(size-offset, count);
         char* output = reinterpret_cast<char*>(asmr.reserveData(toRead));
         // and just read directly to output
         ifs.read(output, toRead);
@@ -2165,6 +2179,108 @@ void AsmPseudoOps::setAbsoluteOffset(Assembler& asmr, const char* linePtr)
     asmr.currentOutPos = value;
 }
 
+void AsmPseudoOps::setOccupancy(Assembler& asmr, const char* pseudoOpPlace,
+                      const char* linePtr)
+{
+    const char* end = asmr.line+asmr.lineSize;
+    asmr.initializeOutputFormat();
+    skipSpacesToEnd(linePtr, end);
+    const char* valuePlace = linePtr;
+    uint64_t value = 0;
+    bool good = getAbsoluteValueArg(asmr, value, linePtr, true);
+    if (good && (value == 0 || value > 10))
+        ASM_NOTGOOD_BY_ERROR(valuePlace, "Occupancy out of range (1-10)")
+    if (!good || !checkGarbagesAtEnd(asmr, linePtr))
+        return;
+    asmr.regAllocUsed = true;
+    // raw code does not have kernels
+    if (!asmr.kernels.empty() && asmr.currentKernel != ASMKERN_GLOBAL &&
+        asmr.currentKernel != ASMKERN_INNER)
+    {
+        asmr.kernels[asmr.currentKernel].occupancy = value;
+        asmr.kernels[asmr.currentKernel].occupancyPos = asmr.getSourcePos(pseudoOpPlace);
+    }
+    else
+    {
+        asmr.occupancy = value;
+        asmr.occupancyPos = asmr.getSourcePos(pseudoOpPlace);
+    }
+}
+
+void AsmPseudoOps::setSpillScratch(Assembler& asmr, const char* linePtr)
+{
+    const char* end = asmr.line+asmr.lineSize;
+    asmr.initializeOutputFormat();
+    cxuint regRanges[MAX_REGTYPES_NUM*2];
+    size_t regTypesNum;
+    asmr.isaAssembler->getRegisterRanges(regTypesNum, regRanges);
+    // scalar registers: buffer resource and offset
+    skipSpacesToEnd(linePtr, end);
+    const char* srsrcPlace = linePtr;
+    cxuint srsrcStart = 0, srsrcEnd = 0;
+    const AsmRegVar* regVar = nullptr;
+    bool good = asmr.isaAssembler->parseRegisterRange(linePtr, srsrcStart, srsrcEnd,
+                regVar);
+    if (good && (regVar != nullptr || srsrcEnd-srsrcStart != 4 ||
+            (srsrcStart&3) != 0 || srsrcStart < regRanges[0] || srsrcEnd > regRanges[1]))
+        ASM_NOTGOOD_BY_ERROR(srsrcPlace, "Expected 4 aligned scalar registers")
+    if (!skipRequiredComma(asmr, linePtr))
+        return;
+    skipSpacesToEnd(linePtr, end);
+    const char* soffsetPlace = linePtr;
+    cxuint soffsetStart = 0, soffsetEnd = 0;
+    if (asmr.isaAssembler->parseRegisterRange(linePtr, soffsetStart, soffsetEnd, regVar))
+    {
+        if (regVar != nullptr || soffsetEnd-soffsetStart != 1 ||
+            soffsetStart < regRanges[0] || soffsetEnd > regRanges[1])
+            ASM_NOTGOOD_BY_ERROR(soffsetPlace, "Expected single scalar register")
+    }
+    else
+        good = false;
+    uint64_t offset = 0;
+    bool haveComma;
+    if (!skipComma(asmr, haveComma, linePtr))
+        return;
+    if (haveComma)
+    {
+        skipSpacesToEnd(linePtr, end);
+        const char* offsetPlace = linePtr;
+        if (getAbsoluteValueArg(asmr, offset, linePtr, true))
+        {
+            if (offset > 4095)
+                ASM_NOTGOOD_BY_ERROR(offsetPlace, "Offset out of range (0-4095)")
+        }
+        else
+            good = false;
+    }
+    if (!good || !checkGarbagesAtEnd(asmr, linePtr))
+        return;
+    const AsmSpillScratch scratch = { true, uint16_t(srsrcStart), uint16_t(soffsetStart),
+                uint32_t(offset) };
+    // raw code does not have kernels
+    if (!asmr.kernels.empty() && asmr.currentKernel != ASMKERN_GLOBAL &&
+        asmr.currentKernel != ASMKERN_INNER)
+        asmr.kernels[asmr.currentKernel].spillScratch = scratch;
+    else
+        asmr.spillScratch = scratch;
+}
+
+static const std::pair<const char*, cxuint> regAllocModeMap[] =
+{
+    { "coloring", cxuint(AsmRegAllocMode::GRAPH_COLORING) },
+    { "linear", cxuint(AsmRegAllocMode::LINEAR_SCAN) }
+};
+
+void AsmPseudoOps::setRegAllocMode(Assembler& asmr, const char* linePtr)
+{
+    cxuint mode = 0;
+    if (!getEnumeration(asmr, linePtr, "register allocation mode",
+            sizeof(regAllocModeMap)/sizeof(regAllocModeMap[0]), regAllocModeMap, mode))
+        return;
+    if (checkGarbagesAtEnd(asmr, linePtr))
+        asmr.regAllocMode = AsmRegAllocMode(mode);
+}
+
 void AsmPseudoOps::defRegVar(Assembler& asmr, const char* pseudoOpPlace,
                        const char* linePtr)
 {
@@ -2215,6 +2331,7 @@ void AsmPseudoOps::defRegVar(Assembler& asmr, const char* pseudoOpPlace,
         if (!asmr.addRegVar(name, var))
             asmr.printError(regNamePlace, (std::string("Reg-var '")+name.c_str()+
                         "' was already defined").c_str());
+        asmr.regAllocUsed = true;
         
     } while(skipCommaForMultipleArgs(asmr, linePtr));
     
@@ -2722,6 +2839,13 @@ void Assembler::parsePseudoOps(const CString& firstName,
             if (AsmPseudoOps::checkGarbagesAtEnd(*this, linePtr))
                 oldModParam = false;
             break;
+        case ASMOP_NOSCHEDULE:
+            if (AsmPseudoOps::checkGarbagesAtEnd(*this, linePtr))
+                scheduling = false;
+            break;
+        case ASMOP_OCCUPANCY:
+            AsmPseudoOps::setOccupancy(*this, stmtPlace, linePtr);
+            break;
         case ASMOP_OCTA:
             AsmPseudoOps::putUInt128s(*this, stmtPlace, linePtr);
             break;
@@ -2747,6 +2871,9 @@ void Assembler::parsePseudoOps(const CString& firstName,
         case ASMOP_QUAD:
             AsmPseudoOps::putIntegers<uint64_t>(*this, stmtPlace, linePtr);
             break;
+        case ASMOP_REGALLOC:
+            AsmPseudoOps::setRegAllocMode(*this, linePtr);
+            break;
         case ASMOP_REGVAR:
             AsmPseudoOps::defRegVar(*this, stmtPlace, linePtr);
             break;
@@ -2756,6 +2883,10 @@ void Assembler::parsePseudoOps(const CString& firstName,
         case ASMOP_RODATA:
             AsmPseudoOps::goToSection(*this, stmtPlace, stmtPlace, true);
             break;
+        case ASMOP_SCHEDULE:
+            if (AsmPseudoOps::checkGarbagesAtEnd(*this, linePtr))
+                scheduling = schedulingUsed = true;
+            break;
         case ASMOP_SCOPE:
             AsmPseudoOps::openScope(*this, stmtPlace, linePtr);
             break;
@@ -2775,6 +2906,9 @@ void Assembler::parsePseudoOps(const CString& firstName,
         case ASMOP_SPACE:
             AsmPseudoOps::doSkip(*this, stmtPlace, linePtr);
             break;
+        case ASMOP_SPILLSCRATCH:
+            AsmPseudoOps::setSpillScratch(*this, linePtr);
+            break;
         case ASMOP_STRING:
             AsmPseudoOps::putStrings(*this, stmtPlace, linePtr, true);
             break;
@@ -1529,6 +1529,11 @@ bool AsmROCmHandler::prepareBinary()
     if (output.archStepping!=UINT32_MAX)
         amdGpuArchValues.stepping = output.archStepping;
     
+    // include registers used by register allocator
+    for (size_t i = 0; i < kernelStates.size(); i++)
+        for (cxuint k = 0; k < 2; k++)
+            kernelStates[i]->allocRegs[k] = std::max(kernelStates[i]->allocRegs[k],
+                        assembler.kernels[i].usedRegsNums[k]);
     // prepare kernels configuration
     for (size_t i = 0; i < kernelStates.size(); i++)
     {
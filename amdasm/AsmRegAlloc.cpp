@@ -19,15 +19,17 @@
 
 #include <CLRX/Config.h>
 #include <iostream>
+#include <sstream>
 #include <stack>
 #include <deque>
 #include <vector>
 #include <utility>
 #include <unordered_set>
-#include <map>
 #include <set>
 #include <unordered_map>
 #include <algorithm>
+#include <cstring>
+#include <functional>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/amdasm/Assembler.h>
@@ -35,14 +37,30 @@
 
 using namespace CLRX;
 
+#if ASMREGALLOC_DEBUGDUMP
+#  define ARDOut std::cout
+#else
+// debug output of register allocator (disabled)
+struct NoOutput
+{
+    template<typename T>
+    NoOutput& operator<<(const T& v)
+    { return *this; }
+    NoOutput& operator<<(std::ostream& (*manip)(std::ostream&))
+    { return *this; }
+};
+
+#  define ARDOut NoOutput()
+#endif
+
 typedef AsmRegAllocator::CodeBlock CodeBlock;
 typedef AsmRegAllocator::NextBlock NextBlock;
 typedef AsmRegAllocator::SSAInfo SSAInfo;
 
 ISAUsageHandler::ISAUsageHandler(const std::vector<cxbyte>& _content) :
-            content(_content), lastOffset(0), readOffset(0), instrStructPos(0),
-            regUsagesPos(0), regUsages2Pos(0), regVarUsagesPos(0),
-            pushedArgs(0), argPos(0), argFlags(0), isNext(false), useRegMode(false)
+            content(_content), lastOffset(0), readOffset(0), instrStructPos(0), regUsagesPos(0), regUsages2Pos(0),
+            regVarUsagesPos(0), pushedArgs(0), argPos(0), argFlags(0),
+            isNext(false), useRegMode(false)
 { }
 
 ISAUsageHandler::~ISAUsageHandler()
@@ -54,6 +72,7 @@ void ISAUsageHandler::rewind()
     regUsagesPos = regUsages2Pos = regVarUsagesPos = 0;
     useRegMode = false;
     pushedArgs = 0;
+    argPos = 0;
     skipBytesInInstrStruct();
 }
 
@@ -91,13 +110,23 @@ void ISAUsageHandler::putSpace(size_t offset)
         lastOffset = offset;
         argFlags = 0;
         pushedArgs = 0;
+        /* sparse index: read position of first instruction at or after
+         * start of every code chunk (first chunk starts from rewind) */
+        while (usageIndex.size() < (offset >> usageIndexShift))
+            usageIndex.push_back({ offset, instrStruct.size(), regUsages.size(),
+                    regUsages2.size(), regVarUsages.size(), 0, 0, false });
     } 
 }
 
 void ISAUsageHandler::pushUsage(const AsmRegVarUsage& rvu)
 {
     if (lastOffset == rvu.offset && useRegMode)
+    {
         flush(); // only flush if useRegMode and no change in offset
+        // start usages of instruction after useregs
+        argFlags = 0;
+        pushedArgs = 0;
+    }
     else // otherwise
         putSpace(rvu.offset);
     useRegMode = false;
@@ -105,7 +134,7 @@ void ISAUsageHandler::pushUsage(const AsmRegVarUsage& rvu)
     {
         argFlags |= (1U<<pushedArgs);
         regVarUsages.push_back({ rvu.regVar, rvu.rstart, rvu.rend, rvu.regField,
-            rvu.rwFlags, rvu.align });
+                rvu.rwFlags, rvu.align });
     }
     else // reg usages
         regUsages.push_back({ rvu.regField,cxbyte(rvu.rwFlags |
@@ -131,7 +160,7 @@ void ISAUsageHandler::pushUseRegUsage(const AsmRegVarUsage& rvu)
     {
         argFlags |= (1U<<(pushedArgs & 7));
         regVarUsages.push_back({ rvu.regVar, rvu.rstart, rvu.rend, rvu.regField,
-            rvu.rwFlags, rvu.align });
+                rvu.rwFlags, rvu.align });
     }
     else // reg usages
         regUsages2.push_back({ rvu.rstart, rvu.rend, rvu.rwFlags });
@@ -250,9 +279,98 @@ AsmRegVarUsage ISAUsageHandler::nextUsage()
     return rvu;
 }
 
-AsmRegAllocator::AsmRegAllocator(Assembler& _assembler) : assembler(_assembler)
+void ISAUsageHandler::seekTo(size_t offset)
+{
+    const size_t chunk = offset >> usageIndexShift;
+    if (chunk == 0 || usageIndex.empty())
+        rewind();
+    else
+        setReadPos(usageIndex[std::min(chunk, usageIndex.size()) - 1]);
+    // skip usages before offset (at most from single code chunk)
+    while (isNext && readOffset < offset)
+        nextUsage();
+}
+
+void ISAUsageHandler::moveInstructions(
+            const std::vector<std::pair<size_t, size_t> >& moves)
+{
+    if (moves.empty())
+        return;
+    // read all usages with their raw register flags
+    struct MovedUsage
+    {
+        size_t offset;
+        AsmRegVarUsage rvu;
+        cxbyte rawRwFlags;
+    };
+    std::vector<MovedUsage> usages;
+    rewind();
+    while (hasNext())
+    {
+        const size_t oldRegUsagesPos = regUsagesPos;
+        MovedUsage usage;
+        usage.rvu = nextUsage();
+        usage.rawRwFlags = (regUsagesPos != oldRegUsagesPos) ?
+                    (regUsages[oldRegUsagesPos].rwFlags & 0x7f) : 0;
+        // translate offset of moved instruction
+        auto it = std::lower_bound(moves.begin(), moves.end(),
+                std::make_pair(usage.rvu.offset, size_t(0)));
+        usage.offset = (it != moves.end() && it->first == usage.rvu.offset) ?
+                it->second : usage.rvu.offset;
+        usages.push_back(usage);
+    }
+    std::stable_sort(usages.begin(), usages.end(),
+            [](const MovedUsage& u1, const MovedUsage& u2)
+            { return u1.offset < u2.offset; });
+
+    // rebuild structure by pushing usages again
+    instrStruct.clear();
+    regUsages.clear();
+    regUsages2.clear();
+    regVarUsages.clear();
+    usageIndex.clear();
+    lastOffset = 0;
+    pushedArgs = 0;
+    argPos = argFlags = 0;
+    useRegMode = false;
+    for (MovedUsage& usage: usages)
+    {
+        AsmRegVarUsage& rvu = usage.rvu;
+        rvu.offset = usage.offset;
+        if (rvu.useRegMode)
+            pushUseRegUsage(rvu);
+        else if (rvu.regVar != nullptr)
+            pushUsage(rvu);
+        else
+        {
+            // register size is already in raw rwFlags (getRwFlags gives zero)
+            rvu.rstart = 0;
+            rvu.rend = 1;
+            rvu.rwFlags = usage.rawRwFlags;
+            pushUsage(rvu);
+        }
+    }
+    flush();
+    rewind();
+}
+
+AsmRegAllocator::AsmRegAllocator(Assembler& _assembler)
+        : AsmRegAllocator(_assembler, _assembler.regAllocMode)
 { }
 
+AsmRegAllocator::AsmRegAllocator(Assembler& _assembler, AsmRegAllocMode _mode)
+        : assembler(_assembler), mode(_mode), regTypesNum(0), spillInstrsNum(0),
+          laneRegStart(0), sectionId(0), allocated(false), occupancy(0),
+          achievedOccupancy(0), threadsNum(0), timePasses(false)
+{
+    ::memset(&stats, 0, sizeof(AsmRegAllocStats));
+    ::memset(&spillScratch, 0, sizeof(AsmSpillScratch));
+    std::fill(vregsCounts, vregsCounts+MAX_REGTYPES_NUM, 0);
+    std::fill(usedRegsNums, usedRegsNums+MAX_REGTYPES_NUM, 0);
+    std::fill(spilledVarsNums, spilledVarsNums+MAX_REGTYPES_NUM, 0);
+    std::fill(tempVarsStarts, tempVarsStarts+MAX_REGTYPES_NUM, 0);
+}
+
 static inline bool codeBlockStartLess(const AsmRegAllocator::CodeBlock& c1,
                   const AsmRegAllocator::CodeBlock& c2)
 { return c1.start < c2.start; }
@@ -441,10 +559,14 @@ void AsmRegAllocator::createCodeStructure(const std::vector<AsmCodeFlowEntry>& c
     }
 }
 
-// map of last SSAId for routine, key - varid, value - last SSA ids
-typedef std::unordered_map<AsmSingleVReg, std::vector<size_t> > LastSSAIdMap;
+/* in SSA data creation every single vreg have dense id (in order of single vregs).
+ * below maps are array maps sorted by vreg id */
 
-typedef std::unordered_map<AsmSingleVReg, std::vector<bool> > LastOccurMap;
+// map of last SSAId for routine, key - vreg id, value - last SSA ids
+typedef std::vector<std::pair<size_t, std::vector<size_t> > > LastSSAIdMap;
+
+// key - vreg id, value - SSA id
+typedef std::vector<std::pair<size_t, size_t> > SSAIdMap;
 
 struct RetSSAEntry
 {
@@ -452,12 +574,12 @@ struct RetSSAEntry
     std::vector<size_t> ssaIds;
 };
 
-typedef std::unordered_map<AsmSingleVReg, RetSSAEntry> RetSSAIdMap;
+typedef std::vector<std::pair<size_t, RetSSAEntry> > RetSSAIdMap;
 
 struct RoutineData
 {
     // rbwSSAIdMap - read before write SSAId's map
-    std::unordered_map<AsmSingleVReg, size_t> rbwSSAIdMap;
+    SSAIdMap rbwSSAIdMap;
     LastSSAIdMap curSSAIdMap;
     LastSSAIdMap lastSSAIdMap;
 };
@@ -466,7 +588,7 @@ struct FlowStackEntry
 {
     size_t blockIndex;
     size_t nextIndex;
-    std::unordered_map<AsmSingleVReg, size_t> prevSSAIds;
+    SSAIdMap prevSSAIds;
     RetSSAIdMap prevRetSSAIdSets;
 };
 
@@ -484,6 +606,13 @@ struct CallStackEntry
     size_t routineBlock;    // routine block
 };
 
+// tables indexed by vreg id used while resolving SSA conflicts (empty entry - SIZE_MAX)
+struct ResolveSSATables
+{
+    std::vector<size_t> stackVarIndices;    // index in stack var list
+    std::vector<size_t> toResolveBlocks;    // source block where conflict found
+};
+
 typedef AsmRegAllocator::SSAReplace SSAReplace; // first - orig ssaid, second - dest ssaid
 typedef AsmRegAllocator::SSAReplacesMap SSAReplacesMap;
 
@@ -494,37 +623,81 @@ static inline void insertReplace(SSAReplacesMap& rmap, const AsmSingleVReg& vreg
     res.first->second.push_back({ origId, destId });
 }
 
+// insert entry to map sorted by vreg id, if not exists
+template<typename T>
+static std::pair<typename std::vector<std::pair<size_t, T> >::iterator, bool>
+insertVarIdEntry(std::vector<std::pair<size_t, T> >& map, size_t id, const T& value)
+{
+    auto it = std::lower_bound(map.begin(), map.end(), id,
+                [](const std::pair<size_t, T>& e, size_t id)
+                { return e.first < id; });
+    if (it != map.end() && it->first == id)
+        return std::make_pair(it, false);
+    return std::make_pair(map.insert(it, std::make_pair(id, value)), true);
+}
+
+// get entry from map sorted by vreg id (add empty entry if not exists)
+template<typename T>
+static inline T& getVarIdEntry(std::vector<std::pair<size_t, T> >& map, size_t id)
+{
+    return insertVarIdEntry(map, id, T()).first->second;
+}
+
+// add new SSA ids (not found in destination)
+static inline void addNewSSAIds(std::vector<size_t>& dest, const std::vector<size_t>& src)
+{
+    for (size_t ssaId: src)
+        if (std::find(dest.begin(), dest.end(), ssaId) == dest.end())
+            dest.push_back(ssaId);
+}
+
 static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
         const std::unordered_map<size_t, RoutineData>& routineMap,
         const std::vector<CodeBlock>& codeBlocks,
-        SSAReplacesMap& replacesMap)
+        const std::vector<std::vector<size_t> >& blockVarIds,
+        ResolveSSATables& tables, SSAReplacesMap& replacesMap)
 {
     size_t nextBlock = prevFlowStack.back().blockIndex;
     auto pfEnd = prevFlowStack.end();
     --pfEnd;
-    std::cout << "startResolv: " << (pfEnd-1)->blockIndex << "," << nextBlock << std::endl;
+    ARDOut << "startResolv: " << (pfEnd-1)->blockIndex << "," << nextBlock << std::endl;
+    // stack var map: vreg id and its SSA ids (unsorted)
+    std::vector<size_t>& stackVarIndices = tables.stackVarIndices;
     LastSSAIdMap stackVarMap;
+    auto setStackVar = [&stackVarIndices, &stackVarMap]
+                (size_t id, const std::vector<size_t>& ssaIds)
+    {
+        if (stackVarIndices[id] == SIZE_MAX)
+        {
+            stackVarIndices[id] = stackVarMap.size();
+            stackVarMap.push_back({ id, ssaIds });
+        }
+        else
+            stackVarMap[stackVarIndices[id]].second = ssaIds;
+    };
+    
     for (auto pfit = prevFlowStack.begin(); pfit != pfEnd; ++pfit)
     {
         const FlowStackEntry& entry = *pfit;
-        std::cout << "  apply: " << entry.blockIndex << std::endl;
+        ARDOut << "  apply: " << entry.blockIndex << std::endl;
         const CodeBlock& cblock = codeBlocks[entry.blockIndex];
-        for (const auto& sentry: cblock.ssaInfoMap)
+        const std::vector<size_t>& varIds = blockVarIds[entry.blockIndex];
+        for (size_t k = 0; k < varIds.size(); k++)
         {
-            const SSAInfo& sinfo = sentry.second;
+            const SSAInfo& sinfo = cblock.ssaInfoMap[k].second;
             if (sinfo.ssaIdChange != 0)
-                stackVarMap[sentry.first] = { sinfo.ssaId + sinfo.ssaIdChange - 1 };
+                setStackVar(varIds[k], { sinfo.ssaId + sinfo.ssaIdChange - 1 });
         }
         if (entry.nextIndex > cblock.nexts.size())
             for (const NextBlock& next: cblock.nexts)
                 if (next.isCall)
                 {
-                    std::cout << "  applycall: " << entry.blockIndex << ": " <<
+                    ARDOut << "  applycall: " << entry.blockIndex << ": " <<
                             entry.nextIndex << ": " << next.block << std::endl;
                     const LastSSAIdMap& regVarMap =
                             routineMap.find(next.block)->second.lastSSAIdMap;
                     for (const auto& sentry: regVarMap)
-                        stackVarMap[sentry.first] = sentry.second;
+                        setStackVar(sentry.first, sentry.second);
                 }
     }
     
@@ -534,13 +707,23 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
     flowStack.push_back({ nextBlock, 0 });
     std::vector<bool> visited(codeBlocks.size(), false);
     
-    // key - vreg, value - source block where vreg of conflict found
-    std::unordered_map<AsmSingleVReg, size_t> toResolveMap;
+    // key - vreg id, value - source block where vreg of conflict found
+    std::vector<size_t>& toResolveBlocks = tables.toResolveBlocks;
+    std::vector<size_t> toResolveIds;
+    auto insertToResolve = [&toResolveBlocks, &toResolveIds](size_t id, size_t block)
+    {
+        if (toResolveBlocks[id] != SIZE_MAX)
+            return false;
+        toResolveBlocks[id] = block;
+        toResolveIds.push_back(id);
+        return true;
+    };
     
     while (!flowStack.empty())
     {
         FlowStackEntry2& entry = flowStack.back();
         const CodeBlock& cblock = codeBlocks[entry.blockIndex];
+        const std::vector<size_t>& varIds = blockVarIds[entry.blockIndex];
         
         if (entry.nextIndex == 0)
         {
@@ -548,28 +731,29 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
             if (!visited[entry.blockIndex])
             {
                 visited[entry.blockIndex] = true;
-                std::cout << "  resolv: " << entry.blockIndex << std::endl;
+                ARDOut << "  resolv: " << entry.blockIndex << std::endl;
                 
-                for (auto& sentry: cblock.ssaInfoMap)
+                for (size_t k = 0; k < varIds.size(); k++)
                 {
+                    const auto& sentry = cblock.ssaInfoMap[k];
                     const SSAInfo& sinfo = sentry.second;
-                    auto res = toResolveMap.insert({ sentry.first, entry.blockIndex });
+                    const bool inserted = insertToResolve(varIds[k], entry.blockIndex);
                     
-                    if (res.second && sinfo.readBeforeWrite)
+                    if (inserted && sinfo.readBeforeWrite)
                     {
                         // resolve conflict for this variable ssaId>.
                         // only if in previous block previous SSAID is
                         // read before all writes
-                        auto it = stackVarMap.find(sentry.first);
+                        const size_t stackVarIndex = stackVarIndices[varIds[k]];
                         
-                        if (it != stackVarMap.end())
+                        if (stackVarIndex != SIZE_MAX)
                         {
                             // found, resolve by set ssaIdLast
-                            for (size_t ssaId: it->second)
+                            for (size_t ssaId: stackVarMap[stackVarIndex].second)
                             {
                                 if (ssaId > sinfo.ssaIdBefore)
                                 {
-                                    std::cout << "  insertreplace: " <<
+                                    ARDOut << "  insertreplace: " <<
                                         sentry.first.regVar << ":" <<
                                         sentry.first.index  << ": " <<
                                         ssaId << ", " << sinfo.ssaIdBefore << std::endl;
@@ -578,7 +762,7 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
                                 }
                                 else if (ssaId < sinfo.ssaIdBefore)
                                 {
-                                    std::cout << "  insertreplace2: " <<
+                                    ARDOut << "  insertreplace2: " <<
                                         sentry.first.regVar << ":" <<
                                         sentry.first.index  << ": " <<
                                         ssaId << ", " << sinfo.ssaIdBefore << std::endl;
@@ -586,7 +770,7 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
                                                   sinfo.ssaIdBefore, ssaId);
                                 }
                                 /*else
-                                    std::cout << "  noinsertreplace: " <<
+                                    ARDOut << "  noinsertreplace: " <<
                                         ssaId << "," << sinfo.ssaIdBefore << std::endl;*/
                             }
                         }
@@ -596,7 +780,7 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
             else
             {
                 // back, already visited
-                std::cout << "resolv already: " << entry.blockIndex << std::endl;
+                ARDOut << "resolv already: " << entry.blockIndex << std::endl;
                 flowStack.pop_back();
                 continue;
             }
@@ -626,9 +810,9 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
                 {
                     const RoutineData& rdata = routineMap.find(next.block)->second;
                     for (const auto& v: rdata.rbwSSAIdMap)
-                        toResolveMap.insert({v.first, entry.blockIndex });
+                        insertToResolve(v.first, entry.blockIndex);
                     for (const auto& v: rdata.lastSSAIdMap)
-                        toResolveMap.insert({v.first, entry.blockIndex });
+                        insertToResolve(v.first, entry.blockIndex);
                 }
             
             flowStack.push_back({ entry.blockIndex+1, 0 });
@@ -642,253 +826,168 @@ static void resolveSSAConflicts(const std::deque<FlowStackEntry>& prevFlowStack,
                 {
                     const RoutineData& rdata = routineMap.find(next.block)->second;
                     for (const auto& v: rdata.rbwSSAIdMap)
-                    {
-                        auto it = toResolveMap.find(v.first);
-                        if (it != toResolveMap.end() && it->second == entry.blockIndex)
+                        if (toResolveBlocks[v.first] == entry.blockIndex)
                             // remove if not handled yet
-                            toResolveMap.erase(it);
-                    }
+                            toResolveBlocks[v.first] = SIZE_MAX;
                     for (const auto& v: rdata.lastSSAIdMap)
-                    {
-                        auto it = toResolveMap.find(v.first);
-                        if (it != toResolveMap.end() && it->second == entry.blockIndex)
+                        if (toResolveBlocks[v.first] == entry.blockIndex)
                             // remove if not handled yet
-                            toResolveMap.erase(it);
-                    }
+                            toResolveBlocks[v.first] = SIZE_MAX;
                 }
             
-            for (const auto& sentry: cblock.ssaInfoMap)
-            {
+            for (size_t id: varIds)
                 // mark resolved variables as not handled for further processing
-                auto it = toResolveMap.find(sentry.first);
-                if (it != toResolveMap.end() && it->second == entry.blockIndex)
+                if (toResolveBlocks[id] == entry.blockIndex)
                     // remove if not handled yet
-                    toResolveMap.erase(it);
-            }
-            std::cout << "  popresolv" << std::endl;
+                    toResolveBlocks[id] = SIZE_MAX;
+            ARDOut << "  popresolv" << std::endl;
             flowStack.pop_back();
         }
     }
+    
+    // clear tables for next call
+    for (size_t id: toResolveIds)
+        toResolveBlocks[id] = SIZE_MAX;
+    for (const auto& sentry: stackVarMap)
+        stackVarIndices[sentry.first] = SIZE_MAX;
 }
 
 static void joinRetSSAIdMap(RetSSAIdMap& dest, const LastSSAIdMap& src,
-                size_t routineBlock)
+                size_t routineBlock, const std::vector<AsmSingleVReg>& idVRegs)
 {
+    // merge sorted maps
+    RetSSAIdMap newMap;
+    newMap.reserve(dest.size() + src.size());
+    auto dit = dest.begin();
     for (const auto& entry: src)
     {
-        std::cout << "  entry2: " << entry.first.regVar << ":" <<
-                cxuint(entry.first.index) << ":";
+        const AsmSingleVReg& svreg = idVRegs[entry.first];
+        ARDOut << "  entry2: " << svreg.regVar << ":" <<
+                cxuint(svreg.index) << ":";
         for (size_t v: entry.second)
-            std::cout << " " << v;
-        std::cout << std::endl;
+            ARDOut << " " << v;
+        ARDOut << std::endl;
+        for (; dit != dest.end() && dit->first < entry.first; ++dit)
+            newMap.push_back(std::move(*dit));
         // insert if not inserted
-        auto res = dest.insert({entry.first, { { routineBlock }, entry.second } });
-        if (res.second)
-            continue; // added new
-        std::vector<size_t>& destEntry = res.first->second.ssaIds;
-        res.first->second.routines.push_back(routineBlock);
-        // add new ways
-        for (size_t ssaId: entry.second)
+        if (dit == dest.end() || dit->first != entry.first)
         {
-            auto it = std::find(destEntry.begin(), destEntry.end(), ssaId);
-            if (it == destEntry.end())
-                destEntry.push_back(ssaId);
+            newMap.push_back({ entry.first, { { routineBlock }, entry.second } });
+            continue; // added new
         }
-        std::cout << "    :";
+        std::vector<size_t>& destEntry = dit->second.ssaIds;
+        dit->second.routines.push_back(routineBlock);
+        // add new ways
+        addNewSSAIds(destEntry, entry.second);
+        ARDOut << "    :";
         for (size_t v: destEntry)
-            std::cout << " " << v;
-        std::cout << std::endl;
+            ARDOut << " " << v;
+        ARDOut << std::endl;
+        newMap.push_back(std::move(*dit));
+        ++dit;
     }
+    for (; dit != dest.end(); ++dit)
+        newMap.push_back(std::move(*dit));
+    dest.swap(newMap);
 }
 
-static void joinLastSSAIdMap(LastSSAIdMap& dest, const LastSSAIdMap& src)
+static void joinLastSSAIdMap(LastSSAIdMap& dest, const LastSSAIdMap& src,
+                const std::vector<AsmSingleVReg>& idVRegs)
 {
+    // merge sorted maps
+    LastSSAIdMap newMap;
+    newMap.reserve(dest.size() + src.size());
+    auto dit = dest.begin();
     for (const auto& entry: src)
     {
-        std::cout << "  entry: " << entry.first.regVar << ":" <<
-                cxuint(entry.first.index) << ":";
+        const AsmSingleVReg& svreg = idVRegs[entry.first];
+        ARDOut << "  entry: " << svreg.regVar << ":" <<
+                cxuint(svreg.index) << ":";
         for (size_t v: entry.second)
-            std::cout << " " << v;
-        std::cout << std::endl;
-        auto res = dest.insert(entry); // find
-        if (res.second)
-            continue; // added new
-        std::vector<size_t>& destEntry = res.first->second;
-        // add new ways
-        for (size_t ssaId: entry.second)
+            ARDOut << " " << v;
+        ARDOut << std::endl;
+        for (; dit != dest.end() && dit->first < entry.first; ++dit)
+            newMap.push_back(std::move(*dit));
+        if (dit == dest.end() || dit->first != entry.first)
         {
-            auto it = std::find(destEntry.begin(), destEntry.end(), ssaId);
-            if (it == destEntry.end())
-                destEntry.push_back(ssaId);
+            newMap.push_back(entry);
+            continue; // added new
         }
-        std::cout << "    :";
+        std::vector<size_t>& destEntry = dit->second;
+        // add new ways
+        addNewSSAIds(destEntry, entry.second);
+        ARDOut << "    :";
         for (size_t v: destEntry)
-            std::cout << " " << v;
-        std::cout << std::endl;
+            ARDOut << " " << v;
+        ARDOut << std::endl;
+        newMap.push_back(std::move(*dit));
+        ++dit;
     }
+    for (; dit != dest.end(); ++dit)
+        newMap.push_back(std::move(*dit));
+    dest.swap(newMap);
 }
 
-static void joinRoutineData(RoutineData& dest, const RoutineData& src)
+static void joinRoutineData(RoutineData& dest, const RoutineData& src,
+                const std::vector<AsmSingleVReg>& idVRegs)
 {
     // insert readBeforeWrite only if doesnt exists in destination
-    dest.rbwSSAIdMap.insert(src.rbwSSAIdMap.begin(), src.rbwSSAIdMap.end());
+    {
+        SSAIdMap newRbwMap;
+        newRbwMap.reserve(dest.rbwSSAIdMap.size() + src.rbwSSAIdMap.size());
+        auto dit = dest.rbwSSAIdMap.begin();
+        for (const auto& entry: src.rbwSSAIdMap)
+        {
+            for (; dit != dest.rbwSSAIdMap.end() && dit->first < entry.first; ++dit)
+                newRbwMap.push_back(*dit);
+            if (dit == dest.rbwSSAIdMap.end() || dit->first != entry.first)
+                newRbwMap.push_back(entry);
+        }
+        newRbwMap.insert(newRbwMap.end(), dit, dest.rbwSSAIdMap.end());
+        dest.rbwSSAIdMap.swap(newRbwMap);
+    }
     
     //joinLastSSAIdMap(dest.curSSAIdMap, src.lastSSAIdMap);
     
+    LastSSAIdMap newMap;
+    newMap.reserve(dest.curSSAIdMap.size() + src.lastSSAIdMap.size());
+    auto dit = dest.curSSAIdMap.begin();
     for (const auto& entry: src.lastSSAIdMap)
     {
-        std::cout << "  entry3: " << entry.first.regVar << ":" <<
-                cxuint(entry.first.index) << ":";
+        const AsmSingleVReg& svreg = idVRegs[entry.first];
+        ARDOut << "  entry3: " << svreg.regVar << ":" <<
+                cxuint(svreg.index) << ":";
         for (size_t v: entry.second)
-            std::cout << " " << v;
-        std::cout << std::endl;
-        auto res = dest.curSSAIdMap.insert(entry); // find
-        std::vector<size_t>& destEntry = res.first->second;
-        if (!res.second)
+            ARDOut << " " << v;
+        ARDOut << std::endl;
+        for (; dit != dest.curSSAIdMap.end() && dit->first < entry.first; ++dit)
+            newMap.push_back(std::move(*dit));
+        if (dit == dest.curSSAIdMap.end() || dit->first != entry.first)
+            newMap.push_back(entry);
+        else
         {
             // add new ways
-            for (size_t ssaId: entry.second)
-            {
-                auto it = std::find(destEntry.begin(), destEntry.end(), ssaId);
-                if (it == destEntry.end())
-                    destEntry.push_back(ssaId);
-            }
+            addNewSSAIds(dit->second, entry.second);
+            newMap.push_back(std::move(*dit));
+            ++dit;
         }
-        auto rbwit = src.rbwSSAIdMap.find(entry.first);
+        std::vector<size_t>& destEntry = newMap.back().second;
+        auto rbwit = binaryMapFind(src.rbwSSAIdMap.begin(), src.rbwSSAIdMap.end(),
+                        entry.first);
         if (rbwit != src.rbwSSAIdMap.end())
         {
             auto deit = std::find(destEntry.begin(), destEntry.end(), rbwit->second);
             if (deit != destEntry.end())
                 destEntry.erase(deit);
         }
-        std::cout << "    :";
+        ARDOut << "    :";
         for (size_t v: destEntry)
-            std::cout << " " << v;
-        std::cout << std::endl;
-    }
-}
-
-static void collectSSAIdsForCall(const std::deque<FlowStackEntry>& prevFlowStack,
-        const std::deque<CallStackEntry>& prevCallStack,
-        const std::vector<bool>& prevVisited,
-        std::unordered_map<size_t, RoutineData>& routineMap,
-        const std::vector<CodeBlock>& codeBlocks)
-{
-    std::deque<FlowStackEntry> flowStack;
-    // total SSA count
-    std::unordered_map<AsmSingleVReg, size_t> totalSSACountMap;
-    // last SSA ids map from returns
-    LastSSAIdMap retSSAIdMap;
-    // last SSA ids in current way in code flow
-    std::unordered_map<AsmSingleVReg, size_t> curSSAIdMap;
-    
-    std::vector<bool> visited(codeBlocks.size(), false);
-    flowStack.push_back({ 0, 0 });
-    
-    RoutineData& rdata = routineMap.find(prevCallStack.back().routineBlock)->second;
-    
-    while (!flowStack.empty())
-    {
-        FlowStackEntry& entry = flowStack.back();
-        const CodeBlock& cblock = codeBlocks[entry.blockIndex];
-        
-        if (entry.nextIndex == 0)
-        {
-            // process current block
-            if (!visited[entry.blockIndex])
-            {
-                visited[entry.blockIndex] = true;
-                
-                for (const auto& ssaEntry: cblock.ssaInfoMap)
-                {
-                    const SSAInfo& sinfo = ssaEntry.second;
-                    curSSAIdMap[ssaEntry.first] = sinfo.ssaIdLast != SIZE_MAX ?
-                        sinfo.ssaIdLast : sinfo.ssaIdBefore+1;
-                    
-                    if (sinfo.ssaIdChange != 0)
-                    {
-                        // put last SSAId
-                        auto res = rdata.curSSAIdMap.insert({ ssaEntry.first,
-                                { sinfo.ssaIdLast } });
-                        if (!res.second)
-                        {
-                            // if not inserted
-                            std::vector<size_t>& ssaIds = res.first->second;
-                            auto ssaIdIt = ssaIds.end();
-                            if (sinfo.readBeforeWrite)
-                                ssaIdIt = std::find(ssaIds.begin(), ssaIds.end(),
-                                        sinfo.ssaIdBefore);
-                            if (ssaIdIt == ssaIds.end())
-                                ssaIds.push_back(sinfo.ssaIdLast);
-                            else
-                                *ssaIdIt = sinfo.ssaIdLast;
-                        }
-                    }
-                }
-            }
-            else
-            {
-                // join routine data
-                auto rit = routineMap.find(entry.blockIndex);
-                if (rit != routineMap.end())
-                    // just join with current routine data
-                    joinRoutineData(rdata, rit->second);
-                
-                collectSSAIdsForCall(flowStack, prevCallStack, visited,
-                            routineMap, codeBlocks);
-                // back, already visited
-                flowStack.pop_back();
-                continue;
-            }
-        }
-        
-        if (entry.nextIndex < cblock.nexts.size() &&
-            prevVisited[cblock.nexts[entry.nextIndex].block])
-        {
-            flowStack.push_back({ cblock.nexts[entry.nextIndex].block, 0 });
-            entry.nextIndex++;
-        }
-        else if (((entry.nextIndex==0 && cblock.nexts.empty()) ||
-                // if have any call then go to next block
-                (cblock.haveCalls && entry.nextIndex==cblock.nexts.size())) &&
-                 !cblock.haveReturn && !cblock.haveEnd &&
-                 prevVisited[entry.blockIndex+1])
-        {
-            flowStack.push_back({ entry.blockIndex+1, 0 });
-            entry.nextIndex++;
-        }
-        else // back
-        {
-            flowStack.pop_back();
-            // previous code block
-            const CodeBlock& pcblock = codeBlocks[((!flowStack.empty()) ?
-                    flowStack.back().blockIndex : prevFlowStack.back().blockIndex)];
-            
-            //std::cout << "  popresolv" << std::endl;
-            for (const auto& ssaEntry: cblock.ssaInfoMap)
-            {
-                size_t& curSSAId = curSSAIdMap[ssaEntry.first];
-                const size_t nextSSAId = curSSAId;
-                curSSAId = ssaEntry.second.ssaIdBefore+1;
-                auto psit = pcblock.ssaInfoMap.find(ssaEntry.first);
-                if (psit != pcblock.ssaInfoMap.end())
-                    curSSAId = psit->second.ssaIdLast;
-                
-                std::vector<size_t>& ssaIds = rdata.curSSAIdMap
-                        .find(ssaEntry.first)->second;
-                
-                if (!cblock.nexts.empty() || (!cblock.haveEnd && !cblock.haveReturn))
-                {   // if cblock with some children
-                    auto nit = std::find(ssaIds.begin(), ssaIds.end(), nextSSAId-1);
-                    if (nit != ssaIds.end())
-                        ssaIds.erase(nit);  // just remove
-                }
-                // push previous SSAId to lastSSAIdMap (later will be replaced)
-                if (std::find(ssaIds.begin(), ssaIds.end(), curSSAId-1) == ssaIds.end())
-                    ssaIds.push_back(curSSAId-1);
-            }
-        }
+            ARDOut << " " << v;
+        ARDOut << std::endl;
     }
+    for (; dit != dest.curSSAIdMap.end(); ++dit)
+        newMap.push_back(std::move(*dit));
+    dest.curSSAIdMap.swap(newMap);
 }
 
 void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
@@ -908,13 +1007,22 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
     size_t regTypesNum;
     assembler.isaAssembler->getRegisterRanges(regTypesNum, regRanges);
     
+    /* first pass: get SSA infos of code blocks. single vregs have temporary ids
+     * (regvar have range of ids, real register have own id) */
+    std::unordered_map<const AsmRegVar*, size_t> regVarTmpIds;
+    std::vector<size_t> realRegTmpIds;
+    size_t idsNum = 0;
+    const AsmRegVar* lastRegVar = nullptr;
+    size_t lastFirstTmpId = 0;
+    // key - tmp id, value - position in SSA info list of current code block
+    std::vector<size_t> blockVarPos;
+    std::vector<std::vector<std::pair<size_t, SSAInfo> > > blockSSAInfos(
+                codeBlocks.size());
+    
     while (true)
     {
         while (cbit != codeBlocks.end() && cbit->end <= rvu.offset)
-        {
-            cbit->usagePos = usageHandler.getReadPos();
             ++cbit;
-        }
         if (cbit == codeBlocks.end())
             break;
         // skip rvu's before codeblock
@@ -923,18 +1031,42 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
         if (rvu.offset < cbit->start)
             break;
         
-        cbit->usagePos = usageHandler.getReadPos();
+        std::vector<std::pair<size_t, SSAInfo> >& ssaInfos =
+                    blockSSAInfos[cbit - codeBlocks.begin()];
         while (rvu.offset < cbit->end)
         {
             // process rvu
-            // only if regVar
+            if (rvu.regVar != nullptr && rvu.regVar != lastRegVar)
+            {
+                auto res = regVarTmpIds.insert({ rvu.regVar, idsNum });
+                if (res.second)
+                    idsNum += rvu.regVar->size;
+                lastRegVar = rvu.regVar;
+                lastFirstTmpId = res.first->second;
+            }
+            else if (rvu.regVar == nullptr && realRegTmpIds.size() < rvu.rend)
+                realRegTmpIds.resize(rvu.rend, SIZE_MAX);
+            
             for (uint16_t rindex = rvu.rstart; rindex < rvu.rend; rindex++)
             {
-                auto res = cbit->ssaInfoMap.insert(
-                        { AsmSingleVReg{ rvu.regVar, rindex }, SSAInfo() });
+                size_t tmpId = lastFirstTmpId + rindex;
+                if (rvu.regVar == nullptr)
+                {
+                    if (realRegTmpIds[rindex] == SIZE_MAX)
+                        realRegTmpIds[rindex] = idsNum++;
+                    tmpId = realRegTmpIds[rindex];
+                }
+                if (blockVarPos.size() < idsNum)
+                    blockVarPos.resize(idsNum, SIZE_MAX);
                 
-                SSAInfo& sinfo = res.first->second;
-                if (res.second)
+                const bool newVar = (blockVarPos[tmpId] == SIZE_MAX);
+                if (newVar)
+                {
+                    blockVarPos[tmpId] = ssaInfos.size();
+                    ssaInfos.push_back({ tmpId, SSAInfo() });
+                }
+                SSAInfo& sinfo = ssaInfos[blockVarPos[tmpId]].second;
+                if (newVar)
                     sinfo.firstPos = rvu.offset;
                 if ((rvu.rwFlags & ASMRVU_READ) != 0 && (sinfo.ssaIdChange == 0 ||
                     // if first write RVU instead read RVU
@@ -953,22 +1085,64 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                 break;
             rvu = usageHandler.nextUsage();
         }
+        for (const auto& sentry: ssaInfos)
+            blockVarPos[sentry.first] = SIZE_MAX;
         ++cbit;
     }
     
+    /* final ids of single vregs - sorted by single vregs */
+    std::vector<std::pair<AsmSingleVReg, size_t> > tmpIdVRegs;
+    tmpIdVRegs.reserve(idsNum);
+    for (size_t k = 0; k < realRegTmpIds.size(); k++)
+        if (realRegTmpIds[k] != SIZE_MAX)
+            tmpIdVRegs.push_back({ AsmSingleVReg{ nullptr, uint16_t(k) },
+                        realRegTmpIds[k] });
+    for (const auto& entry: regVarTmpIds)
+        for (uint16_t k = 0; k < entry.first->size; k++)
+            tmpIdVRegs.push_back({ AsmSingleVReg{ entry.first, k }, entry.second + k });
+    mapSort(tmpIdVRegs.begin(), tmpIdVRegs.end());
+    
+    std::vector<AsmSingleVReg> idVRegs(idsNum);
+    std::vector<size_t> finalIds(idsNum);
+    for (size_t i = 0; i < tmpIdVRegs.size(); i++)
+    {
+        idVRegs[i] = tmpIdVRegs[i].first;
+        finalIds[tmpIdVRegs[i].second] = i;
+    }
+    tmpIdVRegs.clear();
+    
+    // vreg ids of SSA infos of code blocks
+    std::vector<std::vector<size_t> > blockVarIds(codeBlocks.size());
+    for (size_t bi = 0; bi < codeBlocks.size(); bi++)
+    {
+        std::vector<std::pair<size_t, SSAInfo> >& ssaInfos = blockSSAInfos[bi];
+        for (auto& sentry: ssaInfos)
+            sentry.first = finalIds[sentry.first];
+        mapSort(ssaInfos.begin(), ssaInfos.end());
+        SSAInfoMap& ssaInfoMap = codeBlocks[bi].ssaInfoMap;
+        std::vector<size_t>& varIds = blockVarIds[bi];
+        ssaInfoMap.resize(ssaInfos.size());
+        varIds.resize(ssaInfos.size());
+        for (size_t k = 0; k < ssaInfos.size(); k++)
+        {
+            ssaInfoMap[k] = std::make_pair(idVRegs[ssaInfos[k].first],
+                        ssaInfos[k].second);
+            varIds[k] = ssaInfos[k].first;
+        }
+        std::vector<std::pair<size_t, SSAInfo> >().swap(ssaInfos);
+    }
+    
     std::deque<CallStackEntry> callStack;
     std::deque<FlowStackEntry> flowStack;
     // total SSA count
-    std::unordered_map<AsmSingleVReg, size_t> totalSSACountMap;
+    std::vector<size_t> totalSSACounts(idsNum, 0);
     // last SSA ids map from returns
     RetSSAIdMap retSSAIdMap;
     // last SSA ids in current way in code flow
-    std::unordered_map<AsmSingleVReg, size_t> curSSAIdMap;
+    std::vector<size_t> curSSAIds(idsNum, 0);
     // routine map - routine datas map, value - last SSA ids map
     std::unordered_map<size_t, RoutineData> routineMap;
     
-    LastOccurMap lastOccurMap;
-    
     std::vector<bool> visited(codeBlocks.size(), false);
     flowStack.push_back({ 0, 0 });
     
@@ -976,17 +1150,20 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
     {
         FlowStackEntry& entry = flowStack.back();
         CodeBlock& cblock = codeBlocks[entry.blockIndex];
+        const std::vector<size_t>& varIds = blockVarIds[entry.blockIndex];
         
         if (entry.nextIndex == 0)
         {
             // process current block
             if (!visited[entry.blockIndex])
             {
-                std::cout << "proc: " << entry.blockIndex << std::endl;
+                ARDOut << "proc: " << entry.blockIndex << std::endl;
                 visited[entry.blockIndex] = true;
                 
-                for (auto& ssaEntry: cblock.ssaInfoMap)
+                for (size_t k = 0; k < varIds.size(); k++)
                 {
+                    auto& ssaEntry = cblock.ssaInfoMap[k];
+                    const size_t varId = varIds[k];
                     SSAInfo& sinfo = ssaEntry.second;
                     if (ssaEntry.first.regVar==nullptr)
                     {
@@ -995,16 +1172,9 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                         continue; // no change for registers
                     }
                     
-                    if (sinfo.ssaIdChange != 0)
-                    {
-                        /*std::cout << "loccurpush: " << ssaEntry.first.regVar << ":" <<
-                                ssaEntry.first.index << ": " <<
-                                entry.blockIndex << std::endl;*/
-                        lastOccurMap[ssaEntry.first].push_back(false);
-                    }
-                    
-                    size_t& ssaId = curSSAIdMap[ssaEntry.first];
-                    auto ssaIdsIt = retSSAIdMap.find(ssaEntry.first);
+                    size_t& ssaId = curSSAIds[varId];
+                    auto ssaIdsIt = binaryMapFind(retSSAIdMap.begin(), retSSAIdMap.end(),
+                                varId);
                     if (ssaIdsIt != retSSAIdMap.end() && sinfo.readBeforeWrite)
                     {
                         auto& ssaIds = ssaIdsIt->second.ssaIds;
@@ -1025,27 +1195,28 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                         else if (ssaIds.size() == 1)
                             ssaId = ssaIds.front()+1; // plus one
                         
-                        std::cout << "retssa ssaid: " << ssaEntry.first.regVar << ":" <<
+                        ARDOut << "retssa ssaid: " << ssaEntry.first.regVar << ":" <<
                                 ssaEntry.first.index << ": " << ssaId << std::endl;
                         // replace smallest ssaId in routineMap lastSSAId entry
                         // reduce SSAIds replaces
                         for (size_t rblock: ssaIdsIt->second.routines)
-                            routineMap.find(rblock)->second.lastSSAIdMap[ssaEntry.first] =
-                                    std::vector<size_t>({ ssaId-1 });
+                            getVarIdEntry(routineMap.find(rblock)->second.lastSSAIdMap,
+                                    varId) = std::vector<size_t>({ ssaId-1 });
                         // finally remove from container (because obsolete)
                         retSSAIdMap.erase(ssaIdsIt);
                     }
                     
-                    size_t& totalSSACount = totalSSACountMap[ssaEntry.first];
+                    size_t& totalSSACount = totalSSACounts[varId];
+                    // SSA infos are sorted by id, prevSSAIds will be sorted
                     if (totalSSACount == 0)
                     {
                         // first read before write at all, need change totalcount, ssaId
                         ssaId++;
                         totalSSACount++;
-                        entry.prevSSAIds.insert({ ssaEntry.first, ssaId });
+                        entry.prevSSAIds.push_back({ varId, ssaId });
                     }
                     else if (ssaId != totalSSACount) // save old ssaId
-                        entry.prevSSAIds.insert({ ssaEntry.first, ssaId });
+                        entry.prevSSAIds.push_back({ varId, ssaId });
                     
                     sinfo.ssaId = totalSSACount;
                     sinfo.ssaIdFirst = sinfo.ssaIdChange!=0 ? totalSSACount : SIZE_MAX;
@@ -1064,16 +1235,16 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                         // put first SSAId before write
                         if (sinfo.readBeforeWrite)
                         {
-                            //std::cout << "PutCRBW: " << sinfo.ssaIdBefore << std::endl;
-                            rdata.rbwSSAIdMap.insert({ ssaEntry.first, sinfo.ssaIdBefore });
+                            //ARDOut << "PutCRBW: " << sinfo.ssaIdBefore << std::endl;
+                            insertVarIdEntry(rdata.rbwSSAIdMap, varId, sinfo.ssaIdBefore);
                         }
                         
                         if (sinfo.ssaIdChange != 0)
                         {
                             // put last SSAId
-                            //std::cout << "PutC: " << sinfo.ssaIdLast << std::endl;
-                            auto res = rdata.curSSAIdMap.insert({ ssaEntry.first,
-                                    { sinfo.ssaIdLast } });
+                            //ARDOut << "PutC: " << sinfo.ssaIdLast << std::endl;
+                            auto res = insertVarIdEntry(rdata.curSSAIdMap, varId,
+                                    std::vector<size_t>{ sinfo.ssaIdLast });
                             if (!res.second)
                             {
                                 // if not inserted
@@ -1103,21 +1274,21 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
             entry.blockIndex == callStack.back().callBlock &&
             entry.nextIndex-1 == callStack.back().callNextIndex)
         {
-            std::cout << " ret: " << entry.blockIndex << std::endl;
+            ARDOut << " ret: " << entry.blockIndex << std::endl;
             const RoutineData& prevRdata =
                     routineMap.find(callStack.back().routineBlock)->second;
             callStack.pop_back(); // just return from call
             if (!callStack.empty())
                 // put to parent routine
                 joinRoutineData(routineMap.find(callStack.back().routineBlock)->second,
-                                    prevRdata);
+                                    prevRdata, idVRegs);
         }
         
         if (entry.nextIndex < cblock.nexts.size())
         {
             if (cblock.nexts[entry.nextIndex].isCall)
             {
-                std::cout << " call: " << entry.blockIndex << std::endl;
+                ARDOut << " call: " << entry.blockIndex << std::endl;
                 callStack.push_back({ entry.blockIndex, entry.nextIndex,
                             cblock.nexts[entry.nextIndex].block });
                 routineMap.insert({ cblock.nexts[entry.nextIndex].block, { } });
@@ -1136,19 +1307,22 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                 for (const NextBlock& next: cblock.nexts)
                     if (next.isCall)
                     {
-                        //std::cout << "joincall:"<< next.block << std::endl;
+                        //ARDOut << "joincall:"<< next.block << std::endl;
                         auto it = routineMap.find(next.block); // must find
                         for (const auto& v: it->second.lastSSAIdMap)
                         {
-                            auto res = entry.prevRetSSAIdSets.insert({v.first, {}});
+                            auto res = insertVarIdEntry(entry.prevRetSSAIdSets,
+                                        v.first, RetSSAEntry());
                             if (!res.second)
                                 continue; // already added, do not change
-                            auto rfit = retSSAIdMap.find(v.first);
+                            auto rfit = binaryMapFind(retSSAIdMap.begin(),
+                                        retSSAIdMap.end(), v.first);
                             if (rfit != retSSAIdMap.end())
                                 res.first->second = rfit->second;
                         }
                         
-                        joinRetSSAIdMap(retSSAIdMap, it->second.lastSSAIdMap, next.block);
+                        joinRetSSAIdMap(retSSAIdMap, it->second.lastSSAIdMap,
+                                    next.block, idVRegs);
                     }
             }
             flowStack.push_back({ entry.blockIndex+1, 0 });
@@ -1162,18 +1336,20 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
             
             if (cblock.haveReturn && rdata != nullptr)
             {
-                std::cout << "procret: " << entry.blockIndex << std::endl;
-                joinLastSSAIdMap(rdata->lastSSAIdMap, rdata->curSSAIdMap);
-                std::cout << "procretend" << std::endl;
+                ARDOut << "procret: " << entry.blockIndex << std::endl;
+                joinLastSSAIdMap(rdata->lastSSAIdMap, rdata->curSSAIdMap, idVRegs);
+                ARDOut << "procretend" << std::endl;
             }
             
             // revert retSSAIdMap
-            for (auto v: entry.prevRetSSAIdSets)
+            for (const auto& v: entry.prevRetSSAIdSets)
             {
-                auto rfit = retSSAIdMap.find(v.first);
-                if (rdata!=nullptr)
+                auto rfit = binaryMapFind(retSSAIdMap.begin(), retSSAIdMap.end(),
+                            v.first);
+                if (rdata!=nullptr && rfit != retSSAIdMap.end())
                 {
-                    std::vector<size_t>& ssaIds = rdata->curSSAIdMap[v.first];
+                    std::vector<size_t>& ssaIds = getVarIdEntry(rdata->curSSAIdMap,
+                                v.first);
                     for (size_t ssaId: rfit->second.ssaIds)
                     {
                         auto ssaIdsIt = std::find(ssaIds.begin(), ssaIds.end(), ssaId);
@@ -1183,13 +1359,19 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                 }
                 
                 if (!v.second.ssaIds.empty())
-                    rfit->second = v.second;
-                else // erase if empty
-                    retSSAIdMap.erase(v.first);
+                {
+                    if (rfit != retSSAIdMap.end())
+                        rfit->second = v.second;
+                    else
+                        insertVarIdEntry(retSSAIdMap, v.first, v.second);
+                }
+                else if (rfit != retSSAIdMap.end()) // erase if empty
+                    retSSAIdMap.erase(rfit);
                 
                 if (rdata!=nullptr)
                 {
-                    std::vector<size_t>& ssaIds = rdata->curSSAIdMap[v.first];
+                    std::vector<size_t>& ssaIds = getVarIdEntry(rdata->curSSAIdMap,
+                                v.first);
                     for (size_t ssaId: v.second.ssaIds)
                     {
                         auto ssaIdsIt = std::find(ssaIds.begin(), ssaIds.end(), ssaId);
@@ -1197,99 +1379,77 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                             ssaIds.push_back(ssaId);
                     }
                     if (v.second.ssaIds.empty())
-                        ssaIds.push_back(curSSAIdMap[v.first]-1);
+                        ssaIds.push_back(curSSAIds[v.first]-1);
                     
-                    std::cout << " popentry2 " << entry.blockIndex << ": " <<
-                            v.first.regVar << ":" <<
-                            v.first.index << ":";
+                    ARDOut << " popentry2 " << entry.blockIndex << ": " <<
+                            idVRegs[v.first].regVar << ":" <<
+                            idVRegs[v.first].index << ":";
                     for (size_t v: ssaIds)
-                            std::cout << " " << v;
-                        std::cout << std::endl;
+                            ARDOut << " " << v;
+                        ARDOut << std::endl;
                     
                 }
             }
             //
             
-            for (const auto& ssaEntry: cblock.ssaInfoMap)
+            for (size_t k = 0; k < varIds.size(); k++)
             {
+                const auto& ssaEntry = cblock.ssaInfoMap[k];
+                const size_t varId = varIds[k];
                 if (ssaEntry.first.regVar == nullptr)
                     continue;
                 
-                auto it = entry.prevSSAIds.find(ssaEntry.first);
-                size_t& curSSAId = curSSAIdMap[ssaEntry.first];
+                auto it = binaryMapFind(entry.prevSSAIds.begin(), entry.prevSSAIds.end(),
+                            varId);
+                size_t& curSSAId = curSSAIds[varId];
                 const size_t nextSSAId = curSSAId;
                 if (it == entry.prevSSAIds.end())
                     curSSAId -= ssaEntry.second.ssaIdChange;
                 else // if found
                     curSSAId = it->second;
                 
-                std::cout << "popcurnext: " << ssaEntry.first.regVar <<
+                ARDOut << "popcurnext: " << ssaEntry.first.regVar <<
                             ":" << ssaEntry.first.index << ": " <<
                             nextSSAId << ", " << curSSAId << std::endl;
                 
                 if (rdata!=nullptr)
                 {
-                    std::vector<size_t>& ssaIds = rdata->curSSAIdMap[ssaEntry.first];
+                    std::vector<size_t>& ssaIds = getVarIdEntry(rdata->curSSAIdMap, varId);
                     
-                    std::cout << " pushentry " << entry.blockIndex << ": " <<
+                    ARDOut << " pushentry " << entry.blockIndex << ": " <<
                                 ssaEntry.first.regVar << ":" <<
                                 ssaEntry.first.index << ":";
                     for (size_t v: ssaIds)
-                        std::cout << " " << v;
-                    std::cout << std::endl;
+                        ARDOut << " " << v;
+                    ARDOut << std::endl;
                     
-                    /*if (ssaEntry.second.ssaIdChange != 0 &&
-                        lastOccurMap[ssaEntry.first].back())*/
                     {   // if cblock with some children
                         auto nit = std::find(ssaIds.begin(), ssaIds.end(), nextSSAId-1);
                         if (nit != ssaIds.end() && nextSSAId != curSSAId)
                         {
-                            std::cout << "erase in blk2: " << ssaEntry.first.regVar <<
+                            ARDOut << "erase in blk2: " << ssaEntry.first.regVar <<
                                     ":" << ssaEntry.first.index << ": " <<
                                     entry.blockIndex << " ssaId=" << *nit << std::endl;
                             ssaIds.erase(nit);  // just remove
                         }
                     }
                     // push previous SSAId to lastSSAIdMap (later will be replaced)
-                    /*std::cout << "call back: " << nextSSAId << "," <<
+                    /*ARDOut << "call back: " << nextSSAId << "," <<
                             (curSSAId) << std::endl;*/
                     auto fit = std::find(ssaIds.begin(), ssaIds.end(), curSSAId-1);
-                    /*if (entry.blockIndex == callStack.back().routineBlock)
-                    {   // just erase if end of traverse in routine
-                        if (fit != ssaIds.end())
-                        {
-                            std::cout << "erase in blk: " << ssaEntry.first.regVar <<
-                                    ":" << ssaEntry.first.index << ": " <<
-                                    entry.blockIndex << " ssaId=" << *fit << std::endl;
-                            ssaIds.erase(fit);
-                        }
-                    }
-                    else*/ if (fit == ssaIds.end())
+                    if (fit == ssaIds.end())
                         ssaIds.push_back(curSSAId-1);
                     
-                    std::cout << " popentry " << entry.blockIndex << ": " <<
+                    ARDOut << " popentry " << entry.blockIndex << ": " <<
                                 ssaEntry.first.regVar << ":" <<
                                 ssaEntry.first.index << ":";
                     for (size_t v: ssaIds)
-                        std::cout << " " << v;
-                    std::cout << std::endl;
-                }
-                
-                if (ssaEntry.second.ssaIdChange != 0)
-                {
-                    /*std::cout << "loccurpop: " << ssaEntry.first.regVar << ":" <<
-                                ssaEntry.first.index << ": " <<
-                                entry.blockIndex << std::endl;*/
-                    std::vector<bool>& lastOccur = lastOccurMap[ssaEntry.first];
-                    // erase indicator for last SSAEntry
-                    lastOccur.pop_back();
-                    if (!lastOccur.empty())
-                        // mark that parent have children
-                        lastOccur.back() = true;
+                        ARDOut << " " << v;
+                    ARDOut << std::endl;
                 }
             }
             
-            std::cout << "pop: " << entry.blockIndex << std::endl;
+            ARDOut << "pop: " << entry.blockIndex << std::endl;
             flowStack.pop_back();
         }
     }
@@ -1300,6 +1460,9 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
     flowStack.clear();
     std::fill(visited.begin(), visited.end(), false);
     flowStack.push_back({ 0, 0 });
+    ResolveSSATables resolveTables;
+    resolveTables.stackVarIndices.assign(idsNum, SIZE_MAX);
+    resolveTables.toResolveBlocks.assign(idsNum, SIZE_MAX);
     
     while (!flowStack.empty())
     {
@@ -1313,17 +1476,9 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
                 visited[entry.blockIndex] = true;
             else
             {
-                resolveSSAConflicts(flowStack, routineMap, codeBlocks, ssaReplacesMap);
+                resolveSSAConflicts(flowStack, routineMap, codeBlocks, blockVarIds,
+                            resolveTables, ssaReplacesMap);
                 
-                // join routine data
-                /*auto rit = routineMap.find(entry.blockIndex);
-                if (rit != routineMap.end())
-                    // just join with current routine data
-                    joinRoutineData(routineMap.find(
-                            callStack.back().routineBlock)->second, rit->second);*/
-                /*if (!callStack.empty())
-                    collectSSAIdsForCall(flowStack, callStack, visited,
-                            routineMap, codeBlocks);*/
                 // back, already visited
                 flowStack.pop_back();
                 continue;
@@ -1350,94 +1505,44 @@ void AsmRegAllocator::createSSAData(ISAUsageHandler& usageHandler)
 
 void AsmRegAllocator::applySSAReplaces()
 {
-    /* prepare SSA id replaces */
-    struct MinSSAGraphNode
-    {
-        size_t minSSAId;
-        bool visited;
-        std::unordered_set<size_t> nexts;
-        MinSSAGraphNode() : minSSAId(SIZE_MAX), visited(false) { }
-    };
-    struct MinSSAGraphStackEntry
-    {
-        std::unordered_map<size_t, MinSSAGraphNode>::iterator nodeIt;
-        std::unordered_set<size_t>::const_iterator nextIt;
-        size_t minSSAId;
-    };
-    
+    /* prepare SSA id replaces: SSA ids joined by replaces are this same variable,
+     * hence every SSA id is replaced by minimal SSA id of its joined set
+     * (disjoint sets, root of set is always minimal SSA id) */
     for (auto& entry: ssaReplacesMap)
     {
         std::vector<SSAReplace>& replaces = entry.second;
-        std::sort(replaces.begin(), replaces.end());
-        replaces.resize(std::unique(replaces.begin(), replaces.end()) - replaces.begin());
-        std::vector<SSAReplace> newReplaces;
-        
-        std::unordered_map<size_t, MinSSAGraphNode> ssaGraphNodes;
-        
-        auto it = replaces.begin();
-        while (it != replaces.end())
+        std::unordered_map<size_t, size_t> parents;
+        auto findRoot = [&parents](size_t ssaId)
         {
-            auto itEnd = std::upper_bound(it, replaces.end(),
-                            std::make_pair(it->first, size_t(SIZE_MAX)));
+            auto it = parents.insert({ ssaId, ssaId }).first;
+            while (it->second != ssaId)
             {
-                MinSSAGraphNode& node = ssaGraphNodes[it->first];
-                node.minSSAId = std::min(node.minSSAId, it->second);
-                for (auto it2 = it; it2 != itEnd; ++it2)
-                    node.nexts.insert(it->second);
+                auto pit = parents.find(it->second);
+                it->second = pit->second; // path halving
+                ssaId = it->second;
+                it = parents.find(ssaId);
             }
-            it = itEnd;
-        }
-        // propagate min value
-        std::stack<MinSSAGraphStackEntry> minSSAStack;
-        for (auto ssaGraphNodeIt = ssaGraphNodes.begin();
-                 ssaGraphNodeIt!=ssaGraphNodes.end(); )
+            return ssaId;
+        };
+        for (const SSAReplace& replace: replaces)
         {
-            minSSAStack.push({ ssaGraphNodeIt, ssaGraphNodeIt->second.nexts.begin() });
-            // traverse with minimalize SSA id
-            while (!minSSAStack.empty())
-            {
-                MinSSAGraphStackEntry& entry = minSSAStack.top();
-                MinSSAGraphNode& node = entry.nodeIt->second;
-                bool toPop = false;
-                if (entry.nextIt == node.nexts.begin())
-                {
-                    if (!node.visited)
-                        node.visited = true;
-                    else
-                        toPop = true;
-                }
-                if (!toPop && entry.nextIt != node.nexts.end())
-                {
-                    auto nodeIt = ssaGraphNodes.find(*entry.nextIt);
-                    if (nodeIt != ssaGraphNodes.end())
-                    {
-                        minSSAStack.push({ nodeIt, nodeIt->second.nexts.begin(),
-                                nodeIt->second.minSSAId });
-                    }
-                    ++entry.nextIt;
-                }
-                else
-                {
-                    node.minSSAId = std::min(node.minSSAId, entry.minSSAId);
-                    minSSAStack.pop();
-                    if (!minSSAStack.empty())
-                    {
-                        MinSSAGraphStackEntry& pentry = minSSAStack.top();
-                        pentry.minSSAId = std::min(pentry.minSSAId, node.minSSAId);
-                    }
-                }
-            }
-            // skip visited nodes
-            while (ssaGraphNodeIt != ssaGraphNodes.end())
-                if (!ssaGraphNodeIt->second.visited)
-                    break;
+            const size_t root1 = findRoot(replace.first);
+            const size_t root2 = findRoot(replace.second);
+            if (root1 < root2)
+                parents[root2] = root1;
+            else if (root2 < root1)
+                parents[root1] = root2;
         }
         
-        for (const auto& entry: ssaGraphNodes)
-            newReplaces.push_back({ entry.first, entry.second.minSSAId });
-        
+        std::vector<SSAReplace> newReplaces;
+        for (const auto& node: parents)
+        {
+            const size_t root = findRoot(node.first);
+            if (root != node.first)
+                newReplaces.push_back({ node.first, root });
+        }
         std::sort(newReplaces.begin(), newReplaces.end());
-        entry.second = newReplaces;
+        replaces.swap(newReplaces);
     }
     
     /* apply SSA id replaces */
@@ -1473,63 +1578,88 @@ void AsmRegAllocator::applySSAReplaces()
         }
 }
 
+// find SSA info of single vreg in code block (must exists)
+static inline const SSAInfo& findSSAInfo(const AsmRegAllocator::SSAInfoMap& ssaInfoMap,
+            const AsmSingleVReg& svreg)
+{
+    return binaryMapFind(ssaInfoMap.begin(), ssaInfoMap.end(), svreg)->second;
+}
+
+static inline SSAInfo& findSSAInfo(AsmRegAllocator::SSAInfoMap& ssaInfoMap,
+            const AsmSingleVReg& svreg)
+{
+    return binaryMapFind(ssaInfoMap.begin(), ssaInfoMap.end(), svreg)->second;
+}
+
+/* liveness of variable - sorted regions (start, end) in contiguous array.
+ * empty region (start==end) - variable written but not read */
 struct Liveness
 {
-    std::map<size_t, size_t> l;
+    typedef std::pair<size_t, size_t> Region;
+    std::vector<Region> l;
     
     Liveness() { }
     
     void clear()
-    { l.clear(); }
+    { std::vector<Region>().swap(l); }
+    
+    // find first region that starts at k or later
+    std::vector<Region>::iterator lowerBound(size_t k)
+    {
+        return std::lower_bound(l.begin(), l.end(), k,
+                [](const Region& r, size_t k) { return r.first < k; });
+    }
     
     void expand(size_t k)
     {
         if (l.empty())
-            l.insert(std::make_pair(k, k+1));
+            l.push_back(std::make_pair(k, k+1));
         else
-        {
-            auto it = l.end();
-            --it;
-            it->second = k+1;
-        }
+            l.back().second = k+1;
     }
     void newRegion(size_t k)
     {
         if (l.empty())
-            l.insert(std::make_pair(k, k));
-        else
+            l.push_back(std::make_pair(k, k));
+        else if (l.back().first < k)
+        {
+            if (l.back().second != k)
+                l.push_back(std::make_pair(k, k));
+        }
+        else if (l.back().first != k && l.back().second != k)
         {
-            auto it = l.end();
-            --it;
-            if (it->first != k && it->second != k)
-                l.insert(std::make_pair(k, k));
+            // insert before last regions (if not exists)
+            auto it = lowerBound(k);
+            if (it->first != k)
+                l.insert(it, std::make_pair(k, k));
         }
     }
     
     void insert(size_t k, size_t k2)
     {
-        auto it1 = l.lower_bound(k);
-        if (it1!=l.begin() && (it1==l.end() || it1->first>k))
-            --it1;
-        if (it1->second < k)
-            ++it1;
-        auto it2 = l.lower_bound(k2);
-        if (it1!=it2)
+        // first region that ends at k or later (overlapping or adjacent)
+        auto it1 = std::lower_bound(l.begin(), l.end(), k,
+                [](const Region& r, size_t k) { return r.second < k; });
+        // first region that starts after k2
+        auto it2 = std::upper_bound(it1, l.end(), k2,
+                [](size_t k2, const Region& r) { return k2 < r.first; });
+        if (it1 < it2)
         {
+            // join with overlapping and adjacent regions
             k = std::min(k, it1->first);
-            k2 = std::max(k2, (--it2)->second);
-            l.erase(it1, it2);
+            k2 = std::max(k2, (it2-1)->second);
+            it1 = l.erase(it1, it2);
         }
-        l.insert(std::make_pair(k, k2));
+        l.insert(it1, std::make_pair(k, k2));
     }
     
     bool contain(size_t t) const
     {
-        auto it = l.lower_bound(t);
-        if (it==l.begin() && it->first>t)
+        auto it = std::upper_bound(l.begin(), l.end(), t,
+                [](size_t t, const Region& r) { return t < r.first; });
+        if (it==l.begin())
             return false;
-        if (it==l.end() || it->first>t)
-            --it;
+        --it;
         return it->first<=t && t<it->second;
     }
     
@@ -1582,9 +1712,10 @@ static cxuint getRegType(size_t regTypesNum, const cxuint* regRanges,
     return regType;
 }
 
-static Liveness& getLiveness(const AsmSingleVReg& svreg, size_t ssaIdIdx,
-        const AsmRegAllocator::SSAInfo& ssaInfo, std::vector<Liveness>* livenesses,
-        const VarIndexMap* vregIndexMaps, size_t regTypesNum, const cxuint* regRanges)
+// get variable index (node index) from index of SSA id in code block
+static size_t getVarIndex(const AsmSingleVReg& svreg, size_t ssaIdIdx,
+        const AsmRegAllocator::SSAInfo& ssaInfo, const VarIndexMap* vregIndexMaps,
+        size_t regTypesNum, const cxuint* regRanges)
 {
     size_t ssaId;
     if (svreg.regVar==nullptr)
@@ -1602,175 +1733,133 @@ static Liveness& getLiveness(const AsmSingleVReg& svreg, size_t ssaIdIdx,
     const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
     const std::vector<size_t>& ssaIdIndices =
                 vregIndexMap.find(svreg)->second;
-    return livenesses[regType][ssaIdIndices[ssaId]];
+    return ssaIdIndices[ssaId];
 }
 
-typedef std::deque<FlowStackEntry>::const_iterator FlowStackCIter;
-
-struct VRegLastPos
-{
-    size_t ssaId; // last SSA id
-    std::vector<FlowStackCIter> blockChain; // subsequent blocks that changes SSAId
-};
-
 /* TODO: add handling calls
  * handle many start points in this code (for example many kernel's in same code)
- * replace sets by vector, and sort and remove same values on demand
  */
 
-typedef std::unordered_map<AsmSingleVReg, VRegLastPos> LastVRegMap;
-
-static void putCrossBlockLivenesses(const std::deque<FlowStackEntry>& flowStack,
-        const std::vector<CodeBlock>& codeBlocks,
-        const Array<size_t>& codeBlockLiveTimes, const LastVRegMap& lastVRegMap,
-        std::vector<Liveness>* livenesses, const VarIndexMap* vregIndexMaps,
-        size_t regTypesNum, const cxuint* regRanges)
+/* put livenesses between code blocks: variable live at end of block (read
+ * before write in any next block) lives from its last definition
+ * (or from start of block) to end of block.
+ * live variables at end of blocks are solved by iterative data flow
+ * (live in = read before write + live out not defined in block) */
+static void putCrossBlockLivenesses(const std::vector<CodeBlock>& codeBlocks,
+        const Array<size_t>& codeBlockLiveTimes, std::vector<Liveness>* livenesses,
+        const VarIndexMap* vregIndexMaps, size_t regTypesNum, const cxuint* regRanges)
 {
-    const CodeBlock& cblock = codeBlocks[flowStack.back().blockIndex];
-    for (const auto& entry: cblock.ssaInfoMap)
-        if (entry.second.readBeforeWrite)
+    const size_t blocksNum = codeBlocks.size();
+    // variable: first - regtype, second - variable index
+    typedef std::pair<size_t, size_t> Var;
+    std::vector<std::vector<Var> > usedVars(blocksNum);
+    std::vector<std::vector<Var> > definedVars(blocksNum);
+    std::vector<std::vector<size_t> > nextBlocks(blocksNum);
+    for (size_t i = 0; i < blocksNum; i++)
+    {
+        const CodeBlock& cblock = codeBlocks[i];
+        for (const auto& entry: cblock.ssaInfoMap)
         {
-            // find last 
-            auto lvrit = lastVRegMap.find(entry.first);
-            if (lvrit == lastVRegMap.end())
-                continue; // not found
-            const VRegLastPos& lastPos = lvrit->second;
-            FlowStackCIter flit = lastPos.blockChain.back();
-            cxuint regType = getRegType(regTypesNum, regRanges, entry.first);
-            const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
+            const SSAInfo& sinfo = entry.second;
+            const cxuint regType = getRegType(regTypesNum, regRanges, entry.first);
             const std::vector<size_t>& ssaIdIndices =
-                        vregIndexMap.find(entry.first)->second;
-            Liveness& lv = livenesses[regType][ssaIdIndices[entry.second.ssaIdBefore]];
-            FlowStackCIter flitEnd = flowStack.end();
-            --flitEnd; // before last element
-            // insert live time to last seen position
-            const CodeBlock& lastBlk = codeBlocks[flit->blockIndex];
-            size_t toLiveCvt = codeBlockLiveTimes[flit->blockIndex] - lastBlk.start;
-            lv.insert(lastBlk.ssaInfoMap.find(entry.first)->second.lastPos + toLiveCvt,
-                    toLiveCvt + lastBlk.end);
-            for (++flit; flit != flitEnd; ++flit)
-            {
-                const CodeBlock& cblock = codeBlocks[flit->blockIndex];
-                size_t blockLiveTime = codeBlockLiveTimes[flit->blockIndex];
-                lv.insert(blockLiveTime, cblock.end-cblock.start + blockLiveTime);
-            }
+                        vregIndexMaps[regType].find(entry.first)->second;
+            const bool realReg = entry.first.regVar == nullptr;
+            if (sinfo.readBeforeWrite)
+                usedVars[i].push_back({ regType,
+                        ssaIdIndices[realReg ? 0 : sinfo.ssaIdBefore] });
+            if (sinfo.ssaIdChange != 0)
+                definedVars[i].push_back({ regType,
+                        ssaIdIndices[realReg ? 0 : sinfo.ssaIdLast] });
         }
-}
-
-static void putCrossBlockForLoop(const std::deque<FlowStackEntry>& flowStack,
-        const std::vector<CodeBlock>& codeBlocks,
-        const Array<size_t>& codeBlockLiveTimes,
-        std::vector<Liveness>* livenesses, const VarIndexMap* vregIndexMaps,
-        size_t regTypesNum, const cxuint* regRanges)
-{
-    auto flitStart = flowStack.end();
-    --flitStart;
-    size_t curBlock = flitStart->blockIndex;
-    // find step in way
-    while (flitStart->blockIndex != curBlock) --flitStart;
-    auto flitEnd = flowStack.end();
-    --flitEnd;
-    std::unordered_map<AsmSingleVReg, std::pair<size_t, size_t> > varMap;
+        std::sort(usedVars[i].begin(), usedVars[i].end());
+        std::sort(definedVars[i].begin(), definedVars[i].end());
+        for (const NextBlock& next: cblock.nexts)
+            nextBlocks[i].push_back(next.block);
+        if ((cblock.nexts.empty() || cblock.haveCalls) && !cblock.haveReturn &&
+            !cblock.haveEnd && i+1 < blocksNum)
+            nextBlocks[i].push_back(i+1);
+    }
     
-    // collect var to check
-    size_t flowPos = 0;
-    for (auto flit = flitStart; flit != flitEnd; ++flit, flowPos++)
+    std::vector<std::vector<Var> > liveIns(blocksNum);
+    std::vector<std::vector<Var> > liveOuts(blocksNum);
+    std::vector<Var> liveOut, liveIn;
+    bool changed = true;
+    while (changed)
     {
-        const CodeBlock& cblock = codeBlocks[flit->blockIndex];
-        for (const auto& entry: cblock.ssaInfoMap)
+        changed = false;
+        for (size_t i = blocksNum; i > 0; i--)
         {
-            const SSAInfo& sinfo = entry.second;
-            size_t lastSSAId = (sinfo.ssaIdChange != 0) ? sinfo.ssaIdLast :
-                    (sinfo.readBeforeWrite) ? sinfo.ssaIdBefore : 0;
-            varMap[entry.first] = { lastSSAId, flowPos };
+            const size_t bi = i-1;
+            liveOut.clear();
+            for (size_t next: nextBlocks[bi])
+                liveOut.insert(liveOut.end(), liveIns[next].begin(),
+                            liveIns[next].end());
+            std::sort(liveOut.begin(), liveOut.end());
+            liveOut.resize(std::unique(liveOut.begin(), liveOut.end()) - liveOut.begin());
+            // live in = used + (live out - defined)
+            liveIn.clear();
+            std::set_difference(liveOut.begin(), liveOut.end(),
+                    definedVars[bi].begin(), definedVars[bi].end(),
+                    std::back_inserter(liveIn));
+            liveIn.insert(liveIn.end(), usedVars[bi].begin(), usedVars[bi].end());
+            std::sort(liveIn.begin(), liveIn.end());
+            liveIn.resize(std::unique(liveIn.begin(), liveIn.end()) - liveIn.begin());
+            if (liveIn != liveIns[bi])
+            {
+                liveIns[bi].swap(liveIn);
+                changed = true;
+            }
+            liveOuts[bi].swap(liveOut);
         }
     }
-    // find connections
-    flowPos = 0;
-    for (auto flit = flitStart; flit != flitEnd; ++flit, flowPos++)
+    
+    for (size_t i = 0; i < blocksNum; i++)
     {
-        const CodeBlock& cblock = codeBlocks[flit->blockIndex];
-        for (const auto& entry: cblock.ssaInfoMap)
+        const size_t blockStart = codeBlockLiveTimes[i];
+        const size_t blockEnd = blockStart + codeBlocks[i].end - codeBlocks[i].start;
+        for (const Var& var: liveOuts[i])
         {
-            const SSAInfo& sinfo = entry.second;
-            auto varMapIt = varMap.find(entry.first);
-            if (!sinfo.readBeforeWrite || varMapIt == varMap.end() ||
-                flowPos > varMapIt->second.second ||
-                sinfo.ssaIdBefore != varMapIt->second.first)
-                continue;
-            // just connect
-            
-            cxuint regType = getRegType(regTypesNum, regRanges, entry.first);
-            const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
-            const std::vector<size_t>& ssaIdIndices =
-                        vregIndexMap.find(entry.first)->second;
-            Liveness& lv = livenesses[regType][ssaIdIndices[entry.second.ssaIdBefore]];
-            
-            if (flowPos == varMapIt->second.second)
+            Liveness& lv = livenesses[var.first][var.second];
+            size_t start = blockStart;
+            if (std::binary_search(definedVars[i].begin(), definedVars[i].end(), var))
             {
-                // fill whole loop
-                for (auto flit2 = flitStart; flit != flitEnd; ++flit)
-                {
-                    const CodeBlock& cblock = codeBlocks[flit2->blockIndex];
-                    size_t blockLiveTime = codeBlockLiveTimes[flit2->blockIndex];
-                    lv.insert(blockLiveTime, cblock.end-cblock.start + blockLiveTime);
-                }
-                continue;
-            }
-            
-            size_t flowPos2 = 0;
-            for (auto flit2 = flitStart; flowPos2 < flowPos; ++flit2, flowPos++)
-            {
-                const CodeBlock& cblock = codeBlocks[flit2->blockIndex];
-                size_t blockLiveTime = codeBlockLiveTimes[flit2->blockIndex];
-                lv.insert(blockLiveTime, cblock.end-cblock.start + blockLiveTime);
-            }
-            // insert liveness for last block in loop of last SSAId (prev round)
-            auto flit2 = flitStart + flowPos;
-            const CodeBlock& firstBlk = codeBlocks[flit2->blockIndex];
-            size_t toLiveCvt = codeBlockLiveTimes[flit2->blockIndex] - firstBlk.start;
-            lv.insert(codeBlockLiveTimes[flit2->blockIndex],
-                    firstBlk.ssaInfoMap.find(entry.first)->second.firstPos + toLiveCvt);
-            // insert liveness for first block in loop of last SSAId
-            flit2 = flitStart + (varMapIt->second.second+1);
-            const CodeBlock& lastBlk = codeBlocks[flit2->blockIndex];
-            toLiveCvt = codeBlockLiveTimes[flit2->blockIndex] - lastBlk.start;
-            lv.insert(lastBlk.ssaInfoMap.find(entry.first)->second.lastPos + toLiveCvt,
-                    toLiveCvt + lastBlk.end);
-            // fill up loop end
-            for (++flit2; flit2 != flitEnd; ++flit2)
-            {
-                const CodeBlock& cblock = codeBlocks[flit2->blockIndex];
-                size_t blockLiveTime = codeBlockLiveTimes[flit2->blockIndex];
-                lv.insert(blockLiveTime, cblock.end-cblock.start + blockLiveTime);
+                // from last region in block (from definition)
+                auto it = lv.lowerBound(blockEnd);
+                if (it != lv.l.begin() && (it-1)->first >= blockStart)
+                    start = (it-1)->first;
             }
+            lv.insert(start, blockEnd);
         }
     }
 }
 
-struct LiveBlock
-{
-    size_t start;
-    size_t end;
-    size_t vidx;
-    
-    bool operator==(const LiveBlock& b) const
-    { return start==b.start && end==b.end && vidx==b.vidx; }
-    
-    bool operator<(const LiveBlock& b) const
-    { return start<b.start || (start==b.start &&
-            (end<b.end || (end==b.end && vidx<b.vidx))); }
-};
+typedef AsmRegAllocator::LiveBlock LiveBlock;
 
 typedef AsmRegAllocator::LinearDep LinearDep;
 typedef AsmRegAllocator::EqualToDep EqualToDep;
 typedef std::unordered_map<size_t, LinearDep> LinearDepMap;
 typedef std::unordered_map<size_t, EqualToDep> EqualToDepMap;
 
+// add dependency from variable to next variable (only once)
+template<typename T>
+static void addVarDep(std::unordered_map<size_t, T>& depMap, size_t vidx,
+            size_t nextVidx)
+{
+    if (vidx == nextVidx)
+        return;
+    std::vector<size_t>& nextVidxes = depMap[vidx].nextVidxes;
+    if (std::find(nextVidxes.begin(), nextVidxes.end(), nextVidx) != nextVidxes.end())
+        return; // already added
+    nextVidxes.push_back(nextVidx);
+    depMap[nextVidx].prevVidxes.push_back(vidx);
+}
+
 static void addUsageDeps(const cxbyte* ldeps, const cxbyte* edeps, cxuint rvusNum,
             const AsmRegVarUsage* rvus, LinearDepMap* ldepsOut,
             EqualToDepMap* edepsOut, const VarIndexMap* vregIndexMaps,
-            std::unordered_map<AsmSingleVReg, size_t> ssaIdIdxMap,
+            const std::unordered_map<AsmSingleVReg, size_t>& ssaIdIdxMap,
+            const AsmRegAllocator::SSAInfoMap& ssaInfoMap,
             size_t regTypesNum, const cxuint* regRanges)
 {
     // add linear deps
@@ -1793,19 +1882,15 @@ static void addUsageDeps(const cxbyte* ldeps, const cxbyte* edeps, cxuint rvusNu
                 auto sit = ssaIdIdxMap.find(svreg);
                 if (regType==UINT_MAX)
                     regType = getRegType(regTypesNum, regRanges, svreg);
-                const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
-                const std::vector<size_t>& ssaIdIndices =
-                            vregIndexMap.find(svreg)->second;
                 // push variable index
-                vidxes.push_back(ssaIdIndices[sit->second]);
+                vidxes.push_back(getVarIndex(svreg, sit->second,
+                        findSSAInfo(ssaInfoMap, svreg), vregIndexMaps,
+                        regTypesNum, regRanges));
             }
         }
         ldepsOut[regType][vidxes[0]].align = align;
         for (size_t k = 1; k < vidxes.size(); k++)
-        {
-            ldepsOut[regType][vidxes[k-1]].nextVidxes.push_back(vidxes[k]);
-            ldepsOut[regType][vidxes[k]].prevVidxes.push_back(vidxes[k-1]);
-        }
+            addVarDep(ldepsOut[regType], vidxes[k-1], vidxes[k]);
     }
     // add single arg linear dependencies
     for (cxuint i = 0; i < rvusNum; i++)
@@ -1820,17 +1905,14 @@ static void addUsageDeps(const cxbyte* ldeps, const cxbyte* edeps, cxuint rvusNu
                 auto sit = ssaIdIdxMap.find(svreg);
                 if (regType==UINT_MAX)
                     regType = getRegType(regTypesNum, regRanges, svreg);
-                const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
-                const std::vector<size_t>& ssaIdIndices =
-                            vregIndexMap.find(svreg)->second;
                 // push variable index
-                vidxes.push_back(ssaIdIndices[sit->second]);
+                vidxes.push_back(getVarIndex(svreg, sit->second,
+                        findSSAInfo(ssaInfoMap, svreg), vregIndexMaps,
+                        regTypesNum, regRanges));
             }
+            ldepsOut[regType][vidxes[0]].align = rvu.align;
             for (size_t j = 1; j < vidxes.size(); j++)
-            {
-                ldepsOut[regType][vidxes[j-1]].nextVidxes.push_back(vidxes[j]);
-                ldepsOut[regType][vidxes[j]].prevVidxes.push_back(vidxes[j-1]);
-            }
+                addVarDep(ldepsOut[regType], vidxes[j-1], vidxes[j]);
         }
         
     /* equalTo dependencies */
@@ -1850,17 +1932,13 @@ static void addUsageDeps(const cxbyte* ldeps, const cxbyte* edeps, cxuint rvusNu
             auto sit = ssaIdIdxMap.find(svreg);
             if (regType==UINT_MAX)
                 regType = getRegType(regTypesNum, regRanges, svreg);
-            const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
-            const std::vector<size_t>& ssaIdIndices =
-                        vregIndexMap.find(svreg)->second;
             // push variable index
-            vidxes.push_back(ssaIdIndices[sit->second]);
+            vidxes.push_back(getVarIndex(svreg, sit->second,
+                    findSSAInfo(ssaInfoMap, svreg), vregIndexMaps,
+                    regTypesNum, regRanges));
         }
         for (size_t j = 1; j < vidxes.size(); j++)
-        {
-            edepsOut[regType][vidxes[j-1]].nextVidxes.push_back(vidxes[j]);
-            edepsOut[regType][vidxes[j]].prevVidxes.push_back(vidxes[j-1]);
-        }
+            addVarDep(edepsOut[regType], vidxes[j-1], vidxes[j]);
     }
 }
 
@@ -1872,23 +1950,187 @@ struct EqualStackEntry
     size_t nextIdx; // over nextVidxes size, then prevVidxes[nextIdx-nextVidxes.size()]
 };
 
-void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
+/*
+ * interference graph
+ */
+
+void AsmInterGraph::resize(size_t _nodesNum)
+{
+    nodesNum = _nodesNum;
+    bitMatrixMode = (nodesNum <= bitMatrixMaxNodes);
+    rowWords = 0;
+    degrees.assign(nodesNum, 0);
+    bitMatrix.clear();
+    rowSummaries.clear();
+    adjOffsets.clear();
+    adjacency.clear();
+    cliqueOffsets.assign(1, 0);
+    cliqueNodes.clear();
+    if (bitMatrixMode)
+    {
+        rowWords = (nodesNum+63)>>6;
+        bitMatrix.assign(nodesNum*rowWords, 0);
+        rowSummaries.assign(nodesNum, 0);
+    }
+    else
+        adjOffsets.assign(nodesNum+1, 0);
+}
+
+void AsmInterGraph::addClique(const std::vector<size_t>& nodes)
+{
+    if (nodes.size() < 2)
+        return;
+    if (bitMatrixMode)
+    {
+        // set directly in bit matrix (in both rows)
+        for (size_t i = 0; i < nodes.size(); i++)
+            for (size_t j = i+1; j < nodes.size(); j++)
+            {
+                const size_t a = nodes[i], b = nodes[j];
+                if (a == b || bitMatrixTest(a, b))
+                    continue;
+                bitMatrixSet(a, b);
+                bitMatrixSet(b, a);
+                degrees[a]++;
+                degrees[b]++;
+            }
+        return;
+    }
+    // keep only clique, neighbors will be resolved at finish
+    cliqueNodes.insert(cliqueNodes.end(), nodes.begin(), nodes.end());
+    cliqueOffsets.push_back(cliqueNodes.size());
+}
+
+void AsmInterGraph::finish()
+{
+    if (bitMatrixMode)
+    {
+        cliqueOffsets.clear();
+        return;
+    }
+    const size_t cliquesNum = cliqueOffsets.size()-1;
+    // create node to cliques map (in CSR form)
+    std::vector<size_t> nodeCliqueOffsets(nodesNum+1, 0);
+    for (cxuint node: cliqueNodes)
+        nodeCliqueOffsets[node+1]++;
+    for (size_t i = 0; i < nodesNum; i++)
+        nodeCliqueOffsets[i+1] += nodeCliqueOffsets[i];
+    std::vector<cxuint> nodeCliques(cliqueNodes.size());
+    {
+        std::vector<size_t> fillPos(nodeCliqueOffsets.begin(),
+                    nodeCliqueOffsets.end()-1);
+        for (size_t c = 0; c < cliquesNum; c++)
+            for (size_t k = cliqueOffsets[c]; k < cliqueOffsets[c+1]; k++)
+                nodeCliques[fillPos[cliqueNodes[k]]++] = c;
+    }
+    
+    /* collect neighbors of every node from its cliques. first pass counts neighbors,
+     * second pass fills adjacency lists (to allocate exact memory) */
+    std::vector<size_t> lastVisitor(nodesNum, SIZE_MAX);
+    for (cxuint pass = 0; pass < 2; pass++)
+    {
+        if (pass == 1)
+        {
+            for (size_t node = 0; node < nodesNum; node++)
+                adjOffsets[node+1] = adjOffsets[node] + degrees[node];
+            adjacency.resize(adjOffsets[nodesNum]);
+            std::fill(lastVisitor.begin(), lastVisitor.end(), SIZE_MAX);
+        }
+        for (size_t node = 0; node < nodesNum; node++)
+        {
+            size_t adjPos = adjOffsets[node];
+            cxuint degree = 0;
+            lastVisitor[node] = node;
+            for (size_t k = nodeCliqueOffsets[node]; k < nodeCliqueOffsets[node+1]; k++)
+            {
+                const cxuint c = nodeCliques[k];
+                for (size_t l = cliqueOffsets[c]; l < cliqueOffsets[c+1]; l++)
+                {
+                    const cxuint nb = cliqueNodes[l];
+                    if (lastVisitor[nb] == node)
+                        continue;
+                    lastVisitor[nb] = node;
+                    if (pass == 0)
+                        degree++;
+                    else
+                        adjacency[adjPos++] = nb;
+                }
+            }
+            if (pass == 0)
+                degrees[node] = degree;
+            else
+                std::sort(adjacency.begin() + adjOffsets[node], adjacency.begin() + adjPos);
+        }
+    }
+    cliqueOffsets.clear();
+    cliqueOffsets.shrink_to_fit();
+    cliqueNodes.clear();
+    cliqueNodes.shrink_to_fit();
+}
+
+bool AsmInterGraph::isEdge(size_t a, size_t b) const
+{
+    if (a == b)
+        return false;
+    if (bitMatrixMode)
+        return bitMatrixTest(a, b);
+    return std::binary_search(adjacency.begin() + adjOffsets[a],
+                adjacency.begin() + adjOffsets[a+1], cxuint(b));
+}
+
+size_t AsmInterGraph::edgesNum() const
+{
+    size_t degreesSum = 0;
+    for (cxuint degree: degrees)
+        degreesSum += degree;
+    return degreesSum >> 1;
+}
+
+size_t AsmInterGraph::getMemoryUsage() const
+{
+    return degrees.capacity()*sizeof(cxuint) + bitMatrix.capacity()*sizeof(uint64_t) +
+        rowSummaries.capacity()*sizeof(uint64_t) +
+        adjOffsets.capacity()*sizeof(size_t) + adjacency.capacity()*sizeof(cxuint) +
+        cliqueOffsets.capacity()*sizeof(size_t) + cliqueNodes.capacity()*sizeof(cxuint);
+}
+
+void AsmRegAllocator::createLivenesses(ISAUsageHandler& usageHandler)
 {
     // construct var index maps
-    size_t graphVregsCounts[MAX_REGTYPES_NUM];
-    std::fill(graphVregsCounts, graphVregsCounts+regTypesNum, 0);
+    std::fill(vregsCounts, vregsCounts+MAX_REGTYPES_NUM, 0);
     cxuint regRanges[MAX_REGTYPES_NUM*2];
-    size_t regTypesNum;
     assembler.isaAssembler->getRegisterRanges(regTypesNum, regRanges);
+    for (size_t regType = 0; regType < MAX_REGTYPES_NUM; regType++)
+        varUsages[regType].clear();
     
+    /* variables are numbered in order of their first usage in code block
+     * (SSA infos are sorted by regvar address), hence allocation does not depend
+     * on placement of regvars in memory */
+    std::vector<size_t> ssaInfoOrder;
     for (const CodeBlock& cblock: codeBlocks)
-        for (const auto& entry: cblock.ssaInfoMap)
+    {
+        ssaInfoOrder.resize(cblock.ssaInfoMap.size());
+        for (size_t i = 0; i < ssaInfoOrder.size(); i++)
+            ssaInfoOrder[i] = i;
+        std::stable_sort(ssaInfoOrder.begin(), ssaInfoOrder.end(),
+                [&cblock](size_t i1, size_t i2)
+                { return cblock.ssaInfoMap[i1].second.firstPos <
+                        cblock.ssaInfoMap[i2].second.firstPos; });
+        for (size_t infoIndex: ssaInfoOrder)
         {
+            const auto& entry = cblock.ssaInfoMap[infoIndex];
             const SSAInfo& sinfo = entry.second;
             cxuint regType = getRegType(regTypesNum, regRanges, entry.first);
             VarIndexMap& vregIndices = vregIndexMaps[regType];
-            size_t& graphVregsCount = graphVregsCounts[regType];
+            size_t& graphVregsCount = vregsCounts[regType];
             std::vector<size_t>& ssaIdIndices = vregIndices[entry.first];
+            if (entry.first.regVar == nullptr)
+            {
+                // real register have single variable (SSA id 0)
+                if (ssaIdIndices.empty())
+                    ssaIdIndices.push_back(graphVregsCount++);
+                continue;
+            }
             size_t ssaIdCount = 0;
             if (sinfo.readBeforeWrite)
                 ssaIdCount = sinfo.ssaIdBefore+1;
@@ -1912,23 +2154,23 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
                 ssaIdIndices[sinfo.ssaIdLast] = graphVregsCount++;
             }
         }
+    }
     
     // construct vreg liveness
     std::deque<FlowStackEntry> flowStack;
     std::vector<bool> visited(codeBlocks.size(), false);
-    // hold last vreg ssaId and position
-    LastVRegMap lastVRegMap;
     // hold start live time position for every code block
     Array<size_t> codeBlockLiveTimes(codeBlocks.size());
-    std::unordered_set<size_t> blockInWay;
     
     std::vector<Liveness> livenesses[MAX_REGTYPES_NUM];
     
     for (size_t i = 0; i < regTypesNum; i++)
-        livenesses[i].resize(graphVregsCounts[i]);
+        livenesses[i].resize(vregsCounts[i]);
     
     size_t curLiveTime = 0;
     
+    if (!codeBlocks.empty())
+        flowStack.push_back({ 0, 0 });
     while (!flowStack.empty())
     {
         FlowStackEntry& entry = flowStack.back();
@@ -1937,75 +2179,63 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
         if (entry.nextIndex == 0)
         {
             // process current block
-            if (!blockInWay.insert(entry.blockIndex).second)
-            {
-                // if loop
-                putCrossBlockForLoop(flowStack, codeBlocks, codeBlockLiveTimes, 
-                        livenesses, vregIndexMaps, regTypesNum, regRanges);
-                flowStack.pop_back();
-                continue;
-            }
-            
-            codeBlockLiveTimes[entry.blockIndex] = curLiveTime;
-            putCrossBlockLivenesses(flowStack, codeBlocks, codeBlockLiveTimes, 
-                    lastVRegMap, livenesses, vregIndexMaps, regTypesNum, regRanges);
-            
-            for (const auto& sentry: cblock.ssaInfoMap)
-            {
-                const SSAInfo& sinfo = sentry.second;
-                // update
-                size_t lastSSAId =  (sinfo.ssaIdChange != 0) ? sinfo.ssaIdLast :
-                        (sinfo.readBeforeWrite) ? sinfo.ssaIdBefore : 0;
-                FlowStackCIter flit = flowStack.end();
-                --flit; // to last position
-                auto res = lastVRegMap.insert({ sentry.first, 
-                            { lastSSAId, { flit } } });
-                if (!res.second) // if not first seen, just update
-                {
-                    // update last
-                    res.first->second.ssaId = lastSSAId;
-                    res.first->second.blockChain.push_back(flit);
-                }
-            }
-            
-            size_t curBlockLiveEnd = cblock.end - cblock.start + curLiveTime;
             if (!visited[entry.blockIndex])
             {
                 visited[entry.blockIndex] = true;
+                codeBlockLiveTimes[entry.blockIndex] = curLiveTime;
                 std::unordered_map<AsmSingleVReg, size_t> ssaIdIdxMap;
                 AsmRegVarUsage instrRVUs[8];
                 cxuint instrRVUsCount = 0;
+                // usages of regvars in instruction (also from '.usereg')
+                std::vector<AsmRegVarUsage> instrVarRVUs;
                 
-                size_t oldOffset = cblock.usagePos.readOffset;
+                usageHandler.seekTo(cblock.start);
+                size_t oldOffset = usageHandler.getReadPos().readOffset;
                 std::vector<AsmSingleVReg> readSVRegs;
                 std::vector<AsmSingleVReg> writtenSVRegs;
                 
-                usageHandler.setReadPos(cblock.usagePos);
                 // register in liveness
                 while (true)
                 {
                     AsmRegVarUsage rvu = { 0U, nullptr, 0U, 0U };
-                    size_t liveTimeNext = curBlockLiveEnd;
+                    bool haveRvu = false;
                     if (usageHandler.hasNext())
                     {
                         rvu = usageHandler.nextUsage();
-                        if (rvu.offset >= cblock.end)
-                            break;
-                        if (!rvu.useRegMode)
-                            instrRVUs[instrRVUsCount++] = rvu;
-                        liveTimeNext = std::min(rvu.offset, cblock.end) -
-                                cblock.start + curLiveTime;
+                        haveRvu = (rvu.offset < cblock.end);
                     }
                     size_t liveTime = oldOffset - cblock.start + curLiveTime;
-                    if (!usageHandler.hasNext() || rvu.offset >= oldOffset)
+                    // register regvar usage with current variable index
+                    auto addVarUsage = [&](const AsmRegVarUsage& vrvu)
+                    {
+                        const AsmSingleVReg svreg{ vrvu.regVar, vrvu.rstart };
+                        const cxuint regType = getRegType(regTypesNum, regRanges,
+                                    svreg);
+                        const size_t vidx = getVarIndex(svreg, ssaIdIdxMap[svreg],
+                                findSSAInfo(cblock.ssaInfoMap, svreg),
+                                vregIndexMaps, regTypesNum, regRanges);
+                        varUsages[regType].push_back({ oldOffset, liveTime, vidx,
+                                vrvu.regField, vrvu.rwFlags,
+                                uint16_t(vrvu.rend-vrvu.rstart) });
+                    };
+                    if (!haveRvu || rvu.offset > oldOffset)
                     {
+                        // apply usages of previous instruction
+                        // reads use variables before writes
+                        for (const AsmRegVarUsage& vrvu: instrVarRVUs)
+                            if (vrvu.rwFlags != ASMRVU_WRITE ||
+                                vrvu.regField == ASMFIELD_NONE)
+                                addVarUsage(vrvu);
                         // apply to liveness
                         for (AsmSingleVReg svreg: readSVRegs)
                         {
-                            Liveness& lv = getLiveness(svreg, ssaIdIdxMap[svreg],
-                                    cblock.ssaInfoMap.find(svreg)->second,
-                                    livenesses, vregIndexMaps, regTypesNum, regRanges);
-                            if (!lv.l.empty() && (--lv.l.end())->first < curLiveTime)
+                            const cxuint regType = getRegType(regTypesNum, regRanges,
+                                    svreg);
+                            const size_t vidx = getVarIndex(svreg, ssaIdIdxMap[svreg],
+                                    findSSAInfo(cblock.ssaInfoMap, svreg),
+                                    vregIndexMaps, regTypesNum, regRanges);
+                            Liveness& lv = livenesses[regType][vidx];
+                            if (lv.l.empty() || lv.l.back().first < curLiveTime)
                                 lv.newRegion(curLiveTime); // begin region from this block
                             lv.expand(liveTime);
                         }
@@ -2013,14 +2243,22 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
                         {
                             size_t& ssaIdIdx = ssaIdIdxMap[svreg];
                             ssaIdIdx++;
-                            SSAInfo& sinfo = cblock.ssaInfoMap.find(svreg)->second;
-                            Liveness& lv = getLiveness(svreg, ssaIdIdx, sinfo,
-                                    livenesses, vregIndexMaps, regTypesNum, regRanges);
-                            if (liveTimeNext != curBlockLiveEnd)
-                                // because live after this instr
-                                lv.newRegion(liveTimeNext);
-                            sinfo.lastPos = liveTimeNext - curLiveTime + cblock.start;
+                            SSAInfo& sinfo = findSSAInfo(cblock.ssaInfoMap, svreg);
+                            const cxuint regType = getRegType(regTypesNum, regRanges,
+                                    svreg);
+                            const size_t vidx = getVarIndex(svreg, ssaIdIdx, sinfo,
+                                    vregIndexMaps, regTypesNum, regRanges);
+                            Liveness& lv = livenesses[regType][vidx];
+                            /* live after this instr (inside instruction, before
+                             * next instruction, also if no next usage in block) */
+                            lv.newRegion(liveTime+1);
+                            sinfo.lastPos = oldOffset+1;
                         }
+                        // writes use new variables
+                        for (const AsmRegVarUsage& vrvu: instrVarRVUs)
+                            if (vrvu.rwFlags == ASMRVU_WRITE &&
+                                vrvu.regField != ASMFIELD_NONE)
+                                addVarUsage(vrvu);
                         // get linear deps and equal to
                         cxbyte lDeps[16];
                         cxbyte eDeps[16];
@@ -2029,23 +2267,26 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
                         
                         addUsageDeps(lDeps, eDeps, instrRVUsCount, instrRVUs,
                                 linearDepMaps, equalToDepMaps, vregIndexMaps, ssaIdIdxMap,
-                                regTypesNum, regRanges);
+                                cblock.ssaInfoMap, regTypesNum, regRanges);
                         
                         readSVRegs.clear();
                         writtenSVRegs.clear();
-                        if (!usageHandler.hasNext())
+                        instrVarRVUs.clear();
+                        if (!haveRvu)
                             break; // end
                         oldOffset = rvu.offset;
                         instrRVUsCount = 0;
                     }
-                    if (rvu.offset >= cblock.end)
-                        break;
+                    if (!rvu.useRegMode)
+                        instrRVUs[instrRVUsCount++] = rvu;
+                    if (rvu.regVar != nullptr)
+                        instrVarRVUs.push_back(rvu);
                     
                     for (uint16_t rindex = rvu.rstart; rindex < rvu.rend; rindex++)
                     {
                         // per register/singlvreg
                         AsmSingleVReg svreg{ rvu.regVar, rindex };
-                        if (rvu.rwFlags == ASMRVU_WRITE && rvu.regField == ASMFIELD_NONE)
+                        if (rvu.rwFlags == ASMRVU_WRITE && rvu.regField != ASMFIELD_NONE)
                             writtenSVRegs.push_back(svreg);
                         else // read or treat as reading // expand previous region
                             readSVRegs.push_back(svreg);
@@ -2072,80 +2313,30 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
         }
         else // back
         {
-            // revert lastSSAIdMap
-            blockInWay.erase(entry.blockIndex);
             flowStack.pop_back();
-            if (!flowStack.empty())
-            {
-                for (const auto& sentry: cblock.ssaInfoMap)
-                {
-                    auto lvrit = lastVRegMap.find(sentry.first);
-                    if (lvrit != lastVRegMap.end())
-                    {
-                        VRegLastPos& lastPos = lvrit->second;
-                        lastPos.ssaId = sentry.second.ssaIdBefore;
-                        lastPos.blockChain.pop_back();
-                        if (lastPos.blockChain.empty()) // just remove from lastVRegs
-                            lastVRegMap.erase(lvrit);
-                    }
-                }
-            }
         }
     }
     
-    /// construct liveBlockMaps
-    std::set<LiveBlock> liveBlockMaps[MAX_REGTYPES_NUM];
+    putCrossBlockLivenesses(codeBlocks, codeBlockLiveTimes, livenesses,
+            vregIndexMaps, regTypesNum, regRanges);
+    
+    /// construct live blocks
     for (size_t regType = 0; regType < regTypesNum; regType++)
     {
-        std::set<LiveBlock>& liveBlockMap = liveBlockMaps[regType];
+        std::vector<LiveBlock>& liveBlockList = liveBlocks[regType];
         std::vector<Liveness>& liveness = livenesses[regType];
         for (size_t li = 0; li < liveness.size(); li++)
         {
             Liveness& lv = liveness[li];
-            for (const std::pair<size_t, size_t>& blk: lv.l)
-                if (blk.first != blk.second)
-                    liveBlockMap.insert({ blk.first, blk.second, li });
+            for (const auto& blk: lv.l)
+                // empty region - variable written but not read, it occupies
+                // register at next instruction
+                liveBlockList.push_back({ blk.first,
+                        std::max(blk.second, blk.first+1), li });
             lv.clear();
         }
         liveness.clear();
-    }
-    
-    // create interference graphs
-    for (size_t regType = 0; regType < regTypesNum; regType++)
-    {
-        InterGraph& interGraph = interGraphs[regType];
-        interGraph.resize(graphVregsCounts[regType]);
-        std::set<LiveBlock>& liveBlockMap = liveBlockMaps[regType];
-        
-        auto lit = liveBlockMap.begin();
-        size_t rangeStart = 0;
-        if (lit != liveBlockMap.end())
-            rangeStart = lit->start;
-        while (lit != liveBlockMap.end())
-        {
-            const size_t blkStart = lit->start;
-            const size_t blkEnd = lit->end;
-            size_t rangeEnd = blkEnd;
-            auto liStart = liveBlockMap.lower_bound({ rangeStart, 0, 0 });
-            auto liEnd = liveBlockMap.lower_bound({ rangeEnd, 0, 0 });
-            // collect from this range, variable indices
-            std::set<size_t> varIndices;
-            for (auto lit2 = liStart; lit2 != liEnd; ++lit2)
-                varIndices.insert(lit2->vidx);
-            // push to intergraph as full subgGraph
-            for (auto vit = varIndices.begin(); vit != varIndices.end(); ++vit)
-                for (auto vit2 = varIndices.begin(); vit2 != varIndices.end(); ++vit2)
-                    if (vit != vit2)
-                        interGraph[*vit].insert(*vit2);
-            // go to next live blocks
-            rangeStart = rangeEnd;
-            for (; lit != liveBlockMap.end(); ++lit)
-                if (lit->start != blkStart && lit->end != blkEnd)
-                    break;
-            if (lit == liveBlockMap.end())
-                break; // 
-            rangeStart = std::max(rangeStart, lit->start);
-        }
+        std::sort(liveBlockList.begin(), liveBlockList.end());
     }
     
     /*
@@ -2153,21 +2344,17 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
      */
     for (cxuint regType = 0; regType < regTypesNum; regType++)
     {
-        InterGraph& interGraph = interGraphs[regType];
-        const size_t nodesNum = interGraph.size();
+        const size_t nodesNum = vregsCounts[regType];
         const std::unordered_map<size_t, EqualToDep>& etoDepMap = equalToDepMaps[regType];
         std::vector<bool> visited(nodesNum, false);
         std::vector<std::vector<size_t> >& equalSetList = equalSetLists[regType];
         
-        for (size_t v = 0; v < nodesNum;)
+        for (size_t v = 0; v < nodesNum; v++)
         {
             auto it = etoDepMap.find(v);
-            if (it == etoDepMap.end())
-            {
-                // is not regvar in equalTo dependencies
-                v++;
+            if (visited[v] || it == etoDepMap.end())
+                // is not regvar in equalTo dependencies or already in equalSet
                 continue;
-            }
             
             std::stack<EqualStackEntry> etoStack;
             etoStack.push(EqualStackEntry{ it, 0 });
@@ -2188,6 +2375,7 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
                     if (!visited[vidx])
                     {
                         // push to this equalSet
+                        visited[vidx] = true;
                         equalSetMap.insert({ vidx, equalSetIndex });
                         equalSet.push_back(vidx);
                     }
@@ -2202,45 +2390,391 @@ void AsmRegAllocator::createInterferenceGraph(ISAUsageHandler& usageHandler)
                 if (entry.nextIdx < eToDep.nextVidxes.size())
                 {
                     auto nextIt = etoDepMap.find(eToDep.nextVidxes[entry.nextIdx]);
-                    etoStack.push(EqualStackEntry{ nextIt, 0 });
                     entry.nextIdx++;
+                    etoStack.push(EqualStackEntry{ nextIt, 0 });
                 }
                 else if (entry.nextIdx < eToDep.nextVidxes.size()+eToDep.prevVidxes.size())
                 {
                     auto nextIt = etoDepMap.find(eToDep.prevVidxes[
                                 entry.nextIdx - eToDep.nextVidxes.size()]);
-                    etoStack.push(EqualStackEntry{ nextIt, 0 });
                     entry.nextIdx++;
+                    etoStack.push(EqualStackEntry{ nextIt, 0 });
                 }
                 else
                     etoStack.pop();
             }
-            
-            // to first already added node (var)
-            while (v < nodesNum && !visited[v]) v++;
         }
     }
 }
 
-typedef AsmRegAllocator::InterGraph InterGraph;
+/* register types are allocated concurrently only if code have many variables,
+ * otherwise creating threads costs more than allocation */
+static const size_t parallelRegTypesMinVRegsNum = 2000;
+
+bool AsmRegAllocator::isParallelByRegTypes() const
+{
+    if (threadsNum == 1 || regTypesNum < 2)
+        return false;
+    size_t vregsNum = 0;
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+        vregsNum += vregsCounts[regType];
+    return vregsNum >= parallelRegTypesMinVRegsNum;
+}
+
+void AsmRegAllocator::createInterferenceGraph()
+{
+    if (isParallelByRegTypes())
+        runParallel(regTypesNum, threadsNum, [this](size_t regType)
+            { createInterferenceGraph(regType); });
+    else
+        for (size_t regType = 0; regType < regTypesNum; regType++)
+            createInterferenceGraph(regType);
+}
+
+void AsmRegAllocator::createInterferenceGraph(size_t regType)
+{
+    PassTimer timer(timePasses, stats.interGraphTimes[regType]);
+    std::vector<LiveBlock> activeBlocks;
+    std::vector<size_t> varIndices;
+    InterGraph& interGraph = interGraphs[regType];
+    interGraph.resize(vregsCounts[regType]);
+    
+    /* sweep by live blocks sorted by start. variables live at this same point
+     * create clique. only maximal cliques are pushed: before first
+     * ending of live block after adding new live blocks */
+    bool activeGrown = false;
+    auto pushActiveClique = [&interGraph, &activeBlocks, &varIndices]()
+    {
+        varIndices.clear();
+        for (const LiveBlock& lb: activeBlocks)
+            varIndices.push_back(lb.vidx);
+        std::sort(varIndices.begin(), varIndices.end());
+        varIndices.resize(std::unique(varIndices.begin(), varIndices.end()) -
+                    varIndices.begin());
+        interGraph.addClique(varIndices);
+    };
+    
+    for (const LiveBlock& lb: liveBlocks[regType])
+    {
+        bool haveEnded = false;
+        for (const LiveBlock& alb: activeBlocks)
+            if (alb.end <= lb.start)
+            {
+                haveEnded = true;
+                break;
+            }
+        if (haveEnded)
+        {
+            if (activeGrown)
+                pushActiveClique();
+            activeGrown = false;
+            activeBlocks.resize(std::remove_if(activeBlocks.begin(),
+                    activeBlocks.end(), [&lb](const LiveBlock& alb)
+                    { return alb.end <= lb.start; }) - activeBlocks.begin());
+        }
+        activeBlocks.push_back(lb);
+        activeGrown = true;
+    }
+    if (activeGrown)
+        pushActiveClique();
+    interGraph.finish();
+}
+
+/* DSatur coloring: nodes are held in bucket queue by saturation degree
+ * (number of distinct colors of neighbors). every node holds bitset of neighbor's
+ * colors, hence coloring a node updates its neighbors in constant time.
+ * nodes with this same saturation degree are chosen in LIFO order, and at start
+ * in order of decreasing degree */
 
-struct CLRX_INTERNAL SDOLDOCompare
+cxuint AsmInterGraph::color(Array<cxuint>& colors, cxuint maxColorsNum,
+            const std::vector<std::vector<size_t> >& equalSetList,
+            const std::unordered_map<size_t, size_t>& equalSetMap,
+            const std::vector<ColorGroup>& groups) const
 {
-    const InterGraph& interGraph;
-    const Array<size_t>& sdoCounts;
+    cxuint colorsNum = 0;
+    for (cxuint c: colors)
+        if (c != UINT_MAX)
+            colorsNum = std::max(colorsNum, c+1);
+    const size_t colorWords = (std::max(colorsNum, maxColorsNum) + 64) >> 6;
+    std::vector<uint64_t> nbColors(nodesNum*colorWords, 0);
+    std::vector<cxuint> satDegrees(nodesNum, 0);
+    // bucket queue (doubly linked lists)
+    std::vector<size_t> bucketHeads(colorWords*64 + 1, SIZE_MAX);
+    std::vector<size_t> prevNodes(nodesNum, SIZE_MAX);
+    std::vector<size_t> nextNodes(nodesNum, SIZE_MAX);
+    size_t maxSatDegree = 0;
     
-    SDOLDOCompare(const InterGraph& _interGraph, const Array<size_t>&_sdoCounts)
-        : interGraph(_interGraph), sdoCounts(_sdoCounts)
-    { }
+    auto pushToBucket = [&](size_t node)
+    {
+        const cxuint sat = satDegrees[node];
+        prevNodes[node] = SIZE_MAX;
+        nextNodes[node] = bucketHeads[sat];
+        if (bucketHeads[sat] != SIZE_MAX)
+            prevNodes[bucketHeads[sat]] = node;
+        bucketHeads[sat] = node;
+        maxSatDegree = std::max(maxSatDegree, size_t(sat));
+    };
+    auto removeFromBucket = [&](size_t node)
+    {
+        if (prevNodes[node] != SIZE_MAX)
+            nextNodes[prevNodes[node]] = nextNodes[node];
+        else
+            bucketHeads[satDegrees[node]] = nextNodes[node];
+        if (nextNodes[node] != SIZE_MAX)
+            prevNodes[nextNodes[node]] = prevNodes[node];
+    };
+    // put color to neighbors of node and update their saturation degrees
+    auto putColorToNeighbors = [&](size_t node, cxuint color)
+    {
+        for (size_t nb: (*this)[node])
+        {
+            if (colors[nb] != UINT_MAX)
+                continue;
+            uint64_t& word = nbColors[nb*colorWords + (color>>6)];
+            const uint64_t mask = 1ULL<<(color&63);
+            if ((word & mask) != 0)
+                continue;
+            word |= mask;
+            removeFromBucket(nb);
+            satDegrees[nb]++;
+            pushToBucket(nb);
+        }
+    };
     
-    bool operator()(size_t a, size_t b) const
     {
-        if (sdoCounts[a] > sdoCounts[b])
-            return true;
-        return interGraph[a].size() > interGraph[b].size();
+        // first chosen will be nodes with greatest degree
+        std::vector<size_t> nodeOrder;
+        for (size_t i = 0; i < nodesNum; i++)
+            if (colors[i] == UINT_MAX)
+                nodeOrder.push_back(i);
+        std::stable_sort(nodeOrder.begin(), nodeOrder.end(), [this](size_t a, size_t b)
+                { return degrees[a] < degrees[b]; });
+        for (size_t node: nodeOrder)
+            pushToBucket(node);
     }
+    // put colors of already colored nodes
+    for (size_t i = 0; i < nodesNum; i++)
+        if (colors[i] != UINT_MAX)
+            putColorToNeighbors(i, colors[i]);
+    
+    // group of every node (SIZE_MAX - not in group)
+    std::vector<size_t> nodeGroups(groups.empty() ? 0 : nodesNum, SIZE_MAX);
+    for (size_t gi = 0; gi < groups.size(); gi++)
+        for (const auto& entry: groups[gi].nodes)
+            nodeGroups[entry.first] = gi;
+    /* color whole group at once: first base color (aligned) that is not
+     * used by neighbors of any node in group, or base given by colored node */
+    auto colorGroup = [&](const ColorGroup& group)
+    {
+        cxuint size = 0;
+        cxuint base = UINT_MAX;
+        for (const auto& entry: group.nodes)
+        {
+            size = std::max(size, entry.second+1);
+            const cxuint c = colors[entry.first];
+            if (c == UINT_MAX)
+                continue;
+            if (c < entry.second || (base != UINT_MAX && base != c-entry.second))
+                throw AsmException("Inconsistent linear dependencies");
+            base = c - entry.second;
+        }
+        if (base == UINT_MAX)
+        {
+            for (base = 0; base + size <= maxColorsNum; base++)
+            {
+                bool good = true;
+                for (const auto& alignEntry: group.aligns)
+                    if (((base + alignEntry.first) % alignEntry.second) != 0)
+                    {
+                        good = false;
+                        break;
+                    }
+                for (auto it = group.nodes.begin(); good && it != group.nodes.end(); ++it)
+                {
+                    const cxuint c = base + it->second;
+                    if ((nbColors[it->first*colorWords + (c>>6)] & (1ULL<<(c&63))) != 0)
+                        good = false;
+                }
+                if (good)
+                    break;
+            }
+        }
+        if (base + size > maxColorsNum && base + size > colorsNum)
+            throw AsmException("Too many register is needed");
+        colorsNum = std::max(colorsNum, base + size);
+        for (const auto& entry: group.nodes)
+            if (colors[entry.first] == UINT_MAX)
+            {
+                removeFromBucket(entry.first);
+                colors[entry.first] = base + entry.second;
+            }
+        for (const auto& entry: group.nodes)
+            putColorToNeighbors(entry.first, base + entry.second);
+    };
+    
+    std::vector<size_t> singleNode(1);
+    std::vector<uint64_t> usedColors(colorWords);
+    while (true)
+    {
+        while (maxSatDegree != 0 && bucketHeads[maxSatDegree] == SIZE_MAX)
+            maxSatDegree--;
+        const size_t node = bucketHeads[maxSatDegree];
+        if (node == SIZE_MAX)
+            break; // all nodes colored
+        
+        if (!nodeGroups.empty() && nodeGroups[node] != SIZE_MAX)
+        {
+            colorGroup(groups[nodeGroups[node]]);
+            continue;
+        }
+        
+        const std::vector<size_t>* equalNodes = &singleNode;
+        singleNode[0] = node; // only one node, if equalSet not found
+        auto equalSetMapIt = equalSetMap.find(node);
+        if (equalSetMapIt != equalSetMap.end())
+            // found, get equal set from equalSetList
+            equalNodes = &equalSetList[equalSetMapIt->second];
+        
+        cxuint color = UINT_MAX;
+        std::fill(usedColors.begin(), usedColors.end(), 0);
+        for (size_t enode: *equalNodes)
+        {
+            if (colors[enode] != UINT_MAX)
+                color = colors[enode]; // use color of already colored node
+            for (size_t w = 0; w < colorWords; w++)
+                usedColors[w] |= nbColors[enode*colorWords + w];
+        }
+        if (color == UINT_MAX)
+        {
+            // find first usable color
+            for (color = 0; color < colorsNum; color++)
+                if ((usedColors[color>>6] & (1ULL<<(color&63))) == 0)
+                    break;
+            if (color == colorsNum) // add new color if needed
+            {
+                if (colorsNum >= maxColorsNum)
+                    throw AsmException("Too many register is needed");
+                colorsNum++;
+            }
+        }
+        
+        for (size_t enode: *equalNodes)
+            if (colors[enode] == UINT_MAX)
+            {
+                removeFromBucket(enode);
+                colors[enode] = color;
+            }
+        for (size_t enode: *equalNodes)
+            putColorToNeighbors(enode, color);
+    }
+    return colorsNum;
+}
+
+/* group of variables in consecutive registers (register range). variables
+ * from equal set share one slot (represented by first node of equal set),
+ * linear dependencies join slots into group */
+
+struct LinearGroup
+{
+    size_t start, end;  // live interval
+    cxuint size;    // number of registers
+    cxuint reg;     // first register
+    bool fixed;     // if have real registers
+    // slot node and its position in group
+    std::vector<std::pair<size_t, cxuint> > slots;
+    // position in group and alignment
+    std::vector<std::pair<cxuint, cxuint> > aligns;
 };
 
+typedef std::vector<std::vector<size_t> > EqualSetList;
+typedef std::unordered_map<size_t, size_t> EqualSetMap;
+
+static inline size_t getSlotOfNode(size_t node, const EqualSetList& equalSetList,
+            const EqualSetMap& equalSetMap)
+{
+    auto it = equalSetMap.find(node);
+    return (it != equalSetMap.end()) ? equalSetList[it->second][0] : node;
+}
+
+template<typename F>
+static void forEachSlotNode(size_t slot, const EqualSetList& equalSetList,
+            const EqualSetMap& equalSetMap, F func)
+{
+    auto it = equalSetMap.find(slot);
+    if (it != equalSetMap.end())
+        for (size_t node: equalSetList[it->second])
+            func(node);
+    else
+        func(slot);
+}
+
+// create groups (traverse by linear dependencies)
+static void createLinearGroups(size_t nodesNum, const LinearDepMap& linearDepMap,
+            const EqualSetList& equalSetList, const EqualSetMap& equalSetMap,
+            std::vector<LinearGroup>& groups)
+{
+    std::vector<size_t> slotGroups(nodesNum, SIZE_MAX);
+    std::vector<ptrdiff_t> slotPositions(nodesNum, 0);
+    std::vector<size_t> slotStack;
+    std::vector<std::pair<size_t, cxuint> > slotAligns;
+    for (size_t v = 0; v < nodesNum; v++)
+    {
+        if (getSlotOfNode(v, equalSetList, equalSetMap) != v ||
+            slotGroups[v] != SIZE_MAX)
+            continue;
+        const size_t groupIndex = groups.size();
+        groups.push_back(LinearGroup{ SIZE_MAX, 0, 0, 0, false });
+        LinearGroup& group = groups.back();
+        ptrdiff_t minPos = 0, maxPos = 0;
+        slotGroups[v] = groupIndex;
+        slotStack.push_back(v);
+        while (!slotStack.empty())
+        {
+            const size_t slot = slotStack.back();
+            slotStack.pop_back();
+            const ptrdiff_t pos = slotPositions[slot];
+            minPos = std::min(minPos, pos);
+            maxPos = std::max(maxPos, pos);
+            group.slots.push_back({ slot, 0 });
+            forEachSlotNode(slot, equalSetList, equalSetMap, [&](size_t node)
+            {
+                auto ldit = linearDepMap.find(node);
+                if (ldit == linearDepMap.end())
+                    return;
+                const LinearDep& ldep = ldit->second;
+                if (ldep.align > 1)
+                    slotAligns.push_back({ slot, ldep.align });
+                // next nodes is in next position, previous in previous position
+                for (size_t k = 0; k < ldep.nextVidxes.size() +
+                            ldep.prevVidxes.size(); k++)
+                {
+                    const bool isNext = k < ldep.nextVidxes.size();
+                    const size_t nextSlot = getSlotOfNode(isNext ? ldep.nextVidxes[k] :
+                                ldep.prevVidxes[k - ldep.nextVidxes.size()],
+                                equalSetList, equalSetMap);
+                    const ptrdiff_t nextPos = isNext ? pos+1 : pos-1;
+                    if (slotGroups[nextSlot] == SIZE_MAX)
+                    {
+                        slotGroups[nextSlot] = groupIndex;
+                        slotPositions[nextSlot] = nextPos;
+                        slotStack.push_back(nextSlot);
+                    }
+                    else if (slotPositions[nextSlot] != nextPos)
+                        throw AsmException("Inconsistent linear dependencies");
+                }
+            });
+        }
+        // normalize positions
+        group.size = maxPos - minPos + 1;
+        for (auto& slotEntry: group.slots)
+            slotEntry.second = slotPositions[slotEntry.first] - minPos;
+        for (const auto& alignEntry: slotAligns)
+            group.aligns.push_back({ cxuint(slotPositions[alignEntry.first] - minPos),
+                        alignEntry.second });
+        slotAligns.clear();
+    }
+}
+
 /* algorithm to allocate regranges:
  * from smallest regranges to greatest regranges:
  *   choosing free register: from smallest free regranges
@@ -2254,109 +2788,453 @@ void AsmRegAllocator::colorInterferenceGraph()
 {
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
                     assembler.deviceType);
+    auto colorRegType = [this, arch](size_t regType)
+    {
+        usedRegsNums[regType] = colorInterferenceGraph(regType,
+                    getGPUMaxRegistersNum(arch, regType));
+    };
+    if (isParallelByRegTypes())
+        runParallel(regTypesNum, threadsNum, colorRegType);
+    else
+        for (size_t regType = 0; regType < regTypesNum; regType++)
+            colorRegType(regType);
+}
+
+cxuint AsmRegAllocator::colorInterferenceGraph(size_t regType, cxuint maxColorsNum)
+{
+    PassTimer timer(timePasses, stats.colorTimes[regType]);
+    cxuint regRanges[MAX_REGTYPES_NUM*2];
+    size_t regTypesNum;
+    assembler.isaAssembler->getRegisterRanges(regTypesNum, regRanges);
+    const InterGraph& interGraph = interGraphs[regType];
+    const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
+    Array<cxuint>& gcMap = graphColorMaps[regType];
     
-    for (size_t regType = 0; regType < regTypesNum; regType++)
+    const size_t nodesNum = interGraph.size();
+    gcMap.resize(nodesNum);
+    std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
+    
+    // firstly, allocate real registers
+    for (const auto& entry: vregIndexMap)
+        if (entry.first.regVar == nullptr)
+            gcMap[entry.second[0]] = entry.first.index - regRanges[regType<<1];
+    
+    // register ranges must have consecutive colors
+    const EqualSetList& equalSetList = equalSetLists[regType];
+    const EqualSetMap& equalSetMap = equalSetMaps[regType];
+    std::vector<LinearGroup> linearGroups;
+    createLinearGroups(nodesNum, linearDepMaps[regType], equalSetList, equalSetMap,
+                linearGroups);
+    std::vector<AsmInterGraph::ColorGroup> colorGroups;
+    for (const LinearGroup& lgroup: linearGroups)
     {
-        const size_t maxColorsNum = getGPUMaxRegistersNum(arch, regType);
-        InterGraph& interGraph = interGraphs[regType];
-        const VarIndexMap& vregIndexMap = vregIndexMaps[regType];
-        Array<cxuint>& gcMap = graphColorMaps[regType];
-        const std::vector<std::vector<size_t> >& equalSetList = equalSetLists[regType];
-        const std::unordered_map<size_t, size_t>& equalSetMap =  equalSetMaps[regType];
-        
-        const size_t nodesNum = interGraph.size();
-        gcMap.resize(nodesNum);
-        std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
-        Array<size_t> sdoCounts(nodesNum);
-        std::fill(sdoCounts.begin(), sdoCounts.end(), 0);
-        
-        SDOLDOCompare compare(interGraph, sdoCounts);
-        std::set<size_t, SDOLDOCompare> nodeSet(compare);
-        for (size_t i = 0; i < nodesNum; i++)
-            nodeSet.insert(i);
-        
-        cxuint colorsNum = 0;
-        // firstly, allocate real registers
-        for (const auto& entry: vregIndexMap)
-            if (entry.first.regVar == nullptr)
-                gcMap[entry.second[0]] = colorsNum++;
-        
-        for (size_t colored = 0; colored < nodesNum; colored++)
-        {
-            size_t node = *nodeSet.begin();
-            if (gcMap[node] != UINT_MAX)
-                continue; // already colored
-            size_t color = 0;
-            std::vector<size_t> equalNodes;
-            equalNodes.push_back(node); // only one node, if equalSet not found
-            auto equalSetMapIt = equalSetMap.find(node);
-            if (equalSetMapIt != equalSetMap.end())
-                // found, get equal set from equalSetList
-                equalNodes = equalSetList[equalSetMapIt->second];
-            
-            for (color = 0; color <= colorsNum; color++)
-            {
-                // find first usable color
-                bool thisSame = false;
-                for (size_t nb: interGraph[node])
-                    if (gcMap[nb] == color)
-                    {
-                        thisSame = true;
-                        break;
-                    }
-                if (!thisSame)
+        if (lgroup.size <= 1 && lgroup.aligns.empty())
+            continue;
+        colorGroups.push_back({ {}, lgroup.aligns });
+        AsmInterGraph::ColorGroup& cgroup = colorGroups.back();
+        for (const auto& slotEntry: lgroup.slots)
+            forEachSlotNode(slotEntry.first, equalSetList, equalSetMap,
+                [&cgroup, &slotEntry](size_t node)
+                { cgroup.nodes.push_back({ node, slotEntry.second }); });
+    }
+    
+    return interGraph.color(gcMap, maxColorsNum, equalSetList, equalSetMap,
+                colorGroups);
+}
+
+/* linear scan allocation: every variable has single live interval (from first start
+ * to last end of its live blocks). groups are allocated in order of start of
+ * their intervals. groups that hold real registers are reserved before allocation */
+
+void AsmRegAllocator::allocateLinearScan()
+{
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                    assembler.deviceType);
+    auto allocRegType = [this, arch](size_t regType)
+    {
+        usedRegsNums[regType] = allocateLinearScan(regType,
+                    getGPUMaxRegistersNum(arch, regType));
+    };
+    if (isParallelByRegTypes())
+        runParallel(regTypesNum, threadsNum, allocRegType);
+    else
+        for (size_t regType = 0; regType < regTypesNum; regType++)
+            allocRegType(regType);
+}
+
+cxuint AsmRegAllocator::allocateLinearScan(size_t regType, cxuint maxRegsNum)
+{
+    PassTimer timer(timePasses, stats.colorTimes[regType]);
+    cxuint regRanges[MAX_REGTYPES_NUM*2];
+    size_t regTypesNum;
+    assembler.isaAssembler->getRegisterRanges(regTypesNum, regRanges);
+    const size_t nodesNum = vregsCounts[regType];
+    const EqualSetList& equalSetList = equalSetLists[regType];
+    const EqualSetMap& equalSetMap = equalSetMaps[regType];
+    Array<cxuint>& gcMap = graphColorMaps[regType];
+    gcMap.resize(nodesNum);
+    std::fill(gcMap.begin(), gcMap.end(), cxuint(UINT_MAX));
+    
+    // live intervals of variables
+    std::vector<size_t> nodeStarts(nodesNum, SIZE_MAX);
+    std::vector<size_t> nodeEnds(nodesNum, 0);
+    for (const LiveBlock& lb: liveBlocks[regType])
+    {
+        nodeStarts[lb.vidx] = std::min(nodeStarts[lb.vidx], lb.start);
+        nodeEnds[lb.vidx] = std::max(nodeEnds[lb.vidx], lb.end);
+    }
+    
+    std::vector<cxuint> fixedRegs(nodesNum, UINT_MAX);
+    for (const auto& entry: vregIndexMaps[regType])
+        if (entry.first.regVar == nullptr && !entry.second.empty() &&
+            entry.second[0] != SIZE_MAX)
+            fixedRegs[getSlotOfNode(entry.second[0], equalSetList, equalSetMap)] =
+                    entry.first.index - regRanges[regType<<1];
+    
+    std::vector<LinearGroup> groups;
+    createLinearGroups(nodesNum, linearDepMaps[regType], equalSetList, equalSetMap,
+                groups);
+    cxuint regsNum = maxRegsNum;
+    for (LinearGroup& group: groups)
+    {
+        for (const auto& slotEntry: group.slots)
+            forEachSlotNode(slotEntry.first, equalSetList, equalSetMap,
+                [&group, &nodeStarts, &nodeEnds](size_t node)
+                {
+                    group.start = std::min(group.start, nodeStarts[node]);
+                    group.end = std::max(group.end, nodeEnds[node]);
+                });
+        // set fixed register for real registers
+        for (const auto& slotEntry: group.slots)
+        {
+            const cxuint fixedReg = fixedRegs[slotEntry.first];
+            if (fixedReg == UINT_MAX)
+                continue;
+            if (fixedReg < slotEntry.second ||
+                (group.fixed && group.reg != fixedReg - slotEntry.second))
+                throw AsmException("Inconsistent linear dependencies");
+            group.fixed = true;
+            group.reg = fixedReg - slotEntry.second;
+        }
+        if (group.fixed)
+            regsNum = std::max(regsNum, group.reg + group.size);
+    }
+    
+    // reserve registers for real registers
+    std::vector<std::vector<std::pair<size_t, size_t> > > fixedIntervals(regsNum);
+    cxuint usedRegsNum = 0;
+    std::vector<size_t> groupOrder;
+    for (size_t gi = 0; gi < groups.size(); gi++)
+    {
+        const LinearGroup& group = groups[gi];
+        if (group.fixed)
+        {
+            usedRegsNum = std::max(usedRegsNum, group.reg + group.size);
+            if (group.start < group.end)
+                for (cxuint r = group.reg; r < group.reg + group.size; r++)
+                    fixedIntervals[r].push_back({ group.start, group.end });
+        }
+        else if (group.start < group.end)
+            groupOrder.push_back(gi);
+    }
+    std::stable_sort(groupOrder.begin(), groupOrder.end(),
+            [&groups](size_t g1, size_t g2)
+            { return groups[g1].start < groups[g2].start; });
+    
+    // scan: allocate groups by start of live intervals
+    std::vector<size_t> regEnds(regsNum, 0);
+    for (size_t gi: groupOrder)
+    {
+        LinearGroup& group = groups[gi];
+        cxuint reg = 0;
+        for (; reg + group.size <= maxRegsNum; reg++)
+        {
+            bool good = true;
+            for (const auto& alignEntry: group.aligns)
+                if (((reg + alignEntry.first) % alignEntry.second) != 0)
+                {
+                    good = false;
                     break;
-            }
-            if (color==colorsNum) // add new color if needed
-            {
-                if (colorsNum >= maxColorsNum)
-                    throw AsmException("Too many register is needed");
-                colorsNum++;
-            }
-            
-            for (size_t nextNode: equalNodes)
-                gcMap[nextNode] = color;
-            // update SDO for node
-            bool colorExists = false;
-            for (size_t node: equalNodes)
+                }
+            for (cxuint r = reg; good && r < reg + group.size; r++)
             {
-                for (size_t nb: interGraph[node])
-                    if (gcMap[nb] == color)
+                if (regEnds[r] > group.start)
+                    good = false;
+                for (const auto& interval: fixedIntervals[r])
+                    if (interval.first < group.end && group.start < interval.second)
                     {
-                        colorExists = true;
+                        good = false;
                         break;
                     }
-                if (!colorExists)
-                    sdoCounts[node]++;
             }
-            // update SDO for neighbors
-            for (size_t node: equalNodes)
-                for (size_t nb: interGraph[node])
+            if (good)
+                break;
+        }
+        if (reg + group.size > maxRegsNum)
+            throw AsmException("Too many register is needed");
+        group.reg = reg;
+        for (cxuint r = reg; r < reg + group.size; r++)
+            regEnds[r] = group.end;
+        usedRegsNum = std::max(usedRegsNum, reg + group.size);
+    }
+    
+    // fill register map
+    for (const LinearGroup& group: groups)
+        for (const auto& slotEntry: group.slots)
+            forEachSlotNode(slotEntry.first, equalSetList, equalSetMap, [&](size_t node)
+            { gcMap[node] = group.reg + slotEntry.second; });
+    return usedRegsNum;
+}
+
+void AsmRegAllocator::allocateRegType(size_t regType, cxuint maxRegsNum)
+{
+    if (mode == AsmRegAllocMode::LINEAR_SCAN)
+        usedRegsNums[regType] = allocateLinearScan(regType, maxRegsNum);
+    else
+    {
+        createInterferenceGraph(regType);
+        usedRegsNums[regType] = colorInterferenceGraph(regType, maxRegsNum);
+    }
+}
+
+/* reserve registers of scratch buffer for spilled vector registers in whole code.
+ * buffer resource and offset must be available at every spill code */
+void AsmRegAllocator::reserveSpillScratch()
+{
+    if (!spillScratch.enabled || regTypesNum <= REGTYPE_VGPR)
+        return;
+    std::vector<LiveBlock>& liveBlockList = liveBlocks[REGTYPE_SGPR];
+    std::vector<size_t> reservedVidxes;
+    for (cxuint i = 0; i < 5; i++)
+    {
+        const AsmSingleVReg svreg{ nullptr,
+                    uint16_t(i < 4 ? spillScratch.srsrc + i : spillScratch.soffset) };
+        std::vector<size_t>& ssaIdIndices = vregIndexMaps[REGTYPE_SGPR][svreg];
+        if (ssaIdIndices.empty())
+            ssaIdIndices.push_back(vregsCounts[REGTYPE_SGPR]++);
+        reservedVidxes.push_back(ssaIdIndices[0]);
+    }
+    liveBlockList.resize(std::remove_if(liveBlockList.begin(), liveBlockList.end(),
+            [&reservedVidxes](const LiveBlock& lb)
+            { return std::find(reservedVidxes.begin(), reservedVidxes.end(),
+                        lb.vidx) != reservedVidxes.end(); }) - liveBlockList.begin());
+    std::sort(reservedVidxes.begin(), reservedVidxes.end());
+    reservedVidxes.resize(std::unique(reservedVidxes.begin(), reservedVidxes.end()) -
+                reservedVidxes.begin());
+    for (size_t vidx: reservedVidxes)
+        liveBlockList.push_back({ 0, SIZE_MAX, vidx });
+    std::sort(liveBlockList.begin(), liveBlockList.end());
+}
+
+/* spilling: choose variables live at points where number of live variables
+ * is greater than target (lowest number of usages per live time are chosen).
+ * live range of spilled variable is split: every usage gets own temporary
+ * variable, that is reloaded before instruction and stored after instruction.
+ * only single registers that are not in any dependencies can be spilled */
+size_t AsmRegAllocator::spillVariables(size_t regType, cxuint targetRegsNum)
+{
+    size_t maxSlotsNum = SIZE_MAX;
+    if (regType == REGTYPE_VGPR)
+    {
+        if (!spillScratch.enabled)
+            return 0; // no place for vector registers
+        maxSlotsNum = (4095U - spillScratch.offset) / 4U + 1U;
+    }
+    if (spilledVarsNums[regType] >= maxSlotsNum)
+        return 0;
+    
+    const size_t varsNum = tempVarsStarts[regType];
+    std::vector<VarUsage>& usages = varUsages[regType];
+    std::vector<LiveBlock>& liveBlockList = liveBlocks[regType];
+    std::vector<size_t> usesNums(varsNum, 0);
+    std::vector<size_t> liveLengths(varsNum, 0);
+    std::vector<bool> spillable(varsNum, false);
+    
+    // spill code can not be put after instruction that changes code flow
+    std::vector<size_t> flowOffsets;
+    for (const AsmCodeFlowEntry& entry: assembler.sections[sectionId].codeFlow)
+        if (entry.type != AsmCodeFlowType::START && entry.type != AsmCodeFlowType::END)
+            flowOffsets.push_back(entry.offset);
+    std::sort(flowOffsets.begin(), flowOffsets.end());
+    
+    for (const VarUsage& usage: usages)
+        if (usage.vidx < varsNum)
+        {
+            usesNums[usage.vidx]++;
+            spillable[usage.vidx] = true;
+        }
+    for (const VarUsage& usage: usages)
+        if (usage.vidx < varsNum && (usage.regsNum != 1 ||
+            usage.regField == ASMFIELD_NONE ||
+            ((usage.rwFlags & ASMRVU_WRITE) != 0 &&
+             std::binary_search(flowOffsets.begin(), flowOffsets.end(), usage.offset))))
+            spillable[usage.vidx] = false;
+    for (const auto& entry: linearDepMaps[regType])
+        if (entry.first < varsNum)
+            spillable[entry.first] = false;
+    for (const auto& entry: equalSetMaps[regType])
+        if (entry.first < varsNum)
+            spillable[entry.first] = false;
+    for (const LiveBlock& lb: liveBlockList)
+        if (lb.vidx < varsNum)
+            liveLengths[lb.vidx] += lb.end - lb.start;
+    
+    // sweep by live blocks and choose variables to spill
+    std::vector<bool> spilled(varsNum, false);
+    std::vector<size_t> spilledVars;
+    std::vector<LiveBlock> activeBlocks;
+    for (const LiveBlock& lb: liveBlockList)
+    {
+        if (lb.vidx < varsNum && spilled[lb.vidx])
+            continue;
+        activeBlocks.resize(std::remove_if(activeBlocks.begin(), activeBlocks.end(),
+                [&lb](const LiveBlock& alb) { return alb.end <= lb.start; }) -
+                activeBlocks.begin());
+        activeBlocks.push_back(lb);
+        while (activeBlocks.size() > targetRegsNum &&
+            spilledVarsNums[regType] + spilledVars.size() < maxSlotsNum)
+        {
+            size_t bestVidx = SIZE_MAX;
+            size_t bestEnd = 0;
+            for (const LiveBlock& alb: activeBlocks)
+            {
+                const size_t v = alb.vidx;
+                if (v >= varsNum || !spillable[v] || spilled[v])
+                    continue;
+                if (bestVidx != SIZE_MAX)
                 {
-                    colorExists = false;
-                    for (size_t nb2: interGraph[nb])
-                        if (gcMap[nb2] == color)
-                        {
-                            colorExists = true;
-                            break;
-                        }
-                    if (!colorExists)
-                    {
-                        if (gcMap[nb] == UINT_MAX)
-                            nodeSet.erase(nb);  // before update we erase from nodeSet
-                        sdoCounts[nb]++;
-                        if (gcMap[nb] == UINT_MAX)
-                            nodeSet.insert(nb); // after update, insert again
-                    }
+                    // compare usesNum/liveLength, if equal choose farthest end of block
+                    const double weight = double(usesNums[v]) * liveLengths[bestVidx];
+                    const double bestWeight = double(usesNums[bestVidx]) * liveLengths[v];
+                    if (weight > bestWeight || (weight == bestWeight && alb.end <= bestEnd))
+                        continue;
                 }
-            
-            for (size_t nextNode: equalNodes)
-                gcMap[nextNode] = color;
+                bestVidx = v;
+                bestEnd = alb.end;
+            }
+            if (bestVidx == SIZE_MAX)
+                break; // nothing to spill
+            spilled[bestVidx] = true;
+            spilledVars.push_back(bestVidx);
+            activeBlocks.resize(std::remove_if(activeBlocks.begin(), activeBlocks.end(),
+                    [bestVidx](const LiveBlock& alb) { return alb.vidx == bestVidx; }) -
+                    activeBlocks.begin());
         }
     }
+    if (spilledVars.empty())
+        return 0;
+    
+    // assign slots in order of spilling
+    std::vector<uint32_t> slots(varsNum, UINT32_MAX);
+    for (size_t v: spilledVars)
+        slots[v] = spilledVarsNums[regType]++;
+    
+    // split live ranges: temporary variable per instruction and spilled variable
+    liveBlockList.resize(std::remove_if(liveBlockList.begin(), liveBlockList.end(),
+            [varsNum, &spilled](const LiveBlock& lb)
+            { return lb.vidx < varsNum && spilled[lb.vidx]; }) - liveBlockList.begin());
+    std::vector<size_t> spillUsages;
+    for (size_t i = 0; i < usages.size(); i++)
+        if (usages[i].vidx < varsNum && spilled[usages[i].vidx])
+            spillUsages.push_back(i);
+    std::sort(spillUsages.begin(), spillUsages.end(), [&usages](size_t i1, size_t i2)
+            { return usages[i1].offset < usages[i2].offset ||
+                (usages[i1].offset == usages[i2].offset &&
+                    usages[i1].vidx < usages[i2].vidx); });
+    for (size_t i = 0; i < spillUsages.size(); )
+    {
+        const VarUsage& first = usages[spillUsages[i]];
+        const size_t tempVidx = vregsCounts[regType]++;
+        const uint32_t slot = slots[first.vidx];
+        cxbyte rwFlags = 0;
+        size_t j = i;
+        for (; j < spillUsages.size() && usages[spillUsages[j]].offset == first.offset &&
+                usages[spillUsages[j]].vidx == first.vidx; j++)
+            rwFlags |= usages[spillUsages[j]].rwFlags;
+        const bool reload = (rwFlags & ASMRVU_READ) != 0;
+        const bool store = (rwFlags & ASMRVU_WRITE) != 0;
+        // reloaded before instruction, stored after instruction
+        liveBlockList.push_back({ reload ? first.liveTime : first.liveTime+1,
+                    store ? first.liveTime+2 : first.liveTime+1, tempVidx });
+        if (reload)
+            varSpills[regType].push_back({ first.offset, tempVidx, slot, false });
+        if (store)
+            varSpills[regType].push_back({ first.offset, tempVidx, slot, true });
+        for (; i < j; i++)
+            usages[spillUsages[i]].vidx = tempVidx;
+    }
+    std::sort(liveBlockList.begin(), liveBlockList.end());
+    return spilledVars.size();
 }
 
-void AsmRegAllocator::allocateRegisters(cxuint sectionId)
+void AsmRegAllocator::allocateRegTypeWithSpills(size_t regType, cxuint maxRegsNum)
+{
+    cxuint targetRegsNum = maxRegsNum;
+    while (true)
+    {
+        try
+        {
+            allocateRegType(regType, maxRegsNum);
+            return;
+        }
+        catch(const AsmException&)
+        {
+            // spill variables and try again, decrease target if nothing to spill
+            size_t spilledNum = 0;
+            while (targetRegsNum != 0 &&
+                (spilledNum = spillVariables(regType, targetRegsNum)) == 0)
+                targetRegsNum--;
+            if (spilledNum == 0)
+                throw;
+        }
+    }
+}
+
+/* allocation for budgets: number of registers of every register type is limited
+ * to budget (for occupancy: budget that allows to run wavesNum waves per SIMD).
+ * variables that do not fit are spilled: scalar registers to lanes of vector
+ * registers, vector registers to scratch buffer */
+void AsmRegAllocator::allocateForBudgets(const cxuint* regsBudgets, cxuint wavesNum)
+{
+    auto allocRegTypeBudget = [this, wavesNum](size_t regType, cxuint budget)
+    {
+        try
+        { allocateRegTypeWithSpills(regType, budget); }
+        catch(const AsmException&)
+        {
+            if (wavesNum == 0)
+                throw;
+            std::ostringstream oss;
+            oss << "Too many " << (regType == REGTYPE_SGPR ? "SGPRs" : "VGPRs") <<
+                    " needed for occupancy " << wavesNum << " (budget is " <<
+                    budget << " registers)";
+            throw AsmException(oss.str());
+        }
+    };
+    auto allocRegType = [regsBudgets, &allocRegTypeBudget](size_t regType)
+    { allocRegTypeBudget(regType, regsBudgets[regType]); };
+    if (isParallelByRegTypes())
+        runParallel(regTypesNum, threadsNum, allocRegType);
+    else
+        for (size_t regType = 0; regType < regTypesNum; regType++)
+            allocRegType(regType);
+    
+    if (regTypesNum <= REGTYPE_VGPR)
+        return;
+    // spilled scalar registers are held in lanes of vector registers
+    const cxuint lanesNum = (spilledVarsNums[REGTYPE_SGPR] + 63) >> 6;
+    if (lanesNum == 0)
+        return;
+    const cxuint vgprsBudget = regsBudgets[REGTYPE_VGPR];
+    if (lanesNum >= vgprsBudget)
+        throw AsmException("Too many SGPRs spilled to VGPR lanes");
+    if (usedRegsNums[REGTYPE_VGPR] + lanesNum > vgprsBudget)
+        allocRegTypeBudget(REGTYPE_VGPR, vgprsBudget - lanesNum);
+    laneRegStart = usedRegsNums[REGTYPE_VGPR];
+    usedRegsNums[REGTYPE_VGPR] += lanesNum;
+}
+
+void AsmRegAllocator::allocateRegisters(cxuint _sectionId)
 {
     // before any operation, clear all
     codeBlocks.clear();
@@ -2369,16 +3247,339 @@ void AsmRegAllocator::allocateRegisters(cxuint sectionId)
         graphColorMaps[i].clear();
         equalSetMaps[i].clear();
         equalSetLists[i].clear();
+        liveBlocks[i].clear();
+        usedRegsNums[i] = 0;
+        varUsages[i].clear();
+        varSpills[i].clear();
+        spilledVarsNums[i] = 0;
+        tempVarsStarts[i] = 0;
     }
+    sectionId = _sectionId;
+    allocated = false;
+    laneRegStart = 0;
+    spillInstrsNum = 0;
     ssaReplacesMap.clear();
+    ::memset(&stats, 0, sizeof(AsmRegAllocStats));
+    PassTimer totalTimer(timePasses, stats.totalTime);
     cxuint maxRegs[MAX_REGTYPES_NUM];
     assembler.isaAssembler->getMaxRegistersNum(regTypesNum, maxRegs);
+    stats.sectionId = sectionId;
+    stats.mode = mode;
+    stats.regTypesNum = regTypesNum;
     
     // set up
     const AsmSection& section = assembler.sections[sectionId];
-    createCodeStructure(section.codeFlow, section.content.size(), section.content.data());
-    createSSAData(*section.usageHandler);
-    applySSAReplaces();
-    createInterferenceGraph(*section.usageHandler);
-    colorInterferenceGraph();
+    {
+        PassTimer timer(timePasses, stats.codeStructureTime);
+        createCodeStructure(section.codeFlow, section.content.size(),
+                    section.content.data());
+    }
+    {
+        PassTimer timer(timePasses, stats.ssaDataTime);
+        createSSAData(*section.usageHandler);
+    }
+    {
+        PassTimer timer(timePasses, stats.ssaReplacesTime);
+        applySSAReplaces();
+    }
+    {
+        PassTimer timer(timePasses, stats.livenessesTime);
+        createLivenesses(*section.usageHandler);
+    }
+    
+    // scratch buffer for spilled vector registers
+    spillScratch = assembler.spillScratch;
+    if (section.kernelId < assembler.kernels.size())
+    {
+        if (assembler.kernels[section.kernelId].spillScratch.enabled)
+            spillScratch = assembler.kernels[section.kernelId].spillScratch;
+    }
+    else
+        // code shared by kernels - use first kernel's scratch buffer
+        for (const AsmKernel& kernel: assembler.kernels)
+            if (!kernel.codeRegions.empty() && kernel.spillScratch.enabled)
+            {
+                spillScratch = kernel.spillScratch;
+                break;
+            }
+    reserveSpillScratch();
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+        tempVarsStarts[regType] = vregsCounts[regType];
+    
+    cxuint wavesNum = occupancy;
+    if (wavesNum == 0)
+    {
+        // get occupancy from kernel of this section
+        if (section.kernelId < assembler.kernels.size())
+            wavesNum = assembler.kernels[section.kernelId].occupancy;
+        else
+            // code shared by kernels - use highest occupancy
+            for (const AsmKernel& kernel: assembler.kernels)
+                if (!kernel.codeRegions.empty())
+                    wavesNum = std::max(wavesNum, kernel.occupancy);
+        if (wavesNum == 0)
+            wavesNum = assembler.occupancy;
+    }
+    
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                    assembler.deviceType);
+    cxuint regsBudgets[MAX_REGTYPES_NUM];
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+        regsBudgets[regType] = (wavesNum != 0) ?
+                getGPUMaxRegsNumByWaves(arch, regType, wavesNum) -
+                    getGPUExtraRegsNum(arch, regType, GCN_VCC) :
+                getGPUMaxRegistersNum(arch, regType);
+    allocateForBudgets(regsBudgets, wavesNum);
+    
+    achievedOccupancy = UINT_MAX;
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+        achievedOccupancy = std::min(achievedOccupancy, getGPUWavesNumByRegsNum(arch,
+                regType, usedRegsNums[regType] +
+                getGPUExtraRegsNum(arch, regType, GCN_VCC)));
+#ifdef HAVE_TIME_PASSES
+    if (timePasses)
+    {
+        stats.codeBlocksNum = codeBlocks.size();
+        for (size_t regType = 0; regType < regTypesNum; regType++)
+        {
+            stats.ssaValuesNums[regType] = vregsCounts[regType];
+            stats.graphNodesNums[regType] = interGraphs[regType].size();
+            stats.graphEdgesNums[regType] = interGraphs[regType].edgesNum();
+            stats.colorsNums[regType] = usedRegsNums[regType];
+        }
+    }
+#endif
+    allocated = true;
+}
+
+// shift offsets of symbols of section in scope and its subscopes
+static void moveSectionSymbols(AsmScope* scope, cxuint sectionId,
+            const std::function<size_t(size_t)>& moveLabel)
+{
+    for (AsmSymbolEntry& entry: scope->symbolMap)
+        if (entry.second.hasValue && !entry.second.regRange &&
+            entry.second.sectionId == sectionId)
+            entry.second.value = moveLabel(entry.second.value);
+    for (const auto& entry: scope->scopeMap)
+        moveSectionSymbols(entry.second, sectionId, moveLabel);
+}
+
+void AsmRegAllocator::applyAllocation()
+{
+    if (!allocated)
+        throw AsmException("Registers are not allocated");
+    AsmSection& section = assembler.sections[sectionId];
+    ISAUsageHandler& usageHandler = *section.usageHandler;
+    const ISAAssembler* isaAsm = assembler.isaAssembler;
+    std::vector<cxbyte>& content = section.content;
+    cxuint regRanges[MAX_REGTYPES_NUM*2];
+    size_t regTypesNum;
+    isaAsm->getRegisterRanges(regTypesNum, regRanges);
+    
+    // set allocated registers in instructions
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+        for (const VarUsage& usage: varUsages[regType])
+            if (usage.regField != ASMFIELD_NONE)
+                usageHandler.setRegStart(content.data() + usage.offset, usage.regField,
+                        regRanges[regType<<1] + graphColorMaps[regType][usage.vidx]);
+    
+    // kernels get number of registers used by allocator
+    for (size_t i = 0; i < assembler.kernels.size(); i++)
+    {
+        AsmKernel& kernel = assembler.kernels[i];
+        if (section.kernelId == i || (section.kernelId >= assembler.kernels.size() &&
+                !kernel.codeRegions.empty()))
+            for (size_t regType = 0; regType < regTypesNum; regType++)
+                kernel.usedRegsNums[regType] = std::max(kernel.usedRegsNums[regType],
+                            usedRegsNums[regType]);
+    }
+    
+    // collect spills by instruction: reloads before stores
+    struct InstrSpill
+    {
+        size_t offset;
+        bool store;
+        AsmSpill spill;
+    };
+    std::vector<InstrSpill> instrSpills;
+    for (size_t regType = 0; regType < regTypesNum; regType++)
+        for (const VarSpill& vspill: varSpills[regType])
+            instrSpills.push_back({ vspill.offset, vspill.store, { cxuint(regType),
+                    uint16_t(regRanges[regType<<1] + graphColorMaps[regType][vspill.vidx]),
+                    vspill.slot } });
+    if (instrSpills.empty())
+        return;
+    std::stable_sort(instrSpills.begin(), instrSpills.end(),
+            [](const InstrSpill& s1, const InstrSpill& s2)
+            { return s1.offset < s2.offset ||
+                (s1.offset == s2.offset && !s1.store && s2.store); });
+    
+    /* generate spill code: reloads are put before instruction (after labels),
+     * stores after instruction (before labels) */
+    struct Insertion
+    {
+        size_t pos;
+        bool beforeLabels;
+        size_t codeStart;
+        size_t codeSize;
+    };
+    std::vector<Insertion> insertions;
+    std::vector<cxbyte> spillCode;
+    std::vector<AsmSpill> spills;
+    for (size_t i = 0; i < instrSpills.size(); )
+    {
+        const size_t offset = instrSpills[i].offset;
+        const bool store = instrSpills[i].store;
+        spills.clear();
+        for (; i < instrSpills.size() && instrSpills[i].offset == offset &&
+                    instrSpills[i].store == store; i++)
+            spills.push_back(instrSpills[i].spill);
+        AsmInstrSchedInfo info;
+        if (!isaAsm->getInstrSchedInfo(content.size() - offset, content.data() + offset,
+                    info))
+            throw AsmException("No instruction for spill code");
+        const size_t codeStart = spillCode.size();
+        spillInstrsNum += isaAsm->putSpillCode(store,
+                    store && (info.flags & ASMSCHED_MEMORY) != 0, spills.size(),
+                    spills.data(), laneRegStart, spillScratch, spillCode);
+        insertions.push_back({ store ? offset + info.size : offset, store,
+                    codeStart, spillCode.size() - codeStart });
+    }
+    // stores of previous instruction before reloads of next instruction
+    std::stable_sort(insertions.begin(), insertions.end(),
+            [](const Insertion& i1, const Insertion& i2)
+            { return i1.pos < i2.pos || (i1.pos == i2.pos &&
+                    i1.beforeLabels && !i2.beforeLabels); });
+    // cumulative sizes of insertions
+    std::vector<size_t> insertEnds(insertions.size());
+    size_t insertedSize = 0;
+    for (size_t i = 0; i < insertions.size(); i++)
+        insertEnds[i] = (insertedSize += insertions[i].codeSize);
+    
+    auto shiftBy = [&insertions, &insertEnds](size_t offset, bool instr) -> size_t
+    {
+        // instruction is after all insertions at its offset,
+        // label is between stores and reloads
+        auto it = std::upper_bound(insertions.begin(), insertions.end(), offset,
+                [instr](size_t off, const Insertion& ins)
+                { return off < ins.pos || (off == ins.pos && !instr &&
+                        !ins.beforeLabels); });
+        const size_t index = it - insertions.begin();
+        return offset + (index != 0 ? insertEnds[index-1] : 0);
+    };
+    auto moveInstr = [&shiftBy](size_t offset) { return shiftBy(offset, true); };
+    auto moveLabel = [&shiftBy](size_t offset) { return shiftBy(offset, false); };
+    
+    // rebuild content
+    std::vector<cxbyte> newContent;
+    newContent.reserve(content.size() + insertedSize);
+    size_t oldPos = 0;
+    for (const Insertion& ins: insertions)
+    {
+        newContent.insert(newContent.end(), content.begin() + oldPos,
+                    content.begin() + ins.pos);
+        newContent.insert(newContent.end(), spillCode.begin() + ins.codeStart,
+                    spillCode.begin() + ins.codeStart + ins.codeSize);
+        oldPos = ins.pos;
+    }
+    newContent.insert(newContent.end(), content.begin() + oldPos, content.end());
+    
+    // update code flow and branches
+    for (AsmCodeFlowEntry& entry: section.codeFlow)
+    {
+        const size_t oldOffset = entry.offset;
+        const size_t oldTarget = entry.target;
+        if (entry.type == AsmCodeFlowType::START || entry.type == AsmCodeFlowType::END)
+        {
+            entry.offset = moveLabel(oldOffset);
+            continue;
+        }
+        entry.offset = moveInstr(oldOffset);
+        if (entry.type == AsmCodeFlowType::RETURN)
+            continue;
+        entry.target = moveLabel(oldTarget);
+        isaAsm->moveBranchTarget(newContent.data() + entry.offset, oldOffset, oldTarget,
+                    entry.offset, entry.target);
+    }
+    content.swap(newContent); // usage handler holds reference to this content
+    
+    // update symbols, relocations and code regions
+    moveSectionSymbols(&assembler.globalScope, sectionId, moveLabel);
+    for (AsmScope* scope: assembler.abandonedScopes)
+        moveSectionSymbols(scope, sectionId, moveLabel);
+    for (auto& entry: assembler.localLabelOffsets)
+        if (entry.first == sectionId)
+            entry.second = moveLabel(entry.second);
+    for (AsmRelocation& reloc: assembler.relocations)
+        if (reloc.sectionId == sectionId)
+            reloc.offset = moveInstr(reloc.offset);
+    for (size_t i = 0; i < assembler.kernels.size(); i++)
+        if (section.kernelId == i || section.kernelId >= assembler.kernels.size())
+            for (auto& region: assembler.kernels[i].codeRegions)
+            {
+                region.first = moveLabel(region.first);
+                region.second = moveLabel(region.second);
+            }
+    
+    // move usages of instructions
+    std::vector<std::pair<size_t, size_t> > moves;
+    usageHandler.rewind();
+    while (usageHandler.hasNext())
+    {
+        const size_t offset = usageHandler.nextUsage().offset;
+        if (moves.empty() || moves.back().first != offset)
+            moves.push_back({ offset, moveInstr(offset) });
+    }
+    std::sort(moves.begin(), moves.end());
+    moves.resize(std::unique(moves.begin(), moves.end()) - moves.begin());
+    usageHandler.moveInstructions(moves);
+}
+
+void AsmRegAllocator::printStats(std::ostream& os, const AsmRegAllocStats& stats)
+{
+    const std::ios_base::fmtflags oldFlags = os.flags();
+    const std::streamsize oldPrecision = os.precision();
+    os << "===------------------------------------------===\n"
+        "  Register allocation passes\n"
+        "===------------------------------------------===\n"
+        "  Time (s)  Pass\n";
+    os.setf(std::ios::fixed, std::ios::floatfield);
+    os.precision(6);
+    auto printPass = [&os](double time, const char* name)
+    {
+        os.width(10);
+        os << time << "  " << name << "\n";
+    };
+    printPass(stats.codeStructureTime, "createCodeStructure");
+    printPass(stats.ssaDataTime, "createSSAData");
+    printPass(stats.ssaReplacesTime, "applySSAReplaces");
+    printPass(stats.livenessesTime, "createLivenesses");
+    double interGraphTime = 0.0, colorTime = 0.0;
+    for (size_t regType = 0; regType < stats.regTypesNum; regType++)
+    {
+        interGraphTime += stats.interGraphTimes[regType];
+        colorTime += stats.colorTimes[regType];
+    }
+    printPass(interGraphTime, "createInterferenceGraph");
+    printPass(colorTime, (stats.mode == AsmRegAllocMode::LINEAR_SCAN) ?
+                "allocateLinearScan" : "colorInterferenceGraph");
+    printPass(stats.totalTime, "Total");
+    os.flags(oldFlags);
+    os.precision(oldPrecision);
+    os << "  Code blocks: " << stats.codeBlocksNum << "\n";
+    for (size_t regType = 0; regType < stats.regTypesNum; regType++)
+        os << "  Regtype " << regType << ": SSA values: " <<
+                stats.ssaValuesNums[regType] << ", graph nodes: " <<
+                stats.graphNodesNums[regType] << ", graph edges: " <<
+                stats.graphEdgesNums[regType] << ", colors: " <<
+                stats.colorsNums[regType] << "\n";
+    os.flush();
+}
+
+void AsmRegAllocator::allocateRegisters(size_t sectionsNum, AsmRegAllocator** regAllocs,
+            const cxuint* sectionIds, cxuint threadsNum)
+{
+    // every allocator holds own state, hence sections can be allocated concurrently
+    runParallel(sectionsNum, threadsNum, [regAllocs, sectionIds](size_t i)
+        { regAllocs[i]->allocateRegisters(sectionIds[i]); });
 }
@@ -0,0 +1,527 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <vector>
+#include <bitset>
+#include <utility>
+#include <algorithm>
+#include <unordered_map>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "AsmInternals.h"
+
+using namespace CLRX;
+
+/* the scheduler moves instructions only inside code blocks (between barriers,
+ * labels and code flow instructions). dependencies between instructions are
+ * built from register usages (from usage handler) and implicit register usages
+ * returned by ISA assembler. memory operations keep their order only if they can
+ * access same memory (and one of them is store) or if they use same wait counter.
+ *
+ * to avoid new hazards, distance between dependent instructions can not be shorter
+ * than original distance or than schedHazardDistance. instructions that depend on
+ * instructions outside code block can not be moved closer to edges of block. */
+
+// max number of wait states required between dependent instructions (GCN hazards)
+static const cxuint schedHazardDistance = 5;
+// max number of instructions in single scheduled block
+static const size_t schedMaxBlockSize = 256;
+// max number of plain registers
+static const cxuint schedMaxRegsNum = 512;
+
+typedef std::bitset<schedMaxRegsNum> SchedRegSet;
+
+struct CLRX_INTERNAL SchedInstr
+{
+    size_t offset;
+    AsmInstrSchedInfo info;
+    bool labelBefore;   // if label at this instruction
+    std::vector<AsmRegUsage2Int> regs;  // explicit and implicit register usages
+};
+
+struct CLRX_INTERNAL SchedDep
+{
+    cxuint pred;    // predecessor (index in block)
+    cxuint minDist; // minimal distance in instructions
+    bool dataDep;   // true if read after write
+};
+
+static void addRegUsages(const SchedInstr& instr, SchedRegSet& reads, SchedRegSet& writes)
+{
+    for (const AsmRegUsage2Int& ru: instr.regs)
+        for (uint16_t r = ru.rstart; r < ru.rend && r < schedMaxRegsNum; r++)
+        {
+            if ((ru.rwFlags & ASMRVU_READ) != 0)
+                reads.set(r);
+            if ((ru.rwFlags & ASMRVU_WRITE) != 0)
+                writes.set(r);
+        }
+}
+
+// returns true if instruction conflicts with any register usage in sets
+static bool conflictsWithRegs(const SchedInstr& instr, const SchedRegSet& reads,
+            const SchedRegSet& writes)
+{
+    for (const AsmRegUsage2Int& ru: instr.regs)
+        for (uint16_t r = ru.rstart; r < ru.rend && r < schedMaxRegsNum; r++)
+            if (writes.test(r) || ((ru.rwFlags & ASMRVU_WRITE) != 0 && reads.test(r)))
+                return true;
+    return false;
+}
+
+// returns true if order of memory operations must be kept
+static bool memoryOpsDepend(const AsmInstrSchedInfo& a, const AsmInstrSchedInfo& b)
+{
+    const cxbyte spaces = ASMSCHEDMEM_GLOBAL|ASMSCHEDMEM_LOCAL|ASMSCHEDMEM_EXPORT;
+    if (((a.memFlags|b.memFlags) & ASMSCHEDMEM_STORE) != 0 &&
+        (a.memFlags & b.memFlags & spaces) != 0)
+        return true; // can alias
+    // s_waitcnt expects that operations finish in order
+    return (a.waitCounters & b.waitCounters) != 0;
+}
+
+// estimate stall cycles for instruction order
+static uint64_t estimateStallCycles(const SchedInstr* instrs,
+            const std::vector<std::vector<SchedDep> >& deps,
+            const std::vector<cxuint>& order)
+{
+    std::vector<uint64_t> finishes(order.size());
+    uint64_t cycle = 0;
+    uint64_t stalls = 0;
+    uint64_t lastFinish = 0;
+    for (cxuint i: order)
+    {
+        uint64_t ready = cycle;
+        for (const SchedDep& dep: deps[i])
+            if (dep.dataDep)
+                ready = std::max(ready, finishes[dep.pred]);
+        stalls += ready - cycle;
+        finishes[i] = ready + instrs[i].info.latency;
+        lastFinish = std::max(lastFinish, finishes[i]);
+        cycle = ready + instrs[i].info.issueCycles;
+    }
+    return stalls + (lastFinish > cycle ? lastFinish - cycle : 0);
+}
+
+// collect offsets of all labels in section (from all scopes)
+static void collectLabelOffsets(const AsmScope* scope, cxuint sectionId,
+            std::vector<size_t>& offsets)
+{
+    for (const AsmSymbolEntry& entry: scope->symbolMap)
+        if (entry.second.hasValue && !entry.second.regRange &&
+            entry.second.sectionId == sectionId)
+            offsets.push_back(entry.second.value);
+    for (const auto& entry: scope->scopeMap)
+        collectLabelOffsets(entry.second, sectionId, offsets);
+}
+
+AsmScheduler::AsmScheduler(Assembler& _assembler) : assembler(_assembler)
+{ }
+
+AsmScheduleStats AsmScheduler::schedule(cxuint sectionId)
+{
+    AsmScheduleStats stats = { sectionId, 0, 0, 0, 0, 0, 0 };
+    AsmSection& section = assembler.sections[sectionId];
+    ISAUsageHandler* usageHandler = section.usageHandler.get();
+    if (usageHandler == nullptr)
+        return stats;
+    const ISAAssembler* isaAsm = assembler.isaAssembler;
+    std::vector<cxbyte>& content = section.content;
+    const size_t codeSize = content.size();
+
+    /* collect labels and code flow instructions */
+    std::vector<size_t> labels;
+    std::vector<size_t> flowOffsets;
+    collectLabelOffsets(&assembler.globalScope, sectionId, labels);
+    for (const AsmScope* scope: assembler.abandonedScopes)
+        collectLabelOffsets(scope, sectionId, labels);
+    for (const auto& entry: assembler.localLabelOffsets)
+        if (entry.first == sectionId)
+            labels.push_back(entry.second);
+    for (const AsmKernel& kernel: assembler.kernels)
+        for (const auto& region: kernel.codeRegions)
+        {
+            labels.push_back(region.first);
+            labels.push_back(region.second);
+        }
+    for (const AsmCodeFlowEntry& entry: section.codeFlow)
+    {
+        if (entry.type == AsmCodeFlowType::START || entry.type == AsmCodeFlowType::END)
+            labels.push_back(entry.offset);
+        else
+        {
+            flowOffsets.push_back(entry.offset);
+            if (entry.type != AsmCodeFlowType::RETURN)
+                labels.push_back(entry.target);
+        }
+    }
+    std::sort(labels.begin(), labels.end());
+    labels.resize(std::unique(labels.begin(), labels.end()) - labels.begin());
+    std::sort(flowOffsets.begin(), flowOffsets.end());
+
+    /* split code into instructions */
+    std::vector<SchedInstr> instrs;
+    usageHandler->rewind();
+    bool haveUsage = usageHandler->hasNext();
+    AsmRegVarUsage rvu = { };
+    if (haveUsage)
+        rvu = usageHandler->nextUsage();
+    auto labelIt = labels.begin();
+    auto flowIt = flowOffsets.begin();
+    size_t pos = 0;
+    while (pos < codeSize)
+    {
+        SchedInstr instr;
+        instr.offset = pos;
+        if (!isaAsm->getInstrSchedInfo(codeSize - pos, content.data() + pos, instr.info))
+            break;
+        if ((instr.info.flags & ASMSCHED_STOP) != 0)
+            return stats; // do not schedule this section
+        while (labelIt != labels.end() && *labelIt < pos)
+            ++labelIt;
+        instr.labelBefore = (labelIt != labels.end() && *labelIt == pos);
+        size_t instrEnd = std::min(pos + instr.info.size, codeSize);
+        if (labelIt != labels.end() && *labelIt == pos)
+            ++labelIt;
+        if (labelIt != labels.end() && *labelIt < instrEnd)
+        {
+            // label inside instruction (data in code), treat as unmovable
+            instrEnd = *labelIt;
+            instr.info.flags |= ASMSCHED_BARRIER|ASMSCHED_FLOW;
+        }
+        instr.info.size = instrEnd - pos;
+        while (flowIt != flowOffsets.end() && *flowIt < instrEnd)
+        {
+            if (*flowIt >= pos)
+                instr.info.flags |= ASMSCHED_BARRIER|ASMSCHED_FLOW;
+            ++flowIt;
+        }
+        // get register usages
+        while (haveUsage && rvu.offset < pos)
+        {
+            haveUsage = usageHandler->hasNext();
+            if (haveUsage)
+                rvu = usageHandler->nextUsage();
+        }
+        bool explicitUsages = false;
+        while (haveUsage && rvu.offset < instrEnd)
+        {
+            if (rvu.regVar != nullptr || rvu.offset != pos)
+                // regvar (not allocated) or usage inside instruction
+                instr.info.flags |= ASMSCHED_BARRIER;
+            else
+                instr.regs.push_back({ rvu.rstart, rvu.rend, rvu.rwFlags });
+            explicitUsages = true;
+            haveUsage = usageHandler->hasNext();
+            if (haveUsage)
+                rvu = usageHandler->nextUsage();
+        }
+        if (!explicitUsages)
+            // no usages - possibly data or special instruction
+            instr.info.flags |= ASMSCHED_BARRIER;
+        for (cxuint i = 0; i < instr.info.implicitRegsNum; i++)
+            instr.regs.push_back(instr.info.implicitRegs[i]);
+        instrs.push_back(instr);
+        pos = instrEnd;
+    }
+    usageHandler->rewind();
+
+    /* determine units: code blocks and single barriers */
+    const size_t instrsNum = instrs.size();
+    std::vector<size_t> unitStarts(instrsNum);
+    std::vector<size_t> unitEnds(instrsNum);
+    std::vector<std::pair<size_t, size_t> > blocks;
+    for (size_t i = 0; i < instrsNum; )
+    {
+        size_t end = i+1;
+        if ((instrs[i].info.flags & ASMSCHED_BARRIER) == 0)
+            while (end < instrsNum && end-i < schedMaxBlockSize &&
+                (instrs[end].info.flags & ASMSCHED_BARRIER) == 0 &&
+                !instrs[end].labelBefore)
+                end++;
+        for (size_t j = i; j < end; j++)
+        {
+            unitStarts[j] = i;
+            unitEnds[j] = end;
+        }
+        if ((instrs[i].info.flags & ASMSCHED_BARRIER) == 0)
+            blocks.push_back(std::make_pair(i, end));
+        i = end;
+    }
+
+    std::vector<std::pair<size_t, size_t> > moves;
+    std::vector<size_t> moveSizes;
+    std::vector<cxbyte> newContent;
+    const cxuint hdist = schedHazardDistance;
+    for (const auto& block: blocks)
+    {
+        const size_t start = block.first;
+        const size_t end = block.second;
+        const cxuint n = end - start;
+        const SchedInstr* binstrs = instrs.data() + start;
+        stats.blocksNum++;
+        stats.instrsNum += n;
+        if (n < 2)
+            continue;
+
+        /* registers used by instructions near to this block */
+        bool headAll = (start + 1 < hdist);
+        bool tailAll = (end + hdist - 1 > instrsNum);
+        // ALL - unknown instructions before or after block (labels, code flow)
+        for (size_t k = (start >= hdist-1 ? start-hdist+1 : 0); k <= start; k++)
+            if (instrs[k].labelBefore || (k < start &&
+                    (instrs[k].info.flags & ASMSCHED_FLOW) != 0))
+                headAll = true;
+        for (size_t k = end; k < end+hdist-1 && k < instrsNum; k++)
+            if ((instrs[k].info.flags & ASMSCHED_FLOW) != 0)
+                tailAll = true;
+        SchedRegSet headReads, headWrites, tailReads, tailWrites;
+        if (!headAll)
+            for (size_t k = unitStarts[start-hdist+1]; k < start; k++)
+                addRegUsages(instrs[k], headReads, headWrites);
+        if (!tailAll)
+            for (size_t k = end; k < unitEnds[end+hdist-2]; k++)
+                addRegUsages(instrs[k], tailReads, tailWrites);
+
+        std::vector<cxuint> minPos(n, 0);
+        std::vector<cxuint> maxPos(n, n-1);
+        for (cxuint i = 0; i < n; i++)
+        {
+            if (headAll || conflictsWithRegs(binstrs[i], headReads, headWrites))
+                minPos[i] = std::min(i, hdist);
+            if (tailAll || conflictsWithRegs(binstrs[i], tailReads, tailWrites))
+                maxPos[i] = n-1 - std::min(n-1-i, hdist);
+        }
+
+        /* build dependencies */
+        std::vector<std::vector<SchedDep> > deps(n);
+        std::vector<std::vector<cxuint> > succs(n);
+        std::unordered_map<uint16_t, std::pair<int, std::vector<cxuint> > > regStates;
+        std::vector<cxuint> memOps;
+        for (cxuint i = 0; i < n; i++)
+        {
+            std::vector<SchedDep>& ideps = deps[i];
+            for (const AsmRegUsage2Int& ru: binstrs[i].regs)
+                for (uint16_t r = ru.rstart; r < ru.rend; r++)
+                {
+                    auto& rstate = regStates.insert(std::make_pair(r,
+                            std::make_pair(-1, std::vector<cxuint>()))).first->second;
+                    if ((ru.rwFlags & ASMRVU_READ) != 0 && rstate.first >= 0)
+                        ideps.push_back({ cxuint(rstate.first),
+                                    std::min(i-rstate.first, hdist), true });
+                    if ((ru.rwFlags & ASMRVU_WRITE) != 0)
+                    {
+                        if (rstate.first >= 0)
+                            ideps.push_back({ cxuint(rstate.first),
+                                    std::min(i-rstate.first, hdist), false });
+                        for (cxuint reader: rstate.second)
+                            if (reader != i)
+                                ideps.push_back({ reader, std::min(i-reader, hdist),
+                                            false });
+                        rstate.second.clear();
+                    }
+                }
+            // update register states after all usages of instruction
+            for (const AsmRegUsage2Int& ru: binstrs[i].regs)
+                for (uint16_t r = ru.rstart; r < ru.rend; r++)
+                {
+                    auto& rstate = regStates[r];
+                    if ((ru.rwFlags & ASMRVU_WRITE) != 0)
+                        rstate.first = i;
+                    else if (rstate.second.empty() || rstate.second.back() != i)
+                        rstate.second.push_back(i);
+                }
+            if ((binstrs[i].info.flags & ASMSCHED_MEMORY) != 0)
+            {
+                for (cxuint memOp: memOps)
+                    if (memoryOpsDepend(binstrs[memOp].info, binstrs[i].info))
+                        ideps.push_back({ memOp, 1, false });
+                memOps.push_back(i);
+            }
+            for (const SchedDep& dep: ideps)
+                succs[dep.pred].push_back(i);
+        }
+
+        // critical path lengths (priorities)
+        std::vector<uint64_t> prios(n);
+        for (cxuint i = n; i > 0; i--)
+        {
+            const cxuint k = i-1;
+            uint64_t prio = binstrs[k].info.latency;
+            for (cxuint s: succs[k])
+                for (const SchedDep& dep: deps[s])
+                    if (dep.pred == k)
+                        prio = std::max(prio, prios[s] + (dep.dataDep ?
+                                binstrs[k].info.latency : binstrs[k].info.issueCycles));
+            prios[k] = prio;
+        }
+
+        /* list scheduling */
+        std::vector<cxuint> origOrder(n);
+        for (cxuint i = 0; i < n; i++)
+            origOrder[i] = i;
+        std::vector<cxuint> order;
+        std::vector<int> newPos(n, -1);
+        std::vector<uint64_t> finishes(n);
+        // number of unscheduled instructions by max position
+        std::vector<cxuint> maxPosCounts(n, 0);
+        for (cxuint i = 0; i < n; i++)
+            maxPosCounts[maxPos[i]]++;
+        // returns true if all other instructions can be put before their max positions
+        auto keepsMaxPositions = [&maxPos, &maxPosCounts, n](cxuint k, cxuint i)
+        {
+            cxuint count = 0;
+            for (cxuint p = k+1; p < n; p++)
+            {
+                count += maxPosCounts[p] - (maxPos[i] == p);
+                if (count > p-k)
+                    return false;
+            }
+            return true;
+        };
+        uint64_t cycle = 0;
+        bool failed = false;
+        for (cxuint k = 0; k < n && !failed; k++)
+        {
+            int best = -1;
+            uint64_t bestReady = 0;
+            bool forced = false;
+            for (cxuint i = 0; i < n; i++)
+            {
+                if (newPos[i] >= 0 || minPos[i] > k)
+                    continue;
+                const bool mustBe = (maxPos[i] == k);
+                bool ready = true;
+                uint64_t readyCycle = cycle;
+                for (const SchedDep& dep: deps[i])
+                {
+                    if (newPos[dep.pred] < 0 || k - newPos[dep.pred] < dep.minDist)
+                    {
+                        ready = false;
+                        break;
+                    }
+                    if (dep.dataDep)
+                        readyCycle = std::max(readyCycle, finishes[dep.pred]);
+                }
+                if (!ready)
+                {
+                    if (mustBe)
+                        failed = true;
+                    continue;
+                }
+                if (mustBe)
+                {
+                    if (forced)
+                        failed = true;
+                    forced = true;
+                    best = i;
+                    bestReady = readyCycle;
+                    continue;
+                }
+                if (forced || !keepsMaxPositions(k, i))
+                    continue;
+                if (best < 0 || readyCycle < bestReady ||
+                    (readyCycle == bestReady && prios[i] > prios[best]))
+                {
+                    best = i;
+                    bestReady = readyCycle;
+                }
+            }
+            if (failed || best < 0)
+            {
+                failed = true;
+                break;
+            }
+            newPos[best] = k;
+            maxPosCounts[maxPos[best]]--;
+            order.push_back(best);
+            finishes[best] = bestReady + binstrs[best].info.latency;
+            cycle = bestReady + binstrs[best].info.issueCycles;
+        }
+
+        const uint64_t stallsBefore = estimateStallCycles(binstrs, deps, origOrder);
+        uint64_t stallsAfter = stallsBefore;
+        if (!failed)
+            stallsAfter = estimateStallCycles(binstrs, deps, order);
+        stats.stallCyclesBefore += stallsBefore;
+        if (failed || stallsAfter >= stallsBefore)
+        {
+            // keep original order
+            stats.stallCyclesAfter += stallsBefore;
+            continue;
+        }
+        stats.stallCyclesAfter += stallsAfter;
+        stats.scheduledBlocksNum++;
+
+        /* put new order of instructions */
+        const size_t blockStart = binstrs[0].offset;
+        const size_t blockEnd = binstrs[n-1].offset + binstrs[n-1].info.size;
+        newContent.assign(content.begin() + blockStart, content.begin() + blockEnd);
+        size_t newOffset = blockStart;
+        for (cxuint i: order)
+        {
+            const SchedInstr& instr = binstrs[i];
+            if (instr.offset != newOffset)
+            {
+                moves.push_back(std::make_pair(instr.offset, newOffset));
+                moveSizes.push_back(instr.info.size);
+                stats.movedInstrsNum++;
+            }
+            std::copy(content.begin() + instr.offset,
+                      content.begin() + instr.offset + instr.info.size,
+                      newContent.begin() + (newOffset - blockStart));
+            newOffset += instr.info.size;
+        }
+        std::copy(newContent.begin(), newContent.end(), content.begin() + blockStart);
+    }
+
+    if (moves.empty())
+        return stats;
+    // moves are sorted by old offset (blocks are in order)
+    std::vector<size_t> moveIndices(moves.size());
+    for (size_t i = 0; i < moves.size(); i++)
+        moveIndices[i] = i;
+    std::sort(moveIndices.begin(), moveIndices.end(), [&moves](size_t a, size_t b)
+            { return moves[a].first < moves[b].first; });
+    std::vector<std::pair<size_t, size_t> > sortedMoves(moves.size());
+    std::vector<size_t> sortedSizes(moves.size());
+    for (size_t i = 0; i < moves.size(); i++)
+    {
+        sortedMoves[i] = moves[moveIndices[i]];
+        sortedSizes[i] = moveSizes[moveIndices[i]];
+    }
+    // update relocations
+    for (AsmRelocation& reloc: assembler.relocations)
+    {
+        if (reloc.sectionId != sectionId)
+            continue;
+        auto it = std::upper_bound(sortedMoves.begin(), sortedMoves.end(),
+                std::make_pair(reloc.offset, SIZE_MAX));
+        if (it == sortedMoves.begin())
+            continue;
+        --it;
+        const size_t mi = it - sortedMoves.begin();
+        if (reloc.offset < it->first + sortedSizes[mi])
+            reloc.offset = reloc.offset - it->first + it->second;
+    }
+    // update register usages
+    usageHandler->moveInstructions(sortedMoves);
+    return stats;
+}
@@ -929,6 +929,8 @@ const char* AsmRepeatInputFilter::readLine(Assembler& assembler, size_t& lineSiz
         source = RefPtr<const AsmSource>(new AsmRepeatSource(
             repeat->getSourceTrans(0).source, repeatCount, repeat->getRepeatsNum()));
     }
+    if (contentLineNo == 0) // start of iteration
+        assembler.timeReport.repetitionsNum++;
     const char* content = repeat->getContent().data();
     size_t oldPos = pos;
     while (pos < contentSize && content[pos] != '\n')
@@ -1023,6 +1025,8 @@ const char* AsmForInputFilter::readLine(Assembler& assembler, size_t& lineSize)
         source = RefPtr<const AsmSource>(new AsmRepeatSource(
             repeat->getSourceTrans(0).source, repeatCount, repeat->getRepeatsNum()));
     }
+    if (contentLineNo == 0) // start of iteration
+        assembler.timeReport.repetitionsNum++;
     const char* content = repeat->getContent().data();
     size_t oldPos = pos;
     while (pos < contentSize && content[pos] != '\n')
@@ -1097,6 +1101,8 @@ const char* AsmIRPInputFilter::readLine(Assembler& assembler, size_t& lineSize)
         source = RefPtr<const AsmSource>(new AsmRepeatSource(
             irp->getSourceTrans(0).source, repeatCount, irp->getRepeatsNum()));
     }
+    if (contentLineNo == 0) // start of iteration
+        assembler.timeReport.repetitionsNum++;
     
     const CString& expectedSymName = irp->getSymbolName();
     const CString& symValue = !irp->isIRPC() ? irp->getSymbolValue(repeatCount) :
@@ -26,6 +26,7 @@
 #include <deque>
 #include <utility>
 #include <algorithm>
+#include <memory>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/MemAccess.h>
 #include <CLRX/utils/GPUId.h>
@@ -678,6 +679,13 @@ Assembler::Assembler(const CString& filename, std::istream& input, Flags _flags,
     buggyFPLit = (flags & ASM_BUGGYFPLIT)!=0;
     macroCase = (flags & ASM_MACRONOCASE)==0;
     oldModParam = (flags & ASM_OLDMODPARAM)!=0;
+    scheduling = schedulingUsed = (flags & ASM_SCHEDULE)!=0;
+    timeReporting = (flags & ASM_TIMEREPORT)!=0;
+    timeReport = AsmTimeReport();
+    occupancy = 0;
+    spillScratch = AsmSpillScratch();
+    regAllocUsed = false;
+    regAllocMode = AsmRegAllocMode::GRAPH_COLORING;
     localCount = macroCount = inclusionLevel = 0;
     macroSubstLevel = repetitionLevel = 0;
     lineAlreadyRead = false;
@@ -717,6 +725,13 @@ Assembler::Assembler(const Array<CString>& _filenames, Flags _flags,
     buggyFPLit = (flags & ASM_BUGGYFPLIT)!=0;
     macroCase = (flags & ASM_MACRONOCASE)==0;
     oldModParam = (flags & ASM_OLDMODPARAM)!=0;
+    scheduling = schedulingUsed = (flags & ASM_SCHEDULE)!=0;
+    timeReporting = (flags & ASM_TIMEREPORT)!=0;
+    timeReport = AsmTimeReport();
+    occupancy = 0;
+    spillScratch = AsmSpillScratch();
+    regAllocUsed = false;
+    regAllocMode = AsmRegAllocMode::GRAPH_COLORING;
     localCount = macroCount = inclusionLevel = 0;
     macroSubstLevel = repetitionLevel = 0;
     lineAlreadyRead = false;
@@ -2236,6 +2251,9 @@ bool Assembler::includeFile(const char* pseudoOpPlace, const std::string& filena
 
 bool Assembler::readLine()
 {
+    PassTimer timer(timeReporting,
+            currentInputFilter->getType() == AsmInputFilterType::STREAM ?
+            timeReport.inputTime : timeReport.macroTime);
     line = currentInputFilter->readLine(*this, lineSize);
     while (line == nullptr)
     {
@@ -2623,6 +2641,7 @@ void Assembler::printUnresolvedSymbols(AsmScope* thisScope)
 
 bool Assembler::assemble()
 {
+    PassTimer totalTimer(timeReporting, timeReport.totalTime);
     resolvingRelocs = false;
     
     for (const DefSym& defSym: defSyms)
@@ -2648,6 +2667,7 @@ bool Assembler::assemble()
             if (line == nullptr)
                 break; // end of stream
         }
+        timeReport.linesNum++;
         
         const char* linePtr = line; // string points to place of line
         const char* end = line+lineSize;
@@ -2702,6 +2722,8 @@ bool Assembler::assemble()
                 prevLRes.second.sectionId = currentSection;
                 /// make forward symbol of label as undefined
                 nextLRes.second.hasValue = false;
+                localLabelOffsets.push_back(std::make_pair(currentSection,
+                            size_t(currentOutPos)));
             }
             else
             {
@@ -2770,6 +2792,7 @@ bool Assembler::assemble()
                 printError(linePtr, "Expected assignment expression");
                 continue;
             }
+            PassTimer timer(timeReporting, timeReport.symbolsTime);
             assignSymbol(firstName, stmtPlace, linePtr);
             continue;
         }
@@ -2777,7 +2800,11 @@ bool Assembler::assemble()
         toLowerString(firstName);
         
         if (firstName.size() >= 2 && firstName[0] == '.') // check for pseudo-op
+        {
+            PassTimer timer(timeReporting, timeReport.pseudoOpsTime);
+            timeReport.pseudoOpsNum++;
             parsePseudoOps(firstName, stmtPlace, linePtr);
+        }
         else if (firstName.size() >= 1 && isDigit(firstName[0]))
             printError(stmtPlace, "Illegal number at statement begin");
         else
@@ -2805,6 +2832,8 @@ bool Assembler::assemble()
                             isaAssembler->createUsageHandler(
                                     sections[currentSection].content));
                 
+                PassTimer timer(timeReporting, timeReport.encodingTime);
+                timeReport.instrsNum++;
                 isaAssembler->assemble(firstName, stmtPlace, linePtr, end,
                            sections[currentSection].content,
                            sections[currentSection].usageHandler.get());
@@ -2840,9 +2869,13 @@ bool Assembler::assemble()
         clauses.pop();
     }
     
-    resolvingRelocs = true;
-    tryToResolveSymbols(&globalScope);
-    printUnresolvedSymbols(&globalScope);
+    {
+        PassTimer timer(timeReporting, timeReport.symbolsTime);
+        resolvingRelocs = true;
+        tryToResolveSymbols(&globalScope);
+        printUnresolvedSymbols(&globalScope);
+    }
+    timeReport.macroSubstsNum = macroCount;
     
     if (good && formatHandler!=nullptr)
     {
@@ -2863,9 +2896,106 @@ bool Assembler::assemble()
             }
             kernels[i].closeCodeRegion(sections[sectionId].content.size());
         }
+        if (schedulingUsed)
+        {
+            // schedule instructions in code sections
+            PassTimer timer(timeReporting, timeReport.schedulingTime);
+            AsmScheduler scheduler(*this);
+            for (cxuint i = 0; i < sections.size(); i++)
+                if (sections[i].usageHandler!=nullptr)
+                    scheduleStats.push_back(scheduler.schedule(i));
+        }
+        // allocate registers in sections with target occupancies
+        std::vector<cxuint> allocSectionIds;
+        std::vector<const AsmSourcePos*> occupancyPlaces;
+        for (cxuint i = 0; i < sections.size(); i++)
+            if (sections[i].usageHandler!=nullptr)
+            {
+                // get place of '.occupancy' for this section (as allocator)
+                const AsmSourcePos* occupancyPlace = nullptr;
+                cxuint wavesNum = 0;
+                if (sections[i].kernelId < kernels.size())
+                {
+                    wavesNum = kernels[sections[i].kernelId].occupancy;
+                    occupancyPlace = &kernels[sections[i].kernelId].occupancyPos;
+                }
+                else
+                    // code shared by kernels - use highest occupancy
+                    for (const AsmKernel& kernel: kernels)
+                        if (!kernel.codeRegions.empty() && kernel.occupancy > wavesNum)
+                        {
+                            wavesNum = kernel.occupancy;
+                            occupancyPlace = &kernel.occupancyPos;
+                        }
+                if (wavesNum == 0)
+                {
+                    wavesNum = occupancy;
+                    occupancyPlace = &occupancyPos;
+                }
+                if (wavesNum == 0)
+                    continue; // no target occupancy
+                allocSectionIds.push_back(i);
+                occupancyPlaces.push_back(occupancyPlace);
+            }
+        if (!allocSectionIds.empty())
+        {
+            PassTimer timer(timeReporting, timeReport.regAllocTime);
+            std::vector<std::unique_ptr<AsmRegAllocator> > regAllocHolders;
+            std::vector<AsmRegAllocator*> regAllocs;
+            for (size_t i = 0; i < allocSectionIds.size(); i++)
+            {
+                regAllocHolders.push_back(std::unique_ptr<AsmRegAllocator>(
+                            new AsmRegAllocator(*this)));
+                // collect statistics of passes for time report
+                regAllocHolders.back()->setTimePasses(timeReporting);
+                regAllocs.push_back(regAllocHolders.back().get());
+            }
+            // allocate sections concurrently, after error allocate remaining sections
+            std::vector<AsmRegAllocator*> pendingAllocs = regAllocs;
+            std::vector<cxuint> pendingSectionIds = allocSectionIds;
+            while (!pendingAllocs.empty())
+            {
+                try
+                {
+                    AsmRegAllocator::allocateRegisters(pendingAllocs.size(),
+                            pendingAllocs.data(), pendingSectionIds.data());
+                    break;
+                }
+                catch(const AsmException& ex)
+                {
+                    // allocators before first failed allocator are allocated
+                    size_t failed = 0;
+                    while (failed < pendingAllocs.size() &&
+                            pendingAllocs[failed]->isAllocated())
+                        failed++;
+                    if (failed == pendingAllocs.size())
+                        throw;
+                    const size_t index = std::find(regAllocs.begin(), regAllocs.end(),
+                                pendingAllocs[failed]) - regAllocs.begin();
+                    printError(*occupancyPlaces[index], ex.what());
+                    size_t k = 0;
+                    for (size_t j = failed+1; j < pendingAllocs.size(); j++)
+                        if (!pendingAllocs[j]->isAllocated())
+                        {
+                            pendingAllocs[k] = pendingAllocs[j];
+                            pendingSectionIds[k++] = pendingSectionIds[j];
+                        }
+                    pendingAllocs.resize(k);
+                    pendingSectionIds.resize(k);
+                }
+            }
+            for (AsmRegAllocator* regAlloc: regAllocs)
+                if (regAlloc->isAllocated())
+                    regAllocStats.push_back(regAlloc->getStats());
+            if (good)
+                for (AsmRegAllocator* regAlloc: regAllocs)
+                    regAlloc->applyAllocation();
+        }
         // prepare binary
+        PassTimer timer(timeReporting, timeReport.prepareBinaryTime);
         formatHandler->prepareBinary();
     }
+    timeReport.relocationsNum = relocations.size();
     return good;
 }
 
@@ -2877,6 +3007,7 @@ void Assembler::writeBinary(const char* filename) const
         if (formatHandler!=nullptr)
         {
             std::ofstream ofs(filename, std::ios::binary);
+            PassTimer timer(timeReporting, timeReport.writeBinaryTime);
             if (ofs)
                 formatHandler->writeBinary(ofs);
             else
@@ -2894,6 +3025,7 @@ void Assembler::writeBinary(std::ostream& outStream) const
     if (good)
     {
         const AsmFormatHandler* formatHandler = getFormatHandler();
+        PassTimer timer(timeReporting, timeReport.writeBinaryTime);
         if (formatHandler!=nullptr)
             formatHandler->writeBinary(outStream);
         else
@@ -2908,6 +3040,7 @@ void Assembler::writeBinary(Array<cxbyte>& array) const
     if (good)
     {
         const AsmFormatHandler* formatHandler = getFormatHandler();
+        PassTimer timer(timeReporting, timeReport.writeBinaryTime);
         if (formatHandler!=nullptr)
             formatHandler->writeBinary(array);
         else
@@ -2916,3 +3049,141 @@ void Assembler::writeBinary(Array<cxbyte>& array) const
     else // failed
         throw AsmException("Assembler failed!");
 }
+
+// names and times of phases in time report
+static const char* timeReportPhaseNames[10] =
+{
+    "input", "macros", "pseudoOps", "encoding", "symbols", "scheduling",
+    "regAlloc", "prepareBinary", "writeBinary", "total"
+};
+
+static void getTimeReportPhaseTimes(const AsmTimeReport& report, double* times)
+{
+    times[0] = report.inputTime;
+    times[1] = report.macroTime;
+    times[2] = report.pseudoOpsTime;
+    times[3] = report.encodingTime;
+    times[4] = report.symbolsTime;
+    times[5] = report.schedulingTime;
+    times[6] = report.regAllocTime;
+    times[7] = report.prepareBinaryTime;
+    times[8] = report.writeBinaryTime;
+    times[9] = report.totalTime;
+}
+
+// names and values of counters in time report
+static const char* timeReportCounterNames[7] =
+{
+    "lines", "instructions", "pseudoOps", "macroSubsts", "repetitions",
+    "expressions", "relocations"
+};
+
+static void getTimeReportCounters(const AsmTimeReport& report, uint64_t* counters)
+{
+    counters[0] = report.linesNum;
+    counters[1] = report.instrsNum;
+    counters[2] = report.pseudoOpsNum;
+    counters[3] = report.macroSubstsNum;
+    counters[4] = report.repetitionsNum;
+    counters[5] = report.expressionsNum;
+    counters[6] = report.relocationsNum;
+}
+
+void Assembler::printTimeReport(std::ostream& os) const
+{
+    double times[10];
+    uint64_t counters[7];
+    getTimeReportPhaseTimes(timeReport, times);
+    getTimeReportCounters(timeReport, counters);
+    const std::ios_base::fmtflags oldFlags = os.flags();
+    const std::streamsize oldPrecision = os.precision();
+    os << "===------------------------------------------===\n"
+        "  Assembler phases\n"
+        "===------------------------------------------===\n"
+        "  Time (s)  Phase\n";
+    os.setf(std::ios::fixed, std::ios::floatfield);
+    os.precision(6);
+    for (cxuint i = 0; i < 10; i++)
+    {
+        os.width(10);
+        os << times[i] << "  " << timeReportPhaseNames[i] << "\n";
+    }
+    os.flags(oldFlags);
+    os.precision(oldPrecision);
+    os << "  Counters:\n";
+    for (cxuint i = 0; i < 7; i++)
+        os << "    " << timeReportCounterNames[i] << ": " << counters[i] << "\n";
+    // statistics of register allocation per section
+    for (const AsmRegAllocStats& stats: regAllocStats)
+    {
+        const char* sectionName = sections[stats.sectionId].name;
+        os << "Section ";
+        if (sectionName != nullptr)
+            os << sectionName << ":\n";
+        else // unnamed section (default section of some formats)
+            os << stats.sectionId << ":\n";
+        AsmRegAllocator::printStats(os, stats);
+    }
+    os.flush();
+}
+
+void Assembler::printTimeReportJSON(std::ostream& os) const
+{
+    double times[10];
+    uint64_t counters[7];
+    getTimeReportPhaseTimes(timeReport, times);
+    getTimeReportCounters(timeReport, counters);
+    const std::ios_base::fmtflags oldFlags = os.flags();
+    const std::streamsize oldPrecision = os.precision();
+    os.setf(std::ios::fixed, std::ios::floatfield);
+    os.precision(9);
+    os << "{\n  \"times\": {";
+    for (cxuint i = 0; i < 10; i++)
+        os << (i!=0 ? ",\n" : "\n") << "    \"" << timeReportPhaseNames[i] <<
+                "\": " << times[i];
+    os << "\n  },\n  \"counters\": {";
+    for (cxuint i = 0; i < 7; i++)
+        os << (i!=0 ? ",\n" : "\n") << "    \"" << timeReportCounterNames[i] <<
+                "\": " << counters[i];
+    os << "\n  },\n  \"regAlloc\": [";
+    // statistics of register allocation per section
+    for (size_t i = 0; i < regAllocStats.size(); i++)
+    {
+        const AsmRegAllocStats& stats = regAllocStats[i];
+        double interGraphTime = 0.0, colorTime = 0.0;
+        for (cxuint regType = 0; regType < stats.regTypesNum; regType++)
+        {
+            interGraphTime += stats.interGraphTimes[regType];
+            colorTime += stats.colorTimes[regType];
+        }
+        const char* sectionName = sections[stats.sectionId].name;
+        os << (i!=0 ? ",\n" : "\n") << "    {\n"
+            "      \"sectionId\": " << stats.sectionId << ",\n"
+            "      \"section\": \"" << (sectionName != nullptr ? sectionName : "") <<
+                    "\",\n"
+            "      \"mode\": \"" << ((stats.mode == AsmRegAllocMode::LINEAR_SCAN) ?
+                        "linearScan" : "graphColoring") << "\",\n"
+            "      \"times\": {\n"
+            "        \"createCodeStructure\": " << stats.codeStructureTime << ",\n"
+            "        \"createSSAData\": " << stats.ssaDataTime << ",\n"
+            "        \"applySSAReplaces\": " << stats.ssaReplacesTime << ",\n"
+            "        \"createLivenesses\": " << stats.livenessesTime << ",\n"
+            "        \"createInterferenceGraph\": " << interGraphTime << ",\n"
+            "        \"allocate\": " << colorTime << ",\n"
+            "        \"total\": " << stats.totalTime << "\n"
+            "      },\n"
+            "      \"codeBlocks\": " << stats.codeBlocksNum << ",\n"
+            "      \"regTypes\": [";
+        for (cxuint regType = 0; regType < stats.regTypesNum; regType++)
+            os << (regType!=0 ? ",\n" : "\n") << "        { \"ssaValues\": " <<
+                    stats.ssaValuesNums[regType] << ", \"graphNodes\": " <<
+                    stats.graphNodesNums[regType] << ", \"graphEdges\": " <<
+                    stats.graphEdgesNums[regType] << ", \"colors\": " <<
+                    stats.colorsNums[regType] << " }";
+        os << "\n      ]\n    }";
+    }
+    os << (regAllocStats.empty() ? "]\n}\n" : "\n  ]\n}\n");
+    os.flags(oldFlags);
+    os.precision(oldPrecision);
+    os.flush();
+}
@@ -124,7 +124,7 @@ static AmdDisasmInput* getAmdDisasmInputFromBinary(const AmdMainBinary& binary,
     input->kernels.resize(kernelInfosNum);
     
     const Flags innerFlags = flags |
-        (((flags&DISASM_CONFIG)!=0) ? DISASM_METADATA|DISASM_CALNOTES : 0);
+        (((flags&(DISASM_CONFIG|DISASM_JSON))!=0) ? DISASM_METADATA|DISASM_CALNOTES : 0);
     for (cxuint i = 0; i < kernelInfosNum; i++)
     {
         const KernelInfo& kernelInfo = binary.getKernelInfo(i);
@@ -143,6 +143,8 @@ static AmdDisasmInput* getAmdDisasmInputFromBinary(const AmdMainBinary& binary,
         // kernel metadata
         kernelInput.metadataSize = binary.getMetadataSize(i);
         kernelInput.metadata = binary.getMetadata(i);
+        // reuse metadata tokenized while loading kernel info
+        kernelInput.metadataView = &binary.getMetadataView(i);
         
         // kernel header
         kernelInput.headerSize = 0;
@@ -399,7 +401,8 @@ inline static int strnecmp(const char* str1, const char* str2, size_t n, const c
 
 
 /* get configuration to human readable form */
-static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metadata,
+AmdKernelConfig CLRX::getAmdKernelConfig(size_t metadataSize, const char* metadata,
+            const AmdKernelMetadataView* metadataView,
             const std::vector<CALNoteInput>& calNotes, const CString& driverInfo,
             const cxbyte* kernelHeader)
 {
@@ -427,8 +430,8 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
     AmdKernelConfig config{};
     std::vector<cxuint> argUavIds;
     std::unordered_map<cxuint,cxuint> argCbIds;
-    std::unordered_map<CString, cxuint> argIndexMap;
     std::vector<cxuint> samplerArgIndices;
+    std::vector<AmdMetadataField> samplerArgNames;
     std::vector<cxuint> constArgIndices;
     // set as defaults
     config.dimMask = BINGEN_DEFAULT;
@@ -452,21 +455,37 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
     /* parse arguments from metadata string */
     /* this is very similar code as in AmdBinaries, but
      * includes type and all needed argument attributes */
-    const char* linePtr = metadata;
-    const char* mtEnd = metadata + metadataSize;
-    LineNo lineNo = 1;
-    for (; linePtr != mtEnd; lineNo++)
+    /* use tokenized metadata from binary if available */
+    AmdKernelMetadataView localView;
+    if (metadataView == nullptr)
     {
-        const char* lineEnd = linePtr;
-        while (lineEnd!=mtEnd && *lineEnd!='\n') lineEnd++;
+        localView.parse(metadataSize, metadata);
+        metadataView = &localView;
+    }
+    const size_t linesNum = metadataView->lines.size();
+    for (size_t li = 0; li < linesNum; li++)
+    {
+        const AmdMetadataLine& line = metadataView->lines[li];
+        if (!line.entry || line.fieldsNum < 2)
+            continue; // not entry 'key:...'
+        const LineNo lineNo = li+1;
+        const char* linePtr = line.ptr;
+        const char* lineEnd = line.ptr + line.size;
+        const AmdMetadataField& key = metadataView->getField(line, 0);
         const char* outEnd;
-        // local size
-        if (::strnecmp(linePtr, ";memory:hwlocal:", 16, lineEnd)==0)
-            config.hwLocalSize = cstrtovCStyle<size_t>(linePtr+16, lineEnd, outEnd);
-        // hw region
-        else if (::strnecmp(linePtr, ";memory:hwregion:", 17, lineEnd)==0)
-            config.hwRegion = cstrtovCStyle<uint32_t>(linePtr+17, lineEnd, outEnd);
-        else if (::strnecmp(linePtr, ";cws:", 5, lineEnd)==0)
+        if (key.equal("memory") && line.fieldsNum >= 3)
+        {
+            const AmdMetadataField& memKey = metadataView->getField(line, 1);
+            // local size
+            if (memKey.equal("hwlocal"))
+                config.hwLocalSize = cstrtovCStyle<size_t>(linePtr+16, lineEnd, outEnd);
+            // hw region
+            else if (memKey.equal("hwregion"))
+                config.hwRegion = cstrtovCStyle<uint32_t>(linePtr+17, lineEnd, outEnd);
+            else if (memKey.equal("uavprivate"))
+                config.uavPrivate = cstrtovCStyle<cxuint>(linePtr+19, lineEnd, outEnd);
+        }
+        else if (key.equal("cws"))
         { 
             // cws (reqd_work_group_size)
             config.reqdWorkGroupSize[0] = cstrtovCStyle<uint32_t>(
@@ -482,7 +501,7 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
             config.reqdWorkGroupSize[2] = cstrtovCStyle<uint32_t>(
                         outEnd, lineEnd, outEnd);
         }
-        else if (::strnecmp(linePtr, ";value:", 7, lineEnd)==0)
+        else if (key.equal("value"))
         {
             /* scalar value or structure */
             AmdKernelArgInput arg;
@@ -522,10 +541,9 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
                 arg.argType = determineKernelArgType(typeStr, vectorSize, lineNo);
             }
             argUavIds.push_back(0);
-            argIndexMap[arg.argName] = config.args.size();
             config.args.push_back(arg);
         }
-        else if (::strnecmp(linePtr, ";pointer:", 9, lineEnd)==0)
+        else if (key.equal("pointer"))
         {
             /* pointer (local, global, constant */
             AmdKernelArgInput arg;
@@ -616,10 +634,9 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
             ptr++;
             if (*ptr == '1')
                 arg.ptrAccess |= KARG_PTR_RESTRICT;
-            argIndexMap[arg.argName] = config.args.size();
             config.args.push_back(arg);
         }
-        else if (::strnecmp(linePtr, ";image:", 7, lineEnd)==0)
+        else if (key.equal("image"))
         {
             /* parse image argument entry */
             AmdKernelArgInput arg;
@@ -669,10 +686,9 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
             ptr += 3;
             arg.resId = cstrtovCStyle<uint32_t>(ptr, lineEnd, outEnd);
             argUavIds.push_back(0);
-            argIndexMap[arg.argName] = config.args.size();
             config.args.push_back(arg);
         }
-        else if (::strnecmp(linePtr, ";counter:", 9, lineEnd)==0)
+        else if (key.equal("counter"))
         {
             /* counter */
             AmdKernelArgInput arg;
@@ -693,23 +709,22 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
             arg.constSpaceSize = 0;
             arg.used = true;
             argUavIds.push_back(0);
-            argIndexMap[arg.argName] = config.args.size();
             config.args.push_back(arg);
         }
-        else if (::strnecmp(linePtr, ";constarg:", 10, lineEnd)==0)
+        else if (key.equal("constarg"))
         {
             /* constant argument to apply constant qualifier */
             cxuint argNo = cstrtovCStyle<cxuint>(linePtr+10, lineEnd, outEnd);
             constArgIndices.push_back(argNo);
         }
-        else if (::strnecmp(linePtr, ";sampler:", 9, lineEnd)==0)
+        else if (key.equal("sampler"))
         {
             /* image sampler */
             const char* ptr = strechr(linePtr+9, lineEnd, ':');
             if (ptr==nullptr)
                 throw ParseException(lineNo, "Can't parse sampler entry");
-            std::string samplerName(linePtr+9, ptr);
-            if (samplerName.compare(0, 8, "unknown_") == 0)
+            const AmdMetadataField& samplerName = metadataView->getField(line, 1);
+            if (samplerName.size >= 8 && ::strncmp(samplerName.ptr, "unknown_", 8) == 0)
             {
                 // add sampler
                 ptr++;
@@ -725,14 +740,12 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
             }
             else
             {
-                // this argument's sampler
-                auto it = argIndexMap.find(samplerName);
-                if (it!=argIndexMap.end())
-                    samplerArgIndices.push_back(it->second);
+                // this argument's sampler (resolved after all arguments)
+                samplerArgNames.push_back(samplerName);
                 argSamplers++;
             }
         }
-        else if (::strnecmp(linePtr, ";reflection:", 12, lineEnd)==0)
+        else if (key.equal("reflection"))
         {
             /* reflection that have type name */
             cxuint argNo = cstrtovCStyle<cxuint>(linePtr+12, lineEnd, outEnd);
@@ -762,7 +775,7 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
             }
             //else
         }
-        else if (::strnecmp(linePtr, ";uavid:", 7, lineEnd)==0)
+        else if (key.equal("uavid"))
         {
             cxuint uavId = cstrtovCStyle<cxuint>(linePtr+7, lineEnd, outEnd);
             uavIdToCompare = uavId;
@@ -770,17 +783,37 @@ static AmdKernelConfig getAmdKernelConfig(size_t metadataSize, const char* metad
                 uavIdToCompare = 9;
         }
         // get printfif
-        else if (::strnecmp(linePtr, ";printfid:", 10, lineEnd)==0)
+        else if (key.equal("printfid"))
             config.printfId = cstrtovCStyle<cxuint>(linePtr+10, lineEnd, outEnd);
         // get privateid
-        else if (::strnecmp(linePtr, ";privateid:", 11, lineEnd)==0)
+        else if (key.equal("privateid"))
             config.privateId = cstrtovCStyle<cxuint>(linePtr+11, lineEnd, outEnd);
-        else if (::strnecmp(linePtr, ";cbid:", 6, lineEnd)==0)
+        else if (key.equal("cbid"))
             config.constBufferId= cstrtovCStyle<cxuint>(linePtr+6, lineEnd, outEnd);
-        else if (::strnecmp(linePtr, ";memory:uavprivate:", 19, lineEnd)==0)
-            config.uavPrivate = cstrtovCStyle<cxuint>(linePtr+19, lineEnd, outEnd);
-        // to next line
-        linePtr = (lineEnd!=mtEnd) ? lineEnd+1 : lineEnd;
+    }
+    
+    if (!samplerArgNames.empty())
+    {
+        // find arguments for samplers (last argument if names are duplicated)
+        std::vector<cxuint> argOrder(config.args.size());
+        for (cxuint i = 0; i < argOrder.size(); i++)
+            argOrder[i] = i;
+        std::stable_sort(argOrder.begin(), argOrder.end(),
+            [&config](cxuint a1, cxuint a2)
+            { return config.args[a1].argName < config.args[a2].argName; });
+        for (const AmdMetadataField& samplerName: samplerArgNames)
+        {
+            auto it = std::upper_bound(argOrder.begin(), argOrder.end(), samplerName,
+                [&config](const AmdMetadataField& name, cxuint a)
+                {
+                    const CString& argName = config.args[a].argName;
+                    const int r = ::strncmp(name.ptr, argName.c_str(), name.size);
+                    return r < 0 || (r == 0 && name.size < argName.size());
+                });
+            if (it != argOrder.begin() &&
+                samplerName.equal(config.args[*(it-1)].argName.c_str()))
+                samplerArgIndices.push_back(*(it-1));
+        }
     }
     
     if (argSamplers != 0 && !config.samplers.empty())
@@ -974,7 +1007,7 @@ static const char* disasmCALNoteNamesTable[] =
 };
 
 /* dump kernel configuration in machine readable form */
-static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput& kinput,
+static void dumpAmdKernelDatas(DisasmOutput& output, const AmdDisasmKernelInput& kinput,
        Flags flags)
 {
     if ((flags & DISASM_METADATA) != 0)
@@ -982,20 +1015,20 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
         if (kinput.header != nullptr && kinput.headerSize != 0)
         {
             // if kernel header available
-            output.write("    .header\n", 12);
+            output.write(12, "    .header\n");
             printDisasmData(kinput.headerSize, kinput.header, output, true);
         }
         if (kinput.metadata != nullptr && kinput.metadataSize != 0)
         {
             // if kernel metadata available
-            output.write("    .metadata\n", 14);
+            output.write(14, "    .metadata\n");
             printDisasmLongString(kinput.metadataSize, kinput.metadata, output, true);
         }
     }
     if ((flags & DISASM_DUMPDATA) != 0 && kinput.data != nullptr && kinput.dataSize != 0)
     {
         // if kernel data available
-        output.write("    .data\n", 10);
+        output.write(10, "    .data\n");
         printDisasmData(kinput.dataSize, kinput.data, output, true);
     }
     
@@ -1006,16 +1039,16 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
             // calNote.header fields is already in native endian
             if (calNote.header.type != 0 && calNote.header.type <= CALNOTE_ATI_MAXTYPE)
             {
-                output.write("    ", 4);
-                output.write(disasmCALNoteNamesTable[calNote.header.type-1],
-                             ::strlen(disasmCALNoteNamesTable[calNote.header.type-1]));
+                output.write(4, "    ");
+                output.write(::strlen(disasmCALNoteNamesTable[calNote.header.type-1]),
+                             disasmCALNoteNamesTable[calNote.header.type-1]);
             }
             else
             {
                 // unknown CAL note type
                 const size_t len = itocstrCStyle(calNote.header.type, buf, 32, 16);
-                output.write("    .calnote ", 13);
-                output.write(buf, len);
+                output.write(13, "    .calnote ");
+                output.write(len, buf);
             }
             
             if (calNote.data == nullptr || calNote.header.descSize==0)
@@ -1047,7 +1080,7 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
                         bufPos += itocstrCStyle(ULEV(progInfo.value),
                                   buf+bufPos, 32, 16, 8);
                         buf[bufPos++] = '\n';
-                        output.write(buf, bufPos);
+                        output.write(bufPos, buf);
                     }
                     /// rest
                     printDisasmData(calNote.header.descSize -
@@ -1089,7 +1122,7 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
                         buf[bufPos++] = ' ';
                         bufPos += itocstrCStyle(ULEV(segment.size), buf+bufPos, 32);
                         buf[bufPos++] = '\n';
-                        output.write(buf, bufPos);
+                        output.write(bufPos, buf);
                     }
                     /// rest
                     printDisasmData(calNote.header.descSize -
@@ -1118,7 +1151,7 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
                         bufPos += itocstrCStyle(ULEV(sampler.sampler),
                                     buf+bufPos, 32, 16);
                         buf[bufPos++] = '\n';
-                        output.write(buf, bufPos);
+                        output.write(bufPos, buf);
                     }
                     /// rest
                     printDisasmData(calNote.header.descSize -
@@ -1146,7 +1179,7 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
                         buf[bufPos++] = ' ';
                         bufPos += itocstrCStyle(ULEV(cbufMask.size), buf+bufPos, 32);
                         buf[bufPos++] = '\n';
-                        output.write(buf, bufPos);
+                        output.write(bufPos, buf);
                     }
                     /// rest
                     printDisasmData(calNote.header.descSize -
@@ -1165,7 +1198,7 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
                                 ULEV(*reinterpret_cast<const uint32_t*>(
                                     calNote.data)), buf, 32);
                         output.put(' ');
-                        output.write(buf, len);
+                        output.write(len, buf);
                         output.put('\n');
                     }
                     else
@@ -1200,7 +1233,7 @@ static void dumpAmdKernelDatas(std::ostream& output, const AmdDisasmKernelInput&
                         buf[bufPos++] = ' ';
                         bufPos += itocstrCStyle(ULEV(uavEntry.type), buf+bufPos, 32);
                         buf[bufPos++] = '\n';
-                        output.write(buf, bufPos);
+                        output.write(bufPos, buf);
                     }
                     /// rest
                     printDisasmData(calNote.header.descSize -
@@ -1276,24 +1309,24 @@ static const char* kernelArgTypeNamesTbl[] =
 };
 
 /* function to print kernel argument (used by DisasmAmd and DisasmAmdCL2 */
-void CLRX::dumpAmdKernelArg(std::ostream& output, const AmdKernelArgInput& arg, bool cl20)
+void CLRX::dumpAmdKernelArg(DisasmOutput& output, const AmdKernelArgInput& arg, bool cl20)
 {
     size_t bufSize;
     char buf[100];
-    output.write("        .arg ", 13);
-    output.write(arg.argName.c_str(), arg.argName.size());
-    output.write(", \"", 3);
-    output.write(arg.typeName.c_str(), arg.typeName.size());
+    output.write(13, "        .arg ");
+    output.write(arg.argName.size(), arg.argName.c_str());
+    output.write(3, ", \"");
+    output.write(arg.typeName.size(), arg.typeName.c_str());
     if (arg.argType != KernelArgType::POINTER)
     {
         bufSize = snprintf(buf, 100, "\", %s",
                    kernelArgTypeNamesTbl[cxuint(arg.argType)]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if (arg.argType == KernelArgType::STRUCTURE)
         {
             // structure size
             bufSize = snprintf(buf, 100, ", %u", arg.structSize);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         bool isImage = false;
         if (isKernelArgImage(arg.argType))
@@ -1303,20 +1336,20 @@ void CLRX::dumpAmdKernelArg(std::ostream& output, const AmdKernelArgInput& arg,
             cxbyte access = arg.ptrAccess & KARG_PTR_ACCESS_MASK;
             // print access qualifier
             if (access == KARG_PTR_READ_ONLY)
-                output.write(", read_only", 11);
+                output.write(11, ", read_only");
             else if (access == KARG_PTR_WRITE_ONLY)
-                output.write(", write_only", 12);
+                output.write(12, ", write_only");
             else if (access == KARG_PTR_READ_WRITE)
-                output.write(", read_write", 12);
+                output.write(12, ", read_write");
             else
-                output.write(", ", 2);
+                output.write(2, ", ");
         }
         if (isImage || ((!cl20 && arg.argType == KernelArgType::COUNTER32) ||
             (cl20 && arg.argType == KernelArgType::SAMPLER)))
         {
             // print resource id: only for images counters and for samplers (if CL2.0)
             bufSize = snprintf(buf, 100, ", %u", arg.resId);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
     }
     else
@@ -1324,20 +1357,20 @@ void CLRX::dumpAmdKernelArg(std::ostream& output, const AmdKernelArgInput& arg,
         // pointer
         bufSize = snprintf(buf, 100, "\", %s*",
                    kernelArgTypeNamesTbl[cxuint(arg.pointerType)]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if (arg.pointerType == KernelArgType::STRUCTURE)
         {
             // structure size
             bufSize = snprintf(buf, 100, ", %u", arg.structSize);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         // print pointer space
         if (arg.ptrSpace == KernelPtrSpace::CONSTANT)
-            output.write(", constant", 10);
+            output.write(10, ", constant");
         else if (arg.ptrSpace == KernelPtrSpace::LOCAL)
-            output.write(", local", 7);
+            output.write(7, ", local");
         else if (arg.ptrSpace == KernelPtrSpace::GLOBAL)
-            output.write(", global", 8);
+            output.write(8, ", global");
         
         if ((arg.ptrAccess & (KARG_PTR_CONST|KARG_PTR_VOLATILE|KARG_PTR_RESTRICT))!=0)
         {
@@ -1346,39 +1379,39 @@ void CLRX::dumpAmdKernelArg(std::ostream& output, const AmdKernelArgInput& arg,
                      ((arg.ptrAccess & KARG_PTR_CONST) ? " const" : ""),
                      ((arg.ptrAccess & KARG_PTR_RESTRICT) ? " restrict" : ""),
                      ((arg.ptrAccess & KARG_PTR_VOLATILE) ? " volatile" : ""));
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         else // empty
-            output.write(", ", 2);
+            output.write(2, ", ");
         if (arg.ptrSpace==KernelPtrSpace::CONSTANT && !cl20)
         {
             // constant size
             bufSize = snprintf(buf, 100, ", %" PRIu64, uint64_t(arg.constSpaceSize));
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         if (arg.ptrSpace!=KernelPtrSpace::LOCAL && !cl20)
         {
             // resid
             bufSize = snprintf(buf, 100, ", %u", arg.resId);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
     }
     if (!arg.used)
-        output.write(", unused\n", 9);
+        output.write(9, ", unused\n");
     // further flags for OpenCL 2.0 binary format
     else if (cl20 && arg.used==AMDCL2_ARGUSED_READ)
-        output.write(", rdonly\n", 9);
+        output.write(9, ", rdonly\n");
     else if (cl20 && arg.used==AMDCL2_ARGUSED_WRITE)
-        output.write(", wronly\n", 9);
+        output.write(9, ", wronly\n");
     else
-        output.write("\n", 1);
+        output.write(1, "\n");
 }
 
-static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& config)
+static void dumpAmdKernelConfig(DisasmOutput& output, const AmdKernelConfig& config)
 {
     size_t bufSize;
     char buf[100];
-    output.write("    .config\n", 12);
+    output.write(12, "    .config\n");
     if (config.dimMask != BINGEN_DEFAULT)
     {
         // print dimensions (.dims xyz)
@@ -1391,7 +1424,7 @@ static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& con
         if ((config.dimMask & 4) != 0)
             buf[bufSize++] = 'z';
         buf[bufSize++] = '\n';
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     // print reqd_work_group_size: .cws XSIZE[,YSIZE[,ZSIZE]]
     if (config.reqdWorkGroupSize[0] != 0 || config.reqdWorkGroupSize[1] != 0 ||
@@ -1400,77 +1433,77 @@ static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& con
         bufSize = snprintf(buf, 100, "        .cws %u, %u, %u\n",
                config.reqdWorkGroupSize[0], config.reqdWorkGroupSize[1],
                config.reqdWorkGroupSize[2]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     bufSize = snprintf(buf, 100, "        .sgprsnum %u\n", config.usedSGPRsNum);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .vgprsnum %u\n", config.usedVGPRsNum);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if (config.hwRegion!=0 && config.hwRegion!=BINGEN_DEFAULT)
     {
         bufSize = snprintf(buf, 100, "        .hwregion %u\n", config.hwRegion);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (config.hwLocalSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .hwlocal %" PRIu64 "\n",
                        uint64_t(config.hwLocalSize));
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     bufSize = snprintf(buf, 100, "        .floatmode 0x%02x\n", config.floatMode);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if (config.scratchBufferSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .scratchbuffer %u\n",
                            config.scratchBufferSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (config.uavId!=BINGEN_DEFAULT)
     {
         bufSize = snprintf(buf, 100, "        .uavid %u\n", config.uavId);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (config.uavPrivate!=BINGEN_DEFAULT)
     {
         bufSize = snprintf(buf, 100, "        .uavprivate %u\n", config.uavPrivate);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (config.printfId!=BINGEN_DEFAULT)
     {
         bufSize = snprintf(buf, 100, "        .printfid %u\n", config.printfId);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (config.privateId!=BINGEN_DEFAULT)
     {
         bufSize = snprintf(buf, 100, "        .privateid %u\n", config.privateId);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (config.constBufferId!=BINGEN_DEFAULT)
     {
         bufSize = snprintf(buf, 100, "        .cbid %u\n", config.constBufferId);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     bufSize = snprintf(buf, 100, "        .earlyexit %u\n", config.earlyExit);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .condout %u\n", config.condOut);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .pgmrsrc2 0x%08x\n", config.pgmRSRC2);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     // flags in PGMRSRC2
     if (config.ieeeMode)
-        output.write("        .ieeemode\n", 18);
+        output.write(18, "        .ieeemode\n");
     if (config.tgSize)
-        output.write("        .tgsize\n", 16);
+        output.write(16, "        .tgsize\n");
     if (config.usePrintf)
-        output.write("        .useprintf\n", 19);
+        output.write(19, "        .useprintf\n");
     if (config.useConstantData)
-        output.write("        .useconstdata\n", 22);
+        output.write(22, "        .useconstdata\n");
     if ((config.exceptions & 0x7f) != 0)
     {
         bufSize = snprintf(buf, 100, "        .exceptions 0x%02x\n",
                    cxuint(config.exceptions));
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     /* user datas */
     for (AmdUserData userData: config.userDatas)
@@ -1480,7 +1513,7 @@ static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& con
             dataClassName = dataClassNameTbl[userData.dataClass];
         bufSize = snprintf(buf, 100, "        .userdata %s, %u, %u, %u\n", dataClassName,
                 userData.apiSlot, userData.regStart, userData.regSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     // arguments
     for (const AmdKernelArgInput& arg: config.args)
@@ -1489,17 +1522,18 @@ static void dumpAmdKernelConfig(std::ostream& output, const AmdKernelConfig& con
     for (cxuint sampler: config.samplers)
     {
         bufSize = snprintf(buf, 100, "        .sampler 0x%x\n", sampler);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
 }
 
-void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
-       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+void CLRX::disassembleAmd(DisasmOutput& output, const AmdDisasmInput* amdInput,
+       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags,
+       cxuint threadsNum)
 {
     if (amdInput->is64BitMode)
-        output.write(".64bit\n", 7);
+        output.write(7, ".64bit\n");
     else
-        output.write(".32bit\n", 7);
+        output.write(7, ".32bit\n");
     
     const bool doMetadata = ((flags & DISASM_METADATA) != 0);
     const bool doDumpData = ((flags & DISASM_DUMPDATA) != 0);
@@ -1508,27 +1542,35 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
     if (doMetadata)
     {
         // compile options and driver info belongs to metadata
-        output.write(".compile_options \"", 18);
+        output.write(18, ".compile_options \"");
         const std::string escapedCompileOptions = 
                 escapeStringCStyle(amdInput->compileOptions);
-        output.write(escapedCompileOptions.c_str(), escapedCompileOptions.size());
-        output.write("\"\n.driver_info \"", 16);
+        output.write(escapedCompileOptions.size(), escapedCompileOptions.c_str());
+        output.write(16, "\"\n.driver_info \"");
         const std::string escapedDriverInfo =
                 escapeStringCStyle(amdInput->driverInfo);
-        output.write(escapedDriverInfo.c_str(), escapedDriverInfo.size());
-        output.write("\"\n", 2);
+        output.write(escapedDriverInfo.size(), escapedDriverInfo.c_str());
+        output.write(2, "\"\n");
     }
     
     if (doDumpData && amdInput->globalData != nullptr && amdInput->globalDataSize != 0)
     {   //
-        output.write(".globaldata\n", 12);
+        output.write(12, ".globaldata\n");
         printDisasmData(amdInput->globalDataSize, amdInput->globalData, output);
     }
     
-    for (const AmdDisasmKernelInput& kinput: amdInput->kernels)
+    auto hasKernelCode = [amdInput, doDumpCode](size_t i)
+    {
+        const AmdDisasmKernelInput& kinput = amdInput->kernels[i];
+        return doDumpCode && kinput.code != nullptr && kinput.codeSize != 0;
+    };
+    disassembleKernels(output, amdInput->kernels.size(), isaDisassembler, sectionCount,
+                threadsNum, hasKernelCode, [amdInput, flags, &hasKernelCode]
+                (DisasmOutput& output, ISADisassembler* isaDisassembler, size_t i)
     {
-        output.write(".kernel ", 8);
-        output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
+        const AmdDisasmKernelInput& kinput = amdInput->kernels[i];
+        output.write(8, ".kernel ");
+        output.write(kinput.kernelName.size(), kinput.kernelName.c_str());
         output.put('\n');
         if ((flags & DISASM_CONFIG) == 0) // if not config
             dumpAmdKernelDatas(output, kinput, flags);
@@ -1536,19 +1578,18 @@ void CLRX::disassembleAmd(std::ostream& output, const AmdDisasmInput* amdInput,
         {
             // dump in human readable configuration
             AmdKernelConfig config = getAmdKernelConfig(kinput.metadataSize,
-                    kinput.metadata, kinput.calNotes, amdInput->driverInfo,
-                    kinput.header);
+                    kinput.metadata, kinput.metadataView, kinput.calNotes,
+                    amdInput->driverInfo, kinput.header);
             dumpAmdKernelConfig(output, config);
         }
         
-        if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+        if (hasKernelCode(i))
         {
             // input kernel code (main disassembly)
-            output.write("    .text\n", 10);
+            output.write(10, "    .text\n");
             isaDisassembler->setInput(kinput.codeSize, kinput.code);
             isaDisassembler->beforeDisassemble();
             isaDisassembler->disassemble();
-            sectionCount++;
         }
-    }
+    });
 }
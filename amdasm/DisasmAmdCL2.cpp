@@ -119,26 +119,13 @@ static AmdCL2DisasmInput* getAmdCL2DisasmInputFromBinary(
         textPtr = innerBin.getSectionContent(".hsatext");
         
         // getting optional sections in inner binary
-        try
-        { gDataSectionIdx = innerBin.getSectionIndex(".hsadata_readonly_agent"); }
-        catch(const Exception& ex)
-        { }
-        try
-        { rwDataSectionIdx = innerBin.getSectionIndex(".hsadata_global_agent"); }
-        catch(const Exception& ex)
-        { }
-        try
-        { bssDataSectionIdx = innerBin.getSectionIndex(".hsabss_global_agent"); }
-        catch(const Exception& ex)
-        { }
+        gDataSectionIdx = innerBin.findSectionIndex(".hsadata_readonly_agent");
+        rwDataSectionIdx = innerBin.findSectionIndex(".hsadata_global_agent");
+        bssDataSectionIdx = innerBin.findSectionIndex(".hsabss_global_agent");
         // relocations for global data section (sampler symbols)
         relaNum = innerBin.getGlobalDataRelaEntriesNum();
         // section index for samplerinit (will be used for comparing sampler symbol section
-        uint16_t samplerInitSecIndex = SHN_UNDEF;
-        try
-        { samplerInitSecIndex = innerBin.getSectionIndex(".hsaimage_samplerinit"); }
-        catch(const Exception& ex)
-        { }
+        uint16_t samplerInitSecIndex = innerBin.findSectionIndex(".hsaimage_samplerinit");
         
         // store sampler relocations to samplerRelocs
         for (size_t i = 0; i < relaNum; i++)
@@ -300,27 +287,6 @@ AmdCL2DisasmInput* CLRX::getAmdCL2DisasmInputFromBinary64(
     return getAmdCL2DisasmInputFromBinary<AmdCL2Types64>(binary, driverVersion);
 }
 
-// internal AMD OpenCL 2.0 Kernel setup (part of AMD HSA config)
-struct CLRX_INTERNAL IntAmdCL2SetupData
-{
-    uint32_t pgmRSRC1;
-    uint32_t pgmRSRC2;
-    uint16_t setup1;
-    uint16_t archInd;
-    uint32_t scratchBufferSize;
-    uint32_t localSize; // in bytes
-    uint32_t gdsSize;   // in bytes
-    uint32_t kernelArgsSize;
-    uint32_t zeroes[2];
-    // really is, reserved Xgprs, but filled by driver
-    uint16_t sgprsNumAll;
-    uint16_t vgprsNum16;
-    uint32_t vgprsNum;
-    uint32_t sgprsNum;
-    uint32_t zero3;
-    uint32_t version; // ??
-};
-
 static const size_t disasmArgTypeNameMapSize = sizeof(disasmArgTypeNameMap)/
             sizeof(std::pair<const char*, KernelArgType>);
 
@@ -393,8 +359,8 @@ static AmdCL2KernelConfig genKernelConfig(size_t metadataSize, const cxbyte* met
     if (setup != nullptr)
     {
         // if passed to this function
-        const IntAmdCL2SetupData* setupData =
-                reinterpret_cast<const IntAmdCL2SetupData*>(setup + 48);
+        const AmdCL2SetupData* setupData =
+                reinterpret_cast<const AmdCL2SetupData*>(setup + 48);
         uint32_t pgmRSRC1 = ULEV(setupData->pgmRSRC1);
         uint32_t pgmRSRC2 = ULEV(setupData->pgmRSRC2);
         /* initializing fields from PGM_RSRC1 and PGM_RSRC2 */
@@ -667,15 +633,15 @@ static AmdCL2KernelConfig genKernelConfig(size_t metadataSize, const cxbyte* met
     return config;
 }
 
-static void dumpAmdCL2KernelConfig(std::ostream& output,
+static void dumpAmdCL2KernelConfig(DisasmOutput& output,
                     const AmdCL2KernelConfig& config, bool hsaConfig)
 {
     size_t bufSize;
     char buf[100];
     if (hsaConfig)
-        output.write("    .hsaconfig\n", 15);
+        output.write(15, "    .hsaconfig\n");
     else
-        output.write("    .config\n", 12);
+        output.write(12, "    .config\n");
     
     if (!hsaConfig)
     {
@@ -691,7 +657,7 @@ static void dumpAmdCL2KernelConfig(std::ostream& output,
             if ((config.dimMask & 4) != 0)
                 buf[bufSize++] = 'z';
             buf[bufSize++] = '\n';
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
     }
     // print reqd_work_group_size: .cws XSIZE[,YSIZE[,ZSIZE]]
@@ -701,7 +667,7 @@ static void dumpAmdCL2KernelConfig(std::ostream& output,
         bufSize = snprintf(buf, 100, "        .cws %u, %u, %u\n",
                config.reqdWorkGroupSize[0], config.reqdWorkGroupSize[1],
                config.reqdWorkGroupSize[2]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     // work group size hint
@@ -711,77 +677,77 @@ static void dumpAmdCL2KernelConfig(std::ostream& output,
         bufSize = snprintf(buf, 100, "        .work_group_size_hint %u, %u, %u\n",
                config.workGroupSizeHint[0], config.workGroupSizeHint[1],
                config.workGroupSizeHint[2]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (!config.vecTypeHint.empty())
     {
-        output.write("        .vectypehint ", 21);
-        output.write(config.vecTypeHint.c_str(), config.vecTypeHint.size());
-        output.write("\n", 1);
+        output.write(21, "        .vectypehint ");
+        output.write(config.vecTypeHint.size(), config.vecTypeHint.c_str());
+        output.write(1, "\n");
     }
     
     if (!hsaConfig)
     {
         // do not print old-config style params if HSA config enabled
         bufSize = snprintf(buf, 100, "        .sgprsnum %u\n", config.usedSGPRsNum);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .vgprsnum %u\n", config.usedVGPRsNum);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         
         if (config.localSize!=0)
         {
             bufSize = snprintf(buf, 100, "        .localsize %" PRIu64 "\n",
                         uint64_t(config.localSize));
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         if (config.gdsSize!=0)
         {
             bufSize = snprintf(buf, 100, "        .gdssize %u\n", config.gdsSize);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         bufSize = snprintf(buf, 100, "        .floatmode 0x%02x\n", config.floatMode);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if (config.scratchBufferSize!=0)
         {
             bufSize = snprintf(buf, 100, "        .scratchbuffer %u\n",
                             config.scratchBufferSize);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         bufSize = snprintf(buf, 100, "        .pgmrsrc1 0x%08x\n", config.pgmRSRC1);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .pgmrsrc2 0x%08x\n", config.pgmRSRC2);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         // pgmrsrc1 and pgmrsrc2 flags
         if (config.privilegedMode)
-            output.write("        .privmode\n", 18);
+            output.write(18, "        .privmode\n");
         if (config.debugMode)
-            output.write("        .debugmode\n", 19);
+            output.write(19, "        .debugmode\n");
         if (config.dx10Clamp)
-            output.write("        .dx10clamp\n", 19);
+            output.write(19, "        .dx10clamp\n");
         if (config.ieeeMode)
-            output.write("        .ieeemode\n", 18);
+            output.write(18, "        .ieeemode\n");
         if (config.tgSize)
-            output.write("        .tgsize\n", 16);
+            output.write(16, "        .tgsize\n");
         if ((config.exceptions & 0x7f) != 0)
         {
             bufSize = snprintf(buf, 100, "        .exceptions 0x%02x\n",
                     cxuint(config.exceptions));
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         if (config.useArgs)
-            output.write("        .useargs\n", 17);
+            output.write(17, "        .useargs\n");
         if (config.useSetup)
-            output.write("        .usesetup\n", 18);
+            output.write(18, "        .usesetup\n");
         if (config.useEnqueue)
-            output.write("        .useenqueue\n", 20);
+            output.write(20, "        .useenqueue\n");
         if (config.useGeneric)
-            output.write("        .usegeneric\n", 20);
+            output.write(20, "        .usegeneric\n");
         bufSize = snprintf(buf, 100, "        .priority %u\n", config.priority);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
 }
 
-static void dumpAmdCL2ArgsAndSamplers(std::ostream& output,
+static void dumpAmdCL2ArgsAndSamplers(DisasmOutput& output,
                     const AmdCL2KernelConfig& config)
 {
     size_t bufSize;
@@ -793,12 +759,13 @@ static void dumpAmdCL2ArgsAndSamplers(std::ostream& output,
     for (cxuint sampler: config.samplers)
     {
         bufSize = snprintf(buf, 100, "        .sampler %u\n", sampler);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
 }
 
-void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdCL2Input,
-       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags)
+void CLRX::disassembleAmdCL2(DisasmOutput& output, const AmdCL2DisasmInput* amdCL2Input,
+       ISADisassembler* isaDisassembler, size_t& sectionCount, Flags flags,
+       cxuint threadsNum)
 {
     const bool doMetadata = ((flags & DISASM_METADATA) != 0);
     const bool doDumpData = ((flags & DISASM_DUMPDATA) != 0);
@@ -808,41 +775,41 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
     const bool doHSAConfig = ((flags & DISASM_HSACONFIG) != 0);
     
     if (amdCL2Input->is64BitMode)
-        output.write(".64bit\n", 7);
+        output.write(7, ".64bit\n");
     else
-        output.write(".32bit\n", 7);
+        output.write(7, ".32bit\n");
     
     {
         // print architecture version
         char buf[40];
         size_t size = snprintf(buf, 40, ".arch_minor %u\n", amdCL2Input->archMinor);
-        output.write(buf, size);
+        output.write(size, buf);
         size = snprintf(buf, 40, ".arch_stepping %u\n", amdCL2Input->archStepping);
-        output.write(buf, size);
+        output.write(size, buf);
         size = snprintf(buf, 40, ".driver_version %u\n",
                    amdCL2Input->driverVersion);
-        output.write(buf, size);
+        output.write(size, buf);
     }
     
     if (doMetadata)
     {
         // print compile options and acl_version
-        output.write(".compile_options \"", 18);
+        output.write(18, ".compile_options \"");
         const std::string escapedCompileOptions = 
                 escapeStringCStyle(amdCL2Input->compileOptions);
-        output.write(escapedCompileOptions.c_str(), escapedCompileOptions.size());
-        output.write("\"\n.acl_version \"", 16);
+        output.write(escapedCompileOptions.size(), escapedCompileOptions.c_str());
+        output.write(16, "\"\n.acl_version \"");
         const std::string escapedAclVersionString =
                 escapeStringCStyle(amdCL2Input->aclVersionString);
-        output.write(escapedAclVersionString.c_str(), escapedAclVersionString.size());
-        output.write("\"\n", 2);
+        output.write(escapedAclVersionString.size(), escapedAclVersionString.c_str());
+        output.write(2, "\"\n");
     }
     if (doSetup && !doDumpConfig)
     {
         if (amdCL2Input->samplerInit!=nullptr && amdCL2Input->samplerInitSize!=0)
         {
             /// sampler init entries
-            output.write(".samplerinit\n", 13);
+            output.write(13, ".samplerinit\n");
             printDisasmData(amdCL2Input->samplerInitSize,
                             amdCL2Input->samplerInit, output);
         }
@@ -856,50 +823,50 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
         {
             size_t bufSize = snprintf(buf, 50, ".sampler 0x%08x\n",
                       ULEV(((const uint32_t*)amdCL2Input->samplerInit)[i*2+1]));
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
     }
     
     if (doDumpData && amdCL2Input->globalData != nullptr &&
         amdCL2Input->globalDataSize != 0)
     {
-        output.write(".globaldata\n", 12);
-        output.write(".gdata:\n", 8); /// symbol used by text relocations
+        output.write(12, ".globaldata\n");
+        output.write(8, ".gdata:\n"); /// symbol used by text relocations
         printDisasmData(amdCL2Input->globalDataSize, amdCL2Input->globalData, output);
         /// put sampler relocations at global data section
         for (auto v: amdCL2Input->samplerRelocs)
         {
-            output.write("    .samplerreloc ", 18);
+            output.write(18, "    .samplerreloc ");
             char buf[64];
             size_t bufPos = itocstrCStyle<size_t>(v.first, buf, 22);
             buf[bufPos++] = ',';
             buf[bufPos++] = ' ';
             bufPos += itocstrCStyle<size_t>(v.second, buf+bufPos, 22);
             buf[bufPos++] = '\n';
-            output.write(buf, bufPos);
+            output.write(bufPos, buf);
         }
     }
     if (doDumpData && amdCL2Input->rwData != nullptr &&
         amdCL2Input->rwDataSize != 0)
     {
-        output.write(".data\n", 6);
-        output.write(".ddata:\n", 8); /// symbol used by text relocations
+        output.write(6, ".data\n");
+        output.write(8, ".ddata:\n"); /// symbol used by text relocations
         printDisasmData(amdCL2Input->rwDataSize, amdCL2Input->rwData, output);
     }
     
     if (doDumpData && amdCL2Input->bssSize)
     {
         // print .bss with alignment and skip (content filling)
-        output.write(".section .bss align=", 20);
+        output.write(20, ".section .bss align=");
         char buf[64];
         size_t bufPos = itocstrCStyle<size_t>(amdCL2Input->bssAlignment, buf, 22);
         buf[bufPos++] = '\n';
-        output.write(buf, bufPos);
-        output.write(".bdata:\n", 8); /// symbol used by text relocations
-        output.write("    .skip ", 10);
+        output.write(bufPos, buf);
+        output.write(8, ".bdata:\n"); /// symbol used by text relocations
+        output.write(10, "    .skip ");
         bufPos = itocstrCStyle<size_t>(amdCL2Input->bssSize, buf, 22);
         buf[bufPos++] = '\n';
-        output.write(buf, bufPos);
+        output.write(bufPos, buf);
     }
     
     // prepare sampler offsets
@@ -917,23 +884,31 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(amdCL2Input->deviceType);
     const cxuint maxSgprsNum = getGPUMaxRegistersNum(arch, REGTYPE_SGPR, 0);
     
-    for (const AmdCL2DisasmKernelInput& kinput: amdCL2Input->kernels)
+    auto hasKernelCode = [amdCL2Input, doDumpCode](size_t i)
     {
-        output.write(".kernel ", 8);
-        output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
+        const AmdCL2DisasmKernelInput& kinput = amdCL2Input->kernels[i];
+        return doDumpCode && kinput.code != nullptr && kinput.codeSize != 0;
+    };
+    disassembleKernels(output, amdCL2Input->kernels.size(), isaDisassembler,
+                sectionCount, threadsNum, hasKernelCode, [&]
+                (DisasmOutput& output, ISADisassembler* isaDisassembler, size_t i)
+    {
+        const AmdCL2DisasmKernelInput& kinput = amdCL2Input->kernels[i];
+        output.write(8, ".kernel ");
+        output.write(kinput.kernelName.size(), kinput.kernelName.c_str());
         output.put('\n');
         if (doMetadata && !doDumpConfig)
         {
             if (kinput.metadata != nullptr && kinput.metadataSize != 0)
             {
                 // if kernel metadata available
-                output.write("    .metadata\n", 14);
+                output.write(14, "    .metadata\n");
                 printDisasmData(kinput.metadataSize, kinput.metadata, output, true);
             }
             if (kinput.isaMetadata != nullptr && kinput.isaMetadataSize != 0)
             {
                 // if kernel isametadata available
-                output.write("    .isametadata\n", 17);
+                output.write(17, "    .isametadata\n");
                 printDisasmData(kinput.isaMetadataSize, kinput.isaMetadata, output, true);
             }
         }
@@ -942,13 +917,13 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
             if (kinput.stub != nullptr && kinput.stubSize != 0)
             {
                 // if kernel setup available
-                output.write("    .stub\n", 10);
+                output.write(10, "    .stub\n");
                 printDisasmData(kinput.stubSize, kinput.stub, output, true);
             }
             if (kinput.setup != nullptr && kinput.setupSize != 0)
             {
                 // if kernel setup available
-                output.write("    .setup\n", 11);
+                output.write(11, "    .setup\n");
                 printDisasmData(kinput.setupSize, kinput.setup, output, true);
             }
         }
@@ -976,13 +951,13 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
                 // print as HSA config
                 dumpAMDHSAConfig(output, maxSgprsNum, arch,
                      *reinterpret_cast<const AmdHsaKernelConfig*>(kinput.setup));
-                output.write("    .hsaconfig\n", 15);
+                output.write(15, "    .hsaconfig\n");
             }
             
             dumpAmdCL2ArgsAndSamplers(output, config);
         }
         
-        if (doDumpCode && kinput.code != nullptr && kinput.codeSize != 0)
+        if (hasKernelCode(i))
         {
             // input kernel code (main disassembly)
             isaDisassembler->clearRelocations();
@@ -993,11 +968,10 @@ void CLRX::disassembleAmdCL2(std::ostream& output, const AmdCL2DisasmInput* amdC
                 isaDisassembler->addRelocation(entry.offset, entry.type, 
                                cxuint(entry.symbol), entry.addend);
     
-            output.write("    .text\n", 10);
+            output.write(10, "    .text\n");
             isaDisassembler->setInput(kinput.codeSize, kinput.code);
             isaDisassembler->beforeDisassemble();
             isaDisassembler->disassemble();
-            sectionCount++;
         }
-    }
+    });
 }
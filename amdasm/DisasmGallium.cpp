@@ -40,11 +40,7 @@ template<typename GalliumElfBinary>
 static void getGalliumDisasmInputFromBinaryBase(const GalliumBinary& binary,
             const GalliumElfBinary& elfBin, GalliumDisasmInput* input)
 {
-    uint16_t rodataIndex = SHN_UNDEF;
-    try
-    { rodataIndex = elfBin.getSectionIndex(".rodata"); }
-    catch(const Exception& ex)
-    { }
+    uint16_t rodataIndex = elfBin.findSectionIndex(".rodata");
     const uint16_t textIndex = elfBin.getSectionIndex(".text");
     
     // set up global data (is '.rodata' section)
@@ -121,10 +117,10 @@ static const char* galliumArgSemTypeNamesTbl[] =
     "general", "griddim", "gridoffset", "imgsize", "imgformat"
 };
 
-static void dumpKernelConfig(std::ostream& output, cxuint maxSgprsNum,
+static void dumpKernelConfig(DisasmOutput& output, cxuint maxSgprsNum,
              GPUArchitecture arch, const GalliumProgInfoEntry* progInfo, bool isLLVM390)
 {
-    output.write("    .config\n", 12);
+    output.write(12, "    .config\n");
     size_t bufSize;
     char buf[100];
     const cxuint ldsShift = arch<GPUArchitecture::GCN1_1 ? 8 : 9;
@@ -145,64 +141,64 @@ static void dumpKernelConfig(std::ostream& output, cxuint maxSgprsNum,
     if ((dimMask & 4) != 0)
         buf[bufSize++] = 'z';
     buf[bufSize++] = '\n';
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     
     // print SGPR and VGPR number from PGMRSRC1
     bufSize = snprintf(buf, 100, "        .sgprsnum %u\n",
               std::min((((pgmRsrc1>>6) & 0xf)<<3)+8, maxSgprsNum));
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .vgprsnum %u\n", ((pgmRsrc1 & 0x3f)<<2)+4);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if ((pgmRsrc1 & (1U<<20)) != 0)
-        output.write("        .privmode\n", 18);
+        output.write(18, "        .privmode\n");
     if ((pgmRsrc1 & (1U<<22)) != 0)
-        output.write("        .debugmode\n", 19);
+        output.write(19, "        .debugmode\n");
     if ((pgmRsrc1 & (1U<<21)) != 0)
-        output.write("        .dx10clamp\n", 19);
+        output.write(19, "        .dx10clamp\n");
     if ((pgmRsrc1 & (1U<<23)) != 0)
-        output.write("        .ieeemode\n", 18);
+        output.write(18, "        .ieeemode\n");
     if ((pgmRsrc2 & 0x400) != 0)
-        output.write("        .tgsize\n", 16);
+        output.write(16, "        .tgsize\n");
     
     bufSize = snprintf(buf, 100, "        .floatmode 0x%02x\n", (pgmRsrc1>>12) & 0xff);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .priority %u\n", (pgmRsrc1>>10) & 3);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if (((pgmRsrc1>>24) & 0x7f) != 0)
     {
         bufSize = snprintf(buf, 100, "        .exceptions 0x%02x\n",
                    (pgmRsrc1>>24) & 0x7f);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     const cxuint localSize = ((pgmRsrc2>>15) & 0x1ff) << ldsShift;
     if (localSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .localsize %u\n", localSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     bufSize = snprintf(buf, 100, "        .userdatanum %u\n", (pgmRsrc2>>1) & 0x1f);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     const cxuint scratchSize = ((scratchVal >> 12) << 10) >> 6;
     if (scratchSize != 0) // scratch buffer
     {
         bufSize = snprintf(buf, 100, "        .scratchbuffer %u\n", scratchSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     bufSize = snprintf(buf, 100, "        .pgmrsrc1 0x%08x\n", pgmRsrc1);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .pgmrsrc2 0x%08x\n", pgmRsrc2);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if (isLLVM390)
     {
         // extra info (spilled GPRs)
         bufSize = snprintf(buf, 100, "        .spilledsgprs %d\n", spilledSGPRs);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .spilledvgprs %d\n", spilledVGPRs);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
 }
 
-void CLRX::disassembleGallium(std::ostream& output,
+void CLRX::disassembleGallium(DisasmOutput& output,
           const GalliumDisasmInput* galliumInput, ISADisassembler* isaDisassembler,
           Flags flags)
 {
@@ -212,26 +208,26 @@ void CLRX::disassembleGallium(std::ostream& output,
     const bool doDumpConfig = ((flags & DISASM_CONFIG) != 0);
     
     if (galliumInput->is64BitMode)
-        output.write(".64bit\n", 7);
+        output.write(7, ".64bit\n");
     else
-        output.write(".32bit\n", 7);
+        output.write(7, ".32bit\n");
     
     if (doDumpData && galliumInput->globalData != nullptr &&
         galliumInput->globalDataSize != 0)
     {   //
-        output.write(".rodata\n", 8);
+        output.write(8, ".rodata\n");
         printDisasmData(galliumInput->globalDataSize, galliumInput->globalData, output);
     }
     if (galliumInput->isMesa170)
-        output.write(".driver_version 170000\n", 23);
+        output.write(23, ".driver_version 170000\n");
     // print correct llvm version
     if (galliumInput->isAMDHSA)
-        output.write(".llvm_version 40000\n", 20);
+        output.write(20, ".llvm_version 40000\n");
     else if (galliumInput->isLLVM390)
-        output.write(".llvm_version 30900\n", 20);
+        output.write(20, ".llvm_version 30900\n");
     
     if (!galliumInput->scratchRelocs.empty())
-        output.write(".scratchsym .scratchaddr\n", 25);
+        output.write(25, ".scratchsym .scratchaddr\n");
     
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(galliumInput->deviceType);
     const cxuint maxSgprsNum = getGPUMaxRegistersNum(arch, REGTYPE_SGPR, 0);
@@ -240,14 +236,14 @@ void CLRX::disassembleGallium(std::ostream& output,
     {
         const GalliumDisasmKernelInput& kinput = galliumInput->kernels[i];
         {
-            output.write(".kernel ", 8);
-            output.write(kinput.kernelName.c_str(), kinput.kernelName.size());
+            output.write(8, ".kernel ");
+            output.write(kinput.kernelName.size(), kinput.kernelName.c_str());
             output.put('\n');
         }
         if (doMetadata)
         {
             char lineBuf[128];
-            output.write("    .args\n", 10);
+            output.write(10, "    .args\n");
             for (const GalliumArgInfo& arg: kinput.argInfos)
             {
                 // print kernel argument
@@ -293,26 +289,26 @@ void CLRX::disassembleGallium(std::ostream& output,
                 else
                     pos += itocstrCStyle<cxuint>(cxuint(arg.semantic), lineBuf+pos, 16);
                 lineBuf[pos++] = '\n';
-                output.write(lineBuf, pos);
+                output.write(pos, lineBuf);
             }
             if (!doDumpConfig)
             {
                 /// proginfo (if no config)
                 const cxuint progInfoEntriesNum = galliumInput->isLLVM390 ? 5 : 3;
-                output.write("    .proginfo\n", 14);
+                output.write(14, "    .proginfo\n");
                 for (cxuint k = 0; k < progInfoEntriesNum; k++)
                 {
                     // print prog info entries: .entry address, value
                     const GalliumProgInfoEntry& piEntry = kinput.progInfo[k];
-                    output.write("        .entry ", 15);
+                    output.write(15, "        .entry ");
                     char buf[32];
                     size_t numSize = itocstrCStyle<uint32_t>(piEntry.address,
                                  buf, 32, 16, 8);
-                    output.write(buf, numSize);
-                    output.write(", ", 2);
+                    output.write(numSize, buf);
+                    output.write(2, ", ");
                     numSize = itocstrCStyle<uint32_t>(piEntry.value, buf, 32, 16, 8);
-                    output.write(buf, numSize);
-                    output.write("\n", 1);
+                    output.write(numSize, buf);
+                    output.write(1, "\n");
                 }
             }
             else
@@ -344,7 +340,7 @@ void CLRX::disassembleGallium(std::ostream& output,
         if (!galliumInput->isAMDHSA)
         {
             // just disassembly code in simple way
-            output.write(".text\n", 6);
+            output.write(6, ".text\n");
             isaDisassembler->setInput(galliumInput->codeSize, galliumInput->code);
             isaDisassembler->beforeDisassemble();
             isaDisassembler->disassemble();
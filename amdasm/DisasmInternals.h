@@ -25,6 +25,7 @@
 #include <string>
 #include <ostream>
 #include <utility>
+#include <functional>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdbin/AmdBinaries.h>
 #include <CLRX/amdbin/AmdCL2Binaries.h>
@@ -37,44 +38,61 @@ namespace CLRX
 
 // print data in bytes in assembler format (secondAlign add extra align)
 extern CLRX_INTERNAL void printDisasmData(size_t size, const cxbyte* data,
-              std::ostream& output, bool secondAlign = false);
+              DisasmOutput& output, bool secondAlign = false);
 
 // print data in 32-bit words in assembler format (secondAlign add extra align)
 extern CLRX_INTERNAL void printDisasmDataU32(size_t size, const uint32_t* data,
-             std::ostream& output, bool secondAlign = false);
+             DisasmOutput& output, bool secondAlign = false);
 
 // print data in string form in assembler format
 extern CLRX_INTERNAL void printDisasmLongString(size_t size, const char* data,
-            std::ostream& output, bool secondAlign = false);
+            DisasmOutput& output, bool secondAlign = false);
+
+// function that disassembles single kernel (output, isaDisassembler, kernelIndex)
+typedef std::function<void(DisasmOutput&, ISADisassembler*, size_t)> DisasmKernelFunc;
+
+// disassemble kernels (in parallel if threadsNum!=1) and write outputs in kernel order
+// hasKernelCode returns true if kernel code will be disassembled (new section)
+extern CLRX_INTERNAL void disassembleKernels(DisasmOutput& output, size_t kernelsNum,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, cxuint threadsNum,
+        const std::function<bool(size_t)>& hasKernelCode,
+        const DisasmKernelFunc& disasmKernel);
+
+// get AMD OpenCL 1.0 kernel configuration from metadata, CAL notes and kernel header
+// metadataView - tokenized metadata (if null, metadata will be tokenized)
+extern CLRX_INTERNAL AmdKernelConfig getAmdKernelConfig(size_t metadataSize,
+        const char* metadata, const AmdKernelMetadataView* metadataView,
+        const std::vector<CALNoteInput>& calNotes, const CString& driverInfo,
+        const cxbyte* kernelHeader);
 
 // disassemble Amd OpenCL 1.0 binary input
-extern CLRX_INTERNAL void disassembleAmd(std::ostream& output,
+extern CLRX_INTERNAL void disassembleAmd(DisasmOutput& output,
        const AmdDisasmInput* amdInput, ISADisassembler* isaDisassembler,
-       size_t& sectionCount, Flags flags);
+       size_t& sectionCount, Flags flags, cxuint threadsNum = 1);
 
 // disassemble Amd OpenCL 2.0 binary input
-extern CLRX_INTERNAL void disassembleAmdCL2(std::ostream& output,
+extern CLRX_INTERNAL void disassembleAmdCL2(DisasmOutput& output,
         const AmdCL2DisasmInput* amdCL2Input, ISADisassembler* isaDisassembler,
-        size_t& sectionCount, Flags flags);
+        size_t& sectionCount, Flags flags, cxuint threadsNum = 1);
 
 // disassemble ROCm binary input
-extern CLRX_INTERNAL void disassembleROCm(std::ostream& output,
+extern CLRX_INTERNAL void disassembleROCm(DisasmOutput& output,
        const ROCmDisasmInput* rocmInput, ISADisassembler* isaDisassembler,
        Flags flags);
 
 // dump AMDHSA configuration in assembler format
 // amdshaPrefix - add extra prefix for gallium HSA config params
-extern CLRX_INTERNAL void dumpAMDHSAConfig(std::ostream& output, cxuint maxSgprsNum,
+extern CLRX_INTERNAL void dumpAMDHSAConfig(DisasmOutput& output, cxuint maxSgprsNum,
              GPUArchitecture arch, const ROCmKernelConfig& config,
              bool amdhsaPrefix = false);
 // disassemble code in AMDHSA layout (kernel config and kernel codes)
-extern CLRX_INTERNAL void disassembleAMDHSACode(std::ostream& output,
+extern CLRX_INTERNAL void disassembleAMDHSACode(DisasmOutput& output,
             const std::vector<ROCmDisasmRegionInput>& regions,
             size_t codeSize, const cxbyte* code, ISADisassembler* isaDisassembler,
             Flags flags);
 
 // disassemble Gallium binary input
-extern CLRX_INTERNAL void disassembleGallium(std::ostream& output,
+extern CLRX_INTERNAL void disassembleGallium(DisasmOutput& output,
        const GalliumDisasmInput* galliumInput, ISADisassembler* isaDisassembler,
        Flags flags);
 
@@ -83,7 +101,7 @@ extern CLRX_INTERNAL const std::pair<const char*, KernelArgType> disasmArgTypeNa
 extern CLRX_INTERNAL const KernelArgType disasmGpuArgTypeTable[];
 
 // dump kernel arguments for  kernel in AMD binaries (cl20 - OpenCL 2.0 binaries)
-extern CLRX_INTERNAL void dumpAmdKernelArg(std::ostream& output,
+extern CLRX_INTERNAL void dumpAmdKernelArg(DisasmOutput& output,
            const AmdKernelArgInput& arg, bool cl20);
 
 };
@@ -0,0 +1,735 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <ostream>
+#include <vector>
+#include <utility>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/GCNEncoding.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/ROCmBinaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include "DisasmInternals.h"
+
+using namespace CLRX;
+
+/* JSON Lines output: every record is single JSON object in single line */
+
+// writer of JSON Lines records
+class CLRX_INTERNAL JSONLinesWriter
+{
+private:
+    DisasmOutput& output;
+    std::string line;
+    bool needComma;
+
+    void putSeparator()
+    {
+        if (needComma)
+            line.push_back(',');
+        needComma = false;
+    }
+public:
+    explicit JSONLinesWriter(DisasmOutput& _output) : output(_output), needComma(false)
+    { line.reserve(512); }
+
+    // begin record with type field
+    void beginRecord(const char* type)
+    {
+        line.clear();
+        line.push_back('{');
+        needComma = false;
+        fieldString("type", type);
+    }
+    // finish record and write it to output
+    void endRecord()
+    {
+        line.append("}\n", 2);
+        output.write(line.size(), line.data());
+        needComma = false;
+    }
+
+    void key(const char* name)
+    {
+        putSeparator();
+        line.push_back('"');
+        line.append(name);
+        line.append("\":", 2);
+    }
+    void beginObject()
+    {
+        putSeparator();
+        line.push_back('{');
+    }
+    void endObject()
+    {
+        line.push_back('}');
+        needComma = true;
+    }
+    void beginArray()
+    {
+        putSeparator();
+        line.push_back('[');
+    }
+    void endArray()
+    {
+        line.push_back(']');
+        needComma = true;
+    }
+
+    void valueString(size_t length, const char* str);
+    void valueString(const char* str)
+    { valueString(::strlen(str), str); }
+    void valueUInt(uint64_t value)
+    {
+        putSeparator();
+        char buf[24];
+        line.append(buf, itocstrCStyle<uint64_t>(value, buf, 24));
+        needComma = true;
+    }
+    void valueBool(bool value)
+    {
+        putSeparator();
+        if (value)
+            line.append("true", 4);
+        else
+            line.append("false", 5);
+        needComma = true;
+    }
+    void valueNull()
+    {
+        putSeparator();
+        line.append("null", 4);
+        needComma = true;
+    }
+
+    void fieldString(const char* name, const char* str)
+    { key(name); valueString(str); }
+    void fieldString(const char* name, const CString& str)
+    { key(name); valueString(str.size(), str.c_str()); }
+    void fieldUInt(const char* name, uint64_t value)
+    { key(name); valueUInt(value); }
+    void fieldBool(const char* name, bool value)
+    { key(name); valueBool(value); }
+    void fieldUIntArray(const char* name, size_t num, const uint32_t* values)
+    {
+        key(name);
+        beginArray();
+        for (size_t i = 0; i < num; i++)
+            valueUInt(values[i]);
+        endArray();
+    }
+};
+
+void JSONLinesWriter::valueString(size_t length, const char* str)
+{
+    putSeparator();
+    line.push_back('"');
+    for (size_t i = 0; i < length; i++)
+    {
+        const unsigned char c = str[i];
+        if (c == '"' || c == '\\')
+        {
+            line.push_back('\\');
+            line.push_back(c);
+        }
+        else if (c < 0x20)
+        {
+            // control characters
+            const char* hexDigits = "0123456789abcdef";
+            line.append("\\u00", 4);
+            line.push_back(hexDigits[c>>4]);
+            line.push_back(hexDigits[c&15]);
+        }
+        else
+            line.push_back(c);
+    }
+    line.push_back('"');
+    needComma = true;
+}
+
+static const char* gcnEncodingJSONNames[GCNENC_MAXVAL+1] =
+{
+    "NONE", "SOPC", "SOPP", "SOP1", "SOP2", "SOPK", "SMRD", "VOPC", "VOP1", "VOP2",
+    "VOP3A", "VOP3B", "VINTRP", "DS", "MUBUF", "MTBUF", "MIMG", "EXP", "FLAT"
+};
+
+// names of GCNDMOD_* modifiers (by bit position)
+static const char* gcnModifierJSONNames[21] =
+{
+    "clamp", "glc", "slc", "tfe", "lds", "offen", "idxen", "addr64", "gds", "unorm",
+    "da", "r128", "lwe", "d16", "done", "compr", "vm", "nv", "high", "bound_ctrl",
+    "imm_offset"
+};
+
+static const size_t noKernelIndex = SIZE_MAX;
+
+// write instruction records for code (offsets of records are codeOffset + position)
+static void writeJSONInstrs(JSONLinesWriter& jw, const GCNDecoder& decoder,
+            size_t sectionIndex, size_t kernelIndex, size_t codeOffset,
+            size_t codeSize, const cxbyte* code)
+{
+    const bool isGCN12 = (decoder.getArchitecture() >= GPUArchitecture::GCN1_2);
+    GCNDecodedInstr instr;
+    char buf[32];
+    for (size_t pos = 0; pos+4 <= codeSize;)
+    {
+        const size_t nextPos = decoder.decode(codeSize, code, pos, instr);
+        jw.beginRecord("insn");
+        jw.fieldUInt("section", sectionIndex);
+        if (kernelIndex != noKernelIndex)
+            jw.fieldUInt("kernel", kernelIndex);
+        jw.fieldUInt("offset", codeOffset + pos);
+        jw.fieldUInt("size", std::min(nextPos, codeSize) - pos);
+        jw.key("encoding");
+        if (instr.encoding == GCNENC_SMRD && isGCN12)
+            jw.valueString("SMEM");
+        else
+            jw.valueString(instr.encoding <= GCNENC_MAXVAL ?
+                        gcnEncodingJSONNames[instr.encoding] : "NONE");
+        jw.key("mnemonic");
+        const char* mnemonic = (instr.mnemonicId != GCNDecodedIllegal) ?
+                GCNDecoder::getMnemonic(instr.mnemonicId) : nullptr;
+        if (mnemonic != nullptr)
+            jw.valueString(mnemonic);
+        else
+            jw.valueNull();
+        jw.fieldUInt("opcode", instr.opcode);
+
+        jw.key("operands");
+        jw.beginArray();
+        for (cxuint i = 0; i < instr.operandsNum; i++)
+        {
+            const cxbyte opFlags = instr.operands[i].flags;
+            jw.beginObject();
+            jw.key("op");
+            jw.valueString(decoder.printOperand(instr, i, buf), buf);
+            jw.key("access");
+            if ((opFlags & (GCNDOP_DST|GCNDOP_SRC)) == (GCNDOP_DST|GCNDOP_SRC))
+                jw.valueString("rw");
+            else
+                jw.valueString((opFlags & GCNDOP_DST) != 0 ? "w" : "r");
+            if ((opFlags & GCNDOP_NEG) != 0)
+                jw.fieldBool("neg", true);
+            if ((opFlags & GCNDOP_ABS) != 0)
+                jw.fieldBool("abs", true);
+            if ((opFlags & GCNDOP_SEXT) != 0)
+                jw.fieldBool("sext", true);
+            if ((opFlags & GCNDOP_NEG_HI) != 0)
+                jw.fieldBool("neg_hi", true);
+            jw.endObject();
+        }
+        jw.endArray();
+
+        // optional fields (only if nonzero)
+        if (instr.extra == GCNDEXTRA_LITERAL)
+            jw.fieldUInt("literal", instr.literal);
+        if (instr.imm != 0)
+            jw.fieldUInt("imm", instr.imm);
+        if (instr.modifiers != 0)
+        {
+            jw.key("modifiers");
+            jw.beginArray();
+            for (cxuint b = 0; b < 21; b++)
+                if ((instr.modifiers & (1U<<b)) != 0)
+                    jw.valueString(gcnModifierJSONNames[b]);
+            jw.endArray();
+        }
+        if (instr.omod != 0)
+            jw.fieldUInt("omod", instr.omod);
+        if (instr.opsel != 0)
+            jw.fieldUInt("opsel", instr.opsel);
+        if (instr.mask != 0)
+            jw.fieldUInt("mask", instr.mask);
+        if (instr.format != 0)
+            jw.fieldUInt("format", instr.format);
+        if (instr.extra == GCNDEXTRA_DPP)
+        {
+            jw.key("dpp");
+            jw.beginObject();
+            jw.fieldUInt("ctrl", instr.dpp.dppCtrl);
+            jw.fieldUInt("row_mask", instr.dpp.rowMask);
+            jw.fieldUInt("bank_mask", instr.dpp.bankMask);
+            jw.endObject();
+        }
+        else if (instr.extra == GCNDEXTRA_SDWA)
+        {
+            jw.key("sdwa");
+            jw.beginObject();
+            jw.fieldUInt("dst_sel", instr.sdwa.dstSel);
+            jw.fieldUInt("dst_unused", instr.sdwa.dstUnused);
+            jw.fieldUInt("src0_sel", instr.sdwa.src0Sel);
+            jw.fieldUInt("src1_sel", instr.sdwa.src1Sel);
+            jw.endObject();
+        }
+        jw.endRecord();
+        pos = nextPos;
+    }
+}
+
+// write section record
+static void writeJSONSection(JSONLinesWriter& jw, size_t sectionIndex, const char* name,
+            size_t size, size_t kernelIndex = noKernelIndex)
+{
+    jw.beginRecord("section");
+    jw.fieldUInt("index", sectionIndex);
+    jw.fieldString("name", name);
+    jw.fieldUInt("size", size);
+    if (kernelIndex != noKernelIndex)
+        jw.fieldUInt("kernel", kernelIndex);
+    jw.endRecord();
+}
+
+// write data section record if data is present
+static void writeJSONDataSection(JSONLinesWriter& jw, size_t& sectionIndex,
+            const char* name, size_t size, const void* data)
+{
+    if (data != nullptr && size != 0)
+        writeJSONSection(jw, sectionIndex++, name, size);
+}
+
+// write AMD HSA kernel configuration (as config field)
+static void writeJSONHSAConfig(JSONLinesWriter& jw, const AmdHsaKernelConfig& config)
+{
+    jw.key("config");
+    jw.beginObject();
+    jw.key("codeVersion");
+    jw.beginArray();
+    jw.valueUInt(ULEV(config.amdCodeVersionMajor));
+    jw.valueUInt(ULEV(config.amdCodeVersionMinor));
+    jw.endArray();
+    jw.key("machine");
+    jw.beginArray();
+    jw.valueUInt(ULEV(config.amdMachineKind));
+    jw.valueUInt(ULEV(config.amdMachineMajor));
+    jw.valueUInt(ULEV(config.amdMachineMinor));
+    jw.valueUInt(ULEV(config.amdMachineStepping));
+    jw.endArray();
+    jw.fieldUInt("kernelCodeEntryOffset", ULEV(config.kernelCodeEntryOffset));
+    jw.fieldUInt("kernelCodePrefetchOffset", ULEV(config.kernelCodePrefetchOffset));
+    jw.fieldUInt("kernelCodePrefetchSize", ULEV(config.kernelCodePrefetchSize));
+    jw.fieldUInt("maxScratchBackingMemorySize",
+                 ULEV(config.maxScrachBackingMemorySize));
+    jw.fieldUInt("pgmRsrc1", ULEV(config.computePgmRsrc1));
+    jw.fieldUInt("pgmRsrc2", ULEV(config.computePgmRsrc2));
+    jw.fieldUInt("enableSgprRegisterFlags", ULEV(config.enableSgprRegisterFlags));
+    jw.fieldUInt("enableFeatureFlags", ULEV(config.enableFeatureFlags));
+    jw.fieldUInt("workitemPrivateSegmentSize",
+                 ULEV(config.workitemPrivateSegmentSize));
+    jw.fieldUInt("workgroupGroupSegmentSize", ULEV(config.workgroupGroupSegmentSize));
+    jw.fieldUInt("gdsSegmentSize", ULEV(config.gdsSegmentSize));
+    jw.fieldUInt("kernargSegmentSize", ULEV(config.kernargSegmentSize));
+    jw.fieldUInt("workgroupFbarrierCount", ULEV(config.workgroupFbarrierCount));
+    jw.fieldUInt("wavefrontSgprCount", ULEV(config.wavefrontSgprCount));
+    jw.fieldUInt("workitemVgprCount", ULEV(config.workitemVgprCount));
+    jw.fieldUInt("reservedVgprFirst", ULEV(config.reservedVgprFirst));
+    jw.fieldUInt("reservedVgprCount", ULEV(config.reservedVgprCount));
+    jw.fieldUInt("reservedSgprFirst", ULEV(config.reservedSgprFirst));
+    jw.fieldUInt("reservedSgprCount", ULEV(config.reservedSgprCount));
+    jw.fieldUInt("debugWavefrontPrivateSegmentOffsetSgpr",
+                 ULEV(config.debugWavefrontPrivateSegmentOffsetSgpr));
+    jw.fieldUInt("debugPrivateSegmentBufferSgpr",
+                 ULEV(config.debugPrivateSegmentBufferSgpr));
+    jw.fieldUInt("kernargSegmentAlignment", config.kernargSegmentAlignment);
+    jw.fieldUInt("groupSegmentAlignment", config.groupSegmentAlignment);
+    jw.fieldUInt("privateSegmentAlignment", config.privateSegmentAlignment);
+    jw.fieldUInt("wavefrontSize", config.wavefrontSize);
+    jw.fieldUInt("callConvention", ULEV(config.callConvention));
+    jw.fieldUInt("runtimeLoaderKernelSymbol", ULEV(config.runtimeLoaderKernelSymbol));
+    jw.endObject();
+}
+
+// write AMD OpenCL 1.2 kernel configuration (as config field)
+static void writeJSONAmdConfig(JSONLinesWriter& jw, const AmdKernelConfig& config)
+{
+    jw.key("config");
+    jw.beginObject();
+    jw.fieldUInt("dimMask", config.dimMask);
+    jw.fieldUIntArray("reqdWorkGroupSize", 3, config.reqdWorkGroupSize);
+    jw.fieldUInt("usedVGPRsNum", config.usedVGPRsNum);
+    jw.fieldUInt("usedSGPRsNum", config.usedSGPRsNum);
+    jw.fieldUInt("pgmRsrc2", config.pgmRSRC2);
+    jw.fieldUInt("floatMode", config.floatMode);
+    jw.fieldBool("ieeeMode", config.ieeeMode);
+    jw.fieldUInt("hwLocalSize", config.hwLocalSize);
+    jw.fieldUInt("hwRegion", config.hwRegion);
+    jw.fieldUInt("scratchBufferSize", config.scratchBufferSize);
+    jw.fieldUInt("uavPrivate", config.uavPrivate);
+    jw.fieldUInt("uavId", config.uavId);
+    jw.fieldUInt("constBufferId", config.constBufferId);
+    jw.fieldUInt("printfId", config.printfId);
+    jw.fieldUInt("privateId", config.privateId);
+    jw.fieldUInt("earlyExit", config.earlyExit);
+    jw.fieldUInt("condOut", config.condOut);
+    jw.fieldUInt("exceptions", config.exceptions);
+    jw.fieldBool("tgSize", config.tgSize);
+    jw.fieldBool("usePrintf", config.usePrintf);
+    jw.fieldBool("useConstantData", config.useConstantData);
+    jw.key("args");
+    jw.beginArray();
+    for (const AmdKernelArgInput& arg: config.args)
+    {
+        jw.beginObject();
+        jw.fieldString("name", arg.argName);
+        jw.fieldString("typeName", arg.typeName);
+        jw.endObject();
+    }
+    jw.endArray();
+    jw.endObject();
+}
+
+// helper for checking wether value is supplied
+static inline bool hasValue(cxuint value)
+{ return value!=BINGEN_NOTSUPPLIED && value!=BINGEN_DEFAULT; }
+
+static inline bool hasValue(uint64_t value)
+{ return value!=BINGEN64_NOTSUPPLIED && value!=BINGEN64_DEFAULT; }
+
+// write ROCm kernel metadata (as metadata field), only supplied values
+static void writeJSONROCmMetadata(JSONLinesWriter& jw, const ROCmKernelMetadata& kernel)
+{
+    jw.key("metadata");
+    jw.beginObject();
+    jw.fieldString("symbolName", kernel.symbolName);
+    jw.fieldString("language", kernel.language);
+    if (kernel.langVersion[0] != BINGEN_NOTSUPPLIED)
+        jw.fieldUIntArray("langVersion", 2, kernel.langVersion);
+    jw.fieldUIntArray("reqdWorkGroupSize", 3, kernel.reqdWorkGroupSize);
+    jw.fieldUIntArray("workGroupSizeHint", 3, kernel.workGroupSizeHint);
+    if (!kernel.vecTypeHint.empty())
+        jw.fieldString("vecTypeHint", kernel.vecTypeHint);
+    if (!kernel.runtimeHandle.empty())
+        jw.fieldString("runtimeHandle", kernel.runtimeHandle);
+    if (hasValue(kernel.kernargSegmentSize))
+        jw.fieldUInt("kernargSegmentSize", kernel.kernargSegmentSize);
+    if (hasValue(kernel.kernargSegmentAlign))
+        jw.fieldUInt("kernargSegmentAlign", kernel.kernargSegmentAlign);
+    if (hasValue(kernel.groupSegmentFixedSize))
+        jw.fieldUInt("groupSegmentFixedSize", kernel.groupSegmentFixedSize);
+    if (hasValue(kernel.privateSegmentFixedSize))
+        jw.fieldUInt("privateSegmentFixedSize", kernel.privateSegmentFixedSize);
+    if (hasValue(kernel.wavefrontSize))
+        jw.fieldUInt("wavefrontSize", kernel.wavefrontSize);
+    if (hasValue(kernel.sgprsNum))
+        jw.fieldUInt("sgprsNum", kernel.sgprsNum);
+    if (hasValue(kernel.vgprsNum))
+        jw.fieldUInt("vgprsNum", kernel.vgprsNum);
+    if (hasValue(kernel.spilledSgprs))
+        jw.fieldUInt("spilledSgprs", kernel.spilledSgprs);
+    if (hasValue(kernel.spilledVgprs))
+        jw.fieldUInt("spilledVgprs", kernel.spilledVgprs);
+    if (hasValue(kernel.maxFlatWorkGroupSize))
+        jw.fieldUInt("maxFlatWorkGroupSize", kernel.maxFlatWorkGroupSize);
+    if (kernel.fixedWorkGroupSize[0] != 0 || kernel.fixedWorkGroupSize[1] != 0 ||
+        kernel.fixedWorkGroupSize[2] != 0)
+        jw.fieldUIntArray("fixedWorkGroupSize", 3, kernel.fixedWorkGroupSize);
+    jw.key("args");
+    jw.beginArray();
+    for (const ROCmKernelArgInfo& arg: kernel.argInfos)
+    {
+        jw.beginObject();
+        jw.fieldString("name", arg.name);
+        jw.fieldString("typeName", arg.typeName);
+        jw.fieldUInt("size", arg.size);
+        jw.fieldUInt("align", arg.align);
+        jw.endObject();
+    }
+    jw.endArray();
+    jw.endObject();
+}
+
+// code region of kernel in single code section (ROCm, Gallium)
+struct CLRX_INTERNAL JSONKernelRegion
+{
+    size_t kernelIndex;
+    size_t offset;  // offset of kernel code (after HSA config)
+    size_t size;    // size of kernel code
+};
+
+// write instruction records of kernel regions (in order of offsets)
+static void writeJSONKernelRegions(JSONLinesWriter& jw, const GCNDecoder& decoder,
+            size_t sectionIndex, std::vector<JSONKernelRegion>& regions,
+            size_t codeSize, const cxbyte* code)
+{
+    std::sort(regions.begin(), regions.end(),
+              [](const JSONKernelRegion& a, const JSONKernelRegion& b)
+              { return a.offset < b.offset; });
+    for (const JSONKernelRegion& region: regions)
+        if (region.offset < codeSize)
+            writeJSONInstrs(jw, decoder, sectionIndex, region.kernelIndex, region.offset,
+                    std::min(region.size, codeSize-region.offset), code + region.offset);
+}
+
+static void disassembleAmdJSON(JSONLinesWriter& jw, const GCNDecoder& decoder,
+            const AmdDisasmInput* amdInput, Flags flags)
+{
+    size_t sectionIndex = 0;
+    writeJSONDataSection(jw, sectionIndex, ".globaldata", amdInput->globalDataSize,
+                amdInput->globalData);
+    for (size_t i = 0; i < amdInput->kernels.size(); i++)
+    {
+        const AmdDisasmKernelInput& kinput = amdInput->kernels[i];
+        jw.beginRecord("kernel");
+        jw.fieldUInt("index", i);
+        jw.fieldString("name", kinput.kernelName);
+        jw.fieldUInt("codeSize", kinput.codeSize);
+        writeJSONAmdConfig(jw, getAmdKernelConfig(kinput.metadataSize, kinput.metadata,
+                kinput.metadataView, kinput.calNotes, amdInput->driverInfo,
+                kinput.header));
+        jw.endRecord();
+        if (kinput.code == nullptr || kinput.codeSize == 0)
+            continue;
+        writeJSONSection(jw, sectionIndex, ".text", kinput.codeSize, i);
+        if ((flags & DISASM_DUMPCODE) != 0)
+            writeJSONInstrs(jw, decoder, sectionIndex, i, 0, kinput.codeSize, kinput.code);
+        sectionIndex++;
+    }
+}
+
+static void disassembleAmdCL2JSON(JSONLinesWriter& jw, const GCNDecoder& decoder,
+            const AmdCL2DisasmInput* amdCL2Input, Flags flags)
+{
+    size_t sectionIndex = 0;
+    writeJSONDataSection(jw, sectionIndex, ".globaldata", amdCL2Input->globalDataSize,
+                amdCL2Input->globalData);
+    writeJSONDataSection(jw, sectionIndex, ".rwdata", amdCL2Input->rwDataSize,
+                amdCL2Input->rwData);
+    if (amdCL2Input->bssSize != 0)
+        writeJSONSection(jw, sectionIndex++, ".bssdata", amdCL2Input->bssSize);
+    writeJSONDataSection(jw, sectionIndex, ".samplerinit", amdCL2Input->samplerInitSize,
+                amdCL2Input->samplerInit);
+    for (size_t i = 0; i < amdCL2Input->kernels.size(); i++)
+    {
+        const AmdCL2DisasmKernelInput& kinput = amdCL2Input->kernels[i];
+        jw.beginRecord("kernel");
+        jw.fieldUInt("index", i);
+        jw.fieldString("name", kinput.kernelName);
+        jw.fieldUInt("codeSize", kinput.codeSize);
+        if (kinput.setup != nullptr && kinput.setupSize >= sizeof(AmdHsaKernelConfig))
+            writeJSONHSAConfig(jw, *reinterpret_cast<const AmdHsaKernelConfig*>(
+                        kinput.setup));
+        jw.endRecord();
+        if (kinput.code == nullptr || kinput.codeSize == 0)
+            continue;
+        writeJSONSection(jw, sectionIndex, ".text", kinput.codeSize, i);
+        if ((flags & DISASM_DUMPCODE) != 0)
+            writeJSONInstrs(jw, decoder, sectionIndex, i, 0, kinput.codeSize, kinput.code);
+        sectionIndex++;
+    }
+}
+
+static void disassembleROCmJSON(JSONLinesWriter& jw, const GCNDecoder& decoder,
+            const ROCmDisasmInput* rocmInput, Flags flags)
+{
+    ROCmMetadata metadataInfo;
+    std::vector<std::pair<CString, size_t> > sortedMdKernelIndices;
+    if (rocmInput->metadata != nullptr && rocmInput->metadataSize != 0)
+    {
+        metadataInfo.parse(rocmInput->metadataSize, rocmInput->metadata);
+        // prepare order of rocm metadata kernels
+        sortedMdKernelIndices.resize(metadataInfo.kernels.size());
+        for (size_t i = 0; i < sortedMdKernelIndices.size(); i++)
+            sortedMdKernelIndices[i] = std::make_pair(metadataInfo.kernels[i].name, i);
+        mapSort(sortedMdKernelIndices.begin(), sortedMdKernelIndices.end());
+    }
+
+    size_t sectionIndex = 0;
+    writeJSONDataSection(jw, sectionIndex, ".globaldata", rocmInput->globalDataSize,
+                rocmInput->globalData);
+
+    std::vector<JSONKernelRegion> regions;
+    size_t kernelIndex = 0;
+    for (const ROCmDisasmRegionInput& rinput: rocmInput->regions)
+    {
+        if (rinput.type == ROCmRegionType::DATA)
+            continue;
+        jw.beginRecord("kernel");
+        jw.fieldUInt("index", kernelIndex);
+        jw.fieldString("name", rinput.regionName);
+        if (rinput.type == ROCmRegionType::FKERNEL)
+            jw.fieldBool("function", true);
+        jw.fieldUInt("offset", rinput.offset);
+        jw.fieldUInt("size", rinput.size);
+        if (rinput.offset+256 <= rocmInput->codeSize)
+        {
+            writeJSONHSAConfig(jw, *reinterpret_cast<const ROCmKernelConfig*>(
+                        rocmInput->code + rinput.offset));
+            if (rinput.size >= 256)
+                regions.push_back({ kernelIndex, rinput.offset+256, rinput.size-256 });
+        }
+        auto it = binaryMapFind(sortedMdKernelIndices.begin(),
+                    sortedMdKernelIndices.end(), rinput.regionName);
+        if (it != sortedMdKernelIndices.end())
+            writeJSONROCmMetadata(jw, metadataInfo.kernels[it->second]);
+        jw.endRecord();
+        kernelIndex++;
+    }
+
+    if (rocmInput->code == nullptr || rocmInput->codeSize == 0)
+        return;
+    writeJSONSection(jw, sectionIndex, ".text", rocmInput->codeSize);
+    if ((flags & DISASM_DUMPCODE) != 0)
+        writeJSONKernelRegions(jw, decoder, sectionIndex, regions,
+                    rocmInput->codeSize, rocmInput->code);
+}
+
+static void disassembleGalliumJSON(JSONLinesWriter& jw, const GCNDecoder& decoder,
+            const GalliumDisasmInput* galliumInput, Flags flags)
+{
+    size_t sectionIndex = 0;
+    writeJSONDataSection(jw, sectionIndex, ".rodata", galliumInput->globalDataSize,
+                galliumInput->globalData);
+
+    const size_t kernelsNum = galliumInput->kernels.size();
+    std::vector<JSONKernelRegion> regions(kernelsNum);
+    for (size_t i = 0; i < kernelsNum; i++)
+        regions[i] = { i, galliumInput->kernels[i].offset, 0 };
+    std::sort(regions.begin(), regions.end(),
+              [](const JSONKernelRegion& a, const JSONKernelRegion& b)
+              { return a.offset < b.offset; });
+    // kernel code ends at next kernel
+    for (size_t i = 0; i < kernelsNum; i++)
+    {
+        const size_t end = (i+1 < kernelsNum) ? regions[i+1].offset :
+                galliumInput->codeSize;
+        regions[i].size = std::max(end, regions[i].offset) - regions[i].offset;
+    }
+    std::sort(regions.begin(), regions.end(),
+              [](const JSONKernelRegion& a, const JSONKernelRegion& b)
+              { return a.kernelIndex < b.kernelIndex; });
+
+    const cxuint progInfoEntriesNum = galliumInput->isLLVM390 ? 5 : 3;
+    for (size_t i = 0; i < kernelsNum; i++)
+    {
+        const GalliumDisasmKernelInput& kinput = galliumInput->kernels[i];
+        JSONKernelRegion& region = regions[i];
+        jw.beginRecord("kernel");
+        jw.fieldUInt("index", i);
+        jw.fieldString("name", kinput.kernelName);
+        jw.fieldUInt("offset", region.offset);
+        jw.fieldUInt("size", region.size);
+        jw.key("progInfo");
+        jw.beginArray();
+        for (cxuint k = 0; k < progInfoEntriesNum; k++)
+        {
+            jw.beginObject();
+            jw.fieldUInt("address", kinput.progInfo[k].address);
+            jw.fieldUInt("value", kinput.progInfo[k].value);
+            jw.endObject();
+        }
+        jw.endArray();
+        if (galliumInput->isAMDHSA && region.size >= 256)
+        {
+            // kernel code begins after HSA config
+            writeJSONHSAConfig(jw, *reinterpret_cast<const ROCmKernelConfig*>(
+                        galliumInput->code + region.offset));
+            region.offset += 256;
+            region.size -= 256;
+        }
+        jw.endRecord();
+    }
+
+    if (galliumInput->code == nullptr || galliumInput->codeSize == 0)
+        return;
+    writeJSONSection(jw, sectionIndex, ".text", galliumInput->codeSize);
+    if ((flags & DISASM_DUMPCODE) != 0)
+        writeJSONKernelRegions(jw, decoder, sectionIndex, regions,
+                    galliumInput->codeSize, galliumInput->code);
+}
+
+static const char* binaryFormatJSONNames[5] =
+{ "amd", "gallium", "rawcode", "amdcl2", "rocm" };
+
+void Disassembler::disassembleJSON()
+{
+    JSONLinesWriter jw(output);
+    const GPUDeviceType deviceType = getDeviceType();
+    const GCNDecoder decoder(getGPUArchitectureFromDeviceType(deviceType));
+
+    jw.beginRecord("binary");
+    jw.fieldString("format", binaryFormatJSONNames[cxuint(binaryFormat)]);
+    jw.fieldString("gpu", getGPUDeviceTypeName(deviceType));
+    jw.fieldString("arch", getGPUArchitectureName(decoder.getArchitecture()));
+    switch(binaryFormat)
+    {
+        case BinaryFormat::AMD:
+            jw.fieldBool("64bit", amdInput->is64BitMode);
+            jw.fieldString("driverInfo", amdInput->driverInfo);
+            jw.fieldString("compileOptions", amdInput->compileOptions);
+            break;
+        case BinaryFormat::AMDCL2:
+            jw.fieldBool("64bit", amdCL2Input->is64BitMode);
+            jw.fieldUInt("archMinor", amdCL2Input->archMinor);
+            jw.fieldUInt("archStepping", amdCL2Input->archStepping);
+            jw.fieldUInt("driverVersion", amdCL2Input->driverVersion);
+            jw.fieldString("compileOptions", amdCL2Input->compileOptions);
+            jw.fieldString("aclVersion", amdCL2Input->aclVersionString);
+            break;
+        case BinaryFormat::ROCM:
+            jw.fieldUInt("archMinor", rocmInput->archMinor);
+            jw.fieldUInt("archStepping", rocmInput->archStepping);
+            jw.fieldUInt("eflags", rocmInput->eflags);
+            jw.fieldBool("newBinFormat", rocmInput->newBinFormat);
+            jw.fieldString("target", rocmInput->target);
+            break;
+        case BinaryFormat::GALLIUM:
+            jw.fieldBool("64bit", galliumInput->is64BitMode);
+            jw.fieldBool("llvm390", galliumInput->isLLVM390);
+            jw.fieldBool("mesa170", galliumInput->isMesa170);
+            jw.fieldBool("amdhsa", galliumInput->isAMDHSA);
+            break;
+        default:
+            break;
+    }
+    jw.endRecord();
+
+    switch(binaryFormat)
+    {
+        case BinaryFormat::AMD:
+            disassembleAmdJSON(jw, decoder, amdInput, flags);
+            break;
+        case BinaryFormat::AMDCL2:
+            disassembleAmdCL2JSON(jw, decoder, amdCL2Input, flags);
+            break;
+        case BinaryFormat::ROCM:
+            disassembleROCmJSON(jw, decoder, rocmInput, flags);
+            break;
+        case BinaryFormat::GALLIUM:
+            disassembleGalliumJSON(jw, decoder, galliumInput, flags);
+            break;
+        default:
+            if (rawInput->code != nullptr && rawInput->codeSize != 0)
+            {
+                writeJSONSection(jw, 0, ".text", rawInput->codeSize);
+                if ((flags & DISASM_DUMPCODE) != 0)
+                    writeJSONInstrs(jw, decoder, 0, noKernelIndex, 0,
+                            rawInput->codeSize, rawInput->code);
+            }
+            break;
+    }
+}
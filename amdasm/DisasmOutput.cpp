@@ -0,0 +1,258 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#ifdef HAVE_WINDOWS
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <vector>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Disassembler.h>
+
+using namespace CLRX;
+
+DisasmOutput::~DisasmOutput()
+{ }
+
+void DisasmOutput::flush()
+{ }
+
+/*
+ * memory output
+ */
+
+DisasmMemoryOutput::DisasmMemoryOutput(size_t initialCapacity)
+{
+    buffer.reserve(initialCapacity);
+}
+
+DisasmMemoryOutput::~DisasmMemoryOutput()
+{ }
+
+void DisasmMemoryOutput::write(size_t size, const char* data)
+{
+    buffer.insert(buffer.end(), data, data+size);
+}
+
+/*
+ * file descriptor output
+ */
+
+DisasmFileOutput::DisasmFileOutput(int _fd, size_t _bufSize)
+        : fd(_fd), bufSize(_bufSize), endPos(0)
+{
+    if (bufSize != 0)
+        buffer.reset(new char[bufSize]);
+}
+
+DisasmFileOutput::~DisasmFileOutput()
+{
+    try
+    { flush(); }
+    catch(...)
+    { } // ignore errors like std::filebuf
+}
+
+void DisasmFileOutput::write(size_t size, const char* data)
+{
+    if (bufSize != 0 && size <= bufSize-endPos)
+    {
+        // fits to buffer
+        ::memcpy(buffer.get()+endPos, data, size);
+        endPos += size;
+        return;
+    }
+    flush();
+    if (size >= bufSize)
+        // big chunk, write directly to file
+        writeToFile(size, data);
+    else
+    {
+        ::memcpy(buffer.get(), data, size);
+        endPos = size;
+    }
+}
+
+void DisasmFileOutput::flush()
+{
+    const size_t size = endPos;
+    // reset buffer before writing to avoid writing again same data after failure
+    endPos = 0;
+    writeToFile(size, buffer.get());
+}
+
+void DisasmFileOutput::writeToFile(size_t size, const char* data)
+{
+    while (size != 0)
+    {
+        // write at most 1 GB in single call
+        const size_t toWrite = std::min(size, size_t(1U<<30));
+        errno = 0;
+#ifdef HAVE_WINDOWS
+        const ssize_t written = ::_write(fd, data, cxuint(toWrite));
+#else
+        const ssize_t written = ::write(fd, data, toWrite);
+#endif
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            throw Exception("Can't write disassembler output to file");
+        }
+        data += written;
+        size -= written;
+    }
+}
+
+/*
+ * callback output
+ */
+
+DisasmCallbackOutput::DisasmCallbackOutput(DisasmOutputCallback _callback,
+            void* _userData) : callback(_callback), userData(_userData)
+{ }
+
+DisasmCallbackOutput::~DisasmCallbackOutput()
+{ }
+
+void DisasmCallbackOutput::write(size_t size, const char* data)
+{
+    callback(size, data, userData);
+}
+
+/*
+ * output stream output
+ */
+
+DisasmStreamOutput::DisasmStreamOutput(std::ostream& _os) : os(_os)
+{ }
+
+DisasmStreamOutput::~DisasmStreamOutput()
+{ }
+
+void DisasmStreamOutput::write(size_t size, const char* data)
+{
+    os.write(data, size);
+}
+
+void DisasmStreamOutput::flush()
+{
+    os.flush();
+}
+
+/*
+ * output stream buffer
+ */
+
+DisasmOutputStreamBuf::DisasmOutputStreamBuf(DisasmOutput& _sink, size_t _bufSize)
+        : sink(_sink), bufSize(_bufSize)
+{
+    if (bufSize != 0)
+    {
+        buffer.reset(new char[bufSize]);
+        setp(buffer.get(), buffer.get() + bufSize);
+    }
+    else
+        setp(nullptr, nullptr);
+}
+
+DisasmOutputStreamBuf::~DisasmOutputStreamBuf()
+{
+    try
+    { flushBuffer(); }
+    catch(...)
+    { } // ignore errors like std::filebuf
+}
+
+void DisasmOutputStreamBuf::flushBuffer()
+{
+    const size_t size = pptr()-pbase();
+    if (size == 0)
+        return;
+    // reset buffer before writing to avoid writing again same data after failure
+    setp(buffer.get(), buffer.get() + bufSize);
+    sink.write(size, buffer.get());
+}
+
+std::streambuf::int_type DisasmOutputStreamBuf::overflow(std::streambuf::int_type ch)
+{
+    flushBuffer();
+    if (ch == traits_type::eof())
+        return traits_type::not_eof(ch);
+    const char_type c = traits_type::to_char_type(ch);
+    if (bufSize == 0)
+        sink.write(1, &c);
+    else
+    {
+        *pptr() = c;
+        pbump(1);
+    }
+    return ch;
+}
+
+std::streamsize DisasmOutputStreamBuf::xsputn(const char_type* s, std::streamsize n)
+{
+    if (n <= 0)
+        return 0;
+    const size_t size = n;
+    if (size <= size_t(epptr()-pptr()))
+    {
+        // fits to buffer
+        ::memcpy(pptr(), s, size);
+        pbump(int(size));
+        return n;
+    }
+    flushBuffer();
+    if (size >= bufSize)
+        // big chunk, write directly to sink
+        sink.write(size, s);
+    else
+    {
+        ::memcpy(pptr(), s, size);
+        pbump(int(size));
+    }
+    return n;
+}
+
+int DisasmOutputStreamBuf::sync()
+{
+    flushBuffer();
+    sink.flush();
+    return 0;
+}
+
+/*
+ * output stream
+ */
+
+DisasmOutputStream::DisasmOutputStream(DisasmOutput& sink, size_t bufSize)
+        : std::ostream(nullptr), buffer(sink, bufSize)
+{
+    rdbuf(&buffer);
+}
+
+DisasmOutputStream::~DisasmOutputStream()
+{ }
@@ -65,7 +65,7 @@ ROCmDisasmInput* CLRX::getROCmDisasmInputFromBinary(const ROCmBinary& binary)
     return input.release();
 }
 
-void CLRX::dumpAMDHSAConfig(std::ostream& output, cxuint maxSgprsNum,
+void CLRX::dumpAMDHSAConfig(DisasmOutput& output, cxuint maxSgprsNum,
              GPUArchitecture arch, const ROCmKernelConfig& config, bool amdhsaPrefix)
 {
     // convert to native-endian
@@ -125,7 +125,7 @@ void CLRX::dumpAMDHSAConfig(std::ostream& output, cxuint maxSgprsNum,
     if ((dimMask & 4) != 0)
         buf[bufSize++] = 'z';
     buf[bufSize++] = '\n';
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     
     if (!amdhsaPrefix)
     {
@@ -133,43 +133,43 @@ void CLRX::dumpAMDHSAConfig(std::ostream& output, cxuint maxSgprsNum,
         // get sgprsnum and vgprsnum from PGMRSRC1
         bufSize = snprintf(buf, 100, "        .sgprsnum %u\n",
                 std::min((((pgmRsrc1>>6) & 0xf)<<3)+8, maxSgprsNum));
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .vgprsnum %u\n", ((pgmRsrc1 & 0x3f)<<2)+4);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if ((pgmRsrc1 & (1U<<20)) != 0)
-            output.write("        .privmode\n", 18);
+            output.write(18, "        .privmode\n");
         if ((pgmRsrc1 & (1U<<22)) != 0)
-            output.write("        .debugmode\n", 19);
+            output.write(19, "        .debugmode\n");
         if ((pgmRsrc1 & (1U<<21)) != 0)
-            output.write("        .dx10clamp\n", 19);
+            output.write(19, "        .dx10clamp\n");
         if ((pgmRsrc1 & (1U<<23)) != 0)
-            output.write("        .ieeemode\n", 18);
+            output.write(18, "        .ieeemode\n");
         if ((pgmRsrc2 & 0x400) != 0)
-            output.write("        .tgsize\n", 16);
+            output.write(16, "        .tgsize\n");
         
         bufSize = snprintf(buf, 100, "        .floatmode 0x%02x\n", (pgmRsrc1>>12) & 0xff);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .priority %u\n", (pgmRsrc1>>10) & 3);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if (((pgmRsrc1>>24) & 0x7f) != 0)
         {
             bufSize = snprintf(buf, 100, "        .exceptions 0x%02x\n",
                     (pgmRsrc1>>24) & 0x7f);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         const cxuint localSize = ((pgmRsrc2>>15) & 0x1ff) << ldsShift;
         if (localSize!=0)
         {
             bufSize = snprintf(buf, 100, "        .localsize %u\n", localSize);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         bufSize = snprintf(buf, 100, "        .userdatanum %u\n", (pgmRsrc2>>1) & 0x1f);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         
         bufSize = snprintf(buf, 100, "        .pgmrsrc1 0x%08x\n", pgmRsrc1);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .pgmrsrc2 0x%08x\n", pgmRsrc2);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     else
     {
@@ -177,93 +177,93 @@ void CLRX::dumpAMDHSAConfig(std::ostream& output, cxuint maxSgprsNum,
         // get sgprsnum and vgprsnum from PGMRSRC1
         bufSize = snprintf(buf, 100, "        .hsa_sgprsnum %u\n",
                 std::min((((pgmRsrc1>>6) & 0xf)<<3)+8, maxSgprsNum));
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .hsa_vgprsnum %u\n", ((pgmRsrc1 & 0x3f)<<2)+4);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if ((pgmRsrc1 & (1U<<20)) != 0)
-            output.write("        .hsa_privmode\n", 22);
+            output.write(22, "        .hsa_privmode\n");
         if ((pgmRsrc1 & (1U<<22)) != 0)
-            output.write("        .hsa_debugmode\n", 23);
+            output.write(23, "        .hsa_debugmode\n");
         if ((pgmRsrc1 & (1U<<21)) != 0)
-            output.write("        .hsa_dx10clamp\n", 23);
+            output.write(23, "        .hsa_dx10clamp\n");
         if ((pgmRsrc1 & (1U<<23)) != 0)
-            output.write("        .hsa_ieeemode\n", 22);
+            output.write(22, "        .hsa_ieeemode\n");
         if ((pgmRsrc2 & 0x400) != 0)
-            output.write("        .hsa_tgsize\n", 20);
+            output.write(20, "        .hsa_tgsize\n");
         
         bufSize = snprintf(buf, 100, "        .hsa_floatmode 0x%02x\n",
                     (pgmRsrc1>>12) & 0xff);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .hsa_priority %u\n",
                     (pgmRsrc1>>10) & 3);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         if (((pgmRsrc1>>24) & 0x7f) != 0)
         {
             bufSize = snprintf(buf, 100, "        .hsa_exceptions 0x%02x\n",
                     (pgmRsrc1>>24) & 0x7f);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         const cxuint localSize = ((pgmRsrc2>>15) & 0x1ff) << ldsShift;
         if (localSize!=0)
         {
             bufSize = snprintf(buf, 100, "        .hsa_localsize %u\n", localSize);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         bufSize = snprintf(buf, 100, "        .hsa_userdatanum %u\n", (pgmRsrc2>>1) & 0x1f);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         
         bufSize = snprintf(buf, 100, "        .hsa_pgmrsrc1 0x%08x\n", pgmRsrc1);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, "        .hsa_pgmrsrc2 0x%08x\n", pgmRsrc2);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     bufSize = snprintf(buf, 100, "        .codeversion %u, %u\n",
                    amdCodeVersionMajor, amdCodeVersionMinor);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .machine %hu, %hu, %hu, %hu\n",
                    amdMachineKind, amdMachineMajor,
                    amdMachineMinor, amdMachineStepping);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .kernel_code_entry_offset 0x%" PRIx64 "\n",
                        kernelCodeEntryOffset);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if (kernelCodePrefetchOffset!=0)
     {
         bufSize = snprintf(buf, 100,
                    "        .kernel_code_prefetch_offset 0x%" PRIx64 "\n",
                            kernelCodePrefetchOffset);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (kernelCodePrefetchSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .kernel_code_prefetch_size %" PRIu64 "\n",
                            kernelCodePrefetchSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (maxScrachBackingMemorySize!=0)
     {
         bufSize = snprintf(buf, 100, "        .max_scratch_backing_memory %" PRIu64 "\n",
                            maxScrachBackingMemorySize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     const uint16_t sgprFlags = enableSgprRegisterFlags;
     // print SGPRregister flags (features)
     if ((sgprFlags&ROCMFLAG_USE_PRIVATE_SEGMENT_BUFFER) != 0)
-        output.write("        .use_private_segment_buffer\n", 36);
+        output.write(36, "        .use_private_segment_buffer\n");
     if ((sgprFlags&ROCMFLAG_USE_DISPATCH_PTR) != 0)
-        output.write("        .use_dispatch_ptr\n", 26);
+        output.write(26, "        .use_dispatch_ptr\n");
     if ((sgprFlags&ROCMFLAG_USE_QUEUE_PTR) != 0)
-        output.write("        .use_queue_ptr\n", 23);
+        output.write(23, "        .use_queue_ptr\n");
     if ((sgprFlags&ROCMFLAG_USE_KERNARG_SEGMENT_PTR) != 0)
-        output.write("        .use_kernarg_segment_ptr\n", 33);
+        output.write(33, "        .use_kernarg_segment_ptr\n");
     if ((sgprFlags&ROCMFLAG_USE_DISPATCH_ID) != 0)
-        output.write("        .use_dispatch_id\n", 25);
+        output.write(25, "        .use_dispatch_id\n");
     if ((sgprFlags&ROCMFLAG_USE_FLAT_SCRATCH_INIT) != 0)
-        output.write("        .use_flat_scratch_init\n", 31);
+        output.write(31, "        .use_flat_scratch_init\n");
     if ((sgprFlags&ROCMFLAG_USE_PRIVATE_SEGMENT_SIZE) != 0)
-        output.write("        .use_private_segment_size\n", 34);
+        output.write(34, "        .use_private_segment_size\n");
     
     if ((sgprFlags&(7U<<ROCMFLAG_USE_GRID_WORKGROUP_COUNT_BIT)) != 0)
     {
@@ -277,127 +277,127 @@ void CLRX::dumpAMDHSAConfig(std::ostream& output, cxuint maxSgprsNum,
         if ((sgprFlags&ROCMFLAG_USE_GRID_WORKGROUP_COUNT_Z) != 0)
             buf[bufSize++] = 'z';
         buf[bufSize++] = '\n';
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     const uint16_t featureFlags = enableFeatureFlags;
     if ((featureFlags&ROCMFLAG_USE_ORDERED_APPEND_GDS) != 0)
-        output.write("        .use_ordered_append_gds\n", 32);
+        output.write(32, "        .use_ordered_append_gds\n");
     bufSize = snprintf(buf, 100, "        .private_elem_size %u\n",
                        2U<<((featureFlags>>ROCMFLAG_PRIVATE_ELEM_SIZE_BIT)&3));
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if ((featureFlags&ROCMFLAG_USE_PTR64) != 0)
-        output.write("        .use_ptr64\n", 19);
+        output.write(19, "        .use_ptr64\n");
     if ((featureFlags&ROCMFLAG_USE_DYNAMIC_CALL_STACK) != 0)
-        output.write("        .use_dynamic_call_stack\n", 32);
+        output.write(32, "        .use_dynamic_call_stack\n");
     if ((featureFlags&ROCMFLAG_USE_DEBUG_ENABLED) != 0)
-        output.write("        .use_debug_enabled\n", 27);
+        output.write(27, "        .use_debug_enabled\n");
     if ((featureFlags&ROCMFLAG_USE_XNACK_ENABLED) != 0)
-        output.write("        .use_xnack_enabled\n", 27);
+        output.write(27, "        .use_xnack_enabled\n");
     
     if (workitemPrivateSegmentSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .workitem_private_segment_size %u\n",
                          workitemPrivateSegmentSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (workgroupGroupSegmentSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .workgroup_group_segment_size %u\n",
                          workgroupGroupSegmentSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (gdsSegmentSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .gds_segment_size %u\n",
                          gdsSegmentSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (kernargSegmentSize!=0)
     {
         bufSize = snprintf(buf, 100, "        .kernarg_segment_size %" PRIu64 "\n",
                          kernargSegmentSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (workgroupFbarrierCount!=0)
     {
         bufSize = snprintf(buf, 100, "        .workgroup_fbarrier_count %u\n",
                          workgroupFbarrierCount);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (wavefrontSgprCount!=0)
     {
         bufSize = snprintf(buf, 100, "        .wavefront_sgpr_count %hu\n",
                          wavefrontSgprCount);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (workitemVgprCount!=0)
     {
         bufSize = snprintf(buf, 100, "        .workitem_vgpr_count %hu\n",
                          workitemVgprCount);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (reservedVgprCount!=0)
     {
         bufSize = snprintf(buf, 100, "        .reserved_vgprs %hu, %hu\n",
                      reservedVgprFirst, uint16_t(reservedVgprFirst+reservedVgprCount-1));
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (reservedSgprCount!=0)
     {
         bufSize = snprintf(buf, 100, "        .reserved_sgprs %hu, %hu\n",
                      reservedSgprFirst, uint16_t(reservedSgprFirst+reservedSgprCount-1));
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (debugWavefrontPrivateSegmentOffsetSgpr!=0)
     {
         bufSize = snprintf(buf, 100, "        "
                         ".debug_wavefront_private_segment_offset_sgpr %hu\n",
                          debugWavefrontPrivateSegmentOffsetSgpr);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (debugPrivateSegmentBufferSgpr!=0)
     {
         bufSize = snprintf(buf, 100, "        .debug_private_segment_buffer_sgpr %hu\n",
                          debugPrivateSegmentBufferSgpr);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     bufSize = snprintf(buf, 100, "        .kernarg_segment_align %u\n",
                      1U<<(config.kernargSegmentAlignment));
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .group_segment_align %u\n",
                      1U<<(config.groupSegmentAlignment));
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .private_segment_align %u\n",
                      1U<<(config.privateSegmentAlignment));
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .wavefront_size %u\n",
                      1U<<(config.wavefrontSize));
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     bufSize = snprintf(buf, 100, "        .call_convention 0x%x\n",
                      callConvention);
-    output.write(buf, bufSize);
+    output.write(bufSize, buf);
     if (runtimeLoaderKernelSymbol!=0)
     {
         bufSize = snprintf(buf, 100,
                    "        .runtime_loader_kernel_symbol 0x%" PRIx64 "\n",
                          runtimeLoaderKernelSymbol);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     // new section, control_directive, outside .config
-    output.write("    .control_directive\n", 23);
+    output.write(23, "    .control_directive\n");
     printDisasmData(sizeof config.controlDirective, config.controlDirective, output, true);
 }
 
-static void dumpKernelConfig(std::ostream& output, cxuint maxSgprsNum,
+static void dumpKernelConfig(DisasmOutput& output, cxuint maxSgprsNum,
              GPUArchitecture arch, const ROCmKernelConfig& config)
 {
-    output.write("    .config\n", 12);
+    output.write(12, "    .config\n");
     dumpAMDHSAConfig(output, maxSgprsNum, arch, config);
 }
 
 // routine to disassembly code in AMD HSA form (kernel with HSA config)
-void CLRX::disassembleAMDHSACode(std::ostream& output,
+void CLRX::disassembleAMDHSACode(DisasmOutput& output,
             const std::vector<ROCmDisasmRegionInput>& regions,
             size_t codeSize, const cxbyte* code, ISADisassembler* isaDisassembler,
             Flags flags)
@@ -414,7 +414,7 @@ void CLRX::disassembleAMDHSACode(std::ostream& output,
         sorted[i] = std::make_pair(regions[i].offset, i);
     mapSort(sorted.get(), sorted.get() + regionsNum);
     
-    output.write(".text\n", 6);
+    output.write(6, ".text\n");
     // clear labels
     isaDisassembler->clearNumberedLabels();
     
@@ -470,7 +470,7 @@ void CLRX::disassembleAMDHSACode(std::ostream& output,
                 if (!doDumpConfig)
                     printDisasmData(0x100, code + region.offset, output, true);
                 else    // skip, config was dumped in kernel configuration
-                    output.write(".skip 256\n", 10);
+                    output.write(10, ".skip 256\n");
             }
             
             if (doDumpCode)
@@ -485,9 +485,9 @@ void CLRX::disassembleAMDHSACode(std::ostream& output,
         }
         else if (doDumpData)
         {
-            output.write(".global ", 8);
-            output.write(region.regionName.c_str(), region.regionName.size());
-            output.write("\n", 1);
+            output.write(8, ".global ");
+            output.write(region.regionName.size(), region.regionName.c_str());
+            output.write(1, "\n");
             printDisasmData(dataSize, code + region.offset, output, true);
             prevRegionPos = region.offset+1;
         }
@@ -536,28 +536,28 @@ static const char* disasmROCmAddressSpaces[] =
 static const char* disasmROCmAccessQuals[] =
 { "default", "read_only", "write_only", "read_write" };
 
-static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadata& kernel)
+static void dumpKernelMetadataInfo(DisasmOutput& output, const ROCmKernelMetadata& kernel)
 {
-    output.write("    .config\n", 12);
-    output.write("        .md_symname ", 20);
-    output.write(kernel.symbolName.c_str(), kernel.symbolName.size());
-    output.write("\n", 1);
-    output.write("        .md_language \"", 22);
+    output.write(12, "    .config\n");
+    output.write(20, "        .md_symname ");
+    output.write(kernel.symbolName.size(), kernel.symbolName.c_str());
+    output.write(1, "\n");
+    output.write(22, "        .md_language \"");
     {
         std::string langName = escapeStringCStyle(kernel.language);
-        output.write(langName.c_str(), langName.size());
+        output.write(langName.size(), langName.c_str());
     }
     size_t bufSize = 0;
     char buf[100];
     if (kernel.langVersion[0] != BINGEN_NOTSUPPLIED)
     {
-        output.write("\", ", 3);
+        output.write(3, "\", ");
         bufSize = snprintf(buf, 100, "%u, %u\n",
                            kernel.langVersion[0], kernel.langVersion[1]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     else // version not supplied
-        output.write("\"\n", 2);
+        output.write(2, "\"\n");
     
     // print reqd_work_group_size: .cws XSIZE[,YSIZE[,ZSIZE]]
     if (kernel.reqdWorkGroupSize[0] != 0 || kernel.reqdWorkGroupSize[1] != 0 ||
@@ -566,7 +566,7 @@ static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadat
         bufSize = snprintf(buf, 100, "        .cws %u, %u, %u\n",
                kernel.reqdWorkGroupSize[0], kernel.reqdWorkGroupSize[1],
                kernel.reqdWorkGroupSize[2]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     // work group size hint
@@ -576,79 +576,79 @@ static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadat
         bufSize = snprintf(buf, 100, "        .work_group_size_hint %u, %u, %u\n",
                kernel.workGroupSizeHint[0], kernel.workGroupSizeHint[1],
                kernel.workGroupSizeHint[2]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (!kernel.vecTypeHint.empty())
     {
-        output.write("        .vectypehint ", 21);
-        output.write(kernel.vecTypeHint.c_str(), kernel.vecTypeHint.size());
-        output.write("\n", 1);
+        output.write(21, "        .vectypehint ");
+        output.write(kernel.vecTypeHint.size(), kernel.vecTypeHint.c_str());
+        output.write(1, "\n");
     }
     if (!kernel.runtimeHandle.empty())
     {
-        output.write("        .runtime_handle ", 24);
-        output.write(kernel.runtimeHandle.c_str(), kernel.runtimeHandle.size());
-        output.write("\n", 1);
+        output.write(24, "        .runtime_handle ");
+        output.write(kernel.runtimeHandle.size(), kernel.runtimeHandle.c_str());
+        output.write(1, "\n");
     }
     if (hasValue(kernel.kernargSegmentSize))
     {
         bufSize = snprintf(buf, 100, "        .md_kernarg_segment_size %" PRIu64 "\n",
                     kernel.kernargSegmentSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.kernargSegmentAlign))
     {
         bufSize = snprintf(buf, 100, "        .md_kernarg_segment_align %" PRIu64 "\n",
                     kernel.kernargSegmentAlign);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.groupSegmentFixedSize))
     {
         bufSize = snprintf(buf, 100, "        .md_group_segment_fixed_size %" PRIu64 "\n",
                     kernel.groupSegmentFixedSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.privateSegmentFixedSize))
     {
         bufSize = snprintf(buf, 100, "        .md_private_segment_fixed_size %" PRIu64 "\n",
                     kernel.privateSegmentFixedSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.wavefrontSize))
     {
         bufSize = snprintf(buf, 100, "        .md_wavefront_size %u\n",
                     kernel.wavefrontSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     // SGPRs and VGPRs
     if (hasValue(kernel.sgprsNum))
     {
         bufSize = snprintf(buf, 100, "        .md_sgprsnum %u\n", kernel.sgprsNum);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.vgprsNum))
     {
         bufSize = snprintf(buf, 100, "        .md_vgprsnum %u\n", kernel.vgprsNum);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     // spilled SGPRs and VGPRs
     if (hasValue(kernel.spilledSgprs))
     {
         bufSize = snprintf(buf, 100, "        .md_spilledsgprs %u\n",
                            kernel.spilledSgprs);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.spilledVgprs))
     {
         bufSize = snprintf(buf, 100, "        .md_spilledvgprs %u\n",
                            kernel.spilledVgprs);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     if (hasValue(kernel.maxFlatWorkGroupSize))
     {
         bufSize = snprintf(buf, 100, "        .max_flat_work_group_size %" PRIu64 "\n",
                     kernel.maxFlatWorkGroupSize);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     // fixed work group size
     if (kernel.fixedWorkGroupSize[0] != 0 || kernel.fixedWorkGroupSize[1] != 0 ||
@@ -657,36 +657,36 @@ static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadat
         bufSize = snprintf(buf, 100, "        .fixed_work_group_size %u, %u, %u\n",
                kernel.fixedWorkGroupSize[0], kernel.fixedWorkGroupSize[1],
                kernel.fixedWorkGroupSize[2]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
     }
     
     // dump kernel arguments
     for (const ROCmKernelArgInfo& argInfo: kernel.argInfos)
     {
-        output.write("        .arg ", 13);
+        output.write(13, "        .arg ");
         if (!argInfo.name.empty())
         {
-            output.write(argInfo.name.c_str(), argInfo.name.size());
-            output.write(", ", 2);
+            output.write(argInfo.name.size(), argInfo.name.c_str());
+            output.write(2, ", ");
         }
-        output.write("\"", 1);
+        output.write(1, "\"");
         std::string typeName = escapeStringCStyle(argInfo.typeName);
-        output.write(typeName.c_str(), typeName.size());
-        output.write("\", ", 3);
+        output.write(typeName.size(), typeName.c_str());
+        output.write(3, "\", ");
         size_t bufSize = 0;
         char buf[100];
         bufSize = snprintf(buf, 100, "%" PRIu64 ", %" PRIu64,
                            argInfo.size, argInfo.align);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         bufSize = snprintf(buf, 100, ", %s, %s", 
                     disasmROCmValueKindNames[cxuint(argInfo.valueKind)],
                     disasmROCmValueTypeNames[cxuint(argInfo.valueType)]);
-        output.write(buf, bufSize);
+        output.write(bufSize, buf);
         
         if (argInfo.valueKind == ROCmValueKind::DYN_SHARED_PTR)
         {
             bufSize = snprintf(buf, 100, ", %" PRIu64, argInfo.pointeeAlign);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         
         if (argInfo.valueKind == ROCmValueKind::DYN_SHARED_PTR ||
@@ -696,7 +696,7 @@ static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadat
             const char* name = disasmROCmAddressSpaces[cxuint(argInfo.addressSpace)];
             bufSize = strlen(name) + 2;
             ::memcpy(buf+2, name, bufSize-2);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         
         if (argInfo.valueKind == ROCmValueKind::IMAGE ||
@@ -706,7 +706,7 @@ static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadat
             const char* name = disasmROCmAccessQuals[cxuint(argInfo.accessQual)];
             bufSize = strlen(name) + 2;
             ::memcpy(buf+2, name, bufSize-2);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         if (argInfo.valueKind == ROCmValueKind::GLOBAL_BUFFER ||
             argInfo.valueKind == ROCmValueKind::IMAGE ||
@@ -716,23 +716,23 @@ static void dumpKernelMetadataInfo(std::ostream& output, const ROCmKernelMetadat
             const char* name = disasmROCmAccessQuals[cxuint(argInfo.actualAccessQual)];
             bufSize = strlen(name) + 2;
             ::memcpy(buf+2, name, bufSize-2);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         
         if (argInfo.isConst)
-            output.write(" const", 6);
+            output.write(6, " const");
         if (argInfo.isRestrict)
-            output.write(" restrict", 9);
+            output.write(9, " restrict");
         if (argInfo.isVolatile)
-            output.write(" volatile", 9);
+            output.write(9, " volatile");
         if (argInfo.isPipe)
-            output.write(" pipe", 5);
+            output.write(5, " pipe");
         
-        output.write("\n", 1);
+        output.write(1, "\n");
     }
 }
 
-void CLRX::disassembleROCm(std::ostream& output, const ROCmDisasmInput* rocmInput,
+void CLRX::disassembleROCm(DisasmOutput& output, const ROCmDisasmInput* rocmInput,
            ISADisassembler* isaDisassembler, Flags flags)
 {
     const bool doMetadata = ((flags & (DISASM_METADATA|DISASM_CONFIG)) != 0);
@@ -754,9 +754,9 @@ void CLRX::disassembleROCm(std::ostream& output, const ROCmDisasmInput* rocmInpu
         // print AMD architecture version
         char buf[40];
         size_t size = snprintf(buf, 40, ".arch_minor %u\n", rocmInput->archMinor);
-        output.write(buf, size);
+        output.write(size, buf);
         size = snprintf(buf, 40, ".arch_stepping %u\n", rocmInput->archStepping);
-        output.write(buf, size);
+        output.write(size, buf);
     }
     
     if (rocmInput->eflags != 0)
@@ -764,32 +764,32 @@ void CLRX::disassembleROCm(std::ostream& output, const ROCmDisasmInput* rocmInpu
         // print eflags if not zero
         char buf[40];
         size_t size = snprintf(buf, 40, ".eflags %u\n", rocmInput->eflags);
-        output.write(buf, size);
+        output.write(size, buf);
     }
     
     if (rocmInput->newBinFormat)
-        output.write(".newbinfmt\n", 11);
+        output.write(11, ".newbinfmt\n");
     
     if (!rocmInput->target.empty())
     {
-        output.write(".target \"", 9);
+        output.write(9, ".target \"");
         const std::string escapedTarget = escapeStringCStyle(rocmInput->target);
-        output.write(escapedTarget.c_str(), escapedTarget.size());
-        output.write("\"\n", 2);
+        output.write(escapedTarget.size(), escapedTarget.c_str());
+        output.write(2, "\"\n");
     }
     
     if (doDumpData && rocmInput->globalData != nullptr &&
         rocmInput->globalDataSize != 0)
     {
-        output.write(".globaldata\n", 12);
-        output.write(".gdata:\n", 8); /// symbol used by text relocations
+        output.write(12, ".globaldata\n");
+        output.write(8, ".gdata:\n"); /// symbol used by text relocations
         printDisasmData(rocmInput->globalDataSize, rocmInput->globalData, output);
     }
     
     if (doMetadata && !doDumpConfig &&
         rocmInput->metadataSize != 0 && rocmInput->metadata != nullptr)
     {
-        output.write(".metadata\n", 10);
+        output.write(10, ".metadata\n");
         printDisasmLongString(rocmInput->metadataSize, rocmInput->metadata, output);
     }
     
@@ -804,21 +804,21 @@ void CLRX::disassembleROCm(std::ostream& output, const ROCmDisasmInput* rocmInpu
         {
             bufSize = snprintf(buf, 100, ".md_version %u, %u\n", metadataInfo.version[0],
                     metadataInfo.version[1]);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
         }
         for (const ROCmPrintfInfo& printfInfo: metadataInfo.printfInfos)
         {
             bufSize = snprintf(buf, 100, ".printf %u", printfInfo.id);
-            output.write(buf, bufSize);
+            output.write(bufSize, buf);
             for (uint32_t argSize: printfInfo.argSizes)
             {
                 bufSize = snprintf(buf, 100, ", %u", argSize);
-                output.write(buf, bufSize);
+                output.write(bufSize, buf);
             }
-            output.write(", \"", 3);
+            output.write(3, ", \"");
             std::string format = escapeStringCStyle(printfInfo.format);
-            output.write(format.c_str(), format.size());
-            output.write("\"\n", 2);
+            output.write(format.size(), format.c_str());
+            output.write(2, "\"\n");
         }
         // prepare order of rocm metadata kernels
         sortedMdKernelIndices.resize(metadataInfo.kernels.size());
@@ -831,11 +831,11 @@ void CLRX::disassembleROCm(std::ostream& output, const ROCmDisasmInput* rocmInpu
     for (const ROCmDisasmRegionInput& rinput: rocmInput->regions)
         if (rinput.type != ROCmRegionType::DATA)
         {
-            output.write(".kernel ", 8);
-            output.write(rinput.regionName.c_str(), rinput.regionName.size());
+            output.write(8, ".kernel ");
+            output.write(rinput.regionName.size(), rinput.regionName.c_str());
             output.put('\n');
             if (rinput.type == ROCmRegionType::FKERNEL)
-                output.write("    .fkernel\n", 13);
+                output.write(13, "    .fkernel\n");
             if (doDumpConfig)
             {
                 dumpKernelConfig(output, maxSgprsNum, arch,
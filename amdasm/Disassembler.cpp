@@ -26,6 +26,9 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#if defined(HAVE_ARCH_INTEL) && defined(__SSSE3__)
+#  include <tmmintrin.h>
+#endif
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdbin/GalliumBinaries.h>
 #include <CLRX/utils/MemAccess.h>
@@ -40,18 +43,28 @@ DisasmException::DisasmException(const std::string& message) : Exception(message
 
 ISADisassembler::ISADisassembler(Disassembler& _disassembler, cxuint outBufSize)
         : disassembler(_disassembler), startOffset(0), labelStartOffset(0),
-          dontPrintLabelsAfterCode(false), output(outBufSize, _disassembler.getOutput())
+          sectionIndex(0), dontPrintLabelsAfterCode(false), labelBitmapStart(0),
+          labelBitmapSize(0), output(outBufSize, _disassembler.getOutput())
+{ }
+
+ISADisassembler::ISADisassembler(Disassembler& _disassembler, DisasmOutput& _output,
+            cxuint outBufSize)
+        : disassembler(_disassembler), startOffset(0), labelStartOffset(0),
+          sectionIndex(0), dontPrintLabelsAfterCode(false), labelBitmapStart(0),
+          labelBitmapSize(0), output(outBufSize, _output)
 { }
 
 ISADisassembler::~ISADisassembler()
 { }
 
 void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
-              NamedLabelIter& namedLabelIter)
+              NamedLabelIter& namedLabelIter, bool onlyBefore)
 {
     pos += startOffset; // fix
-    if ((namedLabelIter != namedLabels.end() && namedLabelIter->first <= pos) ||
-            (labelIter != labels.end() && *labelIter <= pos))
+    // labels before endPos will be written
+    const size_t endPos = onlyBefore ? pos : pos+1;
+    if ((namedLabelIter != namedLabels.end() && namedLabelIter->first < endPos) ||
+            (labelIter != labels.end() && *labelIter < endPos))
     {
         size_t curPos = SIZE_MAX;
         // set current position (from first label)
@@ -64,9 +77,9 @@ void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
         do {
             haveLabel = false;
             const bool haveNumberedLabel =
-                    labelIter != labels.end() && *labelIter <= pos;
+                    labelIter != labels.end() && *labelIter < endPos;
             const bool haveNamedLabel =
-                    (namedLabelIter != namedLabels.end() && namedLabelIter->first <= pos);
+                    (namedLabelIter != namedLabels.end() && namedLabelIter->first < endPos);
             
             size_t namedPos = SIZE_MAX;
             size_t numberedPos = SIZE_MAX;
@@ -75,7 +88,7 @@ void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
             if (haveNamedLabel)
                 namedPos = namedLabelIter->first;
             
-            /// print numbered (not named) label in form .L[position]_[sectionCount]
+            /// print numbered (not named) label in form .L[position]_[sectionIndex]
             if (numberedPos <= namedPos && haveNumberedLabel)
             {
                 curPos = *labelIter;
@@ -86,7 +99,7 @@ void ISADisassembler::writeLabelsToPosition(size_t pos, LabelIter& labelIter,
                 buf[bufPos++] = 'L';
                 bufPos += itocstrCStyle(*labelIter, buf+bufPos, 22, 10, 0, false);
                 buf[bufPos++] = '_';
-                bufPos += itocstrCStyle(disassembler.sectionCount,
+                bufPos += itocstrCStyle(sectionIndex,
                                 buf+bufPos, 22, 10, 0, false);
                 if (curPos != pos)
                 {
@@ -173,7 +186,7 @@ void ISADisassembler::writeLabelsToEnd(size_t start, LabelIter labelIter,
             buf[bufPos++] = 'L';
             bufPos += itocstrCStyle(*labelIter, buf+bufPos, 22, 10, 0, false);
             buf[bufPos++] = '_';
-            bufPos += itocstrCStyle(disassembler.sectionCount,
+            bufPos += itocstrCStyle(sectionIndex,
                             buf+bufPos, 22, 10, 0, false);
             buf[bufPos++] = ':';
             buf[bufPos++] = '\n';
@@ -219,7 +232,7 @@ void ISADisassembler::writeLocation(size_t pos)
     buf[bufPos++] = 'L';
     bufPos += itocstrCStyle(pos, buf+bufPos, 22, 10, 0, false);
     buf[bufPos++] = '_';
-    bufPos += itocstrCStyle(disassembler.sectionCount, buf+bufPos, 22, 10, 0, false);
+    bufPos += itocstrCStyle(sectionIndex, buf+bufPos, 22, 10, 0, false);
     output.forward(bufPos);
 }
 
@@ -266,11 +279,49 @@ bool ISADisassembler::writeRelocation(size_t pos, RelocIter& relocIter)
 void ISADisassembler::clearNumberedLabels()
 {
     labels.clear();
+    labelBitmap.clear();
+    labelBitmapStart = labelBitmapSize = 0;
+}
+
+void ISADisassembler::extendLabelBitmap()
+{
+    const size_t codeWordsNum = inputSize>>2;
+    if (labelBitmapSize == 0)
+    {
+        labelBitmapStart = startOffset;
+        labelBitmapSize = codeWordsNum;
+    }
+    else if (startOffset >= labelBitmapStart &&
+            ((startOffset-labelBitmapStart)&3) == 0)
+        // extend bitmap to end of this code (ROCm kernels are analyzed in order)
+        labelBitmapSize = std::max(labelBitmapSize,
+                ((startOffset-labelBitmapStart)>>2) + codeWordsNum);
+    // otherwise labels of this code will be stored in list
+    labelBitmap.resize((labelBitmapSize+63)>>6);
 }
 
 void ISADisassembler::prepareLabelsAndRelocations()
 {
     std::sort(labels.begin(), labels.end());
+    if (!labelBitmap.empty())
+    {
+        // merge labels from bitmap (already sorted) with other labels
+        std::vector<size_t> bitmapLabels;
+        std::vector<size_t>& outLabels = labels.empty() ? labels : bitmapLabels;
+        for (size_t i = 0; i < labelBitmap.size(); i++)
+            for (uint64_t word = labelBitmap[i]; word != 0; word &= word-1)
+                outLabels.push_back(labelBitmapStart +
+                        (((i<<6) + 63-CLZ64(word & (~word+1)))<<2));
+        if (!bitmapLabels.empty())
+        {
+            std::vector<size_t> newLabels(labels.size() + bitmapLabels.size());
+            std::merge(labels.begin(), labels.end(), bitmapLabels.begin(),
+                       bitmapLabels.end(), newLabels.begin());
+            labels.swap(newLabels);
+        }
+        labelBitmap.clear();
+        labelBitmapStart = labelBitmapSize = 0;
+    }
     const auto newEnd = std::unique(labels.begin(), labels.end());
     labels.resize(newEnd-labels.begin());
     mapSort(namedLabels.begin(), namedLabels.end());
@@ -286,7 +337,18 @@ void ISADisassembler::beforeDisassemble()
 
 Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+            threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    amdInput = getAmdDisasmInputFromBinary32(binary, flags);
+}
+
+Disassembler::Disassembler(const AmdMainGPUBinary32& binary, DisasmOutput& _output,
+            Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
+            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary32(binary, flags);
@@ -294,25 +356,56 @@ Disassembler::Disassembler(const AmdMainGPUBinary32& binary, std::ostream& _outp
 
 Disassembler::Disassembler(const AmdMainGPUBinary64& binary, std::ostream& _output,
             Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
-            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+            amdInput(nullptr), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+            threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    amdInput = getAmdDisasmInputFromBinary64(binary, flags);
+}
+
+Disassembler::Disassembler(const AmdMainGPUBinary64& binary, DisasmOutput& _output,
+            Flags _flags) : fromBinary(true), binaryFormat(BinaryFormat::AMD),
+            amdInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdInput = getAmdDisasmInputFromBinary64(binary, flags);
 }
 
 Disassembler::Disassembler(const AmdCL2MainGPUBinary32& binary, std::ostream& _output,
+           Flags _flags, cxuint driverVersion) : fromBinary(true),
+            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr),
+            streamOutput(new DisasmStreamOutput(_output)), output(*streamOutput),
+            flags(_flags), sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    amdCL2Input = getAmdCL2DisasmInputFromBinary32(binary, driverVersion);
+}
+
+Disassembler::Disassembler(const AmdCL2MainGPUBinary32& binary, DisasmOutput& _output,
            Flags _flags, cxuint driverVersion) : fromBinary(true),
             binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr), output(_output),
-            flags(_flags), sectionCount(0)
+            flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary32(binary, driverVersion);
 }
 
 Disassembler::Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& _output,
+           Flags _flags, cxuint driverVersion) : fromBinary(true),
+            binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr),
+            streamOutput(new DisasmStreamOutput(_output)), output(*streamOutput),
+            flags(_flags), sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    amdCL2Input = getAmdCL2DisasmInputFromBinary64(binary, driverVersion);
+}
+
+Disassembler::Disassembler(const AmdCL2MainGPUBinary64& binary, DisasmOutput& _output,
            Flags _flags, cxuint driverVersion) : fromBinary(true),
             binaryFormat(BinaryFormat::AMDCL2), amdCL2Input(nullptr), output(_output),
-            flags(_flags), sectionCount(0)
+            flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     amdCL2Input = getAmdCL2DisasmInputFromBinary64(binary, driverVersion);
@@ -320,7 +413,18 @@ Disassembler::Disassembler(const AmdCL2MainGPUBinary64& binary, std::ostream& _o
 
 Disassembler::Disassembler(const ROCmBinary& binary, std::ostream& _output, Flags _flags)
          : fromBinary(true), binaryFormat(BinaryFormat::ROCM),
-           rocmInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           rocmInput(nullptr), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+           threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    rocmInput = getROCmDisasmInputFromBinary(binary);
+}
+
+Disassembler::Disassembler(const ROCmBinary& binary, DisasmOutput& _output, Flags _flags)
+         : fromBinary(true), binaryFormat(BinaryFormat::ROCM),
+           rocmInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+           threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rocmInput = getROCmDisasmInputFromBinary(binary);
@@ -328,21 +432,51 @@ Disassembler::Disassembler(const ROCmBinary& binary, std::ostream& _output, Flag
 
 Disassembler::Disassembler(const AmdDisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMD),
-            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdInput(disasmInput), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+            threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+}
+
+Disassembler::Disassembler(const AmdDisasmInput* disasmInput, DisasmOutput& _output,
+            Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMD),
+            amdInput(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const AmdCL2DisasmInput* disasmInput, std::ostream& _output,
             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMDCL2),
-            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            amdCL2Input(disasmInput), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+            threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+}
+
+Disassembler::Disassembler(const AmdCL2DisasmInput* disasmInput, DisasmOutput& _output,
+            Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::AMDCL2),
+            amdCL2Input(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
 
 Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& _output,
                  Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::ROCM),
-            rocmInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            rocmInput(disasmInput), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+            threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+}
+
+Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, DisasmOutput& _output,
+                 Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::ROCM),
+            rocmInput(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -350,7 +484,19 @@ Disassembler::Disassembler(const ROCmDisasmInput* disasmInput, std::ostream& _ou
 Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
            std::ostream& _output, Flags _flags, cxuint llvmVersion) :
            fromBinary(true), binaryFormat(BinaryFormat::GALLIUM),
-           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0)
+           galliumInput(nullptr), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+           threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    galliumInput = getGalliumDisasmInputFromBinary(deviceType, binary, llvmVersion);
+}
+
+Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary,
+           DisasmOutput& _output, Flags _flags, cxuint llvmVersion) :
+           fromBinary(true), binaryFormat(BinaryFormat::GALLIUM),
+           galliumInput(nullptr), output(_output), flags(_flags), sectionCount(0),
+           threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     galliumInput = getGalliumDisasmInputFromBinary(deviceType, binary, llvmVersion);
@@ -358,7 +504,17 @@ Disassembler::Disassembler(GPUDeviceType deviceType, const GalliumBinary& binary
 
 Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream& _output,
              Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::GALLIUM),
-            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0)
+            galliumInput(disasmInput), streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0),
+            threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+}
+
+Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, DisasmOutput& _output,
+             Flags _flags) : fromBinary(false), binaryFormat(BinaryFormat::GALLIUM),
+            galliumInput(disasmInput), output(_output), flags(_flags), sectionCount(0),
+            threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
 }
@@ -366,7 +522,17 @@ Disassembler::Disassembler(const GalliumDisasmInput* disasmInput, std::ostream&
 Disassembler::Disassembler(GPUDeviceType deviceType, size_t rawCodeSize,
            const cxbyte* rawCode, std::ostream& _output, Flags _flags)
        : fromBinary(true), binaryFormat(BinaryFormat::RAWCODE),
-         output(_output), flags(_flags), sectionCount(0)
+         streamOutput(new DisasmStreamOutput(_output)),
+            output(*streamOutput), flags(_flags), sectionCount(0), threadsNum(1)
+{
+    isaDisassembler.reset(new GCNDisassembler(*this));
+    rawInput = new RawCodeInput{ deviceType, rawCodeSize, rawCode };
+}
+
+Disassembler::Disassembler(GPUDeviceType deviceType, size_t rawCodeSize,
+           const cxbyte* rawCode, DisasmOutput& _output, Flags _flags)
+       : fromBinary(true), binaryFormat(BinaryFormat::RAWCODE),
+         output(_output), flags(_flags), sectionCount(0), threadsNum(1)
 {
     isaDisassembler.reset(new GCNDisassembler(*this));
     rawInput = new RawCodeInput{ deviceType, rawCodeSize, rawCode };
@@ -414,10 +580,145 @@ GPUDeviceType Disassembler::getDeviceType() const
     }
 }
 
-void CLRX::printDisasmData(size_t size, const cxbyte* data, std::ostream& output,
+/* data dumping (.byte and .int lines) */
+
+// size of buffer for dumped data (lines are written in whole blocks)
+static const size_t disasmDataBufSize = 8192;
+// max size of single line of dumped data (with extra bytes written by line routines)
+static const size_t disasmDataMaxLineSize = 96;
+
+static const char disasmHexDigits[17] = "0123456789abcdef";
+
+#if defined(HAVE_ARCH_INTEL) && defined(__SSSE3__)
+// templates and shuffle masks for full data lines (8 bytes or 4 dwords)
+// every line has 47 characters (48 with extra byte)
+struct CLRX_INTERNAL DisasmHexLineTables
+{
+    cxbyte byteTemplate[48];    // 0xXX, 0xXX, ... (zeroes in place of digits)
+    cxbyte byteShuffle[48];     // digits of nibbles interleaved: hi, lo
+    cxbyte intTemplate[48];     // 0xXXXXXXXX, ... (zeroes in place of digits)
+    cxbyte intShuffleLo[48];    // digits from first 8 bytes (from highest byte)
+    cxbyte intShuffleHi[48];    // digits from last 8 bytes (from highest byte)
+};
+
+// constant tables (0x80 in shuffle mask gives zero byte)
+static const DisasmHexLineTables disasmHexLineTables =
+{
+    {
+        '0', 'x', 0, 0, ',', ' ', '0', 'x', 0, 0, ',', ' ',
+        '0', 'x', 0, 0, ',', ' ', '0', 'x', 0, 0, ',', ' ',
+        '0', 'x', 0, 0, ',', ' ', '0', 'x', 0, 0, ',', ' ',
+        '0', 'x', 0, 0, ',', ' ', '0', 'x', 0, 0, '\n', ' '
+    },
+    {
+        0x80, 0x80, 0, 1, 0x80, 0x80, 0x80, 0x80, 2, 3, 0x80, 0x80,
+        0x80, 0x80, 4, 5, 0x80, 0x80, 0x80, 0x80, 6, 7, 0x80, 0x80,
+        0x80, 0x80, 8, 9, 0x80, 0x80, 0x80, 0x80, 10, 11, 0x80, 0x80,
+        0x80, 0x80, 12, 13, 0x80, 0x80, 0x80, 0x80, 14, 15, 0x80, 0x80
+    },
+    {
+        '0', 'x', 0, 0, 0, 0, 0, 0, 0, 0, ',', ' ',
+        '0', 'x', 0, 0, 0, 0, 0, 0, 0, 0, ',', ' ',
+        '0', 'x', 0, 0, 0, 0, 0, 0, 0, 0, ',', ' ',
+        '0', 'x', 0, 0, 0, 0, 0, 0, 0, 0, '\n', ' '
+    },
+    {
+        0x80, 0x80, 6, 7, 4, 5, 2, 3, 0, 1, 0x80, 0x80,
+        0x80, 0x80, 14, 15, 12, 13, 10, 11, 8, 9, 0x80, 0x80,
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+    },
+    {
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+        0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+        0x80, 0x80, 6, 7, 4, 5, 2, 3, 0, 1, 0x80, 0x80,
+        0x80, 0x80, 14, 15, 12, 13, 10, 11, 8, 9, 0x80, 0x80
+    }
+};
+
+// convert nibbles to hexadecimal digits
+static inline __m128i hexDigitsSSSE3(__m128i nibbles)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(disasmHexDigits)), nibbles);
+}
+
+// print full line of 8 bytes (writes 48 characters, returns line length)
+static inline size_t printDisasmByteLine(const cxbyte* data, char* out)
+{
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(data));
+    const __m128i mask4 = _mm_set1_epi8(15);
+    const __m128i digits = hexDigitsSSSE3(_mm_unpacklo_epi8(
+            _mm_and_si128(_mm_srli_epi16(v, 4), mask4), _mm_and_si128(v, mask4)));
+    for (cxuint k = 0; k < 48; k += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_or_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                    disasmHexLineTables.byteTemplate + k)),
+            _mm_shuffle_epi8(digits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                    disasmHexLineTables.byteShuffle + k)))));
+    return 47;
+}
+
+// print full line of 4 dwords (writes 48 characters, returns line length)
+static inline size_t printDisasmIntLine(const uint32_t* data, char* out)
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    const __m128i mask4 = _mm_set1_epi8(15);
+    const __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask4);
+    const __m128i lo = _mm_and_si128(v, mask4);
+    const __m128i digitsLo = hexDigitsSSSE3(_mm_unpacklo_epi8(hi, lo));
+    const __m128i digitsHi = hexDigitsSSSE3(_mm_unpackhi_epi8(hi, lo));
+    for (cxuint k = 0; k < 48; k += 16)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_or_si128(
+            _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                    disasmHexLineTables.intTemplate + k)),
+                _mm_shuffle_epi8(digitsLo, _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(
+                            disasmHexLineTables.intShuffleLo + k)))),
+            _mm_shuffle_epi8(digitsHi, _mm_loadu_si128(reinterpret_cast<const __m128i*>(
+                    disasmHexLineTables.intShuffleHi + k)))));
+    return 47;
+}
+#else
+// print full line of 8 bytes (writes 48 characters, returns line length)
+static inline size_t printDisasmByteLine(const cxbyte* data, char* out)
+{
+    for (cxuint i = 0; i < 8; i++, out += 6)
+    {
+        out[0] = '0';
+        out[1] = 'x';
+        out[2] = disasmHexDigits[data[i]>>4];
+        out[3] = disasmHexDigits[data[i]&15];
+        out[4] = ',';
+        out[5] = ' ';
+    }
+    out[-2] = '\n';
+    return 47;
+}
+
+// print full line of 4 dwords (writes 48 characters, returns line length)
+static inline size_t printDisasmIntLine(const uint32_t* data, char* out)
+{
+    for (cxuint i = 0; i < 4; i++, out += 12)
+    {
+        const uint32_t value = ULEV(data[i]);
+        out[0] = '0';
+        out[1] = 'x';
+        for (cxuint d = 0; d < 8; d++)
+            out[2+d] = disasmHexDigits[(value>>(28-4*d))&15];
+        out[10] = ',';
+        out[11] = ' ';
+    }
+    out[-2] = '\n';
+    return 47;
+}
+#endif
+
+void CLRX::printDisasmData(size_t size, const cxbyte* data, DisasmOutput& output,
                 bool secondAlign)
 {
-    char buf[68];
+    char buf[disasmDataBufSize];
+    size_t bufPos = 0;
     /// const strings for .byte and fill pseudo-ops
     const char* linePrefix = "    .byte ";
     const char* fillPrefix = "    .fill ";
@@ -429,66 +730,66 @@ void CLRX::printDisasmData(size_t size, const cxbyte* data, std::ostream& output
         fillPrefix = "        .fill ";
         prefixSize += 4;
     }
-    ::memcpy(buf, linePrefix, prefixSize);
     for (size_t p = 0; p < size;)
     {
-        size_t fillEnd;
-        // find max repetition of this element
-        for (fillEnd = p+1; fillEnd < size && data[fillEnd]==data[p]; fillEnd++);
-        if (fillEnd >= p+8)
+        if (bufPos + disasmDataMaxLineSize > disasmDataBufSize)
         {
-            // if element repeated for least 1 line
+            output.write(bufPos, buf);
+            bufPos = 0;
+        }
+        // if element repeated for least 1 line (p is always multiple of 8)
+        if (p+8 <= size && ::memcmp(data+p, data+p+1, 7) == 0)
+        {
+            // find max repetition of this element (compare whole lines)
+            size_t fillEnd = p+8;
+            for (; fillEnd+8 <= size && ::memcmp(data+fillEnd, data+p, 8) == 0;
+                 fillEnd += 8);
+            for (; fillEnd < size && data[fillEnd]==data[p]; fillEnd++);
             // print .fill pseudo-op: .fill SIZE, 1, VALUE
-            ::memcpy(buf, fillPrefix, prefixSize);
+            ::memcpy(buf+bufPos, fillPrefix, prefixSize);
             const size_t oldP = p;
             p = (fillEnd != size) ? fillEnd&~size_t(7) : fillEnd;
-            size_t bufPos = prefixSize;
+            bufPos += prefixSize;
             bufPos += itocstrCStyle(p-oldP, buf+bufPos, 22, 10);
             memcpy(buf+bufPos, ", 1, ", 5);
             bufPos += 5;
             // value to fill
             bufPos += itocstrCStyle(data[oldP], buf+bufPos, 6, 16, 2);
             buf[bufPos++] = '\n';
-            output.write(buf, bufPos);
-            ::memcpy(buf, linePrefix, prefixSize);
             continue;
         }
         
-        const size_t lineEnd = std::min(p+8, size);
-        size_t bufPos = prefixSize;
-        // print 8 or less (if end of data) bytes
-        for (; p < lineEnd; p++)
+        ::memcpy(buf+bufPos, linePrefix, prefixSize);
+        bufPos += prefixSize;
+        if (p+8 <= size)
+        {
+            bufPos += printDisasmByteLine(data+p, buf+bufPos);
+            p += 8;
+            continue;
+        }
+        // print less than 8 bytes (end of data)
+        for (; p < size; p++)
         {
             buf[bufPos++] = '0';
             buf[bufPos++] = 'x';
-            {
-                // inline byte in hexadecimal
-                cxuint digit = data[p]>>4;
-                if (digit < 10)
-                    buf[bufPos++] = '0'+digit;
-                else
-                    buf[bufPos++] = 'a'+digit-10;
-                digit = data[p]&0xf;
-                if (digit < 10)
-                    buf[bufPos++] = '0'+digit;
-                else
-                    buf[bufPos++] = 'a'+digit-10;
-            }
-            if (p+1 < lineEnd)
+            buf[bufPos++] = disasmHexDigits[data[p]>>4];
+            buf[bufPos++] = disasmHexDigits[data[p]&15];
+            if (p+1 < size)
             {
                 buf[bufPos++] = ',';
                 buf[bufPos++] = ' ';
             }
         }
         buf[bufPos++] = '\n';
-        output.write(buf, bufPos);
     }
+    output.write(bufPos, buf);
 }
 
-void CLRX::printDisasmDataU32(size_t size, const uint32_t* data, std::ostream& output,
+void CLRX::printDisasmDataU32(size_t size, const uint32_t* data, DisasmOutput& output,
                 bool secondAlign)
 {
-    char buf[68];
+    char buf[disasmDataBufSize];
+    size_t bufPos = 0;
     /// const strings for .byte and fill pseudo-ops
     const char* linePrefix = "    .int ";
     const char* fillPrefix = "    .fill ";
@@ -501,50 +802,59 @@ void CLRX::printDisasmDataU32(size_t size, const uint32_t* data, std::ostream& o
         fillPrefixSize += 4;
     }
     const size_t intPrefixSize = fillPrefixSize-1;
-    ::memcpy(buf, linePrefix, intPrefixSize);
     for (size_t p = 0; p < size;)
     {
-        size_t fillEnd;
-        // find max repetition of this char
-        for (fillEnd = p+1; fillEnd < size && ULEV(data[fillEnd])==ULEV(data[p]);
-             fillEnd++);
-        if (fillEnd >= p+4)
+        if (bufPos + disasmDataMaxLineSize > disasmDataBufSize)
         {
-            // if element repeated for least 1 line
+            output.write(bufPos, buf);
+            bufPos = 0;
+        }
+        // if element repeated for least 1 line (p is always multiple of 4)
+        if (p+4 <= size && ::memcmp(data+p, data+p+1, 12) == 0)
+        {
+            // find max repetition of this element (compare whole lines)
+            size_t fillEnd = p+4;
+            for (; fillEnd+4 <= size && ::memcmp(data+fillEnd, data+p, 16) == 0;
+                 fillEnd += 4);
+            for (; fillEnd < size && data[fillEnd]==data[p]; fillEnd++);
             // print .fill pseudo-op
-            ::memcpy(buf, fillPrefix, fillPrefixSize);
+            ::memcpy(buf+bufPos, fillPrefix, fillPrefixSize);
             const size_t oldP = p;
             p = (fillEnd != size) ? fillEnd&~size_t(3) : fillEnd;
-            size_t bufPos = fillPrefixSize;
+            bufPos += fillPrefixSize;
             bufPos += itocstrCStyle(p-oldP, buf+bufPos, 22, 10);
             memcpy(buf+bufPos, ", 4, ", 5);
             bufPos += 5;
             // print fill value
             bufPos += itocstrCStyle(ULEV(data[oldP]), buf+bufPos, 12, 16, 8);
             buf[bufPos++] = '\n';
-            output.write(buf, bufPos);
-            ::memcpy(buf, linePrefix, fillPrefixSize);
             continue;
         }
         
-        const size_t lineEnd = std::min(p+4, size);
-        size_t bufPos = intPrefixSize;
-        // print four or less (if end of data) dwords
-        for (; p < lineEnd; p++)
+        ::memcpy(buf+bufPos, linePrefix, intPrefixSize);
+        bufPos += intPrefixSize;
+        if (p+4 <= size)
+        {
+            bufPos += printDisasmIntLine(data+p, buf+bufPos);
+            p += 4;
+            continue;
+        }
+        // print less than four dwords (end of data)
+        for (; p < size; p++)
         {
             bufPos += itocstrCStyle(ULEV(data[p]), buf+bufPos, 12, 16, 8);
-            if (p+1 < lineEnd)
+            if (p+1 < size)
             {
                 buf[bufPos++] = ',';
                 buf[bufPos++] = ' ';
             }
         }
         buf[bufPos++] = '\n';
-        output.write(buf, bufPos);
     }
+    output.write(bufPos, buf);
 }
 
-void CLRX::printDisasmLongString(size_t size, const char* data, std::ostream& output,
+void CLRX::printDisasmLongString(size_t size, const char* data, DisasmOutput& output,
             bool secondAlign)
 {
     const char* linePrefix = "    .ascii \"";
@@ -571,64 +881,125 @@ void CLRX::printDisasmLongString(size_t size, const char* data, std::ostream& ou
                       buffer+prefixSize, escapeSize);
         buffer[prefixSize+escapeSize] = '\"';
         buffer[prefixSize+escapeSize+1] = '\n';
-        output.write(buffer, prefixSize+escapeSize+2);
+        output.write(prefixSize+escapeSize+2, buffer);
     }
 }
 
-static void disassembleRawCode(std::ostream& output, const RawCodeInput* rawInput,
+void CLRX::disassembleKernels(DisasmOutput& output, size_t kernelsNum,
+        ISADisassembler* isaDisassembler, size_t& sectionCount, cxuint threadsNum,
+        const std::function<bool(size_t)>& hasKernelCode,
+        const DisasmKernelFunc& disasmKernel)
+{
+    if (threadsNum == 0)
+        threadsNum = getHardwareThreadsNum();
+    if (threadsNum <= 1 || kernelsNum <= 1)
+    {
+        // sequential disassembly
+        for (size_t i = 0; i < kernelsNum; i++)
+        {
+            isaDisassembler->setSectionIndex(sectionCount);
+            disasmKernel(output, isaDisassembler, i);
+            if (hasKernelCode(i))
+                sectionCount++;
+        }
+        return;
+    }
+    // kernels are disassembled in batches to hold only few kernel outputs in memory
+    const size_t batchSize = size_t(threadsNum)*4;
+    // kernel outputs are held in memory buffers (reused between batches)
+    std::vector<std::unique_ptr<DisasmMemoryOutput> > kernelOutputs(
+                std::min(batchSize, kernelsNum));
+    for (std::unique_ptr<DisasmMemoryOutput>& kernelOutput: kernelOutputs)
+        kernelOutput.reset(new DisasmMemoryOutput());
+    std::vector<size_t> sectionIndices(kernelOutputs.size());
+    for (size_t batchStart = 0; batchStart < kernelsNum; batchStart += batchSize)
+    {
+        const size_t batchKernelsNum = std::min(batchSize, kernelsNum-batchStart);
+        // section indices (label suffixes) must be same as in sequential disassembly
+        for (size_t i = 0; i < batchKernelsNum; i++)
+        {
+            sectionIndices[i] = sectionCount;
+            if (hasKernelCode(batchStart+i))
+                sectionCount++;
+        }
+        runParallel(batchKernelsNum, threadsNum, [&](size_t i)
+        {
+            DisasmMemoryOutput& kernelOutput = *kernelOutputs[i];
+            std::unique_ptr<ISADisassembler> kernelDisasm(
+                        isaDisassembler->createInstance(kernelOutput));
+            kernelDisasm->setSectionIndex(sectionIndices[i]);
+            disasmKernel(kernelOutput, kernelDisasm.get(), batchStart+i);
+        });
+        // write outputs in original order
+        for (size_t i = 0; i < batchKernelsNum; i++)
+        {
+            output.write(kernelOutputs[i]->size(), kernelOutputs[i]->data());
+            kernelOutputs[i]->clear();
+        }
+    }
+}
+
+static void disassembleRawCode(DisasmOutput& output, const RawCodeInput* rawInput,
        ISADisassembler* isaDisassembler, Flags flags)
 {
     if ((flags & DISASM_DUMPCODE) != 0)
     {
-        output.write(".text\n", 6);
+        output.write(6, ".text\n");
         isaDisassembler->setInput(rawInput->codeSize, rawInput->code);
         isaDisassembler->beforeDisassemble();
         isaDisassembler->disassemble();
     }
 }
 
-void Disassembler::disassemble()
+void Disassembler::disassembleToOutput()
 {
-    const std::ios::iostate oldExceptions = output.exceptions();
-    output.exceptions(std::ios::failbit | std::ios::badbit);
-    try
+    if ((flags & DISASM_JSON) != 0)
     {
+        // machine-readable records instead of assembler source
+        disassembleJSON();
+        output.flush();
+        return;
+    }
     sectionCount = 0;
+    isaDisassembler->setSectionIndex(0);
+    // single code (Gallium, ROCm, raw code) will be disassembled in chunks in parallel
+    static_cast<GCNDisassembler*>(isaDisassembler.get())->setThreadsNum(threadsNum);
     // write pseudo to set binary format
     switch(binaryFormat)
     {
         case BinaryFormat::AMD:
-            output.write(".amd\n", 5);
+            output.write(5, ".amd\n");
             break;
         case BinaryFormat::AMDCL2:
-            output.write(".amdcl2\n", 8);
+            output.write(8, ".amdcl2\n");
             break;
         case BinaryFormat::ROCM:
-            output.write(".rocm\n", 6);
+            output.write(6, ".rocm\n");
             break;
         case BinaryFormat::GALLIUM: // Gallium
-            output.write(".gallium\n", 9);
+            output.write(9, ".gallium\n");
             break;
         default:
-            output.write(".rawcode\n", 9);
+            output.write(9, ".rawcode\n");
     }
     
     // print GPU device (.gpu name)
     const GPUDeviceType deviceType = getDeviceType();
-    output.write(".gpu ", 5);
+    output.write(5, ".gpu ");
     const char* gpuName = getGPUDeviceTypeName(deviceType);
-    output.write(gpuName, ::strlen(gpuName));
+    output.write(::strlen(gpuName), gpuName);
     output.put('\n');
     
     // call main disasembly routine
     switch(binaryFormat)
     {
         case BinaryFormat::AMD:
-            disassembleAmd(output, amdInput, isaDisassembler.get(), sectionCount, flags);
+            disassembleAmd(output, amdInput, isaDisassembler.get(), sectionCount, flags,
+                           threadsNum);
             break;
         case BinaryFormat::AMDCL2:
             disassembleAmdCL2(output, amdCL2Input, isaDisassembler.get(),
-                              sectionCount, flags);
+                              sectionCount, flags, threadsNum);
             break;
         case BinaryFormat::ROCM:
             disassembleROCm(output, rocmInput, isaDisassembler.get(), flags);
@@ -640,11 +1011,25 @@ void Disassembler::disassemble()
             disassembleRawCode(output, rawInput, isaDisassembler.get(), flags);
     }
     output.flush();
-    } /* try catch */
+}
+
+void Disassembler::disassemble()
+{
+    if (!streamOutput)
+    {
+        // sink throws exception itself if writing failed
+        disassembleToOutput();
+        return;
+    }
+    std::ostream& os = streamOutput->getOStream();
+    const std::ios::iostate oldExceptions = os.exceptions();
+    os.exceptions(std::ios::failbit | std::ios::badbit);
+    try
+    { disassembleToOutput(); }
     catch(...)
     {
-        output.exceptions(oldExceptions);
+        os.exceptions(oldExceptions);
         throw;
     }
-    output.exceptions(oldExceptions);
+    os.exceptions(oldExceptions);
 }
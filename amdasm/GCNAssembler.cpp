@@ -24,6 +24,7 @@
 #include <cstring>
 #include <algorithm>
 #include <mutex>
+#include <unordered_map>
 #include <CLRX/amdasm/Assembler.h>
 #include <CLRX/utils/Utilities.h>
 #include "GCNAsmInternals.h"
@@ -308,6 +309,134 @@ std::pair<uint16_t,uint16_t> GCNUsageHandler::getRegPair(AsmRegField regField,
     return { rstart, rstart+regSize };
 }
 
+/* set first register in register field of instruction (reverse of getRegPair).
+ * fields that are implied by other fields (H and LAST) are not changed */
+void GCNUsageHandler::setRegStart(cxbyte* code, AsmRegField regField,
+                 uint16_t rstart) const
+{
+    const bool isGCN12 = (archMask & ARCH_GCN_1_2_4)!=0;
+    uint32_t* words = reinterpret_cast<uint32_t*>(code);
+    // set bits of field in word of instruction
+    auto setField = [words](cxuint wordIndex, cxuint shift, uint32_t mask,
+                uint32_t value)
+    {
+        const uint32_t word = ULEV(words[wordIndex]);
+        SULEV(words[wordIndex], (word & ~(mask<<shift)) | ((value&mask)<<shift));
+    };
+    switch(regField)
+    {
+        case GCNFIELD_SSRC0:
+            setField(0, 0, 0xff, rstart);
+            break;
+        case GCNFIELD_SSRC1:
+            setField(0, 8, 0xff, rstart);
+            break;
+        case GCNFIELD_SDST:
+            setField(0, 16, 0x7f, rstart);
+            break;
+        case GCNFIELD_SMRD_SBASE:
+            if (isGCN12)
+                setField(0, 0, 0x3f, rstart>>1);
+            else
+                setField(0, 9, 0x3f, rstart>>1);
+            break;
+        case GCNFIELD_SMRD_SDST:
+            if (isGCN12)
+                setField(0, 6, 0x7f, rstart);
+            else
+                setField(0, 15, 0x7f, rstart);
+            break;
+        case GCNFIELD_SMRD_SOFFSET:
+            if (isGCN12)
+                setField(1, 0, 0x7f, rstart);
+            else
+                setField(0, 0, 0x7f, rstart);
+            break;
+        case GCNFIELD_VOP_SRC0:
+            setField(0, 0, 0x1ff, rstart);
+            break;
+        case GCNFIELD_VOP_VSRC1:
+            setField(0, 9, 0xff, rstart-256);
+            break;
+        case GCNFIELD_VOP_SSRC1:
+            setField(0, 9, 0xff, rstart);
+            break;
+        case GCNFIELD_VOP_VDST:
+            setField(0, 17, 0xff, rstart-256);
+            break;
+        case GCNFIELD_VOP_SDST:
+            setField(0, 17, 0xff, rstart);
+            break;
+        case GCNFIELD_VOP3_SRC0:
+            setField(1, 0, 0x1ff, rstart);
+            break;
+        case GCNFIELD_VOP3_SRC1:
+            setField(1, 9, 0x1ff, rstart);
+            break;
+        case GCNFIELD_VOP3_SRC2:
+        case GCNFIELD_VOP3_SSRC:
+            setField(1, 18, 0x1ff, rstart);
+            break;
+        case GCNFIELD_VOP3_VDST:
+        case GCNFIELD_VINTRP_VSRC0:
+            setField(0, 0, 0xff, rstart-256);
+            break;
+        case GCNFIELD_VOP3_SDST0:
+            setField(0, 0, 0xff, rstart);
+            break;
+        case GCNFIELD_VOP3_SDST1:
+            setField(0, 8, 0x7f, rstart);
+            break;
+        case GCNFIELD_VINTRP_VDST:
+            setField(0, 18, 0xff, rstart-256);
+            break;
+        case GCNFIELD_DPPSDWA_SRC0:
+        case GCNFIELD_FLAT_ADDR:
+        case GCNFIELD_DS_ADDR:
+        case GCNFIELD_EXP_VSRC0:
+        case GCNFIELD_M_VADDR:
+            setField(1, 0, 0xff, rstart-256);
+            break;
+        case GCNFIELD_FLAT_DATA:
+        case GCNFIELD_DS_DATA0:
+        case GCNFIELD_EXP_VSRC1:
+        case GCNFIELD_M_VDATA:
+            setField(1, 8, 0xff, rstart-256);
+            break;
+        case GCNFIELD_DS_DATA1:
+        case GCNFIELD_EXP_VSRC2:
+            setField(1, 16, 0xff, rstart-256);
+            break;
+        case GCNFIELD_DS_VDST:
+        case GCNFIELD_FLAT_VDST:
+        case GCNFIELD_EXP_VSRC3:
+            setField(1, 24, 0xff, rstart-256);
+            break;
+        case GCNFIELD_M_SRSRC:
+            setField(1, 16, 0x1f, rstart>>2);
+            break;
+        case GCNFIELD_MIMG_SSAMP:
+            setField(1, 21, 0x1f, rstart>>2);
+            break;
+        case GCNFIELD_M_SOFFSET:
+            setField(1, 24, 0xff, rstart);
+            break;
+        case GCNFIELD_DPPSDWA_SSRC0:
+            setField(1, 0, 0xff, rstart);
+            break;
+        case GCNFIELD_SDWAB_SDST:
+            setField(1, 8, 0x7f, rstart);
+            break;
+        case GCNFIELD_SMRD_SDSTH:
+        case GCNFIELD_M_VDATAH:
+        case GCNFIELD_M_VDATALAST:
+        case GCNFIELD_FLAT_VDSTLAST:
+            break;
+        default:
+            throw AsmException("Unknown GCNField");
+    }
+}
+
 /// get usage dependencies
 /* linearDeps - lists of linked register fields (linked fields)
  * equalToDeps - lists of register fields should be equal */
@@ -315,7 +444,9 @@ void GCNUsageHandler::getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage*
                 cxbyte* linearDeps, cxbyte* equalToDeps) const
 {
     cxuint count = 0;
-    if (rvus[0].regField>=GCNFIELD_VOP_SRC0 && rvus[0].regField<=GCNFIELD_VOP3_SDST1)
+    equalToDeps[0] = 0;
+    if (rvusNum != 0 &&
+        rvus[0].regField>=GCNFIELD_VOP_SRC0 && rvus[0].regField<=GCNFIELD_VOP3_SDST1)
     {
         // if VOPx instructions, equalTo deps for rule (only one SGPR in source)
         for (cxuint i = 0; i < rvusNum; i++)
@@ -327,7 +458,7 @@ void GCNUsageHandler::getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage*
                 rf == GCNFIELD_VOP3_SSRC || rf == GCNFIELD_DPPSDWA_SRC0)
             {
                 // if SGPR
-                if ((rvus[i].regVar==nullptr && rvus[i].rstart<108) ||
+                if (rvus[i].regVar==nullptr ? rvus[i].rstart<108 :
                      rvus[i].regVar->type == REGTYPE_SGPR)
                     equalToDeps[2 + count++] = i;
             }
@@ -355,6 +486,8 @@ void GCNUsageHandler::getUsageDependencies(cxuint rvusNum, const AsmRegVarUsage*
 
 GCNAssembler::GCNAssembler(Assembler& assembler): ISAAssembler(assembler),
         regs({0, 0}), curArchMask(1U<<cxuint(
+                    getGPUArchitectureFromDeviceType(assembler.getDeviceType()))),
+        encTable(getGCNEncodingTable(
                     getGPUArchitectureFromDeviceType(assembler.getDeviceType())))
 {
     callOnce(clrxGCNAssemblerOnceFlag, initializeGCNAssembler);
@@ -3987,8 +4120,9 @@ void GCNAssembler::assemble(const CString& inMnemonic, const char* mnemPlace,
         default:
             break;
     }
-    // register RegVarUsage in tests, do not apply normal usage
-    if (good && (assembler.getFlags() & ASM_TESTRUN) != 0)
+    // register RegVarUsage in tests, for instruction scheduling and register allocation
+    if (good && ((assembler.getFlags() & ASM_TESTRUN) != 0 ||
+                assembler.isScheduling() || assembler.isRegAllocUsed()))
         flushInstrRVUs(usageHandler);
 }
 
@@ -4237,134 +4371,384 @@ bool GCNAssembler::parseRegisterType(const char*& linePtr, const char* end, cxui
     return false;
 }
 
-static const bool gcnSize11Table[16] =
+// get instruction size, used by register allocation to skip instruction
+size_t GCNAssembler::getInstructionSize(size_t codeSize, const cxbyte* code) const
+{
+    if (codeSize < 4)
+        return 0; // no instruction
+    const uint32_t insnCode = ULEV(*reinterpret_cast<const uint32_t*>(code));
+    return getGCNInstrWordsNum(getGCNEncodingEntry(encTable, insnCode), insnCode)<<2;
+}
+
+static OnceFlag clrxGCNSchedOnceFlag;
+// GCN instructions by architecture, encoding and opcode (used by scheduler)
+static std::unordered_map<uint32_t, const GCNInstruction*> gcnInstrByCodeMap;
+
+static void initializeGCNSchedInfo()
 {
-    false, // GCNENC_SMRD, // 0000
-    false, // GCNENC_SMRD, // 0001
-    false, // GCNENC_VINTRP, // 0010
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_NONE, // 0101 - illegal
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    true,  // GCNENC_EXP,   // 1110
-    false // GCNENC_NONE   // 1111 - illegal
+    for (const GCNInstruction* insn = gcnInstrsTable; insn->mnemonic!=nullptr; insn++)
+        for (cxuint arch = 0; arch < 4; arch++)
+            if ((insn->archMask & (1U<<arch)) != 0)
+                // first instruction wins (aliases have same behaviour)
+                gcnInstrByCodeMap.insert(std::make_pair((uint32_t(arch)<<24) |
+                        (uint32_t(insn->encoding)<<16) | insn->code, insn));
+}
+
+static inline bool mnemonicStartsWith(const char* mnemonic, const char* prefix)
+{ return ::strncmp(mnemonic, prefix, ::strlen(prefix))==0; }
+
+// SOPP instructions that do not change code flow
+static const char* gcnSchedNoFlowSOPPTable[] =
+{
+    "s_barrier", "s_decperflevel", "s_icache_inv", "s_incperflevel", "s_nop",
+    "s_sendmsg", "s_sendmsghalt", "s_sethalt", "s_setprio", "s_sleep",
+    "s_ttracedata", "s_waitcnt", "s_wakeup"
 };
 
-static const bool gcnSize12Table[16] =
+// scalar instructions that change or depend on code flow
+static const char* gcnSchedFlowSALUTable[] =
 {
-    true,  // GCNENC_SMEM, // 0000
-    true,  // GCNENC_EXP, // 0001
-    false, // GCNENC_NONE, // 0010 - illegal
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_VINTRP, // 0101
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    false, // GCNENC_NONE,  // 1110 - illegal
-    false // GCNENC_NONE   // 1111 - illegal
+    "s_call", "s_cbranch", "s_getpc", "s_getreg", "s_movrel", "s_rfe",
+    "s_setpc", "s_setreg", "s_setvskip", "s_subvector", "s_swappc"
 };
 
-// get instruction size, used by register allocation to skip instruction
-size_t GCNAssembler::getInstructionSize(size_t codeSize, const cxbyte* code) const
+// memory instructions that only read memory
+static const char* gcnSchedLoadTable[] =
 {
-    if (codeSize < 4)
-        return 0; // no instruction
-    bool isGCN11 = (curArchMask & ARCH_RX2X0)!=0;
-    bool isGCN12 = (curArchMask & ARCH_GCN_1_2_4)!=0;
+    "buffer_load", "ds_bpermute", "ds_permute", "ds_read", "ds_swizzle", "flat_load",
+    "global_load", "image_gather", "image_get", "image_load", "image_sample",
+    "s_buffer_load", "s_load", "s_scratch_load", "scratch_load", "tbuffer_load"
+};
+
+// wait counters (used by s_waitcnt) for scheduler
+enum : cxbyte
+{
+    GCNSCHED_VMCNT = 1,
+    GCNSCHED_LGKMCNT = 2,
+    GCNSCHED_EXPCNT = 4
+};
+
+// get memory access flags (load or store) for memory instruction
+static cxbyte getGCNSchedMemFlags(const char* mnemonic, cxbyte memSpace)
+{
+    for (const char* name: gcnSchedLoadTable)
+        if (mnemonicStartsWith(mnemonic, name))
+            return memSpace;
+    return memSpace | ASMSCHEDMEM_STORE;
+}
+
+bool GCNAssembler::getInstrSchedInfo(size_t codeSize, const cxbyte* code,
+            AsmInstrSchedInfo& info) const
+{
+    callOnce(clrxGCNSchedOnceFlag, initializeGCNSchedInfo);
+    info.size = getInstructionSize(codeSize, code);
+    if (info.size == 0 || info.size > codeSize)
+        return false;
+    info.flags = 0;
+    info.memFlags = 0;
+    info.waitCounters = 0;
+    info.issueCycles = 4;
+    info.latency = 4;
+    info.implicitRegsNum = 0;
+    
+    const bool isGCN12 = (curArchMask & ARCH_GCN_1_2_4)!=0;
     const uint32_t insnCode = ULEV(*reinterpret_cast<const uint32_t*>(code));
-    uint32_t words = 1;
-    if ((insnCode & 0x80000000U) != 0)
+    const cxbyte encoding = getGCNEncodingEntry(encTable, insnCode).encoding;
+    cxuint opcode = 0;
+    switch (encoding)
     {
-        if ((insnCode & 0x40000000U) == 0)
+        case GCNENC_VOPC:
+            opcode = (insnCode>>17) & 0xff;
+            break;
+        case GCNENC_VOP1:
+            opcode = (insnCode>>9) & 0xff;
+            break;
+        case GCNENC_VOP2:
+            opcode = (insnCode>>25) & 0x3f;
+            break;
+        case GCNENC_SOP1:
+            opcode = (insnCode>>8) & 0xff;
+            break;
+        case GCNENC_SOPC:
+        case GCNENC_SOPP:
+            opcode = (insnCode>>16) & 0x7f;
+            break;
+        case GCNENC_SOPK:
+            opcode = (insnCode>>23) & 0x1f;
+            break;
+        case GCNENC_SOP2:
+            opcode = (insnCode>>23) & 0x7f;
+            break;
+        case GCNENC_SMRD:
+            opcode = isGCN12 ? (insnCode>>18) & 0xff : (insnCode>>22) & 0x3f;
+            break;
+        case GCNENC_VOP3A:
+            opcode = isGCN12 ? (insnCode>>16) & 0x3ff : (insnCode>>17) & 0x1ff;
+            break;
+        case GCNENC_VINTRP:
+            opcode = (insnCode>>16) & 3;
+            break;
+        case GCNENC_DS:
+            opcode = isGCN12 ? (insnCode>>17) & 0xff : (insnCode>>18) & 0xff;
+            break;
+        case GCNENC_MTBUF:
+            opcode = isGCN12 ? (insnCode>>15) & 0xf : (insnCode>>16) & 7;
+            break;
+        case GCNENC_MUBUF:
+        case GCNENC_MIMG:
+        case GCNENC_FLAT:
+            opcode = (insnCode>>18) & 0x7f;
+            break;
+        default:
+            break;
+    }
+    
+    // find instruction
+    cxuint arch = 0;
+    while ((curArchMask>>arch) > 1) arch++;
+    const GCNInstruction* insn = nullptr;
+    auto it = gcnInstrByCodeMap.find((uint32_t(arch)<<24) |
+                (uint32_t(encoding)<<16) | opcode);
+    if (it == gcnInstrByCodeMap.end() && encoding == GCNENC_VOP3A)
+        it = gcnInstrByCodeMap.find((uint32_t(arch)<<24) |
+                (uint32_t(GCNENC_VOP3B)<<16) | opcode);
+    if (encoding == GCNENC_EXP)
+    {
+        info.flags = ASMSCHED_MEMORY;
+        info.memFlags = ASMSCHEDMEM_EXPORT|ASMSCHEDMEM_STORE;
+        info.waitCounters = GCNSCHED_EXPCNT;
+        info.latency = 16;
+    }
+    else if (it == gcnInstrByCodeMap.end())
+    {
+        // unknown instruction
+        info.flags = ASMSCHED_BARRIER|ASMSCHED_FLOW;
+        return true;
+    }
+    else
+        insn = it->second;
+    
+    auto addImplicitReg = [&info](uint16_t rstart, uint16_t rend, cxbyte rwFlags)
+    { info.implicitRegs[info.implicitRegsNum++] = { rstart, rend, rwFlags }; };
+    const cxbyte readWrite = ASMRVU_READ|ASMRVU_WRITE;
+    // M0 can be read by almost all instructions
+    addImplicitReg(124, 125, ASMRVU_READ);
+    const char* mnemonic = (insn != nullptr) ? insn->mnemonic : "";
+    if (mnemonicStartsWith(mnemonic, "s_set_gpr_idx"))
+    {
+        // indexing of VGPRs changes meaning of register fields
+        info.flags = ASMSCHED_BARRIER|ASMSCHED_FLOW|ASMSCHED_STOP;
+        return true;
+    }
+    switch (encoding)
+    {
+        case GCNENC_SOPP:
         {
-            // SOP???
-            if  ((insnCode & 0x30000000U) == 0x30000000U)
-            {
-                // SOP1/SOPK/SOPC/SOPP
-                const uint32_t encPart = (insnCode & 0x0f800000U);
-                if (encPart == 0x0e800000U)
-                {
-                    // SOP1
-                    if ((insnCode&0xff) == 0xff) // literal
-                        words++;
-                }
-                else if (encPart == 0x0f000000U)
-                {
-                    // SOPC
-                    if ((insnCode&0xff) == 0xff ||
-                        (insnCode&0xff00) == 0xff00) // literal
-                        words++;
-                }
-                else if (encPart != 0x0f800000U)
+            info.flags = ASMSCHED_BARRIER|ASMSCHED_FLOW;
+            for (const char* name: gcnSchedNoFlowSOPPTable)
+                if (::strcmp(mnemonic, name)==0)
+                    info.flags = ASMSCHED_BARRIER;
+            break;
+        }
+        case GCNENC_SOP1:
+        case GCNENC_SOP2:
+        case GCNENC_SOPC:
+        case GCNENC_SOPK:
+            for (const char* name: gcnSchedFlowSALUTable)
+                if (mnemonicStartsWith(mnemonic, name))
                 {
-                    // SOPK
-                    const cxuint opcode = (insnCode>>23)&0x1f;
-                    if ((!isGCN12 && opcode == 21) ||
-                        (isGCN12 && opcode == 20))
-                        words++; // additional literal
+                    info.flags = ASMSCHED_BARRIER|ASMSCHED_FLOW;
+                    return true;
                 }
-            }
+            // moves do not change SCC
+            if (!mnemonicStartsWith(mnemonic, "s_mov"))
+                addImplicitReg(253, 254, readWrite);
+            if (::strstr(mnemonic, "saveexec")!=nullptr)
+                addImplicitReg(126, 128, readWrite);
+            break;
+        case GCNENC_SMRD:
+            if (mnemonicStartsWith(mnemonic, "s_memtime") ||
+                mnemonicStartsWith(mnemonic, "s_memrealtime") ||
+                mnemonicStartsWith(mnemonic, "s_dcache"))
+                info.flags = ASMSCHED_BARRIER;
             else
             {
-                // SOP2
-                if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                    words++;  // literal
+                info.flags = ASMSCHED_MEMORY;
+                info.memFlags = getGCNSchedMemFlags(mnemonic, ASMSCHEDMEM_GLOBAL);
+                info.waitCounters = GCNSCHED_LGKMCNT;
             }
-        }
-        else
+            info.latency = 64;
+            break;
+        case GCNENC_VOPC:
+        case GCNENC_VOP1:
+        case GCNENC_VOP2:
+        case GCNENC_VOP3A:
+        case GCNENC_VOP3B:
+        case GCNENC_VINTRP:
         {
-            // SMRD and others
-            const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-            if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                (isGCN12 && gcnSize12Table[encPart]))
-                words++;
+            if (mnemonicStartsWith(mnemonic, "v_movrel"))
+            {
+                // registers indexed by M0
+                info.flags = ASMSCHED_BARRIER|ASMSCHED_FLOW;
+                return true;
+            }
+            info.latency = 8;
+            const bool cmpx = mnemonicStartsWith(mnemonic, "v_cmpx");
+            addImplicitReg(126, 128, cmpx ? readWrite : ASMRVU_READ);
+            if (encoding == GCNENC_VOPC)
+                addImplicitReg(106, 108, ASMRVU_WRITE);
+            else if (encoding == GCNENC_VOP2)
+            {
+                // implicit VCC in VOP2 encoding
+                const uint16_t mode1 = insn->mode & GCN_MASK1;
+                if (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC_VSRC2)
+                    addImplicitReg(106, 108, readWrite);
+                else if (mode1 == GCN_DST_VCC)
+                    addImplicitReg(106, 108, ASMRVU_WRITE);
+                else if (mode1 == GCN_SRC2_VCC)
+                    addImplicitReg(106, 108, ASMRVU_READ);
+            }
+            else if (mnemonicStartsWith(mnemonic, "v_div_fmas"))
+                addImplicitReg(106, 108, ASMRVU_READ);
+            if (encoding == GCNENC_VINTRP || mnemonicStartsWith(mnemonic, "v_interp"))
+            {
+                info.flags = ASMSCHED_MEMORY; // reads LDS
+                info.memFlags = ASMSCHEDMEM_LOCAL;
+            }
+            break;
         }
+        case GCNENC_DS:
+            info.flags = ASMSCHED_MEMORY;
+            info.memFlags = getGCNSchedMemFlags(mnemonic, ASMSCHEDMEM_LOCAL);
+            info.waitCounters = GCNSCHED_LGKMCNT;
+            info.latency = 64;
+            addImplicitReg(126, 128, ASMRVU_READ);
+            break;
+        case GCNENC_MUBUF:
+        case GCNENC_MTBUF:
+        case GCNENC_MIMG:
+        case GCNENC_FLAT:
+            info.flags = ASMSCHED_MEMORY;
+            info.memFlags = getGCNSchedMemFlags(mnemonic, ASMSCHEDMEM_GLOBAL);
+            // FLAT instructions can access LDS and use also LGKM_CNT
+            if (mnemonicStartsWith(mnemonic, "flat_"))
+            {
+                info.memFlags |= ASMSCHEDMEM_LOCAL;
+                info.waitCounters |= GCNSCHED_LGKMCNT;
+            }
+            // MUBUF with LDS=1 writes loaded data to LDS
+            if (encoding == GCNENC_MUBUF && (insnCode & 0x10000U) != 0)
+                info.memFlags |= ASMSCHEDMEM_LOCAL|ASMSCHEDMEM_STORE;
+            info.waitCounters |= GCNSCHED_VMCNT;
+            // store data are read from VGPRs before EXP_CNT is decremented
+            if ((info.memFlags & ASMSCHEDMEM_STORE) != 0)
+                info.waitCounters |= GCNSCHED_EXPCNT;
+            info.latency = 400;
+            addImplicitReg(126, 128, ASMRVU_READ);
+            break;
+        case GCNENC_EXP:
+            addImplicitReg(126, 128, ASMRVU_READ);
+            break;
+        default:
+            break;
     }
-    else
+    return true;
+}
+
+// put GCN instruction words to output
+static inline void putGCNInstrWords(std::vector<cxbyte>& output, uint32_t word0,
+            uint32_t word1, cxuint wordsNum)
+{
+    uint32_t words[2];
+    SLEV(words[0], word0);
+    SLEV(words[1], word1);
+    output.insert(output.end(), reinterpret_cast<cxbyte*>(words),
+            reinterpret_cast<cxbyte*>(words + wordsNum));
+}
+
+/* spilled SGPRs are held in lanes of VGPRs (v_writelane/v_readlane), spilled VGPRs
+ * are held in scratch buffer (buffer_store_dword/buffer_load_dword).
+ * after reloading, code waits for results (hazards for SGPRs written by VALU) */
+cxuint GCNAssembler::putSpillCode(bool store, bool waitForMemory, size_t spillsNum,
+            const AsmSpill* spills, cxuint laneRegStart, const AsmSpillScratch& scratch,
+            std::vector<cxbyte>& output) const
+{
+    const bool isGCN12 = (curArchMask & ARCH_GCN_1_2_4)!=0;
+    cxuint instrsNum = 0;
+    bool haveSGPRs = false, haveVGPRs = false;
+    if (store && waitForMemory)
     {
-        // some vector instructions
-        if ((insnCode & 0x7e000000U) == 0x7c000000U)
-        {
-            // VOPC
-            if ((insnCode&0x1ff) == 0xff || // literal
-                // SDWA, DDP
-                (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                words++;
-        }
-        else if ((insnCode & 0x7e000000U) == 0x7e000000U)
+        // s_waitcnt vmcnt(0) & expcnt(0) & lgkmcnt(0)
+        putGCNInstrWords(output, 0xbf8c0000U, 0, 1);
+        instrsNum++;
+    }
+    for (size_t i = 0; i < spillsNum; i++)
+    {
+        const AsmSpill& spill = spills[i];
+        if (spill.regType == REGTYPE_SGPR)
         {
-            // VOP1
-            if ((insnCode&0x1ff) == 0xff || // literal
-                // SDWA, DDP
-                (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                words++;
+            // lane select as inline constant
+            const uint32_t lane = 128 + (spill.slot & 63);
+            const uint32_t laneReg = laneRegStart + (spill.slot >> 6);
+            const uint32_t vdst = store ? laneReg : spill.reg;
+            const uint32_t src0 = store ? spill.reg : laneReg + 256;
+            if (isGCN12)
+                // VOP3 v_writelane_b32 or v_readlane_b32
+                putGCNInstrWords(output, 0xd0000000U | ((store ? 650U : 649U)<<16) |
+                        vdst, src0 | (lane<<9), 2);
+            else
+                // VOP2 v_writelane_b32 or v_readlane_b32
+                putGCNInstrWords(output, ((store ? 2U : 1U)<<25) | (vdst<<17) |
+                        (lane<<9) | src0, 0, 1);
+            haveSGPRs = true;
         }
         else
         {
-            // VOP2
-            const cxuint opcode = (insnCode >> 25)&0x3f;
-            if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                (isGCN12 && (opcode == 23 || opcode == 24 ||
-                opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                words++;  // inline 32-bit constant
-            else if ((insnCode&0x1ff) == 0xff || // literal
-                // SDWA, DDP
-                (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                words++;  // literal
+            // buffer_store_dword or buffer_load_dword, offset (not offen)
+            const uint32_t offset = scratch.offset + (spill.slot<<2);
+            const uint32_t opcode = store ? 28U : (isGCN12 ? 20U : 12U);
+            putGCNInstrWords(output, 0xe0000000U | (opcode<<18) | offset,
+                    (uint32_t(spill.reg-256)<<8) | (uint32_t(scratch.srsrc>>2)<<16) |
+                    (uint32_t(scratch.soffset)<<24), 2);
+            haveVGPRs = true;
         }
+        instrsNum++;
+    }
+    if (store && haveVGPRs && !isGCN12)
+    {
+        // s_waitcnt expcnt(0): stored data must be read before overwriting VGPRs
+        putGCNInstrWords(output, 0xbf8c0f0fU, 0, 1);
+        instrsNum++;
+    }
+    if (!store && haveVGPRs)
+    {
+        // s_waitcnt vmcnt(0)
+        putGCNInstrWords(output, 0xbf8c0f70U, 0, 1);
+        instrsNum++;
+    }
+    if (!store && haveSGPRs)
+    {
+        // s_nop 4: SGPRs written by VALU can be read by VMEM after 5 wait states
+        putGCNInstrWords(output, 0xbf800004U, 0, 1);
+        instrsNum++;
     }
-    return words<<2;
+    return instrsNum;
+}
+
+bool GCNAssembler::moveBranchTarget(cxbyte* code, size_t oldOffset, size_t oldTarget,
+            size_t offset, size_t target) const
+{
+    const uint32_t insnCode = ULEV(*reinterpret_cast<const uint32_t*>(code));
+    const cxbyte encoding = getGCNEncodingEntry(encTable, insnCode).encoding;
+    if (encoding != GCNENC_SOPP && encoding != GCNENC_SOPK)
+        return false;
+    // check whether instruction holds this target
+    const int64_t oldValue = int16_t(insnCode & 0xffff);
+    if (int64_t(oldOffset) + 4 + (oldValue<<2) != int64_t(oldTarget))
+        return false;
+    const int64_t value = (int64_t(target)-int64_t(offset)-4) >> 2;
+    if (value > INT16_MAX || value < INT16_MIN)
+        throw AsmException("Jump out of range!");
+    SULEV(*reinterpret_cast<uint16_t*>(code), uint16_t(value));
+    return true;
 }
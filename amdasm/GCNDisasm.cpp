@@ -23,6 +23,8 @@
 #include <cstring>
 #include <mutex>
 #include <memory>
+#include <string>
+#include <vector>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/GPUId.h>
 #include <CLRX/amdasm/Disassembler.h>
@@ -55,71 +57,77 @@ struct CLRX_INTERNAL GCNDisasmUtils
               RelocIter& relocIter, cxuint op, cxuint regNum, uint16_t arch,
               uint32_t literal = 0, FloatLitType floatLit = FLTLIT_NONE);
     
-    static void decodeSOPCEncoding(GCNDisassembler& dasm,
-             size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal);
+    // print operand of decoded instruction (include literal, can print relocations)
+    static char* printDecodedOperand(GCNDisassembler& dasm, size_t codePos,
+              RelocIter& relocIter, const GCNDecodedInstr& instr, cxuint index,
+              uint16_t arch, FloatLitType floatLit = FLTLIT_NONE);
     
-    static void decodeSOPPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode,
-             uint32_t literal, size_t pos);
+    /* routines below print decoded instruction. Raw instruction words are used
+     * only to print values of unused fields */
     
-    static void decodeSOP1Encoding(GCNDisassembler& dasm,
-             size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal);
+    static void printSOPCEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch);
     
-    static void decodeSOP2Encoding(GCNDisassembler& dasm,
+    static void printSOPPEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn, size_t pos);
+    
+    static void printSOP1Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
              size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal);
+             uint32_t insnCode);
     
-    static void decodeSOPKEncoding(GCNDisassembler& dasm,
+    static void printSOP2Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
              size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal);
+             uint32_t insnCode);
     
-    static void decodeSMRDEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
+    static void printSOPKEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
              const GCNInstruction& gcnInsn, uint32_t insnCode);
     
-    static void decodeSMEMEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2);
+    static void printSMRDEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+             uint32_t insnCode);
     
-    static void decodeVOPCEncoding(GCNDisassembler& dasm,
+    static void printSMEMEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+             uint32_t insnCode, uint32_t insnCode2);
+    
+    static void printVOPCEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
              size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal,
-             FloatLitType displayFloatLits);
+             uint32_t insnCode2, FloatLitType displayFloatLits);
     
-    static void decodeVOP1Encoding(GCNDisassembler& dasm,
+    static void printVOP1Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
              size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal,
-             FloatLitType displayFloatLits);
+             uint32_t insnCode, uint32_t insnCode2, FloatLitType displayFloatLits);
     
-    static void decodeVOP2Encoding(GCNDisassembler& dasm,
+    static void printVOP2Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
              size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal,
+             const GCNInstruction& gcnInsn, uint32_t insnCode2,
              FloatLitType displayFloatLits);
     
-    static void decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2,
-             FloatLitType displayFloatLits);
+    static void printVOP3Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+             uint32_t insnCode, uint32_t insnCode2, FloatLitType displayFloatLits);
     
-    static void decodeVINTRPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-             uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode);
+    static void printVINTRPEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch);
     
-    static void decodeDSEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2);
+    static void printDSEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+             uint32_t insnCode2);
     
-    static void decodeMUBUFEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-            uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
-            uint32_t insnCode2);
+    static void printMUBUFEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+             uint32_t insnCode2);
     
-    static void decodeMIMGEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2);
+    static void printMIMGEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, uint32_t insnCode2);
     
-    static void decodeEXPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2);
-
-    static void printFLATAddr(cxuint flatMode, char*& bufPtr, uint32_t insnCode2);
+    static void printEXPEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, uint32_t insnCode2);
     
-    static void decodeFLATEncoding(GCNDisassembler& dasm, cxuint spacesToAdd, uint16_t arch,
-             const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2);
+    static void printFLATEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+             cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+             uint32_t insnCode2);
 };
 
 };
@@ -261,7 +269,13 @@ static void initializeGCNDisassembler()
 }
 
 GCNDisassembler::GCNDisassembler(Disassembler& disassembler)
-        : ISADisassembler(disassembler), instrOutOfCode(false)
+        : ISADisassembler(disassembler), instrOutOfCode(false), threadsNum(1)
+{
+    callOnce(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+}
+
+GCNDisassembler::GCNDisassembler(Disassembler& disassembler, DisasmOutput& output)
+        : ISADisassembler(disassembler, output), instrOutOfCode(false), threadsNum(1)
 {
     callOnce(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
 }
@@ -269,206 +283,154 @@ GCNDisassembler::GCNDisassembler(Disassembler& disassembler)
 GCNDisassembler::~GCNDisassembler()
 { }
 
-// gcn encoding sizes table: true - if 8 byte encoding, false - 4 byte encoding
-// for GCN1.0/1.1
-static const bool gcnSize11Table[16] =
-{
-    false, // GCNENC_SMRD, // 0000
-    false, // GCNENC_SMRD, // 0001
-    false, // GCNENC_VINTRP, // 0010
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_NONE, // 0101 - illegal
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    true,  // GCNENC_EXP,   // 1110
-    false // GCNENC_NONE   // 1111 - illegal
-};
+ISADisassembler* GCNDisassembler::createInstance(DisasmOutput& output) const
+{
+    return new GCNDisassembler(disassembler, output);
+}
 
-// for GCN1.2/1.4
-static const bool gcnSize12Table[16] =
-{
-    true,  // GCNENC_SMEM, // 0000
-    true,  // GCNENC_EXP, // 0001
-    false, // GCNENC_NONE, // 0010 - illegal
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_VINTRP, // 0101
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    false, // GCNENC_NONE,  // 1110 - illegal
-    false // GCNENC_NONE   // 1111 - illegal
+// minimal number of code words in chunk (in parallel disassembling)
+static const size_t gcnMinChunkWordsNum = 1024;
+
+// GCN code analyzer (finds jumps and boundaries of instructions)
+struct CLRX_INTERNAL GCNCodeAnalyzer
+{
+    const uint32_t* codeWords;
+    size_t codeWordsNum;
+    size_t startOffset;
+    const GCNEncodingEntry* encTable;
+    bool isGCN11;
+    bool isGCN12;
+    bool isGCN14;
+    
+    GCNCodeAnalyzer(const cxbyte* input, size_t inputSize, size_t _startOffset,
+            GPUArchitecture arch) : codeWords(reinterpret_cast<const uint32_t*>(input)),
+            codeWordsNum(inputSize>>2), startOffset(_startOffset),
+            encTable(getGCNEncodingTable(arch)), isGCN11(arch == GPUArchitecture::GCN1_1),
+            isGCN12(arch >= GPUArchitecture::GCN1_2),
+            isGCN14(arch == GPUArchitecture::GCN1_4)
+    { }
+    
+    // analyze instruction at position, returns position of next instruction
+    // jumpTarget is SIZE_MAX if instruction is not jump
+    size_t analyzeInstr(size_t pos, size_t& jumpTarget) const;
+    
+    // analyze code in chunks in parallel, stores true instruction boundaries
+    // (first instruction at or after guessed chunk start) to chunkStarts,
+    // adds jump targets to labels of dasm (if not null). returns end of last instruction
+    size_t analyzeInChunks(cxuint threadsNum, std::vector<size_t>& chunkStarts,
+                ISADisassembler* dasm) const;
 };
 
-void GCNDisassembler::analyzeBeforeDisassemble()
+inline size_t GCNCodeAnalyzer::analyzeInstr(size_t pos, size_t& jumpTarget) const
 {
-    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(input);
-    const size_t codeWordsNum = (inputSize>>2);
+    jumpTarget = SIZE_MAX;
+    const uint32_t insnCode = ULEV(codeWords[pos]);
+    const GCNEncodingEntry& encEntry = getGCNEncodingEntry(encTable, insnCode);
+    if (encEntry.encoding == GCNENC_SOPP)
+    {
+        const cxuint opcode = (insnCode>>16)&0x7f;
+        if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
+            // GCN1.1 and GCN1.2 opcodes
+            ((isGCN11 || isGCN12) &&
+                    (opcode >= 23 && opcode <= 26))) // if jump
+            jumpTarget = startOffset + ((pos+int16_t(insnCode&0xffff)+1)<<2);
+    }
+    else if (encEntry.encoding == GCNENC_SOPK)
+    {
+        const cxuint opcode = (insnCode>>23)&0x1f;
+        if ((!isGCN12 && opcode == 17) ||
+            (isGCN12 && opcode == 16) || // if branch fork
+            (isGCN14 && opcode == 21)) // if s_call_b64
+            jumpTarget = startOffset + ((pos+int16_t(insnCode&0xffff)+1)<<2);
+    }
+    // skip literal, SDWA, DPP or second dword
+    return pos + getGCNInstrWordsNum(encEntry, insnCode);
+}
 
-    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
-                disassembler.getDeviceType());
-    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
-    const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
-    const bool isGCN14 = (arch == GPUArchitecture::GCN1_4);
-    size_t pos;
-    for (pos = 0; pos < codeWordsNum; pos++)
-    {
-        /* scan all instructions and get jump addresses */
-        const uint32_t insnCode = ULEV(codeWords[pos]);
-        if ((insnCode & 0x80000000U) != 0)
+size_t GCNCodeAnalyzer::analyzeInChunks(cxuint threadsNum,
+            std::vector<size_t>& chunkStarts, ISADisassembler* dasm) const
+{
+    const size_t chunksNum = std::max(size_t(1), std::min(size_t(threadsNum)*4,
+                codeWordsNum / gcnMinChunkWordsNum));
+    // speculative analysis: every chunk is decoded from its guessed start
+    std::vector<std::vector<std::pair<size_t, size_t> > > chunkJumps(chunksNum);
+    std::vector<size_t> chunkEnds(chunksNum);
+    runParallel(chunksNum, threadsNum, [&](size_t k)
+    {
+        const size_t chunkEnd = (k+1)*codeWordsNum / chunksNum;
+        size_t pos = k*codeWordsNum / chunksNum;
+        while (pos < chunkEnd)
         {
-            if ((insnCode & 0x40000000U) == 0)
-            {
-                // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {
-                    // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {
-                        // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                            pos++;
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {
-                        // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                            pos++;
-                    }
-                    else if (encPart == 0x0f800000U)
-                    {
-                        // SOPP
-                        const cxuint opcode = (insnCode>>16)&0x7f;
-                        if (opcode == 2 || (opcode >= 4 && opcode <= 9) ||
-                            // GCN1.1 and GCN1.2 opcodes
-                            ((isGCN11 || isGCN12) &&
-                                    (opcode >= 23 && opcode <= 26))) // if jump
-                            labels.push_back(startOffset +
-                                    ((pos+int16_t(insnCode&0xffff)+1)<<2));
-                    }
-                    else
-                    {
-                        // SOPK
-                        const cxuint opcode = (insnCode>>23)&0x1f;
-                        if ((!isGCN12 && opcode == 17) ||
-                            (isGCN12 && opcode == 16) || // if branch fork
-                            (isGCN14 && opcode == 21)) // if s_call_b64
-                            labels.push_back(startOffset +
-                                    ((pos+int16_t(insnCode&0xffff)+1)<<2));
-                        else if ((!isGCN12 && opcode == 21) ||
-                            (isGCN12 && opcode == 20))
-                            pos++; // additional literal
-                    }
-                }
-                else
-                {
-                    // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                        pos++;  // literal
-                }
-            }
-            else
-            {
-                // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN12 && gcnSize12Table[encPart]))
-                    pos++;
-            }
+            size_t jumpTarget;
+            const size_t nextPos = analyzeInstr(pos, jumpTarget);
+            if (dasm != nullptr && jumpTarget != SIZE_MAX)
+                chunkJumps[k].push_back(std::make_pair(pos, jumpTarget));
+            pos = nextPos;
         }
-        else
+        chunkEnds[k] = pos;
+    });
+    
+    // resynchronize chunk joins: decode from true end of previous chunk
+    // until instruction boundary is same as in speculative decoding
+    chunkStarts.resize(chunksNum);
+    size_t truePos = 0;
+    for (size_t k = 0; k < chunksNum; k++)
+    {
+        const size_t chunkEnd = (k+1)*codeWordsNum / chunksNum;
+        size_t specPos = k*codeWordsNum / chunksNum;
+        chunkStarts[k] = truePos;
+        while (truePos < chunkEnd && truePos != specPos)
         {
-            // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {
-                // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {
-                // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;
-            }
+            size_t jumpTarget;
+            if (specPos < truePos)
+                specPos = analyzeInstr(specPos, jumpTarget);
             else
             {
-                // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN12 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                    pos++;  // inline 32-bit constant
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    pos++;  // literal
+                truePos = analyzeInstr(truePos, jumpTarget);
+                if (dasm != nullptr && jumpTarget != SIZE_MAX)
+                    dasm->addLabel(jumpTarget);
             }
         }
+        if (truePos >= chunkEnd)
+            continue; // not synchronized, whole chunk decoded again
+        // synchronized: speculative decoding is valid from truePos
+        if (dasm != nullptr)
+            for (const auto& jump: chunkJumps[k])
+                if (jump.first >= truePos)
+                    dasm->addLabel(jump.second);
+        truePos = chunkEnds[k];
+    }
+    return truePos;
+}
+
+void GCNDisassembler::analyzeBeforeDisassemble()
+{
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                disassembler.getDeviceType());
+    const GCNCodeAnalyzer analyzer(input, inputSize, startOffset, arch);
+    const size_t codeWordsNum = analyzer.codeWordsNum;
+    const cxuint chunkThreadsNum = (threadsNum != 0) ? threadsNum :
+                getHardwareThreadsNum();
+    extendLabelBitmap();
+    size_t pos;
+    if (chunkThreadsNum > 1 && codeWordsNum >= 2*gcnMinChunkWordsNum)
+    {
+        std::vector<size_t> chunkStarts;
+        pos = analyzer.analyzeInChunks(chunkThreadsNum, chunkStarts, this);
     }
+    else
+        for (pos = 0; pos < codeWordsNum;)
+        {
+            /* scan all instructions and get jump addresses */
+            size_t jumpTarget;
+            pos = analyzer.analyzeInstr(pos, jumpTarget);
+            if (jumpTarget != SIZE_MAX)
+                addLabel(jumpTarget);
+        }
     
     instrOutOfCode = (pos != codeWordsNum);
 }
 
-static const cxbyte gcnEncoding11Table[16] =
-{
-    GCNENC_SMRD, // 0000
-    GCNENC_SMRD, // 0001
-    GCNENC_VINTRP, // 0010
-    GCNENC_NONE, // 0011 - illegal
-    GCNENC_VOP3A, // 0100
-    GCNENC_NONE, // 0101 - illegal
-    GCNENC_DS,   // 0110
-    GCNENC_FLAT, // 0111
-    GCNENC_MUBUF, // 1000
-    GCNENC_NONE,  // 1001 - illegal
-    GCNENC_MTBUF, // 1010
-    GCNENC_NONE,  // 1011 - illegal
-    GCNENC_MIMG,  // 1100
-    GCNENC_NONE,  // 1101 - illegal
-    GCNENC_EXP,   // 1110
-    GCNENC_NONE   // 1111 - illegal
-};
-
-static const cxbyte gcnEncoding12Table[16] =
-{
-    GCNENC_SMEM, // 0000
-    GCNENC_EXP, // 0001
-    GCNENC_NONE, // 0010 - illegal
-    GCNENC_NONE, // 0011 - illegal
-    GCNENC_VOP3A, // 0100
-    GCNENC_VINTRP, // 0101
-    GCNENC_DS,   // 0110
-    GCNENC_FLAT, // 0111
-    GCNENC_MUBUF, // 1000
-    GCNENC_NONE,  // 1001 - illegal
-    GCNENC_MTBUF, // 1010
-    GCNENC_NONE,  // 1011 - illegal
-    GCNENC_MIMG,  // 1100
-    GCNENC_NONE,  // 1101 - illegal
-    GCNENC_NONE,  // 1110 - illegal
-    GCNENC_NONE   // 1111 - illegal
-};
-
-
 struct CLRX_INTERNAL GCNEncodingOpcodeBits
 {
     cxbyte bitPos;
@@ -588,12 +550,6 @@ static void regRanges(cxuint op, cxuint vregNum, char*& bufPtr)
     }
 }
 
-static void decodeGCNVRegOperand(cxuint op, cxuint vregNum, char*& bufPtr)
-{
-    *bufPtr++ = 'v';
-    return regRanges(op, vregNum, bufPtr);
-}
-
 /* parameters: dasm - disassembler, codePos - code position for relocation,
  * relocIter, optional - if literal is optional (can be replaced by inline constant) */
 void GCNDisasmUtils::printLiteral(GCNDisassembler& dasm, size_t codePos,
@@ -602,7 +558,7 @@ void GCNDisasmUtils::printLiteral(GCNDisassembler& dasm, size_t codePos,
     // if with relocation, just write
     if (dasm.writeRelocation(dasm.startOffset + (codePos<<2)-4, relocIter))
         return;
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(50);
     char* bufPtr = bufStart;
     if (optional && (int32_t(literal)<=64 && int32_t(literal)>=-16)) // use lit(...)
@@ -630,8 +586,9 @@ void GCNDisasmUtils::printLiteral(GCNDisassembler& dasm, size_t codePos,
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeGCNOperandNoLit(GCNDisassembler& dasm, cxuint op,
-           cxuint regNum, char*& bufPtr, uint16_t arch, FloatLitType floatLit)
+// print operand (without literal) to buffer (used also by GCNDecoder)
+static void printGCNOperandNoLit(cxuint op, cxuint regNum, char*& bufPtr,
+           uint16_t arch, FloatLitType floatLit, Flags disasmFlags)
 {
     const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
     const bool isGCN14 = ((arch&ARCH_RXVEGA)!=0);
@@ -762,7 +719,6 @@ void GCNDisasmUtils::decodeGCNOperandNoLit(GCNDisassembler& dasm, cxuint op,
         return;
     }
     
-    Flags disasmFlags = dasm.disassembler.getFlags();
     if (op >= 240 && op < 248)
     {
         const char* inOp = gcnOperandFloatTable[op-240];
@@ -832,11 +788,18 @@ void GCNDisasmUtils::decodeGCNOperandNoLit(GCNDisassembler& dasm, cxuint op,
     *bufPtr++ = '0'+op%10U;
 }
 
+void GCNDisasmUtils::decodeGCNOperandNoLit(GCNDisassembler& dasm, cxuint op,
+           cxuint regNum, char*& bufPtr, uint16_t arch, FloatLitType floatLit)
+{
+    printGCNOperandNoLit(op, regNum, bufPtr, arch, floatLit,
+                dasm.disassembler.getFlags());
+}
+
 char* GCNDisasmUtils::decodeGCNOperand(GCNDisassembler& dasm, size_t codePos,
               RelocIter& relocIter, cxuint op, cxuint regNum, uint16_t arch,
               uint32_t literal, FloatLitType floatLit)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     if (op == 255)
     {
         // if literal
@@ -850,6 +813,44 @@ char* GCNDisasmUtils::decodeGCNOperand(GCNDisassembler& dasm, size_t codePos,
     return output.reserve(100);
 }
 
+char* GCNDisasmUtils::printDecodedOperand(GCNDisassembler& dasm, size_t codePos,
+              RelocIter& relocIter, const GCNDecodedInstr& instr, cxuint index,
+              uint16_t arch, FloatLitType floatLit)
+{
+    const GCNDecodedOperand& op = instr.operands[index];
+    return decodeGCNOperand(dasm, codePos, relocIter, op.code, op.regsNum, arch,
+                instr.literal, floatLit);
+}
+
+// print operand of decoded instruction (without literal) to buffer
+static inline void printDecodedOperandNoLit(GCNDisassembler& dasm,
+            const GCNDecodedInstr& instr, cxuint index, char*& bufPtr, uint16_t arch,
+            FloatLitType floatLit = FLTLIT_NONE)
+{
+    GCNDisasmUtils::decodeGCNOperandNoLit(dasm, instr.operands[index].code,
+                instr.operands[index].regsNum, bufPtr, arch, floatLit);
+}
+
+// put sext, negation and abs before operand (by GCNDOP_* flags)
+static inline void putOperandModsBegin(cxbyte flags, char*& bufPtr)
+{
+    if (flags & GCNDOP_SEXT)
+        putChars(bufPtr, "sext(", 5);
+    if (flags & GCNDOP_NEG)
+        *bufPtr++ = '-';
+    if (flags & GCNDOP_ABS)
+        putChars(bufPtr, "abs(", 4);
+}
+
+// put closing of abs and sext after operand
+static inline void putOperandModsEnd(cxbyte flags, char*& bufPtr)
+{
+    if (flags & GCNDOP_ABS)
+        *bufPtr++ = ')';
+    if (flags & GCNDOP_SEXT)
+        *bufPtr++ = ')';
+}
+
 // table of values sendmsg
 static const char* sendMsgCodeMessageTable[16] =
 {
@@ -898,45 +899,41 @@ static size_t addSpacesOld(char* bufPtr, cxuint spacesToAdd)
     return spacesToAdd;
 }
 
-void GCNDisasmUtils::decodeSOPCEncoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal)
+void GCNDisasmUtils::printSOPCEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(90);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
     output.forward(bufPtr-bufStart);
     
     // form: INSTR SRC0, SRC1
-    bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, insnCode&0xff,
-                     (gcnInsn.mode&GCN_REG_SRC0_64)?2:1, arch, literal);
+    bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr, 0, arch);
     *bufPtr++ = ',';
     *bufPtr++ = ' ';
-    if ((gcnInsn.mode & GCN_SRC1_IMM) != 0)
+    if (instr.operandsNum < 2)
     {
         // if immediate in SRC1
-        putHexByteToBuf((insnCode>>8)&0xff, bufPtr);
+        putHexByteToBuf(instr.imm, bufPtr);
         output.forward(bufPtr-bufStart);
     }
     else
     {
         output.forward(bufPtr-bufStart);
-        decodeGCNOperand(dasm, codePos, relocIter, (insnCode>>8)&0xff,
-               (gcnInsn.mode&GCN_REG_SRC1_64)?2:1, arch, literal);
+        printDecodedOperand(dasm, codePos, relocIter, instr, 1, arch);
     }
 }
 
 /// about label writer - label is workaround for class hermetization
-void GCNDisasmUtils::decodeSOPPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-         uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
-         uint32_t literal, size_t pos)
+void GCNDisasmUtils::printSOPPEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn, size_t pos)
 {
     const bool isGCN14 = ((arch&ARCH_RXVEGA)!=0);
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(70);
     char* bufPtr = bufStart;
-    const cxuint imm16 = insnCode&0xffff;
+    const cxuint imm16 = instr.imm;
     switch(gcnInsn.mode&GCN_MASK1)
     {
         case GCN_IMM_REL:
@@ -1082,26 +1079,26 @@ void GCNDisasmUtils::decodeSOPPEncoding(GCNDisassembler& dasm, cxuint spacesToAd
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeSOP1Encoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal)
+void GCNDisasmUtils::printSOP1Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
+         uint32_t insnCode)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(80);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
-    bool isDst = (gcnInsn.mode & GCN_MASK1) != GCN_DST_NONE;
+    const bool isDst = instr.operandsNum != 0 && (instr.operands[0].flags & GCNDOP_DST);
+    const cxuint srcIndex = isDst ? 1 : 0;
     // print destination if instruction have it
     if (isDst)
     {
         output.forward(bufPtr-bufStart);
-        bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, (insnCode>>16)&0x7f,
-                         (gcnInsn.mode&GCN_REG_DST_64)?2:1, arch);
+        bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr, 0, arch);
     }
     
-    if ((gcnInsn.mode & GCN_MASK1) != GCN_SRC_NONE)
+    if (srcIndex < instr.operandsNum)
     {
-        if ((gcnInsn.mode & GCN_MASK1) != GCN_DST_NONE)
+        if (isDst)
         {
             // put ',' if destination and source
             *bufPtr++ = ',';
@@ -1109,8 +1106,8 @@ void GCNDisasmUtils::decodeSOP1Encoding(GCNDisassembler& dasm, size_t codePos,
         }
         // put SRC1
         output.forward(bufPtr-bufStart);
-        bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, insnCode&0xff,
-                         (gcnInsn.mode&GCN_REG_SRC0_64)?2:1, arch, literal);
+        bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr,
+                    srcIndex, arch);
     }
     else if ((insnCode&0xff) != 0)
     {
@@ -1127,36 +1124,37 @@ void GCNDisasmUtils::decodeSOP1Encoding(GCNDisassembler& dasm, size_t codePos,
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeSOP2Encoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal)
+void GCNDisasmUtils::printSOP2Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
+         uint32_t insnCode)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(90);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
-    if ((gcnInsn.mode & GCN_MASK1) != GCN_DST_NONE)
+    const bool isDst = (instr.operands[0].flags & GCNDOP_DST) != 0;
+    if (isDst)
     {
         // print destination
         output.forward(bufPtr-bufStart);
-        bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, (insnCode>>16)&0x7f,
-                         (gcnInsn.mode&GCN_REG_DST_64)?2:1, arch);
+        bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr, 0, arch);
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
     }
+    const cxuint srcIndex = isDst ? 1 : 0;
     // print SRC0
     output.forward(bufPtr-bufStart);
-    bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, insnCode&0xff,
-                     (gcnInsn.mode&GCN_REG_SRC0_64)?2:1, arch, literal);
+    bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr,
+                srcIndex, arch);
     *bufPtr++ = ',';
     *bufPtr++ = ' ';
     // print SRC1
     output.forward(bufPtr-bufStart);
-    bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, (insnCode>>8)&0xff,
-                 (gcnInsn.mode&GCN_REG_SRC1_64)?2:1, arch, literal);
+    bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr,
+                srcIndex+1, arch);
     
     // print value, if some are not used, but values is not default
-    if ((gcnInsn.mode & GCN_MASK1) == GCN_DST_NONE && ((insnCode>>16)&0x7f) != 0)
+    if (!isDst && ((insnCode>>16)&0x7f) != 0)
     {
         putChars(bufPtr, " sdst=", 6);
         bufPtr += itocstrCStyle(((insnCode>>16)&0x7f), bufPtr, 6, 16);
@@ -1176,11 +1174,11 @@ static const char* hwregNames[20] =
 };
 
 /// about label writer - label is workaround for class hermetization
-void GCNDisasmUtils::decodeSOPKEncoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal)
+void GCNDisasmUtils::printSOPKEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
+         const GCNInstruction& gcnInsn, uint32_t insnCode)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(90);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
@@ -1188,12 +1186,11 @@ void GCNDisasmUtils::decodeSOPKEncoding(GCNDisassembler& dasm, size_t codePos,
     {
         // if normal destination
         output.forward(bufPtr-bufStart);
-        bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter, (insnCode>>16)&0x7f,
-                         (gcnInsn.mode&GCN_REG_DST_64)?2:1, arch);
+        bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr, 0, arch);
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
     }
-    const cxuint imm16 = insnCode&0xffff;
+    const cxuint imm16 = instr.imm;
     if ((gcnInsn.mode&GCN_MASK1) == GCN_IMM_REL)
     {
         // print relative address (as label)
@@ -1241,7 +1238,7 @@ void GCNDisasmUtils::decodeSOPKEncoding(GCNDisassembler& dasm, size_t codePos,
         if (gcnInsn.mode & GCN_SOPK_CONST)
         {
             // for S_SETREG_IMM32_B32
-            bufPtr += itocstrCStyle(literal, bufPtr, 11, 16);
+            bufPtr += itocstrCStyle(instr.literal, bufPtr, 11, 16);
             if (((insnCode>>16)&0x7f) != 0)
             {
                 putChars(bufPtr, " sdst=", 6);
@@ -1252,17 +1249,18 @@ void GCNDisasmUtils::decodeSOPKEncoding(GCNDisassembler& dasm, size_t codePos,
         {
             // for s_setreg_b32, print destination as source
             output.forward(bufPtr-bufStart);
-            bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter,
-                     (insnCode>>16)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1, arch);
+            bufPtr = bufStart = printDecodedOperand(dasm, codePos, relocIter, instr,
+                        0, arch);
         }
     }
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeSMRDEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-             uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode)
+void GCNDisasmUtils::printSMRDEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+         uint32_t insnCode)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(100);
     char* bufPtr = bufStart;
     const uint16_t mode1 = (gcnInsn.mode & GCN_MASK1);
@@ -1274,28 +1272,25 @@ void GCNDisasmUtils::decodeSMRDEncoding(GCNDisassembler& dasm, cxuint spacesToAd
     {
         // print only destination
         addSpaces(bufPtr, spacesToAdd);
-        decodeGCNOperandNoLit(dasm, (insnCode>>15)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1,
-                         bufPtr, arch);
+        printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
         useDst = true;
         spacesAdded = true;
     }
     else if (mode1 != GCN_ARG_NONE)
     {
-        const cxuint dregsNum = 1<<((gcnInsn.mode & GCN_DSIZE_MASK)>>GCN_SHIFT2);
         addSpaces(bufPtr, spacesToAdd);
         // print destination (1,2,4,8 or 16 registers)
-        decodeGCNOperandNoLit(dasm, (insnCode>>15)&0x7f, dregsNum, bufPtr, arch);
+        printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
         // print SBASE (base address registers) (address or resource)
-        decodeGCNOperandNoLit(dasm, (insnCode>>8)&0x7e, (gcnInsn.mode&GCN_SBASE4)?4:2,
-                          bufPtr, arch);
+        printDecodedOperandNoLit(dasm, instr, 1, bufPtr, arch);
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
-        if (insnCode&0x100) // immediate value
-            bufPtr += itocstrCStyle(insnCode&0xff, bufPtr, 11, 16);
+        if (instr.modifiers & GCNDMOD_IMM_OFFSET) // immediate value
+            bufPtr += itocstrCStyle(instr.imm, bufPtr, 11, 16);
         else // S register
-            decodeGCNOperandNoLit(dasm, insnCode&0xff, 1, bufPtr, arch);
+            printDecodedOperandNoLit(dasm, instr, 2, bufPtr, arch);
         // set what is printed
         useDst = true;
         useOthers = true;
@@ -1336,76 +1331,59 @@ void GCNDisasmUtils::decodeSMRDEncoding(GCNDisassembler& dasm, cxuint spacesToAd
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeSMEMEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-         uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
-         uint32_t insnCode2)
+void GCNDisasmUtils::printSMEMEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+         uint32_t insnCode, uint32_t insnCode2)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(120);
     char* bufPtr = bufStart;
     const uint16_t mode1 = (gcnInsn.mode & GCN_MASK1);
     bool useDst = false;
     bool useOthers = false;
     bool spacesAdded = false;
-    const bool isGCN14 = ((arch&ARCH_RXVEGA) != 0);
     bool printOffset = false;
     
     if (mode1 == GCN_SMRD_ONLYDST)
     {
         // print only destination
         addSpaces(bufPtr, spacesToAdd);
-        decodeGCNOperandNoLit(dasm, (insnCode>>6)&0x7f, (gcnInsn.mode&GCN_REG_DST_64)?2:1,
-                         bufPtr, arch);
+        printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
         useDst = true;
         spacesAdded = true;
     }
     else if (mode1 != GCN_ARG_NONE)
     {
-        const cxuint dregsNum = 1<<((gcnInsn.mode & GCN_DSIZE_MASK)>>GCN_SHIFT2);
+        cxuint opIndex = 0;
         addSpaces(bufPtr, spacesToAdd);
         if (!(mode1 & GCN_SMEM_NOSDATA)) {
             if (mode1 & GCN_SMEM_SDATA_IMM)
                 // print immediate value
-                putHexByteToBuf((insnCode>>6)&0x7f, bufPtr);
+                putHexByteToBuf(instr.mask, bufPtr);
             else
                 // print destination (1,2,4,8 or 16 registers)
-                decodeGCNOperandNoLit(dasm, (insnCode>>6)&0x7f, dregsNum, bufPtr , arch);
+                printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
             *bufPtr++ = ',';
             *bufPtr++ = ' ';
             useDst = true;
         }
         // print SBASE (base address registers) (address or resource)
-        decodeGCNOperandNoLit(dasm, (insnCode<<1)&0x7e, (gcnInsn.mode&GCN_SBASE4)?4:2,
-                          bufPtr, arch);
+        printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
-        if (insnCode&0x20000) // immediate value
-        {
-            if (isGCN14 && (insnCode & 0x4000) != 0)
-            {
-                // last 8-bit in second dword
-                decodeGCNOperandNoLit(dasm, (insnCode2>>25), 1, bufPtr , arch);
-                printOffset = true;
-            }
-            else
-            {
-                // print SOFFSET
-                uint32_t immMask =  isGCN14 ? 0x1fffff : 0xfffff;
-                bufPtr += itocstrCStyle(insnCode2 & immMask, bufPtr, 11, 16);
-            }
-        }
-        else // SOFFSET register
+        if (opIndex < instr.operandsNum)
         {
-            if (isGCN14 && (insnCode & 0x4000) != 0)
-                decodeGCNOperandNoLit(dasm, insnCode2>>25, 1, bufPtr, arch);
-            else
-                decodeGCNOperandNoLit(dasm, insnCode2&0xff, 1, bufPtr, arch);
+            // print SOFFSET, if also immediate then print it as offset modifier
+            printDecodedOperandNoLit(dasm, instr, opIndex, bufPtr, arch);
+            printOffset = (instr.modifiers & GCNDMOD_IMM_OFFSET) != 0;
         }
+        else // immediate value
+            bufPtr += itocstrCStyle(instr.imm, bufPtr, 11, 16);
         useOthers = true;
         spacesAdded = true;
     }
     
-    if ((insnCode & 0x10000) != 0)
+    if ((instr.modifiers & GCNDMOD_GLC) != 0)
     {
         if (!spacesAdded)
             addSpaces(bufPtr, spacesToAdd-1);
@@ -1414,7 +1392,7 @@ void GCNDisasmUtils::decodeSMEMEncoding(GCNDisassembler& dasm, cxuint spacesToAd
         putChars(bufPtr, " glc", 4);
     }
     
-    if (isGCN14 && (insnCode & 0x8000) != 0)
+    if ((instr.modifiers & GCNDMOD_NV) != 0)
     {
         if (!spacesAdded)
             addSpaces(bufPtr, spacesToAdd-1);
@@ -1430,7 +1408,7 @@ void GCNDisasmUtils::decodeSMEMEncoding(GCNDisassembler& dasm, cxuint spacesToAd
             addSpaces(bufPtr, spacesToAdd-1);
         spacesAdded = true;
         putChars(bufPtr, " offset:", 8);
-        bufPtr += itocstrCStyle(insnCode2 & 0x1fffff, bufPtr, 11, 16);
+        bufPtr += itocstrCStyle(instr.imm, bufPtr, 11, 16);
     }
     
     // print value, if some are not used, but values is not default
@@ -1505,34 +1483,29 @@ static inline VOPExtraWordOut decodeVOPSDWAFlags(uint32_t insnCode2, uint16_t ar
         isGCN14 && ((insnCode2&(1U<<31))!=0) };
 }
 
-// decode and print VOP SDWA encoding
-static void decodeVOPSDWA(FastOutputBuffer& output, uint16_t arch, uint32_t insnCode2,
-          bool src0Used, bool src1Used, bool vopc = false)
+// print VOP SDWA modifiers of decoded instruction
+static void printVOPSDWA(DisasmOutputBuffer& output, uint16_t arch,
+          const GCNDecodedInstr& instr, uint32_t insnCode2, bool src0Used, bool src1Used,
+          bool vopc = false)
 {
     char* bufStart = output.reserve(100);
     char* bufPtr = bufStart;
     const bool isGCN14 = ((arch&ARCH_RXVEGA) != 0);
-    cxuint dstSel = 6;
-    cxuint dstUnused = 0;
-    if (!isGCN14 || !vopc)
-    {
-        // not VEGA or not VOPC
-        dstSel = (insnCode2>>8)&7;
-        dstUnused = (insnCode2>>11)&3;
-    }
-    const cxuint src0Sel = (insnCode2>>16)&7;
-    const cxuint src1Sel = (insnCode2>>24)&7;
+    const cxuint dstSel = instr.sdwa.dstSel;
+    const cxuint dstUnused = instr.sdwa.dstUnused;
+    const cxuint src0Sel = instr.sdwa.src0Sel;
+    const cxuint src1Sel = instr.sdwa.src1Sel;
     
     if (!isGCN14 || !vopc)
     {
         // not VEGA or not VOPC
-        if (isGCN14 && (insnCode2 & 0xc000U) != 0)
+        if (instr.omod != 0)
         {
-            cxuint omod = (insnCode2>>14)&3;
-            const char* omodStr = (omod==3)?" div:2":(omod==2)?" mul:4":" mul:2";
+            const char* omodStr = (instr.omod==3)?" div:2":(instr.omod==2)?" mul:4":
+                        " mul:2";
             putChars(bufPtr, omodStr, 6);
         }
-        if (insnCode2 & 0x2000)
+        if (instr.modifiers & GCNDMOD_CLAMP)
             putChars(bufPtr, " clamp", 6);
         
         // print dst_sel:XXXX
@@ -1609,12 +1582,13 @@ static inline VOPExtraWordOut decodeVOPDPPFlags(uint32_t insnCode2)
         false, (insnCode2&(1U<<22))!=0, (insnCode2&(1U<<23))!=0, false };
 }
 
-static void decodeVOPDPP(FastOutputBuffer& output, uint32_t insnCode2,
-        bool src0Used, bool src1Used)
+// print VOP DPP modifiers of decoded instruction
+static void printVOPDPP(DisasmOutputBuffer& output, const GCNDecodedInstr& instr,
+        uint32_t insnCode2, bool src0Used, bool src1Used)
 {
     char* bufStart = output.reserve(110);
     char* bufPtr = bufStart;
-    const cxuint dppCtrl = (insnCode2>>8)&0x1ff;
+    const cxuint dppCtrl = instr.dpp.dppCtrl;
     
     if (dppCtrl<256)
     {
@@ -1652,14 +1626,14 @@ static void decodeVOPDPP(FastOutputBuffer& output, uint32_t insnCode2,
         bufPtr += itocstrCStyle(dppCtrl, bufPtr, 10, 16);
     }
     
-    if (insnCode2 & (0x80000U)) // bound ctrl
+    if (instr.modifiers & GCNDMOD_BOUND_CTRL) // bound ctrl
         putChars(bufPtr, " bound_ctrl", 11);
     
     // print bank_mask and row_mask
     putChars(bufPtr, " bank_mask:", 11);
-    putByteToBuf((insnCode2>>24)&0xf, bufPtr);
+    putByteToBuf(instr.dpp.bankMask, bufPtr);
     putChars(bufPtr, " row_mask:", 10);
-    putByteToBuf((insnCode2>>28)&0xf, bufPtr);
+    putByteToBuf(instr.dpp.rowMask, bufPtr);
     // unused but fields
     if (!src0Used)
     {
@@ -1679,152 +1653,69 @@ static void decodeVOPDPP(FastOutputBuffer& output, uint32_t insnCode2,
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeVOPCEncoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal,
-         FloatLitType displayFloatLits)
+void GCNDisasmUtils::printVOPCEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
+         uint32_t insnCode2, FloatLitType displayFloatLits)
 {
-    FastOutputBuffer& output = dasm.output;
-    const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(120);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
     
-    const cxuint src0Field = (insnCode&0x1ff);
-    // extra flags are zeroed by default
-    VOPExtraWordOut extraFlags = { 0, 0, 0, 0, 0, 0, 0 };
-    if ((arch & ARCH_RXVEGA) != 0 && src0Field==0xf9 && (literal & 0x8000) != 0)
-    {
-        // SDWAB replacement of SDST
-        output.forward(bufPtr-bufStart);
-        bufPtr = bufStart = decodeGCNOperand(dasm, codePos, relocIter,
-                            (literal>>8)&0x7f, 2, arch);
-        *bufPtr++ = ',';
-        *bufPtr++ = ' ';
-    }
-    else // just vcc
-        putChars(bufPtr, "vcc, ", 5);
-    
-    if (isGCN12)
-    {
-        // return VOP SDWA/DPP flags for operands
-        if (src0Field == 0xf9)
-            extraFlags = decodeVOPSDWAFlags(literal, arch);
-        else if (src0Field == 0xfa)
-            extraFlags = decodeVOPDPPFlags(literal);
-        else
-            extraFlags.src0 = src0Field;
-    }
-    else
-        extraFlags.src0 = src0Field;
-    
+    // print SDST (VCC or SDWAB replacement of SDST)
+    printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
+    *bufPtr++ = ',';
+    *bufPtr++ = ' ';
     // apply sext(), negation and abs() if applied
-    if (extraFlags.sextSrc0)
-        putChars(bufPtr, "sext(", 5);
-    if (extraFlags.negSrc0)
-        *bufPtr++ = '-';
-    if (extraFlags.absSrc0)
-        putChars(bufPtr, "abs(", 4);
-    
+    const cxbyte src0Flags = instr.operands[1].flags;
+    putOperandModsBegin(src0Flags, bufPtr);
     output.forward(bufPtr-bufStart);
     // print SRC0
-    bufStart = bufPtr = decodeGCNOperand(dasm, codePos, relocIter, extraFlags.src0,
-                 (gcnInsn.mode&GCN_REG_SRC0_64)?2:1, arch, literal, displayFloatLits);
-    // closing for abs and sext
-    if (extraFlags.absSrc0)
-        *bufPtr++ = ')';
-    if (extraFlags.sextSrc0)
-        *bufPtr++ = ')';
+    bufStart = bufPtr = printDecodedOperand(dasm, codePos, relocIter, instr, 1, arch,
+                displayFloatLits);
+    putOperandModsEnd(src0Flags, bufPtr);
     *bufPtr++ = ',';
     *bufPtr++ = ' ';
     
     // apply sext(), negation and abs() if applied
-    if (extraFlags.sextSrc1)
-        putChars(bufPtr, "sext(", 5);
-    
-    if (extraFlags.negSrc1)
-        *bufPtr++ = '-';
-    if (extraFlags.absSrc1)
-        putChars(bufPtr, "abs(", 4);
-    
+    const cxbyte src1Flags = instr.operands[2].flags;
+    putOperandModsBegin(src1Flags, bufPtr);
     // print SRC1
-    decodeGCNOperandNoLit(dasm, ((insnCode>>9)&0xff) + (extraFlags.scalarSrc1 ? 0 : 256),
-                (gcnInsn.mode&GCN_REG_SRC1_64)?2:1, bufPtr, arch);
-    // closing for abs and sext
-    if (extraFlags.absSrc1)
-        *bufPtr++ = ')';
-    if (extraFlags.sextSrc1)
-        *bufPtr++ = ')';
+    printDecodedOperandNoLit(dasm, instr, 2, bufPtr, arch);
+    putOperandModsEnd(src1Flags, bufPtr);
     
     output.forward(bufPtr-bufStart);
-    if (isGCN12)
-    {
-        // print extra SDWA/DPP modifiers
-        if (src0Field == 0xf9)
-            decodeVOPSDWA(output, arch, literal, true, true, true);
-        else if (src0Field == 0xfa)
-            decodeVOPDPP(output, literal, true, true);
-    }
+    // print extra SDWA/DPP modifiers
+    if (instr.extra == GCNDEXTRA_SDWA)
+        printVOPSDWA(output, arch, instr, insnCode2, true, true, true);
+    else if (instr.extra == GCNDEXTRA_DPP)
+        printVOPDPP(output, instr, insnCode2, true, true);
 }
 
-void GCNDisasmUtils::decodeVOP1Encoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal,
-         FloatLitType displayFloatLits)
+void GCNDisasmUtils::printVOP1Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
+         uint32_t insnCode, uint32_t insnCode2, FloatLitType displayFloatLits)
 {
-    FastOutputBuffer& output = dasm.output;
-    const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(130);
     char* bufPtr = bufStart;
     
-    const cxuint src0Field = (insnCode&0x1ff);
-    // extra flags are zeroed by default
-    VOPExtraWordOut extraFlags = { 0, 0, 0, 0, 0, 0, 0 };
-    
-    if (isGCN12)
-    {
-        // return extra flags from SDWA/DPP encoding
-        if (src0Field == 0xf9)
-            extraFlags = decodeVOPSDWAFlags(literal, arch);
-        else if (src0Field == 0xfa)
-            extraFlags = decodeVOPDPPFlags(literal);
-        else
-            extraFlags.src0 = src0Field;
-    }
-    else
-        extraFlags.src0 = src0Field;
-    
-    bool argsUsed = true;
-    if ((gcnInsn.mode & GCN_MASK1) != GCN_VOP_ARG_NONE)
+    const bool argsUsed = instr.operandsNum != 0;
+    if (argsUsed)
     {
         addSpaces(bufPtr, spacesToAdd);
-        if ((gcnInsn.mode & GCN_MASK1) != GCN_DST_SGPR)
-            // print DST as SGPR
-            decodeGCNVRegOperand(((insnCode>>17)&0xff),
-                     (gcnInsn.mode&GCN_REG_DST_64)?2:1, bufPtr);
-        else
-            // print DST as normal VGPR
-            decodeGCNOperandNoLit(dasm, ((insnCode>>17)&0xff),
-                          (gcnInsn.mode&GCN_REG_DST_64)?2:1, bufPtr, arch);
+        // print DST (VGPR or SGPR)
+        printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
         // apply sext, negation and abs if supplied
-        if (extraFlags.sextSrc0)
-            putChars(bufPtr, "sext(", 5);
-        
-        if (extraFlags.negSrc0)
-            *bufPtr++ = '-';
-        if (extraFlags.absSrc0)
-            putChars(bufPtr, "abs(", 4);
+        const cxbyte src0Flags = instr.operands[1].flags;
+        putOperandModsBegin(src0Flags, bufPtr);
         output.forward(bufPtr-bufStart);
         // print SRC0
-        bufStart = bufPtr = decodeGCNOperand(dasm, codePos, relocIter, extraFlags.src0,
-                     (gcnInsn.mode&GCN_REG_SRC0_64)?2:1, arch, literal, displayFloatLits);
-        // closing sext and abs
-        if (extraFlags.absSrc0)
-            *bufPtr++ = ')';
-        if (extraFlags.sextSrc0)
-            *bufPtr++ = ')';
+        bufStart = bufPtr = printDecodedOperand(dasm, codePos, relocIter, instr, 1, arch,
+                    displayFloatLits);
+        putOperandModsEnd(src0Flags, bufPtr);
     }
     else if ((insnCode & 0x1fe01ffU) != 0)
     {
@@ -1842,137 +1733,96 @@ void GCNDisasmUtils::decodeVOP1Encoding(GCNDisassembler& dasm, size_t codePos,
             putChars(bufPtr, "src0=", 5);
             bufPtr += itocstrCStyle(insnCode&0x1ff, bufPtr, 6, 16);
         }
-        argsUsed = false;
     }
     output.forward(bufPtr-bufStart);
-    if (isGCN12)
-    {
-        // print extra SDWA/DPP modifiers
-        if (src0Field == 0xf9)
-            decodeVOPSDWA(output, arch, literal, argsUsed, false);
-        else if (src0Field == 0xfa)
-            decodeVOPDPP(output, literal, argsUsed, false);
-    }
+    // print extra SDWA/DPP modifiers
+    if (instr.extra == GCNDEXTRA_SDWA)
+        printVOPSDWA(output, arch, instr, insnCode2, argsUsed, false);
+    else if (instr.extra == GCNDEXTRA_DPP)
+        printVOPDPP(output, instr, insnCode2, argsUsed, false);
 }
 
-void GCNDisasmUtils::decodeVOP2Encoding(GCNDisassembler& dasm, size_t codePos,
-         RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
-         const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t literal,
+void GCNDisasmUtils::printVOP2Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         size_t codePos, RelocIter& relocIter, cxuint spacesToAdd, uint16_t arch,
+         const GCNInstruction& gcnInsn, uint32_t insnCode2,
          FloatLitType displayFloatLits)
 {
-    FastOutputBuffer& output = dasm.output;
-    const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(150);
     char* bufPtr = bufStart;
     
     addSpaces(bufPtr, spacesToAdd);
     const uint16_t mode1 = (gcnInsn.mode & GCN_MASK1);
     
-    const cxuint src0Field = (insnCode&0x1ff);
-    // extra flags are zeroed by default
-    VOPExtraWordOut extraFlags = { 0, 0, 0, 0, 0, 0, 0 };
-    
-    if (isGCN12)
-    {
-        // return extra flags from SDWA/DPP encoding
-        if (src0Field == 0xf9)
-            extraFlags = decodeVOPSDWAFlags(literal, arch);
-        else if (src0Field == 0xfa)
-            extraFlags = decodeVOPDPPFlags(literal);
-        else
-            extraFlags.src0 = src0Field;
-    }
-    else
-        extraFlags.src0 = src0Field;
-    
-    if (mode1 != GCN_DS1_SGPR)
-        // print DST as SGPR
-        decodeGCNVRegOperand(((insnCode>>17)&0xff),
-                     (gcnInsn.mode&GCN_REG_DST_64)?2:1, bufPtr);
-    else
-        decodeGCNOperandNoLit(dasm, ((insnCode>>17)&0xff),
-                 (gcnInsn.mode&GCN_REG_DST_64)?2:1, bufPtr, arch);
-    
+    // print DST (VGPR or SGPR)
+    printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
+    cxuint opIndex = 1;
     // add VCC if V_ADD_XXX or other instruction VCC as DST
     if (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC)
-        putChars(bufPtr, ", vcc", 5);
+    {
+        *bufPtr++ = ',';
+        *bufPtr++ = ' ';
+        printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
+    }
     *bufPtr++ = ',';
     *bufPtr++ = ' ';
     // apply sext, negation and abs if supplied
-    if (extraFlags.sextSrc0)
-        putChars(bufPtr, "sext(", 5);
-    if (extraFlags.negSrc0)
-        *bufPtr++ = '-';
-    if (extraFlags.absSrc0)
-        putChars(bufPtr, "abs(", 4);
+    const cxbyte src0Flags = instr.operands[opIndex].flags;
+    putOperandModsBegin(src0Flags, bufPtr);
     output.forward(bufPtr-bufStart);
     // print SRC0
-    bufStart = bufPtr = decodeGCNOperand(dasm, codePos, relocIter, extraFlags.src0,
-                 (gcnInsn.mode&GCN_REG_SRC0_64)?2:1, arch, literal, displayFloatLits);
-    // closing sext and abs
-    if (extraFlags.absSrc0)
-        *bufPtr++ = ')';
-    if (extraFlags.sextSrc0)
-        *bufPtr++ = ')';
+    bufStart = bufPtr = printDecodedOperand(dasm, codePos, relocIter, instr, opIndex++,
+                arch, displayFloatLits);
+    putOperandModsEnd(src0Flags, bufPtr);
     if (mode1 == GCN_ARG1_IMM)
     {
         // extra immediate (like V_MADMK_F32)
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
         output.forward(bufPtr-bufStart);
-        printLiteral(dasm, codePos, relocIter, literal, displayFloatLits, false);
+        printLiteral(dasm, codePos, relocIter, instr.literal, displayFloatLits, false);
         bufStart = bufPtr = output.reserve(100);
     }
     *bufPtr++ = ',';
     *bufPtr++ = ' ';
     // apply sext, negation and abs if supplied
-    if (extraFlags.sextSrc1)
-        putChars(bufPtr, "sext(", 5);
-    
-    if (extraFlags.negSrc1)
-        *bufPtr++ = '-';
-    if (extraFlags.absSrc1)
-        putChars(bufPtr, "abs(", 4);
-    // print SRC0
+    const cxbyte src1Flags = instr.operands[opIndex].flags;
+    putOperandModsBegin(src1Flags, bufPtr);
+    // print SRC1
     if (mode1 == GCN_DS1_SGPR || mode1 == GCN_SRC1_SGPR)
     {
         output.forward(bufPtr-bufStart);
-        bufStart = bufPtr = decodeGCNOperand(dasm, codePos, relocIter,
-                 ((insnCode>>9)&0xff), (gcnInsn.mode&GCN_REG_SRC1_64)?2:1, arch);
+        bufStart = bufPtr = printDecodedOperand(dasm, codePos, relocIter, instr,
+                    opIndex, arch);
     }
     else
-        decodeGCNOperandNoLit(dasm, ((insnCode>>9)&0xff) +
-                (extraFlags.scalarSrc1 ? 0 : 256),
-                (gcnInsn.mode&GCN_REG_SRC1_64)?2:1, bufPtr, arch);
-    // closing sext and abs
-    if (extraFlags.absSrc1)
-        *bufPtr++ = ')';
-    if (extraFlags.sextSrc1)
-        *bufPtr++ = ')';
+        printDecodedOperandNoLit(dasm, instr, opIndex, bufPtr, arch);
+    opIndex++;
+    putOperandModsEnd(src1Flags, bufPtr);
     if (mode1 == GCN_ARG2_IMM)
     {
         // extra immediate (like V_MADAK_F32)
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
         output.forward(bufPtr-bufStart);
-        printLiteral(dasm, codePos, relocIter, literal, displayFloatLits, false);
-    }
-    else if (mode1 == GCN_DS2_VCC || mode1 == GCN_SRC2_VCC)
-    {
-        // VCC like in V_CNDMASK_B32 or V_SUBB_B32
-        putChars(bufPtr, ", vcc", 5);
-        output.forward(bufPtr-bufStart);
+        printLiteral(dasm, codePos, relocIter, instr.literal, displayFloatLits, false);
     }
     else
-        output.forward(bufPtr-bufStart);
-    if (isGCN12)
     {
-        // print extra SDWA/DPP modifiers
-        if (src0Field == 0xf9)
-            decodeVOPSDWA(output, arch, literal, true, true);
-        else if (src0Field == 0xfa)
-            decodeVOPDPP(output, literal, true, true);
+        if (opIndex < instr.operandsNum)
+        {
+            // VCC like in V_CNDMASK_B32 or V_SUBB_B32
+            *bufPtr++ = ',';
+            *bufPtr++ = ' ';
+            printDecodedOperandNoLit(dasm, instr, opIndex, bufPtr, arch);
+        }
+        output.forward(bufPtr-bufStart);
     }
+    // print extra SDWA/DPP modifiers
+    if (instr.extra == GCNDEXTRA_SDWA)
+        printVOPSDWA(output, arch, instr, insnCode2, true, true);
+    else if (instr.extra == GCNDEXTRA_DPP)
+        printVOPDPP(output, instr, insnCode2, true, true);
 }
 
 // VINTRP param names
@@ -1990,17 +1840,17 @@ static void decodeVINTRPParam(uint16_t p, char*& bufPtr)
         putChars(bufPtr, vintrpParamsTbl[p], ::strlen(vintrpParamsTbl[p]));
 }
 
-void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-         uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
-         uint32_t insnCode2, FloatLitType displayFloatLits)
+void GCNDisasmUtils::printVOP3Encoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
+         uint32_t insnCode, uint32_t insnCode2, FloatLitType displayFloatLits)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(170);
     char* bufPtr = bufStart;
-    const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
     const bool isGCN14 = ((arch&ARCH_RXVEGA)!=0);
-    const cxuint opcode = (isGCN12) ? ((insnCode>>16)&0x3ff) : ((insnCode>>17)&0x1ff);
+    const cxuint opcode = instr.opcode;
     
+    // fields used to print values of unused operands and to check VOP1/VOP2/VOPC form
     const cxuint vdst = insnCode&0xff;
     const cxuint vsrc0 = insnCode2&0x1ff;
     const cxuint vsrc1 = (insnCode2>>9)&0x1ff;
@@ -2015,138 +1865,116 @@ void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAd
     bool vsrc2Used = false;
     bool vsrc2CC = false;
     cxuint absFlags = 0;
-    cxuint negFlags = 0;
     
     if (gcnInsn.encoding == GCNENC_VOP3A && vop3Mode != GCN_VOP3_VOP3P)
         absFlags = (insnCode>>8)&7;
-    // get negation flags from insnCode (VOP3P)
-    if (vop3Mode != GCN_VOP3_VOP3P)
-        negFlags = (insnCode2>>29)&7;
-    
-    const bool is128Ops = (gcnInsn.mode&0x7000)==GCN_VOP3_DS2_128;
+    // negation is printed as neg_lo modifier for VOP3P
+    const cxbyte srcModsMask = GCNDOP_ABS |
+                ((vop3Mode != GCN_VOP3_VOP3P) ? GCNDOP_NEG : 0);
+    // index of first source operand
+    cxuint srcIndex = 0;
     
     if (mode1 != GCN_VOP_ARG_NONE)
     {
         addSpaces(bufPtr, spacesToAdd);
         
-        if (opcode < 256 || (gcnInsn.mode&GCN_VOP3_DST_SGPR)!=0)
-            /* if compares (print DST as SDST) */
-            decodeGCNOperandNoLit(dasm, vdst, ((gcnInsn.mode&GCN_VOP3_DST_SGPR)==0)?2:1,
-                              bufPtr, arch);
-        else /* regular instruction */
-            // for V_MQSAD_U32 SRC2 is 128-bit
-            decodeGCNVRegOperand(vdst, (is128Ops) ? 4 : 
-                                 ((gcnInsn.mode&GCN_REG_DST_64)?2:1), bufPtr);
-        
-        if (gcnInsn.encoding == GCNENC_VOP3B &&
-            (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC || mode1 == GCN_DST_VCC_VSRC2 ||
-             mode1 == GCN_S0EQS12)) /* VOP3b */
+        // print VDST (or SDST for compares)
+        printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
+        cxuint opIndex = 1;
+        if (opIndex < instr.operandsNum && (instr.operands[opIndex].flags & GCNDOP_DST))
         {
             // print SDST operand (VOP3B)
             *bufPtr++ = ',';
             *bufPtr++ = ' ';
-            decodeGCNOperandNoLit(dasm, ((insnCode>>8)&0x7f), 2, bufPtr, arch);
+            printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
         }
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
+        srcIndex = opIndex;
         if (vop3Mode != GCN_VOP3_VINTRP)
         {
-            // print negation or abs if supplied
-            if (negFlags & 1)
-                *bufPtr++ = '-';
-            if (absFlags & 1)
-                putChars(bufPtr, "abs(", 4);
-            // print VSRC0
-            decodeGCNOperandNoLit(dasm, vsrc0, (gcnInsn.mode&GCN_REG_SRC0_64)?2:1,
-                                   bufPtr, arch, displayFloatLits);
-            // closing abs
-            if (absFlags & 1)
-                *bufPtr++ = ')';
+            // print VSRC0 with negation or abs if supplied
+            const cxbyte flags = instr.operands[opIndex].flags & srcModsMask;
+            putOperandModsBegin(flags, bufPtr);
+            printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch,
+                        displayFloatLits);
+            putOperandModsEnd(flags, bufPtr);
             vsrc0Used = true;
         }
         
         if (vop3Mode == GCN_VOP3_VINTRP)
         {
-            // print negation or abs if supplied
-            if (negFlags & 2)
-                *bufPtr++ = '-';
-            if (absFlags & 2)
-                putChars(bufPtr, "abs(", 4);
             if (mode1 == GCN_P0_P10_P20)
-                // VINTRP param
-                decodeVINTRPParam(vsrc1, bufPtr);
+            {
+                // VINTRP param (negation and abs are not in decoded operands)
+                if ((insnCode2 & (1U<<30)) != 0)
+                    *bufPtr++ = '-';
+                if (absFlags & 2)
+                    putChars(bufPtr, "abs(", 4);
+                decodeVINTRPParam(instr.imm, bufPtr);
+                if (absFlags & 2)
+                    *bufPtr++ = ')';
+            }
             else
+            {
                 // print VSRC1
-                decodeGCNOperandNoLit(dasm, vsrc1, 1, bufPtr, arch, displayFloatLits);
-            if (absFlags & 2)
-                *bufPtr++ = ')';
+                const cxbyte flags = instr.operands[opIndex].flags & srcModsMask;
+                putOperandModsBegin(flags, bufPtr);
+                printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch,
+                            displayFloatLits);
+                putOperandModsEnd(flags, bufPtr);
+            }
             // print VINTRP attr
             putChars(bufPtr, ", attr", 6);
-            const cxuint attr = vsrc0&63;
-            putByteToBuf(attr, bufPtr);
+            putByteToBuf(instr.format&63, bufPtr);
             *bufPtr++ = '.';
-            *bufPtr++ = "xyzw"[((vsrc0>>6)&3)]; // attrchannel
+            *bufPtr++ = "xyzw"[instr.format>>6]; // attrchannel
             
-            if ((gcnInsn.mode & GCN_VOP3_MASK3) == GCN_VINTRP_SRC2)
+            if (opIndex < instr.operandsNum)
             {
                 *bufPtr++ = ',';
                 *bufPtr++ = ' ';
-                // print abs and negation for VSRC2
-                if (negFlags & 4)
-                    *bufPtr++ = '-';
-                if (absFlags & 4)
-                    putChars(bufPtr, "abs(", 4);
                 // print VSRC2
-                decodeGCNOperandNoLit(dasm, vsrc2, 1, bufPtr, arch, displayFloatLits);
-                if (absFlags & 4)
-                    *bufPtr++ = ')';
+                const cxbyte flags = instr.operands[opIndex].flags & srcModsMask;
+                putOperandModsBegin(flags, bufPtr);
+                printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch,
+                            displayFloatLits);
+                putOperandModsEnd(flags, bufPtr);
                 vsrc2Used = true;
             }
             
-            if (vsrc0 & 0x100)
+            if (instr.modifiers & GCNDMOD_HIGH)
                 putChars(bufPtr, " high", 5);
             vsrc0Used = true;
             vsrc1Used = true;
         }
-        else if (mode1 != GCN_SRC12_NONE)
+        else if (opIndex < instr.operandsNum)
         {
             *bufPtr++ = ',';
             *bufPtr++ = ' ';
-            // print abs and negation for VSRC1
-            if (negFlags & 2)
-                *bufPtr++ = '-';
-            if (absFlags & 2)
-                putChars(bufPtr, "abs(", 4);
-            // print VSRC1
-            decodeGCNOperandNoLit(dasm, vsrc1, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1,
-                      bufPtr, arch, displayFloatLits);
-            if (absFlags & 2)
-                *bufPtr++ = ')';
-            /* GCN_DST_VCC - only sdst is used, no vsrc2 */
-            if (mode1 != GCN_SRC2_NONE && mode1 != GCN_DST_VCC && opcode >= 256)
+            // print VSRC1 with abs and negation
+            const cxbyte flags = instr.operands[opIndex].flags & srcModsMask;
+            putOperandModsBegin(flags, bufPtr);
+            printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch,
+                        displayFloatLits);
+            putOperandModsEnd(flags, bufPtr);
+            if (opIndex < instr.operandsNum)
             {
                 *bufPtr++ = ',';
                 *bufPtr++ = ' ';
-                
                 if (mode1 == GCN_DS2_VCC || mode1 == GCN_SRC2_VCC)
                 {
-                    decodeGCNOperandNoLit(dasm, vsrc2, 2, bufPtr, arch);
+                    printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
                     vsrc2CC = true;
                 }
                 else
                 {
-                    // print abs and negation for VSRC2
-                    if (negFlags & 4)
-                        *bufPtr++ = '-';
-                    if (absFlags & 4)
-                        putChars(bufPtr, "abs(", 4);
-                    // for V_MQSAD_U32 SRC2 is 128-bit
-                    // print VSRC2
-                    decodeGCNOperandNoLit(dasm, vsrc2, is128Ops ? 4 :
-                                (gcnInsn.mode&GCN_REG_SRC2_64)?2:1,
-                                 bufPtr, arch, displayFloatLits);
-                    if (absFlags & 4)
-                        *bufPtr++ = ')';
+                    // print VSRC2 with abs and negation
+                    const cxbyte flags = instr.operands[opIndex].flags & srcModsMask;
+                    putOperandModsBegin(flags, bufPtr);
+                    printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch,
+                                displayFloatLits);
+                    putOperandModsEnd(flags, bufPtr);
                 }
                 vsrc2Used = true;
             }
@@ -2158,12 +1986,10 @@ void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAd
     else
         addSpaces(bufPtr, spacesToAdd-1);
     
-    uint32_t opselBaseMask = 0;
-    uint32_t opselMask = 1;
-    uint32_t opsel = 0;
+    cxuint opselMask = 1;
+    cxuint opselBits = 0;
     if (isGCN14 && gcnInsn.encoding != GCNENC_VOP3B)
     {
-        opsel = (insnCode >> 11) & 15;
         // print OPSEL
         const bool opsel2Bit = (vop3Mode!=GCN_VOP3_VOP3P && vsrc1Used) ||
             (vop3Mode==GCN_VOP3_VOP3P && vsrc2Used);
@@ -2171,108 +1997,98 @@ void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAd
         if (vop3Mode!=GCN_VOP3_VOP3P)
         {
             opselMask |= (opsel2Bit?2:0) | (opsel3Bit?4:0) | 8;
-            opselBaseMask = (15U<<11);
+            opselBits = instr.opsel&15;
         }
         else // VOP3P
         {
             opselMask |= (opsel2Bit?6:2);
-            opselBaseMask = (7U<<11);
+            opselBits = instr.opsel&7;
         }
         
-        if ((insnCode & (opselMask<<11)) != 0 &&
-            ((insnCode & opselBaseMask) & ~(opselMask<<11)) == 0)
+        if ((opselBits & opselMask) != 0 && (opselBits & ~opselMask) == 0)
         {
             putChars(bufPtr, " op_sel:[", 9);
-            *bufPtr++ = (insnCode&0x800) ? '1' : '0';
+            *bufPtr++ = (opselBits&1) ? '1' : '0';
             *bufPtr++ = ',';
             if (vop3Mode==GCN_VOP3_VOP3P || vsrc1Used)
-                *bufPtr++ = (insnCode&0x1000) ? '1' : '0';
+                *bufPtr++ = (opselBits&2) ? '1' : '0';
             else
                 // last bit 14-bit dest (for one operand instr)
-                *bufPtr++ = (insnCode&0x4000) ? '1' : '0';
+                *bufPtr++ = (opselBits&8) ? '1' : '0';
             // print next opsel if next operand is present
             // for VOP3P: VSRC2, non VOP3P - VSRC1
             if (vop3Mode!=GCN_VOP3_VOP3P && vsrc1Used)
             {
                 *bufPtr++ = ',';
                 if (vsrc2Used)
-                    *bufPtr++ = (insnCode&0x2000) ? '1' : '0';
+                    *bufPtr++ = (opselBits&4) ? '1' : '0';
                 else
                     // last bit 14-bit dest (no third source operand)
-                    *bufPtr++ = (insnCode&0x4000) ? '1' : '0';
+                    *bufPtr++ = (opselBits&8) ? '1' : '0';
             }
             else if (vop3Mode==GCN_VOP3_VOP3P && vsrc2Used)
             {
                 *bufPtr++ = ',';
-                *bufPtr++ = (insnCode&0x2000) ? '1' : '0';
+                *bufPtr++ = (opselBits&4) ? '1' : '0';
             }
             // only for VOP3P and VSRC2
             if (vsrc2Used && vop3Mode!=GCN_VOP3_VOP3P)
             {
                 *bufPtr++ = ',';
-                *bufPtr++ = (insnCode&0x4000) ? '1' : '0';
+                *bufPtr++ = (opselBits&8) ? '1' : '0';
             }
             *bufPtr++ = ']';
         }
     }
     
     // fi VOP3P encoding
-    if (vop3Mode==GCN_VOP3_VOP3P)
+    if (vop3Mode==GCN_VOP3_VOP3P && vdstUsed)
     {
         // print OP_SEL_HI modifier
-        cxuint opselHi = ((insnCode2 >> 27) & 3) | (vsrc2Used ? ((insnCode>>12)&4) : 0);
+        const cxuint opselHi = (instr.opsel>>4) & (vsrc2Used ? 7 : 3);
         if (opselHi != 3+(vsrc2Used?4:0))
         {
             putChars(bufPtr, " op_sel_hi:[", 12);
-            *bufPtr++ = (insnCode2 & (1U<<27)) ? '1' : '0';
-            *bufPtr++ = ',';
-            *bufPtr++ = (insnCode2 & (1U<<28)) ? '1' : '0';
-            if (vsrc2Used)
-            {
-                *bufPtr++ = ',';
-                *bufPtr++ = (insnCode& 0x4000) ? '1' : '0';
-            }
-            *bufPtr++ = ']';
-        }
-        // print NEG_LO modifier
-        if ((insnCode2&((3+(vsrc2Used?4:0))<<29)) != 0)
-        {
-            putChars(bufPtr, " neg_lo:[", 9);
-            *bufPtr++ = (insnCode2 & (1U<<29)) ? '1' : '0';
+            *bufPtr++ = (opselHi & 1) ? '1' : '0';
             *bufPtr++ = ',';
-            *bufPtr++ = (insnCode2 & (1U<<30)) ? '1' : '0';
+            *bufPtr++ = (opselHi & 2) ? '1' : '0';
             if (vsrc2Used)
             {
                 *bufPtr++ = ',';
-                *bufPtr++ = (insnCode2 & (1U<<31)) ? '1' : '0';
+                *bufPtr++ = (opselHi & 4) ? '1' : '0';
             }
             *bufPtr++ = ']';
         }
-        // print NEG_HI modifier
-        if ((insnCode & ((3+(vsrc2Used?4:0))<<8)) != 0)
+        // print NEG_LO and NEG_HI modifiers
+        const cxuint srcsNum = vsrc2Used ? 3 : 2;
+        for (cxbyte negFlag: { GCNDOP_NEG, GCNDOP_NEG_HI })
         {
-            putChars(bufPtr, " neg_hi:[", 9);
-            *bufPtr++ = (insnCode & (1U<<8)) ? '1' : '0';
+            cxuint negBits = 0;
+            for (cxuint k = 0; k < srcsNum; k++)
+                if (instr.operands[srcIndex+k].flags & negFlag)
+                    negBits |= 1U<<k;
+            if (negBits == 0)
+                continue;
+            putChars(bufPtr, (negFlag == GCNDOP_NEG) ? " neg_lo:[" : " neg_hi:[", 9);
+            *bufPtr++ = (negBits & 1) ? '1' : '0';
             *bufPtr++ = ',';
-            *bufPtr++ = (insnCode & (1U<<9)) ? '1' : '0';
+            *bufPtr++ = (negBits & 2) ? '1' : '0';
             if (vsrc2Used)
             {
                 *bufPtr++ = ',';
-                *bufPtr++ = (insnCode & (1U<<10)) ? '1' : '0';
+                *bufPtr++ = (negBits & 4) ? '1' : '0';
             }
             *bufPtr++ = ']';
         }
     }
     
-    const cxuint omod = (insnCode2>>27)&3;
-    if (vop3Mode != GCN_VOP3_VOP3P && omod != 0)
+    if (instr.omod != 0)
     {
-        const char* omodStr = (omod==3)?" div:2":(omod==2)?" mul:4":" mul:2";
+        const char* omodStr = (instr.omod==3)?" div:2":(instr.omod==2)?" mul:4":" mul:2";
         putChars(bufPtr, omodStr, 6);
     }
     
-    const bool clamp = (!isGCN12 && gcnInsn.encoding == GCNENC_VOP3A &&
-            (insnCode&0x800) != 0) || (isGCN12 && (insnCode&0x8000) != 0);
+    const bool clamp = (instr.modifiers & GCNDMOD_CLAMP) != 0;
     if (clamp)
         putChars(bufPtr, " clamp", 6);
     
@@ -2321,14 +2137,14 @@ void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAd
     }
     
     // unused op_sel field
-    if (isGCN14 && ((insnCode & opselBaseMask) & ~(opselMask<<11)) != 0 &&
-        gcnInsn.encoding != GCNENC_VOP3B)
+    if (isGCN14 && (opselBits & ~opselMask) != 0 && gcnInsn.encoding != GCNENC_VOP3B)
     {
         putChars(bufPtr, " op_sel=", 8);
         bufPtr += itocstrCStyle((insnCode>>11)&15, bufPtr, 6, 16);
     }
     
     const cxuint usedMask = 7 & ~(vsrc2CC?4:0);
+    const cxuint omod = (insnCode2>>27)&3;
     /* check whether instruction is this same like VOP2/VOP1/VOPC */
     bool isVOP1Word = false; // if can be write in single VOP dword
     if (vop3Mode == GCN_VOP3_VINTRP)
@@ -2371,7 +2187,7 @@ void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAd
         
         if (isVOP1Word && !reqForVOP1Word)
             isVOP1Word = false;
-        if (opsel != 0)
+        if (opselBits != 0)
             isVOP1Word = false;
     }
     else // force for v_madmk_f32 and v_madak_f32
@@ -2383,106 +2199,60 @@ void GCNDisasmUtils::decodeVOP3Encoding(GCNDisassembler& dasm, cxuint spacesToAd
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeVINTRPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-          uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode)
+void GCNDisasmUtils::printVINTRPEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+          cxuint spacesToAdd, uint16_t arch)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(90);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
     // print DST operand
-    decodeGCNVRegOperand((insnCode>>18)&0xff, 1, bufPtr);
+    printDecodedOperandNoLit(dasm, instr, 0, bufPtr, arch);
     *bufPtr++ = ',';
     *bufPtr++ = ' ';
-    if ((gcnInsn.mode & GCN_MASK1) == GCN_P0_P10_P20)
+    if (instr.operandsNum < 2)
         // print VINTRP param
-        decodeVINTRPParam(insnCode&0xff, bufPtr);
+        decodeVINTRPParam(instr.imm, bufPtr);
     else
         // or VSRC0 operand
-        decodeGCNVRegOperand(insnCode&0xff, 1, bufPtr);
+        printDecodedOperandNoLit(dasm, instr, 1, bufPtr, arch);
     putChars(bufPtr, ", attr", 6);
-    const cxuint attr = (insnCode>>10)&63;
-    putByteToBuf(attr, bufPtr);
+    putByteToBuf(instr.format&63, bufPtr);
     *bufPtr++ = '.';
-    *bufPtr++ = "xyzw"[((insnCode>>8)&3)]; // attrchannel
+    *bufPtr++ = "xyzw"[instr.format>>6]; // attrchannel
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeDSEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-          uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
+void GCNDisasmUtils::printDSEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+          cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
           uint32_t insnCode2)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(105);
     char* bufPtr = bufStart;
-    const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
     addSpaces(bufPtr, spacesToAdd);
-    bool vdstUsed = false;
-    bool vaddrUsed = false;
-    bool vdata0Used = false;
-    bool vdata1Used = false;
     const cxuint vaddr = insnCode2&0xff;
     const cxuint vdata0 = (insnCode2>>8)&0xff;
     const cxuint vdata1 = (insnCode2>>16)&0xff;
     const cxuint vdst = insnCode2>>24;
     
-    if (((gcnInsn.mode & GCN_ADDR_SRC) != 0 || (gcnInsn.mode & GCN_ONLYDST) != 0) &&
-            (gcnInsn.mode & GCN_ONLY_SRC) == 0)
-    {
-        /* vdst is dst */
-        cxuint regsNum = (gcnInsn.mode&GCN_REG_DST_64)?2:1;
-        if ((gcnInsn.mode&GCN_DS_96) != 0)
-            regsNum = 3;
-        if ((gcnInsn.mode&GCN_DS_128) != 0 || (gcnInsn.mode&GCN_DST128) != 0)
-            regsNum = 4;
-        // print VDST
-        decodeGCNVRegOperand(vdst, regsNum, bufPtr);
-        vdstUsed = true;
-    }
-    if ((gcnInsn.mode & GCN_ONLYDST) == 0 && (gcnInsn.mode & GCN_ONLY_SRC) == 0)
-    {
-        /// print VADDR
-        if (vdstUsed)
-        {
-            *bufPtr++ = ',';
-            *bufPtr++ = ' ';
-        }
-        decodeGCNVRegOperand(vaddr, 1, bufPtr);
-        vaddrUsed = true;
-    }
-    
-    const uint16_t srcMode = (gcnInsn.mode & GCN_SRCS_MASK);
-    
-    if ((gcnInsn.mode & GCN_ONLYDST) == 0 &&
-        (gcnInsn.mode & (GCN_ADDR_DST|GCN_ADDR_SRC)) != 0 && srcMode != GCN_NOSRC)
+    // print VDST, VADDR, VDATA0 and VDATA1 (if they are used)
+    for (cxuint i = 0; i < instr.operandsNum; i++)
     {
-        /* print two vdata */
-        if (vaddrUsed || vdstUsed)
-        {
-            // comma after previous argument (VDST, VADDR)
-            *bufPtr++ = ',';
-            *bufPtr++ = ' ';
-        }
-        // determine number of register for VDATA0
-        cxuint regsNum = (gcnInsn.mode&GCN_REG_SRC0_64)?2:1;
-        if ((gcnInsn.mode&GCN_DS_96) != 0)
-            regsNum = 3;
-        if ((gcnInsn.mode&GCN_DS_128) != 0)
-            regsNum = 4;
-        // print VDATA0
-        decodeGCNVRegOperand(vdata0, regsNum, bufPtr);
-        vdata0Used = true;
-        if (srcMode == GCN_2SRCS)
+        if (i != 0)
         {
             *bufPtr++ = ',';
             *bufPtr++ = ' ';
-            // print VDATA1
-            decodeGCNVRegOperand(vdata1, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1, bufPtr);
-            vdata1Used = true;
         }
+        printDecodedOperandNoLit(dasm, instr, i, bufPtr, arch);
     }
+    const bool vdstUsed = instr.operandsNum != 0 &&
+                (instr.operands[0].flags & GCNDOP_DST) != 0;
+    const bool vaddrUsed = (gcnInsn.mode & GCN_ONLYDST) == 0 &&
+                (gcnInsn.mode & GCN_ONLY_SRC) == 0;
+    const cxuint vdataNum = instr.operandsNum - (vdstUsed?1:0) - (vaddrUsed?1:0);
     
-    const cxuint offset = (insnCode&0xffff);
+    const cxuint offset = instr.imm;
     // printing offsets (one 16-bit or two 8-bit)
     if (offset != 0)
     {
@@ -2507,7 +2277,7 @@ void GCNDisasmUtils::decodeDSEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
         }
     }
     
-    if ((!isGCN12 && (insnCode&0x20000)!=0) || (isGCN12 && (insnCode&0x10000)!=0))
+    if (instr.modifiers & GCNDMOD_GDS)
         putChars(bufPtr, " gds", 4);
     
     // print value, if some are not used, but values is not default
@@ -2516,12 +2286,12 @@ void GCNDisasmUtils::decodeDSEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
         putChars(bufPtr, " vaddr=", 7);
         bufPtr += itocstrCStyle(vaddr, bufPtr, 6, 16);
     }
-    if (!vdata0Used && vdata0 != 0)
+    if (vdataNum < 1 && vdata0 != 0)
     {
         putChars(bufPtr, " vdata0=", 8);
         bufPtr += itocstrCStyle(vdata0, bufPtr, 6, 16);
     }
-    if (!vdata1Used && vdata1 != 0)
+    if (vdataNum < 2 && vdata1 != 0)
     {
         putChars(bufPtr, " vdata1=", 8);
         bufPtr += itocstrCStyle(vdata1, bufPtr, 6, 16);
@@ -2549,15 +2319,13 @@ static const char* mtbufNFMTTable[] =
     "uint", "sint", "snorm_ogl", "float"
 };
 
-void GCNDisasmUtils::decodeMUBUFEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-          uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
+void GCNDisasmUtils::printMUBUFEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+          cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
           uint32_t insnCode2)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(170);
     char* bufPtr = bufStart;
-    const bool isGCN12 = ((arch&ARCH_GCN_1_2_4)!=0);
-    const bool isGCN14 = ((arch&ARCH_RXVEGA)!=0);
     const cxuint vaddr = insnCode2&0xff;
     const cxuint vdata = (insnCode2>>8)&0xff;
     const cxuint srsrc = (insnCode2>>16)&0x1f;
@@ -2566,69 +2334,48 @@ void GCNDisasmUtils::decodeMUBUFEncoding(GCNDisassembler& dasm, cxuint spacesToA
     if (mode1 != GCN_ARG_NONE)
     {
         addSpaces(bufPtr, spacesToAdd);
-        if (mode1 != GCN_MUBUF_NOVAD)
+        // print VDATA, VADDR (if used), SRSRC and SOFFSET
+        for (cxuint i = 0; i < instr.operandsNum; i++)
         {
-            // determine number of regs in VDATA
-            cxuint dregsNum = ((gcnInsn.mode&GCN_DSIZE_MASK)>>GCN_SHIFT2)+1;
-            if ((gcnInsn.mode & GCN_MUBUF_D16)!=0 && isGCN14)
-                // 16-bit values packed into half of number of registers
-                dregsNum = (dregsNum+1)>>1;
-            if (insnCode2 & 0x800000U)
-                dregsNum++; // tfe
-            // print VDATA
-            decodeGCNVRegOperand(vdata, dregsNum, bufPtr);
-            *bufPtr++ = ',';
-            *bufPtr++ = ' ';
-            // determine number of vaddr registers
-            /* for addr32 - idxen+offen or 1, for addr64 - 2 (idxen and offen is illegal) */
-            const cxuint aregsNum = ((insnCode & 0x3000U)==0x3000U ||
-                    /* addr64 only for older GCN than 1.2 */
-                    (!isGCN12 && (insnCode & 0x8000U)))? 2 : 1;
-            // print VADDR
-            decodeGCNVRegOperand(vaddr, aregsNum, bufPtr);
-            *bufPtr++ = ',';
-            *bufPtr++ = ' ';
+            if (i != 0)
+            {
+                *bufPtr++ = ',';
+                *bufPtr++ = ' ';
+            }
+            printDecodedOperandNoLit(dasm, instr, i, bufPtr, arch);
         }
-        // print SRSRC
-        decodeGCNOperandNoLit(dasm, srsrc<<2, 4, bufPtr, arch);
-        *bufPtr++ = ',';
-        *bufPtr++ = ' ';
-        // print SOFFSET
-        decodeGCNOperandNoLit(dasm, soffset, 1, bufPtr, arch);
     }
     else
         addSpaces(bufPtr, spacesToAdd-1);
     
     // print modifiers: (offen and idxen, glc)
-    if (insnCode & 0x1000U)
+    if (instr.modifiers & GCNDMOD_OFFEN)
         putChars(bufPtr, " offen", 6);
-    if (insnCode & 0x2000U)
+    if (instr.modifiers & GCNDMOD_IDXEN)
         putChars(bufPtr, " idxen", 6);
-    const cxuint offset = insnCode&0xfff;
-    if (offset != 0)
+    if (instr.imm != 0)
     {
         putChars(bufPtr, " offset:", 8);
-        bufPtr += itocstrCStyle(offset, bufPtr, 7, 10);
+        bufPtr += itocstrCStyle(instr.imm, bufPtr, 7, 10);
     }
-    if (insnCode & 0x4000U)
+    if (instr.modifiers & GCNDMOD_GLC)
         putChars(bufPtr, " glc", 4);
     
     // print SLD if supplied
-    if (((!isGCN12 || gcnInsn.encoding==GCNENC_MTBUF) && (insnCode2 & 0x400000U)!=0) ||
-        ((isGCN12 && gcnInsn.encoding!=GCNENC_MTBUF) && (insnCode & 0x20000)!=0))
+    if (instr.modifiers & GCNDMOD_SLC)
         putChars(bufPtr, " slc", 4);
     
-    if (!isGCN12 && (insnCode & 0x8000U)!=0)
+    if (instr.modifiers & GCNDMOD_ADDR64)
         putChars(bufPtr, " addr64", 7);
-    if (gcnInsn.encoding!=GCNENC_MTBUF && (insnCode & 0x10000U) != 0)
+    if (instr.modifiers & GCNDMOD_LDS)
         putChars(bufPtr, " lds", 4);
-    if (insnCode2 & 0x800000U)
+    if (instr.modifiers & GCNDMOD_TFE)
         putChars(bufPtr, " tfe", 4);
     // routine to decode MTBUF format (include default values)
     if (gcnInsn.encoding==GCNENC_MTBUF)
     {
-        const cxuint dfmt = (insnCode>>19)&15;
-        const cxuint nfmt = (insnCode>>23)&7;
+        const cxuint dfmt = instr.format&15;
+        const cxuint nfmt = instr.format>>4;
         if (dfmt!=1 || nfmt!=0)
         {
             // in shortened form: format:[DFMT, NFMT]
@@ -2681,48 +2428,26 @@ void GCNDisasmUtils::decodeMUBUFEncoding(GCNDisassembler& dasm, cxuint spacesToA
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeMIMGEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-         uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
-         uint32_t insnCode2)
+void GCNDisasmUtils::printMIMGEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+         cxuint spacesToAdd, uint16_t arch, uint32_t insnCode2)
 {
     const bool isGCN14 = ((arch&ARCH_RXVEGA)!=0);
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(170);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
     
-    const cxuint dmask = (insnCode>>8)&15;
-    cxuint dregsNum = 4;
-    // determine register number for VDATA
-    if ((gcnInsn.mode & GCN_MIMG_VDATA4) == 0)
-        dregsNum = ((dmask & 1)?1:0) + ((dmask & 2)?1:0) + ((dmask & 4)?1:0) +
-                ((dmask & 8)?1:0);
-    
-    dregsNum = (dregsNum == 0) ? 1 : dregsNum;
-    if (insnCode & 0x10000)
-        dregsNum++; // tfe
-    
-    // print VDATA
-    decodeGCNVRegOperand((insnCode2>>8)&0xff, dregsNum, bufPtr);
-    *bufPtr++ = ',';
-    *bufPtr++ = ' ';
-    // print VADDR
-    decodeGCNVRegOperand(insnCode2&0xff,
-                 std::max(4, (gcnInsn.mode&GCN_MIMG_VA_MASK)+1), bufPtr);
-    *bufPtr++ = ',';
-    *bufPtr++ = ' ';
-    // print SRSRC
-    decodeGCNOperandNoLit(dasm, ((insnCode2>>14)&0x7c),
-                (((insnCode & 0x8000)!=0) && !isGCN14) ? 4: 8, bufPtr, arch);
-    
-    const cxuint ssamp = (insnCode2>>21)&0x1f;
-    if ((gcnInsn.mode & GCN_MIMG_SAMPLE) != 0)
+    // print VDATA, VADDR, SRSRC and SSAMP (if supplied)
+    for (cxuint i = 0; i < instr.operandsNum; i++)
     {
-        *bufPtr++ = ',';
-        *bufPtr++ = ' ';
-        // print SSAMP if supplied
-        decodeGCNOperandNoLit(dasm, ssamp<<2, 4, bufPtr, arch);
+        if (i != 0)
+        {
+            *bufPtr++ = ',';
+            *bufPtr++ = ' ';
+        }
+        printDecodedOperandNoLit(dasm, instr, i, bufPtr, arch);
     }
+    const cxuint dmask = instr.mask;
     if (dmask != 1)
     {
         putChars(bufPtr, " dmask:", 7);
@@ -2737,35 +2462,36 @@ void GCNDisasmUtils::decodeMIMGEncoding(GCNDisassembler& dasm, cxuint spacesToAd
     }
     
     // print other modifiers (unorm, glc, slc, ...)
-    if (insnCode & 0x1000)
+    if (instr.modifiers & GCNDMOD_UNORM)
         putChars(bufPtr, " unorm", 6);
-    if (insnCode & 0x2000)
+    if (instr.modifiers & GCNDMOD_GLC)
         putChars(bufPtr, " glc", 4);
-    if (insnCode & 0x2000000)
+    if (instr.modifiers & GCNDMOD_SLC)
         putChars(bufPtr, " slc", 4);
-    if (insnCode & 0x8000)
+    if (instr.modifiers & GCNDMOD_R128)
     {
         if (!isGCN14)
             putChars(bufPtr, " r128", 5);
         else
             putChars(bufPtr, " a16", 4);
     }
-    if (insnCode & 0x10000)
+    if (instr.modifiers & GCNDMOD_TFE)
         putChars(bufPtr, " tfe", 4);
-    if (insnCode & 0x20000)
+    if (instr.modifiers & GCNDMOD_LWE)
         putChars(bufPtr, " lwe", 4);
-    if (insnCode & 0x4000)
+    if (instr.modifiers & GCNDMOD_DA)
     {
         // DA modifier
         *bufPtr++ = ' ';
         *bufPtr++ = 'd';
         *bufPtr++ = 'a';
     }
-    if ((arch & ARCH_GCN_1_2_4)!=0 && (insnCode2 & (1U<<31)) != 0)
+    if (instr.modifiers & GCNDMOD_D16)
         putChars(bufPtr, " d16", 4);
     
     // print value, if some are not used, but values is not default
-    if ((gcnInsn.mode & GCN_MIMG_SAMPLE) == 0 && ssamp != 0)
+    const cxuint ssamp = (insnCode2>>21)&0x1f;
+    if (instr.operandsNum < 4 && ssamp != 0)
     {
         putChars(bufPtr, " ssamp=", 7);
         bufPtr += itocstrCStyle(ssamp, bufPtr, 6, 16);
@@ -2773,16 +2499,15 @@ void GCNDisasmUtils::decodeMIMGEncoding(GCNDisassembler& dasm, cxuint spacesToAd
     output.forward(bufPtr-bufStart);
 }
 
-void GCNDisasmUtils::decodeEXPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-            uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
-            uint32_t insnCode2)
+void GCNDisasmUtils::printEXPEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+            cxuint spacesToAdd, uint16_t arch, uint32_t insnCode2)
 {
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(100);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
     /* export target */
-    const cxuint target = (insnCode>>4)&63;
+    const cxuint target = instr.format;
     if (target >= 32)
     {
         // print paramXX
@@ -2819,35 +2544,29 @@ void GCNDisasmUtils::decodeEXPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd
     }
     
     /* print vdata registers */
+    const bool compr = (instr.modifiers & GCNDMOD_COMPR) != 0;
     cxuint vsrcsUsed = 0;
+    cxuint opIndex = 0;
     for (cxuint i = 0; i < 4; i++)
     {
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
-        if (insnCode & (1U<<i))
+        if (instr.mask & (1U<<i))
         {
-            if ((insnCode&0x400)==0)
-            {
-                decodeGCNVRegOperand((insnCode2>>(i<<3))&0xff, 1, bufPtr);
-                vsrcsUsed |= 1<<i;
-            }
-            else
-            {
-                // if compr=1
-                decodeGCNVRegOperand(((i>=2)?(insnCode2>>8):insnCode2)&0xff, 1, bufPtr);
-                vsrcsUsed |= 1U<<(i>>1);
-            }
+            printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
+            // if compr=1, two sources share single VGPR field
+            vsrcsUsed |= 1U<<(compr ? (i>>1) : i);
         }
         else
             putChars(bufPtr, "off", 3);
     }
     
     // other modifiers
-    if (insnCode&0x800)
+    if (instr.modifiers & GCNDMOD_DONE)
         putChars(bufPtr, " done", 5);
-    if (insnCode&0x400)
+    if (compr)
         putChars(bufPtr, " compr", 6);
-    if (insnCode&0x1000)
+    if (instr.modifiers & GCNDMOD_VM)
     {
         // VM modifier
         *bufPtr++ = ' ';
@@ -2869,118 +2588,78 @@ void GCNDisasmUtils::decodeEXPEncoding(GCNDisassembler& dasm, cxuint spacesToAdd
     output.forward(bufPtr-bufStart);
 }
 
-// routine to print FLAT address including 'off' for GCN 1.4
-void GCNDisasmUtils::printFLATAddr(cxuint flatMode, char*& bufPtr, uint32_t insnCode2)
-{
-    const cxuint vaddr = insnCode2&0xff;
-    if (flatMode == 0)
-        decodeGCNVRegOperand(vaddr, 2 , bufPtr); // addr
-    else if (flatMode == GCN_FLAT_GLOBAL)
-        decodeGCNVRegOperand(vaddr,
-                // if off in SADDR, then single VGPR offset
-                ((insnCode2>>16)&0x7f) == 0x7f ? 2 : 1, bufPtr); // addr
-    else if (flatMode == GCN_FLAT_SCRATCH)
-    {
-        if (((insnCode2>>16)&0x7f) == 0x7f)
-            decodeGCNVRegOperand(vaddr, 1, bufPtr); // addr
-        else // no vaddr
-            putChars(bufPtr, "off", 3);
-    }
-}
-
-void GCNDisasmUtils::decodeFLATEncoding(GCNDisassembler& dasm, cxuint spacesToAdd,
-            uint16_t arch, const GCNInstruction& gcnInsn, uint32_t insnCode,
+void GCNDisasmUtils::printFLATEncoding(GCNDisassembler& dasm, const GCNDecodedInstr& instr,
+            cxuint spacesToAdd, uint16_t arch, const GCNInstruction& gcnInsn,
             uint32_t insnCode2)
 {
-    const bool isGCN14 = ((arch&ARCH_RXVEGA)!=0);
-    FastOutputBuffer& output = dasm.output;
+    DisasmOutputBuffer& output = dasm.output;
     char* bufStart = output.reserve(150);
     char* bufPtr = bufStart;
     addSpaces(bufPtr, spacesToAdd);
-    bool vdstUsed = false;
-    bool vdataUsed = false;
-    bool saddrUsed = false;
-    const cxuint dregsNum = ((gcnInsn.mode&GCN_DSIZE_MASK)>>GCN_SHIFT2)+1;
-    /// cmpswap store only to half of number of data registers
-    cxuint dstRegsNum = ((gcnInsn.mode & GCN_CMPSWAP)!=0) ? (dregsNum>>1) :  dregsNum;
     const cxuint flatMode = gcnInsn.mode & GCN_FLAT_MODEMASK;
-    // add tfe extra register if needed
-    dstRegsNum = (!isGCN14 && (insnCode2 & 0x800000U)) ? dstRegsNum+1 : dstRegsNum;
-    
-    bool printAddr = false;
-    if ((gcnInsn.mode & GCN_FLAT_ADST) == 0)
-    {
-        vdstUsed = true;
-        // print VDST
-        decodeGCNVRegOperand(insnCode2>>24, dstRegsNum, bufPtr);
-        *bufPtr++ = ',';
-        *bufPtr++ = ' ';
-        printFLATAddr(flatMode, bufPtr, insnCode2);
-        printAddr = true;
-    }
-    else
-    {
-        /* two vregs, because 64-bitness stored in PTR32 mode (at runtime) */
-        printFLATAddr(flatMode, bufPtr, insnCode2);
-        printAddr = true;
-        if ((gcnInsn.mode & GCN_FLAT_NODST) == 0)
+    // SADDR=0x7f means 'off' (no scalar address)
+    const bool saddrOff = ((insnCode2>>16)&0x7f) == 0x7f;
+    // scratch with SADDR have no VADDR
+    const bool addrOff = flatMode == GCN_FLAT_SCRATCH && !saddrOff;
+    const bool vdstUsed = (gcnInsn.mode & GCN_FLAT_ADST) == 0 ||
+                (gcnInsn.mode & GCN_FLAT_NODST) == 0;
+    const bool vdataUsed = (gcnInsn.mode & GCN_FLAT_NODATA) == 0;
+    
+    // print VDST and ADDR in order of instruction operands
+    cxuint opIndex = 0;
+    for (cxuint i = 0; i < 2; i++)
+    {
+        if (i == 1 && !vdstUsed)
+            break;
+        if (i != 0)
         {
-            vdstUsed = true;
             *bufPtr++ = ',';
             *bufPtr++ = ' ';
-            // print VDST
-            decodeGCNVRegOperand(insnCode2>>24, dstRegsNum, bufPtr);
         }
+        if (addrOff && ((i == 0) == ((gcnInsn.mode & GCN_FLAT_ADST) != 0)))
+            putChars(bufPtr, "off", 3);
+        else
+            printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
     }
     
-    if ((gcnInsn.mode & GCN_FLAT_NODATA) == 0) /* print data */
+    if (vdataUsed) /* print data */
     {
-        vdataUsed = true;
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
-        // print DATA field
-        decodeGCNVRegOperand((insnCode2>>8)&0xff, dregsNum, bufPtr);
+        printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
     }
     
-    if (flatMode != 0 && printAddr)
+    if (flatMode != 0)
     {
         // if GLOBAL_ or SCRATCH_
         *bufPtr++ = ',';
         *bufPtr++ = ' ';
-        cxuint saddr = (insnCode2>>16)&0x7f;
-        if ((saddr&0x7f) != 0x7f)
+        if (!saddrOff)
             // print SADDR (GCN 1.4)
-            decodeGCNOperandNoLit(dasm, saddr, flatMode == GCN_FLAT_SCRATCH ? 1 : 2,
-                        bufPtr, arch, FLTLIT_NONE);
+            printDecodedOperandNoLit(dasm, instr, opIndex++, bufPtr, arch);
         else // off
             putChars(bufPtr, "off", 3);
-        saddrUsed = true;
     }
     
-    // get inst_offset, with sign if FLAT_SCRATCH, FLAT_GLOBAL
-    const cxint instOffset = (flatMode != 0 && (insnCode&0x1000) != 0) ?
-                -4096+(insnCode&0xfff) : insnCode&0xfff;
-    if (isGCN14 && instOffset != 0)
+    // inst_offset, with sign if FLAT_SCRATCH, FLAT_GLOBAL
+    if (instr.imm != 0)
     {
         putChars(bufPtr, " inst_offset:", 13);
-        bufPtr += itocstrCStyle(instOffset, bufPtr, 7, 10);
+        bufPtr += itocstrCStyle(cxint(instr.imm), bufPtr, 7, 10);
     }
     
     // print other modifers
-    if (isGCN14 && (insnCode & 0x2000U))
+    if (instr.modifiers & GCNDMOD_LDS)
         putChars(bufPtr, " lds", 4);
-    if (insnCode & 0x10000U)
+    if (instr.modifiers & GCNDMOD_GLC)
         putChars(bufPtr, " glc", 4);
-    if (insnCode & 0x20000U)
+    if (instr.modifiers & GCNDMOD_SLC)
         putChars(bufPtr, " slc", 4);
-    if (insnCode2 & 0x800000U)
-    {
-        if (!isGCN14)
-            putChars(bufPtr, " tfe", 4);
-        else
-            // if GCN 1.4 this bit is NV
-            putChars(bufPtr, " nv", 3);
-    }
+    if (instr.modifiers & GCNDMOD_TFE)
+        putChars(bufPtr, " tfe", 4);
+    if (instr.modifiers & GCNDMOD_NV)
+        // if GCN 1.4 TFE bit is NV
+        putChars(bufPtr, " nv", 3);
     
     // print value, if some are not used, but values is not default
     if (!vdataUsed && ((insnCode2>>8)&0xff) != 0)
@@ -2993,26 +2672,134 @@ void GCNDisasmUtils::decodeFLATEncoding(GCNDisassembler& dasm, cxuint spacesToAd
         putChars(bufPtr, " vdst=", 6);
         bufPtr += itocstrCStyle(insnCode2>>24, bufPtr, 6, 16);
     }
-    if (flatMode != 0 && !saddrUsed && ((insnCode>>16)&0xff) != 0)
+    output.forward(bufPtr-bufStart);
+}
+
+// find instruction by encoding and opcode (includes overrides for GCN 1.1 and GCN 1.4)
+// if instruction is illegal, returns entry from main encoding space and sets isIllegal
+static const GCNInstruction* findGCNInstrByCode(uint16_t curArchMask, bool isGCN124,
+            bool isGCN14, cxbyte gcnEncoding, cxuint opcode, uint32_t insnCode,
+            bool& isIllegal)
+{
+    const GCNEncodingSpace& encSpace = 
+        (isGCN124) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
+          gcnInstrTableByCodeSpaces[gcnEncoding];
+    const GCNInstruction* gcnInsn = gcnInstrTableByCode.get() + encSpace.offset + opcode;
+    const GCNInstruction* overInsn = nullptr;
+    isIllegal = false;
+    if (!isGCN124 && gcnInsn->mnemonic != nullptr &&
+        (curArchMask & gcnInsn->archMask) == 0 &&
+        gcnEncoding == GCNENC_VOP3A)
+    {    /* new overrides (VOP3A) */
+        const GCNEncodingSpace& encSpace2 = gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
+        overInsn = gcnInstrTableByCode.get() + encSpace2.offset + opcode;
+    }
+    else if (isGCN14 && gcnInsn->mnemonic != nullptr &&
+        (curArchMask & gcnInsn->archMask) == 0 &&
+        (gcnEncoding == GCNENC_VOP3A || gcnEncoding == GCNENC_VOP2 ||
+            gcnEncoding == GCNENC_VOP1))
+    {
+        /* new overrides (VOP1/VOP3A/VOP2 for GCN 1.4) */
+        const GCNEncodingSpace& encSpace4 =
+                gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 +
+                        (gcnEncoding != GCNENC_VOP2) + (gcnEncoding == GCNENC_VOP1)];
+        overInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
+    }
+    else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)!=0)
+    {
+        // GLOBAL_/SCRATCH_* instructions
+        const cxuint flatMode = (insnCode>>14)&3;
+        if (flatMode == 3) // 3 - reserved segment
+        {
+            isIllegal = true;
+            return gcnInsn;
+        }
+        const GCNEncodingSpace& encSpace4 =
+            gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 + flatMode-1];
+        overInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
+    }
+    else
+        overInsn = gcnInsn;
+    if (overInsn->mnemonic == nullptr || (curArchMask & overInsn->archMask) == 0)
     {
-        putChars(bufPtr, " saddr=", 7);
-        bufPtr += itocstrCStyle((insnCode2>>16)&0xff, bufPtr, 6, 16);
+        isIllegal = true; // illegal
+        return gcnInsn;
     }
-    output.forward(bufPtr-bufStart);
+    return overInsn;
 }
 
 /* main routine */
 
 void GCNDisassembler::disassemble()
+{
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                disassembler.getDeviceType());
+    const GCNCodeAnalyzer analyzer(input, inputSize, startOffset, arch);
+    const size_t codeWordsNum = analyzer.codeWordsNum;
+    const cxuint chunkThreadsNum = (threadsNum != 0) ? threadsNum :
+                getHardwareThreadsNum();
+    if (chunkThreadsNum <= 1 || codeWordsNum < 2*gcnMinChunkWordsNum)
+    {
+        disassembleRange(0, codeWordsNum);
+        output.flush();
+        output.getOutput().flush();
+        return;
+    }
+    
+    std::vector<size_t> chunkStarts;
+    analyzer.analyzeInChunks(chunkThreadsNum, chunkStarts, nullptr);
+    // zero words are printed as single '.fill', hence move chunk start after them
+    std::vector<size_t> rangeStarts;
+    rangeStarts.push_back(0);
+    for (size_t k = 1; k < chunkStarts.size(); k++)
+    {
+        size_t start = chunkStarts[k];
+        while (start < codeWordsNum && analyzer.codeWords[start] == 0)
+            start++;
+        if (start > rangeStarts.back() && start < codeWordsNum)
+            rangeStarts.push_back(start);
+    }
+    rangeStarts.push_back(codeWordsNum);
+    
+    const size_t rangesNum = rangeStarts.size()-1;
+    std::vector<std::unique_ptr<DisasmMemoryOutput> > rangeOutputs(rangesNum);
+    runParallel(rangesNum, chunkThreadsNum, [&](size_t k)
+    {
+        // presize buffer (about 40 characters per code word)
+        rangeOutputs[k].reset(new DisasmMemoryOutput(
+                    (rangeStarts[k+1]-rangeStarts[k])*40));
+        GCNDisassembler rangeDisasm(disassembler, *rangeOutputs[k]);
+        rangeDisasm.setInput(inputSize, input, startOffset, labelStartOffset);
+        rangeDisasm.sectionIndex = sectionIndex;
+        rangeDisasm.dontPrintLabelsAfterCode = dontPrintLabelsAfterCode;
+        rangeDisasm.instrOutOfCode = instrOutOfCode;
+        rangeDisasm.labels = labels;
+        rangeDisasm.namedLabels = namedLabels;
+        rangeDisasm.relSymbols = relSymbols;
+        rangeDisasm.relocations = relocations;
+        rangeDisasm.disassembleRange(rangeStarts[k], rangeStarts[k+1]);
+        rangeDisasm.output.flush();
+    });
+    // write outputs in original order
+    for (const std::unique_ptr<DisasmMemoryOutput>& rangeOutput: rangeOutputs)
+        output.write(rangeOutput->size(), rangeOutput->data());
+    output.flush();
+    output.getOutput().flush();
+}
+
+void GCNDisassembler::disassembleRange(size_t start, size_t end)
 {
     // select current label and reloc to first
-    LabelIter curLabel = std::lower_bound(labels.begin(), labels.end(), labelStartOffset);
+    LabelIter curLabel = std::lower_bound(labels.begin(), labels.end(),
+                start == 0 ? labelStartOffset :
+                std::max(labelStartOffset, startOffset + (start<<2)));
     RelocIter curReloc = std::lower_bound(relocations.begin(), relocations.end(),
         std::make_pair(startOffset, Relocation()),
           [](const std::pair<size_t,Relocation>& a, const std::pair<size_t, Relocation>& b)
           { return a.first < b.first; });
     NamedLabelIter curNamedLabel = std::lower_bound(namedLabels.begin(), namedLabels.end(),
-        std::make_pair(labelStartOffset, CString()),
+        std::make_pair(start == 0 ? labelStartOffset :
+                std::max(labelStartOffset, startOffset + (start<<2)), CString()),
           [](const std::pair<size_t,CString>& a, const std::pair<size_t, CString>& b)
           { return a.first < b.first; });
     
@@ -3021,37 +2808,45 @@ void GCNDisassembler::disassemble()
     const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
                 disassembler.getDeviceType());
     // set up GCN indicators
-    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
     const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
-    const bool isGCN14 = (arch >= GPUArchitecture::GCN1_4);
     const uint16_t curArchMask = 
             1U<<int(getGPUArchitectureFromDeviceType(disassembler.getDeviceType()));
     const size_t codeWordsNum = (inputSize>>2);
+    const GCNDecoder decoder(arch);
     
-    if ((inputSize&3) != 0)
-        output.write(64,
-           "        /* WARNING: Code size is not aligned to 4-byte word! */\n");
-    if (instrOutOfCode)
-        output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
+    if (start == 0)
+    {
+        if ((inputSize&3) != 0)
+            output.write(64,
+               "        /* WARNING: Code size is not aligned to 4-byte word! */\n");
+        if (instrOutOfCode)
+            output.write(54, "        /* WARNING: Unfinished instruction at end! */\n");
+    }
     
     bool prevIsTwoWord = false;
     
-    size_t pos = 0;
+    size_t pos = start;
     while (true)
     {
+        if (pos >= end && end < codeWordsNum)
+        {
+            // end of range: labels at this position will be written by next range
+            writeLabelsToPosition(pos<<2, curLabel, curNamedLabel, true);
+            return;
+        }
         writeLabelsToPosition(pos<<2, curLabel, curNamedLabel);
         if (pos >= codeWordsNum)
             break;
         
         const size_t oldPos = pos;
-        cxbyte gcnEncoding = GCNENC_NONE;
-        const uint32_t insnCode = ULEV(codeWords[pos++]);
+        const uint32_t insnCode = ULEV(codeWords[pos]);
         if (insnCode == 0)
         {
             /* fix for GalliumCOmpute disassemblying (assembler doesn't accep 
              * with two scalar operands */
             size_t count;
-            for (count = 1; pos < codeWordsNum && codeWords[pos]==0; count++, pos++);
+            for (count = 1, pos++; pos < codeWordsNum && codeWords[pos]==0;
+                        count++, pos++);
             // put to output
             char* buf = output.reserve(40);
             size_t bufPos = 0;
@@ -3063,132 +2858,13 @@ void GCNDisassembler::disassemble()
             output.forward(bufPos);
             continue;
         }
-        uint32_t insnCode2 = 0;
-        
         
-        /* determine GCN encoding */
-        if ((insnCode & 0x80000000U) != 0)
-        {
-            if ((insnCode & 0x40000000U) == 0)
-            {
-                // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {
-                    // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {
-                        // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                        gcnEncoding = GCNENC_SOP1;
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {
-                        // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                        gcnEncoding = GCNENC_SOPC;
-                    }
-                    else if (encPart == 0x0f800000U) // SOPP
-                        gcnEncoding = GCNENC_SOPP;
-                    else // SOPK
-                    {
-                        gcnEncoding = GCNENC_SOPK;
-                        const uint32_t opcode = ((insnCode>>23)&0x1f);
-                        if ((!isGCN124 && opcode == 21) ||
-                            (isGCN124 && opcode == 20))
-                        {
-                            if (pos < codeWordsNum)
-                                insnCode2 = ULEV(codeWords[pos++]);
-                        }
-                    }
-                }
-                else
-                {
-                    // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                    {
-                        // literal
-                        if (pos < codeWordsNum)
-                            insnCode2 = ULEV(codeWords[pos++]);
-                    }
-                    gcnEncoding = GCNENC_SOP2;
-                }
-            }
-            else
-            {
-                // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN124 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN124 && gcnSize12Table[encPart]))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                if (isGCN124)
-                    gcnEncoding = gcnEncoding12Table[encPart];
-                else
-                    gcnEncoding = gcnEncoding11Table[encPart];
-                if (gcnEncoding == GCNENC_FLAT && !isGCN11 && !isGCN124)
-                    gcnEncoding = GCNENC_NONE; // illegal if not GCN1.1
-            }
-        }
-        else
-        {
-            // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {
-                // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOPC;
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {
-                // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOP1;
-            }
-            else
-            {
-                // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN124 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN124 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN124 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum)
-                        insnCode2 = ULEV(codeWords[pos++]);
-                }
-                gcnEncoding = GCNENC_VOP2;
-            }
-        }
+        /* decode instruction (text output is formatted from decoded record) */
+        GCNDecodedInstr instr;
+        pos = std::min(decoder.decode(inputSize, input, oldPos<<2, instr)>>2,
+                    codeWordsNum);
+        // literal, SDWA, DPP or second dword
+        const uint32_t insnCode2 = (pos == oldPos+2) ? ULEV(codeWords[oldPos+1]) : 0;
         
         prevIsTwoWord = (oldPos+2 == pos);
         
@@ -3242,7 +2918,7 @@ void GCNDisassembler::disassemble()
             }
         }
         
-        if (gcnEncoding == GCNENC_NONE)
+        if (instr.encoding == GCNENC_NONE)
         {
             // invalid encoding
             char* buf = output.reserve(24);
@@ -3257,66 +2933,14 @@ void GCNDisassembler::disassemble()
         }
         else
         {
-            const GCNEncodingOpcodeBits* encodingOpcodeTable = 
-                    (isGCN124) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
-            const cxuint opcode =
-                    (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
-                    ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
-            
-            /* decode instruction and put to output */
-            const GCNEncodingSpace& encSpace = 
-                (isGCN124) ? gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+3 + gcnEncoding] :
-                  gcnInstrTableByCodeSpaces[gcnEncoding];
-            const GCNInstruction* gcnInsn = gcnInstrTableByCode.get() +
-                    encSpace.offset + opcode;
-            
-            const GCNInstruction defaultInsn = { nullptr, gcnInsn->encoding, GCN_STDMODE,
+            const GCNInstruction defaultInsn = { nullptr, instr.encoding, GCN_STDMODE,
                         0, 0 };
+            const GCNInstruction* gcnInsn = &defaultInsn;
             cxuint spacesToAdd = 16;
-            bool isIllegal = false;
-            if (!isGCN124 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                gcnEncoding == GCNENC_VOP3A)
-            {    /* new overrides (VOP3A) */
-                const GCNEncodingSpace& encSpace2 =
-                        gcnInstrTableByCodeSpaces[GCNENC_MAXVAL+1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace2.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (isGCN14 && gcnInsn->mnemonic != nullptr &&
-                (curArchMask & gcnInsn->archMask) == 0 &&
-                (gcnEncoding == GCNENC_VOP3A || gcnEncoding == GCNENC_VOP2 ||
-                    gcnEncoding == GCNENC_VOP1))
-            {
-                /* new overrides (VOP1/VOP3A/VOP2 for GCN 1.4) */
-                const GCNEncodingSpace& encSpace4 =
-                        gcnInstrTableByCodeSpaces[2*GCNENC_MAXVAL+4 +
-                                (gcnEncoding != GCNENC_VOP2) +
-                                (gcnEncoding == GCNENC_VOP1)];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (isGCN14 && gcnEncoding == GCNENC_FLAT && ((insnCode>>14)&3)!=0)
-            {
-                // GLOBAL_/SCRATCH_* instructions
-                const GCNEncodingSpace& encSpace4 =
-                    gcnInstrTableByCodeSpaces[2*(GCNENC_MAXVAL+1)+2+3 +
-                        ((insnCode>>14)&3)-1];
-                gcnInsn = gcnInstrTableByCode.get() + encSpace4.offset + opcode;
-                if (gcnInsn->mnemonic == nullptr ||
-                        (curArchMask & gcnInsn->archMask) == 0)
-                    isIllegal = true; // illegal
-            }
-            else if (gcnInsn->mnemonic == nullptr ||
-                (curArchMask & gcnInsn->archMask) == 0)
-                isIllegal = true;
             
-            if (!isIllegal)
+            if (instr.mnemonicId != GCNDecodedIllegal)
             {
+                gcnInsn = gcnInstrTableByCode.get() + instr.mnemonicId;
                 // put spaces between mnemonic and operands
                 size_t k = ::strlen(gcnInsn->mnemonic);
                 output.writeString(gcnInsn->mnemonic);
@@ -3327,17 +2951,19 @@ void GCNDisassembler::disassemble()
                 // print illegal instruction mnemonic
                 char* bufStart = output.reserve(40);
                 char* bufPtr = bufStart;
-                if (!isGCN124 || gcnEncoding != GCNENC_SMEM)
-                    putChars(bufPtr, gcnEncodingNames[gcnEncoding],
-                            ::strlen(gcnEncodingNames[gcnEncoding]));
+                // VOP3B is only decoded form of VOP3A encoding
+                const cxbyte encName = (instr.encoding == GCNENC_VOP3B) ?
+                            cxbyte(GCNENC_VOP3A) : instr.encoding;
+                if (!isGCN124 || encName != GCNENC_SMEM)
+                    putChars(bufPtr, gcnEncodingNames[encName],
+                            ::strlen(gcnEncodingNames[encName]));
                 else /* SMEM encoding */
                     putChars(bufPtr, "SMEM", 4);
                 putChars(bufPtr, "_ill_", 5);
                 // opcode value
-                bufPtr += itocstrCStyle(opcode, bufPtr , 6);
+                bufPtr += itocstrCStyle(instr.opcode, bufPtr , 6);
                 const size_t linePos = bufPtr-bufStart;
                 spacesToAdd = spacesToAdd >= (linePos+1)? spacesToAdd - linePos : 1;
-                gcnInsn = &defaultInsn;
                 output.forward(bufPtr-bufStart);
             }
             
@@ -3349,79 +2975,79 @@ void GCNDisassembler::disassemble()
                      FLTLIT_NONE) : FLTLIT_NONE;
             
             // print instruction in correct encoding
-            switch(gcnEncoding)
+            switch(instr.encoding)
             {
                 case GCNENC_SOPC:
-                    GCNDisasmUtils::decodeSOPCEncoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printSOPCEncoding(*this, instr, pos, curReloc,
+                               spacesToAdd, curArchMask);
                     break;
                 case GCNENC_SOPP:
-                    GCNDisasmUtils::decodeSOPPEncoding(*this, spacesToAdd, curArchMask, 
-                                 *gcnInsn, insnCode, insnCode2, pos);
+                    GCNDisasmUtils::printSOPPEncoding(*this, instr, spacesToAdd,
+                               curArchMask, *gcnInsn, pos);
                     break;
                 case GCNENC_SOP1:
-                    GCNDisasmUtils::decodeSOP1Encoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printSOP1Encoding(*this, instr, pos, curReloc,
+                               spacesToAdd, curArchMask, insnCode);
                     break;
                 case GCNENC_SOP2:
-                    GCNDisasmUtils::decodeSOP2Encoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printSOP2Encoding(*this, instr, pos, curReloc,
+                               spacesToAdd, curArchMask, insnCode);
                     break;
                 case GCNENC_SOPK:
-                    GCNDisasmUtils::decodeSOPKEncoding(*this, pos, curReloc,
-                               spacesToAdd, curArchMask, *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printSOPKEncoding(*this, instr, pos, curReloc,
+                               spacesToAdd, curArchMask, *gcnInsn, insnCode);
                     break;
                 case GCNENC_SMRD:
                     if (isGCN124)
-                        GCNDisasmUtils::decodeSMEMEncoding(*this, spacesToAdd, curArchMask,
-                                  *gcnInsn, insnCode, insnCode2);
+                        GCNDisasmUtils::printSMEMEncoding(*this, instr, spacesToAdd,
+                                  curArchMask, *gcnInsn, insnCode, insnCode2);
                     else
-                        GCNDisasmUtils::decodeSMRDEncoding(*this, spacesToAdd, curArchMask,
-                                  *gcnInsn, insnCode);
+                        GCNDisasmUtils::printSMRDEncoding(*this, instr, spacesToAdd,
+                                  curArchMask, *gcnInsn, insnCode);
                     break;
                 case GCNENC_VOPC:
-                    GCNDisasmUtils::decodeVOPCEncoding(*this, pos, curReloc, spacesToAdd,
-                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
+                    GCNDisasmUtils::printVOPCEncoding(*this, instr, pos, curReloc,
+                           spacesToAdd, curArchMask, insnCode2, displayFloatLits);
                     break;
                 case GCNENC_VOP1:
-                    GCNDisasmUtils::decodeVOP1Encoding(*this, pos, curReloc, spacesToAdd,
-                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
+                    GCNDisasmUtils::printVOP1Encoding(*this, instr, pos, curReloc,
+                           spacesToAdd, curArchMask, insnCode, insnCode2,
+                           displayFloatLits);
                     break;
                 case GCNENC_VOP2:
-                    GCNDisasmUtils::decodeVOP2Encoding(*this, pos, curReloc, spacesToAdd,
-                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
+                    GCNDisasmUtils::printVOP2Encoding(*this, instr, pos, curReloc,
+                           spacesToAdd, curArchMask, *gcnInsn, insnCode2,
+                           displayFloatLits);
                     break;
                 case GCNENC_VOP3A:
-                    GCNDisasmUtils::decodeVOP3Encoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2, displayFloatLits);
+                case GCNENC_VOP3B:
+                    GCNDisasmUtils::printVOP3Encoding(*this, instr, spacesToAdd,
+                           curArchMask, *gcnInsn, insnCode, insnCode2, displayFloatLits);
                     break;
                 case GCNENC_VINTRP:
-                    GCNDisasmUtils::decodeVINTRPEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode);
+                    GCNDisasmUtils::printVINTRPEncoding(*this, instr, spacesToAdd,
+                           curArchMask);
                     break;
                 case GCNENC_DS:
-                    GCNDisasmUtils::decodeDSEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printDSEncoding(*this, instr, spacesToAdd,
+                           curArchMask, *gcnInsn, insnCode2);
                     break;
                 case GCNENC_MUBUF:
-                    GCNDisasmUtils::decodeMUBUFEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
-                    break;
                 case GCNENC_MTBUF:
-                    GCNDisasmUtils::decodeMUBUFEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printMUBUFEncoding(*this, instr, spacesToAdd,
+                           curArchMask, *gcnInsn, insnCode2);
                     break;
                 case GCNENC_MIMG:
-                    GCNDisasmUtils::decodeMIMGEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printMIMGEncoding(*this, instr, spacesToAdd,
+                           curArchMask, insnCode2);
                     break;
                 case GCNENC_EXP:
-                    GCNDisasmUtils::decodeEXPEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printEXPEncoding(*this, instr, spacesToAdd,
+                           curArchMask, insnCode2);
                     break;
                 case GCNENC_FLAT:
-                    GCNDisasmUtils::decodeFLATEncoding(*this, spacesToAdd, curArchMask,
-                                 *gcnInsn, insnCode, insnCode2);
+                    GCNDisasmUtils::printFLATEncoding(*this, instr, spacesToAdd,
+                           curArchMask, *gcnInsn, insnCode2);
                     break;
                 default:
                     break;
@@ -3431,6 +3057,586 @@ void GCNDisassembler::disassemble()
     }
     if (!dontPrintLabelsAfterCode)
         writeLabelsToEnd(codeWordsNum<<2, curLabel, curNamedLabel);
-    output.flush();
-    disassembler.getOutput().flush();
+}
+
+/* GCN decoder (decodes instructions to records without printing) */
+
+GCNDecoder::GCNDecoder(GPUArchitecture _arch) : arch(_arch),
+        encTable(getGCNEncodingTable(_arch))
+{
+    callOnce(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+}
+
+const char* GCNDecoder::getMnemonic(uint16_t mnemonicId)
+{
+    callOnce(clrxGCNDisasmOnceFlag, initializeGCNDisassembler);
+    if (mnemonicId >= gcnInstrTableByCodeLength)
+        return nullptr;
+    return gcnInstrTableByCode[mnemonicId].mnemonic;
+}
+
+size_t GCNDecoder::printOperand(const GCNDecodedInstr& instr, cxuint index,
+            char* buf) const
+{
+    const GCNDecodedOperand& op = instr.operands[index];
+    if (op.code == 255)
+        // literal
+        return itocstrCStyle(instr.literal, buf, 32, 16);
+    char* bufPtr = buf;
+    printGCNOperandNoLit(op.code, op.regsNum, bufPtr, 1U<<int(arch), FLTLIT_NONE, 0);
+    return bufPtr-buf;
+}
+
+// add operand to decoded instruction
+static inline void addDecodedOperand(GCNDecodedInstr& instr, cxuint code,
+            cxuint regsNum, cxbyte flags)
+{
+    GCNDecodedOperand& op = instr.operands[instr.operandsNum++];
+    op.code = code;
+    op.regsNum = regsNum;
+    op.flags = flags;
+}
+
+// get flags of VDATA/SDATA operand of memory instruction
+static inline cxbyte getMemDataOperandFlags(uint16_t mode, bool glc)
+{
+    if ((mode & GCN_MLOAD) != 0)
+        return GCNDOP_DST;
+    if ((mode & GCN_MATOMIC) != 0) // atomics returns data if glc
+        return GCNDOP_SRC | (glc ? GCNDOP_DST : 0);
+    return GCNDOP_SRC;
+}
+
+// get flags of SRC0 of VOP encoding (with SDWA/DPP modifiers)
+static inline cxbyte getVOPSrc0Flags(const VOPExtraWordOut& extraFlags)
+{
+    return GCNDOP_SRC | (extraFlags.negSrc0 ? GCNDOP_NEG : 0) |
+            (extraFlags.absSrc0 ? GCNDOP_ABS : 0) | (extraFlags.sextSrc0 ? GCNDOP_SEXT : 0);
+}
+
+// get flags of SRC1 of VOP encoding (with SDWA/DPP modifiers)
+static inline cxbyte getVOPSrc1Flags(const VOPExtraWordOut& extraFlags)
+{
+    return GCNDOP_SRC | (extraFlags.negSrc1 ? GCNDOP_NEG : 0) |
+            (extraFlags.absSrc1 ? GCNDOP_ABS : 0) | (extraFlags.sextSrc1 ? GCNDOP_SEXT : 0);
+}
+
+// decode VOP3 operands and modifiers
+static void decodeVOP3Fields(GCNDecodedInstr& instr, bool isGCN12, bool isGCN14,
+            const GCNInstruction& gcnInsn, uint32_t insnCode, uint32_t insnCode2)
+{
+    const uint16_t mode1 = (gcnInsn.mode & GCN_MASK1);
+    const uint16_t vop3Mode = (gcnInsn.mode & GCN_VOP3_MASK2);
+    const cxuint vdst = insnCode&0xff;
+    const cxuint vsrc0 = insnCode2&0x1ff;
+    const cxuint vsrc1 = (insnCode2>>9)&0x1ff;
+    const cxuint vsrc2 = (insnCode2>>18)&0x1ff;
+    const bool isVOP3P = (vop3Mode == GCN_VOP3_VOP3P);
+    const bool is128Ops = (gcnInsn.mode&0x7000)==GCN_VOP3_DS2_128;
+    
+    const cxuint absFlags = (gcnInsn.encoding == GCNENC_VOP3A && !isVOP3P) ?
+                (insnCode>>8)&7 : 0;
+    const cxuint negFlags = (insnCode2>>29)&7;
+    const cxuint negHiFlags = isVOP3P ? (insnCode>>8)&7 : 0;
+    cxbyte srcFlags[3];
+    for (cxuint i = 0; i < 3; i++)
+        srcFlags[i] = GCNDOP_SRC | (((negFlags>>i)&1) ? GCNDOP_NEG : 0) |
+                (((absFlags>>i)&1) ? GCNDOP_ABS : 0) |
+                (((negHiFlags>>i)&1) ? GCNDOP_NEG_HI : 0);
+    
+    if (mode1 != GCN_VOP_ARG_NONE)
+    {
+        if (instr.opcode < 256 || (gcnInsn.mode&GCN_VOP3_DST_SGPR) != 0)
+            // compares (destination is SGPR)
+            addDecodedOperand(instr, vdst, ((gcnInsn.mode&GCN_VOP3_DST_SGPR)==0)?2:1,
+                        GCNDOP_DST);
+        else
+            addDecodedOperand(instr, vdst+256, is128Ops ? 4 :
+                        ((gcnInsn.mode&GCN_REG_DST_64)?2:1), GCNDOP_DST);
+        
+        if (gcnInsn.encoding == GCNENC_VOP3B &&
+            (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC || mode1 == GCN_DST_VCC_VSRC2 ||
+             mode1 == GCN_S0EQS12))
+            // SDST (VOP3B)
+            addDecodedOperand(instr, (insnCode>>8)&0x7f, 2, GCNDOP_DST);
+        
+        if (vop3Mode == GCN_VOP3_VINTRP)
+        {
+            // VINTRP attribute and channel
+            instr.format = (vsrc0&63) | (((vsrc0>>6)&3)<<6);
+            if (vsrc0 & 0x100)
+                instr.modifiers |= GCNDMOD_HIGH;
+            if (mode1 == GCN_P0_P10_P20)
+                instr.imm = vsrc1;
+            else
+                addDecodedOperand(instr, vsrc1, 1, srcFlags[1]);
+            if ((gcnInsn.mode & GCN_VOP3_MASK3) == GCN_VINTRP_SRC2)
+                addDecodedOperand(instr, vsrc2, 1, srcFlags[2]);
+        }
+        else
+        {
+            addDecodedOperand(instr, vsrc0, (gcnInsn.mode&GCN_REG_SRC0_64)?2:1,
+                        srcFlags[0]);
+            if (mode1 != GCN_SRC12_NONE)
+            {
+                addDecodedOperand(instr, vsrc1, (gcnInsn.mode&GCN_REG_SRC1_64)?2:1,
+                        srcFlags[1]);
+                if (mode1 != GCN_SRC2_NONE && mode1 != GCN_DST_VCC &&
+                    instr.opcode >= 256)
+                {
+                    if (mode1 == GCN_DS2_VCC || mode1 == GCN_SRC2_VCC)
+                        addDecodedOperand(instr, vsrc2, 2, GCNDOP_SRC);
+                    else
+                        addDecodedOperand(instr, vsrc2, is128Ops ? 4 :
+                                (gcnInsn.mode&GCN_REG_SRC2_64)?2:1, srcFlags[2]);
+                }
+            }
+        }
+    }
+    
+    if (isGCN14 && gcnInsn.encoding != GCNENC_VOP3B)
+        instr.opsel = isVOP3P ? ((insnCode>>11)&7) |
+                ((((insnCode2>>27)&3) | ((insnCode>>12)&4))<<4) : (insnCode>>11)&15;
+    if (!isVOP3P)
+        instr.omod = (insnCode2>>27)&3;
+    if ((!isGCN12 && gcnInsn.encoding == GCNENC_VOP3A && (insnCode&0x800) != 0) ||
+            (isGCN12 && (insnCode&0x8000) != 0))
+        instr.modifiers |= GCNDMOD_CLAMP;
+}
+
+size_t GCNDecoder::decode(size_t codeSize, const cxbyte* code, size_t pos,
+            GCNDecodedInstr& instr) const
+{
+    const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(code);
+    const size_t codeWordsNum = (codeSize>>2);
+    const size_t wordPos = (pos>>2);
+    const bool isGCN124 = (arch >= GPUArchitecture::GCN1_2);
+    const bool isGCN14 = (arch >= GPUArchitecture::GCN1_4);
+    const uint16_t curArchMask = 1U<<int(arch);
+    
+    const uint32_t insnCode = ULEV(codeWords[wordPos]);
+    const GCNEncodingEntry& encEntry = getGCNEncodingEntry(encTable, insnCode);
+    const cxuint wordsNum = getGCNInstrWordsNum(encEntry, insnCode);
+    const uint32_t insnCode2 = (wordsNum == 2 && wordPos+1 < codeWordsNum) ?
+                ULEV(codeWords[wordPos+1]) : 0;
+    const cxbyte gcnEncoding = encEntry.encoding;
+    
+    instr.offset = pos;
+    instr.mnemonicId = GCNDecodedIllegal;
+    instr.opcode = 0;
+    instr.encoding = gcnEncoding;
+    instr.wordsNum = wordsNum;
+    instr.operandsNum = 0;
+    instr.extra = GCNDEXTRA_NONE;
+    instr.literal = 0;
+    instr.imm = 0;
+    instr.modifiers = 0;
+    instr.omod = 0;
+    instr.opsel = 0;
+    instr.mask = 0;
+    instr.format = 0;
+    instr.dpp = { 0, 0, 0 };
+    
+    const size_t nextPos = pos + (wordsNum<<2);
+    if (gcnEncoding == GCNENC_NONE)
+        return nextPos;
+    
+    const GCNEncodingOpcodeBits* encodingOpcodeTable = 
+            (isGCN124) ? gcnEncodingOpcode12Table : gcnEncodingOpcodeTable;
+    const cxuint opcode = (insnCode>>encodingOpcodeTable[gcnEncoding].bitPos) & 
+            ((1U<<encodingOpcodeTable[gcnEncoding].bits)-1U);
+    instr.opcode = opcode;
+    bool isIllegal = false;
+    const GCNInstruction* gcnInsn = findGCNInstrByCode(curArchMask, isGCN124,
+                isGCN14, gcnEncoding, opcode, insnCode, isIllegal);
+    // operands of illegal instruction are decoded in standard mode
+    const GCNInstruction defaultInsn = { nullptr, gcnInsn->encoding, GCN_STDMODE, 0, 0 };
+    if (isIllegal)
+        gcnInsn = &defaultInsn;
+    else
+        instr.mnemonicId = gcnInsn - gcnInstrTableByCode.get();
+    
+    const uint16_t mode = gcnInsn->mode;
+    const uint16_t mode1 = (mode & GCN_MASK1);
+    // extra dword: literal, SDWA or DPP
+    VOPExtraWordOut extraFlags = { uint16_t(insnCode&0x1ff), 0, 0, 0, 0, 0, 0, 0 };
+    if (wordsNum == 2)
+    {
+        const cxuint src0Field = insnCode&0x1ff;
+        // V_MADMK and V_MADAK with SDWA or DPP use extra dword also as literal
+        // (like text disassembler)
+        const bool vopExt = encEntry.literal == GCNLIT_VSRC0_EXT ||
+                (isGCN124 && gcnEncoding == GCNENC_VOP2);
+        if (vopExt && (src0Field == 0xf9 || src0Field == 0xfa) &&
+            encEntry.literal == GCNLIT_NONE)
+            instr.literal = insnCode2;
+        if (vopExt && src0Field == 0xf9)
+        {
+            instr.extra = GCNDEXTRA_SDWA;
+            extraFlags = decodeVOPSDWAFlags(insnCode2, curArchMask);
+            instr.sdwa.src0Sel = (insnCode2>>16)&7;
+            instr.sdwa.src1Sel = (insnCode2>>24)&7;
+            if (!isGCN14 || gcnEncoding != GCNENC_VOPC)
+            {
+                instr.sdwa.dstSel = (insnCode2>>8)&7;
+                instr.sdwa.dstUnused = (insnCode2>>11)&3;
+                if (isGCN14)
+                    instr.omod = (insnCode2>>14)&3;
+                if (insnCode2 & 0x2000)
+                    instr.modifiers |= GCNDMOD_CLAMP;
+            }
+            else
+                instr.sdwa.dstSel = 6; // VOPC in GCN 1.4 (dword)
+        }
+        else if (vopExt && src0Field == 0xfa)
+        {
+            instr.extra = GCNDEXTRA_DPP;
+            extraFlags = decodeVOPDPPFlags(insnCode2);
+            instr.dpp.dppCtrl = (insnCode2>>8)&0x1ff;
+            instr.dpp.bankMask = (insnCode2>>24)&15;
+            instr.dpp.rowMask = (insnCode2>>28)&15;
+            if (insnCode2 & 0x80000)
+                instr.modifiers |= GCNDMOD_BOUND_CTRL;
+        }
+        else if (encEntry.literal != GCNLIT_NONE || gcnEncoding == GCNENC_SOPK ||
+                gcnEncoding == GCNENC_VOP2)
+        {
+            instr.extra = GCNDEXTRA_LITERAL;
+            instr.literal = insnCode2;
+        }
+    }
+    
+    switch(gcnEncoding)
+    {
+        case GCNENC_SOPC:
+            addDecodedOperand(instr, insnCode&0xff, (mode&GCN_REG_SRC0_64)?2:1,
+                        GCNDOP_SRC);
+            if ((mode & GCN_SRC1_IMM) != 0)
+                instr.imm = (insnCode>>8)&0xff;
+            else
+                addDecodedOperand(instr, (insnCode>>8)&0xff, (mode&GCN_REG_SRC1_64)?2:1,
+                        GCNDOP_SRC);
+            break;
+        case GCNENC_SOPP:
+            instr.imm = insnCode&0xffff;
+            break;
+        case GCNENC_SOP1:
+            if (mode1 != GCN_DST_NONE)
+                addDecodedOperand(instr, (insnCode>>16)&0x7f, (mode&GCN_REG_DST_64)?2:1,
+                        GCNDOP_DST);
+            if (mode1 != GCN_SRC_NONE)
+                addDecodedOperand(instr, insnCode&0xff, (mode&GCN_REG_SRC0_64)?2:1,
+                        GCNDOP_SRC);
+            break;
+        case GCNENC_SOP2:
+            if (mode1 != GCN_DST_NONE)
+                addDecodedOperand(instr, (insnCode>>16)&0x7f, (mode&GCN_REG_DST_64)?2:1,
+                        GCNDOP_DST);
+            addDecodedOperand(instr, insnCode&0xff, (mode&GCN_REG_SRC0_64)?2:1,
+                        GCNDOP_SRC);
+            addDecodedOperand(instr, (insnCode>>8)&0xff, (mode&GCN_REG_SRC1_64)?2:1,
+                        GCNDOP_SRC);
+            break;
+        case GCNENC_SOPK:
+            instr.imm = insnCode&0xffff;
+            if ((mode & GCN_IMM_DST) == 0)
+                addDecodedOperand(instr, (insnCode>>16)&0x7f, (mode&GCN_REG_DST_64)?2:1,
+                        (mode1 == GCN_DST_SRC) ? GCNDOP_SRC : GCNDOP_DST);
+            else if ((mode & GCN_SOPK_CONST) == 0)
+                // s_setreg_b32: SDST is source
+                addDecodedOperand(instr, (insnCode>>16)&0x7f, (mode&GCN_REG_DST_64)?2:1,
+                        GCNDOP_SRC);
+            break;
+        case GCNENC_SMRD:
+            if (!isGCN124)
+            {
+                if (mode1 == GCN_SMRD_ONLYDST)
+                    addDecodedOperand(instr, (insnCode>>15)&0x7f,
+                            (mode&GCN_REG_DST_64)?2:1, GCNDOP_DST);
+                else if (mode1 != GCN_ARG_NONE)
+                {
+                    addDecodedOperand(instr, (insnCode>>15)&0x7f,
+                            1<<((mode & GCN_DSIZE_MASK)>>GCN_SHIFT2), GCNDOP_DST);
+                    addDecodedOperand(instr, (insnCode>>8)&0x7e, (mode&GCN_SBASE4)?4:2,
+                            GCNDOP_SRC);
+                    if (insnCode&0x100)
+                    {
+                        instr.imm = insnCode&0xff;
+                        instr.modifiers |= GCNDMOD_IMM_OFFSET;
+                    }
+                    else
+                        addDecodedOperand(instr, insnCode&0xff, 1, GCNDOP_SRC);
+                }
+                break;
+            }
+            // SMEM encoding
+            if ((insnCode & 0x10000) != 0)
+                instr.modifiers |= GCNDMOD_GLC;
+            if (isGCN14 && (insnCode & 0x8000) != 0)
+                instr.modifiers |= GCNDMOD_NV;
+            if (mode1 == GCN_SMRD_ONLYDST)
+                addDecodedOperand(instr, (insnCode>>6)&0x7f,
+                        (mode&GCN_REG_DST_64)?2:1, GCNDOP_DST);
+            else if (mode1 != GCN_ARG_NONE)
+            {
+                if ((mode1 & GCN_SMEM_NOSDATA) == 0)
+                {
+                    if ((mode1 & GCN_SMEM_SDATA_IMM) != 0)
+                        instr.mask = (insnCode>>6)&0x7f;
+                    else
+                        addDecodedOperand(instr, (insnCode>>6)&0x7f,
+                                1<<((mode & GCN_DSIZE_MASK)>>GCN_SHIFT2),
+                                getMemDataOperandFlags(mode, (insnCode & 0x10000) != 0));
+                }
+                addDecodedOperand(instr, (insnCode<<1)&0x7e, (mode&GCN_SBASE4)?4:2,
+                        GCNDOP_SRC);
+                const bool soffsetInCode2 = isGCN14 && (insnCode & 0x4000) != 0;
+                if (insnCode&0x20000)
+                {
+                    instr.modifiers |= GCNDMOD_IMM_OFFSET;
+                    if (soffsetInCode2)
+                        addDecodedOperand(instr, insnCode2>>25, 1, GCNDOP_SRC);
+                    instr.imm = insnCode2 & (isGCN14 ? 0x1fffff : 0xfffff);
+                }
+                else
+                    addDecodedOperand(instr, soffsetInCode2 ? insnCode2>>25 :
+                            insnCode2&0xff, 1, GCNDOP_SRC);
+            }
+            break;
+        case GCNENC_VOPC:
+            if (isGCN14 && instr.extra == GCNDEXTRA_SDWA && (insnCode2 & 0x8000) != 0)
+                // SDWAB replacement of SDST
+                addDecodedOperand(instr, (insnCode2>>8)&0x7f, 2, GCNDOP_DST);
+            else
+                addDecodedOperand(instr, 106, 2, GCNDOP_DST); // VCC
+            addDecodedOperand(instr, extraFlags.src0, (mode&GCN_REG_SRC0_64)?2:1,
+                        getVOPSrc0Flags(extraFlags));
+            addDecodedOperand(instr, ((insnCode>>9)&0xff) +
+                        (extraFlags.scalarSrc1 ? 0 : 256), (mode&GCN_REG_SRC1_64)?2:1,
+                        getVOPSrc1Flags(extraFlags));
+            break;
+        case GCNENC_VOP1:
+            if (mode1 != GCN_VOP_ARG_NONE)
+            {
+                addDecodedOperand(instr, ((insnCode>>17)&0xff) +
+                        (mode1 != GCN_DST_SGPR ? 256 : 0), (mode&GCN_REG_DST_64)?2:1,
+                        GCNDOP_DST);
+                addDecodedOperand(instr, extraFlags.src0, (mode&GCN_REG_SRC0_64)?2:1,
+                        getVOPSrc0Flags(extraFlags));
+            }
+            break;
+        case GCNENC_VOP2:
+            addDecodedOperand(instr, ((insnCode>>17)&0xff) +
+                    (mode1 != GCN_DS1_SGPR ? 256 : 0), (mode&GCN_REG_DST_64)?2:1,
+                    GCNDOP_DST);
+            if (mode1 == GCN_DS2_VCC || mode1 == GCN_DST_VCC)
+                addDecodedOperand(instr, 106, 2, GCNDOP_DST);
+            addDecodedOperand(instr, extraFlags.src0, (mode&GCN_REG_SRC0_64)?2:1,
+                    getVOPSrc0Flags(extraFlags));
+            addDecodedOperand(instr, ((insnCode>>9)&0xff) +
+                    ((mode1 == GCN_DS1_SGPR || mode1 == GCN_SRC1_SGPR ||
+                        extraFlags.scalarSrc1) ? 0 : 256),
+                    (mode&GCN_REG_SRC1_64)?2:1, getVOPSrc1Flags(extraFlags));
+            if (mode1 == GCN_DS2_VCC || mode1 == GCN_SRC2_VCC)
+                addDecodedOperand(instr, 106, 2, GCNDOP_SRC);
+            break;
+        case GCNENC_VOP3A:
+        case GCNENC_VOP3B:
+            if (gcnInsn->encoding != GCNENC_NONE)
+                instr.encoding = gcnInsn->encoding;
+            decodeVOP3Fields(instr, isGCN124, isGCN14, *gcnInsn, insnCode, insnCode2);
+            break;
+        case GCNENC_VINTRP:
+            addDecodedOperand(instr, ((insnCode>>18)&0xff)+256, 1, GCNDOP_DST);
+            if (mode1 == GCN_P0_P10_P20)
+                instr.imm = insnCode&0xff;
+            else
+                addDecodedOperand(instr, (insnCode&0xff)+256, 1, GCNDOP_SRC);
+            instr.format = ((insnCode>>10)&63) | (((insnCode>>8)&3)<<6);
+            break;
+        case GCNENC_DS:
+        {
+            instr.imm = insnCode&0xffff;
+            if ((!isGCN124 && (insnCode&0x20000)!=0) || (isGCN124 && (insnCode&0x10000)!=0))
+                instr.modifiers |= GCNDMOD_GDS;
+            const bool onlyDst = (mode & GCN_ONLYDST) != 0;
+            const bool onlySrc = (mode & GCN_ONLY_SRC) != 0;
+            if (((mode & GCN_ADDR_SRC) != 0 || onlyDst) && !onlySrc)
+            {
+                cxuint regsNum = (mode&GCN_REG_DST_64)?2:1;
+                if ((mode&GCN_DS_96) != 0)
+                    regsNum = 3;
+                if ((mode&GCN_DS_128) != 0 || (mode&GCN_DST128) != 0)
+                    regsNum = 4;
+                addDecodedOperand(instr, (insnCode2>>24)+256, regsNum, GCNDOP_DST);
+            }
+            if (!onlyDst && !onlySrc)
+                addDecodedOperand(instr, (insnCode2&0xff)+256, 1, GCNDOP_SRC);
+            if (!onlyDst && (mode & (GCN_ADDR_DST|GCN_ADDR_SRC)) != 0 &&
+                (mode & GCN_SRCS_MASK) != GCN_NOSRC)
+            {
+                cxuint regsNum = (mode&GCN_REG_SRC0_64)?2:1;
+                if ((mode&GCN_DS_96) != 0)
+                    regsNum = 3;
+                if ((mode&GCN_DS_128) != 0)
+                    regsNum = 4;
+                addDecodedOperand(instr, ((insnCode2>>8)&0xff)+256, regsNum, GCNDOP_SRC);
+                if ((mode & GCN_SRCS_MASK) == GCN_2SRCS)
+                    addDecodedOperand(instr, ((insnCode2>>16)&0xff)+256,
+                                (mode&GCN_REG_SRC1_64)?2:1, GCNDOP_SRC);
+            }
+            break;
+        }
+        case GCNENC_MUBUF:
+        case GCNENC_MTBUF:
+        {
+            const bool glc = (insnCode & 0x4000U) != 0;
+            if (mode1 != GCN_ARG_NONE)
+            {
+                if (mode1 != GCN_MUBUF_NOVAD)
+                {
+                    cxuint dregsNum = ((mode&GCN_DSIZE_MASK)>>GCN_SHIFT2)+1;
+                    if ((mode & GCN_MUBUF_D16)!=0 && isGCN14)
+                        dregsNum = (dregsNum+1)>>1;
+                    if (insnCode2 & 0x800000U)
+                        dregsNum++; // tfe
+                    addDecodedOperand(instr, ((insnCode2>>8)&0xff)+256, dregsNum,
+                                getMemDataOperandFlags(mode, glc));
+                    addDecodedOperand(instr, (insnCode2&0xff)+256,
+                            ((insnCode & 0x3000U)==0x3000U ||
+                            (!isGCN124 && (insnCode & 0x8000U)))? 2 : 1, GCNDOP_SRC);
+                }
+                addDecodedOperand(instr, ((insnCode2>>16)&0x1f)<<2, 4, GCNDOP_SRC);
+                addDecodedOperand(instr, insnCode2>>24, 1, GCNDOP_SRC);
+            }
+            instr.imm = insnCode&0xfff;
+            if (insnCode & 0x1000U)
+                instr.modifiers |= GCNDMOD_OFFEN;
+            if (insnCode & 0x2000U)
+                instr.modifiers |= GCNDMOD_IDXEN;
+            if (glc)
+                instr.modifiers |= GCNDMOD_GLC;
+            if (((!isGCN124 || gcnEncoding==GCNENC_MTBUF) && (insnCode2 & 0x400000U)!=0) ||
+                ((isGCN124 && gcnEncoding!=GCNENC_MTBUF) && (insnCode & 0x20000)!=0))
+                instr.modifiers |= GCNDMOD_SLC;
+            if (!isGCN124 && (insnCode & 0x8000U)!=0)
+                instr.modifiers |= GCNDMOD_ADDR64;
+            if (gcnEncoding!=GCNENC_MTBUF && (insnCode & 0x10000U) != 0)
+                instr.modifiers |= GCNDMOD_LDS;
+            if (insnCode2 & 0x800000U)
+                instr.modifiers |= GCNDMOD_TFE;
+            if (gcnEncoding==GCNENC_MTBUF)
+                instr.format = ((insnCode>>19)&15) | (((insnCode>>23)&7)<<4);
+            break;
+        }
+        case GCNENC_MIMG:
+        {
+            const cxuint dmask = (insnCode>>8)&15;
+            cxuint dregsNum = 4;
+            if ((mode & GCN_MIMG_VDATA4) == 0)
+                dregsNum = ((dmask & 1)?1:0) + ((dmask & 2)?1:0) + ((dmask & 4)?1:0) +
+                        ((dmask & 8)?1:0);
+            dregsNum = (dregsNum == 0) ? 1 : dregsNum;
+            if (insnCode & 0x10000)
+                dregsNum++; // tfe
+            instr.mask = dmask;
+            addDecodedOperand(instr, ((insnCode2>>8)&0xff)+256, dregsNum,
+                        getMemDataOperandFlags(mode, (insnCode & 0x2000) != 0));
+            addDecodedOperand(instr, (insnCode2&0xff)+256,
+                        std::max(4, (mode&GCN_MIMG_VA_MASK)+1), GCNDOP_SRC);
+            addDecodedOperand(instr, (insnCode2>>14)&0x7c,
+                        (((insnCode & 0x8000)!=0) && !isGCN14) ? 4: 8, GCNDOP_SRC);
+            if ((mode & GCN_MIMG_SAMPLE) != 0)
+                addDecodedOperand(instr, ((insnCode2>>21)&0x1f)<<2, 4, GCNDOP_SRC);
+            if (insnCode & 0x1000)
+                instr.modifiers |= GCNDMOD_UNORM;
+            if (insnCode & 0x2000)
+                instr.modifiers |= GCNDMOD_GLC;
+            if (insnCode & 0x2000000)
+                instr.modifiers |= GCNDMOD_SLC;
+            if (insnCode & 0x8000)
+                instr.modifiers |= GCNDMOD_R128;
+            if (insnCode & 0x10000)
+                instr.modifiers |= GCNDMOD_TFE;
+            if (insnCode & 0x20000)
+                instr.modifiers |= GCNDMOD_LWE;
+            if (insnCode & 0x4000)
+                instr.modifiers |= GCNDMOD_DA;
+            if (isGCN124 && (insnCode2 & (1U<<31)) != 0)
+                instr.modifiers |= GCNDMOD_D16;
+            break;
+        }
+        case GCNENC_EXP:
+            instr.format = (insnCode>>4)&63;
+            instr.mask = insnCode&15;
+            for (cxuint i = 0; i < 4; i++)
+                if (insnCode & (1U<<i))
+                    addDecodedOperand(instr, ((((insnCode&0x400)==0) ? insnCode2>>(i<<3) :
+                            ((i>=2) ? insnCode2>>8 : insnCode2))&0xff) + 256, 1, GCNDOP_SRC);
+            if (insnCode&0x800)
+                instr.modifiers |= GCNDMOD_DONE;
+            if (insnCode&0x400)
+                instr.modifiers |= GCNDMOD_COMPR;
+            if (insnCode&0x1000)
+                instr.modifiers |= GCNDMOD_VM;
+            break;
+        case GCNENC_FLAT:
+        {
+            const cxuint dregsNum = ((mode&GCN_DSIZE_MASK)>>GCN_SHIFT2)+1;
+            cxuint dstRegsNum = ((mode & GCN_CMPSWAP)!=0) ? (dregsNum>>1) : dregsNum;
+            dstRegsNum = (!isGCN14 && (insnCode2 & 0x800000U)) ? dstRegsNum+1 : dstRegsNum;
+            const cxuint flatMode = mode & GCN_FLAT_MODEMASK;
+            const cxuint saddr = (insnCode2>>16)&0x7f;
+            const cxuint vaddr = (insnCode2&0xff)+256;
+            // address: 2 registers, 1 if SADDR for global, or none if SADDR for scratch
+            const cxuint aregsNum = (flatMode == 0 || (flatMode == GCN_FLAT_GLOBAL &&
+                        saddr == 0x7f)) ? 2 : (flatMode == GCN_FLAT_GLOBAL ||
+                        saddr == 0x7f) ? 1 : 0;
+            if ((mode & GCN_FLAT_ADST) == 0)
+            {
+                addDecodedOperand(instr, (insnCode2>>24)+256, dstRegsNum, GCNDOP_DST);
+                if (aregsNum != 0)
+                    addDecodedOperand(instr, vaddr, aregsNum, GCNDOP_SRC);
+            }
+            else
+            {
+                if (aregsNum != 0)
+                    addDecodedOperand(instr, vaddr, aregsNum, GCNDOP_SRC);
+                if ((mode & GCN_FLAT_NODST) == 0)
+                    addDecodedOperand(instr, (insnCode2>>24)+256, dstRegsNum, GCNDOP_DST);
+            }
+            if ((mode & GCN_FLAT_NODATA) == 0)
+                addDecodedOperand(instr, ((insnCode2>>8)&0xff)+256, dregsNum, GCNDOP_SRC);
+            if (flatMode != 0 && saddr != 0x7f)
+                addDecodedOperand(instr, saddr, flatMode == GCN_FLAT_SCRATCH ? 1 : 2,
+                            GCNDOP_SRC);
+            if (isGCN14)
+                instr.imm = (flatMode != 0 && (insnCode&0x1000) != 0) ?
+                        uint32_t(-4096+(insnCode&0xfff)) : insnCode&0xfff;
+            if (isGCN14 && (insnCode & 0x2000U))
+                instr.modifiers |= GCNDMOD_LDS;
+            if (insnCode & 0x10000U)
+                instr.modifiers |= GCNDMOD_GLC;
+            if (insnCode & 0x20000U)
+                instr.modifiers |= GCNDMOD_SLC;
+            if (insnCode2 & 0x800000U)
+                instr.modifiers |= isGCN14 ? GCNDMOD_NV : GCNDMOD_TFE;
+            break;
+        }
+        default:
+            break;
+    }
+    return nextPos;
+}
+
+void GCNDecoder::decodeAll(size_t codeSize, const cxbyte* code,
+            std::vector<GCNDecodedInstr>& instrs) const
+{
+    instrs.clear();
+    instrs.reserve(codeSize>>3);
+    for (size_t pos = 0; pos+4 <= codeSize;)
+    {
+        instrs.push_back(GCNDecodedInstr());
+        pos = decode(codeSize, code, pos, instrs.back());
+    }
 }
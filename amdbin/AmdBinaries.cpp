@@ -22,8 +22,10 @@
 #include <cstring>
 #include <climits>
 #include <cstdint>
-#include <map>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
+#include <memory>
 #include <utility>
 #include <vector>
 #include <CLRX/amdbin/Elf.h>
@@ -151,6 +153,13 @@ static const KernelArgType gpuArgTypeTable[] =
 
 static const uint32_t elfMagicValue = 0x464c457fU;
 
+// convert AMD binary creation flags into inner binary creation flags
+static inline Flags getAmdInnerCreationFlags(Flags creationFlags)
+{
+    return ((creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL) |
+        ((creationFlags & AMDBIN_INNER_CREATE_HASHINDEX) != 0 ? ELF_CREATE_HASHINDEX : 0);
+}
+
 /* determine unfinished strings region in string table for checking further consistency */
 static size_t unfinishedRegionOfStringTable(const cxbyte* table, size_t size)
 {
@@ -370,11 +379,9 @@ static size_t getKernelInfosInternal(const typename Types::ElfBinary& elf,
 {
     if (!elf) return 0;
     
-    cxuint rodataIndex = SHN_UNDEF;
-    try
-    { rodataIndex = elf.getSectionIndex(".rodata"); }
-    catch(const Exception& ex)
-    { return 0; /* no section */ }
+    const cxuint rodataIndex = elf.findSectionIndex(".rodata");
+    if (rodataIndex == SHN_UNDEF)
+        return 0; /* no section */
     
     const typename Types::Shdr& rodataHdr = elf.getSectionHeader(rodataIndex);
     
@@ -610,19 +617,29 @@ void AmdInnerX86Binary64::getKernelInfos(Array<KernelInfo>& kernelInfos) const
 
 /* AmdMainBinaryBase */
 
-AmdMainBinaryBase::AmdMainBinaryBase(AmdMainType _type) : type(_type)
+AmdMainBinaryBase::AmdMainBinaryBase(AmdMainType _type) : type(_type),
+        lazyKernelInfos(false)
 { }
 
 AmdMainBinaryBase::~AmdMainBinaryBase()
 { }
 
+void AmdMainBinaryBase::loadKernelInfo(size_t index) const
+{ }
+
+void AmdMainBinaryBase::loadKernelInfos() const
+{
+    for (size_t i = 0; i < kernelInfos.size(); i++)
+        loadKernelInfo(i);
+}
+
 const KernelInfo& AmdMainBinaryBase::getKernelInfo(const char* name) const
 {
     KernelInfoMap::const_iterator it = binaryMapFind(
         kernelInfosMap.begin(), kernelInfosMap.end(), name);
     if (it == kernelInfosMap.end())
         throw BinException("Can't find kernel name");
-    return kernelInfos[it->second];
+    return getKernelInfo(it->second);
 }
 
 static const cxuint vectorIdTable[17] =
@@ -675,222 +692,235 @@ static KernelArgType determineKernelArgType(const char* typeString,
     return outType;
 }
 
-static inline CString stringFromCStringDelim(const char* c1, size_t maxSize, char delim)
+void AmdKernelMetadataView::parse(size_t metadataSize, const char* metadata)
+{
+    const char* mtEnd = metadata + metadataSize;
+    // count lines and fields to allocate arrays once
+    size_t linesNum = 0;
+    uint32_t colonsNum = 0;
+    for (const char* p = metadata; p != mtEnd; p++)
+        colonsNum += (*p == ':');
+    for (const char* p = metadata; (p = reinterpret_cast<const char*>(
+                ::memchr(p, '\n', mtEnd-p))) != nullptr; p++)
+        linesNum++;
+    if (metadataSize != 0 && mtEnd[-1] != '\n')
+        linesNum++; // last line without newline
+    lines.resize(linesNum);
+    fields.resize(colonsNum + linesNum);
+    
+    AmdMetadataLine* line = lines.data();
+    AmdMetadataField* field = fields.data();
+    for (const char* linePtr = metadata; linePtr != mtEnd; line++)
+    {
+        const char* lineEnd = reinterpret_cast<const char*>(
+                ::memchr(linePtr, '\n', mtEnd-linePtr));
+        line->newline = (lineEnd != nullptr);
+        if (lineEnd == nullptr)
+            lineEnd = mtEnd;
+        line->ptr = linePtr;
+        line->size = lineEnd-linePtr;
+        line->fieldsIndex = field - fields.data();
+        line->entry = (*linePtr == ';');
+        const char* fieldPtr = line->entry ? linePtr+1 : linePtr;
+        for (const char* p = fieldPtr; p != lineEnd; p++)
+            if (*p == ':')
+            {
+                *field++ = { fieldPtr, size_t(p-fieldPtr) };
+                fieldPtr = p+1;
+            }
+        *field++ = { fieldPtr, size_t(lineEnd-fieldPtr) };
+        line->fieldsNum = (field - fields.data()) - line->fieldsIndex;
+        linePtr = line->newline ? lineEnd+1 : lineEnd;
+    }
+}
+
+// parse unsigned integer from metadata field
+static cxuint parseMetadataFieldUInt(const AmdMetadataField& field, LineNo lineNo)
+{
+    const char* outEnd;
+    cxuint value = 0;
+    try
+    { value = cstrtoui(field.ptr, field.ptr+field.size, outEnd); }
+    catch(const ParseException& ex)
+    { throw ParseException(lineNo, ex.what()); }
+    if (outEnd != field.ptr+field.size)
+        throw ParseException(lineNo, "Garbages after integer");
+    return value;
+}
+
+// return true if key is equal to keyword or abbreviation of it
+static inline bool matchMetadataKey(const AmdMetadataField& key, const char* keyword)
+{ return ::strncmp(key.ptr, keyword, key.size) == 0; }
+
+// compare metadata fields (for sorting argument names)
+static inline bool lessMetadataField(const AmdMetadataField& f1, const AmdMetadataField& f2)
 {
-    size_t i = 0;
-    for (i = 0; i < maxSize && c1[i] != delim; i++);
-    return CString(c1, i);
+    const int r = ::memcmp(f1.ptr, f2.ptr, std::min(f1.size, f2.size));
+    return r < 0 || (r == 0 && f1.size < f2.size);
 }
 
 /* metadata string that stored in rodata section in main GPU binary holds needed kernel
- * argument info (arg type and arg name). this function just retrieve that data */
-static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
-          const char* kernelDesc, KernelInfo& kernelInfo)
+ * argument info (arg type and arg name). this function just retrieve that data
+ * from tokenized metadata */
+static void parseAmdGpuKernelMetadata(const char* symName,
+          const AmdKernelMetadataView& view, KernelInfo& kernelInfo)
 {
-    // internal structure to hold kernel arguments info in map
-    struct InitKernelArgMapEntry
+    // internal structure to hold kernel arguments info
+    struct InitKernelArgEntry
     {
-        uint32_t index;
+        AmdMetadataField name;
         KernelArgType argType;
         KernelArgType origArgType;
         KernelPtrSpace ptrSpace;
         uint32_t ptrAccess;
-        const char* nameStr;
-        
-        InitKernelArgMapEntry() : index(0), argType(KernelArgType::VOID),
-            origArgType(KernelArgType::VOID),
-            ptrSpace(KernelPtrSpace::NONE), ptrAccess(0), nameStr(nullptr)
-        { }
+        LineNo lineNo;
     };
-    typedef std::map<CString, InitKernelArgMapEntry> InitKernelArgMap;
-    
-    /* parse kernel description */
-    LineNo lineNo = 1;
-    uint32_t argIndex = 0;
+    std::vector<InitKernelArgEntry> initKernelArgs;
     
-    InitKernelArgMap initKernelArgs;
+    // find previously defined argument (referenced argument usually precedes line)
+    auto findArg = [&initKernelArgs](const AmdMetadataField& name) -> InitKernelArgEntry*
+    {
+        for (size_t i = initKernelArgs.size(); i > 0; i--)
+            if (initKernelArgs[i-1].name.equal(name))
+                return &initKernelArgs[i-1];
+        return nullptr;
+    };
+    // check whether argument names are unique (sorting names)
+    auto checkDuplicates = [&initKernelArgs]()
+    {
+        const size_t argsNum = initKernelArgs.size();
+        std::vector<uint32_t> argOrder(argsNum);
+        for (size_t i = 0; i < argsNum; i++)
+            argOrder[i] = i;
+        std::sort(argOrder.begin(), argOrder.end(),
+            [&initKernelArgs](uint32_t a1, uint32_t a2)
+            {
+                const AmdMetadataField& n1 = initKernelArgs[a1].name;
+                const AmdMetadataField& n2 = initKernelArgs[a2].name;
+                return lessMetadataField(n1, n2) ||
+                        (!lessMetadataField(n2, n1) && a1 < a2);
+            });
+        // report first duplicate in metadata order
+        LineNo dupLineNo = 0;
+        for (size_t i = 1; i < argsNum; i++)
+            if (initKernelArgs[argOrder[i-1]].name.equal(
+                        initKernelArgs[argOrder[i]].name))
+            {
+                const LineNo lineNo = initKernelArgs[argOrder[i]].lineNo;
+                if (dupLineNo == 0 || lineNo < dupLineNo)
+                    dupLineNo = lineNo;
+            }
+        if (dupLineNo != 0)
+            throw ParseException(dupLineNo, "Argument has been duplicated");
+    };
     
-    const char* kptr = kernelDesc;
-    const char* kend = kernelDesc + metadataSize;
-    // first phase (value/pointer/image/sampler)
-    while (kptr < kend)
+    const size_t linesNum = view.lines.size();
+    // end of metadata (image type parsing can look beyond line)
+    const char* mtEnd = (linesNum != 0) ? view.lines[linesNum-1].ptr +
+            view.lines[linesNum-1].size + view.lines[linesNum-1].newline : nullptr;
+    size_t li = 0;
+    try
     {
-        if (*kptr != ';')
-            throw ParseException(lineNo, "This is not KernelDesc line");
-        kptr++;
-        if (kptr >= kend)
-            throw ParseException(lineNo, "This is not KernelDesc line");
-        
-        const char* tokPtr = kptr;
-        while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-        if (tokPtr >= kend)
-            throw ParseException(lineNo, "Is not KernelDesc line");
-        
-        if (::strncmp(kptr, "value", tokPtr-kptr) == 0)
+        // first phase (value/pointer/image/sampler)
+        for (; li < linesNum; li++)
         {
-            // value
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not value line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after name");
+            const AmdMetadataLine& line = view.lines[li];
+            const LineNo lineNo = li+1;
+            const AmdMetadataField* fields = view.fields.data() + line.fieldsIndex;
+            const size_t fieldsNum = line.fieldsNum;
+            if (!line.entry || (line.size == 1 && !line.newline))
+                throw ParseException(lineNo, "This is not KernelDesc line");
+            if (fieldsNum == 1 && !line.newline)
+                throw ParseException(lineNo, "Is not KernelDesc line");
             
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
-            {
-                InitKernelArgMapEntry entry;
-                entry.index = argIndex++;
-                entry.nameStr = kptr;
-                std::pair<InitKernelArgMap::iterator, bool> result = 
-                    initKernelArgs.insert(std::make_pair(CString(kptr, tokPtr), entry));
-                if (!result.second)
-                    throw ParseException(lineNo, "Argument has been duplicated");
-                argIt = result.first;
-            }
-            ///
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after type");
-            // get arg type
-            const char* argType = kptr;
-            ///
-            if (tokPtr-kptr != 6 || ::strncmp(argType, "struct", 6)!=0)
+            const AmdMetadataField& key = fields[0];
+            InitKernelArgEntry entry = { fieldsNum >= 2 ? fields[1] : key,
+                KernelArgType::VOID, KernelArgType::VOID, KernelPtrSpace::NONE, 0, lineNo };
+            if (matchMetadataKey(key, "value"))
             {
-                // regular type
-                kptr = ++tokPtr;
-                while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-                if (tokPtr >= kend || *tokPtr =='\n')
-                    throw ParseException(lineNo, "No separator after vector size");
-                // get vector size
+                // value
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not value line");
+                if (fieldsNum < 3)
+                    throw ParseException(lineNo, "No separator after name");
+                initKernelArgs.push_back(entry);
+                InitKernelArgEntry& arg = initKernelArgs.back();
+                if (fieldsNum < 4)
+                    throw ParseException(lineNo, "No separator after type");
+                if (!fields[2].equal("struct"))
                 {
-                    const char* outEnd;
-                    cxuint vectorSize = 0;
-                    try
-                    { vectorSize = cstrtoui(kptr, tokPtr, outEnd); }
-                    catch(const ParseException& ex)
-                    { throw ParseException(lineNo, ex.what()); }
-                    if (outEnd != tokPtr)
-                        throw ParseException(lineNo, "Garbages after integer");
-                    argIt->second.argType = determineKernelArgType(argType,
-                           vectorSize, lineNo);
+                    // regular type
+                    if (fieldsNum < 5)
+                        throw ParseException(lineNo, "No separator after vector size");
+                    arg.argType = determineKernelArgType(fields[2].ptr,
+                            parseMetadataFieldUInt(fields[3], lineNo), lineNo);
                 }
-                kptr = tokPtr;
+                else // if structure
+                    arg.argType = KernelArgType::STRUCTURE;
             }
-            else // if structure
-                argIt->second.argType = KernelArgType::STRUCTURE;
-        }
-        else if (::strncmp(kptr, "pointer", tokPtr-kptr) == 0)
-        {
-            // pointer
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not pointer line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after name");
-            
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
+            else if (matchMetadataKey(key, "pointer"))
             {
-                InitKernelArgMapEntry entry;
-                entry.index = argIndex++;
-                entry.nameStr = kptr;
+                // pointer
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not pointer line");
+                if (fieldsNum < 3)
+                    throw ParseException(lineNo, "No separator after name");
                 entry.argType = KernelArgType::POINTER;
-                std::pair<InitKernelArgMap::iterator, bool> result = 
-                    initKernelArgs.insert(std::make_pair(CString(kptr, tokPtr), entry));
-                if (!result.second)
-                    throw ParseException(lineNo, "Argument has been duplicated");
-                argIt = result.first;
-            }
-            ///
-            ++tokPtr;
-            for (cxuint k = 0; k < 4; k++) // // skip four fields
-            {
-                while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-                if (tokPtr >= kend || *tokPtr =='\n')
+                initKernelArgs.push_back(entry);
+                InitKernelArgEntry& arg = initKernelArgs.back();
+                // skip four fields
+                if (fieldsNum < 7)
                     throw ParseException(lineNo, "No separator after field");
-                tokPtr++;
-            }
-            kptr = tokPtr;
-            // get pointer type (global/local/constant)
-            if (kptr+4 <= kend && *kptr == 'u' && kptr[1] == 'a' && kptr[2] == 'v' &&
-                kptr[3] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::GLOBAL; kptr += 4; }
-            else if (kptr+3 <= kend && *kptr == 'h' && kptr[1] == 'c' && kptr[2] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::CONSTANT; kptr += 3; }
-            else if (kptr+3 <= kend && *kptr == 'h' && kptr[1] == 'l' && kptr[2] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::LOCAL; kptr += 3; }
-            else if (kptr+2 <= kend && *kptr == 'c' && kptr[1] == ':')
-            { argIt->second.ptrSpace = KernelPtrSpace::CONSTANT; kptr += 2; }
-            else //if not match
-                throw ParseException(lineNo, "Unknown pointer type");
-            
-            tokPtr = kptr;
-            for (cxuint k = 0; k < 2; k++) // // skip two fields
-            {
-                while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-                if (tokPtr >= kend || *tokPtr =='\n')
+                // get pointer type (global/local/constant)
+                const AmdMetadataField& ptrSpace = fields[6];
+                if (fieldsNum >= 8 && ptrSpace.equal("uav"))
+                    arg.ptrSpace = KernelPtrSpace::GLOBAL;
+                else if (fieldsNum >= 8 && (ptrSpace.equal("hc") || ptrSpace.equal("c")))
+                    arg.ptrSpace = KernelPtrSpace::CONSTANT;
+                else if (fieldsNum >= 8 && ptrSpace.equal("hl"))
+                    arg.ptrSpace = KernelPtrSpace::LOCAL;
+                else //if not match
+                    throw ParseException(lineNo, "Unknown pointer type");
+                // skip two fields
+                if (fieldsNum < 10)
                     throw ParseException(lineNo, "No separator after field");
-                tokPtr++;
-            }
-            // RO/RW
-            kptr = tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr =='\n')
-                throw ParseException(lineNo, "No separator after access qualifier");
-            if (kptr+3 <= kend && *kptr=='R' && kptr[1]=='O' && kptr[2]==':' &&
-                argIt->second.ptrSpace==KernelPtrSpace::GLOBAL)
-                argIt->second.ptrAccess |= KARG_PTR_CONST;
-            else if (kptr+3 <= kend && *kptr=='R' && kptr[1]=='W' && kptr[2]==':')
-                argIt->second.ptrAccess |= KARG_PTR_NORMAL;
-            /* volatile specifier */
-            kptr = ++tokPtr;
-            if (kptr+2 <= kend && kptr[1] == ':' && (*kptr == '0' || *kptr == '1'))
-            {
-                if (*kptr == '1')
-                    argIt->second.ptrAccess |= KARG_PTR_VOLATILE;
-                kptr += 2;
-            }
-            else // error
-                throw ParseException("Unknown value or end at volatile field");
-            
-            /* restrict specifier */
-            if (kptr+2 <= kend && kptr[1] == '\n' && (*kptr == '0' || *kptr == '1'))
-            {
-                if (*kptr == '1')
-                    argIt->second.ptrAccess |= KARG_PTR_RESTRICT;
-                kptr++;
+                // RO/RW
+                if (fieldsNum < 11)
+                    throw ParseException(lineNo, "No separator after access qualifier");
+                if (fields[9].equal("RO") && arg.ptrSpace==KernelPtrSpace::GLOBAL)
+                    arg.ptrAccess |= KARG_PTR_CONST;
+                else if (fields[9].equal("RW"))
+                    arg.ptrAccess |= KARG_PTR_NORMAL;
+                /* volatile specifier */
+                if (fieldsNum >= 12 && (fields[10].equal("0") || fields[10].equal("1")))
+                {
+                    if (*fields[10].ptr == '1')
+                        arg.ptrAccess |= KARG_PTR_VOLATILE;
+                }
+                else // error
+                    throw ParseException("Unknown value or end at volatile field");
+                /* restrict specifier */
+                if (fieldsNum == 12 && line.newline &&
+                    (fields[11].equal("0") || fields[11].equal("1")))
+                {
+                    if (*fields[11].ptr == '1')
+                        arg.ptrAccess |= KARG_PTR_RESTRICT;
+                }
+                else // error
+                    throw ParseException("Unknown value or end at restrict field");
             }
-            else // error
-                throw ParseException("Unknown value or end at restrict field");
-        }
-        else if (::strncmp(kptr, "image", tokPtr-kptr) == 0)
-        {
-            // parse image arg
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not image line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr == '\n')
-                throw ParseException(lineNo, "No separator after name");
-            
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
-            InitKernelArgMapEntry entry;
-            entry.index = argIndex++;
-            entry.nameStr = kptr;
-            entry.ptrSpace = KernelPtrSpace::GLOBAL;
-            CString name(kptr, tokPtr);
-            
-            kptr = ++tokPtr;
-            // quick image type parsing (1D,1DA,1DB,2D,2DA,3D)
-            if (kptr+3 < kend)
+            else if (matchMetadataKey(key, "image"))
             {
+                // parse image arg
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not image line");
+                if (fieldsNum < 3)
+                    throw ParseException(lineNo, "No separator after name");
+                entry.ptrSpace = KernelPtrSpace::GLOBAL;
+                // quick image type parsing (1D,1DA,1DB,2D,2DA,3D)
+                const char* kptr = fields[2].ptr;
+                if (kptr+3 >= mtEnd)
+                    throw ParseException(lineNo, "No separator after field");
                 if (kptr[1] != 'D')
                     throw ParseException("Unknown image type");
                 if (*kptr == '1')
@@ -914,187 +944,132 @@ static void parseAmdGpuKernelMetadata(const char* symName, size_t metadataSize,
                 { entry.argType = KernelArgType::IMAGE3D; kptr += 2; }
                 else
                     throw ParseException("Unknown image type");
-                if (kptr >= kend || *kptr != ':')
+                if (kptr >= mtEnd || *kptr != ':')
                     throw ParseException("No separator after field");
+                // image type field is correct, next field is access qualifier
+                initKernelArgs.push_back(entry);
+                
+                // handle img access qualifier: RO,WO,RW */
+                uint32_t& ptrAccess = initKernelArgs.back().ptrAccess;
+                const AmdMetadataField& access = fields[3];
+                if (fieldsNum < 5 || access.size != 2)
+                    throw ParseException(lineNo, "Can't parse image access qualifier");
+                if (access.equal("RO"))
+                    ptrAccess |= KARG_PTR_READ_ONLY;
+                else if (access.equal("WO"))
+                    ptrAccess |= KARG_PTR_WRITE_ONLY;
+                else if (access.equal("RW")) //???
+                    ptrAccess |= KARG_PTR_READ_WRITE;
+                else
+                    throw ParseException(lineNo, "Can't parse image access qualifier");
             }
-            else
-                throw ParseException(lineNo, "No separator after field");
-            
-            std::pair<InitKernelArgMap::iterator, bool> result = 
-                initKernelArgs.insert(std::make_pair(name, entry));
-            if (!result.second)
-                throw ParseException(lineNo, "Argument has been duplicated");
-            argIt = result.first;
-            
-            ++kptr;
-            if (kptr+3 > kend || kptr[2] != ':')
-                throw ParseException(lineNo, "Can't parse image access qualifier");
-            // handle img access qualifier: RO,WO,RW */
-            if (*kptr == 'R' && kptr[1] == 'O')
-                argIt->second.ptrAccess |= KARG_PTR_READ_ONLY;
-            else if (*kptr == 'W' && kptr[1] == 'O')
-                argIt->second.ptrAccess |= KARG_PTR_WRITE_ONLY;
-            else if (*kptr == 'R' && kptr[1] == 'W') //???
-                argIt->second.ptrAccess |= KARG_PTR_READ_WRITE;
-            else
-                throw ParseException(lineNo, "Can't parse image access qualifier");
-            kptr += 3;
-        }
-        else if (::strncmp(kptr, "sampler", tokPtr-kptr) == 0)
-        {
-            // sampler (set up some argument as sampler
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not sampler line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend)
-                throw ParseException(lineNo, "No separator after name");
-            
-            CString argName(kptr, tokPtr);
-            InitKernelArgMap::iterator argIt = initKernelArgs.find(argName);
-            if (argIt != initKernelArgs.end())
+            else if (matchMetadataKey(key, "sampler"))
             {
-                argIt->second.origArgType = argIt->second.argType;
-                argIt->second.argType = KernelArgType::SAMPLER;
+                // sampler (set up some argument as sampler
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not sampler line");
+                if (fieldsNum == 2 && !line.newline)
+                    throw ParseException(lineNo, "No separator after name");
+                InitKernelArgEntry* arg = findArg(fields[1]);
+                if (arg != nullptr)
+                {
+                    arg->origArgType = arg->argType;
+                    arg->argType = KernelArgType::SAMPLER;
+                }
             }
-            
-            kptr = tokPtr;
-        }
-        else if (::strncmp(kptr, "constarg", tokPtr-kptr) == 0)
-        {
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not constarg line");
-            
-            kptr = ++tokPtr;
-            // skip number
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr == '\n')
-                throw ParseException(lineNo, "No separator after field");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend)
-                throw ParseException(lineNo, "End of data");
-            
-            /// put constant
-            const CString thisName(kptr, tokPtr);
-            InitKernelArgMap::iterator argIt = initKernelArgs.find(thisName);
-            if (argIt == initKernelArgs.end())
-                throw ParseException(lineNo, "Can't find constant argument");
-            // set up const access type
-            argIt->second.ptrAccess |= KARG_PTR_CONST;
-            kptr = tokPtr;
-        }
-        else if (::strncmp(kptr, "counter", tokPtr-kptr) == 0)
-        {
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not constarg line");
-            
-            kptr = ++tokPtr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend)
-                throw ParseException(lineNo, "No separator after name");
-            
-            CString argName(kptr, tokPtr);
-            // extract arg name
-            InitKernelArgMap::iterator argIt;
+            else if (matchMetadataKey(key, "constarg"))
+            {
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not constarg line");
+                if (fieldsNum < 3)
+                    throw ParseException(lineNo, "No separator after field");
+                if (!line.newline)
+                    throw ParseException(lineNo, "End of data");
+                /// put constant (name is rest of line)
+                InitKernelArgEntry* arg = findArg({ fields[2].ptr,
+                            size_t(line.ptr + line.size - fields[2].ptr) });
+                if (arg == nullptr)
+                    throw ParseException(lineNo, "Can't find constant argument");
+                // set up const access type
+                arg->ptrAccess |= KARG_PTR_CONST;
+            }
+            else if (matchMetadataKey(key, "counter"))
             {
-                InitKernelArgMapEntry entry;
-                entry.index = argIndex++;
-                entry.nameStr = kptr;
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not constarg line");
+                if (fieldsNum == 2 && !line.newline)
+                    throw ParseException(lineNo, "No separator after name");
                 entry.argType = KernelArgType::COUNTER32;
-                std::pair<InitKernelArgMap::iterator, bool> result = 
-                    initKernelArgs.insert(std::make_pair(CString(kptr, tokPtr), entry));
-                if (!result.second)
-                    throw ParseException(lineNo, "Argument has been duplicated");
-                argIt = result.first;
+                initKernelArgs.push_back(entry);
+            }
+            else if (matchMetadataKey(key, "reflection"))
+            {
+                if (fieldsNum == 1)
+                    throw ParseException(lineNo, "This is not reflection line");
+                break;
             }
-            
-            kptr = tokPtr;
-        }
-        else if (::strncmp(kptr, "reflection", tokPtr-kptr) == 0)
-        {
-            if (*tokPtr == '\n')
-                throw ParseException(lineNo, "This is not reflection line");
-            break;
         }
         
-        while (kptr < kend && *kptr != '\n') kptr++;
-        lineNo++;
-        kptr++; // skip newline
     }
+    catch(const ParseException&)
+    {
+        // duplicate in previous lines is reported before this error
+        checkDuplicates();
+        throw;
+    }
+    checkDuplicates();
+    const size_t argsNum = initKernelArgs.size();
     
     kernelInfo.kernelName.assign(symName+9, ::strlen(symName)-18);
-    kernelInfo.argInfos.resize(argIndex);
+    kernelInfo.argInfos.resize(argsNum);
     
-    for (const auto& e: initKernelArgs)
+    for (size_t i = 0; i < argsNum; i++)
     {
         /* initialize kernel arguments before set argument type from reflections */
-        AmdKernelArg& karg = kernelInfo.argInfos[e.second.index];
-        karg.argType = e.second.argType;
-        karg.ptrSpace = e.second.ptrSpace;
-        karg.ptrAccess = e.second.ptrAccess;
-        karg.argName = stringFromCStringDelim(e.second.nameStr, kend-e.second.nameStr, ':');
+        const InitKernelArgEntry& e = initKernelArgs[i];
+        AmdKernelArg& karg = kernelInfo.argInfos[i];
+        karg.argType = e.argType;
+        karg.ptrSpace = e.ptrSpace;
+        karg.ptrAccess = e.ptrAccess;
+        karg.argName.assign(e.name.ptr, e.name.size);
     }
     
     /* reflections holds argument type names, we just retrieve from arg type names! */
-    if (argIndex != 0)
+    if (argsNum != 0)
     {
         /* check whether not end */
-        if (kptr >= kend)
-            throw ParseException(lineNo, "Unexpected end of data");
+        if (li >= linesNum)
+            throw ParseException(li+1, "Unexpected end of data");
         
         // reflections
-        kptr--; // skip ';'
-        while (kptr < kend)
+        for (; li < linesNum; li++)
         {
-            if (*kptr != ';')
+            const AmdMetadataLine& line = view.lines[li];
+            const LineNo lineNo = li+1;
+            if (!line.entry)
                 throw ParseException(lineNo, "Is not KernelDesc line");
-            kptr++;
-            if (kptr >= kend)
+            if (line.size == 1 && !line.newline)
                 throw ParseException(lineNo, "Is not KernelDesc line");
             // finish at end of string or if no ';reflection'
-            if (kptr+11 > kend || ::strncmp(kptr, "reflection:", 11) != 0)
+            if (line.fieldsNum < 2 || !view.getField(line, 0).equal("reflection"))
                 break; // end!!!
-            kptr += 11;
-            
-            const char* tokPtr = kptr;
-            while (tokPtr < kend && *tokPtr != ':' && *tokPtr != '\n') tokPtr++;
-            if (tokPtr >= kend || *tokPtr == '\n')
+            if (line.fieldsNum < 3)
                 throw ParseException(lineNo, "Is not KernelDesc line");
             
-            const char* outEnd;
-            cxuint argIndex = 0;
-            try
-            { argIndex = cstrtoui(kptr, tokPtr, outEnd); }
-            catch(const ParseException& ex)
-            { throw ParseException(lineNo, ex.what()); }
-            
-            if (outEnd != tokPtr)
-                throw ParseException(lineNo, "Garbages after integer");
-            if (argIndex >= kernelInfo.argInfos.size())
+            const cxuint argIndex = parseMetadataFieldUInt(view.getField(line, 1), lineNo);
+            if (argIndex >= argsNum)
                 throw ParseException(lineNo, "Argument index out of range");
-            kptr = tokPtr+1;
             
             AmdKernelArg& argInfo = kernelInfo.argInfos[argIndex];
-            argInfo.typeName = stringFromCStringDelim(kptr, kend-kptr, '\n');
+            const char* typeName = view.getField(line, 2).ptr;
+            argInfo.typeName.assign(typeName, line.ptr + line.size);
             
             if (argInfo.argName.compare(0, 8, "unknown_") == 0 &&
                 argInfo.typeName != "sampler_t" &&
-                argInfo.argType == KernelArgType::SAMPLER)
-            {
-                InitKernelArgMap::const_iterator argIt =
-                            initKernelArgs.find(argInfo.argName);
-                if (argIt != initKernelArgs.end() &&
-                    argIt->second.origArgType != KernelArgType::VOID)
-                    /* revert sampler type and restore original arg type */
-                    argInfo.argType = argIt->second.origArgType;
-            }    
-            
-            while (kptr < kend && *kptr != '\n') kptr++;
-            lineNo++;
-            kptr++;
+                argInfo.argType == KernelArgType::SAMPLER &&
+                initKernelArgs[argIndex].origArgType != KernelArgType::VOID)
+                /* revert sampler type and restore original arg type */
+                argInfo.argType = initKernelArgs[argIndex].origArgType;
         }
     }
 }
@@ -1109,18 +1084,82 @@ struct CLRX_INTERNAL AmdGPU64Types: Elf64Types
     typedef ElfBinary64 ElfBinary;
 };
 
+// symbol index of AMD main GPU binary in lazy mode
+struct AmdMainGPUBinaryBase::LazyState
+{
+    std::mutex mutex;
+    cxuint textIndex;
+    std::vector<size_t> innerSyms;  // symbols of inner binaries (kernels)
+    std::vector<size_t> metadataSyms;   // symbols of kernel metadatas
+    std::unique_ptr<std::atomic<bool>[]> innerLoaded;
+    std::unique_ptr<std::atomic<bool>[]> infoLoaded;
+};
+
 AmdMainGPUBinaryBase::AmdMainGPUBinaryBase(AmdMainType type)
         : AmdMainBinaryBase(type), metadatas(nullptr), globalDataSize(0), globalData(0)
 { }
 
+AmdMainGPUBinaryBase::~AmdMainGPUBinaryBase()
+{ }
+
+// create inner binary from kernel symbol
+template<typename Types>
+static void initAmdInnerGPUBinary(typename Types::ElfBinary& mainElf, cxuint textIndex,
+            size_t symIndex, AmdInnerGPUBinary32& innerBinary)
+{
+    const typename Types::Shdr& textHdr = mainElf.getSectionHeader(textIndex);
+    cxbyte* textContent = mainElf.getBinaryCode() + ULEV(textHdr.sh_offset);
+    
+    const char* symName = mainElf.getSymbolName(symIndex);
+    size_t len = ::strlen(symName);
+    const typename Types::Sym& sym = mainElf.getSymbol(symIndex);
+    
+    const typename Types::Word symvalue = ULEV(sym.st_value);
+    const typename Types::Word symsize = ULEV(sym.st_size);
+    if (symvalue > ULEV(textHdr.sh_size))
+        throw BinException("Inner binary offset out of range!");
+    if (usumGt(symvalue, symsize, ULEV(textHdr.sh_size)))
+        throw BinException("Inner binary offset+size out of range!");
+    
+    innerBinary = AmdInnerGPUBinary32(CString(symName+9, len-16),
+            symsize, textContent+symvalue,
+            getAmdInnerCreationFlags(mainElf.getCreationFlags()));
+}
+
+// parse kernel info from metadata symbol
+template<typename Types>
+static void initAmdGPUKernelInfo(typename Types::ElfBinary& mainElf, size_t symIndex,
+            KernelInfo& kernelInfo, AmdGPUKernelMetadata& metadata)
+{
+    // read symbol _OpenCL..._metadata
+    const typename Types::Sym& sym = mainElf.getSymbol(symIndex);
+    const char* symName = mainElf.getSymbolName(symIndex);
+    if (ULEV(sym.st_shndx) >= mainElf.getSectionHeadersNum())
+        throw BinException("Metadata section index out of range");
+    
+    const typename Types::Shdr& rodataHdr =
+            mainElf.getSectionHeader(ULEV(sym.st_shndx));
+    cxbyte* secContent = mainElf.getBinaryCode() + ULEV(rodataHdr.sh_offset);
+    
+    const typename Types::Word symvalue = ULEV(sym.st_value);
+    const typename Types::Word symsize = ULEV(sym.st_size);
+    if (symvalue > ULEV(rodataHdr.sh_size))
+        throw BinException("Metadata offset out of range");
+    if (usumGt(symvalue, symsize, ULEV(rodataHdr.sh_size)))
+        throw BinException("Metadata offset+size out of range");
+    
+    metadata.size = symsize;
+    metadata.data = reinterpret_cast<char*>(secContent + symvalue);
+    // tokenize metadata once (view is reused by disassembler)
+    metadata.view.parse(metadata.size, metadata.data);
+    // parse AMDGPU kernel metadata
+    parseAmdGpuKernelMetadata(symName, metadata.view, kernelInfo);
+}
+
 template<typename Types>
 void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
 {
-    cxuint textIndex = SHN_UNDEF;
-    try
-    { textIndex = mainElf.getSectionIndex(".text"); }
-    catch(const Exception& ex)
-    { } // ignore failed
+    cxuint textIndex = mainElf.findSectionIndex(".text");
     
     std::vector<size_t> choosenSyms;
     std::vector<size_t> choosenSymsMetadata;
@@ -1131,9 +1170,9 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     const bool doKernelHeaders = (creationFlags & AMDBIN_CREATE_KERNELHEADERS) != 0;
     const bool doKernelInfo = (creationFlags & AMDBIN_CREATE_KERNELINFO) != 0;
     const bool doInfoStrings = (creationFlags & AMDBIN_CREATE_INFOSTRINGS) != 0;
+    const bool lazy = (creationFlags & AMDBIN_CREATE_LAZY) != 0;
     size_t compileOptionsEnd = 0;
     uint16_t compileOptionShIndex = SHN_UNDEF;
-    
     for (size_t i = 0; i < mainElf.getSymbolsNum(); i++)
     {
         const char* symName = mainElf.getSymbolName(i);
@@ -1188,11 +1227,7 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     if (doInfoStrings)
     {
         // put driver info
-        uint16_t commentShIndex = SHN_UNDEF;
-        try
-        { commentShIndex = mainElf.getSectionIndex(".comment"); }
-        catch(const Exception& ex)
-        { }
+        uint16_t commentShIndex = mainElf.findSectionIndex(".comment");
         if (commentShIndex != SHN_UNDEF)
         {
             size_t offset = 0;
@@ -1206,36 +1241,35 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
     }
     
     innerBinaries.resize(choosenSyms.size());
+    if (lazy)
+    {
+        // only symbol index, inner binaries and kernel infos are parsed on demand
+        lazyState.reset(new LazyState);
+        lazyState->textIndex = textIndex;
+        lazyState->innerLoaded.reset(new std::atomic<bool>[choosenSyms.size()]());
+        // without ".text" inner binaries stay empty
+        if (textIndex == SHN_UNDEF)
+            for (size_t i = 0; i < choosenSyms.size(); i++)
+                lazyState->innerLoaded[i].store(true, std::memory_order_relaxed);
+    }
     
     if (textIndex != SHN_UNDEF) /* if have ".text" */
     {
-        const typename Types::Shdr& textHdr = mainElf.getSectionHeader(textIndex);
-        cxbyte* textContent = mainElf.getBinaryCode() + ULEV(textHdr.sh_offset);
-        
         /* create table of innerBinaries */
-        size_t ki = 0;
-        for (auto it: choosenSyms)
-        {
-            const char* symName = mainElf.getSymbolName(it);
-            size_t len = ::strlen(symName);
-            const typename Types::Sym& sym = mainElf.getSymbol(it);
-            
-            const typename Types::Word symvalue = ULEV(sym.st_value);
-            const typename Types::Word symsize = ULEV(sym.st_size);
-            if (symvalue > ULEV(textHdr.sh_size))
-                throw BinException("Inner binary offset out of range!");
-            if (usumGt(symvalue, symsize, ULEV(textHdr.sh_size)))
-                throw BinException("Inner binary offset+size out of range!");
-            
-            innerBinaries[ki++] = AmdInnerGPUBinary32(CString(symName+9, len-16),
-                symsize, textContent+symvalue,
-                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
-        }
+        if (!lazy)
+            for (size_t ki = 0; ki < choosenSyms.size(); ki++)
+                initAmdInnerGPUBinary<Types>(mainElf, textIndex, choosenSyms[ki],
+                            innerBinaries[ki]);
         if ((creationFlags & AMDBIN_CREATE_INNERBINMAP) != 0)
         {
             innerBinaryMap.resize(innerBinaries.size());
             for (size_t i = 0; i < innerBinaries.size(); i++)
-                innerBinaryMap[i] = std::make_pair(innerBinaries[i].getKernelName(), i);
+            {
+                // kernel name preceded by '__OpenCL_' and precedes '_kernel'
+                const char* symName = mainElf.getSymbolName(choosenSyms[i]);
+                innerBinaryMap[i] = std::make_pair(
+                        CString(symName+9, ::strlen(symName)-16), i);
+            }
             mapSort(innerBinaryMap.begin(), innerBinaryMap.end());
         }
     }
@@ -1245,43 +1279,35 @@ void AmdMainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& mainElf)
         kernelInfos.resize(choosenSymsMetadata.size());
         metadatas.reset(new AmdGPUKernelMetadata[kernelInfos.size()]);
         
-        typename Types::Size ki = 0;
-        for (typename Types::Size it: choosenSymsMetadata)
+        if (!lazy)
+            for (size_t ki = 0; ki < choosenSymsMetadata.size(); ki++)
+                initAmdGPUKernelInfo<Types>(mainElf, choosenSymsMetadata[ki],
+                            kernelInfos[ki], metadatas[ki]);
+        else
         {
-            // read symbol _OpenCL..._metadata
-            const typename Types::Sym& sym = mainElf.getSymbol(it);
-            const char* symName = mainElf.getSymbolName(it);
-            if (ULEV(sym.st_shndx) >= mainElf.getSectionHeadersNum())
-                throw BinException("Metadata section index out of range");
-            
-            const typename Types::Shdr& rodataHdr =
-                    mainElf.getSectionHeader(ULEV(sym.st_shndx));
-            cxbyte* secContent = mainElf.getBinaryCode() + ULEV(rodataHdr.sh_offset);
-            
-            const typename Types::Word symvalue = ULEV(sym.st_value);
-            const typename Types::Word symsize = ULEV(sym.st_size);
-            if (symvalue > ULEV(rodataHdr.sh_size))
-                throw BinException("Metadata offset out of range");
-            if (usumGt(symvalue, symsize, ULEV(rodataHdr.sh_size)))
-                throw BinException("Metadata offset+size out of range");
-            
-            // parse AMDGPU kernel metadata
-            parseAmdGpuKernelMetadata(symName, symsize,
-                  reinterpret_cast<const char*>(secContent + symvalue),
-                  kernelInfos[ki]);
-            metadatas[ki].size = symsize;
-            metadatas[ki].data = reinterpret_cast<char*>(secContent + symvalue);
-            ki++;
+            lazyState->infoLoaded.reset(
+                        new std::atomic<bool>[choosenSymsMetadata.size()]());
+            lazyKernelInfos = true;
         }
         /* maps kernel info */
         if ((creationFlags & AMDBIN_CREATE_KERNELINFOMAP) != 0)
         {
             kernelInfosMap.resize(kernelInfos.size());
             for (size_t i = 0; i < kernelInfos.size(); i++)
-                kernelInfosMap[i] = std::make_pair(kernelInfos[i].kernelName, i);
+            {
+                // kernel name preceded by '__OpenCL_' and precedes '_metadata'
+                const char* symName = mainElf.getSymbolName(choosenSymsMetadata[i]);
+                kernelInfosMap[i] = std::make_pair(
+                        CString(symName+9, ::strlen(symName)-18), i);
+            }
             mapSort(kernelInfosMap.begin(), kernelInfosMap.end());
         }
     }
+    if (lazy)
+    {
+        lazyState->innerSyms = std::move(choosenSyms);
+        lazyState->metadataSyms = std::move(choosenSymsMetadata);
+    }
     if ((creationFlags & AMDBIN_CREATE_KERNELHEADERS) != 0)
     {
         kernelHeaders.resize(choosenSymsHeaders.size());
@@ -1330,7 +1356,7 @@ const AmdInnerGPUBinary32& AmdMainGPUBinaryBase::getInnerBinary(const char* name
                   innerBinaryMap.end(), name);
     if (it == innerBinaryMap.end())
         throw BinException("Can't find inner binary");
-    return innerBinaries[it->second];
+    return getInnerBinary(it->second);
 }
 
 const AmdGPUKernelHeader& AmdMainGPUBinaryBase::getKernelHeaderEntry(
@@ -1343,6 +1369,57 @@ const AmdGPUKernelHeader& AmdMainGPUBinaryBase::getKernelHeaderEntry(
     return kernelHeaders[it->second];
 }
 
+template<typename Types>
+void AmdMainGPUBinaryBase::loadLazyEntry(const typename Types::ElfBinary& mainElf,
+            size_t index, bool kernelInfo) const
+{
+    // entries are parsed once, object is logically const
+    typename Types::ElfBinary& elf = const_cast<typename Types::ElfBinary&>(mainElf);
+    AmdMainGPUBinaryBase& thisBin = const_cast<AmdMainGPUBinaryBase&>(*this);
+    if (kernelInfo)
+        initAmdGPUKernelInfo<Types>(elf, lazyState->metadataSyms[index],
+                    thisBin.kernelInfos[index], thisBin.metadatas[index]);
+    else
+        initAmdInnerGPUBinary<Types>(elf, lazyState->textIndex,
+                    lazyState->innerSyms[index], thisBin.innerBinaries[index]);
+}
+
+void AmdMainGPUBinaryBase::loadInnerBinary(size_t index) const
+{
+    std::atomic<bool>& loaded = lazyState->innerLoaded[index];
+    if (loaded.load(std::memory_order_acquire))
+        return;
+    std::lock_guard<std::mutex> lock(lazyState->mutex);
+    if (loaded.load(std::memory_order_relaxed))
+        return;
+    if (type == AmdMainType::GPU_BINARY)
+        loadLazyEntry<AmdGPU32Types>(
+                static_cast<const AmdMainGPUBinary32&>(*this), index, false);
+    else
+        loadLazyEntry<AmdGPU64Types>(
+                static_cast<const AmdMainGPUBinary64&>(*this), index, false);
+    loaded.store(true, std::memory_order_release);
+}
+
+void AmdMainGPUBinaryBase::loadKernelInfo(size_t index) const
+{
+    if (!lazyState->infoLoaded)
+        return; // no kernel infos
+    std::atomic<bool>& loaded = lazyState->infoLoaded[index];
+    if (loaded.load(std::memory_order_acquire))
+        return;
+    std::lock_guard<std::mutex> lock(lazyState->mutex);
+    if (loaded.load(std::memory_order_relaxed))
+        return;
+    if (type == AmdMainType::GPU_BINARY)
+        loadLazyEntry<AmdGPU32Types>(
+                static_cast<const AmdMainGPUBinary32&>(*this), index, true);
+    else
+        loadLazyEntry<AmdGPU64Types>(
+                static_cast<const AmdMainGPUBinary64&>(*this), index, true);
+    loaded.store(true, std::memory_order_release);
+}
+
 /* AmdMainGPUBinary32 */
 
 AmdMainGPUBinary32::AmdMainGPUBinary32(size_t binaryCodeSize, cxbyte* binaryCode,
@@ -1433,11 +1510,7 @@ AmdMainX86Binary32::AmdMainX86Binary32(size_t binaryCodeSize, cxbyte* binaryCode
        Flags creationFlags) : AmdMainBinaryBase(AmdMainType::X86_BINARY),
        ElfBinary32(binaryCodeSize, binaryCode, creationFlags)
 {
-    cxuint textIndex = SHN_UNDEF;
-    try
-    { textIndex = getSectionIndex(".text"); }
-    catch(const Exception& ex)
-    { } // ignore failed
+    cxuint textIndex = findSectionIndex(".text");
     
     if (textIndex != SHN_UNDEF)
     {
@@ -1445,7 +1518,7 @@ AmdMainX86Binary32::AmdMainX86Binary32(size_t binaryCodeSize, cxbyte* binaryCode
         cxbyte* textContent = binaryCode + ULEV(textHdr.sh_offset);
         
         innerBinary = AmdInnerX86Binary32(ULEV(textHdr.sh_size), textContent,
-                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
+                getAmdInnerCreationFlags(creationFlags));
     }
     
     if ((creationFlags & AMDBIN_CREATE_INFOSTRINGS) != 0)
@@ -1479,11 +1552,7 @@ AmdMainX86Binary32::AmdMainX86Binary32(size_t binaryCodeSize, cxbyte* binaryCode
         }
         
         // put driver info
-        uint16_t commentShIndex = SHN_UNDEF;
-        try
-        { commentShIndex = getSectionIndex(".comment"); }
-        catch(const Exception& ex)
-        { }
+        uint16_t commentShIndex = findSectionIndex(".comment");
         if (commentShIndex != SHN_UNDEF)
         {
             size_t offset = 0;
@@ -1518,11 +1587,7 @@ AmdMainX86Binary64::AmdMainX86Binary64(size_t binaryCodeSize, cxbyte* binaryCode
        Flags creationFlags) : AmdMainBinaryBase(AmdMainType::X86_64_BINARY),
        ElfBinary64(binaryCodeSize, binaryCode, creationFlags)
 {
-    cxuint textIndex = SHN_UNDEF;
-    try
-    { textIndex = getSectionIndex(".text"); }
-    catch(const Exception& ex)
-    { } // ignore failed
+    cxuint textIndex = findSectionIndex(".text");
     
     if (textIndex != SHN_UNDEF)
     {
@@ -1530,7 +1595,7 @@ AmdMainX86Binary64::AmdMainX86Binary64(size_t binaryCodeSize, cxbyte* binaryCode
         cxbyte* textContent = binaryCode + ULEV(textHdr.sh_offset);
         
         innerBinary = AmdInnerX86Binary64(ULEV(textHdr.sh_size), textContent,
-                (creationFlags >> AMDBIN_INNER_SHIFT) & AMDBIN_INNER_INT_CREATE_ALL);
+                getAmdInnerCreationFlags(creationFlags));
     }
     
     if ((creationFlags & AMDBIN_CREATE_INFOSTRINGS) != 0)
@@ -1563,11 +1628,7 @@ AmdMainX86Binary64::AmdMainX86Binary64(size_t binaryCodeSize, cxbyte* binaryCode
         }
         
         // put driver info
-        uint16_t commentShIndex = SHN_UNDEF;
-        try
-        { commentShIndex = getSectionIndex(".comment"); }
-        catch(const Exception& ex)
-        { }
+        uint16_t commentShIndex = findSectionIndex(".comment");
         if (commentShIndex != SHN_UNDEF)
         {
             size_t offset = 0;
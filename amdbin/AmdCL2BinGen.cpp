@@ -29,6 +29,7 @@
 #include <memory>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/utils/InputOutput.h>
+#include <CLRX/utils/GCNEncoding.h>
 #include <CLRX/amdbin/AmdCL2Binaries.h>
 #include <CLRX/amdbin/AmdCL2BinGen.h>
 
@@ -1471,73 +1472,6 @@ struct CLRX_INTERNAL IntAmdCL2StubHeader
     uint32_t sgprsNumAll;
 };
 
-static const bool gcnSize11Table[16] =
-{
-    false, // GCNENC_SMRD, // 0000
-    false, // GCNENC_SMRD, // 0001
-    false, // GCNENC_VINTRP, // 0010
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_NONE, // 0101 - illegal
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    true,  // GCNENC_EXP,   // 1110
-    false  // GCNENC_NONE   // 1111 - illegal
-};
-
-static const bool gcnSize12Table[16] =
-{
-    true,  // GCNENC_SMEM, // 0000
-    true,  // GCNENC_EXP, // 0001
-    false, // GCNENC_NONE, // 0010 - illegal
-    false, // GCNENC_NONE, // 0011 - illegal
-    true,  // GCNENC_VOP3A, // 0100
-    false, // GCNENC_VINTRP, // 0101
-    true,  // GCNENC_DS,   // 0110
-    true,  // GCNENC_FLAT, // 0111
-    true,  // GCNENC_MUBUF, // 1000
-    false, // GCNENC_NONE,  // 1001 - illegal
-    true,  // GCNENC_MTBUF, // 1010
-    false, // GCNENC_NONE,  // 1011 - illegal
-    true,  // GCNENC_MIMG,  // 1100
-    false, // GCNENC_NONE,  // 1101 - illegal
-    false, // GCNENC_NONE,  // 1110 - illegal
-    false  // GCNENC_NONE   // 1111 - illegal
-};
-
-enum : cxbyte
-{
-    INSTRTYPE_OTHER = 0,
-    INSTRTYPE_GLOBAL,
-    INSTRTYPE_LOCAL,
-};
-
-static const cxbyte gcnEncInstrTable[16] =
-{
-    INSTRTYPE_OTHER, // 0000
-    INSTRTYPE_OTHER, // 0001
-    INSTRTYPE_OTHER, // 0010
-    INSTRTYPE_OTHER, // 0011 - illegal
-    INSTRTYPE_OTHER, // 0100
-    INSTRTYPE_OTHER, // 0101 - illegal
-    INSTRTYPE_LOCAL,  // 0110
-    INSTRTYPE_GLOBAL, // 0111
-    INSTRTYPE_GLOBAL, // 1000
-    INSTRTYPE_OTHER,  // 1001 - illegal
-    INSTRTYPE_GLOBAL, // 1010
-    INSTRTYPE_OTHER,  // 1011 - illegal
-    INSTRTYPE_GLOBAL, // 1100
-    INSTRTYPE_OTHER,  // 1101 - illegal
-    INSTRTYPE_OTHER,  // 1110
-    INSTRTYPE_OTHER // 1111 - illegal
-};
-
 /* count number of instructions, local memory operations and global memory operations */
 
 static void analyzeCode(GPUArchitecture arch, size_t codeSize, const cxbyte* code,
@@ -1548,107 +1482,28 @@ static void analyzeCode(GPUArchitecture arch, size_t codeSize, const cxbyte* cod
     uint32_t localMemOps = 0;
     const size_t codeWordsNum = codeSize>>2;
     const uint32_t* codeWords = reinterpret_cast<const uint32_t*>(code);
-    bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
-    bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+    const GCNEncodingEntry* encTable = getGCNEncodingTable(arch);
     
     /* main analyzing code loop, parse and determine instr encoding, and counts
      * global/local memory ops */
     for (size_t pos = 0; pos < codeWordsNum; instrsNum++)
     {
-        uint32_t insnCode = ULEV(codeWords[pos++]);
-        
-        if ((insnCode & 0x80000000U) != 0)
-        {
-            if ((insnCode & 0x40000000U) == 0)
-            {
-                // SOP???
-                if  ((insnCode & 0x30000000U) == 0x30000000U)
-                {
-                    // SOP1/SOPK/SOPC/SOPP
-                    const uint32_t encPart = (insnCode & 0x0f800000U);
-                    if (encPart == 0x0e800000U)
-                    {
-                        // SOP1
-                        if ((insnCode&0xff) == 0xff) // literal
-                        {
-                            if (pos < codeWordsNum) pos++;
-                        }
-                    }
-                    else if (encPart == 0x0f000000U)
-                    {
-                        // SOPC
-                        if ((insnCode&0xff) == 0xff ||
-                            (insnCode&0xff00) == 0xff00) // literal
-                            if (pos < codeWordsNum) pos++;
-                    }
-                    else if (encPart != 0x0f800000U) // no SOPP
-                    {
-                        const uint32_t opcode = ((insnCode>>23)&0x1f);
-                        if ((!isGCN12 && opcode == 21) ||
-                            (isGCN12 && opcode == 20))
-                            if (pos < codeWordsNum) pos++;
-                    }
-                }
-                else
-                {
-                    // SOP2
-                    if ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00)
-                        // literal
-                        if (pos < codeWordsNum) pos++;
-                }
-            }
-            else
-            {
-                // SMRD and others
-                const uint32_t encPart = (insnCode&0x3c000000U)>>26;
-                if ((!isGCN12 && gcnSize11Table[encPart] && (encPart != 7 || isGCN11)) ||
-                    (isGCN12 && gcnSize12Table[encPart]))
-                {
-                    if (pos < codeWordsNum) pos++;
-                }
-                cxbyte instrType = gcnEncInstrTable[encPart];
-                if (instrType == INSTRTYPE_LOCAL)
-                    localMemOps++;
-                if (instrType == INSTRTYPE_GLOBAL)
-                    globalMemOps++;
-            }
-        }
-        else
+        const uint32_t insnCode = ULEV(codeWords[pos]);
+        const GCNEncodingEntry& encEntry = getGCNEncodingEntry(encTable, insnCode);
+        pos = std::min(pos + getGCNInstrWordsNum(encEntry, insnCode), codeWordsNum);
+        switch (encEntry.encoding)
         {
-            // some vector instructions
-            if ((insnCode & 0x7e000000U) == 0x7c000000U)
-            {
-                // VOPC
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                {
-                    if (pos < codeWordsNum) pos++;
-                }
-            }
-            else if ((insnCode & 0x7e000000U) == 0x7e000000U)
-            {
-                // VOP1
-                if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    if (pos < codeWordsNum) pos++;
-            }
-            else
-            {
-                // VOP2
-                const cxuint opcode = (insnCode >> 25)&0x3f;
-                if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
-                    (isGCN12 && (opcode == 23 || opcode == 24 ||
-                    opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
-                {
-                    if (pos < codeWordsNum) pos++;
-                }
-                else if ((insnCode&0x1ff) == 0xff || // literal
-                    // SDWA, DDP
-                    (isGCN12 && ((insnCode&0x1ff) == 0xf9 || (insnCode&0x1ff) == 0xfa)))
-                    if (pos < codeWordsNum) pos++; 
-            }
+            case GCNENC_DS:
+                localMemOps++;
+                break;
+            case GCNENC_FLAT:
+            case GCNENC_MUBUF:
+            case GCNENC_MTBUF:
+            case GCNENC_MIMG:
+                globalMemOps++;
+                break;
+            default:
+                break;
         }
     }
     
@@ -32,6 +32,13 @@
 
 using namespace CLRX;
 
+// convert AMD OpenCL 2.0 binary creation flags into inner binary creation flags
+static inline Flags getAmdCL2InnerCreationFlags(Flags creationFlags)
+{
+    return (creationFlags >> AMDBIN_INNER_SHIFT) |
+        ((creationFlags & AMDBIN_INNER_CREATE_HASHINDEX) != 0 ? ELF_CREATE_HASHINDEX : 0);
+}
+
 /* class AmdCL2InnerGPUBinaryBase */
 
 AmdCL2InnerGPUBinaryBase::~AmdCL2InnerGPUBinaryBase()
@@ -55,11 +62,7 @@ AmdCL2OldInnerGPUBinary::AmdCL2OldInnerGPUBinary(ElfBinaryTemplate<Types>* mainB
 {
     if ((creationFlags & (AMDCL2BIN_CREATE_KERNELDATA|AMDCL2BIN_CREATE_KERNELSTUBS)) == 0)
         return; // nothing to initialize
-    uint16_t textIndex = SHN_UNDEF;
-    try
-    { textIndex = mainBinary->getSectionIndex(".text"); }
-    catch(const Exception& ex)
-    { }
+    uint16_t textIndex = mainBinary->findSectionIndex(".text");
     // find symbols of ISA kernel binary
     std::vector<size_t> choosenSyms;
     const size_t symbolsNum = mainBinary->getSymbolsNum();
@@ -213,69 +216,63 @@ AmdCL2InnerGPUBinary::AmdCL2InnerGPUBinary(size_t binaryCodeSize, cxbyte* binary
             mapSort(kernelDataMap.begin(), kernelDataMap.end());
     }
     // get global data - from section
-    try
+    const uint16_t gdataIndex = findSectionIndex(".hsadata_readonly_agent");
+    if (gdataIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& gdataShdr = getSectionHeader(".hsadata_readonly_agent");
+        const Elf64_Shdr& gdataShdr = getSectionHeader(gdataIndex);
         globalDataSize = ULEV(gdataShdr.sh_size);
         globalData = binaryCode + ULEV(gdataShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
     
     // get hsadata_global_agent (used by atomics)
-    try
+    const uint16_t rwIndex = findSectionIndex(".hsadata_global_agent");
+    if (rwIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& rwShdr = getSectionHeader(".hsadata_global_agent");
+        const Elf64_Shdr& rwShdr = getSectionHeader(rwIndex);
         rwDataSize = ULEV(rwShdr.sh_size);
         rwData = binaryCode + ULEV(rwShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
     // get hsabss_gobal_agent
-    try
+    const uint16_t bssIndex = findSectionIndex(".hsabss_global_agent");
+    if (bssIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& bssShdr = getSectionHeader(".hsabss_global_agent");
+        const Elf64_Shdr& bssShdr = getSectionHeader(bssIndex);
         bssSize = ULEV(bssShdr.sh_size);
         bssAlignment = ULEV(bssShdr.sh_addralign);
     }
-    catch(const Exception& ex)
-    { }
     
     // get ssection with sampler data '.hsaimage_samplerinit'
-    try
+    const uint16_t samplerInitIndex = findSectionIndex(".hsaimage_samplerinit");
+    if (samplerInitIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& dataShdr = getSectionHeader(".hsaimage_samplerinit");
+        const Elf64_Shdr& dataShdr = getSectionHeader(samplerInitIndex);
         samplerInitSize = ULEV(dataShdr.sh_size);
         samplerInit = binaryCode + ULEV(dataShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
     
     // get relocation section for text
-    try
+    const uint16_t textRelaIndex = findSectionIndex(".rela.hsatext");
+    if (textRelaIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& relaShdr = getSectionHeader(".rela.hsatext");
+        const Elf64_Shdr& relaShdr = getSectionHeader(textRelaIndex);
         textRelEntrySize = ULEV(relaShdr.sh_entsize);
         if (textRelEntrySize==0)
             textRelEntrySize = sizeof(Elf64_Rela);
         textRelsNum = ULEV(relaShdr.sh_size)/textRelEntrySize;
         textRela = binaryCode + ULEV(relaShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
     
     /// get relocation for hsadata_readonly_agent (readonly data section)
-    try
+    const uint16_t gdataRelaIndex = findSectionIndex(".rela.hsadata_readonly_agent");
+    if (gdataRelaIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& relaShdr = getSectionHeader(".rela.hsadata_readonly_agent");
+        const Elf64_Shdr& relaShdr = getSectionHeader(gdataRelaIndex);
         globalDataRelEntrySize = ULEV(relaShdr.sh_entsize);
         if (globalDataRelEntrySize==0)
             globalDataRelEntrySize = sizeof(Elf64_Rela);
         globalDataRelsNum = ULEV(relaShdr.sh_size)/globalDataRelEntrySize;
         globalDataRela = binaryCode + ULEV(relaShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
 }
 
 /* AmdCL2MainGPUBinary64 */
@@ -633,14 +630,13 @@ void AmdCL2MainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& elfBi
     }
     
     const bool newInnerBinary = choosenBinSyms.empty();
-    uint16_t textIndex = SHN_UNDEF;
     driverVersion = newInnerBinary ? 191205: 180005;
-    try
-    { textIndex = elfBin.getSectionIndex(".text"); }
-    catch(const Exception& ex)
+    const uint16_t textIndex = elfBin.findSectionIndex(".text");
+    if (textIndex == SHN_UNDEF)
     {
         if (!choosenMetadataSyms.empty())
-            throw;  // throw exception if least one kernel is present
+            // throw exception if least one kernel is present
+            throw BinException(std::string("Can't find Elf")+Types::bitName+" Section");
         else // old driver version
             driverVersion = 180005;
     }
@@ -651,27 +647,26 @@ void AmdCL2MainGPUBinaryBase::initMainGPUBinary(typename Types::ElfBinary& elfBi
         {
             innerBinary.reset(new AmdCL2InnerGPUBinary(ULEV(textShdr.sh_size),
                            binaryCode + ULEV(textShdr.sh_offset),
-                           creationFlags >> AMDBIN_INNER_SHIFT));
+                           getAmdCL2InnerCreationFlags(creationFlags)));
             // detect new format from Crimson 16.4
             const auto& innerBin = getInnerBinary();
             driverVersion = (innerBin.getSymbolsNum()!=0 &&
                     innerBin.getSymbolName(0)[0]==0) ? 200406 : 191205;
-            try
+            // special detection for first AMDGPU-PRO driver (may be bug in driver)
+            const uint16_t noteIndex = innerBin.findSectionIndex(".note");
+            if (noteIndex != SHN_UNDEF)
             {
-                // special detection for first AMDGPU-PRO driver (may be bug in driver)
-                const Elf64_Shdr& noteShdr = innerBin.getSectionHeader(".note");
-                const cxbyte* noteContent = innerBin.getSectionContent(".note");
+                const Elf64_Shdr& noteShdr = innerBin.getSectionHeader(noteIndex);
+                const cxbyte* noteContent = innerBin.getSectionContent(noteIndex);
                 const size_t noteSize = ULEV(noteShdr.sh_size);
                 if (noteSize == 200 && noteContent[197]!=0)
                     driverVersion = 203603;
             }
-            catch(const Exception& ex)
-            { }
         }
         else // old driver
             innerBinary.reset(new AmdCL2OldInnerGPUBinary(&elfBin, ULEV(textShdr.sh_size),
                            binaryCode + ULEV(textShdr.sh_offset),
-                           creationFlags >> AMDBIN_INNER_SHIFT));
+                           getAmdCL2InnerCreationFlags(creationFlags)));
     }
     
     // get metadata
@@ -22,6 +22,7 @@
 #include <cstring>
 #include <cstdint>
 #include <climits>
+#include <algorithm>
 #include <utility>
 #include <string>
 #include <cassert>
@@ -59,6 +60,142 @@ static size_t unfinishedRegionOfStringTable(const cxbyte* table, size_t size)
     return (table[k]==0)?k+1:k;
 }
 
+/* ELF hash function (from System V ABI) */
+static inline uint32_t elfHashName(const char* inName)
+{
+    uint32_t h = 0, g;
+    const cxbyte* name = reinterpret_cast<const cxbyte*>(inName);
+    while(*name!=0)
+    {
+        h = (h<<4) + *name++;
+        g = h & 0xf0000000U;
+        if (g) h ^= g>>24;
+        h &= ~g;
+    }
+    return h;
+}
+
+/* ELF hash index routines */
+
+/* hash for hash index (based on MurmurHash3), it processes 4 bytes in single step.
+ * ELF hash is not used, because it processes single byte in single step and
+ * it depends mainly on last characters of name (many collisions for common suffixes) */
+static inline uint32_t elfHashIndexHash(const char* name, size_t len)
+{
+    uint32_t h = uint32_t(len);
+    size_t i = 0;
+    for (; i+4 <= len; i += 4)
+    {
+        uint32_t k;
+        ::memcpy(&k, name+i, 4);
+        k *= 0xcc9e2d51U;
+        k = (k<<15) | (k>>17);
+        h ^= k*0x1b873593U;
+        h = (h<<13) | (h>>19);
+        h = h*5 + 0xe6546b64U;
+    }
+    uint32_t k = 0;
+    for (; i < len; i++)
+        k = (k<<8) | cxbyte(name[i]);
+    k *= 0xcc9e2d51U;
+    k = (k<<15) | (k>>17);
+    h ^= k*0x1b873593U;
+    // final mix
+    h ^= h>>16;
+    h *= 0x85ebca6bU;
+    h ^= h>>13;
+    h *= 0xc2b2ae35U;
+    h ^= h>>16;
+    return h;
+}
+
+static void initElfHashIndex(ElfHashIndex& index, size_t elemsNum)
+{
+    if (elemsNum >= UINT32_MAX)
+        throw BinException("Too many elements for hash index!");
+    // keep load factor below 0.5
+    size_t size = 4;
+    while (size < (elemsNum<<1))
+        size <<= 1;
+    index.resize(size);
+    std::fill(index.begin(), index.end(), ElfHashIndexEntry{ 0, UINT32_MAX, 0 });
+}
+
+static inline void insertElfHashIndex(ElfHashIndex& index, const char* name,
+                uint32_t nameOffset, uint32_t elemIndex)
+{
+    const uint32_t hash = elfHashIndexHash(name, ::strlen(name));
+    const size_t mask = index.size()-1;
+    size_t slot = hash & mask;
+    while (index[slot].index != UINT32_MAX)
+        slot = (slot+1) & mask;
+    index[slot] = { hash, elemIndex, nameOffset };
+}
+
+/* find in hash index, returns SIZE_MAX if not found.
+ * if many elements have same name, then returns first element */
+static size_t findInElfHashIndex(const ElfHashIndex& index, const cxbyte* stringTable,
+                const char* name)
+{
+    const uint32_t hash = elfHashIndexHash(name, ::strlen(name));
+    const size_t mask = index.size()-1;
+    for (size_t slot = hash & mask; index[slot].index != UINT32_MAX; slot = (slot+1) & mask)
+        if (index[slot].hash == hash && ::strcmp(reinterpret_cast<const char*>(
+                    stringTable + index[slot].nameOffset), name) == 0)
+            return index[slot].index;
+    return SIZE_MAX;
+}
+
+/* find ELF hash table ('.hash') for symbol table, returns null if not found
+ * or hash table is not usable */
+template<typename Types>
+static const cxbyte* findElfHashTable(const ElfBinaryTemplate<Types>& elf,
+            const typename Types::Shdr* symTableHdr, size_t symbolsNum)
+{
+    const cxuint shnum = elf.getSectionHeadersNum();
+    for (cxuint i = 0; i < shnum; i++)
+    {
+        const typename Types::Shdr& shdr = elf.getSectionHeader(i);
+        if (ULEV(shdr.sh_type) != SHT_HASH ||
+            &elf.getSectionHeader(ULEV(shdr.sh_link)) != symTableHdr)
+            continue;
+        const size_t size = ULEV(shdr.sh_size);
+        if (size < 8)
+            continue;
+        const cxbyte* content = elf.getBinaryCode() + ULEV(shdr.sh_offset);
+        const uint32_t* table = reinterpret_cast<const uint32_t*>(content);
+        const uint64_t bucketsNum = ULEV(table[0]);
+        const uint64_t chainsNum = ULEV(table[1]);
+        if (bucketsNum == 0 || chainsNum != symbolsNum ||
+            (2 + bucketsNum + chainsNum)*4 > size)
+            continue; // malformed, ignore
+        return content;
+    }
+    return nullptr;
+}
+
+/* find symbol in ELF hash table ('.hash'), returns SIZE_MAX if not found */
+template<typename GetName>
+static size_t findInElfHashTable(const cxbyte* hashTable, const char* name,
+                GetName getName)
+{
+    const uint32_t* table = reinterpret_cast<const uint32_t*>(hashTable);
+    const uint32_t bucketsNum = ULEV(table[0]);
+    const uint32_t chainsNum = ULEV(table[1]);
+    const uint32_t* buckets = table + 2;
+    const uint32_t* chains = buckets + bucketsNum;
+    uint32_t i = ULEV(buckets[elfHashName(name) % bucketsNum]);
+    // limit steps to avoid infinite loop for malformed chains
+    for (uint32_t steps = 0; i != STN_UNDEF && i < chainsNum && steps < chainsNum;
+                steps++, i = ULEV(chains[i]))
+        if (::strcmp(getName(i), name) == 0)
+            return i;
+    // first symbol is not reachable by chains
+    if (chainsNum != 0 && ::strcmp(getName(0), name) == 0)
+        return 0;
+    return SIZE_MAX;
+}
+
 /* elf32 types */
 
 const cxbyte CLRX::Elf32Types::ELFCLASS = ELFCLASS32;
@@ -77,7 +214,8 @@ template<typename Types>
 ElfBinaryTemplate<Types>::ElfBinaryTemplate() : binaryCodeSize(0), binaryCode(nullptr),
         sectionStringTable(nullptr), symbolStringTable(nullptr),
         symbolTable(nullptr), dynSymStringTable(nullptr), dynSymTable(nullptr),
-        noteTable(nullptr), symbolsNum(0), dynSymbolsNum(0),
+        noteTable(nullptr), dynamicTable(nullptr), symbolElfHash(nullptr),
+        dynSymElfHash(nullptr), symbolsNum(0), dynSymbolsNum(0),
         noteTableSize(0), dynamicsNum(0), symbolEntSize(0), dynSymEntSize(0),
         dynamicEntSize(0)
 { }
@@ -92,7 +230,8 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
         binaryCodeSize(_binaryCodeSize), binaryCode(_binaryCode),
         sectionStringTable(nullptr), symbolStringTable(nullptr),
         symbolTable(nullptr), dynSymStringTable(nullptr), dynSymTable(nullptr),
-        noteTable(nullptr), symbolsNum(0), dynSymbolsNum(0),
+        noteTable(nullptr), dynamicTable(nullptr), symbolElfHash(nullptr),
+        dynSymElfHash(nullptr), symbolsNum(0), dynSymbolsNum(0),
         noteTableSize(0), dynamicsNum(0), symbolEntSize(0), dynSymEntSize(0),
         dynamicEntSize(0)     
 {
@@ -161,6 +300,8 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
         cxuint shnum = ULEV(ehdr->e_shnum);
         if ((creationFlags & ELF_CREATE_SECTIONMAP) != 0)
             sectionIndexMap.resize(shnum);
+        if ((creationFlags & ELF_CREATE_HASHINDEX) != 0)
+            initElfHashIndex(sectionHashIndex, shnum);
         for (cxuint i = 0; i < shnum; i++)
         {
             const typename Types::Shdr& shdr = getSectionHeader(i);
@@ -185,6 +326,8 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
             
             if ((creationFlags & ELF_CREATE_SECTIONMAP) != 0)
                 sectionIndexMap[i] = std::make_pair(shname, i);
+            if ((creationFlags & ELF_CREATE_HASHINDEX) != 0)
+                insertElfHashIndex(sectionHashIndex, shname, sh_nameindx, i);
             // set symbol table and dynamic symbol table pointers
             if (ULEV(shdr.sh_type) == SHT_SYMTAB)
                 symTableHdr = &shdr;
@@ -218,6 +361,15 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
             symbolsNum = ULEV(symTableHdr->sh_size)/ULEV(symTableHdr->sh_entsize);
             if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0)
                 symbolIndexMap.resize(symbolsNum);
+            // use ELF hash table if exists, otherwise build own hash index
+            bool buildHashIndex = false;
+            if ((creationFlags & ELF_CREATE_HASHINDEX) != 0)
+            {
+                symbolElfHash = findElfHashTable(*this, symTableHdr, symbolsNum);
+                buildHashIndex = (symbolElfHash == nullptr);
+                if (buildHashIndex)
+                    initElfHashIndex(symbolHashIndex, symbolsNum);
+            }
             
             for (typename Types::Size i = 0; i < symbolsNum; i++)
             {
@@ -235,6 +387,8 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                 // add to symbol map
                 if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0)
                     symbolIndexMap[i] = std::make_pair(symname, i);
+                if (buildHashIndex)
+                    insertElfHashIndex(symbolHashIndex, symname, symnameindx, i);
             }
             // sort symbol's map (really is array of symbols)
             if ((creationFlags & ELF_CREATE_SYMBOLMAP) != 0)
@@ -261,6 +415,15 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
             
             if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0)
                 dynSymIndexMap.resize(dynSymbolsNum);
+            // use ELF hash table if exists, otherwise build own hash index
+            bool buildHashIndex = false;
+            if ((creationFlags & ELF_CREATE_HASHINDEX) != 0)
+            {
+                dynSymElfHash = findElfHashTable(*this, dynSymTableHdr, dynSymbolsNum);
+                buildHashIndex = (dynSymElfHash == nullptr);
+                if (buildHashIndex)
+                    initElfHashIndex(dynSymHashIndex, dynSymbolsNum);
+            }
             
             for (typename Types::Size i = 0; i < dynSymbolsNum; i++)
             {
@@ -278,6 +441,8 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
                 // add to symbol map
                 if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0)
                     dynSymIndexMap[i] = std::make_pair(symname, i);
+                if (buildHashIndex)
+                    insertElfHashIndex(dynSymHashIndex, symname, symnameindx, i);
             }
             // sort dynamic symbol's map (really is array of dynamic symbols)
             if ((creationFlags & ELF_CREATE_DYNSYMMAP) != 0)
@@ -304,16 +469,17 @@ ElfBinaryTemplate<Types>::ElfBinaryTemplate(size_t _binaryCodeSize, cxbyte* _bin
 }
 
 template<typename Types>
-uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
+size_t ElfBinaryTemplate<Types>::findSectionIndexInt(const char* name) const
 {
-    if (hasSectionMap())
+    if (!sectionHashIndex.empty())
+        // find in hash index
+        return findInElfHashIndex(sectionHashIndex, sectionStringTable, name);
+    else if (hasSectionMap())
     {
         // find in section map (sorted array)
         SectionIndexMap::const_iterator it = binaryMapFind(
                     sectionIndexMap.begin(), sectionIndexMap.end(), name, CStringLess());
-        if (it == sectionIndexMap.end())
-            throw BinException(std::string("Can't find Elf")+Types::bitName+" Section");
-        return it->second;
+        return (it != sectionIndexMap.end()) ? it->second : SIZE_MAX;
     }
     else
     {
@@ -323,28 +489,80 @@ uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
             if (::strcmp(getSectionName(i), name) == 0)
                 return i;
         }
+        return SIZE_MAX;
+    }
+}
+
+template<typename Types>
+uint16_t ElfBinaryTemplate<Types>::getSectionIndex(const char* name) const
+{
+    const size_t index = findSectionIndexInt(name);
+    if (index == SIZE_MAX)
         throw BinException(std::string("Can't find Elf")+Types::bitName+" Section");
+    return index;
+}
+
+template<typename Types>
+uint16_t ElfBinaryTemplate<Types>::findSectionIndex(const char* name) const
+{
+    const size_t index = findSectionIndexInt(name);
+    return (index != SIZE_MAX) ? index : SHN_UNDEF;
+}
+
+template<typename Types>
+typename Types::Size ElfBinaryTemplate<Types>::findSymbolIndex(const char* name) const
+{
+    size_t index = SIZE_MAX;
+    if (symbolElfHash != nullptr)
+        index = findInElfHashTable(symbolElfHash, name,
+                [this](size_t i) { return getSymbolName(i); });
+    else if (!symbolHashIndex.empty())
+        index = findInElfHashIndex(symbolHashIndex, symbolStringTable, name);
+    else
+    {
+        SymbolIndexMap::const_iterator it = binaryMapFind(
+                    symbolIndexMap.begin(), symbolIndexMap.end(), name, CStringLess());
+        if (it != symbolIndexMap.end())
+            index = it->second;
+    }
+    return (index != SIZE_MAX) ? index : Types::nosymbol;
+}
+
+template<typename Types>
+typename Types::Size ElfBinaryTemplate<Types>::findDynSymbolIndex(const char* name) const
+{
+    size_t index = SIZE_MAX;
+    if (dynSymElfHash != nullptr)
+        index = findInElfHashTable(dynSymElfHash, name,
+                [this](size_t i) { return getDynSymbolName(i); });
+    else if (!dynSymHashIndex.empty())
+        index = findInElfHashIndex(dynSymHashIndex, dynSymStringTable, name);
+    else
+    {
+        SymbolIndexMap::const_iterator it = binaryMapFind(
+                    dynSymIndexMap.begin(), dynSymIndexMap.end(), name, CStringLess());
+        if (it != dynSymIndexMap.end())
+            index = it->second;
     }
+    return (index != SIZE_MAX) ? index : Types::nosymbol;
 }
 
 template<typename Types>
 typename Types::Size ElfBinaryTemplate<Types>::getSymbolIndex(const char* name) const
 {
-    SymbolIndexMap::const_iterator it = binaryMapFind(
-                    symbolIndexMap.begin(), symbolIndexMap.end(), name, CStringLess());
-    if (it == symbolIndexMap.end())
+    const typename Types::Size index = findSymbolIndex(name);
+    if (index == Types::nosymbol)
         throw BinException(std::string("Can't find Elf")+Types::bitName+" Symbol");
-    return it->second;
+    return index;
 }
 
 template<typename Types>
 typename Types::Size ElfBinaryTemplate<Types>::getDynSymbolIndex(const char* name) const
 {
-    SymbolIndexMap::const_iterator it = binaryMapFind(
-                    dynSymIndexMap.begin(), dynSymIndexMap.end(), name, CStringLess());
-    if (it == dynSymIndexMap.end())
+    const typename Types::Size index = findDynSymbolIndex(name);
+    if (index == Types::nosymbol)
         throw BinException(std::string("Can't find Elf")+Types::bitName+" DynSymbol");
-    return it->second;
+    return index;
 }
 
 template class CLRX::ElfBinaryTemplate<CLRX::Elf32Types>;
@@ -406,17 +624,7 @@ static std::unique_ptr<uint32_t[]> calculateHashValuesForSymbols(bool addNullSym
         hashCodes[0] = 0;
     for (size_t i = 0; i < symbols.size(); i++)
     {
-        // main routine of hash
-        uint32_t h = 0, g;
-        const cxbyte* name = reinterpret_cast<const cxbyte*>(symbols[i].name);
-        while(*name!=0)
-        {
-            h = (h<<4) + *name++;
-            g = h & 0xf0000000U;
-            if (g) h ^= g>>24;
-            h &= ~g;
-        }
-        hashCodes[i+addNullSymbol] = h;
+        hashCodes[i+addNullSymbol] = elfHashName(symbols[i].name);
     }
     return hashCodes;
 }
@@ -34,6 +34,13 @@
 
 using namespace CLRX;
 
+// convert Gallium binary creation flags into inner binary creation flags
+static inline Flags getGalliumInnerCreationFlags(Flags creationFlags)
+{
+    return (creationFlags >> GALLIUM_INNER_SHIFT) |
+        ((creationFlags & GALLIUM_INNER_CREATE_HASHINDEX) != 0 ? ELF_CREATE_HASHINDEX : 0);
+}
+
 /* Gallium ELF binary */
 
 GalliumElfBinaryBase::GalliumElfBinaryBase() :
@@ -44,17 +51,9 @@ GalliumElfBinaryBase::GalliumElfBinaryBase() :
 template<typename ElfBinary>
 void GalliumElfBinaryBase::loadFromElf(ElfBinary& elfBinary, size_t kernelsNum)
 {
-    uint16_t amdGpuConfigIndex = SHN_UNDEF;
-    try
-    { amdGpuConfigIndex = elfBinary.getSectionIndex(".AMDGPU.config"); }
-    catch(const Exception& ex)
-    { }
+    uint16_t amdGpuConfigIndex = elfBinary.findSectionIndex(".AMDGPU.config");
     
-    uint16_t amdGpuDisasmIndex = SHN_UNDEF;
-    try
-    { amdGpuDisasmIndex = elfBinary.getSectionIndex(".AMDGPU.disasm"); }
-    catch(const Exception& ex)
-    { }
+    uint16_t amdGpuDisasmIndex = elfBinary.findSectionIndex(".AMDGPU.disasm");
     if (amdGpuDisasmIndex != SHN_UNDEF)
     {
         // set disassembler section
@@ -63,15 +62,10 @@ void GalliumElfBinaryBase::loadFromElf(ElfBinary& elfBinary, size_t kernelsNum)
         disasmSize = ULEV(shdr.sh_size);
     }
     
-    uint16_t textIndex = SHN_UNDEF;
+    const uint16_t textIndex = elfBinary.findSectionIndex(".text");
     size_t textSize = 0;
-    try
-    {
-        textIndex = elfBinary.getSectionIndex(".text");
+    if (textIndex != SHN_UNDEF)
         textSize = ULEV(elfBinary.getSectionHeader(textIndex).sh_size);
-    }
-    catch(const Exception& ex)
-    { }
     
     if (amdGpuConfigIndex == SHN_UNDEF || textIndex == SHN_UNDEF)
         return;
@@ -174,17 +168,16 @@ GalliumElfBinary32::GalliumElfBinary32(size_t binaryCodeSize, cxbyte* binaryCode
     loadFromElf(static_cast<const ElfBinary32&>(*this), kernelsNum);
     
     // get relocation section for text
-    try
+    const uint16_t relIndex = findSectionIndex(".rel.text");
+    if (relIndex != SHN_UNDEF)
     {
-        const Elf32_Shdr& relShdr = getSectionHeader(".rel.text");
+        const Elf32_Shdr& relShdr = getSectionHeader(relIndex);
         textRelEntrySize = ULEV(relShdr.sh_entsize);
         if (textRelEntrySize==0)
             textRelEntrySize = sizeof(Elf32_Rel);
         textRelsNum = ULEV(relShdr.sh_size)/textRelEntrySize;
         textRel = binaryCode + ULEV(relShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
     
     innerBinaryGetScratchRelocs(*this, scratchRelocs);
 }
@@ -203,17 +196,16 @@ GalliumElfBinary64::GalliumElfBinary64(size_t binaryCodeSize, cxbyte* binaryCode
 {
     loadFromElf(static_cast<const ElfBinary64&>(*this), kernelsNum);
     // get relocation section for text
-    try
+    const uint16_t relIndex = findSectionIndex(".rel.text");
+    if (relIndex != SHN_UNDEF)
     {
-        const Elf64_Shdr& relShdr = getSectionHeader(".rel.text");
+        const Elf64_Shdr& relShdr = getSectionHeader(relIndex);
         textRelEntrySize = ULEV(relShdr.sh_entsize);
         if (textRelEntrySize==0)
             textRelEntrySize = sizeof(Elf64_Rel);
         textRelsNum = ULEV(relShdr.sh_size)/textRelEntrySize;
         textRel = binaryCode + ULEV(relShdr.sh_offset);
     }
-    catch(const Exception& ex)
-    { }
     
     innerBinaryGetScratchRelocs(*this, scratchRelocs);
 }
@@ -250,11 +242,10 @@ static void verifyKernelSymbols(size_t kernelsNum, const GalliumKernel* kernels,
     for (uint32_t i = 0; i < kernelsNum; i++)
     {
         const GalliumKernel& kernel = kernels[i];
-        size_t symIndex = 0;
-        try 
-        { symIndex = elfBinary.getSymbolIndex(kernel.kernelName.c_str()); }
-        catch(const Exception& ex)
-        { throw BinException("Kernel symbol not found"); }
+        typedef typename GalliumElfBinary::ElfTypes ElfTypes;
+        const size_t symIndex = elfBinary.findSymbolIndex(kernel.kernelName.c_str());
+        if (symIndex == ElfTypes::nosymbol)
+            throw BinException("Kernel symbol not found");
         const auto& sym = elfBinary.getSymbol(symIndex);
         const char* symName = elfBinary.getSymbolName(symIndex);
         // kernel symol must be defined as global and must be bound to text section
@@ -388,7 +379,7 @@ GalliumBinary::GalliumBinary(size_t _binaryCodeSize, cxbyte* _binaryCode,
             {
                 // 32-bit
                 elfBinary.reset(new GalliumElfBinary32(section.size, data,
-                                 creationFlags>>GALLIUM_INNER_SHIFT, kernelsNum));
+                        getGalliumInnerCreationFlags(creationFlags), kernelsNum));
                 elf64BitBinary = false;
             }
             else if (ehdr.e_ident[EI_CLASS] == ELFCLASS64)
@@ -396,7 +387,7 @@ GalliumBinary::GalliumBinary(size_t _binaryCodeSize, cxbyte* _binaryCode,
                 // 64-bit
                 elfSectionId = section.sectionId;
                 elfBinary.reset(new GalliumElfBinary64(section.size, data,
-                                 creationFlags>>GALLIUM_INNER_SHIFT, kernelsNum));
+                        getGalliumInnerCreationFlags(creationFlags), kernelsNum));
                 elf64BitBinary = true;
             }
             else // wrong class
@@ -429,6 +420,56 @@ uint32_t GalliumBinary::getKernelIndex(const char* name) const
     return it-kernels.get();
 }
 
+// if Gallium binary (checks structure of container without parsing it)
+bool CLRX::isGalliumBinary(size_t binarySize, const cxbyte* binary)
+{
+    if (binarySize < 4)
+        return false;
+    const uint32_t kernelsNum = ULEV(*reinterpret_cast<const uint32_t*>(binary));
+    if (binarySize < uint64_t(kernelsNum)*16U)
+        return false;
+    uint64_t offset = 4;
+    for (uint32_t i = 0; i < kernelsNum; i++)
+    {
+        // kernel name and header
+        if (offset + 4 > binarySize)
+            return false;
+        offset += 4 + uint64_t(ULEV(*reinterpret_cast<const uint32_t*>(
+                        binary + offset)));
+        if (offset + 12 > binarySize)
+            return false;
+        const uint32_t argsNum = ULEV(reinterpret_cast<const uint32_t*>(
+                        binary + offset)[2]);
+        offset += 12 + uint64_t(argsNum)*24U;
+    }
+    if (offset + 4 > binarySize)
+        return false;
+    const uint32_t sectionsNum = ULEV(*reinterpret_cast<const uint32_t*>(
+                        binary + offset));
+    offset += 4;
+    if (binarySize - offset < uint64_t(sectionsNum)*20U)
+        return false;
+    bool haveElfBinary = false;
+    for (uint32_t i = 0; i < sectionsNum; i++)
+    {
+        if (offset + 20 > binarySize)
+            return false;
+        const uint32_t* data32 = reinterpret_cast<const uint32_t*>(binary + offset);
+        const uint32_t secType = ULEV(data32[1]);
+        const uint32_t size = ULEV(data32[2]);
+        if (secType > 255 || size != ULEV(data32[3])-4 || size != ULEV(data32[4]))
+            return false;
+        offset += 20;
+        if (offset + size > binarySize)
+            return false;
+        if (secType == cxuint(GalliumSectionType::TEXT) ||
+            secType == cxuint(GalliumSectionType::TEXT_EXECUTABLE_170))
+            haveElfBinary |= isElfBinary(size, binary + offset);
+        offset += size;
+    }
+    return haveElfBinary;
+}
+
 void GalliumInput::addEmptyKernel(const char* kernelName, cxuint llvmVersion)
 {
     GalliumKernelInput kinput = { kernelName, {
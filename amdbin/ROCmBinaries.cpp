@@ -1230,6 +1230,678 @@ void ROCmMetadata::parse(size_t metadataSize, const char* metadata)
     parseROCmMetadata(metadataSize, metadata, *this);
 }
 
+/*
+ * ROCm metadata view parser
+ */
+
+void ROCmKernelMetadataView::initialize()
+{
+    name = symbolName = language = ROCmStringView{};
+    vecTypeHint = runtimeHandle = ROCmStringView{};
+    argInfosStart = argInfosNum = 0;
+    langVersion[0] = langVersion[1] = BINGEN_NOTSUPPLIED;
+    reqdWorkGroupSize[0] = reqdWorkGroupSize[1] = reqdWorkGroupSize[2] = 0;
+    workGroupSizeHint[0] = workGroupSizeHint[1] = workGroupSizeHint[2] = 0;
+    kernargSegmentSize = BINGEN64_NOTSUPPLIED;
+    groupSegmentFixedSize = BINGEN64_NOTSUPPLIED;
+    privateSegmentFixedSize = BINGEN64_NOTSUPPLIED;
+    kernargSegmentAlign = BINGEN64_NOTSUPPLIED;
+    wavefrontSize = BINGEN_NOTSUPPLIED;
+    sgprsNum = BINGEN_NOTSUPPLIED;
+    vgprsNum = BINGEN_NOTSUPPLIED;
+    maxFlatWorkGroupSize = BINGEN64_NOTSUPPLIED;
+    fixedWorkGroupSize[0] = fixedWorkGroupSize[1] = fixedWorkGroupSize[2] = 0;
+    spilledSgprs = BINGEN_NOTSUPPLIED;
+    spilledVgprs = BINGEN_NOTSUPPLIED;
+}
+
+void ROCmMetadataView::initialize()
+{
+    version[0] = version[1] = 0;
+}
+
+CString ROCmStringView::toCString() const
+{
+    if (size == 0)
+        return CString();
+    if (kind == ROCMSTRVIEW_PLAIN)
+        return CString(ptr, ptr+size);
+    // decode string (it has been checked while parsing)
+    const char* strPtr = ptr;
+    size_t lineNo = 0;
+    if (kind == ROCMSTRVIEW_QUOTED)
+        return parseYAMLString(strPtr, ptr+size, lineNo);
+    return parseYAMLStringValue(strPtr, ptr+size, lineNo, prevIndent, false, true);
+}
+
+// all keys of metadata (for all levels)
+enum {
+    ROCMMTK_ACCQUAL = 0, ROCMMTK_ACTUALACCQUAL, ROCMMTK_ADDRSPACEQUAL, ROCMMTK_ALIGN,
+    ROCMMTK_ARGS, ROCMMTK_ATTRS, ROCMMTK_CODEPROPS, ROCMMTK_FIXED_WORK_GROUP_SIZE,
+    ROCMMTK_GROUP_SEGMENT_FIXED_SIZE, ROCMMTK_ISCONST, ROCMMTK_ISPIPE,
+    ROCMMTK_ISRESTRICT, ROCMMTK_ISVOLATILE, ROCMMTK_KERNARG_SEGMENT_ALIGN,
+    ROCMMTK_KERNARG_SEGMENT_SIZE, ROCMMTK_KERNELS, ROCMMTK_LANGUAGE,
+    ROCMMTK_LANGUAGE_VERSION, ROCMMTK_MAX_FLAT_WORK_GROUP_SIZE, ROCMMTK_NAME,
+    ROCMMTK_NUM_SGPRS, ROCMMTK_NUM_SPILLED_SGPRS, ROCMMTK_NUM_SPILLED_VGPRS,
+    ROCMMTK_NUM_VGPRS, ROCMMTK_POINTEE_ALIGN, ROCMMTK_PRINTF,
+    ROCMMTK_PRIVATE_SEGMENT_FIXED_SIZE, ROCMMTK_REQD_WORK_GROUP_SIZE,
+    ROCMMTK_RUNTIME_HANDLE, ROCMMTK_SIZE, ROCMMTK_SYMBOLNAME, ROCMMTK_TYPENAME,
+    ROCMMTK_VALUEKIND, ROCMMTK_VALUETYPE, ROCMMTK_VECTYPEHINT, ROCMMTK_VERSION,
+    ROCMMTK_WAVEFRONT_SIZE, ROCMMTK_WORK_GROUP_SIZE_HINT
+};
+
+static const char* rocmMetadataKeys[] =
+{
+    "AccQual", "ActualAccQual", "AddrSpaceQual", "Align", "Args", "Attrs", "CodeProps",
+    "FixedWorkGroupSize", "GroupSegmentFixedSize", "IsConst", "IsPipe", "IsRestrict",
+    "IsVolatile", "KernargSegmentAlign", "KernargSegmentSize", "Kernels", "Language",
+    "LanguageVersion", "MaxFlatWorkGroupSize", "Name", "NumSGPRs", "NumSpilledSGPRs",
+    "NumSpilledVGPRs", "NumVGPRs", "PointeeAlign", "Printf", "PrivateSegmentFixedSize",
+    "ReqdWorkGroupSize", "RuntimeHandle", "Size", "SymbolName", "TypeName",
+    "ValueKind", "ValueType", "VecTypeHint", "Version", "WavefrontSize",
+    "WorkGroupSizeHint"
+};
+
+static const size_t rocmMetadataKeysNum = sizeof(rocmMetadataKeys) / sizeof(const char*);
+
+/* perfect hash table for metadata keys: slot = (h ^ (h>>23)) & 127,
+ * where h = h*11 + c for every key character (0xff - empty slot) */
+static const cxbyte rocmMetadataKeysHashTable[128] =
+{
+    255, 255, 255, 33, 255, 255, 255, 255, 255, 255, 255, 255, 25, 255, 17, 255,
+    255, 30, 6, 255, 255, 28, 255, 255, 255, 255, 255, 1, 255, 255, 255, 14,
+    255, 255, 11, 255, 7, 26, 31, 20, 255, 255, 255, 15, 255, 255, 255, 255,
+    255, 32, 8, 255, 9, 4, 255, 255, 37, 27, 5, 255, 255, 24, 255, 255,
+    255, 255, 255, 255, 21, 255, 255, 255, 255, 255, 255, 255, 255, 29, 255, 255,
+    255, 18, 255, 255, 34, 255, 255, 22, 255, 12, 23, 0, 255, 255, 255, 255,
+    2, 255, 255, 255, 255, 255, 255, 255, 35, 255, 255, 255, 255, 255, 255, 255,
+    255, 3, 255, 255, 255, 255, 36, 19, 255, 255, 255, 255, 13, 10, 255, 16
+};
+
+// parse YAML key and find it by perfect hash (without copying key)
+static size_t parseYAMLKeyFast(const char*& ptr, const char* end, size_t lineNo)
+{
+    const char* keyPtr = ptr;
+    uint32_t hash = 0;
+    while (ptr != end && (isAlnum(*ptr) || *ptr=='_'))
+        hash = hash*11 + cxbyte(*ptr++);
+    if (keyPtr == end)
+        throw ParseException(lineNo, "Expected key name");
+    const size_t keyLen = ptr - keyPtr;
+    skipSpacesToLineEnd(ptr, end);
+    if (ptr == end || *ptr!=':')
+        throw ParseException(lineNo, "Expected colon");
+    ptr++;
+    const char* afterColon = ptr;
+    skipSpacesToLineEnd(ptr, end);
+    if (afterColon == ptr && ptr != end && *ptr!='\n')
+        // only if not immediate newline
+        throw ParseException(lineNo, "After key and colon must be space");
+    const cxbyte index = rocmMetadataKeysHashTable[(hash ^ (hash>>23)) & 127];
+    if (index != 0xff && ::strncmp(rocmMetadataKeys[index], keyPtr, keyLen)==0 &&
+        rocmMetadataKeys[index][keyLen]==0)
+        return index;
+    return rocmMetadataKeysNum;
+}
+
+// parse YAML string value as view (single value, block strings accepted)
+static ROCmStringView parseYAMLStringView(const char*& ptr, const char* end,
+            size_t& lineNo, cxuint prevIndent)
+{
+    skipSpacesToLineEnd(ptr, end);
+    ROCmStringView view{ ptr, 0, prevIndent, ROCMSTRVIEW_PLAIN };
+    if (ptr == end)
+        return view;
+    if (*ptr=='"' || *ptr== '\'')
+    {
+        const char termChar = *ptr;
+        const char* strPtr = ptr+1;
+        size_t newLines = 0;
+        while (strPtr != end && *strPtr != termChar && *strPtr != '\\')
+            if (*strPtr++ == '\n')
+                newLines++;
+        if (strPtr != end && *strPtr == termChar)
+        {
+            // string without escapes
+            view.ptr = ptr+1;
+            view.size = strPtr - ptr - 1;
+            ptr = strPtr+1;
+            lineNo += newLines;
+        }
+        else
+        {
+            // check string with escapes (or unterminated) by regular parser
+            const char* strStart = ptr;
+            parseYAMLString(ptr, end, lineNo);
+            view.size = ptr - strStart;
+            view.kind = ROCMSTRVIEW_QUOTED;
+        }
+    }
+    else if (*ptr == '|' || *ptr == '>')
+    {
+        // block strings are rare, check it by regular parser
+        const char* strStart = ptr;
+        parseYAMLStringValue(ptr, end, lineNo, prevIndent, true, true);
+        view.size = ptr - strStart;
+        view.kind = ROCMSTRVIEW_BLOCK;
+        return view;
+    }
+    else
+    {
+        // single line string (unquoted)
+        const char* strStart = ptr;
+        // automatically trim spaces at ends
+        const char* strEnd = ptr;
+        while (ptr != end && *ptr!='\n' && *ptr!='#')
+        {
+            if (!isSpace(*ptr))
+                strEnd = ptr; // to trim at end
+            ptr++;
+        }
+        if (strEnd != end && !isSpace(*strEnd))
+            strEnd++;
+        view.size = strEnd - strStart;
+    }
+    
+    skipSpacesToNextLine(ptr, end, lineNo);
+    return view;
+}
+
+// get trimmed text of string view (decode to buffer only if needed)
+static void getYAMLStringViewText(const ROCmStringView& view, std::string& buf,
+            const char*& text, size_t& textLen)
+{
+    if (view.kind != ROCMSTRVIEW_PLAIN)
+    {
+        buf = trimStrSpaces(view.toCString().c_str());
+        text = buf.c_str();
+        textLen = buf.size();
+        return;
+    }
+    text = view.ptr;
+    const char* textEnd = view.ptr + view.size;
+    while (text != textEnd && isSpace(*text)) text++;
+    while (textEnd != text && isSpace(textEnd[-1])) textEnd--;
+    textLen = textEnd - text;
+}
+
+static inline bool equalNameText(const char* name, const char* text, size_t textLen)
+{
+    return ::strncmp(name, text, textLen)==0 && name[textLen]==0;
+}
+
+static void parseROCmMetadataView(size_t metadataSize, const char* metadata,
+                ROCmMetadataView& metadataView)
+{
+    const char* ptr = metadata;
+    const char* end = metadata + metadataSize;
+    size_t lineNo = 1;
+    // init metadata view object
+    metadataView.kernels.clear();
+    metadataView.argInfos.clear();
+    metadataView.printfInfos.clear();
+    metadataView.version[0] = metadataView.version[1] = 0;
+    
+    std::vector<ROCmKernelMetadataView>& kernels = metadataView.kernels;
+    std::vector<ROCmKernelArgInfoView>& argInfos = metadataView.argInfos;
+    
+    cxuint levels[6] = { UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX, UINT_MAX };
+    cxuint curLevel = 0;
+    bool inKernels = false;
+    bool inKernel = false;
+    bool inKernelArgs = false;
+    bool inKernelArg = false;
+    bool inKernelCodeProps = false;
+    bool inKernelAttrs = false;
+    bool canToNextLevel = false;
+    // buffer for decoded (escaped) enumeration values
+    std::string textBuf;
+    
+    size_t oldLineNo = 0;
+    while (ptr != end)
+    {
+        cxuint level = skipSpacesAndComments(ptr, end, lineNo);
+        if (ptr == end || lineNo == oldLineNo)
+            throw ParseException(lineNo, "Expected new line");
+        
+        if (levels[curLevel] == UINT_MAX)
+            levels[curLevel] = level;
+        else if (levels[curLevel] < level)
+        {
+            if (canToNextLevel)
+                // go to next nesting level
+                levels[++curLevel] = level;
+            else
+                throw ParseException(lineNo, "Unexpected nesting level");
+            canToNextLevel = false;
+        }
+        else if (levels[curLevel] > level)
+        {
+            while (curLevel != UINT_MAX && levels[curLevel] > level)
+                curLevel--;
+            if (curLevel == UINT_MAX)
+                throw ParseException(lineNo, "Indentation smaller than in main level");
+            
+            // pop from previous level
+            if (curLevel < 3)
+            {
+                if (inKernelArgs)
+                {
+                    // leave from kernel args
+                    inKernelArgs = false;
+                    inKernelArg = false;
+                }
+            
+                inKernelCodeProps = false;
+                inKernelAttrs = false;
+            }
+            if (curLevel < 1 && inKernels)
+            {
+                // leave from kernels
+                inKernels = false;
+                inKernel = false;
+            }
+            
+            if (levels[curLevel] != level)
+                throw ParseException(lineNo, "Unexpected nesting level");
+        }
+        
+        oldLineNo = lineNo;
+        if (curLevel == 0)
+        {
+            if (lineNo==1 && ptr+3 <= end && *ptr=='-' && ptr[1]=='-' && ptr[2]=='-' &&
+                (ptr+3==end || (ptr+3 < end && ptr[3]=='\n')))
+            {
+                ptr += 3;
+                if (ptr!=end)
+                {
+                    lineNo++;
+                    ptr++; // to newline
+                }
+                continue; // skip document start
+            }
+            
+            if (ptr+3 <= end && *ptr=='.' && ptr[1]=='.' && ptr[2]=='.' &&
+                (ptr+3==end || (ptr+3 < end && ptr[3]=='\n')))
+                break; // end of the document
+            
+            switch(parseYAMLKeyFast(ptr, end, lineNo))
+            {
+                case ROCMMTK_KERNELS:
+                    inKernels = true;
+                    canToNextLevel = true;
+                    break;
+                case ROCMMTK_PRINTF:
+                {
+                    YAMLPrintfVectorConsumer consumer(metadataView.printfInfos);
+                    parseYAMLValArray(ptr, end, lineNo, levels[curLevel], &consumer, true);
+                    break;
+                }
+                case ROCMMTK_VERSION:
+                {
+                    YAMLIntArrayConsumer<uint32_t> consumer(2, metadataView.version);
+                    parseYAMLValArray(ptr, end, lineNo, levels[curLevel], &consumer, true);
+                    break;
+                }
+                default:
+                    skipYAMLValue(ptr, end, lineNo, level);
+                    break;
+            }
+        }
+        
+        if (curLevel==1 && inKernels)
+        {
+            // enter to kernel level
+            if (ptr == end || *ptr != '-')
+                throw ParseException(lineNo, "No '-' before kernel object");
+            ptr++;
+            const char* afterMinus = ptr;
+            skipSpacesToLineEnd(ptr, end);
+            levels[++curLevel] = level + 1 + ptr-afterMinus;
+            level = levels[curLevel];
+            inKernel = true;
+            
+            kernels.push_back(ROCmKernelMetadataView());
+            kernels.back().initialize();
+        }
+        
+        if (curLevel==2 && inKernel)
+        {
+            // in kernel
+            ROCmKernelMetadataView& kernel = kernels.back();
+            switch(parseYAMLKeyFast(ptr, end, lineNo))
+            {
+                case ROCMMTK_ARGS:
+                    inKernelArgs = true;
+                    canToNextLevel = true;
+                    // arguments of current kernel are always at end
+                    kernel.argInfosStart = argInfos.size();
+                    kernel.argInfosNum = 0;
+                    break;
+                case ROCMMTK_ATTRS:
+                    inKernelAttrs = true;
+                    canToNextLevel = true;
+                    // initialize kernel attributes values
+                    kernel.reqdWorkGroupSize[0] = 0;
+                    kernel.reqdWorkGroupSize[1] = 0;
+                    kernel.reqdWorkGroupSize[2] = 0;
+                    kernel.workGroupSizeHint[0] = 0;
+                    kernel.workGroupSizeHint[1] = 0;
+                    kernel.workGroupSizeHint[2] = 0;
+                    kernel.runtimeHandle = ROCmStringView{};
+                    kernel.vecTypeHint = ROCmStringView{};
+                    break;
+                case ROCMMTK_CODEPROPS:
+                    // initialize CodeProps values
+                    kernel.kernargSegmentSize = BINGEN64_DEFAULT;
+                    kernel.groupSegmentFixedSize = BINGEN64_DEFAULT;
+                    kernel.privateSegmentFixedSize = BINGEN64_DEFAULT;
+                    kernel.kernargSegmentAlign = BINGEN64_DEFAULT;
+                    kernel.wavefrontSize = BINGEN_DEFAULT;
+                    kernel.sgprsNum = BINGEN_DEFAULT;
+                    kernel.vgprsNum = BINGEN_DEFAULT;
+                    kernel.spilledSgprs = BINGEN_NOTSUPPLIED;
+                    kernel.spilledVgprs = BINGEN_NOTSUPPLIED;
+                    kernel.maxFlatWorkGroupSize = BINGEN64_DEFAULT;
+                    kernel.fixedWorkGroupSize[0] = 0;
+                    kernel.fixedWorkGroupSize[1] = 0;
+                    kernel.fixedWorkGroupSize[2] = 0;
+                    inKernelCodeProps = true;
+                    canToNextLevel = true;
+                    break;
+                case ROCMMTK_LANGUAGE:
+                    kernel.language = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                case ROCMMTK_LANGUAGE_VERSION:
+                {
+                    YAMLIntArrayConsumer<uint32_t> consumer(2, kernel.langVersion);
+                    parseYAMLValArray(ptr, end, lineNo, levels[curLevel], &consumer);
+                    break;
+                }
+                case ROCMMTK_NAME:
+                    kernel.name = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                case ROCMMTK_SYMBOLNAME:
+                    kernel.symbolName = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                default:
+                    skipYAMLValue(ptr, end, lineNo, level);
+                    break;
+            }
+        }
+        
+        if (curLevel==3 && inKernelAttrs)
+        {
+            // in kernel attributes
+            ROCmKernelMetadataView& kernel = kernels.back();
+            switch(parseYAMLKeyFast(ptr, end, lineNo))
+            {
+                case ROCMMTK_REQD_WORK_GROUP_SIZE:
+                {
+                    YAMLIntArrayConsumer<cxuint> consumer(3, kernel.reqdWorkGroupSize);
+                    parseYAMLValArray(ptr, end, lineNo, level, &consumer);
+                    break;
+                }
+                case ROCMMTK_RUNTIME_HANDLE:
+                    kernel.runtimeHandle = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                case ROCMMTK_VECTYPEHINT:
+                    kernel.vecTypeHint = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                case ROCMMTK_WORK_GROUP_SIZE_HINT:
+                {
+                    YAMLIntArrayConsumer<cxuint> consumer(3, kernel.workGroupSizeHint);
+                    parseYAMLValArray(ptr, end, lineNo, level, &consumer, true);
+                    break;
+                }
+                default:
+                    skipYAMLValue(ptr, end, lineNo, level);
+                    break;
+            }
+        }
+        
+        if (curLevel==3 && inKernelCodeProps)
+        {
+            // in kernel codeProps
+            ROCmKernelMetadataView& kernel = kernels.back();
+            switch(parseYAMLKeyFast(ptr, end, lineNo))
+            {
+                case ROCMMTK_FIXED_WORK_GROUP_SIZE:
+                {
+                    YAMLIntArrayConsumer<cxuint> consumer(3, kernel.fixedWorkGroupSize);
+                    parseYAMLValArray(ptr, end, lineNo, level, &consumer);
+                    break;
+                }
+                case ROCMMTK_GROUP_SEGMENT_FIXED_SIZE:
+                    kernel.groupSegmentFixedSize =
+                                parseYAMLIntValue<cxuint>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_KERNARG_SEGMENT_ALIGN:
+                    kernel.kernargSegmentAlign =
+                                parseYAMLIntValue<uint64_t>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_KERNARG_SEGMENT_SIZE:
+                    kernel.kernargSegmentSize =
+                                parseYAMLIntValue<uint64_t>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_MAX_FLAT_WORK_GROUP_SIZE:
+                    kernel.maxFlatWorkGroupSize =
+                                parseYAMLIntValue<uint64_t>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_NUM_SGPRS:
+                    kernel.sgprsNum = parseYAMLIntValue<cxuint>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_NUM_SPILLED_SGPRS:
+                    kernel.spilledSgprs =
+                            parseYAMLIntValue<cxuint>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_NUM_SPILLED_VGPRS:
+                    kernel.spilledVgprs =
+                            parseYAMLIntValue<cxuint>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_NUM_VGPRS:
+                    kernel.vgprsNum = parseYAMLIntValue<cxuint>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_PRIVATE_SEGMENT_FIXED_SIZE:
+                    kernel.privateSegmentFixedSize =
+                                parseYAMLIntValue<uint64_t>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_WAVEFRONT_SIZE:
+                    kernel.wavefrontSize =
+                            parseYAMLIntValue<cxuint>(ptr, end, lineNo, true);
+                    break;
+                default:
+                    skipYAMLValue(ptr, end, lineNo, level);
+                    break;
+            }
+        }
+        
+        if (curLevel==3 && inKernelArgs)
+        {
+            // enter to kernel argument level
+            if (ptr == end || *ptr != '-')
+                throw ParseException(lineNo, "No '-' before argument object");
+            ptr++;
+            const char* afterMinus = ptr;
+            skipSpacesToLineEnd(ptr, end);
+            levels[++curLevel] = level + 1 + ptr-afterMinus;
+            level = levels[curLevel];
+            inKernelArg = true;
+            
+            argInfos.push_back(ROCmKernelArgInfoView{});
+            kernels.back().argInfosNum++;
+        }
+        
+        if (curLevel==4 && inKernelArg)
+        {
+            // in kernel argument
+            const size_t keyIndex = parseYAMLKeyFast(ptr, end, lineNo);
+            ROCmKernelArgInfoView& kernelArg = argInfos.back();
+            
+            size_t valLineNo = lineNo;
+            const char* text;
+            size_t textLen;
+            switch(keyIndex)
+            {
+                case ROCMMTK_ACCQUAL:
+                case ROCMMTK_ACTUALACCQUAL:
+                {
+                    getYAMLStringViewText(parseYAMLStringView(ptr, end, lineNo, level),
+                                textBuf, text, textLen);
+                    size_t accIndex = 0;
+                    for (; accIndex < 4; accIndex++)
+                        if (equalNameText(rocmAccessQualifierTbl[accIndex], text, textLen))
+                            break;
+                    if (accIndex == 4)
+                        throw ParseException(lineNo, "Wrong access qualifier");
+                    if (keyIndex == ROCMMTK_ACCQUAL)
+                        kernelArg.accessQual = ROCmAccessQual(accIndex);
+                    else
+                        kernelArg.actualAccessQual = ROCmAccessQual(accIndex);
+                    break;
+                }
+                case ROCMMTK_ADDRSPACEQUAL:
+                {
+                    getYAMLStringViewText(parseYAMLStringView(ptr, end, lineNo, level),
+                                textBuf, text, textLen);
+                    size_t aspaceIndex = 0;
+                    for (; aspaceIndex < 6; aspaceIndex++)
+                        if (equalNameText(rocmAddrSpaceTypesTbl[aspaceIndex],
+                                    text, textLen))
+                            break;
+                    if (aspaceIndex == 6)
+                        throw ParseException(valLineNo, "Wrong address space");
+                    kernelArg.addressSpace = ROCmAddressSpace(aspaceIndex+1);
+                    break;
+                }
+                case ROCMMTK_ALIGN:
+                    kernelArg.align = parseYAMLIntValue<uint64_t>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_ISCONST:
+                    kernelArg.isConst = parseYAMLBoolValue(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_ISPIPE:
+                    kernelArg.isPipe = parseYAMLBoolValue(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_ISRESTRICT:
+                    kernelArg.isRestrict = parseYAMLBoolValue(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_ISVOLATILE:
+                    kernelArg.isVolatile = parseYAMLBoolValue(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_NAME:
+                    kernelArg.name = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                case ROCMMTK_POINTEE_ALIGN:
+                    kernelArg.pointeeAlign =
+                                parseYAMLIntValue<uint64_t>(ptr, end, lineNo, true);
+                    break;
+                case ROCMMTK_SIZE:
+                    kernelArg.size = parseYAMLIntValue<uint64_t>(ptr, end, lineNo);
+                    break;
+                case ROCMMTK_TYPENAME:
+                    kernelArg.typeName = parseYAMLStringView(ptr, end, lineNo, level);
+                    break;
+                case ROCMMTK_VALUEKIND:
+                {
+                    getYAMLStringViewText(parseYAMLStringView(ptr, end, lineNo, level),
+                                textBuf, text, textLen);
+                    size_t vkindIndex = 0;
+                    for (; vkindIndex < rocmValueKindNamesNum; vkindIndex++)
+                        if (equalNameText(rocmValueKindNamesMap[vkindIndex].first,
+                                    text, textLen))
+                            break;
+                    // if unknown kind
+                    if (vkindIndex == rocmValueKindNamesNum)
+                        throw ParseException(valLineNo, "Wrong argument value kind");
+                    kernelArg.valueKind = rocmValueKindNamesMap[vkindIndex].second;
+                    break;
+                }
+                case ROCMMTK_VALUETYPE:
+                {
+                    getYAMLStringViewText(parseYAMLStringView(ptr, end, lineNo, level),
+                                textBuf, text, textLen);
+                    size_t vtypeIndex = 0;
+                    for (; vtypeIndex < rocmValueTypeNamesNum; vtypeIndex++)
+                        if (equalNameText(rocmValueTypeNamesMap[vtypeIndex].first,
+                                    text, textLen))
+                            break;
+                    // if unknown type
+                    if (vtypeIndex == rocmValueTypeNamesNum)
+                        throw ParseException(valLineNo, "Wrong argument value type");
+                    kernelArg.valueType = rocmValueTypeNamesMap[vtypeIndex].second;
+                    break;
+                }
+                default:
+                    skipYAMLValue(ptr, end, lineNo, level);
+                    break;
+            }
+        }
+    }
+}
+
+void ROCmMetadataView::parse(size_t metadataSize, const char* metadata)
+{
+    parseROCmMetadataView(metadataSize, metadata, *this);
+}
+
+void ROCmMetadataView::getKernelMetadata(size_t index, ROCmKernelMetadata& kernel) const
+{
+    const ROCmKernelMetadataView& kview = kernels[index];
+    kernel.name = kview.name.toCString();
+    kernel.symbolName = kview.symbolName.toCString();
+    kernel.argInfos.resize(kview.argInfosNum);
+    for (size_t i = 0; i < kview.argInfosNum; i++)
+    {
+        const ROCmKernelArgInfoView& aview = argInfos[kview.argInfosStart + i];
+        ROCmKernelArgInfo& argInfo = kernel.argInfos[i];
+        argInfo.name = aview.name.toCString();
+        argInfo.typeName = aview.typeName.toCString();
+        argInfo.size = aview.size;
+        argInfo.align = aview.align;
+        argInfo.pointeeAlign = aview.pointeeAlign;
+        argInfo.valueKind = aview.valueKind;
+        argInfo.valueType = aview.valueType;
+        argInfo.addressSpace = aview.addressSpace;
+        argInfo.accessQual = aview.accessQual;
+        argInfo.actualAccessQual = aview.actualAccessQual;
+        argInfo.isConst = aview.isConst;
+        argInfo.isRestrict = aview.isRestrict;
+        argInfo.isVolatile = aview.isVolatile;
+        argInfo.isPipe = aview.isPipe;
+    }
+    kernel.language = kview.language.toCString();
+    std::copy(kview.langVersion, kview.langVersion+2, kernel.langVersion);
+    std::copy(kview.reqdWorkGroupSize, kview.reqdWorkGroupSize+3,
+              kernel.reqdWorkGroupSize);
+    std::copy(kview.workGroupSizeHint, kview.workGroupSizeHint+3,
+              kernel.workGroupSizeHint);
+    kernel.vecTypeHint = kview.vecTypeHint.toCString();
+    kernel.runtimeHandle = kview.runtimeHandle.toCString();
+    kernel.kernargSegmentSize = kview.kernargSegmentSize;
+    kernel.groupSegmentFixedSize = kview.groupSegmentFixedSize;
+    kernel.privateSegmentFixedSize = kview.privateSegmentFixedSize;
+    kernel.kernargSegmentAlign = kview.kernargSegmentAlign;
+    kernel.wavefrontSize = kview.wavefrontSize;
+    kernel.sgprsNum = kview.sgprsNum;
+    kernel.vgprsNum = kview.vgprsNum;
+    kernel.maxFlatWorkGroupSize = kview.maxFlatWorkGroupSize;
+    std::copy(kview.fixedWorkGroupSize, kview.fixedWorkGroupSize+3,
+              kernel.fixedWorkGroupSize);
+    kernel.spilledSgprs = kview.spilledSgprs;
+    kernel.spilledVgprs = kview.spilledVgprs;
+}
+
+void ROCmMetadataView::toMetadata(ROCmMetadata& metadata) const
+{
+    metadata.version[0] = version[0];
+    metadata.version[1] = version[1];
+    metadata.printfInfos = printfInfos;
+    metadata.kernels.resize(kernels.size());
+    for (size_t i = 0; i < kernels.size(); i++)
+        getKernelMetadata(i, metadata.kernels[i]);
+}
+
 /*
  * ROCm binary reader and generator
  */
@@ -1242,11 +1914,7 @@ ROCmBinary::ROCmBinary(size_t binaryCodeSize, cxbyte* binaryCode, Flags creation
           globalDataSize(0), globalData(nullptr), metadataSize(0), metadata(nullptr),
           newBinFormat(false)
 {
-    cxuint textIndex = SHN_UNDEF;
-    try
-    { textIndex = getSectionIndex(".text"); }
-    catch(const Exception& ex)
-    { } // ignore failed
+    cxuint textIndex = findSectionIndex(".text");
     uint64_t codeOffset = 0;
     // find '.text' section
     if (textIndex!=SHN_UNDEF)
@@ -1257,11 +1925,7 @@ ROCmBinary::ROCmBinary(size_t binaryCodeSize, cxbyte* binaryCode, Flags creation
         codeOffset = ULEV(textShdr.sh_offset);
     }
     
-    cxuint rodataIndex = SHN_UNDEF;
-    try
-    { rodataIndex = getSectionIndex(".rodata"); }
-    catch(const Exception& ex)
-    { } // ignore failed
+    cxuint rodataIndex = findSectionIndex(".rodata");
     // find '.text' section
     if (rodataIndex!=SHN_UNDEF)
     {
@@ -1270,11 +1934,7 @@ ROCmBinary::ROCmBinary(size_t binaryCodeSize, cxbyte* binaryCode, Flags creation
         globalDataSize = ULEV(rodataShdr.sh_size);
     }
     
-    cxuint gpuConfigIndex = SHN_UNDEF;
-    try
-    { gpuConfigIndex = getSectionIndex(".AMDGPU.config"); }
-    catch(const Exception& ex)
-    { } // ignore failed
+    cxuint gpuConfigIndex = findSectionIndex(".AMDGPU.config");
     newBinFormat = (gpuConfigIndex == SHN_UNDEF);
     
     // counts regions (symbol or kernel)
@@ -1384,11 +2044,20 @@ ROCmBinary::ROCmBinary(size_t binaryCodeSize, cxbyte* binaryCode, Flags creation
         mapSort(regionsMap.begin(), regionsMap.end());
     }
     
-    if ((creationFlags & ROCMBIN_CREATE_METADATAINFO) != 0 &&
-        metadata != nullptr && metadataSize != 0)
+    if ((creationFlags & (ROCMBIN_CREATE_METADATAINFO|
+            ROCMBIN_CREATE_METADATAVIEW)) != 0 && metadata != nullptr && metadataSize != 0)
+    {
+        // metadata info is created from metadata view (single parsing)
+        metadataView.reset(new ROCmMetadataView());
+        parseROCmMetadataView(metadataSize, metadata, *metadataView);
+    }
+    
+    if ((creationFlags & ROCMBIN_CREATE_METADATAINFO) != 0 && metadataView)
     {
         metadataInfo.reset(new ROCmMetadata());
-        parseROCmMetadata(metadataSize, metadata, *metadataInfo);
+        metadataView->toMetadata(*metadataInfo);
+        if ((creationFlags & ROCMBIN_CREATE_METADATAVIEW) == 0)
+            metadataView.reset();
         
         if (hasKernelInfoMap())
         {
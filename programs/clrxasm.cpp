@@ -57,6 +57,12 @@ static const CLIOption programOptions[] =
         "use old and buggy fplit rules", nullptr },
     { "oldModParam", 0, CLIArgType::NONE, false, false,
         "use old modifier parametrization", nullptr },
+    { "schedule", 0, CLIArgType::NONE, false, false,
+        "schedule instructions in code blocks and print report", nullptr },
+    { "timeReport", 0, CLIArgType::NONE, false, false,
+        "print times of assembler phases and counters", nullptr },
+    { "timeReportJSON", 0, CLIArgType::NONE, false, false,
+        "print times of assembler phases and counters in JSON form", nullptr },
     { "noMacroCase", 'm', CLIArgType::NONE, false, false,
         "do not ignore letter's case in macro names", nullptr },
     { "noWarnings", 'w', CLIArgType::NONE, false, false, "disable warnings", nullptr },
@@ -130,6 +136,10 @@ try
         flags |= ASM_MACRONOCASE;
     if (cli.hasLongOption("oldModParam"))
         flags |= ASM_OLDMODPARAM;
+    if (cli.hasLongOption("schedule"))
+        flags |= ASM_SCHEDULE;
+    if (cli.hasLongOption("timeReport") || cli.hasLongOption("timeReportJSON"))
+        flags |= ASM_TIMEREPORT;
     
     cxuint argsNum = cli.getArgsNum();
     Array<CString> filenames(argsNum);
@@ -206,11 +216,39 @@ try
     /// run assembling
     if (!assembler->assemble())
         return 1;
+    if (cli.hasLongOption("schedule"))
+    {
+        // print scheduling report
+        for (const AsmScheduleStats& stats: assembler->getScheduleStats())
+        {
+            const AsmSection& section = assembler->getSections()[stats.sectionId];
+            std::cout << "Section ";
+            if (section.name != nullptr)
+                std::cout << section.name;
+            else // unnamed section (default section of some formats)
+                std::cout << stats.sectionId;
+            if (section.kernelId != ASMKERN_GLOBAL)
+                std::cout << " (kernel " <<
+                        assembler->getKernels()[section.kernelId].name << ")";
+            std::cout << ": scheduled " << stats.scheduledBlocksNum << " of " <<
+                    stats.blocksNum << " blocks, moved " << stats.movedInstrsNum <<
+                    " of " << stats.instrsNum << " instructions, estimated stall cycles " <<
+                    stats.stallCyclesBefore << " -> " << stats.stallCyclesAfter <<
+                    " (removed " << (stats.stallCyclesBefore - stats.stallCyclesAfter) <<
+                    ")\n";
+        }
+        std::cout.flush();
+    }
     /// write output to file
     const char* outputName = "a.out";
     if (cli.hasShortOption('o'))
         outputName = cli.getShortOptArg<const char*>('o');
     assembler->writeBinary(outputName);
+    // print time report
+    if (cli.hasLongOption("timeReport"))
+        assembler->printTimeReport(std::cout);
+    if (cli.hasLongOption("timeReportJSON"))
+        assembler->printTimeReportJSON(std::cout);
     return 0;
 }
 catch(const Exception& ex)
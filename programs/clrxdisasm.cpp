@@ -18,8 +18,11 @@
  */
 
 #include <CLRX/Config.h>
+#include <cstdio>
 #include <iostream>
+#include <string>
 #include <memory>
+#include <utility>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/CLIParser.h>
 #include <CLRX/amdbin/AmdBinaries.h>
@@ -54,10 +57,53 @@ static const CLIOption programOptions[] =
         "set LLVM version (for Gallium)", "VERSION" },
     { "buggyFPLit", 0, CLIArgType::NONE, false, false,
         "use old and buggy fplit rules", nullptr },
+    { "threads", 'j', CLIArgType::UINT, false, false,
+        "disassemble kernels in parallel (0 - all hardware threads)", "THREADS" },
+    { "json", 'J', CLIArgType::NONE, false, false,
+        "write JSON Lines records (kernels, config, instructions)", nullptr },
     CLRX_CLI_AUTOHELP
     { nullptr, 0 }
 };
 
+// append JSON string (with quotes) to line
+static void appendJSONString(std::string& line, const char* str)
+{
+    line.push_back('"');
+    for (; *str != 0; str++)
+    {
+        const unsigned char c = *str;
+        if (c == '"' || c == '\\')
+            line.push_back('\\');
+        if (c >= 0x20)
+            line.push_back(c);
+        else
+        {
+            // control characters
+            char buf[8];
+            snprintf(buf, 8, "\\u%04x", c);
+            line += buf;
+        }
+    }
+    line.push_back('"');
+}
+
+// write JSON record with file name (and error message if not null)
+static void writeJSONFileRecord(const char* type, const char* filename,
+            const char* message = nullptr)
+{
+    std::string line = "{\"type\":";
+    appendJSONString(line, type);
+    line += ",\"name\":";
+    appendJSONString(line, filename);
+    if (message != nullptr)
+    {
+        line += ",\"message\":";
+        appendJSONString(line, message);
+    }
+    line += "}\n";
+    std::cout.write(line.c_str(), line.size());
+}
+
 int main(int argc, const char** argv)
 try
 {
@@ -85,6 +131,9 @@ try
      disasmFlags |= (cli.hasShortOption('C')?DISASM_CONFIG:0) |
              (cli.hasLongOption("buggyFPLit")?DISASM_BUGGYFPLIT:0) |
              (cli.hasShortOption('H')?DISASM_HSACONFIG:0);
+    const bool jsonOutput = cli.hasShortOption('J');
+    if (jsonOutput)
+        disasmFlags |= DISASM_JSON;
     
     GPUDeviceType gpuDeviceType = GPUDeviceType::CAPE_VERDE;
     const bool fromRawCode = cli.hasShortOption('r');
@@ -100,16 +149,29 @@ try
     cxuint llvmVersion = 0;
     if (cli.hasLongOption("llvmVersion"))
         llvmVersion = cli.getLongOptArg<cxuint>("llvmVersion");
+    cxuint threadsNum = 1;
+    if (cli.hasShortOption('j'))
+        threadsNum = cli.getShortOptArg<cxuint>('j');
     
     int ret = 0;
     for (const char* const* args = cli.getArgs();*args != nullptr; args++)
     {
-        std::cout << "/* Disassembling '" << *args << "\' */" << std::endl;
+        if (jsonOutput)
+            writeJSONFileRecord("file", *args);
+        else
+            std::cout << "/* Disassembling '" << *args << "\' */" << std::endl;
         Array<cxbyte> binaryData;
+        MappedFile mappedFile;
         std::unique_ptr<AmdMainBinaryBase> base = nullptr;
         try
         {
-            binaryData = loadDataFromFile(*args);
+            // map regular files to memory, read other files (pipes, devices)
+            // binary parsers take mutable pointer (copy-on-write mapping),
+            // raw code is only read (read-only mapping)
+            const std::pair<cxbyte*, size_t> binaryPair = loadDataFromFile(*args,
+                        mappedFile, binaryData, !fromRawCode);
+            cxbyte* binaryCode = binaryPair.first;
+            const size_t binarySize = binaryPair.second;
             
             if (!fromRawCode)
             {
@@ -119,21 +181,23 @@ try
                         AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
                         AMDBIN_CREATE_KERNELHEADERMAP;
                 // supply additional flags for CALNotes and info strings
-                if ((disasmFlags & (DISASM_CALNOTES|DISASM_CONFIG)) != 0)
+                if ((disasmFlags & (DISASM_CALNOTES|DISASM_CONFIG|DISASM_JSON)) != 0)
                     binFlags |= AMDBIN_INNER_CREATE_CALNOTES;
-                if ((disasmFlags & (DISASM_METADATA|DISASM_CONFIG)) != 0)
+                if ((disasmFlags & (DISASM_METADATA|DISASM_CONFIG|DISASM_JSON)) != 0)
                     binFlags |= AMDBIN_CREATE_INFOSTRINGS;
                 
-                if (isAmdBinary(binaryData.size(), binaryData.data()))
+                if (isAmdBinary(binarySize, binaryCode))
                 {
                     // if amd binary
-                    base.reset(createAmdBinaryFromCode(binaryData.size(),
-                            binaryData.data(), binFlags));
+                    base.reset(createAmdBinaryFromCode(binarySize,
+                            binaryCode, binFlags));
+                    base->setMappedFile(std::move(mappedFile));
                     if (base->getType() == AmdMainType::GPU_BINARY)
                     {
                         AmdMainGPUBinary32* amdGpuBin =
                                 static_cast<AmdMainGPUBinary32*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else if (base->getType() == AmdMainType::GPU_64_BINARY)
@@ -141,25 +205,28 @@ try
                         AmdMainGPUBinary64* amdGpuBin =
                                 static_cast<AmdMainGPUBinary64*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else
                         throw Exception("This is not AMDGPU binary file!");
                 }
-                else if (isAmdCL2Binary(binaryData.size(), binaryData.data()))
+                else if (isAmdCL2Binary(binarySize, binaryCode))
                 {   // AMD OpenCL 2.0 binary
                     // extra (extra data) flags for OpenCL 2.0 disassembler
                     binFlags |= AMDCL2BIN_INNER_CREATE_KERNELDATA |
                                 AMDCL2BIN_INNER_CREATE_KERNELDATAMAP |
                                 AMDCL2BIN_INNER_CREATE_KERNELSTUBS;
-                    base.reset(createAmdCL2BinaryFromCode(binaryData.size(),
-                                           binaryData.data(), binFlags));
+                    base.reset(createAmdCL2BinaryFromCode(binarySize,
+                                           binaryCode, binFlags));
+                    base->setMappedFile(std::move(mappedFile));
                     if (base->getType() == AmdMainType::GPU_CL2_BINARY)
                     {
                         AmdCL2MainGPUBinary32* amdGpuBin =
                                 static_cast<AmdCL2MainGPUBinary32*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags,
                                             driverVersion);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else if (base->getType() == AmdMainType::GPU_CL2_64_BINARY)
@@ -168,39 +235,48 @@ try
                                 static_cast<AmdCL2MainGPUBinary64*>(base.get());
                         Disassembler disasm(*amdGpuBin, std::cout, disasmFlags,
                                             driverVersion);
+                        disasm.setThreadsNum(threadsNum);
                         disasm.disassemble();
                     }
                     else
                         throw Exception("This is not AMDGPU binary file!");
                 }
-                else if (isROCmBinary(binaryData.size(), binaryData.data()))
+                else if (isROCmBinary(binarySize, binaryCode))
                 {
                     // ROCm binary
-                    ROCmBinary rocmBin(binaryData.size(), binaryData.data(), 0);
+                    ROCmBinary rocmBin(binarySize, binaryCode, 0);
+                    rocmBin.setMappedFile(std::move(mappedFile));
                     Disassembler disasm(rocmBin, std::cout, disasmFlags);
+                    disasm.setThreadsNum(threadsNum);
                     disasm.disassemble();
                 }
                 else
                 {
                     // if gallium binary
-                    GalliumBinary galliumBin(binaryData.size(),binaryData.data(), 0);
+                    GalliumBinary galliumBin(binarySize, binaryCode, 0);
+                    galliumBin.setMappedFile(std::move(mappedFile));
                     Disassembler disasm(gpuDeviceType, galliumBin, std::cout,
                             disasmFlags, llvmVersion);
+                    disasm.setThreadsNum(threadsNum);
                     disasm.disassemble();
                 }
             }
             else
             {
                 /* raw binaries */
-                Disassembler disasm(gpuDeviceType, binaryData.size(), binaryData.data(),
+                Disassembler disasm(gpuDeviceType, binarySize, binaryCode,
                         std::cout, disasmFlags);
+                disasm.setThreadsNum(threadsNum);
                 disasm.disassemble();
             }
         }
         catch(const std::exception& ex)
         {
             ret = 1;
-            std::cout << "/* ERROR for '" << *args << "\' */" << std::endl;
+            if (jsonOutput)
+                writeJSONFileRecord("error", *args, ex.what());
+            else
+                std::cout << "/* ERROR for '" << *args << "\' */" << std::endl;
             std::cerr << "Error during disassemblying '" << *args << "': " <<
                     ex.what() << std::endl;
         }
@@ -0,0 +1,529 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <CLRX/Config.h>
+#include <cstdio>
+#include <cstring>
+#include <inttypes.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/CLIParser.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/ROCmBinaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+
+using namespace CLRX;
+
+static const CLIOption programOptions[] =
+{
+    { "json", 'J', CLIArgType::NONE, false, false,
+        "write JSON Lines records instead of CSV", nullptr },
+    { "threads", 'j', CLIArgType::UINT, false, false,
+        "scan files in parallel (0 - all hardware threads)", "THREADS" },
+    { "gpuType", 'g', CLIArgType::TRIMMED_STRING, false, false,
+        "set GPU type for Gallium binaries", "DEVICE" },
+    { "arch", 'A', CLIArgType::TRIMMED_STRING, false, false,
+        "set GPU architecture for Gallium binaries", "ARCH" },
+    { "quiet", 'q', CLIArgType::NONE, false, false,
+        "do not print summary (files per second)", nullptr },
+    CLRX_CLI_AUTOHELP
+    { nullptr, 0 }
+};
+
+// resource summary of kernel
+struct ScanKernelInfo
+{
+    CString name;
+    cxuint sgprsNum;
+    cxuint vgprsNum;
+    uint64_t scratchSize;
+    uint64_t localSize;
+};
+
+// result of scanning single file
+struct ScanFileResult
+{
+    const char* format;     // null if file is not recognized binary
+    std::vector<ScanKernelInfo> kernels;
+    std::string error;
+};
+
+// find directories recursively and collect all regular files
+// symbolic links to directories inside scanned directories are skipped (no loops)
+static void collectFiles(const std::string& path, std::vector<std::string>& files,
+            bool inDirectory = false)
+{
+    if (inDirectory && isSymbolicLink(path.c_str()))
+    {
+        bool linkToDir = false;
+        try
+        { linkToDir = isDirectory(path.c_str()); }
+        catch(const Exception&)
+        { } // broken link, will be reported while scanning
+        if (!linkToDir)
+            files.push_back(path);
+        return;
+    }
+    if (!isDirectory(path.c_str()))
+    {
+        files.push_back(path);
+        return;
+    }
+    std::vector<std::string> names = listDirectory(path.c_str());
+    std::sort(names.begin(), names.end());
+    for (const std::string& name: names)
+        collectFiles(joinPaths(path, name), files, true);
+}
+
+// AMD OpenCL 1.2 binaries: resources from CAL notes and metadata
+static void scanAmdGPUBinary(const AmdMainGPUBinaryBase& binary,
+            std::vector<ScanKernelInfo>& kernels)
+{
+    const size_t kernelInfosNum = binary.getKernelInfosNum();
+    const size_t innerBinariesNum = binary.getInnerBinariesNum();
+    kernels.resize(kernelInfosNum);
+    for (size_t i = 0; i < kernelInfosNum; i++)
+    {
+        const KernelInfo& kernelInfo = binary.getKernelInfo(i);
+        ScanKernelInfo& kinfo = kernels[i];
+        kinfo = { kernelInfo.kernelName, 0, 0, 0, 0 };
+        // local size from metadata (memory:hwlocal:SIZE)
+        const AmdKernelMetadataView& mtView = binary.getMetadataView(i);
+        for (const AmdMetadataLine& line: mtView.lines)
+            if (line.entry && line.fieldsNum == 3 &&
+                mtView.getField(line, 0).equal("memory") &&
+                mtView.getField(line, 1).equal("hwlocal"))
+            {
+                const AmdMetadataField& field = mtView.getField(line, 2);
+                const char* outEnd;
+                kinfo.localSize = cstrtovCStyle<uint64_t>(field.ptr,
+                            field.ptr+field.size, outEnd);
+            }
+        
+        const AmdInnerGPUBinary32* innerBin = nullptr;
+        if (i < innerBinariesNum)
+            innerBin = &binary.getInnerBinary(i);
+        if (innerBin == nullptr || innerBin->getKernelName() != kernelInfo.kernelName)
+            // fallback if not in order
+            innerBin = &binary.getInnerBinary(kernelInfo.kernelName.c_str());
+        if (innerBin->getCALEncodingEntriesNum() == 0)
+            continue;
+        const uint32_t calNotesNum = innerBin->getCALNotesNum(0);
+        for (uint32_t j = 0; j < calNotesNum; j++)
+        {
+            const CALNoteHeader& cnHdr = innerBin->getCALNoteHeader(0, j);
+            const cxbyte* cnData = innerBin->getCALNoteData(0, j);
+            if (cnHdr.type == CALNOTE_ATI_SCRATCH_BUFFERS && cnHdr.descSize >= 4)
+                kinfo.scratchSize = uint64_t(
+                        ULEV(*reinterpret_cast<const uint32_t*>(cnData)))<<2;
+            else if (cnHdr.type == CALNOTE_ATI_PROGINFO)
+            {
+                const CALProgramInfoEntry* piEntry =
+                        reinterpret_cast<const CALProgramInfoEntry*>(cnData);
+                const cxuint piEntriesNum = cnHdr.descSize/sizeof(CALProgramInfoEntry);
+                for (cxuint k = 0; k < piEntriesNum; k++)
+                    if (ULEV(piEntry[k].address) == 0x80001041)
+                        kinfo.vgprsNum = ULEV(piEntry[k].value);
+                    else if (ULEV(piEntry[k].address) == 0x80001042)
+                        kinfo.sgprsNum = ULEV(piEntry[k].value);
+            }
+        }
+    }
+}
+
+// AMD OpenCL 2.0 binaries: resources from kernel setup
+static void scanAmdCL2GPUBinary(const AmdCL2MainGPUBinaryBase& binary,
+            std::vector<ScanKernelInfo>& kernels)
+{
+    const size_t kernelInfosNum = binary.getKernelInfosNum();
+    kernels.resize(kernelInfosNum);
+    for (size_t i = 0; i < kernelInfosNum; i++)
+    {
+        const KernelInfo& kernelInfo = binary.getKernelInfo(i);
+        ScanKernelInfo& kinfo = kernels[i];
+        kinfo = { kernelInfo.kernelName, 0, 0, 0, 0 };
+        if (!binary.hasInnerBinary())
+            continue;
+        const AmdCL2InnerGPUBinaryBase& innerBin = binary.getInnerBinaryBase();
+        const AmdCL2GPUKernel* kernelData = nullptr;
+        if (i < innerBin.getKernelsNum())
+            kernelData = &innerBin.getKernelData(i);
+        if (kernelData==nullptr || kernelData->kernelName != kernelInfo.kernelName)
+            kernelData = &innerBin.getKernelData(kernelInfo.kernelName.c_str());
+        if (kernelData->setup == nullptr ||
+            kernelData->setupSize < 48 + sizeof(AmdCL2SetupData))
+            continue;
+        const AmdCL2SetupData* setupData =
+                reinterpret_cast<const AmdCL2SetupData*>(kernelData->setup + 48);
+        kinfo.sgprsNum = ULEV(setupData->sgprsNum);
+        kinfo.vgprsNum = ULEV(setupData->vgprsNum);
+        kinfo.scratchSize = ULEV(setupData->scratchBufferSize);
+        kinfo.localSize = ULEV(setupData->localSize);
+    }
+}
+
+// decode granulated register counts from PGM_RSRC1
+static void decodePgmRsrc1(uint32_t value, GPUArchitecture arch, ScanKernelInfo& kinfo)
+{
+    kinfo.sgprsNum = std::min((((value>>6) & 0xf)<<3)+8,
+                getGPUMaxRegistersNum(arch, REGTYPE_SGPR, 0));
+    kinfo.vgprsNum = ((value & 0x3f)<<2)+4;
+}
+
+// ROCm binaries: resources from AMD HSA kernel configuration
+static void scanROCmBinary(const ROCmBinary& binary, std::vector<ScanKernelInfo>& kernels)
+{
+    uint32_t archMinor = 0, archStepping = 0;
+    const GPUArchitecture arch = getGPUArchitectureFromDeviceType(
+                binary.determineGPUDeviceType(archMinor, archStepping));
+    const size_t regionsNum = binary.getRegionsNum();
+    for (size_t i = 0; i < regionsNum; i++)
+    {
+        const ROCmRegion& region = binary.getRegion(i);
+        // only kernels have own resources (functions and data are skipped)
+        if (region.type != ROCmRegionType::KERNEL)
+            continue;
+        ScanKernelInfo kinfo = { region.regionName, 0, 0, 0, 0 };
+        // region offset is offset in binary
+        if (region.offset + sizeof(AmdHsaKernelConfig) <= binary.getSize())
+        {
+            const AmdHsaKernelConfig* config =
+                    reinterpret_cast<const AmdHsaKernelConfig*>(
+                        binary.getBinaryCode() + region.offset);
+            kinfo.sgprsNum = ULEV(config->wavefrontSgprCount);
+            kinfo.vgprsNum = ULEV(config->workitemVgprCount);
+            kinfo.scratchSize = ULEV(config->workitemPrivateSegmentSize);
+            kinfo.localSize = ULEV(config->workgroupGroupSegmentSize);
+            if (kinfo.sgprsNum == 0 && kinfo.vgprsNum == 0)
+                // some compilers do not fill register counts
+                decodePgmRsrc1(ULEV(config->computePgmRsrc1), arch, kinfo);
+        }
+        kernels.push_back(kinfo);
+    }
+}
+
+// Gallium binaries: resources from program info (PGM_RSRC1, PGM_RSRC2, TMPRING_SIZE)
+template<typename GalliumElfBinary>
+static void scanGalliumBinary(const GalliumBinary& binary,
+            const GalliumElfBinary& elfBin, GPUArchitecture arch,
+            std::vector<ScanKernelInfo>& kernels)
+{
+    const cxuint ldsShift = arch<GPUArchitecture::GCN1_1 ? 8 : 9;
+    const uint32_t kernelsNum = binary.getKernelsNum();
+    kernels.resize(kernelsNum);
+    for (uint32_t i = 0; i < kernelsNum; i++)
+    {
+        ScanKernelInfo& kinfo = kernels[i];
+        kinfo = { binary.getKernel(i).kernelName, 0, 0, 0, 0 };
+        const GalliumProgInfoEntry* progInfo = elfBin.getProgramInfo(i);
+        const uint32_t entriesNum = elfBin.getProgramInfoEntriesNum(i);
+        for (uint32_t k = 0; k < entriesNum; k++)
+        {
+            const uint32_t value = ULEV(progInfo[k].value);
+            switch (ULEV(progInfo[k].address))
+            {
+                case 0xb848: // PGM_RSRC1
+                    decodePgmRsrc1(value, arch, kinfo);
+                    break;
+                case 0xb84c: // PGM_RSRC2
+                    kinfo.localSize = uint64_t((value>>15) & 0x1ff) << ldsShift;
+                    break;
+                case 0xb860: // TMPRING_SIZE
+                    kinfo.scratchSize = ((value >> 12) << 10) >> 6;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+static void scanFile(const std::string& filename, GPUArchitecture galliumArch,
+            ScanFileResult& result)
+{
+    result.format = nullptr;
+    try
+    {
+        Array<cxbyte> binaryData;
+        MappedFile mappedFile;
+        // map regular files to memory, read other files (pipes, devices)
+        const std::pair<cxbyte*, size_t> binaryPair = loadDataFromFile(filename.c_str(),
+                    mappedFile, binaryData, true);
+        cxbyte* binaryCode = binaryPair.first;
+        const size_t binarySize = binaryPair.second;
+        
+        if (isAmdBinary(binarySize, binaryCode))
+        {
+            // parse inner binaries and kernel infos only on access
+            std::unique_ptr<AmdMainBinaryBase> base(createAmdBinaryFromCode(
+                    binarySize, binaryCode, AMDBIN_CREATE_KERNELINFO |
+                    AMDBIN_CREATE_INNERBINMAP | AMDBIN_INNER_CREATE_CALNOTES |
+                    AMDBIN_CREATE_LAZY));
+            if (base->getType() == AmdMainType::GPU_BINARY ||
+                base->getType() == AmdMainType::GPU_64_BINARY)
+            {
+                result.format = "amd";
+                if (base->getType() == AmdMainType::GPU_BINARY)
+                    scanAmdGPUBinary(static_cast<const AmdMainGPUBinary32&>(*base),
+                                result.kernels);
+                else
+                    scanAmdGPUBinary(static_cast<const AmdMainGPUBinary64&>(*base),
+                                result.kernels);
+            }
+            else
+                result.format = "amdx86";
+        }
+        else if (isAmdCL2Binary(binarySize, binaryCode))
+        {
+            std::unique_ptr<AmdCL2MainGPUBinaryBase> base(createAmdCL2BinaryFromCode(
+                    binarySize, binaryCode, AMDBIN_CREATE_KERNELINFO |
+                    AMDCL2BIN_INNER_CREATE_KERNELDATA |
+                    AMDCL2BIN_INNER_CREATE_KERNELDATAMAP));
+            result.format = "amdcl2";
+            scanAmdCL2GPUBinary(*base, result.kernels);
+        }
+        else if (isROCmBinary(binarySize, binaryCode))
+        {
+            ROCmBinary binary(binarySize, binaryCode, 0);
+            result.format = "rocm";
+            scanROCmBinary(binary, result.kernels);
+        }
+        else if (isGalliumBinary(binarySize, binaryCode))
+        {
+            GalliumBinary binary(binarySize, binaryCode, 0);
+            result.format = "gallium";
+            if (!binary.is64BitElfBinary())
+                scanGalliumBinary(binary, binary.getElfBinary32(), galliumArch,
+                            result.kernels);
+            else
+                scanGalliumBinary(binary, binary.getElfBinary64(), galliumArch,
+                            result.kernels);
+        }
+    }
+    catch(const std::exception& ex)
+    {
+        result.kernels.clear();
+        result.error = ex.what();
+    }
+}
+
+// append JSON string (with quotes) to line
+static void appendJSONString(std::string& line, const char* str)
+{
+    line.push_back('"');
+    for (; *str != 0; str++)
+    {
+        const unsigned char c = *str;
+        if (c == '"' || c == '\\')
+            line.push_back('\\');
+        if (c >= 0x20)
+            line.push_back(c);
+        else
+        {
+            // control characters
+            char buf[8];
+            snprintf(buf, 8, "\\u%04x", c);
+            line += buf;
+        }
+    }
+    line.push_back('"');
+}
+
+// append CSV field (quoted only if needed)
+static void appendCSVField(std::string& line, const char* str)
+{
+    if (::strpbrk(str, ",\"\r\n") == nullptr)
+    {
+        line += str;
+        return;
+    }
+    line.push_back('"');
+    for (; *str != 0; str++)
+    {
+        if (*str == '"')
+            line.push_back('"');
+        line.push_back(*str);
+    }
+    line.push_back('"');
+}
+
+static void writeResult(std::string& out, const std::string& filename,
+            const ScanFileResult& result, bool jsonOutput)
+{
+    char buf[120];
+    if (!result.error.empty())
+    {
+        if (jsonOutput)
+        {
+            out += "{\"type\":\"error\",\"name\":";
+            appendJSONString(out, filename.c_str());
+            out += ",\"message\":";
+            appendJSONString(out, result.error.c_str());
+            out += "}\n";
+        }
+        return;
+    }
+    if (result.format == nullptr)
+        return; // not recognized
+    if (jsonOutput)
+    {
+        out += "{\"type\":\"file\",\"name\":";
+        appendJSONString(out, filename.c_str());
+        snprintf(buf, sizeof buf, ",\"format\":\"%s\",\"kernelsNum\":%zu}\n",
+                result.format, result.kernels.size());
+        out += buf;
+    }
+    for (const ScanKernelInfo& kinfo: result.kernels)
+        if (jsonOutput)
+        {
+            out += "{\"type\":\"kernel\",\"file\":";
+            appendJSONString(out, filename.c_str());
+            out += ",\"name\":";
+            appendJSONString(out, kinfo.name.c_str());
+            snprintf(buf, sizeof buf, ",\"sgprsNum\":%u,\"vgprsNum\":%u,"
+                    "\"scratchSize\":%" PRIu64 ",\"localSize\":%" PRIu64 "}\n",
+                    kinfo.sgprsNum, kinfo.vgprsNum, kinfo.scratchSize, kinfo.localSize);
+            out += buf;
+        }
+        else
+        {
+            appendCSVField(out, filename.c_str());
+            out.push_back(',');
+            out += result.format;
+            out.push_back(',');
+            appendCSVField(out, kinfo.name.c_str());
+            snprintf(buf, sizeof buf, ",%u,%u,%" PRIu64 ",%" PRIu64 "\n",
+                    kinfo.sgprsNum, kinfo.vgprsNum, kinfo.scratchSize, kinfo.localSize);
+            out += buf;
+        }
+}
+
+int main(int argc, const char** argv)
+try
+{
+    CLIParser cli("clrxscan", programOptions, argc, argv);
+    cli.parse();
+    if (cli.handleHelpOrUsage())
+        return 0;
+    
+    if (cli.getArgsNum() == 0)
+    {
+        std::cerr << "No input files." << std::endl;
+        return 1;
+    }
+    
+    const bool jsonOutput = cli.hasShortOption('J');
+    cxuint threadsNum = 0;
+    if (cli.hasShortOption('j'))
+        threadsNum = cli.getShortOptArg<cxuint>('j');
+    GPUArchitecture galliumArch = GPUArchitecture::GCN1_0;
+    if (cli.hasShortOption('g'))
+        galliumArch = getGPUArchitectureFromDeviceType(
+                getGPUDeviceTypeFromName(cli.getShortOptArg<const char*>('g')));
+    else if (cli.hasShortOption('A'))
+        galliumArch = getGPUArchitectureFromName(cli.getShortOptArg<const char*>('A'));
+    
+    const std::chrono::steady_clock::time_point startTime =
+                std::chrono::steady_clock::now();
+    int ret = 0;
+    std::vector<std::string> files;
+    for (const char* const* args = cli.getArgs();*args != nullptr; args++)
+        try
+        { collectFiles(*args, files); }
+        catch(const std::exception& ex)
+        {
+            ret = 1;
+            std::cerr << "Error during scanning '" << *args << "': " <<
+                    ex.what() << std::endl;
+        }
+    
+    std::vector<ScanFileResult> results(files.size());
+    runParallel(files.size(), threadsNum, [&files, &results, galliumArch](size_t i)
+            { scanFile(files[i], galliumArch, results[i]); });
+    
+    // write results in order of files
+    size_t kernelsNum = 0;
+    size_t skippedNum = 0;
+    size_t errorsNum = 0;
+    std::string out;
+    if (!jsonOutput)
+        out = "file,format,kernel,sgprsNum,vgprsNum,scratchSize,localSize\n";
+    for (size_t i = 0; i < files.size(); i++)
+    {
+        const ScanFileResult& result = results[i];
+        writeResult(out, files[i], result, jsonOutput);
+        if (!result.error.empty())
+        {
+            ret = 1;
+            errorsNum++;
+            std::cerr << "Error during scanning '" << files[i] << "': " <<
+                    result.error << std::endl;
+        }
+        else if (result.format == nullptr)
+            skippedNum++;
+        kernelsNum += result.kernels.size();
+        if (out.size() >= 0x10000)
+        {
+            std::cout.write(out.c_str(), out.size());
+            out.clear();
+        }
+    }
+    std::cout.write(out.c_str(), out.size());
+    std::cout.flush();
+    
+    if (!cli.hasShortOption('q'))
+    {
+        const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - startTime).count();
+        char buf[200];
+        snprintf(buf, sizeof buf, "Scanned %zu files (%zu skipped, %zu errors), "
+                "%zu kernels in %.3f s: %.1f files/s", files.size(), skippedNum,
+                errorsNum, kernelsNum, seconds,
+                seconds > 0.0 ? files.size() / seconds : 0.0);
+        std::cerr << buf << std::endl;
+    }
+    return ret;
+}
+catch(const Exception& ex)
+{
+    std::cerr << ex.what() << std::endl;
+    return 1;
+}
+catch(const std::bad_alloc& ex)
+{
+    std::cerr << "Out of memory" << std::endl;
+    return 1;
+}
+catch(const std::exception& ex)
+{
+    std::cerr << "System exception: " << ex.what() << std::endl;
+    return 1;
+}
+catch(...)
+{
+    std::cerr << "Unknown exception" << std::endl;
+    return 1;
+}
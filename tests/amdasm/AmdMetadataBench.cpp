@@ -0,0 +1,144 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdasm/Assembler.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+/* benchmark of AMD OpenCL 1.2 kernel metadata parsing: loading binary with
+ * kernel infos and disassembling kernel configurations.
+ * usage: AmdMetadataBench [ITERATIONS [KERNELSNUM [ARGSNUM]]] */
+
+static const char* argDefs[] =
+{
+    "uint", "float4", "structure,24", "sampler", "image2d",
+    "image3d,write_only", "float*,global", "float*,global,const", "uchar8*,constant,,40",
+    "float*,local", "structure*,14,global,const", "ulong16*,global,restrict volatile",
+    "image1d_array", "double", "short8"
+};
+
+// generate source of AMD binary with many kernels with many arguments
+static std::string generateSource(cxuint kernelsNum, cxuint argsNum)
+{
+    std::ostringstream oss;
+    oss << ".amd\n.gpu Pitcairn\n";
+    for (cxuint i = 0; i < kernelsNum; i++)
+    {
+        oss << ".kernel kernel_" << i << "\n    .config\n        .dims x\n";
+        for (cxuint j = 0; j < argsNum; j++)
+            oss << "        .arg argument_" << j << "," <<
+                    argDefs[(i+j) % (sizeof(argDefs)/sizeof(const char*))] << "\n";
+        oss << "    .text\n        s_endpgm\n";
+    }
+    return oss.str();
+}
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static void benchMetadata(cxuint iterations, cxuint kernelsNum, cxuint argsNum)
+{
+    const char* testName = "benchMetadata";
+    std::istringstream input(generateSource(kernelsNum, argsNum));
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL&~ASM_ALTMACRO,
+            BinaryFormat::AMD, GPUDeviceType::PITCAIRN, errorStream);
+    if (!assembler.assemble())
+        throw Exception("Can't assemble: " + errorStream.str());
+    Array<cxbyte> binary;
+    assembler.writeBinary(binary);
+    
+    const Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+            AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+            AMDBIN_CREATE_KERNELHEADERMAP | AMDBIN_CREATE_INFOSTRINGS |
+            AMDBIN_INNER_CREATE_CALNOTES;
+    BenchClock::time_point start = BenchClock::now();
+    for (cxuint i = 0; i < iterations; i++)
+    {
+        AmdMainGPUBinary32 amdBin(binary.size(), binary.data(), binFlags);
+        assertValue(testName, "kernelInfosNum", size_t(kernelsNum),
+                    amdBin.getKernelInfosNum());
+    }
+    const double loadTime = elapsedMs(start);
+    
+    AmdMainGPUBinary32 amdBin(binary.size(), binary.data(), binFlags);
+    for (cxuint i = 0; i < kernelsNum; i++)
+    {
+        const KernelInfo& kernelInfo = amdBin.getKernelInfo(i);
+        assertValue(testName, "argsNum", size_t(argsNum), kernelInfo.argInfos.size());
+        assertString(testName, "argName", "argument_0", kernelInfo.argInfos[0].argName);
+    }
+    
+    // disassemble configuration (with loading binary)
+    size_t outputSize = 0;
+    start = BenchClock::now();
+    for (cxuint i = 0; i < iterations; i++)
+    {
+        AmdMainGPUBinary32 amdBin(binary.size(), binary.data(), binFlags);
+        std::ostringstream output;
+        Disassembler disasm(amdBin, output, DISASM_CONFIG);
+        disasm.disassemble();
+        outputSize = output.str().size();
+    }
+    const double disasmTime = elapsedMs(start);
+    
+    char buf[200];
+    snprintf(buf, sizeof buf, "kernels=%u args=%u: load=%.3fms "
+            "load+disasmConfig=%.3fms (output=%zu)", kernelsNum, argsNum,
+            loadTime, disasmTime, outputSize);
+    std::cout << buf << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    cxuint iterations = 2;
+    cxuint kernelsNum = 100;
+    cxuint argsNum = 64;
+    if (argc >= 2)
+        iterations = ::strtoul(argv[1], nullptr, 10);
+    if (argc >= 3)
+        kernelsNum = ::strtoul(argv[2], nullptr, 10);
+    if (argc >= 4)
+        argsNum = ::strtoul(argv[3], nullptr, 10);
+    try
+    { benchMetadata(iterations, kernelsNum, argsNum); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    return retVal;
+}
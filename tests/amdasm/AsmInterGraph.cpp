@@ -0,0 +1,249 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+// simple linear congruential generator (to get this same results on every platform)
+static uint32_t nextRandom(uint32_t& state)
+{
+    state = state*1103515245U + 12345U;
+    return state>>8;
+}
+
+/* build graph from random cliques (live ranges) and compare with reference graph */
+static void testAsmInterGraph(size_t nodesNum, size_t cliquesNum, size_t maxCliqueSize,
+            bool expBitMatrix)
+{
+    std::ostringstream oss;
+    oss << " testAsmInterGraph(" << nodesNum << ")";
+    const std::string testName = oss.str();
+    uint32_t state = nodesNum;
+    std::vector<std::set<size_t> > refGraph(nodesNum);
+    AsmInterGraph graph;
+    graph.resize(nodesNum);
+    std::vector<size_t> clique;
+    for (size_t c = 0; c < cliquesNum; c++)
+    {
+        // nodes from window (like live variables in code range)
+        const size_t cliqueSize = 1 + nextRandom(state) % maxCliqueSize;
+        const size_t start = nextRandom(state) % nodesNum;
+        clique.clear();
+        for (size_t k = 0; k < cliqueSize; k++)
+            clique.push_back((start + nextRandom(state) % (4*maxCliqueSize)) % nodesNum);
+        std::sort(clique.begin(), clique.end());
+        clique.resize(std::unique(clique.begin(), clique.end()) - clique.begin());
+        graph.addClique(clique);
+        for (size_t a: clique)
+            for (size_t b: clique)
+                if (a != b)
+                    refGraph[a].insert(b);
+    }
+    graph.finish();
+
+    assertValue("testAsmInterGraph", testName+".size", nodesNum, graph.size());
+    assertValue<bool>("testAsmInterGraph", testName+".isBitMatrix", expBitMatrix,
+                graph.isBitMatrix());
+    for (size_t i = 0; i < nodesNum; i++)
+    {
+        std::ostringstream nOss;
+        nOss << testName << ".node" << i;
+        const std::string nodeName = nOss.str();
+        assertValue("testAsmInterGraph", nodeName+".degree", refGraph[i].size(),
+                    graph.degree(i));
+        std::vector<size_t> neighbors;
+        for (size_t nb: graph[i])
+            neighbors.push_back(nb);
+        assertValue("testAsmInterGraph", nodeName+".neighborsNum", refGraph[i].size(),
+                    neighbors.size());
+        if (!std::equal(neighbors.begin(), neighbors.end(), refGraph[i].begin()))
+            throw Exception("FAILED for"+nodeName+": neighbors mismatch");
+        for (size_t j = 0; j < nodesNum; j += 1 + (nodesNum>>8))
+            assertValue<bool>("testAsmInterGraph", nodeName+".isEdge",
+                    refGraph[i].find(j) != refGraph[i].end(), graph.isEdge(i, j));
+    }
+}
+
+/* sparse bit matrix graph: neighbors at word boundaries and in distant words */
+static void testAsmInterGraphSparse()
+{
+    const size_t nodesNum = AsmInterGraph::bitMatrixMaxNodes;
+    AsmInterGraph graph;
+    graph.resize(nodesNum);
+    graph.addClique({ 0, 63, 64, 4032, 4095 });
+    graph.addClique({ 127, 128 });
+    graph.addClique({ 5, 5 });
+    graph.finish();
+    assertValue<bool>("testAsmInterGraph", "sparse.isBitMatrix", true,
+                graph.isBitMatrix());
+    const std::vector<std::vector<size_t> > expNeighbors = {
+        { 63, 64, 4032, 4095 }, { 0, 64, 4032, 4095 }, { 0, 63, 4032, 4095 },
+        { 0, 63, 64, 4095 }, { 0, 63, 64, 4032 }, { 128 }, { 127 }, { }, { } };
+    const size_t nodes[] = { 0, 63, 64, 4032, 4095, 127, 128, 5, 1000 };
+    for (size_t i = 0; i < 9; i++)
+    {
+        std::ostringstream nOss;
+        nOss << "sparse.node" << nodes[i];
+        std::vector<size_t> neighbors;
+        for (size_t nb: graph[nodes[i]])
+            neighbors.push_back(nb);
+        assertValue("testAsmInterGraph", nOss.str()+".degree",
+                    expNeighbors[i].size(), graph.degree(nodes[i]));
+        if (neighbors != expNeighbors[i])
+            throw Exception("FAILED for "+nOss.str()+": neighbors mismatch");
+    }
+}
+
+static void checkGraphColoring(const AsmInterGraph& graph, const Array<cxuint>& colors,
+            cxuint colorsNum, const std::string& testName)
+{
+    for (size_t i = 0; i < graph.size(); i++)
+    {
+        std::ostringstream nOss;
+        nOss << testName << ".node" << i;
+        const std::string nodeName = nOss.str();
+        if (colors[i] >= colorsNum)
+            throw Exception("FAILED for"+nodeName+": not colored");
+        for (size_t nb: graph[i])
+            if (colors[i] == colors[nb])
+                throw Exception("FAILED for"+nodeName+": neighbor with same color");
+    }
+}
+
+/* coloring of graph built from sliding windows (interval graph) */
+static void testAsmInterGraphColor(size_t nodesNum, size_t windowSize,
+            cxuint maxColorsNum)
+{
+    std::ostringstream oss;
+    oss << " testAsmInterGraphColor(" << nodesNum << "," << windowSize << ")";
+    const std::string testName = oss.str();
+    AsmInterGraph graph;
+    graph.resize(nodesNum);
+    std::vector<size_t> clique;
+    for (size_t start = 0; start + windowSize <= nodesNum; start++)
+    {
+        clique.clear();
+        for (size_t k = 0; k < windowSize; k++)
+            clique.push_back(start + k);
+        graph.addClique(clique);
+    }
+    graph.finish();
+    
+    Array<cxuint> colors(nodesNum);
+    std::fill(colors.begin(), colors.end(), cxuint(UINT_MAX));
+    // precolored node (real register)
+    colors[nodesNum>>1] = 3;
+    // nodes that must have this same color (not interfering)
+    std::vector<std::vector<size_t> > equalSetList;
+    equalSetList.push_back({ 1, 1+windowSize, 1+2*windowSize });
+    std::unordered_map<size_t, size_t> equalSetMap;
+    for (size_t node: equalSetList[0])
+        equalSetMap.insert({ node, 0 });
+    
+    const cxuint colorsNum = graph.color(colors, maxColorsNum, equalSetList,
+                equalSetMap);
+    // interval graph with cliques of windowSize needs windowSize colors
+    assertValue("testAsmInterGraph", testName+".colorsNum", cxuint(windowSize),
+                colorsNum);
+    assertValue("testAsmInterGraph", testName+".precolored", cxuint(3),
+                colors[nodesNum>>1]);
+    assertValue("testAsmInterGraph", testName+".equalSet1", colors[1],
+                colors[1+windowSize]);
+    assertValue("testAsmInterGraph", testName+".equalSet2", colors[1],
+                colors[1+2*windowSize]);
+    checkGraphColoring(graph, colors, colorsNum, testName);
+    
+    // too few colors
+    std::fill(colors.begin(), colors.end(), cxuint(UINT_MAX));
+    bool tooMany = false;
+    try
+    { graph.color(colors, windowSize-1, equalSetList, equalSetMap); }
+    catch(const AsmException& ex)
+    { tooMany = true; }
+    assertValue<bool>("testAsmInterGraph", testName+".tooManyRegs", true, tooMany);
+}
+
+/* stress test: 100000 variables, every variable lives in some ranges */
+static void testAsmInterGraphStress()
+{
+    const size_t nodesNum = 100000;
+    AsmInterGraph graph;
+    graph.resize(nodesNum);
+    std::vector<size_t> clique;
+    // sliding window of live variables
+    for (size_t start = 0; start + 32 <= nodesNum; start += 4)
+    {
+        clique.clear();
+        for (size_t k = 0; k < 32; k++)
+            clique.push_back(start + k);
+        graph.addClique(clique);
+    }
+    graph.finish();
+    assertValue<bool>("testAsmInterGraph", "stress.isBitMatrix", false,
+                graph.isBitMatrix());
+    // node 50000 is in windows that starts from 49972 to 50000
+    assertValue("testAsmInterGraph", "stress.degree", size_t(59), graph.degree(50000));
+    assertValue<bool>("testAsmInterGraph", "stress.isEdge0", true,
+                graph.isEdge(50000, 50031));
+    assertValue<bool>("testAsmInterGraph", "stress.isEdge1", false,
+                graph.isEdge(50000, 50032));
+    // adjacency lists use 4-byte indices
+    if (graph.getMemoryUsage() > nodesNum*(62*4+16))
+        throw Exception("FAILED for stress: too big memory usage");
+    Array<cxuint> colors(nodesNum);
+    std::fill(colors.begin(), colors.end(), cxuint(UINT_MAX));
+    const cxuint colorsNum = graph.color(colors, 256, {}, {});
+    assertValue("testAsmInterGraph", "stress.colorsNum", cxuint(32), colorsNum);
+    checkGraphColoring(graph, colors, colorsNum, "stress");
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    try
+    {
+        testAsmInterGraph(1, 1, 1, true);
+        testAsmInterGraph(100, 40, 10, true);
+        testAsmInterGraph(AsmInterGraph::bitMatrixMaxNodes, 1000, 30, true);
+        testAsmInterGraph(AsmInterGraph::bitMatrixMaxNodes+1, 1000, 30, false);
+        testAsmInterGraph(20000, 5000, 40, false);
+        testAsmInterGraphSparse();
+        testAsmInterGraphColor(100, 8, 104);
+        testAsmInterGraphColor(AsmInterGraph::bitMatrixMaxNodes+100, 20, 104);
+        testAsmInterGraphStress();
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    return retVal;
+}
@@ -3646,6 +3646,30 @@ static void testCreateSSAData(cxuint i, const AsmSSADataCase& testCase)
                     int(expCBlock.haveReturn), int(resCBlock.haveReturn));
         assertValue("testAsmSSAData", testCaseName + cbname + "haveEnd",
                     int(expCBlock.haveEnd), int(resCBlock.haveEnd));
+        
+        // check whether seeking to code block gives first usage of code block
+        ISAUsageHandler& usageHandler = *section.usageHandler;
+        usageHandler.rewind();
+        AsmRegVarUsage expRvu = { 0U, nullptr, 0U, 0U };
+        while (usageHandler.hasNext())
+        {
+            expRvu = usageHandler.nextUsage();
+            if (expRvu.offset >= resCBlock.start)
+                break;
+        }
+        if (expRvu.offset >= resCBlock.start && expRvu.offset < resCBlock.end)
+        {
+            usageHandler.seekTo(resCBlock.start);
+            assertValue("testAsmSSAData", testCaseName + cbname + "seek.hasNext",
+                    1, int(usageHandler.hasNext()));
+            const AsmRegVarUsage resRvu = usageHandler.nextUsage();
+            assertValue("testAsmSSAData", testCaseName + cbname + "seek.offset",
+                    expRvu.offset, resRvu.offset);
+            assertValue("testAsmSSAData", testCaseName + cbname + "seek.rstart",
+                    expRvu.rstart, resRvu.rstart);
+            assertValue("testAsmSSAData", testCaseName + cbname + "seek.regField",
+                    cxuint(expRvu.regField), cxuint(resRvu.regField));
+        }
     }
     
     const SSAReplacesMap& ssaReplacesMap = regAlloc.getSSAReplacesMap();
@@ -3692,6 +3716,660 @@ static void testCreateSSAData(cxuint i, const AsmSSADataCase& testCase)
     }
 }
 
+struct AsmApplySSAReplacesCase
+{
+    size_t ssaDataCaseIndex;    ///< index of input in ssaDataTestCases1Tbl
+    Array<std::pair<TestSingleVReg2, Array<SSAReplace> > > ssaReplaces;
+};
+
+// SSA replaces after applying (every SSA id replaced by minimal SSA id)
+static const AsmApplySSAReplacesCase applySSAReplacesTestCases1Tbl[] =
+{
+    {   8,
+        {
+            { { "sa", 0 }, { { 2, 1 } } },
+            { { "sa", 1 }, { { 3, 2 } } },
+            { { "va", 0 }, { { 8, 1 }, { 10, 5 } } },
+            { { "va", 1 }, { { 2, 1 }, { 3, 1 } } },
+            { { "va", 2 }, { { 4, 1 }, { 5, 1 } } }
+        }
+    },
+    {   25,
+        {
+            { { "sa", 2 }, { { 5, 4 }, { 6, 4 }, { 7, 3 } } },
+            { { "sa", 3 }, { { 3, 2 }, { 4, 2 }, { 5, 2 } } }
+        }
+    },
+    {   27,
+        {
+            { { "sa", 2 }, { { 3, 1 }, { 4, 1 }, { 6, 5 } } },
+            { { "sa", 3 }, { { 2, 1 }, { 4, 3 } } },
+            { { "sa", 4 }, { { 2, 1 }, { 3, 1 } } }
+        }
+    }
+};
+
+static void testApplySSAReplaces(cxuint i, const AsmApplySSAReplacesCase& testCase)
+{
+    std::istringstream input(ssaDataTestCases1Tbl[testCase.ssaDataCaseIndex].input);
+    std::ostringstream errorStream;
+    
+    Assembler assembler("test.s", input,
+                    (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN | ASM_TESTRESOLVE,
+                    BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream);
+    assembler.assemble();
+    const AsmSection& section = assembler.getSections()[0];
+    
+    AsmRegAllocator regAlloc(assembler);
+    regAlloc.createCodeStructure(section.codeFlow, section.getSize(),
+                            section.content.data());
+    regAlloc.createSSAData(*section.usageHandler);
+    regAlloc.applySSAReplaces();
+    
+    std::ostringstream oss;
+    oss << " testAsmApplySSAReplacesCase#" << i;
+    const std::string testCaseName = oss.str();
+    
+    const SSAReplacesMap& ssaReplacesMap = regAlloc.getSSAReplacesMap();
+    assertValue("testApplySSAReplaces", testCaseName + "ssaReplacesSize",
+                    testCase.ssaReplaces.size(), ssaReplacesMap.size());
+    for (size_t j = 0; j < testCase.ssaReplaces.size(); j++)
+    {
+        std::ostringstream ssaOss;
+        ssaOss << "ssas" << j << ".";
+        std::string ssaName(ssaOss.str());
+        
+        const auto& expEntry = testCase.ssaReplaces[j];
+        const AsmRegVar* regVar = &assembler.getRegVarMap().find(
+                        expEntry.first.name)->second;
+        auto rit = ssaReplacesMap.find(AsmSingleVReg{ regVar, expEntry.first.index });
+        assertTrue("testApplySSAReplaces", testCaseName + ssaName + "found",
+                        rit != ssaReplacesMap.end());
+        const std::vector<SSAReplace>& resReplaces = rit->second;
+        assertValue("testApplySSAReplaces", testCaseName + ssaName + "replacesSize",
+                        expEntry.second.size(), resReplaces.size());
+        for (size_t k = 0; k < expEntry.second.size(); k++)
+        {
+            std::ostringstream repOss;
+            repOss << "replace#" << k << ".";
+            std::string repName(repOss.str());
+            
+            assertValue("testApplySSAReplaces", testCaseName + ssaName + repName + "first",
+                        expEntry.second[k].first, resReplaces[k].first);
+            assertValue("testApplySSAReplaces", testCaseName + ssaName + repName +
+                        "second", expEntry.second[k].second, resReplaces[k].second);
+        }
+    }
+}
+
+typedef AsmRegAllocator::LiveBlock LiveBlock;
+
+// variable (SSA id of single vreg), empty name for real register
+struct TestVar
+{
+    const char* name;
+    uint16_t index;
+    size_t ssaId;
+};
+
+struct CLiveness
+{
+    TestVar var;
+    Array<std::pair<size_t, size_t> > regions;  ///< live regions (start, end)
+};
+
+// linear or equalTo dependency of variable
+struct CVarDep
+{
+    TestVar var;
+    cxuint align;   ///< alignment (zero for equalTo dependency)
+    Array<TestVar> prevVars;
+    Array<TestVar> nextVars;
+};
+
+struct AsmLivenessesCase
+{
+    const char* input;
+    Array<CLiveness> livenesses[2];  ///< livenesses of variables (sorted by var)
+    Array<CVarDep> linearDeps[2];   ///< linear dependencies (sorted by var)
+    Array<CVarDep> equalToDeps[2];  ///< equalTo dependencies (sorted by var)
+    bool good;
+    const char* errorMessages;
+};
+
+static const AsmLivenessesCase livenessesTestCases1Tbl[] =
+{
+    {   /* 0 - only reads */
+        ".regvar sa:s:2\n"
+        "s_cmp_eq_u32 sa[0], sa[1]\n"
+        "s_cmp_lg_u32 sa[0], s1\n"
+        "s_cmp_eq_u32 sa[1], sa[1]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 1, 0 }, { { 0, 5 } } },
+                { { "sa", 0, 0 }, { { 0, 5 } } },
+                { { "sa", 1, 0 }, { { 0, 9 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 1 - write-only usereg does not create new SSA id */
+        ".regvar sa:s:2\n"
+        "s_mov_b32 sa[0], 1\n"
+        "s_mov_b32 sa[1], 2\n"
+        ".usereg sa[0]:w, sa[1]:rw\n"
+        "s_cmp_eq_u32 sa[0], sa[1]\n"
+        "s_cmp_eq_u32 sa[1], sa[1]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "sa", 0, 1 }, { { 1, 9 } } },
+                { { "sa", 1, 1 }, { { 5, 13 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 2 - read and write of same regvar in instruction */
+        ".regvar sa:s:2\n"
+        "s_mov_b32 sa[0], 1\n"
+        "s_mov_b32 sa[1], 2\n"
+        "s_add_u32 sa[0], sa[0], sa[1]\n"
+        "s_add_u32 sa[1], sa[1], sa[0]\n"
+        "s_lshl_b32 sa[0], sa[0], sa[1]\n"
+        "s_cmp_eq_u32 sa[0], s2\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 2, 0 }, { { 0, 21 } } },
+                { { "sa", 0, 1 }, { { 1, 9 } } },
+                { { "sa", 0, 2 }, { { 9, 17 } } },
+                { { "sa", 0, 3 }, { { 17, 21 } } },
+                { { "sa", 1, 1 }, { { 5, 13 } } },
+                { { "sa", 1, 2 }, { { 13, 17 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 3 - linear dependencies in second code block */
+        ".regvar sp:s:2\n"
+        "s_mov_b64 sp[0:1], 0\n"
+        "s_cmp_eq_u32 sp[0], sp[1]\n"
+        "s_branch b1\n"
+        "b1: s_mov_b64 sp[0:1], 1\n"
+        "s_cmp_eq_u32 sp[0], sp[1]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "sp", 0, 1 }, { { 1, 5 } } },
+                { { "sp", 0, 2 }, { { 13, 17 } } },
+                { { "sp", 1, 1 }, { { 1, 5 } } },
+                { { "sp", 1, 2 }, { { 13, 17 } } }
+            },
+            { }
+        },
+        {   // linearDeps
+            {   // for SGPRs
+                { { "sp", 0, 1 }, 2, { }, { { "sp", 1, 1 } } },
+                { { "sp", 0, 2 }, 2, { }, { { "sp", 1, 2 } } },
+                { { "sp", 1, 1 }, 0, { { "sp", 0, 1 } }, { } },
+                { { "sp", 1, 2 }, 0, { { "sp", 0, 2 } }, { } }
+            },
+            { }
+        },
+        { },
+        true, ""
+    },
+    {   /* 4 - dead write */
+        ".regvar sa:s:2\n"
+        "s_mov_b32 sa[0], 1\n"
+        "s_mov_b32 sa[1], 2\n"
+        "s_cmp_eq_u32 sa[0], s1\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 1, 0 }, { { 0, 9 } } },
+                { { "sa", 0, 1 }, { { 1, 9 } } },
+                { { "sa", 1, 1 }, { { 5, 6 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 5 - dead write at last instruction with usages in code block */
+        ".regvar sa:s:4\n"
+        "s_mov_b32 sa[0], 1\n"
+        "s_mov_b32 sa[1], 2\n"
+        "s_branch b1\n"
+        "b1: s_mov_b32 s4, sa[0]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 4, 0 }, { { 13, 14 } } },
+                { { "sa", 0, 1 }, { { 1, 13 } } },
+                { { "sa", 1, 1 }, { { 5, 6 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 6 - VOP instruction with real register */
+        ".regvar va:v:2\n"
+        "v_mov_b32 va[0], 1\n"
+        "v_add_f32 va[1], v1, va[0]\n"
+        "v_mov_b32 v2, va[1]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            { },
+            {   // for VGPRs
+                { { "", 257, 0 }, { { 0, 5 } } },
+                { { "", 258, 0 }, { { 9, 10 } } },
+                { { "va", 0, 1 }, { { 1, 5 } } },
+                { { "va", 1, 1 }, { { 5, 9 } } }
+            }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 7 - dependencies of rewritten 64-bit regvar and regvar in two VOP sources */
+        ".regvar sp:s:2, va:v:2\n"
+        "s_mov_b64 sp[0:1], 0\n"
+        "s_lshl_b64 sp[0:1], sp[0:1], 1\n"
+        "v_mov_b32 va[0], 1\n"
+        "s_branch b1\n"
+        "b1: s_lshl_b64 sp[0:1], sp[0:1], 2\n"
+        "v_mad_f32 va[0], sp[1], sp[1], va[0]\n"
+        "v_mov_b32 va[1], va[0]\n"
+        "s_mov_b64 s[2:3], sp[0:1]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 2, 0 }, { { 33, 34 } } },
+                { { "", 3, 0 }, { { 33, 34 } } },
+                { { "sp", 0, 1 }, { { 1, 5 } } },
+                { { "sp", 0, 2 }, { { 5, 17 } } },
+                { { "sp", 0, 3 }, { { 17, 33 } } },
+                { { "sp", 1, 1 }, { { 1, 5 } } },
+                { { "sp", 1, 2 }, { { 5, 17 } } },
+                { { "sp", 1, 3 }, { { 17, 33 } } }
+            },
+            {   // for VGPRs
+                { { "va", 0, 1 }, { { 9, 21 } } },
+                { { "va", 0, 2 }, { { 21, 29 } } },
+                { { "va", 1, 1 }, { { 29, 30 } } }
+            }
+        },
+        {   // linearDeps
+            {   // for SGPRs
+                { { "", 2, 0 }, 0, { }, { { "", 3, 0 } } },
+                { { "", 3, 0 }, 0, { { "", 2, 0 } }, { } },
+                { { "sp", 0, 1 }, 2, { }, { { "sp", 1, 1 } } },
+                { { "sp", 0, 2 }, 2, { }, { { "sp", 1, 2 } } },
+                { { "sp", 0, 3 }, 2, { }, { { "sp", 1, 3 } } },
+                { { "sp", 1, 1 }, 0, { { "sp", 0, 1 } }, { } },
+                { { "sp", 1, 2 }, 0, { { "sp", 0, 2 } }, { } },
+                { { "sp", 1, 3 }, 0, { { "sp", 0, 3 } }, { } }
+            },
+            { }
+        },
+        { },  // no equalTo dependency of sp[1] to itself
+        true, ""
+    },
+    {   /* 8 - two branches joined (variable from both branches) */
+        ".regvar sa:s:3\n"
+        "s_mov_b32 sa[0], 1\n"
+        "s_cbranch_scc0 b0\n"
+        "s_mov_b32 sa[1], sa[0]\n"
+        "s_branch b1\n"
+        "b0: s_mov_b32 sa[1], 2\n"
+        "b1: s_mov_b32 s5, sa[1]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 5, 0 }, { { 17, 18 } } },
+                { { "sa", 0, 1 }, { { 1, 9 } } },
+                { { "sa", 1, 1 }, { { 9, 17 }, { 25, 28 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    },
+    {   /* 9 - loop (variable read and written in loop lives in whole loop) */
+        ".regvar sa:s:3\n"
+        "s_mov_b32 sa[0], 1\n"
+        "b1: s_add_u32 sa[1], sa[0], 1\n"
+        "s_add_u32 sa[0], sa[1], sa[0]\n"
+        "s_cbranch_scc0 b1\n"
+        "s_mov_b32 s5, sa[0]\n"
+        "s_endpgm\n",
+        {   // livenesses
+            {   // for SGPRs
+                { { "", 5, 0 }, { { 17, 18 } } },
+                { { "sa", 0, 1 }, { { 1, 17 } } },
+                { { "sa", 1, 1 }, { { 5, 9 } } }
+            },
+            { }
+        },
+        { }, { },
+        true, ""
+    }
+};
+
+// result variable with its live regions
+struct ResLiveness
+{
+    TestSingleVReg vreg;
+    size_t ssaId;
+    std::vector<std::pair<size_t, size_t> > regions;
+    
+    bool operator<(const ResLiveness& b) const
+    { return vreg < b.vreg || (vreg == b.vreg && ssaId < b.ssaId); }
+};
+
+typedef AsmRegAllocator::LinearDep LinearDep;
+typedef AsmRegAllocator::EqualToDep EqualToDep;
+
+static cxuint getDepAlign(const LinearDep& dep)
+{ return dep.align; }
+
+static cxuint getDepAlign(const EqualToDep& dep)
+{ return 0; }
+
+static void assertTestVar(const std::string& caseName, const TestVar& expected,
+            const ResLiveness& result)
+{
+    const TestSingleVReg expVReg = { expected.name, expected.index };
+    assertValue("testAsmLivenesses", caseName + "svreg", expVReg, result.vreg);
+    assertValue("testAsmLivenesses", caseName + "ssaId", expected.ssaId, result.ssaId);
+}
+
+// compare dependencies (variables are sorted by name, index and SSA id)
+template<typename T>
+static void checkVarDeps(const std::string& caseName, const Array<CVarDep>& expDeps,
+            const std::unordered_map<size_t, T>& resDepMap,
+            const std::vector<ResLiveness>& resVars,
+            const std::vector<size_t>& vidxPositions)
+{
+    auto vidxLess = [&resVars, &vidxPositions](size_t a, size_t b)
+    { return resVars[vidxPositions[a]] < resVars[vidxPositions[b]]; };
+    std::vector<size_t> resVidxes;
+    for (const auto& entry: resDepMap)
+        resVidxes.push_back(entry.first);
+    std::sort(resVidxes.begin(), resVidxes.end(), vidxLess);
+    
+    assertValue("testAsmLivenesses", caseName + "size", expDeps.size(),
+                resVidxes.size());
+    for (size_t j = 0; j < expDeps.size(); j++)
+    {
+        std::ostringstream depOss;
+        depOss << caseName << "dep#" << j << ".";
+        const std::string depName(depOss.str());
+        const CVarDep& expDep = expDeps[j];
+        const T& resDep = resDepMap.find(resVidxes[j])->second;
+        assertTestVar(depName, expDep.var, resVars[vidxPositions[resVidxes[j]]]);
+        assertValue("testAsmLivenesses", depName + "align", expDep.align,
+                    getDepAlign(resDep));
+        for (cxuint k = 0; k < 2; k++)
+        {
+            const Array<TestVar>& expVars = (k==0) ? expDep.prevVars : expDep.nextVars;
+            std::vector<size_t> resDepVidxes = (k==0) ? resDep.prevVidxes :
+                        resDep.nextVidxes;
+            std::sort(resDepVidxes.begin(), resDepVidxes.end(), vidxLess);
+            const std::string varsName = depName + ((k==0) ? "prev" : "next");
+            assertValue("testAsmLivenesses", varsName + "Size", expVars.size(),
+                    resDepVidxes.size());
+            for (size_t l = 0; l < expVars.size(); l++)
+            {
+                std::ostringstream varOss;
+                varOss << varsName << "#" << l << ".";
+                assertTestVar(varOss.str(), expVars[l],
+                        resVars[vidxPositions[resDepVidxes[l]]]);
+            }
+        }
+    }
+}
+
+static void testCreateLivenesses(cxuint i, const AsmLivenessesCase& testCase)
+{
+    std::istringstream input(testCase.input);
+    std::ostringstream errorStream;
+    
+    Assembler assembler("test.s", input,
+                    (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN | ASM_TESTRESOLVE,
+                    BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    if (assembler.getSections().size()<1)
+    {
+        std::ostringstream oss;
+        oss << "FAILED for " << " testAsmLivenessesCase#" << i;
+        throw Exception(oss.str());
+    }
+    const AsmSection& section = assembler.getSections()[0];
+    
+    AsmRegAllocator regAlloc(assembler);
+    
+    regAlloc.createCodeStructure(section.codeFlow, section.getSize(),
+                            section.content.data());
+    regAlloc.createSSAData(*section.usageHandler);
+    regAlloc.applySSAReplaces();
+    regAlloc.createLivenesses(*section.usageHandler);
+    std::ostringstream oss;
+    oss << " testAsmLivenessesCase#" << i;
+    const std::string testCaseName = oss.str();
+    assertValue<bool>("testAsmLivenesses", testCaseName+".good",
+                      testCase.good, good);
+    assertString("testAsmLivenesses", testCaseName+".errorMessages",
+              testCase.errorMessages, errorStream.str());
+    
+    std::unordered_map<const AsmRegVar*, CString> regVarNamesMap;
+    for (const auto& rvEntry: assembler.getRegVarMap())
+        regVarNamesMap.insert(std::make_pair(&rvEntry.second, rvEntry.first));
+    
+    for (size_t regType = 0; regType < 2; regType++)
+    {
+        std::ostringstream rtOss;
+        rtOss << ".regType#" << regType << ".";
+        const std::string rtname(rtOss.str());
+        // collect variables and their live regions
+        std::vector<ResLiveness> resLivenesses;
+        std::vector<size_t> vidxPositions;
+        for (const auto& entry: regAlloc.getVregIndexMaps()[regType])
+            for (size_t ssaId = 0; ssaId < entry.second.size(); ssaId++)
+                if (entry.second[ssaId] != SIZE_MAX)
+                {
+                    const size_t vidx = entry.second[ssaId];
+                    if (vidxPositions.size() <= vidx)
+                        vidxPositions.resize(vidx+1, SIZE_MAX);
+                    vidxPositions[vidx] = resLivenesses.size();
+                    resLivenesses.push_back({ getTestSingleVReg(entry.first,
+                            regVarNamesMap), ssaId });
+                }
+        for (const LiveBlock& lb: regAlloc.getLiveBlocks()[regType])
+            resLivenesses[vidxPositions[lb.vidx]].regions.push_back(
+                        { lb.start, lb.end });
+        
+        checkVarDeps(testCaseName + rtname + "linearDeps.",
+                testCase.linearDeps[regType], regAlloc.getLinearDepMaps()[regType],
+                resLivenesses, vidxPositions);
+        checkVarDeps(testCaseName + rtname + "equalToDeps.",
+                testCase.equalToDeps[regType], regAlloc.getEqualToDepMaps()[regType],
+                resLivenesses, vidxPositions);
+        std::sort(resLivenesses.begin(), resLivenesses.end());
+        
+        const Array<CLiveness>& expLivenesses = testCase.livenesses[regType];
+        assertValue("testAsmLivenesses", testCaseName + rtname + "size",
+                    expLivenesses.size(), resLivenesses.size());
+        for (size_t j = 0; j < expLivenesses.size(); j++)
+        {
+            std::ostringstream lvOss;
+            lvOss << "liveness#" << j << ".";
+            const std::string lvname(lvOss.str());
+            const CLiveness& expLv = expLivenesses[j];
+            const ResLiveness& resLv = resLivenesses[j];
+            const TestSingleVReg expVReg = { expLv.var.name, expLv.var.index };
+            assertValue("testAsmLivenesses", testCaseName + rtname + lvname + "svreg",
+                        expVReg, resLv.vreg);
+            assertValue("testAsmLivenesses", testCaseName + rtname + lvname + "ssaId",
+                        expLv.var.ssaId, resLv.ssaId);
+            assertValue("testAsmLivenesses", testCaseName + rtname + lvname +
+                        "regionsSize", expLv.regions.size(), resLv.regions.size());
+            for (size_t k = 0; k < expLv.regions.size(); k++)
+            {
+                std::ostringstream rOss;
+                rOss << "region#" << k << ".";
+                const std::string rname(rOss.str());
+                assertValue("testAsmLivenesses", testCaseName + rtname + lvname +
+                        rname + "start", expLv.regions[k].first, resLv.regions[k].first);
+                assertValue("testAsmLivenesses", testCaseName + rtname + lvname +
+                        rname + "end", expLv.regions[k].second, resLv.regions[k].second);
+            }
+        }
+    }
+}
+
+/* real registers have single variable and stay in own registers */
+static void testRegAllocRealRegs(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << "testRegAllocRealRegs(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    std::istringstream input(
+        ".regvar sa:s:4\n"
+        "s_mov_b32 s7, 1\n"
+        "s_mov_b32 sa[0], s7\n"
+        "s_mov_b32 s2, 3\n"
+        "s_add_u32 s7, s7, sa[0]\n"
+        "s_add_u32 sa[1], s2, s7\n"
+        "s_mov_b32 s5, sa[1]\n"
+        "s_endpgm\n");
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>(testName, "good", true, good);
+    AsmRegAllocator regAlloc(assembler, mode);
+    regAlloc.allocateRegisters(0);
+    
+    const Array<cxuint>& regMap = regAlloc.getGraphColorMaps()[REGTYPE_SGPR];
+    size_t realRegsNum = 0;
+    for (const auto& entry: regAlloc.getVregIndexMaps()[REGTYPE_SGPR])
+        if (entry.first.regVar == nullptr)
+        {
+            assertValue(testName, "realRegVarsNum",
+                    size_t(1), entry.second.size());
+            assertValue(testName, "realReg",
+                    cxuint(entry.first.index), regMap[entry.second[0]]);
+            realRegsNum++;
+        }
+    assertValue(testName, "realRegsNum", size_t(3), realRegsNum);
+}
+
+static const char* interGraphStraightCode =
+    ".regvar sa:s:8\n"
+    "s_mov_b32 sa[0], 1\n"
+    "s_mov_b32 sa[1], 2\n"
+    "s_add_u32 sa[2], sa[0], sa[1]\n"
+    "s_mov_b32 sa[3], 4\n"
+    "s_add_u32 sa[4], sa[2], sa[0]\n"
+    "s_add_u32 sa[5], sa[3], sa[1]\n"
+    "s_add_u32 sa[6], sa[4], sa[5]\n"
+    "s_add_u32 sa[7], sa[6], sa[3]\n"
+    "s_add_u32 sa[1], sa[7], sa[2]\n"
+    "s_add_u32 sa[0], sa[1], sa[6]\n"
+    "s_cmp_eq_u32 sa[0], sa[4]\n"
+    "s_endpgm\n";
+
+static const char* interGraphBranchCode =
+    ".regvar sa:s:8\n"
+    "s_mov_b32 sa[0], 1\n"
+    "s_mov_b32 sa[1], 2\n"
+    "s_mov_b32 sa[2], 3\n"
+    "s_cbranch_scc0 b0\n"
+    "s_add_u32 sa[3], sa[0], sa[1]\n"
+    "s_add_u32 sa[4], sa[3], sa[2]\n"
+    "s_branch b1\n"
+    "b0:\n"
+    "s_add_u32 sa[4], sa[1], sa[2]\n"
+    "s_mov_b32 sa[5], sa[0]\n"
+    "b1:\n"
+    "s_add_u32 sa[6], sa[4], sa[0]\n"
+    "s_add_u32 sa[7], sa[6], sa[2]\n"
+    "s_cbranch_scc0 b1\n"
+    "s_mov_b32 s5, sa[7]\n"
+    "s_endpgm\n";
+
+/* interference graph must have edge between every two variables that
+ * have overlapping live blocks (and only between them) */
+static void testRegAllocInterGraph(const char* code, const char* caseName)
+{
+    const std::string testName = std::string("testRegAllocInterGraph(") +
+                caseName + ")";
+    std::istringstream input(code);
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>(testName, "good", true, good);
+    AsmRegAllocator regAlloc(assembler);
+    regAlloc.allocateRegisters(0);
+    
+    const AsmInterGraph& interGraph = regAlloc.getInterGraphs()[REGTYPE_SGPR];
+    const std::vector<LiveBlock>& liveBlocks = regAlloc.getLiveBlocks()[REGTYPE_SGPR];
+    const size_t nodesNum = interGraph.size();
+    std::vector<bool> expEdges(nodesNum*nodesNum, false);
+    for (const LiveBlock& lb1: liveBlocks)
+        for (const LiveBlock& lb2: liveBlocks)
+            if (lb1.vidx != lb2.vidx && lb1.start < lb2.end && lb2.start < lb1.end)
+                expEdges[lb1.vidx*nodesNum + lb2.vidx] = true;
+    for (size_t a = 0; a < nodesNum; a++)
+        for (size_t b = 0; b < nodesNum; b++)
+            if (a != b)
+            {
+                std::ostringstream eoss;
+                eoss << "edge(" << a << "," << b << ")";
+                assertValue<bool>(testName, eoss.str(),
+                        expEdges[a*nodesNum + b], interGraph.isEdge(a, b));
+            }
+}
+
+/* regvar that is equalTo real register (only one SGPR in VOP instruction) */
+static void testRegAllocEqualTo(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << "testRegAllocEqualTo(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    std::istringstream input(
+        ".regvar sa:s:2, va:v:2\n"
+        "s_mov_b32 sa[0], 1\n"
+        "v_mov_b32 va[0], 2\n"
+        "v_mad_f32 va[1], sa[0], s5, va[0]\n"
+        "v_mov_b32 va[0], va[1]\n"
+        "s_endpgm\n");
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>(testName, "good", true, good);
+    AsmRegAllocator regAlloc(assembler, mode);
+    regAlloc.allocateRegisters(0);
+    
+    const AsmRegVar* sa = &assembler.getRegVarMap().find("sa")->second;
+    const Array<cxuint>& regMap = regAlloc.getGraphColorMaps()[REGTYPE_SGPR];
+    const std::vector<size_t>& vidxes = regAlloc.getVregIndexMaps()[REGTYPE_SGPR].
+                find(AsmSingleVReg{ sa, 0 })->second;
+    assertValue(testName, "sa0VarsNum", size_t(2), vidxes.size());
+    assertValue(testName, "sa0Reg", cxuint(5), regMap[vidxes[1]]);
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -3711,5 +4389,28 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    for (size_t i = 0; i < sizeof(applySSAReplacesTestCases1Tbl)/
+                sizeof(AsmApplySSAReplacesCase); i++)
+        try
+        { testApplySSAReplaces(i, applySSAReplacesTestCases1Tbl[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    for (size_t i = 0; i < sizeof(livenessesTestCases1Tbl)/sizeof(AsmLivenessesCase); i++)
+        try
+        { testCreateLivenesses(i, livenessesTestCases1Tbl[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    retVal |= callTest(testRegAllocRealRegs, AsmRegAllocMode::GRAPH_COLORING);
+    retVal |= callTest(testRegAllocRealRegs, AsmRegAllocMode::LINEAR_SCAN);
+    retVal |= callTest(testRegAllocInterGraph, interGraphStraightCode, "straight");
+    retVal |= callTest(testRegAllocInterGraph, interGraphBranchCode, "branch");
+    retVal |= callTest(testRegAllocEqualTo, AsmRegAllocMode::GRAPH_COLORING);
+    retVal |= callTest(testRegAllocEqualTo, AsmRegAllocMode::LINEAR_SCAN);
     return retVal;
 }
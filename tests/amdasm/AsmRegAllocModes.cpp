@@ -0,0 +1,659 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/Containers.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+typedef AsmRegAllocator::LiveBlock LiveBlock;
+
+/* generate chain of scalar regvars: every regvar is read by next instruction and
+ * by instruction in windowSize distance. pairsNum 64-bit regvars are
+ * shifted in chain too. names of regvars begins with prefix */
+static std::string generateChainCode(size_t varsNum, size_t windowSize,
+            size_t pairsNum, const char* prefix = "s")
+{
+    std::ostringstream oss;
+    oss << ".regvar ";
+    for (size_t i = 0; i < varsNum; i++)
+        oss << (i!=0 ? "," : "") << prefix << "a" << i << ":s";
+    for (size_t i = 0; i < pairsNum; i++)
+        oss << "," << prefix << "p" << i << ":s:2";
+    oss << "\n";
+    for (size_t i = 0; i < varsNum; i++)
+    {
+        if (i < 2)
+            oss << "s_mov_b32 " << prefix << "a" << i << ", " << i << "\n";
+        else
+            oss << "s_add_u32 " << prefix << "a" << i << ", " << prefix << "a" <<
+                    (i-1) << ", " << prefix << "a" <<
+                    (i>=windowSize ? i-windowSize : 0) << "\n";
+        if (i < pairsNum)
+        {
+            if (i == 0)
+                oss << "s_mov_b64 " << prefix << "p0[0:1], 0\n";
+            else
+                oss << "s_lshl_b64 " << prefix << "p" << i << "[0:1], " << prefix <<
+                        "p" << (i-1) << "[0:1], " << prefix << "a" << i << "\n";
+        }
+    }
+    if (pairsNum != 0)
+        oss << "s_mov_b64 s[4:5], " << prefix << "p" << (pairsNum-1) << "[0:1]\n";
+    oss << "s_endpgm\n";
+    return oss.str();
+}
+
+// check whether variables that live at this same time have different registers
+static void checkRegAllocation(const AsmRegAllocator& regAlloc, size_t regType,
+            const std::string& testName)
+{
+    const Array<cxuint>& regMap = regAlloc.getGraphColorMaps()[regType];
+    const std::vector<LiveBlock>& liveBlocks = regAlloc.getLiveBlocks()[regType];
+    for (size_t i = 0; i < regMap.size(); i++)
+        if (regMap[i] >= regAlloc.getUsedRegsNum(regType))
+            throw Exception("FAILED for"+testName+": variable not allocated");
+    // live blocks are sorted by start
+    for (size_t i = 0; i < liveBlocks.size(); i++)
+        for (size_t j = i+1; j < liveBlocks.size() &&
+                    liveBlocks[j].start < liveBlocks[i].end; j++)
+            if (liveBlocks[i].vidx != liveBlocks[j].vidx &&
+                regMap[liveBlocks[i].vidx] == regMap[liveBlocks[j].vidx])
+                throw Exception("FAILED for"+testName+": live variables in same register");
+}
+
+static void testRegAllocModes(size_t varsNum, size_t windowSize, size_t pairsNum,
+            cxuint expGraphRegsNum, cxuint expLinearRegsNum)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocModes(" << varsNum << "," << windowSize << "," <<
+                pairsNum << ")";
+    const std::string testName = oss.str();
+    std::istringstream input(generateChainCode(varsNum, windowSize, pairsNum));
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+
+    AsmRegAllocator graphAlloc(assembler);
+    graphAlloc.allocateRegisters(0);
+    assertValue("testRegAllocModes", testName+".graphRegsNum", expGraphRegsNum,
+                graphAlloc.getUsedRegsNum(REGTYPE_SGPR));
+    checkRegAllocation(graphAlloc, REGTYPE_SGPR, testName+".graph");
+
+    AsmRegAllocator linearAlloc(assembler, AsmRegAllocMode::LINEAR_SCAN);
+    linearAlloc.allocateRegisters(0);
+    assertValue("testRegAllocModes", testName+".linearRegsNum", expLinearRegsNum,
+                linearAlloc.getUsedRegsNum(REGTYPE_SGPR));
+    checkRegAllocation(linearAlloc, REGTYPE_SGPR, testName+".linear");
+
+    const Array<cxuint>& regMap = linearAlloc.getGraphColorMaps()[REGTYPE_SGPR];
+    std::unordered_map<AsmSingleVReg, const std::vector<size_t>*> vregs;
+    for (const auto& entry: linearAlloc.getVregIndexMaps()[REGTYPE_SGPR])
+        vregs.insert({ entry.first, &entry.second });
+    for (const auto& entry: vregs)
+    {
+        if (entry.first.regVar == nullptr)
+        {
+            // real registers have own registers
+            assertValue("testRegAllocModes", testName+".realReg", cxuint(entry.first.index),
+                    regMap[(*entry.second)[0]]);
+            continue;
+        }
+        if (entry.first.regVar->size != 2 || entry.first.index != 0)
+            continue;
+        // 64-bit regvars in aligned pair of registers
+        const std::vector<size_t>& vidxes0 = *entry.second;
+        const std::vector<size_t>& vidxes1 = *vregs.find(
+                    AsmSingleVReg{ entry.first.regVar, 1 })->second;
+        for (size_t k = 0; k < vidxes0.size(); k++)
+            if (vidxes0[k] != SIZE_MAX && vidxes1[k] != SIZE_MAX)
+            {
+                if ((regMap[vidxes0[k]] & 1) != 0)
+                    throw Exception("FAILED for"+testName+": unaligned pair");
+                if (regMap[vidxes0[k]]+1 != regMap[vidxes1[k]])
+                    throw Exception("FAILED for"+testName+": not consecutive pair");
+            }
+    }
+}
+
+/* too many live variables at this same time (pairs of registers can not be spilled) */
+static void testRegAllocTooMany(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocTooMany(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    std::ostringstream source;
+    source << ".regvar ";
+    for (size_t i = 0; i < 60; i++)
+        source << (i!=0 ? "," : "") << "sp" << i << ":s:2";
+    source << "\n";
+    for (size_t i = 0; i < 60; i++)
+        source << "s_mov_b64 sp" << i << "[0:1], " << i << "\n";
+    for (size_t i = 0; i < 60; i++)
+        source << "s_and_b64 s[0:1], s[0:1], sp" << i << "[0:1]\n";
+    source << "s_endpgm\n";
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+    AsmRegAllocator regAlloc(assembler, mode);
+    bool tooMany = false;
+    try
+    { regAlloc.allocateRegisters(0); }
+    catch(const AsmException& ex)
+    { tooMany = true; }
+    assertValue<bool>("testRegAllocModes", testName+".tooManyRegs", true, tooMany);
+}
+
+/* allocation for occupancy by assembler: registers must fit to budget for
+ * number of waves (expErrorMessages - error if not fit) */
+static void testRegAllocOccupancy(AsmRegAllocMode mode, cxuint wavesNum,
+            cxuint expAchievedOccupancy, const char* expErrorMessages)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocOccupancy(" << int(mode) << "," << wavesNum << ")";
+    const std::string testName = oss.str();
+    std::ostringstream source;
+    source << ".occupancy " << wavesNum << "\n";
+    if (mode == AsmRegAllocMode::LINEAR_SCAN)
+        source << ".regalloc linear\n";
+    source << generateChainCode(200, 60, 0);
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good",
+                expErrorMessages[0] == 0, good);
+    assertString("testRegAllocModes", testName+".errorMessages",
+                expErrorMessages, errorStream.str());
+    assertValue("testRegAllocModes", testName+".asmOccupancy", wavesNum,
+                assembler.getOccupancy());
+    if (!good)
+        return;
+    AsmRegAllocator regAlloc(assembler);
+    regAlloc.allocateRegisters(0);
+    assertValue("testRegAllocModes", testName+".achievedOccupancy",
+                expAchievedOccupancy, regAlloc.getAchievedOccupancy());
+    checkRegAllocation(regAlloc, REGTYPE_SGPR, testName);
+}
+
+// compare results of two allocations
+static void compareRegAllocs(const AsmRegAllocator& expected,
+            const AsmRegAllocator& result, const std::string& testName)
+{
+    assertValue("testRegAllocModes", testName+".achievedOccupancy",
+                expected.getAchievedOccupancy(), result.getAchievedOccupancy());
+    for (size_t regType = 0; regType < 2; regType++)
+    {
+        assertValue("testRegAllocModes", testName+".usedRegsNum",
+                expected.getUsedRegsNum(regType), result.getUsedRegsNum(regType));
+        const Array<cxuint>& expRegMap = expected.getGraphColorMaps()[regType];
+        assertArray("testRegAllocModes", testName+".regMap", expRegMap,
+                result.getGraphColorMaps()[regType]);
+    }
+}
+
+/* parallel allocation of register types gives this same results as sequential */
+static void testRegAllocParallel(AsmRegAllocMode mode, cxuint wavesNum)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocParallel(" << int(mode) << "," << wavesNum << ")";
+    const std::string testName = oss.str();
+    std::ostringstream source;
+    source << generateChainCode(2500, 60, 20);
+    // some vector registers
+    source << ".regvar va0:v, va1:v\nv_mov_b32 va0, 1\nv_mov_b32 va1, va0\n"
+            "v_add_f32 v0, va0, va1\n";
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+    
+    AsmRegAllocator seqAlloc(assembler, mode);
+    seqAlloc.setOccupancy(wavesNum);
+    seqAlloc.setThreadsNum(1);
+    seqAlloc.allocateRegisters(0);
+    AsmRegAllocator parAlloc(assembler, mode);
+    parAlloc.setOccupancy(wavesNum);
+    parAlloc.setThreadsNum(4);
+    parAlloc.allocateRegisters(0);
+    compareRegAllocs(seqAlloc, parAlloc, testName);
+    checkRegAllocation(parAlloc, REGTYPE_VGPR, testName);
+}
+
+/* allocate registers for kernels concurrently */
+static void testRegAllocSections(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocSections(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    const char* prefixes[3] = { "x", "y", "z" };
+    std::ostringstream source;
+    source << ".amd\n.gpu CapeVerde\n";
+    for (cxuint i = 0; i < 3; i++)
+        source << ".kernel k" << i << "\n.text\n" <<
+                generateChainCode(150+i*50, 40+i*10, i*5, prefixes[i]);
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::AMD,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+    
+    std::vector<cxuint> sectionIds;
+    for (cxuint i = 0; i < assembler.getSections().size(); i++)
+        if (assembler.getSections()[i].type == AsmSectionType::CODE)
+            sectionIds.push_back(i);
+    assertValue("testRegAllocModes", testName+".sectionsNum", size_t(3),
+                sectionIds.size());
+    
+    std::vector<std::unique_ptr<AsmRegAllocator> > regAllocs;
+    std::vector<AsmRegAllocator*> regAllocPtrs;
+    for (size_t i = 0; i < sectionIds.size(); i++)
+    {
+        regAllocs.push_back(std::unique_ptr<AsmRegAllocator>(
+                    new AsmRegAllocator(assembler, mode)));
+        // occupancy limits registers budget
+        regAllocs.back()->setOccupancy(8);
+        regAllocPtrs.push_back(regAllocs.back().get());
+    }
+    AsmRegAllocator::allocateRegisters(sectionIds.size(), regAllocPtrs.data(),
+                sectionIds.data(), 3);
+    for (size_t i = 0; i < sectionIds.size(); i++)
+    {
+        AsmRegAllocator seqAlloc(assembler, mode);
+        seqAlloc.setOccupancy(8);
+        seqAlloc.allocateRegisters(sectionIds[i]);
+        compareRegAllocs(seqAlloc, *regAllocs[i], testName+".section");
+    }
+}
+
+/* statistics of register allocation passes */
+static void testRegAllocTimePasses(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocTimePasses(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    std::istringstream input(generateChainCode(100, 20, 4));
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+    AsmRegAllocator regAlloc(assembler, mode);
+    regAlloc.setTimePasses(true);
+    regAlloc.allocateRegisters(0);
+    const AsmRegAllocStats& stats = regAlloc.getStats();
+#ifdef HAVE_TIME_PASSES
+    assertValue("testRegAllocModes", testName+".codeBlocksNum", size_t(1),
+                stats.codeBlocksNum);
+    // every SSA value have own register
+    const size_t ssaValuesNum = regAlloc.getGraphColorMaps()[REGTYPE_SGPR].size();
+    assertTrue("testRegAllocModes", testName+".ssaValuesNum", ssaValuesNum > 100);
+    assertValue("testRegAllocModes", testName+".ssaValuesNum", ssaValuesNum,
+                stats.ssaValuesNums[REGTYPE_SGPR]);
+    assertValue("testRegAllocModes", testName+".colorsNum",
+                regAlloc.getUsedRegsNum(REGTYPE_SGPR), stats.colorsNums[REGTYPE_SGPR]);
+    if (mode == AsmRegAllocMode::GRAPH_COLORING)
+    {
+        assertValue("testRegAllocModes", testName+".graphNodesNum", ssaValuesNum,
+                    stats.graphNodesNums[REGTYPE_SGPR]);
+        const AsmInterGraph& interGraph = regAlloc.getInterGraphs()[REGTYPE_SGPR];
+        size_t edgesNum = 0;
+        for (size_t a = 0; a < interGraph.size(); a++)
+            for (size_t b = a+1; b < interGraph.size(); b++)
+                if (interGraph.isEdge(a, b))
+                    edgesNum++;
+        assertValue("testRegAllocModes", testName+".graphEdgesNum", edgesNum,
+                    stats.graphEdgesNums[REGTYPE_SGPR]);
+    }
+    assertTrue("testRegAllocModes", testName+".totalTime",
+               stats.totalTime >= stats.ssaDataTime + stats.livenessesTime);
+#else
+    assertTrue("testRegAllocModes", testName+".totalTime", stats.totalTime == 0.0);
+#endif
+    std::ostringstream report;
+    regAlloc.printTimePasses(report);
+    assertTrue("testRegAllocModes", testName+".report",
+               report.str().find("  createSSAData\n") != std::string::npos);
+}
+
+/* statistics of register allocation collected by assembler for time report */
+static void testRegAllocTimeReport(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocTimeReport(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    std::ostringstream source;
+    source << ".occupancy 8\n";
+    if (mode == AsmRegAllocMode::LINEAR_SCAN)
+        source << ".regalloc linear\n";
+    source << generateChainCode(100, 20, 4);
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN|ASM_TIMEREPORT,
+                BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+    const std::vector<AsmRegAllocStats>& statsList = assembler.getRegAllocStats();
+    assertValue("testRegAllocModes", testName+".statsNum", size_t(1), statsList.size());
+    const AsmRegAllocStats& stats = statsList[0];
+    assertValue("testRegAllocModes", testName+".sectionId", cxuint(0), stats.sectionId);
+    assertValue("testRegAllocModes", testName+".mode", int(mode), int(stats.mode));
+    assertValue("testRegAllocModes", testName+".regTypesNum", cxuint(2),
+                stats.regTypesNum);
+#ifdef HAVE_TIME_PASSES
+    assertValue("testRegAllocModes", testName+".codeBlocksNum", size_t(1),
+                stats.codeBlocksNum);
+    assertTrue("testRegAllocModes", testName+".ssaValuesNum",
+               stats.ssaValuesNums[REGTYPE_SGPR] > 100);
+    assertTrue("testRegAllocModes", testName+".regAllocTime",
+               assembler.getTimeReport().regAllocTime >= stats.totalTime);
+#endif
+    std::ostringstream report;
+    assembler.printTimeReport(report);
+    assertTrue("testRegAllocModes", testName+".report",
+               report.str().find("Section .text:\n") != std::string::npos &&
+               report.str().find("  createSSAData\n") != std::string::npos);
+    std::ostringstream jsonReport;
+    assembler.printTimeReportJSON(jsonReport);
+    assertTrue("testRegAllocModes", testName+".jsonReport",
+               jsonReport.str().find("\"section\": \".text\"") != std::string::npos);
+}
+
+// assemble code with real registers (expected result of allocation)
+static std::vector<cxbyte> assembleExpected(const std::string& source,
+            const std::string& testName)
+{
+    std::istringstream input(source);
+    std::ostringstream errorStream;
+    Assembler assembler("expected.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".expectedGood", true, good);
+    return assembler.getSections()[0].content;
+}
+
+/* spilling scalar registers to lanes of vector register: first variables
+ * have lowest number of usages per live time, they are spilled */
+static void testRegAllocSpillSGPRs(AsmRegAllocMode mode)
+{
+    std::ostringstream oss;
+    oss << " testRegAllocSpillSGPRs(" << int(mode) << ")";
+    const std::string testName = oss.str();
+    std::ostringstream source;
+    std::ostringstream expSource;
+    source << ".occupancy 10\n";
+    if (mode == AsmRegAllocMode::LINEAR_SCAN)
+        source << ".regalloc linear\n";
+    source << ".regvar ";
+    for (cxuint i = 0; i < 50; i++)
+        source << (i!=0 ? "," : "") << "sa" << i << ":s";
+    source << "\n";
+    const bool linear = (mode == AsmRegAllocMode::LINEAR_SCAN);
+    // 6 variables are spilled, other variables are in registers s1-s45
+    auto getReg = [linear](cxuint i) { return linear ? i-5 : 51-i; };
+    for (cxuint i = 0; i < 50; i++)
+    {
+        source << "s_mov_b32 sa" << i << ", " << (i+100) << "\n";
+        if (i < 6)
+            expSource << "s_mov_b32 s1, " << (i+100) << "\n"
+                    "v_writelane_b32 v0, s1, " << i << "\n";
+        else
+            expSource << "s_mov_b32 s" << getReg(i) << ", " << (i+100) << "\n";
+    }
+    source << "loop:\n";
+    expSource << "loop:\n";
+    for (cxuint i = 0; i < 50; i++)
+    {
+        source << "s_add_u32 s0, s0, sa" << i << "\n";
+        if (i < 6)
+            expSource << "v_readlane_b32 s" << (linear ? 45 : 1) << ", v0, " << i <<
+                    "\ns_nop 4\ns_add_u32 s0, s0, s" << (linear ? 45 : 1) << "\n";
+        else
+            expSource << "s_add_u32 s0, s0, s" << getReg(i) << "\n";
+    }
+    source << "s_cbranch_scc0 loop\ns_endpgm\n";
+    expSource << "s_cbranch_scc0 loop\ns_endpgm\n";
+    
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good", true, good);
+    assertString("testRegAllocModes", testName+".errorMessages", "",
+                errorStream.str());
+    const std::vector<cxbyte> expContent = assembleExpected(expSource.str(), testName);
+    assertArray("testRegAllocModes", testName+".content", Array<cxbyte>(
+                expContent.begin(), expContent.end()), assembler.getSections()[0].content);
+}
+
+/* spilling vector registers to scratch buffer set by '.spillscratch' */
+static void testRegAllocSpillVGPRs(const char* scratch, const char* expErrorMessages)
+{
+    std::string testName = std::string(" testRegAllocSpillVGPRs(") + scratch + ")";
+    std::ostringstream source;
+    std::ostringstream expSource;
+    source << ".occupancy 10\n" << scratch << "\n.regvar ";
+    for (cxuint i = 0; i < 28; i++)
+        source << (i!=0 ? "," : "") << "va" << i << ":v";
+    source << "\ns_mov_b32 s12, 0\n";
+    expSource << "s_mov_b32 s12, 0\n";
+    /* first value of va0 is not used, va1-va5 are spilled,
+     * other variables are in registers v1 and v2-v23 */
+    for (cxuint i = 0; i < 28; i++)
+    {
+        source << "v_mov_b32 va" << i << ", " << (i+100) << "\n";
+        if (i == 0)
+            expSource << "v_mov_b32 v2, 100\n";
+        else if (i < 6)
+            expSource << "v_mov_b32 v2, " << (i+100) << "\n"
+                "buffer_store_dword v2, v0, s[8:11], s12 offset:" << (12+i*4) << "\n"
+                "s_waitcnt expcnt(0)\n";
+        else
+            expSource << "v_mov_b32 v" << (29-i) << ", " << (i+100) << "\n";
+    }
+    source << "buffer_load_dword va0, v1, s[8:11], 0 offen\n";
+    expSource << "buffer_load_dword v1, v1, s[8:11], 0 offen\n";
+    for (cxuint i = 0; i < 28; i++)
+    {
+        source << "v_add_f32 v0, v0, va" << i << "\n";
+        if (i == 0)
+            expSource << "v_add_f32 v0, v0, v1\n";
+        else if (i < 6)
+            expSource << "buffer_load_dword v1, v0, s[8:11], s12 offset:" <<
+                    (12+i*4) << "\ns_waitcnt vmcnt(0)\nv_add_f32 v0, v0, v1\n";
+        else
+            expSource << "v_add_f32 v0, v0, v" << (29-i) << "\n";
+    }
+    source << "s_endpgm\n";
+    expSource << "s_endpgm\n";
+    
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", testName+".good",
+                expErrorMessages[0] == 0, good);
+    assertString("testRegAllocModes", testName+".errorMessages", expErrorMessages,
+                errorStream.str());
+    if (!good)
+        return;
+    const std::vector<cxbyte> expContent = assembleExpected(expSource.str(), testName);
+    assertArray("testRegAllocModes", testName+".content", Array<cxbyte>(
+                expContent.begin(), expContent.end()), assembler.getSections()[0].content);
+}
+
+/* kernel gets number of registers used by allocator (with spill registers) */
+static void testRegAllocKernelRegs()
+{
+    std::ostringstream source;
+    source << ".amd\n.gpu CapeVerde\n.kernel k0\n.config\n.occupancy 10\n.text\n" <<
+            generateChainCode(200, 60, 0) << ".kernel k1\n.text\ns_endpgm\n";
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::AMD,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", "kernelRegs.good", true, good);
+    const AsmKernel& kernel = assembler.getKernels()[0];
+    assertValue("testRegAllocModes", "kernelRegs.usedSGPRs", cxuint(46),
+                kernel.usedRegsNums[REGTYPE_SGPR]);
+    // lanes of single vector register holds spilled scalar registers
+    assertValue("testRegAllocModes", "kernelRegs.usedVGPRs", cxuint(1),
+                kernel.usedRegsNums[REGTYPE_VGPR]);
+    const AsmKernel& kernel1 = assembler.getKernels()[1];
+    assertValue("testRegAllocModes", "kernelRegs.usedSGPRs1", cxuint(0),
+                kernel1.usedRegsNums[REGTYPE_SGPR]);
+}
+
+/* wrong scratch buffer in pseudo-op */
+static void testSpillScratchPseudoOp()
+{
+    std::istringstream input(".spillscratch s[9:12], s13\n.spillscratch s[8:11], s[12:13]\n"
+            ".spillscratch s[8:11], s12, 4096\n.spillscratch v[8:11], s12\n"
+            ".spillscratch s[8:11], s12, 12\ns_endpgm\n");
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", "spillScratchPseudoOp.good", false, good);
+    assertString("testRegAllocModes", "spillScratchPseudoOp.errorMessages",
+                "test.s:1:15: Error: Expected 4 aligned scalar registers\n"
+                "test.s:2:24: Error: Expected single scalar register\n"
+                "test.s:3:29: Error: Offset out of range (0-4095)\n"
+                "test.s:4:15: Error: Expected 4 aligned scalar registers\n",
+                errorStream.str());
+    const AsmSpillScratch& scratch = assembler.getSpillScratch();
+    assertValue<bool>("testRegAllocModes", "spillScratchPseudoOp.enabled", true,
+                scratch.enabled);
+    assertValue("testRegAllocModes", "spillScratchPseudoOp.srsrc", 8, int(scratch.srsrc));
+    assertValue("testRegAllocModes", "spillScratchPseudoOp.soffset", 12,
+                int(scratch.soffset));
+    assertValue("testRegAllocModes", "spillScratchPseudoOp.offset", 12,
+                int(scratch.offset));
+}
+
+/* wrong occupancy in pseudo-op */
+static void testOccupancyPseudoOp()
+{
+    std::istringstream input(".occupancy 11\ns_endpgm\n");
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", "occupancyPseudoOp.good", false, good);
+    assertString("testRegAllocModes", "occupancyPseudoOp.errorMessages",
+                "test.s:1:12: Error: Occupancy out of range (1-10)\n",
+                errorStream.str());
+}
+
+/* register allocation mode from pseudo-op */
+static void testRegAllocPseudoOp()
+{
+    {
+        std::istringstream input(".regalloc LINEAR\n"
+                ".regvar sa:s:2\ns_mov_b32 sa[0], 1\ns_mov_b32 sa[1], sa[0]\n"
+                "s_mov_b32 s4, sa[1]\ns_endpgm\n");
+        std::ostringstream errorStream;
+        Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN,
+                    BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream);
+        bool good = assembler.assemble();
+        assertValue<bool>("testRegAllocModes", "regAllocPseudoOp.good", true, good);
+        assertValue("testRegAllocModes", "regAllocPseudoOp.asmMode",
+                    int(AsmRegAllocMode::LINEAR_SCAN), int(assembler.getRegAllocMode()));
+        AsmRegAllocator regAlloc(assembler);
+        assertValue("testRegAllocModes", "regAllocPseudoOp.mode",
+                    int(AsmRegAllocMode::LINEAR_SCAN), int(regAlloc.getMode()));
+        regAlloc.allocateRegisters(0);
+        checkRegAllocation(regAlloc, REGTYPE_SGPR, " regAllocPseudoOp");
+    }
+    std::istringstream input(".regalloc coloring\n.regalloc fast\ns_endpgm\n");
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TESTRUN, BinaryFormat::RAWCODE,
+                GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testRegAllocModes", "regAllocPseudoOp2.good", false, good);
+    assertValue("testRegAllocModes", "regAllocPseudoOp2.asmMode",
+                int(AsmRegAllocMode::GRAPH_COLORING), int(assembler.getRegAllocMode()));
+    assertString("testRegAllocModes", "regAllocPseudoOp2.errorMessages",
+                "test.s:2:11: Error: Unknown register allocation mode\n",
+                errorStream.str());
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    try
+    {
+        testRegAllocModes(10, 3, 0, 3, 3);
+        testRegAllocModes(10, 3, 3, 6, 6);
+        testRegAllocModes(300, 16, 40, 18, 18);
+        testRegAllocModes(5000, 40, 0, 40, 40);
+        testRegAllocTooMany(AsmRegAllocMode::GRAPH_COLORING);
+        testRegAllocTooMany(AsmRegAllocMode::LINEAR_SCAN);
+        testRegAllocOccupancy(AsmRegAllocMode::GRAPH_COLORING, 8, 8, "");
+        testRegAllocOccupancy(AsmRegAllocMode::LINEAR_SCAN, 8, 8, "");
+        // scalar registers are spilled to lanes of vector register
+        testRegAllocOccupancy(AsmRegAllocMode::GRAPH_COLORING, 10, 10, "");
+        testRegAllocOccupancy(AsmRegAllocMode::LINEAR_SCAN, 10, 10, "");
+        testRegAllocSpillSGPRs(AsmRegAllocMode::GRAPH_COLORING);
+        testRegAllocSpillSGPRs(AsmRegAllocMode::LINEAR_SCAN);
+        testRegAllocSpillVGPRs(".spillscratch s[8:11], s12, 16", "");
+        testRegAllocSpillVGPRs("", "test.s:1:1: Error: "
+                "Too many VGPRs needed for occupancy 10 (budget is 24 registers)\n");
+        testRegAllocKernelRegs();
+        testRegAllocParallel(AsmRegAllocMode::GRAPH_COLORING, 0);
+        testRegAllocParallel(AsmRegAllocMode::GRAPH_COLORING, 8);
+        testRegAllocParallel(AsmRegAllocMode::LINEAR_SCAN, 8);
+        testRegAllocSections(AsmRegAllocMode::GRAPH_COLORING);
+        testRegAllocSections(AsmRegAllocMode::LINEAR_SCAN);
+        testRegAllocTimePasses(AsmRegAllocMode::GRAPH_COLORING);
+        testRegAllocTimePasses(AsmRegAllocMode::LINEAR_SCAN);
+        testRegAllocTimeReport(AsmRegAllocMode::GRAPH_COLORING);
+        testRegAllocTimeReport(AsmRegAllocMode::LINEAR_SCAN);
+        testOccupancyPseudoOp();
+        testSpillScratchPseudoOp();
+        testRegAllocPseudoOp();
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    return retVal;
+}
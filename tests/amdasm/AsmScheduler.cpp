@@ -0,0 +1,329 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdasm/Assembler.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+struct AsmSchedulerCase
+{
+    const char* input;  // input with '.schedule'
+    const char* expected;   // expected order of instructions
+    size_t blocksNum;
+    size_t scheduledBlocksNum;
+    size_t movedInstrsNum;
+    uint64_t stallCyclesBefore;
+    uint64_t stallCyclesAfter;
+};
+
+static const AsmSchedulerCase schedulerTestCases1Tbl[] =
+{
+    {   /* 0 - move load before independent instructions */
+        R"ffDXD(.rawcode
+        .schedule
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        v_add_f32 v7, v6, v6
+        v_add_f32 v8, v7, v7
+        v_add_f32 v9, v8, v8
+        buffer_load_dword v10, v11, s[4:7], 0 offen
+        v_add_f32 v12, v13, v14
+        v_add_f32 v15, v12, v12
+        v_add_f32 v16, v15, v15
+        v_add_f32 v17, v16, v16
+        v_add_f32 v18, v17, v17
+        v_add_f32 v19, v18, v18
+        s_waitcnt vmcnt(0)
+        v_add_f32 v20, v10, v19
+        s_endpgm
+)ffDXD",
+        R"ffDXD(.rawcode
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        v_add_f32 v7, v6, v6
+        buffer_load_dword v10, v11, s[4:7], 0 offen
+        v_add_f32 v12, v13, v14
+        v_add_f32 v8, v7, v7
+        v_add_f32 v9, v8, v8
+        v_add_f32 v15, v12, v12
+        v_add_f32 v16, v15, v15
+        v_add_f32 v17, v16, v16
+        v_add_f32 v18, v17, v17
+        v_add_f32 v19, v18, v18
+        s_waitcnt vmcnt(0)
+        v_add_f32 v20, v10, v19
+        s_endpgm
+)ffDXD", 2, 1, 4, 396, 380
+    },
+    {   /* 1 - labels, jumps and '.noschedule' region */
+        R"ffDXD(.rawcode
+        .schedule
+        s_mov_b32 s0, 1
+        s_mov_b32 s1, 2
+        s_mov_b32 s2, 3
+        s_mov_b32 s3, 4
+        s_mov_b32 s8, 4
+        s_mov_b32 s9, 4
+loop:
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        v_add_f32 v7, v6, v6
+        v_add_f32 v8, v7, v7
+        v_add_f32 v9, v8, v8
+        s_load_dword s10, s[2:3], 0
+        v_add_f32 v12, v13, v14
+        v_add_f32 v15, v12, v12
+        v_add_f32 v16, v15, v15
+        v_add_f32 v17, v16, v16
+        v_add_f32 v18, v17, v17
+        v_add_f32 v19, v18, v18
+        v_add_f32 v21, v19, v18
+        s_waitcnt lgkmcnt(0)
+        s_sub_u32 s10, s10, 1
+        s_cbranch_scc1 loop
+        .noschedule
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        v_add_f32 v7, v6, v6
+        v_add_f32 v8, v7, v7
+        v_add_f32 v9, v8, v8
+        buffer_load_dword v10, v11, s[4:7], 0 offen
+        v_add_f32 v12, v13, v14
+        s_endpgm
+)ffDXD",
+        R"ffDXD(.rawcode
+        s_mov_b32 s0, 1
+        s_mov_b32 s1, 2
+        s_mov_b32 s2, 3
+        s_mov_b32 s3, 4
+        s_mov_b32 s8, 4
+        s_mov_b32 s9, 4
+loop:
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        v_add_f32 v7, v6, v6
+        s_load_dword s10, s[2:3], 0
+        v_add_f32 v12, v13, v14
+        v_add_f32 v8, v7, v7
+        v_add_f32 v15, v12, v12
+        v_add_f32 v9, v8, v8
+        v_add_f32 v16, v15, v15
+        v_add_f32 v17, v16, v16
+        v_add_f32 v18, v17, v17
+        v_add_f32 v19, v18, v18
+        v_add_f32 v21, v19, v18
+        s_waitcnt lgkmcnt(0)
+        s_sub_u32 s10, s10, 1
+        s_cbranch_scc1 loop
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        v_add_f32 v7, v6, v6
+        v_add_f32 v8, v7, v7
+        v_add_f32 v9, v8, v8
+        buffer_load_dword v10, v11, s[4:7], 0 offen
+        v_add_f32 v12, v13, v14
+        s_endpgm
+)ffDXD", 3, 1, 5, 56, 40
+    },
+    {   /* 2 - dependent chain, nothing to do */
+        R"ffDXD(.rawcode
+        .schedule
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        s_endpgm
+)ffDXD",
+        R"ffDXD(.rawcode
+        v_add_f32 v1, v2, v3
+        v_mul_f32 v4, v1, v1
+        v_add_f32 v5, v4, v4
+        v_add_f32 v6, v5, v5
+        s_endpgm
+)ffDXD", 1, 0, 0, 16, 16
+    },
+    {   /* 3 - buffer load moved before LDS read (different memory and counter) */
+        R"ffDXD(.rawcode
+        .schedule
+        v_add_f32 v20, v21, v21
+        v_add_f32 v22, v20, v20
+        v_add_f32 v23, v22, v22
+        v_add_f32 v24, v23, v23
+        v_add_f32 v25, v24, v24
+        ds_read_b32 v1, v2
+        v_add_f32 v3, v1, v1
+        v_add_f32 v4, v3, v3
+        buffer_load_dword v10, v11, s[4:7], 0 offen
+        v_mul_f32 v12, v10, v10
+        v_add_f32 v30, v31, v31
+        v_add_f32 v32, v30, v30
+        v_add_f32 v33, v32, v32
+        v_add_f32 v34, v33, v33
+        v_add_f32 v35, v34, v34
+        s_endpgm
+)ffDXD",
+        R"ffDXD(.rawcode
+        v_add_f32 v20, v21, v21
+        v_add_f32 v22, v20, v20
+        v_add_f32 v23, v22, v22
+        v_add_f32 v24, v23, v23
+        v_add_f32 v25, v24, v24
+        buffer_load_dword v10, v11, s[4:7], 0 offen
+        ds_read_b32 v1, v2
+        v_add_f32 v3, v1, v1
+        v_add_f32 v4, v3, v3
+        v_mul_f32 v12, v10, v10
+        v_add_f32 v30, v31, v31
+        v_add_f32 v32, v30, v30
+        v_add_f32 v33, v32, v32
+        v_add_f32 v34, v33, v33
+        v_add_f32 v35, v34, v34
+        s_endpgm
+)ffDXD", 1, 1, 4, 496, 420
+    },
+    {   /* 4 - LDS read can not pass LDS write */
+        R"ffDXD(.rawcode
+        .schedule
+        v_add_f32 v20, v21, v21
+        v_add_f32 v22, v20, v20
+        v_add_f32 v23, v22, v22
+        v_add_f32 v24, v23, v23
+        v_add_f32 v25, v24, v24
+        ds_write_b32 v1, v2
+        v_add_f32 v3, v1, v1
+        v_add_f32 v4, v3, v3
+        ds_read_b32 v10, v11
+        v_mul_f32 v12, v10, v10
+        v_add_f32 v30, v31, v31
+        v_add_f32 v32, v30, v30
+        v_add_f32 v33, v32, v32
+        v_add_f32 v34, v33, v33
+        v_add_f32 v35, v34, v34
+        s_endpgm
+)ffDXD",
+        R"ffDXD(.rawcode
+        v_add_f32 v20, v21, v21
+        v_add_f32 v22, v20, v20
+        v_add_f32 v23, v22, v22
+        v_add_f32 v24, v23, v23
+        v_add_f32 v25, v24, v24
+        ds_write_b32 v1, v2
+        ds_read_b32 v10, v11
+        v_add_f32 v3, v1, v1
+        v_add_f32 v4, v3, v3
+        v_mul_f32 v12, v10, v10
+        v_add_f32 v30, v31, v31
+        v_add_f32 v32, v30, v30
+        v_add_f32 v33, v32, v32
+        v_add_f32 v34, v33, v33
+        v_add_f32 v35, v34, v34
+        s_endpgm
+)ffDXD", 1, 1, 3, 100, 88
+    }
+};
+
+static std::vector<cxbyte> assembleCode(const char* source, const std::string& testName,
+            Assembler** asmOut = nullptr)
+{
+    std::istringstream input(source);
+    std::ostringstream errorStream;
+    Assembler* assembler = new Assembler("test.s", input, ASM_ALL&~ASM_ALTMACRO,
+                    BinaryFormat::RAWCODE, GPUDeviceType::PITCAIRN, errorStream);
+    bool good = assembler->assemble();
+    assertValue<bool>("testAsmScheduler", testName+".good", true, good);
+    assertString("testAsmScheduler", testName+".errorMessages", "",
+                 errorStream.str());
+    std::vector<cxbyte> content = assembler->getSections()[0].content;
+    if (asmOut != nullptr)
+        *asmOut = assembler;
+    else
+        delete assembler;
+    return content;
+}
+
+static void testAsmScheduler(cxuint i, const AsmSchedulerCase& testCase)
+{
+    std::ostringstream oss;
+    oss << " testAsmSchedulerCase#" << i;
+    const std::string testCaseName = oss.str();
+    Assembler* assembler = nullptr;
+    const std::vector<cxbyte> result = assembleCode(testCase.input, testCaseName,
+                    &assembler);
+    std::unique_ptr<Assembler> assemblerPtr(assembler);
+    const std::vector<cxbyte> expected = assembleCode(testCase.expected,
+                    testCaseName+".expected");
+
+    assertValue("testAsmScheduler", testCaseName+".size", expected.size(), result.size());
+    for (size_t j = 0; j < expected.size(); j++)
+    {
+        std::ostringstream byteOss;
+        byteOss << testCaseName << ".content[" << j << "]";
+        assertValue("testAsmScheduler", byteOss.str(), cxuint(expected[j]),
+                    cxuint(result[j]));
+    }
+    const std::vector<AsmScheduleStats>& stats = assembler->getScheduleStats();
+    assertValue("testAsmScheduler", testCaseName+".statsSize", size_t(1), stats.size());
+    assertValue("testAsmScheduler", testCaseName+".blocksNum",
+                testCase.blocksNum, stats[0].blocksNum);
+    assertValue("testAsmScheduler", testCaseName+".scheduledBlocksNum",
+                testCase.scheduledBlocksNum, stats[0].scheduledBlocksNum);
+    assertValue("testAsmScheduler", testCaseName+".movedInstrsNum",
+                testCase.movedInstrsNum, stats[0].movedInstrsNum);
+    assertValue("testAsmScheduler", testCaseName+".stallCyclesBefore",
+                testCase.stallCyclesBefore, stats[0].stallCyclesBefore);
+    assertValue("testAsmScheduler", testCaseName+".stallCyclesAfter",
+                testCase.stallCyclesAfter, stats[0].stallCyclesAfter);
+    if (stats[0].scheduledBlocksNum != 0 &&
+        stats[0].stallCyclesAfter >= stats[0].stallCyclesBefore)
+        throw Exception("FAILED for"+testCaseName+": no stall cycles removed");
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (size_t i = 0; i < sizeof(schedulerTestCases1Tbl)/sizeof(AsmSchedulerCase); i++)
+        try
+        { testAsmScheduler(i, schedulerTestCases1Tbl[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
@@ -154,6 +154,68 @@ static void testAssembler(cxuint testId, const AsmTestCase& testCase)
     assertString(testName, "printMessages", testCase.printMessages, printMsgs);
 }
 
+static const char* timeReportTestInput = R"ffDXD(
+        .macro addtwo a
+            .int \a, \a+1
+        .endm
+        .rept 3
+            .byte 1
+        .endr
+        .irp x, 1, 2
+            addtwo \x
+        .endr
+        .for i = 0, i < 2, i+1
+            .short i
+        .endr
+        s_mov_b32 s0, s1
+        s_add_u32 s2, s3, 4
+        v_add_f32 v1, v2, v3
+)ffDXD";
+
+static void testTimeReport()
+{
+    std::istringstream input(timeReportTestInput);
+    std::ostringstream errorStream;
+    std::ostringstream printStream;
+    Assembler assembler("test.s", input, ASM_ALL|ASM_TIMEREPORT,
+            BinaryFormat::RAWCODE, GPUDeviceType::CAPE_VERDE, errorStream, printStream);
+    assertTrue("TimeReport", "good", assembler.assemble());
+    assertTrue("TimeReport", "timeReporting", assembler.isTimeReporting());
+    Array<cxbyte> output;
+    assembler.writeBinary(output);
+    
+    const AsmTimeReport& report = assembler.getTimeReport();
+    assertValue("TimeReport", "linesNum", uint64_t(17), report.linesNum);
+    assertValue("TimeReport", "instrsNum", uint64_t(3), report.instrsNum);
+    assertValue("TimeReport", "pseudoOpsNum", uint64_t(11), report.pseudoOpsNum);
+    assertValue("TimeReport", "macroSubstsNum", uint64_t(2), report.macroSubstsNum);
+    assertValue("TimeReport", "repetitionsNum", uint64_t(7), report.repetitionsNum);
+    assertValue("TimeReport", "expressionsNum", uint64_t(4), report.expressionsNum);
+    assertValue("TimeReport", "relocationsNum", uint64_t(0), report.relocationsNum);
+#ifdef HAVE_TIME_PASSES
+    assertTrue("TimeReport", "totalTime", report.totalTime > 0.0);
+    assertTrue("TimeReport", "totalTime>=phases", report.totalTime >=
+            report.pseudoOpsTime + report.encodingTime);
+#endif
+    
+    std::ostringstream jsonOss;
+    assembler.printTimeReportJSON(jsonOss);
+    const std::string json = jsonOss.str();
+    assertTrue("TimeReport", "json.times", json.find("\"times\": {") != std::string::npos);
+    assertTrue("TimeReport", "json.repetitions",
+               json.find("\"repetitions\": 7") != std::string::npos);
+    
+    // disabled time report: counters are collected, times are zero
+    std::istringstream input2(timeReportTestInput);
+    Assembler assembler2("test.s", input2, ASM_ALL, BinaryFormat::RAWCODE,
+            GPUDeviceType::CAPE_VERDE, errorStream, printStream);
+    assertTrue("TimeReport", "good2", assembler2.assemble());
+    assertTrue("TimeReport", "timeReporting2", !assembler2.isTimeReporting());
+    assertValue("TimeReport", "instrsNum2", uint64_t(3),
+                assembler2.getTimeReport().instrsNum);
+    assertTrue("TimeReport", "totalTime2", assembler2.getTimeReport().totalTime == 0.0);
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -173,5 +235,12 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    try
+    { testTimeReport(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
     return retVal;
 }
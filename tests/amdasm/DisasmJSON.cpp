@@ -0,0 +1,179 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <CLRX/utils/MemAccess.h>
+#include <CLRX/amdbin/ROCmBinaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+#include <CLRX/amdasm/Disassembler.h>
+
+using namespace CLRX;
+
+static const uint32_t rawCode1[5] =
+{
+    LEV(0xbe8503ffU), LEV(0x1234U), // s_mov_b32 s5, 0x1234
+    LEV(0x06060a04U), // v_add_f32 v3, s4, v5
+    LEV(0xd2060103U), LEV(0x20020a04U), // v_add_f32 v3, -|s4|, v5 (VOP3)
+};
+
+static const uint32_t galliumCode1[6] =
+{
+    LEV(0x06060a04U), // v_add_f32 v3, s4, v5
+    LEV(0xbf810000U), // s_endpgm
+    LEV(0xe0701000U), LEV(0x03030702U), // buffer_store_dword v7, v2, s[12:15], s3 offen
+    LEV(0xbf8c0f70U), // s_waitcnt vmcnt(0)
+    LEV(0xbf810000U)  // s_endpgm
+};
+
+static const GalliumDisasmInput galliumJSONInput =
+{
+    GPUDeviceType::PITCAIRN, false, false, false, false,
+    0, nullptr,
+    {
+        { "kernel1", { { 0xb848, 0xc0000 }, { 0xb84c, 0x1788 }, { 0xb860, 0 } },
+          8, { } },
+        { "kernel0", { { 0xb848, 0xc0001 }, { 0xb84c, 0x1789 }, { 0xb860, 1 } },
+          0, { } }
+    },
+    sizeof(galliumCode1), reinterpret_cast<const cxbyte*>(galliumCode1), { }
+};
+
+struct DisasmJSONTestCase
+{
+    const GalliumDisasmInput* galliumInput;
+    size_t rawCodeSize;
+    const uint32_t* rawCode;
+    GPUDeviceType deviceType;
+    const char* expectedString;
+};
+
+static const DisasmJSONTestCase disasmJSONTestCases[] =
+{
+    {   // raw code
+        nullptr, sizeof(rawCode1), rawCode1, GPUDeviceType::PITCAIRN,
+        R"ffDXD({"type":"binary","format":"rawcode","gpu":"Pitcairn","arch":"GCN1.0"}
+{"type":"section","index":0,"name":".text","size":20}
+{"type":"insn","section":0,"offset":0,"size":8,"encoding":"SOP1","mnemonic":"s_mov_b32","opcode":3,"operands":[{"op":"s5","access":"w"},{"op":"0x1234","access":"r"}],"literal":4660}
+{"type":"insn","section":0,"offset":8,"size":4,"encoding":"VOP2","mnemonic":"v_add_f32","opcode":3,"operands":[{"op":"v3","access":"w"},{"op":"s4","access":"r"},{"op":"v5","access":"r"}]}
+{"type":"insn","section":0,"offset":12,"size":8,"encoding":"VOP3A","mnemonic":"v_add_f32","opcode":259,"operands":[{"op":"v3","access":"w"},{"op":"s4","access":"r","neg":true,"abs":true},{"op":"v5","access":"r"}]}
+)ffDXD" },
+    {   // gallium (kernels in other order than in code)
+        &galliumJSONInput, 0, nullptr, GPUDeviceType::PITCAIRN,
+        R"ffDXD({"type":"binary","format":"gallium","gpu":"Pitcairn","arch":"GCN1.0","64bit":false,"llvm390":false,"mesa170":false,"amdhsa":false}
+{"type":"kernel","index":0,"name":"kernel1","offset":8,"size":16,"progInfo":[{"address":47176,"value":786432},{"address":47180,"value":6024},{"address":47200,"value":0}]}
+{"type":"kernel","index":1,"name":"kernel0","offset":0,"size":8,"progInfo":[{"address":47176,"value":786433},{"address":47180,"value":6025},{"address":47200,"value":1}]}
+{"type":"section","index":0,"name":".text","size":24}
+{"type":"insn","section":0,"kernel":1,"offset":0,"size":4,"encoding":"VOP2","mnemonic":"v_add_f32","opcode":3,"operands":[{"op":"v3","access":"w"},{"op":"s4","access":"r"},{"op":"v5","access":"r"}]}
+{"type":"insn","section":0,"kernel":1,"offset":4,"size":4,"encoding":"SOPP","mnemonic":"s_endpgm","opcode":1,"operands":[]}
+{"type":"insn","section":0,"kernel":0,"offset":8,"size":8,"encoding":"MUBUF","mnemonic":"buffer_store_dword","opcode":28,"operands":[{"op":"v7","access":"r"},{"op":"v2","access":"r"},{"op":"s[12:15]","access":"r"},{"op":"s3","access":"r"}],"modifiers":["offen"]}
+{"type":"insn","section":0,"kernel":0,"offset":16,"size":4,"encoding":"SOPP","mnemonic":"s_waitcnt","opcode":12,"operands":[],"imm":3952}
+{"type":"insn","section":0,"kernel":0,"offset":20,"size":4,"encoding":"SOPP","mnemonic":"s_endpgm","opcode":1,"operands":[]}
+)ffDXD" }
+};
+
+static void testDisasmJSON(cxuint testId, const DisasmJSONTestCase& testCase)
+{
+    std::ostringstream disasmOss;
+    if (testCase.galliumInput != nullptr)
+    {
+        Disassembler disasm(testCase.galliumInput, disasmOss,
+                    DISASM_DUMPCODE | DISASM_JSON);
+        disasm.disassemble();
+    }
+    else
+    {
+        Disassembler disasm(testCase.deviceType, testCase.rawCodeSize,
+                reinterpret_cast<const cxbyte*>(testCase.rawCode), disasmOss,
+                DISASM_DUMPCODE | DISASM_JSON);
+        disasm.disassemble();
+    }
+    const std::string resultStr = disasmOss.str();
+    if (::strcmp(testCase.expectedString, resultStr.c_str()) != 0)
+    {
+        // print error
+        std::ostringstream oss;
+        oss << "Failed for #" << testId << std::endl;
+        oss << resultStr << std::endl;
+        throw Exception(oss.str());
+    }
+}
+
+// expected beginnings of first lines for ROCm binary
+static const char* rocmFijiExpectedLines[] =
+{
+    R"ffDXD({"type":"binary","format":"rocm","gpu":"Fiji","arch":"GCN1.2",)ffDXD",
+    R"ffDXD({"type":"kernel","index":0,"name":"test1","offset":0,"size":396,)ffDXD"
+        R"ffDXD("config":{"codeVersion":[1,0],"machine":[1,8,0,3],)ffDXD",
+    R"ffDXD({"type":"kernel","index":1,"name":"test2","offset":512,"size":396,)ffDXD",
+    R"ffDXD({"type":"section","index":0,"name":".text","size":1036})ffDXD",
+    R"ffDXD({"type":"insn","section":0,"kernel":0,"offset":256,"size":8,)ffDXD"
+        R"ffDXD("encoding":"SMEM","mnemonic":"s_load_dword","opcode":0,)ffDXD"
+        R"ffDXD("operands":[{"op":"s2","access":"w"},{"op":"s[4:5]","access":"r"}],)ffDXD"
+        R"ffDXD("imm":4,"modifiers":["imm_offset"]})ffDXD",
+    nullptr
+};
+
+// check records of ROCm binary from file
+static void testDisasmJSONROCmFile(const char* filename, const char** expectedLines)
+{
+    Array<cxbyte> binaryData = loadDataFromFile(filename);
+    ROCmBinary rocmBin(binaryData.size(), binaryData.data(), 0);
+    std::ostringstream disasmOss;
+    Disassembler disasm(rocmBin, disasmOss, DISASM_DUMPCODE | DISASM_JSON);
+    disasm.disassemble();
+    std::istringstream iss(disasmOss.str());
+    std::string line;
+    size_t lineNo = 0;
+    for (const char** expLine = expectedLines; *expLine != nullptr; expLine++, lineNo++)
+    {
+        std::getline(iss, line);
+        if (line.compare(0, ::strlen(*expLine), *expLine) != 0)
+        {
+            std::ostringstream oss;
+            oss << "Failed for '" << filename << "' at line " << lineNo << ": " << line;
+            throw Exception(oss.str());
+        }
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (cxuint i = 0; i < sizeof(disasmJSONTestCases)/sizeof(DisasmJSONTestCase); i++)
+        try
+        { testDisasmJSON(i, disasmJSONTestCases[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    try
+    { testDisasmJSONROCmFile(CLRX_SOURCE_DIR "/tests/amdasm/amdbins/rocm-fiji.hsaco",
+                rocmFijiExpectedLines); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    return retVal;
+}
@@ -0,0 +1,180 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdbin/AmdBinaries.h>
+#include <CLRX/amdbin/AmdCL2Binaries.h>
+#include <CLRX/amdbin/ROCmBinaries.h>
+#include <CLRX/amdbin/GalliumBinaries.h>
+#include <CLRX/amdasm/Disassembler.h>
+
+using namespace CLRX;
+
+static const char* disasmOutputTestFiles[] =
+{
+    "/tests/amdasm/amdbins/samplekernels.clo",
+    "/tests/amdasm/amdbins/amdcl2.clo",
+    "/tests/amdasm/amdbins/rocm-fiji.hsaco",
+    "/tests/amdasm/amdbins/gallium1.clo"
+};
+
+// disassemble binary (AMD, AMD OpenCL 2.0, ROCm or Gallium) to output stream or sink
+template<typename Output>
+static void disassembleBinary(Array<cxbyte>& binaryData, Output& output,
+            cxuint threadsNum)
+{
+    const Flags disasmFlags = DISASM_ALL & ~DISASM_CODEPOS;
+    const Flags binFlags = AMDBIN_CREATE_KERNELINFO | AMDBIN_CREATE_KERNELINFOMAP |
+            AMDBIN_CREATE_INNERBINMAP | AMDBIN_CREATE_KERNELHEADERS |
+            AMDBIN_CREATE_KERNELHEADERMAP | AMDBIN_INNER_CREATE_CALNOTES |
+            AMDBIN_CREATE_INFOSTRINGS;
+    std::unique_ptr<AmdMainBinaryBase> base;
+    if (isAmdBinary(binaryData.size(), binaryData.data()))
+    {
+        base.reset(createAmdBinaryFromCode(binaryData.size(), binaryData.data(),
+                    binFlags));
+        Disassembler disasm(*static_cast<AmdMainGPUBinary32*>(base.get()), output,
+                    disasmFlags);
+        disasm.setThreadsNum(threadsNum);
+        disasm.disassemble();
+    }
+    else if (isAmdCL2Binary(binaryData.size(), binaryData.data()))
+    {
+        base.reset(createAmdCL2BinaryFromCode(binaryData.size(), binaryData.data(),
+                    binFlags | AMDCL2BIN_INNER_CREATE_KERNELDATA |
+                    AMDCL2BIN_INNER_CREATE_KERNELDATAMAP |
+                    AMDCL2BIN_INNER_CREATE_KERNELSTUBS));
+        Disassembler disasm(*static_cast<AmdCL2MainGPUBinary64*>(base.get()), output,
+                    disasmFlags);
+        disasm.setThreadsNum(threadsNum);
+        disasm.disassemble();
+    }
+    else if (isROCmBinary(binaryData.size(), binaryData.data()))
+    {
+        ROCmBinary rocmBin(binaryData.size(), binaryData.data(), 0);
+        Disassembler disasm(rocmBin, output, disasmFlags);
+        disasm.setThreadsNum(threadsNum);
+        disasm.disassemble();
+    }
+    else
+    {
+        GalliumBinary galliumBin(binaryData.size(), binaryData.data(), 0);
+        Disassembler disasm(GPUDeviceType::PITCAIRN, galliumBin, output, disasmFlags);
+        disasm.setThreadsNum(threadsNum);
+        disasm.disassemble();
+    }
+}
+
+static void appendToString(size_t size, const char* data, void* userData)
+{
+    static_cast<std::string*>(userData)->append(data, size);
+}
+
+static void checkOutput(const char* filename, const char* sinkName, size_t bufSize,
+            cxuint threadsNum, const std::string& expected, const std::string& result)
+{
+    if (expected != result)
+    {
+        std::ostringstream oss;
+        oss << "Failed for '" << filename << "' with " << sinkName <<
+                " (buffer " << bufSize << ", threads " << threadsNum << ")";
+        throw Exception(oss.str());
+    }
+}
+
+static void testDisasmOutput(const char* filename)
+{
+    Array<cxbyte> binaryData = loadDataFromFile(filename);
+    std::ostringstream expectedOss;
+    disassembleBinary(binaryData, expectedOss, 1);
+    const std::string expected = expectedOss.str();
+    
+    for (cxuint threadsNum = 1; threadsNum <= 4; threadsNum += 3)
+    {
+        // memory output (disassembler writes directly to sink)
+        DisasmMemoryOutput memOutput(600);
+        disassembleBinary(binaryData, memOutput, threadsNum);
+        checkOutput(filename, "memory", 0, threadsNum, expected,
+                    std::string(memOutput.data(), memOutput.size()));
+        // callback output
+        std::string callbackResult;
+        DisasmCallbackOutput callbackOutput(appendToString, &callbackResult);
+        disassembleBinary(binaryData, callbackOutput, threadsNum);
+        checkOutput(filename, "callback", 0, threadsNum, expected, callbackResult);
+    }
+    
+    const size_t bufSizes[5] = { 0, 1, 7, 600, DisasmOutputStream::defaultBufferSize };
+    for (size_t bufSize: bufSizes)
+    {
+        // output stream that writes to memory sink
+        DisasmMemoryOutput memOutput(bufSize);
+        {
+            DisasmOutputStream os(memOutput, bufSize);
+            disassembleBinary(binaryData, os, 4);
+        }
+        checkOutput(filename, "stream", bufSize, 4, expected,
+                    std::string(memOutput.data(), memOutput.size()));
+        
+        // file descriptor output
+        FILE* file = ::tmpfile();
+        if (file == nullptr)
+            throw Exception("Can't create temporary file");
+        std::string fileResult;
+        try
+        {
+            {
+                DisasmFileOutput fileOutput(::fileno(file), bufSize);
+                disassembleBinary(binaryData, fileOutput, 1);
+            }
+            ::rewind(file);
+            char buf[4096];
+            size_t readSize;
+            while ((readSize = ::fread(buf, 1, sizeof(buf), file)) != 0)
+                fileResult.append(buf, readSize);
+        }
+        catch(...)
+        {
+            ::fclose(file);
+            throw;
+        }
+        ::fclose(file);
+        checkOutput(filename, "file", bufSize, 1, expected, fileResult);
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    for (const char* filename: disasmOutputTestFiles)
+        try
+        { testDisasmOutput((std::string(CLRX_SOURCE_DIR) + filename).c_str()); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+    return retVal;
+}
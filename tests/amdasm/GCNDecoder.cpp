@@ -0,0 +1,362 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GCNEncoding.h>
+#include <CLRX/amdasm/Disassembler.h>
+#include <CLRX/utils/MemAccess.h>
+#include "../TestUtils.h"
+#include "GCNDisasmOpc.h"
+
+using namespace CLRX;
+
+// get register operand in form used by disassembler (empty if not simple register)
+static std::string getRegOperandString(const GCNDecodedOperand& op)
+{
+    cxuint code = op.code;
+    char prefix = 's';
+    if (code >= 256)
+    {
+        prefix = 'v';
+        code -= 256;
+    }
+    else if (code >= 102)
+        return "";
+    std::ostringstream oss;
+    if (op.regsNum == 1)
+        oss << prefix << code;
+    else
+        oss << prefix << '[' << code << ':' << ((code + op.regsNum-1) & 255) << ']';
+    return oss.str();
+}
+
+// check whether decoded instruction matches to text line from disassembler
+// if decoder given, then all operands (not only registers) are checked
+static void checkDecodedInstr(const std::string& caseName, const GCNDecodedInstr& instr,
+            const char* expected, const GCNDecoder* decoder = nullptr)
+{
+    // get mnemonic from expected text
+    while (*expected == ' ')
+        expected++;
+    const char* mnemEnd = expected;
+    while (*mnemEnd != ' ' && *mnemEnd != '\n' && *mnemEnd != 0)
+        mnemEnd++;
+    const std::string expMnemonic(expected, mnemEnd);
+
+    if (expMnemonic == ".int")
+    {
+        assertValue("GCNDecoder", caseName+".encoding", cxuint(GCNENC_NONE),
+                    cxuint(instr.encoding));
+        return;
+    }
+    if (expMnemonic.find("_ill_") != std::string::npos)
+    {
+        assertValue("GCNDecoder", caseName+".illegal", cxuint(GCNDecodedIllegal),
+                    cxuint(instr.mnemonicId));
+        return;
+    }
+    const char* mnemonic = GCNDecoder::getMnemonic(instr.mnemonicId);
+    assertTrue("GCNDecoder", caseName+".mnemonic", mnemonic != nullptr);
+    assertString("GCNDecoder", caseName+".mnemonic", expMnemonic.c_str(), mnemonic);
+
+    // all register operands should be present in text
+    const std::string operandsText(mnemEnd);
+    for (cxuint k = 0; k < instr.operandsNum; k++)
+    {
+        std::string regStr;
+        if (decoder != nullptr)
+        {
+            char buf[32];
+            regStr.assign(buf, decoder->printOperand(instr, k, buf));
+        }
+        else
+            regStr = getRegOperandString(instr.operands[k]);
+        if (regStr.empty())
+            continue;
+        // small literal can be printed also in lit() form
+        std::string litStr;
+        if (instr.operands[k].code == 255)
+        {
+            std::ostringstream litOss;
+            litOss << "lit(" << int32_t(instr.literal) << ")";
+            litStr = litOss.str();
+        }
+        bool found = false;
+        for (const std::string& str: { regStr, litStr })
+            for (size_t p = operandsText.find(str); !str.empty() && !found &&
+                        p != std::string::npos; p = operandsText.find(str, p+1))
+            {
+                const char next = operandsText[p+str.size()];
+                const char prev = operandsText[p-1];
+                if (!isAlnum(next) && next != '_' && next != ':' && next != '.' &&
+                    prev != '_' && !isAlnum(prev))
+                    found = true;
+            }
+        std::ostringstream oss;
+        oss << caseName << ".operand#" << k << " " << regStr;
+        assertTrue("GCNDecoder", oss.str(), found);
+    }
+}
+
+// check whether decoded instruction matches to text from disassembler
+static void testDecodeOpcodeCase(cxuint i, const GCNDisasmOpcodeCase& testCase,
+                      GPUArchitecture arch)
+{
+    std::ostringstream caseOss;
+    caseOss << getGPUArchitectureName(arch) << " decGCNCase#" << i;
+    const std::string caseName = caseOss.str();
+
+    const uint32_t inputCode[2] = { LEV(testCase.word0), LEV(testCase.word1) };
+    const GCNDecoder decoder(arch);
+    GCNDecodedInstr instr;
+    const size_t codeSize = testCase.twoWords ? 8 : 4;
+    const size_t nextPos = decoder.decode(codeSize,
+                reinterpret_cast<const cxbyte*>(inputCode), 0, instr);
+    assertValue("GCNDecoder", caseName+".nextPos", size_t(instr.wordsNum)<<2, nextPos);
+    checkDecodedInstr(caseName, instr, testCase.expected);
+}
+
+static void testDecodeOpcodeCases(const GCNDisasmOpcodeCase* cases, GPUArchitecture arch,
+            int& retVal)
+{
+    for (cxuint i = 0; cases[i].expected!=nullptr; i++)
+        try
+        { testDecodeOpcodeCase(i, cases[i], arch); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
+}
+
+static uint32_t nextRandom(uint32_t& state)
+{
+    state = state*1103515245U + 12345U;
+    return state ^ (state>>16);
+}
+
+static const GPUDeviceType archDeviceTypes[4] =
+{ GPUDeviceType::PITCAIRN, GPUDeviceType::BONAIRE, GPUDeviceType::FIJI,
+  GPUDeviceType::GFX900 };
+
+/* compare decoder with text disassembler over whole encoding space:
+ * every value of upper half of first word (encoding and opcode of all encodings)
+ * with random rest of fields. opcodes of SOP1 and VOP1 (in lower half) are
+ * swept separately. instructions are disassembled in chunks by text disassembler
+ * and decoder, both must give same instruction boundaries and mnemonics */
+static void testDecodeEncodingSpace(GPUArchitecture arch, cxuint variantsNum, int& retVal)
+{
+    const GCNDecoder decoder(arch);
+    const GPUDeviceType deviceType = archDeviceTypes[cxuint(arch)];
+    uint32_t state = 1234567U + cxuint(arch);
+    std::vector<uint32_t> code;
+    std::vector<GCNDecodedInstr> instrs;
+    cxuint failsNum = 0;
+    // chunk - all instructions with same highest byte of first word
+    for (uint32_t high = 0; high < 256 && failsNum < 10; high++)
+    {
+        code.clear();
+        instrs.clear();
+        size_t pos = 0;
+        for (uint32_t mid = 0; mid < 256; mid++)
+            for (cxuint v = 0; v < variantsNum; v++)
+            {
+                uint32_t word0 = (high<<24) | (mid<<16) | (nextRandom(state) & 0xffff);
+                const cxuint sweep = ((mid*variantsNum + v) & 0xff);
+                if ((word0>>23) == 0x17d) // SOP1 opcode
+                    word0 = (word0 & ~0xff00U) | (sweep<<8);
+                else if ((word0>>25) == 0x3f) // VOP1 opcode
+                    word0 = (word0 & ~0x1fe00U) | (sweep<<9);
+                if (word0 == 0) // zero word is printed as fill
+                    word0 = 1;
+                code.resize(pos+4);
+                code[pos] = LEV(word0);
+                for (cxuint k = 1; k < 4; k++)
+                    code[pos+k] = LEV(nextRandom(state));
+                GCNDecodedInstr instr;
+                const size_t nextPos = decoder.decode(code.size()<<2,
+                        reinterpret_cast<const cxbyte*>(code.data()), pos<<2, instr);
+                instrs.push_back(instr);
+                pos = nextPos>>2;
+            }
+        code.resize(pos);
+        
+        std::ostringstream disOss;
+        Disassembler disasm(deviceType, code.size()<<2,
+                    reinterpret_cast<const cxbyte*>(code.data()), disOss,
+                    DISASM_DUMPCODE | DISASM_CODEPOS);
+        disasm.disassemble();
+        const std::string text = disOss.str();
+        
+        // compare instructions lines (with code position) with decoded instructions
+        size_t instrIndex = 0;
+        for (size_t lineStart = 0; lineStart < text.size() && failsNum < 10; )
+        {
+            size_t lineEnd = text.find('\n', lineStart);
+            if (lineEnd == std::string::npos)
+                lineEnd = text.size();
+            const std::string line = text.substr(lineStart, lineEnd-lineStart);
+            lineStart = lineEnd+1;
+            if (line.compare(0, 2, "/*") != 0)
+                continue; // label or directive
+            const size_t offset = strtoull(line.c_str()+2, nullptr, 16);
+            std::ostringstream caseOss;
+            caseOss << getGPUArchitectureName(arch) << " space 0x" << std::hex <<
+                    LEV(code[offset>>2]) << "@0x" << offset;
+            try
+            {
+                assertTrue("GCNDecoder", caseOss.str()+".instrsNum",
+                           instrIndex < instrs.size());
+                const GCNDecodedInstr& instr = instrs[instrIndex++];
+                assertValue("GCNDecoder", caseOss.str()+".offset", instr.offset, offset);
+                checkDecodedInstr(caseOss.str(), instr, line.c_str()+line.find("*/")+2,
+                            &decoder);
+            }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << "\n  " << line << std::endl;
+                retVal = 1;
+                failsNum++;
+            }
+        }
+        if (failsNum == 0 && instrIndex != instrs.size())
+        {
+            std::cerr << getGPUArchitectureName(arch) << " space chunk " << high <<
+                    ": instructions number mismatch" << std::endl;
+            retVal = 1;
+            failsNum++;
+        }
+    }
+}
+
+static void testDecodeFields()
+{
+    const GCNDecoder decoder(GPUArchitecture::GCN1_2);
+    const uint32_t code[] =
+    {
+        // s_add_u32 s21, 0x2345, s61
+        LEV(0x80153dffU), LEV(0x2345U),
+        // v_cndmask_b32 v154, -v0, -v107, vcc sdwa
+        LEV(0x0134d6f9U), LEV(0x16160600U),
+        // v_cndmask_b32 v154, v0, v107, vcc quad_perm:[0,1,2,3] bank_mask:3 row_mask:5
+        LEV(0x0134d6faU), LEV(0x5300e400U),
+        // v_mad_f32 v55, -abs(v79), v166, abs(v229) clamp
+        LEV(0xd1c18537U), LEV(0x27974d4fU),
+        // buffer_load_dwordx2 v[61:62], v[18:19], s[80:83], s35 offen idxen offset:603 glc
+        LEV(0xe054725bU), LEV(0x23343d12U)
+    };
+    std::vector<GCNDecodedInstr> instrs;
+    decoder.decodeAll(sizeof(code), reinterpret_cast<const cxbyte*>(code), instrs);
+    assertValue("GCNDecoder", "fields.instrsNum", size_t(5), instrs.size());
+
+    const GCNDecodedInstr& sadd = instrs[0];
+    assertValue("GCNDecoder", "sadd.offset", size_t(0), sadd.offset);
+    assertValue("GCNDecoder", "sadd.encoding", cxuint(GCNENC_SOP2), cxuint(sadd.encoding));
+    assertString("GCNDecoder", "sadd.mnemonic", "s_add_u32",
+                 GCNDecoder::getMnemonic(sadd.mnemonicId));
+    assertValue("GCNDecoder", "sadd.wordsNum", cxuint(2), cxuint(sadd.wordsNum));
+    assertValue("GCNDecoder", "sadd.extra", cxuint(GCNDEXTRA_LITERAL), cxuint(sadd.extra));
+    assertValue("GCNDecoder", "sadd.literal", uint32_t(0x2345), sadd.literal);
+    assertValue("GCNDecoder", "sadd.operandsNum", cxuint(3), cxuint(sadd.operandsNum));
+    assertValue("GCNDecoder", "sadd.op0", cxuint(21), cxuint(sadd.operands[0].code));
+    assertValue("GCNDecoder", "sadd.op0.flags", cxuint(GCNDOP_DST),
+                cxuint(sadd.operands[0].flags));
+    assertValue("GCNDecoder", "sadd.op1", cxuint(255), cxuint(sadd.operands[1].code));
+    assertValue("GCNDecoder", "sadd.op2", cxuint(61), cxuint(sadd.operands[2].code));
+
+    const GCNDecodedInstr& sdwa = instrs[1];
+    assertValue("GCNDecoder", "sdwa.offset", size_t(8), sdwa.offset);
+    assertValue("GCNDecoder", "sdwa.extra", cxuint(GCNDEXTRA_SDWA), cxuint(sdwa.extra));
+    assertValue("GCNDecoder", "sdwa.operandsNum", cxuint(4), cxuint(sdwa.operandsNum));
+    assertValue("GCNDecoder", "sdwa.op1", cxuint(256), cxuint(sdwa.operands[1].code));
+    assertValue("GCNDecoder", "sdwa.op1.flags", cxuint(GCNDOP_SRC|GCNDOP_NEG),
+                cxuint(sdwa.operands[1].flags));
+    assertValue("GCNDecoder", "sdwa.op2", cxuint(256+107), cxuint(sdwa.operands[2].code));
+    assertValue("GCNDecoder", "sdwa.op2.flags", cxuint(GCNDOP_SRC|GCNDOP_NEG),
+                cxuint(sdwa.operands[2].flags));
+    assertValue("GCNDecoder", "sdwa.op3", cxuint(106), cxuint(sdwa.operands[3].code));
+    assertValue("GCNDecoder", "sdwa.dstSel", cxuint(6), cxuint(sdwa.sdwa.dstSel));
+    assertValue("GCNDecoder", "sdwa.src0Sel", cxuint(6), cxuint(sdwa.sdwa.src0Sel));
+
+    const GCNDecodedInstr& dpp = instrs[2];
+    assertValue("GCNDecoder", "dpp.extra", cxuint(GCNDEXTRA_DPP), cxuint(dpp.extra));
+    assertValue("GCNDecoder", "dpp.dppCtrl", cxuint(0xe4), cxuint(dpp.dpp.dppCtrl));
+    assertValue("GCNDecoder", "dpp.bankMask", cxuint(3), cxuint(dpp.dpp.bankMask));
+    assertValue("GCNDecoder", "dpp.rowMask", cxuint(5), cxuint(dpp.dpp.rowMask));
+    assertValue("GCNDecoder", "dpp.op1", cxuint(256), cxuint(dpp.operands[1].code));
+    assertValue("GCNDecoder", "dpp.modifiers", uint32_t(0), dpp.modifiers);
+
+    const GCNDecodedInstr& vmad = instrs[3];
+    assertValue("GCNDecoder", "vmad.encoding", cxuint(GCNENC_VOP3A),
+                cxuint(vmad.encoding));
+    assertString("GCNDecoder", "vmad.mnemonic", "v_mad_f32",
+                 GCNDecoder::getMnemonic(vmad.mnemonicId));
+    assertValue("GCNDecoder", "vmad.operandsNum", cxuint(4), cxuint(vmad.operandsNum));
+    assertValue("GCNDecoder", "vmad.op0", cxuint(256+55), cxuint(vmad.operands[0].code));
+    assertValue("GCNDecoder", "vmad.op1.flags", cxuint(GCNDOP_SRC|GCNDOP_NEG|GCNDOP_ABS),
+                cxuint(vmad.operands[1].flags));
+    assertValue("GCNDecoder", "vmad.op2", cxuint(256+166), cxuint(vmad.operands[2].code));
+    assertValue("GCNDecoder", "vmad.op3", cxuint(256+229), cxuint(vmad.operands[3].code));
+    assertValue("GCNDecoder", "vmad.op3.flags", cxuint(GCNDOP_SRC|GCNDOP_ABS),
+                cxuint(vmad.operands[3].flags));
+    assertValue("GCNDecoder", "vmad.modifiers", uint32_t(GCNDMOD_CLAMP), vmad.modifiers);
+
+    const GCNDecodedInstr& bload = instrs[4];
+    assertValue("GCNDecoder", "bload.offset", size_t(32), bload.offset);
+    assertString("GCNDecoder", "bload.mnemonic", "buffer_load_dwordx2",
+                 GCNDecoder::getMnemonic(bload.mnemonicId));
+    assertValue("GCNDecoder", "bload.operandsNum", cxuint(4), cxuint(bload.operandsNum));
+    assertValue("GCNDecoder", "bload.op0", cxuint(256+61), cxuint(bload.operands[0].code));
+    assertValue("GCNDecoder", "bload.op0.regsNum", cxuint(2),
+                cxuint(bload.operands[0].regsNum));
+    assertValue("GCNDecoder", "bload.op0.flags", cxuint(GCNDOP_DST),
+                cxuint(bload.operands[0].flags));
+    assertValue("GCNDecoder", "bload.op1.regsNum", cxuint(2),
+                cxuint(bload.operands[1].regsNum));
+    assertValue("GCNDecoder", "bload.op2", cxuint(80), cxuint(bload.operands[2].code));
+    assertValue("GCNDecoder", "bload.op3", cxuint(35), cxuint(bload.operands[3].code));
+    assertValue("GCNDecoder", "bload.imm", uint32_t(603), bload.imm);
+    assertValue("GCNDecoder", "bload.modifiers",
+                uint32_t(GCNDMOD_OFFEN|GCNDMOD_IDXEN|GCNDMOD_GLC), bload.modifiers);
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    testDecodeOpcodeCases(decGCNOpcodeCases, GPUArchitecture::GCN1_0, retVal);
+    testDecodeOpcodeCases(decGCNOpcodeGCN11Cases, GPUArchitecture::GCN1_1, retVal);
+    testDecodeOpcodeCases(decGCNOpcodeGCN12Cases, GPUArchitecture::GCN1_2, retVal);
+    testDecodeOpcodeCases(decGCNOpcodeGCN14Cases, GPUArchitecture::GCN1_4, retVal);
+    for (cxuint arch = 0; arch < 4; arch++)
+        testDecodeEncodingSpace(GPUArchitecture(arch), 4, retVal);
+    try
+    { testDecodeFields(); }
+    catch(const std::exception& ex)
+    {
+        std::cerr << ex.what() << std::endl;
+        retVal = 1;
+    }
+    return retVal;
+}
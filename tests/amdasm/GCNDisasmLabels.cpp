@@ -21,6 +21,8 @@
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <string>
+#include <vector>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/Containers.h>
 #include <CLRX/amdasm/Disassembler.h>
@@ -468,6 +470,72 @@ static void testDecGCNRelocations()
         throw Exception("FAILED relocationTest: result: "+disOss.str());
 }
 
+// generate pseudo-random code with jumps, literals, zero runs and random words
+static std::vector<uint32_t> generateChunkTestCode(size_t wordsNum)
+{
+    std::vector<uint32_t> code;
+    uint32_t seed = 12345;
+    while (code.size() < wordsNum)
+    {
+        seed = seed*1103515245U + 12345U;
+        const uint32_t r = seed>>8;
+        switch (r & 7)
+        {
+            case 0: // s_branch
+                code.push_back(LEV(0xbf820000U | ((r>>3)&0xffff)));
+                break;
+            case 1: // zero words
+                code.insert(code.end(), 1 + ((r>>3)&15), 0);
+                break;
+            case 2: // v_add_f32 with literal
+                code.push_back(LEV(0x0634d6ffU));
+                code.push_back(LEV(r));
+                break;
+            case 3: // v_mad_f32 (VOP3)
+                code.push_back(LEV(0xd2820000U | ((r>>3)&0xff)));
+                code.push_back(LEV(seed*7U));
+                break;
+            default: // random word
+                code.push_back(LEV(seed ^ (r<<5)));
+                break;
+        }
+    }
+    code.resize(wordsNum);
+    return code;
+}
+
+static void testChunkedDisassembly(GPUDeviceType deviceType, cxuint threadsNum)
+{
+    const std::vector<uint32_t> code = generateChunkTestCode(150001);
+    std::string outputs[2];
+    for (cxuint i = 0; i < 2; i++)
+    {
+        std::ostringstream disOss;
+        AmdDisasmInput input;
+        input.deviceType = deviceType;
+        input.is64BitMode = false;
+        Disassembler disasm(&input, disOss, DISASM_HEXCODE|DISASM_CODEPOS);
+        GCNDisassembler gcnDisasm(disasm);
+        // first pass sequential, second pass in chunks
+        gcnDisasm.setThreadsNum(i==0 ? 1 : threadsNum);
+        gcnDisasm.setInput(code.size()<<2, reinterpret_cast<const cxbyte*>(code.data()),
+                    0x100, 0x40);
+        // named labels (also inside instructions)
+        for (size_t pos = 0; pos < code.size()<<2; pos += 3331)
+            gcnDisasm.addNamedLabel(0x100 + pos, "named"+std::to_string(pos));
+        gcnDisasm.beforeDisassemble();
+        gcnDisasm.disassemble();
+        outputs[i] = disOss.str();
+    }
+    if (outputs[0] != outputs[1])
+    {
+        std::ostringstream oss;
+        oss << "FAILED chunkedDisassemblyTest for " << getGPUDeviceTypeName(deviceType) <<
+                ", threads: " << threadsNum;
+        throw Exception(oss.str());
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -506,5 +574,15 @@ int main(int argc, const char** argv)
         std::cerr << ex.what() << std::endl;
         retVal = 1;
     }
+    for (GPUDeviceType deviceType: { GPUDeviceType::PITCAIRN, GPUDeviceType::HAWAII,
+                GPUDeviceType::TONGA, GPUDeviceType::GFX900 })
+        for (cxuint threadsNum: { 3, 0 })
+            try
+            { testChunkedDisassembly(deviceType, threadsNum); }
+            catch(const std::exception& ex)
+            {
+                std::cerr << ex.what() << std::endl;
+                retVal = 1;
+            }
     return retVal;
 }
@@ -21,6 +21,8 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <algorithm>
+#include <vector>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/amdasm/Assembler.h>
 #include <CLRX/utils/Containers.h>
@@ -1800,9 +1802,220 @@ static void testGCNRegVarUsages(cxuint i, const GCNRegVarUsageCase& testCase)
                    j == testCase.regVarUsages.size());
 }
 
+/* restore saved read position (inside instruction and after end of usages)
+ * must give this same usages as first reading */
+static void testGCNRegVarUsageReadPos()
+{
+    std::istringstream input(
+        ".regvar sa:s:8, va:v:8\n"
+        "s_add_u32 sa[1], sa[2], sa[3]\n"
+        "v_mad_f32 va[0], va[1], sa[4], va[2]\n"
+        ".usereg sa[4:5]:r, va[1]:w, s3:rw\n"
+        ".space 12\n"
+        "s_lshl_b64 sa[2:3], sa[4:5], s7\n"
+        "v_add_f32 va[3], va[4], sa[6]\n");
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN,
+                    BinaryFormat::GALLIUM, GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testGCNRegVarUsageReadPos", "good", true, good);
+    
+    ISAUsageHandler* usageHandler = assembler.getSections()[0].usageHandler.get();
+    std::vector<AsmRegVarUsage> rvus;
+    usageHandler->rewind();
+    while (usageHandler->hasNext())
+        rvus.push_back(usageHandler->nextUsage());
+    
+    for (size_t pos = 0; pos < rvus.size(); pos++)
+    {
+        std::ostringstream oss;
+        oss << "pos " << pos;
+        const std::string caseName = oss.str();
+        usageHandler->rewind();
+        for (size_t j = 0; j < pos; j++)
+            usageHandler->nextUsage();
+        const ISAUsageHandler::ReadPos readPos = usageHandler->getReadPos();
+        // rewind from middle of instruction, read to end,
+        // and read again from saved position
+        usageHandler->rewind();
+        for (size_t j = 0; j < rvus.size(); j++)
+        {
+            assertTrue("testGCNRegVarUsageReadPos", caseName+".rewind.hasNext",
+                       usageHandler->hasNext());
+            assertValue("testGCNRegVarUsageReadPos", caseName+".rewind.offset",
+                        rvus[j].offset, usageHandler->nextUsage().offset);
+        }
+        usageHandler->setReadPos(readPos);
+        for (size_t j = pos; j < rvus.size(); j++)
+        {
+            assertTrue("testGCNRegVarUsageReadPos", caseName+".hasNext",
+                       usageHandler->hasNext());
+            const AsmRegVarUsage rvu = usageHandler->nextUsage();
+            assertValue("testGCNRegVarUsageReadPos", caseName+".offset",
+                        rvus[j].offset, rvu.offset);
+            assertTrue("testGCNRegVarUsageReadPos", caseName+".regVar",
+                        rvus[j].regVar == rvu.regVar);
+            assertValue("testGCNRegVarUsageReadPos", caseName+".rstart",
+                        rvus[j].rstart, rvu.rstart);
+            assertValue("testGCNRegVarUsageReadPos", caseName+".rend",
+                        rvus[j].rend, rvu.rend);
+            assertValue("testGCNRegVarUsageReadPos", caseName+".rwFlags",
+                        cxuint(rvus[j].rwFlags), cxuint(rvu.rwFlags));
+            assertValue("testGCNRegVarUsageReadPos", caseName+".useRegMode",
+                        int(rvus[j].useRegMode), int(rvu.useRegMode));
+        }
+        assertTrue("testGCNRegVarUsageReadPos", caseName+".end",
+                   !usageHandler->hasNext());
+    }
+}
+
+struct UsageDepsCase
+{
+    const char* input;
+    Array<cxbyte> linearDeps;
+    Array<cxbyte> equalToDeps;
+};
+
+static const UsageDepsCase usageDepsTestCasesTbl[] =
+{
+    {   /* 0 - scalar instruction */
+        ".regvar sa:s:4\ns_add_u32 sa[0], sa[1], sa[2]\n",
+        { 0 }, { 0 }
+    },
+    {   /* 1 - VOP3 with two SGPR regvars */
+        ".regvar sa:s:4, va:v:4\nv_mad_f32 va[0], sa[1], sa[1], va[1]\n",
+        { 0 }, { 1, 2, 1, 2 }
+    },
+    {   /* 2 - VOP3 with one SGPR regvar and real SGPR */
+        ".regvar sa:s:4, va:v:4\nv_mad_f32 va[0], s3, sa[2], va[1]\n",
+        { 0 }, { 1, 2, 1, 2 }
+    },
+    {   /* 3 - MUBUF store */
+        ".regvar sa:s:8, va:v:8\n"
+        "buffer_store_dwordx2 va[2:3], va[4], sa[4:7], s5 offen\n",
+        { 0 }, { 0 }
+    },
+    {   /* 4 - VOP with real registers */
+        ".regvar va:v:4\nv_add_f32 va[1], v1, va[0]\n",
+        { 0 }, { 0 }
+    }
+};
+
+/* dependencies of instruction usages (equalTo deps only for VOP instructions) */
+static void testGCNUsageDependencies(cxuint i, const UsageDepsCase& testCase)
+{
+    std::istringstream input(testCase.input);
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN,
+                    BinaryFormat::GALLIUM, GPUDeviceType::CAPE_VERDE, errorStream);
+    std::ostringstream oss;
+    oss << " testUsageDepsCase#" << i;
+    const std::string testCaseName = oss.str();
+    bool good = assembler.assemble();
+    assertValue<bool>("testGCNUsageDependencies", testCaseName+".good", true, good);
+    
+    ISAUsageHandler* usageHandler = assembler.getSections()[0].usageHandler.get();
+    AsmRegVarUsage rvus[8];
+    cxuint rvusNum = 0;
+    usageHandler->rewind();
+    while (usageHandler->hasNext())
+        rvus[rvusNum++] = usageHandler->nextUsage();
+    cxbyte linearDeps[16];
+    cxbyte equalToDeps[16];
+    // fill by garbage
+    std::fill(linearDeps, linearDeps+16, 0xff);
+    std::fill(equalToDeps, equalToDeps+16, 0xff);
+    usageHandler->getUsageDependencies(rvusNum, rvus, linearDeps, equalToDeps);
+    assertArray("testGCNUsageDependencies", testCaseName+".linearDeps",
+                testCase.linearDeps, testCase.linearDeps.size(), linearDeps);
+    assertArray("testGCNUsageDependencies", testCaseName+".equalToDeps",
+                testCase.equalToDeps, testCase.equalToDeps.size(), equalToDeps);
+    // no usages
+    usageHandler->getUsageDependencies(0, rvus, linearDeps, equalToDeps);
+    assertValue("testGCNUsageDependencies", testCaseName+".linearDeps0",
+                cxuint(0), cxuint(linearDeps[0]));
+    assertValue("testGCNUsageDependencies", testCaseName+".equalToDeps0",
+                cxuint(0), cxuint(equalToDeps[0]));
+}
+
+/* many regvars and long code (many code chunks).
+ * seek to offset must give this same usages as reading from start */
+static void testGCNRegVarUsageSeek()
+{
+    std::ostringstream source;
+    source << ".regvar ";
+    for (cxuint i = 0; i < 400; i++)
+        source << (i!=0 ? "," : "") << "r" << i << ":s:4";
+    source << "\n";
+    uint32_t rnd = 1;
+    for (cxuint i = 0; i < 3000; i++)
+    {
+        cxuint rvs[3];
+        for (cxuint k = 0; k < 3; k++)
+        {
+            rnd = rnd*1103515245U + 12345U;
+            rvs[k] = (rnd>>8) % 400;
+        }
+        source << "s_add_u32 r" << rvs[0] << "[" << (i&3) << "], r" << rvs[1] <<
+                "[" << ((i>>2)&3) << "], r" << rvs[2] << "[1]\n";
+        if ((i % 97) == 0)
+            source << ".usereg r" << rvs[1] << "[0:2]:r, s" << (i&31) << ":w\n";
+        if ((i % 331) == 0)
+            source << ".space 1500\n"; // code chunks without instructions
+    }
+    std::istringstream input(source.str());
+    std::ostringstream errorStream;
+    Assembler assembler("test.s", input, (ASM_ALL&~ASM_ALTMACRO) | ASM_TESTRUN,
+                    BinaryFormat::GALLIUM, GPUDeviceType::CAPE_VERDE, errorStream);
+    bool good = assembler.assemble();
+    assertValue<bool>("testGCNRegVarUsageSeek", "good", true, good);
+    
+    ISAUsageHandler* usageHandler = assembler.getSections()[0].usageHandler.get();
+    std::vector<AsmRegVarUsage> rvus;
+    usageHandler->rewind();
+    while (usageHandler->hasNext())
+        rvus.push_back(usageHandler->nextUsage());
+    assertValue("testGCNRegVarUsageSeek", "usagesNum", size_t(3000*3 + 31*2),
+                rvus.size());
+    
+    const size_t codeSize = assembler.getSections()[0].content.size();
+    for (size_t offset = 0; offset < codeSize + 100; offset += 36)
+    {
+        std::ostringstream oss;
+        oss << "offset " << offset;
+        const std::string caseName = oss.str();
+        usageHandler->seekTo(offset);
+        size_t j = std::lower_bound(rvus.begin(), rvus.end(), offset,
+                [](const AsmRegVarUsage& rvu, size_t offset)
+                { return rvu.offset < offset; }) - rvus.begin();
+        // compare some next usages
+        for (size_t k = 0; k < 20 && j < rvus.size(); j++, k++)
+        {
+            assertTrue("testGCNRegVarUsageSeek", caseName+".hasNext",
+                       usageHandler->hasNext());
+            const AsmRegVarUsage rvu = usageHandler->nextUsage();
+            assertValue("testGCNRegVarUsageSeek", caseName+".offset",
+                        rvus[j].offset, rvu.offset);
+            assertTrue("testGCNRegVarUsageSeek", caseName+".regVar",
+                        rvus[j].regVar == rvu.regVar);
+            assertValue("testGCNRegVarUsageSeek", caseName+".rstart",
+                        rvus[j].rstart, rvu.rstart);
+            assertValue("testGCNRegVarUsageSeek", caseName+".rend",
+                        rvus[j].rend, rvu.rend);
+            assertValue("testGCNRegVarUsageSeek", caseName+".rwFlags",
+                        cxuint(rvus[j].rwFlags), cxuint(rvu.rwFlags));
+        }
+        if (j == rvus.size())
+            assertTrue("testGCNRegVarUsageSeek", caseName+".end",
+                       !usageHandler->hasNext());
+    }
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
+    retVal |= callTest(testGCNRegVarUsageReadPos);
+    retVal |= callTest(testGCNRegVarUsageSeek);
     for (size_t i = 0; i < sizeof(gcnRvuTestCases1Tbl)/sizeof(GCNRegVarUsageCase); i++)
         try
         { testGCNRegVarUsages(i, gcnRvuTestCases1Tbl[i]); }
@@ -1811,5 +2024,13 @@ int main(int argc, const char** argv)
             std::cerr << ex.what() << std::endl;
             retVal = 1;
         }
+    for (size_t i = 0; i < sizeof(usageDepsTestCasesTbl)/sizeof(UsageDepsCase); i++)
+        try
+        { testGCNUsageDependencies(i, usageDepsTestCasesTbl[i]); }
+        catch(const std::exception& ex)
+        {
+            std::cerr << ex.what() << std::endl;
+            retVal = 1;
+        }
     return retVal;
 }
@@ -491,6 +491,79 @@ static void testKernelArgs(const char* filename, const char* kernelName,
     }
 }
 
+// compare lazily parsed AMD GPU binary with eagerly parsed binary
+static void testLazyLoading(const char* filename, cxuint threadsNum)
+{
+    const std::string testName = std::string("testLazyLoading:") + filename;
+    Array<cxbyte> data = loadDataFromFile(filename);
+    const Flags flags = AMDBIN_CREATE_ALL | AMDBIN_INNER_CREATE_CALNOTES;
+    std::unique_ptr<AmdMainGPUBinaryBase> eager(static_cast<AmdMainGPUBinaryBase*>(
+            createAmdBinaryFromCode(data.size(), data.data(), flags)));
+    std::unique_ptr<AmdMainGPUBinaryBase> lazy(static_cast<AmdMainGPUBinaryBase*>(
+            createAmdBinaryFromCode(data.size(), data.data(), flags | AMDBIN_CREATE_LAZY)));
+    
+    assertValue(testName, "kernelInfosNum", eager->getKernelInfosNum(),
+                lazy->getKernelInfosNum());
+    assertValue(testName, "innerBinariesNum", eager->getInnerBinariesNum(),
+                lazy->getInnerBinariesNum());
+    assertValue(testName, "compileOptions", eager->getCompileOptions(),
+                lazy->getCompileOptions());
+    assertValue(testName, "driverInfo", eager->getDriverInfo(), lazy->getDriverInfo());
+    // access by name (in reversed order) before access by index
+    for (size_t i = eager->getKernelInfosNum(); i > 0; i--)
+    {
+        const CString& kernelName = eager->getKernelInfo(i-1).kernelName;
+        assertTrue(testName, "kernelInfoByName",
+                &lazy->getKernelInfo(kernelName.c_str()) == &lazy->getKernelInfo(i-1));
+        assertTrue(testName, "innerBinaryByName",
+                &lazy->getInnerBinary(kernelName.c_str()) ==
+                &lazy->getInnerBinary(eager->getInnerBinary(kernelName.c_str()).
+                    getKernelName().c_str()));
+    }
+    // parse entries in many threads
+    runParallel(lazy->getInnerBinariesNum(), threadsNum, [&lazy](size_t i)
+    {
+        lazy->getInnerBinary(i);
+        if (i < lazy->getKernelInfosNum())
+            lazy->getMetadata(i);
+    });
+    for (size_t i = 0; i < eager->getKernelInfosNum(); i++)
+    {
+        std::ostringstream oss;
+        oss << "#" << i;
+        const std::string caseName = oss.str();
+        const KernelInfo& expInfo = eager->getKernelInfo(i);
+        const KernelInfo& resInfo = lazy->getKernelInfos()[i];
+        assertValue(testName, caseName+" kernelName", expInfo.kernelName,
+                    resInfo.kernelName);
+        assertValue(testName, caseName+" argInfosNum", expInfo.argInfos.size(),
+                    resInfo.argInfos.size());
+        for (size_t k = 0; k < expInfo.argInfos.size(); k++)
+            assertValue(testName, caseName+" argName", expInfo.argInfos[k].argName,
+                    resInfo.argInfos[k].argName);
+        assertValue(testName, caseName+" metadataSize", eager->getMetadataSize(i),
+                    lazy->getMetadataSize(i));
+        assertTrue(testName, caseName+" metadata",
+                    eager->getMetadata(i) == lazy->getMetadata(i));
+    }
+    for (size_t i = 0; i < eager->getInnerBinariesNum(); i++)
+    {
+        std::ostringstream oss;
+        oss << "inner#" << i;
+        const std::string caseName = oss.str();
+        const AmdInnerGPUBinary32& expInner = eager->getInnerBinary(i);
+        const AmdInnerGPUBinary32& resInner = lazy->getInnerBinary(i);
+        assertValue(testName, caseName+" kernelName", expInner.getKernelName(),
+                    resInner.getKernelName());
+        assertTrue(testName, caseName+" binaryCode",
+                    expInner.getBinaryCode() == resInner.getBinaryCode());
+        assertValue(testName, caseName+" size", expInner.getSize(), resInner.getSize());
+        assertValue(testName, caseName+" CALEncodingEntriesNum",
+                    expInner.getCALEncodingEntriesNum(),
+                    resInner.getCALEncodingEntriesNum());
+    }
+}
+
 static const cxbyte defaultHeader[32] = { };
 
 static AmdMainGPUBinaryBase* genAmdBinWithMetadata(const std::string& metadata)
@@ -657,6 +730,12 @@ int main(int argc, const char** argv)
             "/tests/amdbin/amdbins/structkernel2_cpu64.clo", "myKernel1",
             sizeof(expectedCPUKernelArgs2)/sizeof(AmdKernelArg), expectedCPUKernelArgs2);
     retVal |= callTest(testAmdGPUMetadataGen);
+    retVal |= callTest(testLazyLoading, CLRX_SOURCE_DIR
+            "/tests/amdasm/amdbins/samplekernels.clo", 1);
+    retVal |= callTest(testLazyLoading, CLRX_SOURCE_DIR
+            "/tests/amdasm/amdbins/samplekernels_64.clo", 4);
+    retVal |= callTest(testLazyLoading, CLRX_SOURCE_DIR
+            "/tests/amdbin/amdbins/alltypes.clo", 4);
     
     for (cxuint i = 0; i < sizeof(binLoadingTestCases)/sizeof(BinLoadingFailCase); i++)
     {
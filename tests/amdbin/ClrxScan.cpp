@@ -0,0 +1,108 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+#ifdef HAVE_WINDOWS
+#define popen _popen
+#define pclose _pclose
+#endif
+
+using namespace CLRX;
+
+static const char* clrxScanPath = nullptr;
+
+#define BINDIR CLRX_SOURCE_DIR "/tests/amdasm/amdbins"
+
+// run clrxscan with arguments and return its standard output
+static std::string runClrxScan(const std::string& args, int& status)
+{
+    const std::string command = std::string("\"") + clrxScanPath + "\" -q " + args;
+    FILE* pipe = popen(command.c_str(), "r");
+    if (pipe == nullptr)
+        throw Exception("Can't run clrxscan");
+    std::string output;
+    char buf[256];
+    size_t readed;
+    while ((readed = fread(buf, 1, sizeof buf, pipe)) != 0)
+        output.append(buf, readed);
+    status = pclose(pipe);
+    return output;
+}
+
+// format detection and CSV output (kernels of every recognized binary)
+// functions of ROCm binaries are not listed
+static void testClrxScanCSV()
+{
+    int status = 0;
+    const std::string output = runClrxScan("\"" BINDIR "\"", status);
+    assertValue("testClrxScanCSV", "status", 0, status);
+    assertString("testClrxScanCSV", "output",
+        "file,format,kernel,sgprsNum,vgprsNum,scratchSize,localSize\n"
+        BINDIR "/amd1.clo,amd,xT1,18,222,108,0\n"
+        BINDIR "/amdcl2.clo,amdcl2,aaa1,12,1,0,1000\n"
+        BINDIR "/amdcl2.clo,amdcl2,aaa2,12,1,2342,1000\n"
+        BINDIR "/amdcl2.clo,amdcl2,gfd12,25,78,0,656\n"
+        BINDIR "/gallium1.clo,gallium,one1,104,12,48,32768\n"
+        BINDIR "/gallium1.clo,gallium,secondx,8,56,0,256\n"
+        BINDIR "/new-gallium-llvm40.clo,gallium,vectorAdd,24,4,0,0\n"
+        BINDIR "/rocm-fiji.hsaco,rocm,test1,15,7,0,0\n"
+        BINDIR "/rocm-fiji.hsaco,rocm,test2,15,7,0,0\n"
+        BINDIR "/rocm-func.hsaco,rocm,kx,3,1,0,0\n"
+        BINDIR "/samplekernels.clo,amd,add,16,3,0,0\n"
+        BINDIR "/samplekernels.clo,amd,multiply,20,3,0,0\n"
+        BINDIR "/samplekernels_64.clo,amd,add,20,8,0,0\n"
+        BINDIR "/samplekernels_64.clo,amd,multiply,20,8,0,0\n", output);
+}
+
+// JSON Lines output, unrecognized file is skipped
+static void testClrxScanJSON()
+{
+    int status = 0;
+    const std::string output = runClrxScan("-J \"" BINDIR "/rocm-fiji.hsaco\" \""
+                BINDIR "/samplekernels.cl\"", status);
+    assertValue("testClrxScanJSON", "status", 0, status);
+    assertString("testClrxScanJSON", "output",
+        "{\"type\":\"file\",\"name\":\"" BINDIR "/rocm-fiji.hsaco\","
+            "\"format\":\"rocm\",\"kernelsNum\":2}\n"
+        "{\"type\":\"kernel\",\"file\":\"" BINDIR "/rocm-fiji.hsaco\",\"name\":\"test1\","
+            "\"sgprsNum\":15,\"vgprsNum\":7,\"scratchSize\":0,\"localSize\":0}\n"
+        "{\"type\":\"kernel\",\"file\":\"" BINDIR "/rocm-fiji.hsaco\",\"name\":\"test2\","
+            "\"sgprsNum\":15,\"vgprsNum\":7,\"scratchSize\":0,\"localSize\":0}\n",
+        output);
+}
+
+int main(int argc, const char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: ClrxScan CLRXSCANPATH" << std::endl;
+        return 1;
+    }
+    clrxScanPath = argv[1];
+    int retVal = 0;
+    retVal |= callTest(testClrxScanCSV);
+    retVal |= callTest(testClrxScanJSON);
+    return retVal;
+}
@@ -0,0 +1,163 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <CLRX/amdbin/ElfBinaries.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const cxbyte textContent[16] = { };
+
+static const Flags lookupFlagsTable[] =
+{
+    0, ELF_CREATE_SECTIONMAP|ELF_CREATE_SYMBOLMAP|ELF_CREATE_DYNSYMMAP,
+    ELF_CREATE_HASHINDEX, ELF_CREATE_ALL, ELF_CREATE_ALL|ELF_CREATE_HASHINDEX
+};
+
+// generate ELF binary with many symbols and dynamic symbols
+template<typename Types>
+static Array<cxbyte> generateElfBinary(const std::vector<std::string>& symNames,
+            bool withHash)
+{
+    ElfBinaryGenTemplate<Types> elfBinGen({ 0U, 0U, 0, 0, ET_DYN,
+            0xe0, EV_CURRENT, UINT_MAX, 0, 0 });
+    // section indices: 1 - .text, 2 - .dynsym, 3 - .hash (optional), next .dynstr
+    elfBinGen.addRegion(ElfRegionTemplate<Types>(sizeof(textContent), textContent, 4,
+                ".text", SHT_PROGBITS, SHF_ALLOC|SHF_EXECINSTR));
+    elfBinGen.addRegion(ElfRegionTemplate<Types>::dynsymSection());
+    if (withHash)
+        elfBinGen.addRegion(ElfRegionTemplate<Types>::hashSection(2));
+    elfBinGen.addRegion(ElfRegionTemplate<Types>::dynstrSection());
+    elfBinGen.addRegion(ElfRegionTemplate<Types>::symtabSection());
+    elfBinGen.addRegion(ElfRegionTemplate<Types>::shstrtabSection());
+    elfBinGen.addRegion(ElfRegionTemplate<Types>::strtabSection());
+    elfBinGen.addRegion(ElfRegionTemplate<Types>::sectionHeaderTable());
+    for (size_t i = 0; i < symNames.size(); i++)
+    {
+        elfBinGen.addSymbol(ElfSymbolTemplate<Types>(symNames[i].c_str(), 1,
+                ELF32_ST_INFO(STB_GLOBAL, STT_FUNC), 0, false, i, 0));
+        // dynamic symbols in reversed order
+        elfBinGen.addDynSymbol(ElfSymbolTemplate<Types>(
+                symNames[symNames.size()-i-1].c_str(), 1,
+                ELF32_ST_INFO(STB_GLOBAL, STT_FUNC), 0, false, i, 0));
+    }
+    std::ostringstream oss;
+    elfBinGen.generate(oss);
+    const std::string content = oss.str();
+    Array<cxbyte> binary(content.size());
+    std::copy(content.begin(), content.end(), binary.begin());
+    return binary;
+}
+
+template<typename Types>
+static void testElfLookup(bool withHash)
+{
+    std::ostringstream nameOss;
+    nameOss << "testElfLookup" << Types::bitName << (withHash ? "Hash" : "");
+    const std::string testNameStr = nameOss.str();
+    const char* testName = testNameStr.c_str();
+
+    std::vector<std::string> symNames;
+    for (cxuint i = 0; i < 5000; i++)
+    {
+        char buf[32];
+        snprintf(buf, sizeof buf, "symbol_%u", i);
+        symNames.push_back(buf);
+    }
+    Array<cxbyte> binary = generateElfBinary<Types>(symNames, withHash);
+    const size_t symsNum = symNames.size();
+    static const char* sectionNames[] = { ".text", ".dynsym", ".dynstr", ".symtab",
+            ".shstrtab", ".strtab" };
+
+    for (Flags flags: lookupFlagsTable)
+    {
+        ElfBinaryTemplate<Types> elfBin(binary.size(), binary.data(), flags);
+        std::ostringstream caseOss;
+        caseOss << "flags" << flags << "#";
+        const std::string caseName = caseOss.str();
+        assertTrue(testName, caseName+"hasHashIndex",
+                elfBin.hasHashIndex() == ((flags & ELF_CREATE_HASHINDEX) != 0));
+
+        // sections
+        for (const char* sectionName: sectionNames)
+        {
+            const uint16_t index = elfBin.findSectionIndex(sectionName);
+            assertTrue(testName, caseName+"sectionFound", index != SHN_UNDEF);
+            assertTrue(testName, caseName+"sectionName",
+                        ::strcmp(elfBin.getSectionName(index), sectionName) == 0);
+            assertValue(testName, caseName+"getSectionIndex", int(index),
+                        int(elfBin.getSectionIndex(sectionName)));
+        }
+        assertValue(testName, caseName+"hashSection", int(withHash ? SHN_UNDEF+3 :
+                    SHN_UNDEF), int(elfBin.findSectionIndex(".hash")));
+        assertValue(testName, caseName+"noSection", int(SHN_UNDEF),
+                    int(elfBin.findSectionIndex(".nosection")));
+        assertCLRXException(testName, caseName+"getNoSection",
+                (std::string("Can't find Elf")+Types::bitName+" Section").c_str(),
+                [&elfBin]() { elfBin.getSectionIndex(".nosection"); });
+
+        if ((flags & (ELF_CREATE_SYMBOLMAP|ELF_CREATE_HASHINDEX)) == 0)
+            continue; // symbol lookup requires map or hash index
+
+        // symbols (first symbol is null symbol)
+        for (size_t i = 0; i < symsNum; i++)
+        {
+            const char* symName = symNames[i].c_str();
+            assertTrue(testName, caseName+"symbol#"+symNames[i],
+                    elfBin.findSymbolIndex(symName) == i+1);
+            assertTrue(testName, caseName+"getSymbol#"+symNames[i],
+                    elfBin.getSymbolIndex(symName) == i+1);
+            assertTrue(testName, caseName+"dynSymbol#"+symNames[i],
+                    elfBin.findDynSymbolIndex(symName) == symsNum-i);
+            assertTrue(testName, caseName+"getDynSymbol#"+symNames[i],
+                    elfBin.getDynSymbolIndex(symName) == symsNum-i);
+        }
+        assertTrue(testName, caseName+"noSymbol",
+                elfBin.findSymbolIndex("symbol_x") == Types::nosymbol);
+        assertTrue(testName, caseName+"noDynSymbol",
+                elfBin.findDynSymbolIndex("symbol_5000") == Types::nosymbol);
+        assertTrue(testName, caseName+"nullSymbol", elfBin.findSymbolIndex("") == 0);
+        assertTrue(testName, caseName+"nullDynSymbol",
+                elfBin.findDynSymbolIndex("") == 0);
+        assertCLRXException(testName, caseName+"getNoSymbol",
+                (std::string("Can't find Elf")+Types::bitName+" Symbol").c_str(),
+                [&elfBin]() { elfBin.getSymbolIndex("symbol_x"); });
+        assertCLRXException(testName, caseName+"getNoDynSymbol",
+                (std::string("Can't find Elf")+Types::bitName+" DynSymbol").c_str(),
+                [&elfBin]() { elfBin.getDynSymbolIndex("symbol_x"); });
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testElfLookup<Elf32Types>, false);
+    retVal |= callTest(testElfLookup<Elf32Types>, true);
+    retVal |= callTest(testElfLookup<Elf64Types>, false);
+    retVal |= callTest(testElfLookup<Elf64Types>, true);
+    return retVal;
+}
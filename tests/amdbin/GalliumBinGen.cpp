@@ -112,6 +112,13 @@ static void testOrigBinary(cxuint testCase, const char* origBinaryFilename)
     
     // loading data gallium binary
     inputData = loadDataFromFile(origBinFilenameStr.c_str());
+    if (!isGalliumBinary(inputData.size(), inputData.data()))
+    {
+        std::ostringstream oss;
+        oss << "Failed for #" << testCase << " file=" << origBinaryFilename <<
+                ": not detected as Gallium binary";
+        throw Exception(oss.str());
+    }
     galliumBin.reset(new GalliumBinary(inputData.size(), inputData.data(),
             GALLIUM_INNER_CREATE_SECTIONMAP |
             GALLIUM_INNER_CREATE_SYMBOLMAP | GALLIUM_INNER_CREATE_PROGINFOMAP));
@@ -1176,46 +1176,9 @@ Kernels:
     }
 };
 
-static void testROCmMetadataCase(cxuint testId, const ROCmMetadataTestCase& testCase)
+static void checkROCmMetadata(const char* testName, const ROCmMetadata& expected,
+            const ROCmMetadata& result)
 {
-    ROCmInput rocmInput{};
-    rocmInput.deviceType = GPUDeviceType::FIJI;
-    rocmInput.archMinor = 0;
-    rocmInput.archStepping = 3;
-    rocmInput.newBinFormat = true;
-    rocmInput.target = "amdgcn-amd-amdhsa-amdgizcl-gfx803";
-    rocmInput.metadataSize = ::strlen(testCase.input);
-    rocmInput.metadata = testCase.input;
-    // generate simple binary with metadata
-    Array<cxbyte> output;
-    {
-        ROCmBinGenerator binGen(&rocmInput);
-        binGen.generate(output);
-    }
-    // now we load binary
-    const ROCmMetadata& expected = testCase.expected;
-    ROCmMetadata result;
-    bool good = true;
-    CString error;
-    try
-    {
-        ROCmBinary binary(output.size(), output.data(), ROCMBIN_CREATE_METADATAINFO);
-        result = binary.getMetadataInfo();
-    }
-    catch(const ParseException& ex)
-    {
-        good = false;
-        error = ex.what();
-    }
-    
-    char testName[30];
-    snprintf(testName, 30, "Test #%u", testId);
-    assertValue(testName, "good", testCase.good, good);
-    assertString(testName, "error", testCase.error, error.c_str());
-    if (!good)
-        // do not check if test failed
-        return;
-    
     assertValue(testName, "version[0]", expected.version[0], result.version[0]);
     assertValue(testName, "version[1]", expected.version[1], result.version[1]);
     assertValue(testName, "printfInfosNum", expected.printfInfos.size(),
@@ -1341,6 +1304,63 @@ static void testROCmMetadataCase(cxuint testId, const ROCmMetadataTestCase& test
     }
 }
 
+static void testROCmMetadataCase(cxuint testId, const ROCmMetadataTestCase& testCase)
+{
+    ROCmInput rocmInput{};
+    rocmInput.deviceType = GPUDeviceType::FIJI;
+    rocmInput.archMinor = 0;
+    rocmInput.archStepping = 3;
+    rocmInput.newBinFormat = true;
+    rocmInput.target = "amdgcn-amd-amdhsa-amdgizcl-gfx803";
+    rocmInput.metadataSize = ::strlen(testCase.input);
+    rocmInput.metadata = testCase.input;
+    // generate simple binary with metadata
+    Array<cxbyte> output;
+    {
+        ROCmBinGenerator binGen(&rocmInput);
+        binGen.generate(output);
+    }
+    // now we load binary
+    const ROCmMetadata& expected = testCase.expected;
+    ROCmMetadata result;
+    bool good = true;
+    CString error;
+    try
+    {
+        ROCmBinary binary(output.size(), output.data(), ROCMBIN_CREATE_METADATAINFO);
+        result = binary.getMetadataInfo();
+    }
+    catch(const ParseException& ex)
+    {
+        good = false;
+        error = ex.what();
+    }
+    
+    char testName[30];
+    snprintf(testName, 30, "Test #%u", testId);
+    assertValue(testName, "good", testCase.good, good);
+    assertString(testName, "error", testCase.error, error.c_str());
+    if (good)
+        checkROCmMetadata(testName, expected, result);
+    
+    // regular parser (without metadata view)
+    ROCmMetadata result2;
+    good = true;
+    error.clear();
+    try
+    { result2.parse(rocmInput.metadataSize, rocmInput.metadata); }
+    catch(const ParseException& ex)
+    {
+        good = false;
+        error = ex.what();
+    }
+    snprintf(testName, 30, "Test #%u(parse)", testId);
+    assertValue(testName, "good", testCase.good, good);
+    assertString(testName, "error", testCase.error, error.c_str());
+    if (good)
+        checkROCmMetadata(testName, expected, result2);
+}
+
 int main(int argc, const char** argv)
 {
     int retVal = 0;
@@ -0,0 +1,236 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/amdbin/ROCmBinaries.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+/* benchmark of ROCm metadata parsers: regular parser (ROCmMetadata::parse) and
+ * metadata view parser. Also checks whether both parsers give same results.
+ * usage: ROCmMetadataBench [ITERATIONS [KERNELSNUM]] */
+
+static const char* rocmBinaryFiles[] =
+{
+    CLRX_SOURCE_DIR "/tests/amdbin/rocmbins/consttest1-kaveri.hsaco.regen",
+    CLRX_SOURCE_DIR "/tests/amdbin/rocmbins/rijndael.hsaco.regen",
+    CLRX_SOURCE_DIR "/tests/amdbin/rocmbins/vectoradd-rocm.clo.regen",
+    CLRX_SOURCE_DIR "/tests/amdasm/amdbins/rocm-fiji.hsaco"
+};
+
+// generate large metadata with many kernels
+static std::string generateMetadata(cxuint kernelsNum)
+{
+    static const char* argTypes[4][3] =
+    {
+        { "float*", "GlobalBuffer", "F32" },
+        { "uint", "ByValue", "U32" },
+        { "'struct\\tdata'", "ByValue", "Struct" },
+        { "int4*", "GlobalBuffer", "I32" }
+    };
+    std::ostringstream oss;
+    oss << "---\nVersion: [ 1, 0 ]\nPrintf:\n"
+        "  - '1:1:4:index\\72%d\\n'\n  - '2:1:4:value\\72%d\\n'\nKernels:\n";
+    for (cxuint i = 0; i < kernelsNum; i++)
+    {
+        oss << "  - Name:            kernel_" << i << "\n"
+            "    SymbolName:      'kernel_" << i << "@kd'\n"
+            "    Language:        OpenCL C\n"
+            "    LanguageVersion: [ 1, 2 ]\n"
+            "    Attrs:\n"
+            "      ReqdWorkGroupSize: [ 64, 1, 1 ]\n"
+            "      VecTypeHint:     int\n"
+            "    Args:\n";
+        for (cxuint j = 0; j < 8; j++)
+        {
+            const char** argType = argTypes[(i+j)&3];
+            oss << "      - Name:            arg" << j << "\n"
+                "        TypeName:        " << argType[0] << "\n"
+                "        Size:            8\n"
+                "        Align:           8\n"
+                "        ValueKind:       " << argType[1] << "\n"
+                "        ValueType:       " << argType[2] << "\n";
+            if (argType[1][0] == 'G')
+                oss << "        AddrSpaceQual:   Global\n"
+                    "        AccQual:         Default\n"
+                    "        IsConst:         true\n";
+        }
+        oss << "      - Size:            8\n"
+            "        Align:           8\n"
+            "        ValueKind:       HiddenGlobalOffsetX\n"
+            "        ValueType:       I64\n"
+            "    CodeProps:\n"
+            "      KernargSegmentSize: 80\n"
+            "      GroupSegmentFixedSize: 0\n"
+            "      PrivateSegmentFixedSize: 0\n"
+            "      KernargSegmentAlign: 8\n"
+            "      WavefrontSize:   64\n"
+            "      NumSGPRs:        16\n"
+            "      NumVGPRs:        12\n"
+            "      MaxFlatWorkGroupSize: 256\n";
+    }
+    oss << "...\n";
+    return oss.str();
+}
+
+static void checkMetadataEqual(const char* testName, const ROCmMetadata& expected,
+            const ROCmMetadata& result)
+{
+    assertValue(testName, "version[0]", expected.version[0], result.version[0]);
+    assertValue(testName, "version[1]", expected.version[1], result.version[1]);
+    assertValue(testName, "printfInfosNum", expected.printfInfos.size(),
+                result.printfInfos.size());
+    for (size_t i = 0; i < expected.printfInfos.size(); i++)
+        assertValue(testName, "printf.format", expected.printfInfos[i].format,
+                    result.printfInfos[i].format);
+    assertValue(testName, "kernelsNum", expected.kernels.size(), result.kernels.size());
+    for (size_t i = 0; i < expected.kernels.size(); i++)
+    {
+        const ROCmKernelMetadata& expKernel = expected.kernels[i];
+        const ROCmKernelMetadata& resKernel = result.kernels[i];
+        assertValue(testName, "name", expKernel.name, resKernel.name);
+        assertValue(testName, "symbolName", expKernel.symbolName, resKernel.symbolName);
+        assertValue(testName, "language", expKernel.language, resKernel.language);
+        assertValue(testName, "vecTypeHint", expKernel.vecTypeHint,
+                    resKernel.vecTypeHint);
+        assertValue(testName, "kernargSegmentSize", expKernel.kernargSegmentSize,
+                    resKernel.kernargSegmentSize);
+        assertValue(testName, "sgprsNum", expKernel.sgprsNum, resKernel.sgprsNum);
+        assertValue(testName, "vgprsNum", expKernel.vgprsNum, resKernel.vgprsNum);
+        assertValue(testName, "argsNum", expKernel.argInfos.size(),
+                    resKernel.argInfos.size());
+        for (size_t j = 0; j < expKernel.argInfos.size(); j++)
+        {
+            const ROCmKernelArgInfo& expArg = expKernel.argInfos[j];
+            const ROCmKernelArgInfo& resArg = resKernel.argInfos[j];
+            assertValue(testName, "arg.name", expArg.name, resArg.name);
+            assertValue(testName, "arg.typeName", expArg.typeName, resArg.typeName);
+            assertValue(testName, "arg.size", expArg.size, resArg.size);
+            assertValue(testName, "arg.valueKind", cxuint(expArg.valueKind),
+                        cxuint(resArg.valueKind));
+            assertValue(testName, "arg.valueType", cxuint(expArg.valueType),
+                        cxuint(resArg.valueType));
+            assertValue(testName, "arg.addressSpace", cxuint(expArg.addressSpace),
+                        cxuint(resArg.addressSpace));
+            assertValue(testName, "arg.accessQual", cxuint(expArg.accessQual),
+                        cxuint(resArg.accessQual));
+            assertValue(testName, "arg.isConst", expArg.isConst, resArg.isConst);
+        }
+    }
+}
+
+typedef std::chrono::high_resolution_clock BenchClock;
+
+static double elapsedMs(const BenchClock::time_point& start)
+{
+    return std::chrono::duration<double, std::milli>(BenchClock::now() - start).count();
+}
+
+static void benchMetadata(const char* name, size_t metadataSize, const char* metadata,
+            cxuint iterations)
+{
+    ROCmMetadata expected;
+    expected.parse(metadataSize, metadata);
+    {
+        ROCmMetadataView view;
+        view.parse(metadataSize, metadata);
+        ROCmMetadata result;
+        view.toMetadata(result);
+        checkMetadataEqual(name, expected, result);
+    }
+    
+    BenchClock::time_point start = BenchClock::now();
+    for (cxuint i = 0; i < iterations; i++)
+    {
+        ROCmMetadata metadataInfo;
+        metadataInfo.parse(metadataSize, metadata);
+    }
+    const double parseTime = elapsedMs(start);
+    
+    start = BenchClock::now();
+    for (cxuint i = 0; i < iterations; i++)
+    {
+        ROCmMetadataView view;
+        view.parse(metadataSize, metadata);
+    }
+    const double viewTime = elapsedMs(start);
+    
+    start = BenchClock::now();
+    for (cxuint i = 0; i < iterations; i++)
+    {
+        ROCmMetadataView view;
+        view.parse(metadataSize, metadata);
+        ROCmMetadata metadataInfo;
+        view.toMetadata(metadataInfo);
+    }
+    const double viewAndInfoTime = elapsedMs(start);
+    
+    char buf[200];
+    snprintf(buf, sizeof buf, "%s: size=%zu kernels=%zu parse=%.3fms view=%.3fms "
+            "view+toMetadata=%.3fms", name, metadataSize, expected.kernels.size(),
+            parseTime, viewTime, viewAndInfoTime);
+    std::cout << buf << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+    const cxuint iterations = (argc >= 2) ? ::atoi(argv[1]) : 1;
+    const cxuint kernelsNum = (argc >= 3) ? ::atoi(argv[2]) : 500;
+    int retVal = 0;
+    for (const char* filename: rocmBinaryFiles)
+        try
+        {
+            std::string fname = filename;
+            filesystemPath(fname); // convert to system path (native separators)
+            Array<cxbyte> binaryData = loadDataFromFile(fname.c_str());
+            ROCmBinary binary(binaryData.size(), binaryData.data(), 0);
+            if (binary.getMetadata() == nullptr || binary.getMetadataSize() == 0)
+            {
+                std::cout << filename << ": no metadata" << std::endl;
+                continue;
+            }
+            benchMetadata(filename, binary.getMetadataSize(), binary.getMetadata(),
+                          iterations);
+        }
+        catch(const std::exception& ex)
+        {
+            std::cerr << filename << ": " << ex.what() << std::endl;
+            retVal = 1;
+        }
+    try
+    {
+        const std::string metadata = generateMetadata(kernelsNum);
+        benchMetadata("synthetic", metadata.size(), metadata.c_str(), iterations);
+    }
+    catch(const std::exception& ex)
+    {
+        std::cerr << "synthetic: " << ex.what() << std::endl;
+        retVal = 1;
+    }
+    return retVal;
+}
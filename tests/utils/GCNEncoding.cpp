@@ -0,0 +1,198 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <CLRX/utils/GCNEncoding.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+// GCN encodings for 11 in highest bits (reference)
+static const cxbyte refEncoding11Table[16] =
+{
+    GCNENC_SMRD, GCNENC_SMRD, GCNENC_VINTRP, GCNENC_NONE,
+    GCNENC_VOP3A, GCNENC_NONE, GCNENC_DS, GCNENC_FLAT,
+    GCNENC_MUBUF, GCNENC_NONE, GCNENC_MTBUF, GCNENC_NONE,
+    GCNENC_MIMG, GCNENC_NONE, GCNENC_EXP, GCNENC_NONE
+};
+
+static const cxbyte refEncoding12Table[16] =
+{
+    GCNENC_SMEM, GCNENC_EXP, GCNENC_NONE, GCNENC_NONE,
+    GCNENC_VOP3A, GCNENC_VINTRP, GCNENC_DS, GCNENC_FLAT,
+    GCNENC_MUBUF, GCNENC_NONE, GCNENC_MTBUF, GCNENC_NONE,
+    GCNENC_MIMG, GCNENC_NONE, GCNENC_NONE, GCNENC_NONE
+};
+
+// reference classifier (nested conditions used by disassembler before tables)
+static void refClassify(GPUArchitecture arch, uint32_t insnCode, cxbyte& encoding,
+            cxuint& wordsNum)
+{
+    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+    const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
+    const bool vsrcExt = (isGCN12 && ((insnCode&0x1ff) == 0xf9 ||
+                (insnCode&0x1ff) == 0xfa));
+    const bool ssrc01 = ((insnCode&0xff) == 0xff || (insnCode&0xff00) == 0xff00);
+    wordsNum = 1;
+    if ((insnCode & 0x80000000U) != 0)
+    {
+        if ((insnCode & 0x40000000U) == 0)
+        {
+            if  ((insnCode & 0x30000000U) == 0x30000000U)
+            {
+                const uint32_t encPart = (insnCode & 0x0f800000U);
+                if (encPart == 0x0e800000U)
+                {
+                    encoding = GCNENC_SOP1;
+                    wordsNum += ((insnCode&0xff) == 0xff);
+                }
+                else if (encPart == 0x0f000000U)
+                {
+                    encoding = GCNENC_SOPC;
+                    wordsNum += ssrc01;
+                }
+                else if (encPart == 0x0f800000U)
+                    encoding = GCNENC_SOPP;
+                else
+                {
+                    encoding = GCNENC_SOPK;
+                    const uint32_t opcode = ((insnCode>>23)&0x1f);
+                    wordsNum += ((!isGCN12 && opcode == 21) || (isGCN12 && opcode == 20));
+                }
+            }
+            else
+            {
+                encoding = GCNENC_SOP2;
+                wordsNum += ssrc01;
+            }
+        }
+        else
+        {
+            const uint32_t encPart = (insnCode&0x3c000000U)>>26;
+            encoding = isGCN12 ? refEncoding12Table[encPart] :
+                        refEncoding11Table[encPart];
+            if (encoding == GCNENC_FLAT && !isGCN11 && !isGCN12)
+                encoding = GCNENC_NONE;
+            else if (encoding != GCNENC_NONE && encoding != GCNENC_VINTRP &&
+                (isGCN12 || encoding != GCNENC_SMRD))
+                wordsNum++;
+        }
+    }
+    else
+    {
+        if ((insnCode & 0x7e000000U) == 0x7c000000U)
+            encoding = GCNENC_VOPC;
+        else if ((insnCode & 0x7e000000U) == 0x7e000000U)
+            encoding = GCNENC_VOP1;
+        else
+            encoding = GCNENC_VOP2;
+        const cxuint opcode = (insnCode >> 25)&0x3f;
+        if (encoding == GCNENC_VOP2 && ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
+            (isGCN12 && (opcode == 23 || opcode == 24 || opcode == 36 || opcode == 37))))
+            wordsNum++;
+        else
+            wordsNum += ((insnCode&0x1ff) == 0xff || vsrcExt);
+    }
+}
+
+// low bits of first dword to check literals, SDWA and DPP
+static const uint32_t lowBitsTable[] =
+{
+    0, 0x1, 0xf9, 0xfa, 0xff, 0x1f9, 0x1fa, 0x1ff, 0xff00, 0xffff, 0x12345, 0x7fffff
+};
+
+static void testGCNEncodingTables()
+{
+    for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+    {
+        const GCNEncodingEntry* table = getGCNEncodingTable(GPUArchitecture(arch));
+        for (uint32_t index = 0; index < GCNEncodingTableSize; index++)
+            for (uint32_t lowBits: lowBitsTable)
+            {
+                const uint32_t insnCode = (index<<23) | lowBits;
+                cxbyte expEncoding = GCNENC_NONE;
+                cxuint expWordsNum = 0;
+                refClassify(GPUArchitecture(arch), insnCode, expEncoding, expWordsNum);
+                const GCNEncodingEntry& entry = getGCNEncodingEntry(table, insnCode);
+                char caseName[64];
+                snprintf(caseName, sizeof caseName, "arch=%u,insn=0x%08x", arch,
+                         insnCode);
+                assertValue("GCNEncoding", std::string(caseName)+".encoding",
+                            cxuint(expEncoding), cxuint(entry.encoding));
+                assertValue("GCNEncoding", std::string(caseName)+".wordsNum",
+                            expWordsNum, getGCNInstrWordsNum(entry, insnCode));
+            }
+    }
+}
+
+struct GCNInstrCase
+{
+    GPUArchitecture arch;
+    uint32_t insnCode;
+    cxbyte encoding;
+    cxuint wordsNum;
+};
+
+static const GCNInstrCase gcnInstrCasesTable[] =
+{
+    { GPUArchitecture::GCN1_0, 0xbe8000ffU, GCNENC_SOP1, 2 }, // s_mov_b32 s0, lit
+    { GPUArchitecture::GCN1_0, 0xbe800001U, GCNENC_SOP1, 1 }, // s_mov_b32 s0, s1
+    { GPUArchitecture::GCN1_0, 0xbf810000U, GCNENC_SOPP, 1 }, // s_endpgm
+    { GPUArchitecture::GCN1_0, 0xba800000U, GCNENC_SOPK, 2 }, // s_setreg_imm32_b32
+    { GPUArchitecture::GCN1_2, 0xba000000U, GCNENC_SOPK, 2 }, // s_setreg_imm32_b32
+    { GPUArchitecture::GCN1_0, 0x40000000U, GCNENC_VOP2, 2 }, // v_madmk_f32
+    { GPUArchitecture::GCN1_2, 0x2e000000U, GCNENC_VOP2, 2 }, // v_madmk_f32
+    { GPUArchitecture::GCN1_0, 0x7e0002f9U, GCNENC_VOP1, 1 }, // no SDWA in GCN1.0
+    { GPUArchitecture::GCN1_2, 0x7e0002f9U, GCNENC_VOP1, 2 }, // SDWA
+    { GPUArchitecture::GCN1_4, 0x7c0002faU, GCNENC_VOPC, 2 }, // DPP
+    { GPUArchitecture::GCN1_0, 0xc0000000U, GCNENC_SMRD, 1 },
+    { GPUArchitecture::GCN1_2, 0xc0000000U, GCNENC_SMEM, 2 },
+    { GPUArchitecture::GCN1_0, 0xdc000000U, GCNENC_NONE, 1 }, // no FLAT in GCN1.0
+    { GPUArchitecture::GCN1_1, 0xdc000000U, GCNENC_FLAT, 2 },
+    { GPUArchitecture::GCN1_0, 0xd8000000U, GCNENC_DS, 2 },
+    { GPUArchitecture::GCN1_0, 0xf8000000U, GCNENC_EXP, 2 },
+    { GPUArchitecture::GCN1_2, 0xc4000000U, GCNENC_EXP, 2 }
+};
+
+static void testGCNInstrCases()
+{
+    for (const GCNInstrCase& testCase: gcnInstrCasesTable)
+    {
+        const GCNEncodingEntry& entry = getGCNEncodingEntry(
+                    getGCNEncodingTable(testCase.arch), testCase.insnCode);
+        char caseName[64];
+        snprintf(caseName, sizeof caseName, "arch=%u,insn=0x%08x",
+                 cxuint(testCase.arch), testCase.insnCode);
+        assertValue("GCNInstrCase", std::string(caseName)+".encoding",
+                    cxuint(testCase.encoding), cxuint(entry.encoding));
+        assertValue("GCNInstrCase", std::string(caseName)+".wordsNum",
+                    testCase.wordsNum, getGCNInstrWordsNum(entry, testCase.insnCode));
+    }
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testGCNEncodingTables);
+    retVal |= callTest(testGCNInstrCases);
+    return retVal;
+}
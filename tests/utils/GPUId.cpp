@@ -284,6 +284,77 @@ static void testGetGPUExtraRegsNum()
     }
 }
 
+struct GPUWavesRegsTestCase
+{
+    GPUArchitecture arch;
+    cxuint regType;
+    cxuint wavesNum;
+    cxuint regsNum;
+};
+
+// getGPUMaxRegsNumByWaves testcase table
+static const GPUWavesRegsTestCase gpuMaxRegsByWavesTestTable[] =
+{
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 10, 24 },
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 5, 48 },
+    { GPUArchitecture::GCN1_2, REGTYPE_VGPR, 4, 64 },
+    { GPUArchitecture::GCN1_4, REGTYPE_VGPR, 1, 256 },
+    { GPUArchitecture::GCN1_0, REGTYPE_SGPR, 10, 48 },
+    { GPUArchitecture::GCN1_1, REGTYPE_SGPR, 8, 64 },
+    { GPUArchitecture::GCN1_1, REGTYPE_SGPR, 4, 104 },
+    { GPUArchitecture::GCN1_2, REGTYPE_SGPR, 10, 80 },
+    { GPUArchitecture::GCN1_2, REGTYPE_SGPR, 9, 80 },
+    { GPUArchitecture::GCN1_4, REGTYPE_SGPR, 8, 96 },
+    { GPUArchitecture::GCN1_4, REGTYPE_SGPR, 7, 102 },
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 0, 256 },
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 20, 24 }
+};
+
+static void testGetGPUMaxRegsNumByWaves()
+{
+    char descBuf[60];
+    for (cxuint i = 0; i < sizeof gpuMaxRegsByWavesTestTable/
+                sizeof(GPUWavesRegsTestCase); i++)
+    {
+        const GPUWavesRegsTestCase testCase = gpuMaxRegsByWavesTestTable[i];
+        snprintf(descBuf, sizeof descBuf, "Test %d", i);
+        const cxuint result = getGPUMaxRegsNumByWaves(testCase.arch, testCase.regType,
+                                testCase.wavesNum);
+        assertValue("testGetGPUMaxRegsNumByWaves", descBuf,
+                    testCase.regsNum, result);
+    }
+}
+
+// getGPUWavesNumByRegsNum testcase table
+static const GPUWavesRegsTestCase gpuWavesByRegsTestTable[] =
+{
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 10, 0 },
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 10, 24 },
+    { GPUArchitecture::GCN1_0, REGTYPE_VGPR, 9, 25 },
+    { GPUArchitecture::GCN1_2, REGTYPE_VGPR, 4, 64 },
+    { GPUArchitecture::GCN1_4, REGTYPE_VGPR, 1, 256 },
+    { GPUArchitecture::GCN1_0, REGTYPE_SGPR, 10, 48 },
+    { GPUArchitecture::GCN1_1, REGTYPE_SGPR, 9, 49 },
+    { GPUArchitecture::GCN1_1, REGTYPE_SGPR, 4, 104 },
+    { GPUArchitecture::GCN1_2, REGTYPE_SGPR, 10, 80 },
+    { GPUArchitecture::GCN1_2, REGTYPE_SGPR, 8, 81 },
+    { GPUArchitecture::GCN1_4, REGTYPE_SGPR, 7, 102 }
+};
+
+static void testGetGPUWavesNumByRegsNum()
+{
+    char descBuf[60];
+    for (cxuint i = 0; i < sizeof gpuWavesByRegsTestTable/
+                sizeof(GPUWavesRegsTestCase); i++)
+    {
+        const GPUWavesRegsTestCase testCase = gpuWavesByRegsTestTable[i];
+        snprintf(descBuf, sizeof descBuf, "Test %d", i);
+        const cxuint result = getGPUWavesNumByRegsNum(testCase.arch, testCase.regType,
+                                testCase.regsNum);
+        assertValue("testGetGPUWavesNumByRegsNum", descBuf,
+                    testCase.wavesNum, result);
+    }
+}
 
 int main(int argc, const char** argv)
 {
@@ -292,6 +363,8 @@ int main(int argc, const char** argv)
     retVal |= callTest(testGetGPUArchitectureFromName);
     retVal |= callTest(testGetGPUMaxRegistersNum);
     retVal |= callTest(testGetGPUExtraRegsNum);
+    retVal |= callTest(testGetGPUMaxRegsNumByWaves);
+    retVal |= callTest(testGetGPUWavesNumByRegsNum);
     return retVal;
 }
 
@@ -0,0 +1,54 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testListDirectory()
+{
+    const char* testName = "testListDirectory";
+    std::string dirName = CLRX_SOURCE_DIR "/tests/amdbin/rocmbins";
+    filesystemPath(dirName); // convert to system path (native separators)
+    std::vector<std::string> names = listDirectory(dirName.c_str());
+    std::sort(names.begin(), names.end());
+    static const char* expectedNames[] = { "consttest1-kaveri.hsaco.regen",
+        "rijndael.hsaco.regen", "vectoradd-rocm.clo.regen" };
+    assertValue(testName, "namesNum", size_t(3), names.size());
+    for (size_t i = 0; i < 3; i++)
+        assertValue(testName, "name", std::string(expectedNames[i]), names[i]);
+    
+    std::string noDirName = CLRX_SOURCE_DIR "/tests/amdbin/nodirectory";
+    filesystemPath(noDirName);
+    assertCLRXException(testName, "noDirectory", "Can't open directory",
+                [&noDirName]() { listDirectory(noDirName.c_str()); });
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testListDirectory);
+    return retVal;
+}
@@ -0,0 +1,101 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <cstring>
+#include <utility>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static const char* mappedTestFile = CLRX_SOURCE_DIR "/tests/amdasm/amdbins/amd1.clo";
+
+static void testMappedFile(bool copyOnWrite)
+{
+    const char* testName = copyOnWrite ? "testMappedFileCOW" : "testMappedFile";
+    const Array<cxbyte> expected = loadDataFromFile(mappedTestFile);
+    MappedFile file(mappedTestFile, copyOnWrite);
+    assertValue(testName, "size", expected.size(), file.size());
+    assertTrue(testName, "isCopyOnWrite", file.isCopyOnWrite() == copyOnWrite);
+    assertTrue(testName, "data", ::memcmp(expected.data(), file.data(),
+                expected.size()) == 0);
+    if (copyOnWrite)
+    {
+        // changes must not be visible in file
+        file.data()[0] ^= 0xff;
+        file.data()[file.size()-1] ^= 0xff;
+        MappedFile file2(mappedTestFile);
+        assertTrue(testName, "fileNotChanged", ::memcmp(expected.data(), file2.data(),
+                expected.size()) == 0);
+    }
+    // move semantics
+    const cxbyte* data = file.data();
+    MappedFile file3(std::move(file));
+    assertTrue(testName, "movedEmpty", file.empty());
+    assertTrue(testName, "movedData", file3.data() == data);
+    file = std::move(file3);
+    assertTrue(testName, "moveAssignEmpty", file3.empty());
+    assertTrue(testName, "moveAssignData", file.data() == data);
+    file.reset();
+    assertTrue(testName, "resetEmpty", file.empty());
+    assertValue(testName, "resetSize", size_t(0), file.size());
+}
+
+static void testMappedFileErrors()
+{
+    assertCLRXException("testMappedFileErrors", "directory", "This is directory!",
+            []() { MappedFile file(CLRX_SOURCE_DIR "/tests"); });
+    assertCLRXException("testMappedFileErrors", "notExist",
+            "File or directory doesn't exists",
+            []() { MappedFile file(CLRX_SOURCE_DIR "/tests/xxxxxxxx-nofile"); });
+}
+
+static void testLoadMappedData()
+{
+    const char* testName = "testLoadMappedData";
+    const Array<cxbyte> expected = loadDataFromFile(mappedTestFile);
+    MappedFile file;
+    Array<cxbyte> data;
+    // regular file must be mapped
+    std::pair<cxbyte*, size_t> result = loadDataFromFile(mappedTestFile, file, data);
+    assertTrue(testName, "mapped", !file.empty() && data.empty());
+    assertTrue(testName, "mappedPtr", result.first == file.data());
+    assertValue(testName, "mappedSize", expected.size(), result.second);
+    assertTrue(testName, "mappedData", ::memcmp(expected.data(), result.first,
+                expected.size()) == 0);
+    assertTrue(testName, "readOnly", !file.isCopyOnWrite());
+    result = loadDataFromFile(mappedTestFile, file, data, true);
+    assertTrue(testName, "copyOnWrite", file.isCopyOnWrite());
+    assertValue(testName, "copyOnWriteSize", expected.size(), result.second);
+    assertCLRXException(testName, "notExist", "File or directory doesn't exists",
+            [&file, &data]()
+            { loadDataFromFile(CLRX_SOURCE_DIR "/tests/xxxxxxxx-nofile", file, data); });
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testMappedFile, false);
+    retVal |= callTest(testMappedFile, true);
+    retVal |= callTest(testMappedFileErrors);
+    retVal |= callTest(testLoadMappedData);
+    return retVal;
+}
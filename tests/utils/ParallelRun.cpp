@@ -0,0 +1,79 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <CLRX/utils/Utilities.h>
+#include "../TestUtils.h"
+
+using namespace CLRX;
+
+static void testGetHardwareThreadsNum()
+{
+    assertTrue("testGetHardwareThreadsNum", "not zero", getHardwareThreadsNum() != 0);
+}
+
+static void testRunParallel(size_t itemsNum, cxuint threadsNum)
+{
+    char descBuf[60];
+    snprintf(descBuf, sizeof descBuf, "Items %zu, threads %u", itemsNum, threadsNum);
+    std::vector<cxuint> results(itemsNum, 0);
+    runParallel(itemsNum, threadsNum, [&results](size_t i)
+    { results[i] += i*3+1; });
+    for (size_t i = 0; i < itemsNum; i++)
+        assertValue("testRunParallel", descBuf, cxuint(i*3+1), results[i]);
+}
+
+static void testRunParallelException(cxuint threadsNum)
+{
+    char descBuf[60];
+    snprintf(descBuf, sizeof descBuf, "Threads %u", threadsNum);
+    // exception from lowest item index must be rethrown
+    assertCLRXException("testRunParallelException", descBuf, "Fail 17",
+            [threadsNum]()
+            {
+                runParallel(100, threadsNum, [](size_t i)
+                {
+                    if (i == 17 || i == 56 || i == 93)
+                    {
+                        char buf[20];
+                        snprintf(buf, sizeof buf, "Fail %zu", i);
+                        throw Exception(buf);
+                    }
+                });
+            });
+}
+
+int main(int argc, const char** argv)
+{
+    int retVal = 0;
+    retVal |= callTest(testGetHardwareThreadsNum);
+    retVal |= callTest(testRunParallel, 0, 0);
+    retVal |= callTest(testRunParallel, 1, 4);
+    retVal |= callTest(testRunParallel, 10, 1);
+    retVal |= callTest(testRunParallel, 1000, 4);
+    retVal |= callTest(testRunParallel, 1000, 0);
+    retVal |= callTest(testRunParallel, 3, 8);
+    retVal |= callTest(testRunParallelException, 1);
+    retVal |= callTest(testRunParallelException, 4);
+    retVal |= callTest(testRunParallelException, 0);
+    return retVal;
+}
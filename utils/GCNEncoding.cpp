@@ -0,0 +1,179 @@
+/*
+ *  CLRadeonExtender - Unofficial OpenCL Radeon Extensions Library
+ *  Copyright (C) 2014-2018 Mateusz Szpakowski
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <CLRX/Config.h>
+#include <cstdint>
+#include <CLRX/utils/Utilities.h>
+#include <CLRX/utils/GPUId.h>
+#include <CLRX/utils/GCNEncoding.h>
+
+using namespace CLRX;
+
+// encodings of instructions with 11 in two highest bits (GCN1.0/1.1)
+static const cxbyte gcnEncoding11Table[16] =
+{
+    GCNENC_SMRD, // 0000
+    GCNENC_SMRD, // 0001
+    GCNENC_VINTRP, // 0010
+    GCNENC_NONE, // 0011 - illegal
+    GCNENC_VOP3A, // 0100
+    GCNENC_NONE, // 0101 - illegal
+    GCNENC_DS,   // 0110
+    GCNENC_FLAT, // 0111
+    GCNENC_MUBUF, // 1000
+    GCNENC_NONE,  // 1001 - illegal
+    GCNENC_MTBUF, // 1010
+    GCNENC_NONE,  // 1011 - illegal
+    GCNENC_MIMG,  // 1100
+    GCNENC_NONE,  // 1101 - illegal
+    GCNENC_EXP,   // 1110
+    GCNENC_NONE   // 1111 - illegal
+};
+
+// encodings of instructions with 11 in two highest bits (GCN1.2/1.4)
+static const cxbyte gcnEncoding12Table[16] =
+{
+    GCNENC_SMEM, // 0000
+    GCNENC_EXP, // 0001
+    GCNENC_NONE, // 0010 - illegal
+    GCNENC_NONE, // 0011 - illegal
+    GCNENC_VOP3A, // 0100
+    GCNENC_VINTRP, // 0101
+    GCNENC_DS,   // 0110
+    GCNENC_FLAT, // 0111
+    GCNENC_MUBUF, // 1000
+    GCNENC_NONE,  // 1001 - illegal
+    GCNENC_MTBUF, // 1010
+    GCNENC_NONE,  // 1011 - illegal
+    GCNENC_MIMG,  // 1100
+    GCNENC_NONE,  // 1101 - illegal
+    GCNENC_NONE,  // 1110 - illegal
+    GCNENC_NONE   // 1111 - illegal
+};
+
+// gcn encoding sizes table: true - if 8 byte encoding, false - 4 byte encoding
+// for GCN1.0/1.1
+static const bool gcnSize11Table[16] =
+{
+    false, // GCNENC_SMRD, // 0000
+    false, // GCNENC_SMRD, // 0001
+    false, // GCNENC_VINTRP, // 0010
+    false, // GCNENC_NONE, // 0011 - illegal
+    true,  // GCNENC_VOP3A, // 0100
+    false, // GCNENC_NONE, // 0101 - illegal
+    true,  // GCNENC_DS,   // 0110
+    true,  // GCNENC_FLAT, // 0111
+    true,  // GCNENC_MUBUF, // 1000
+    false, // GCNENC_NONE,  // 1001 - illegal
+    true,  // GCNENC_MTBUF, // 1010
+    false, // GCNENC_NONE,  // 1011 - illegal
+    true,  // GCNENC_MIMG,  // 1100
+    false, // GCNENC_NONE,  // 1101 - illegal
+    true,  // GCNENC_EXP,   // 1110
+    false // GCNENC_NONE   // 1111 - illegal
+};
+
+// for GCN1.2/1.4
+static const bool gcnSize12Table[16] =
+{
+    true,  // GCNENC_SMEM, // 0000
+    true,  // GCNENC_EXP, // 0001
+    false, // GCNENC_NONE, // 0010 - illegal
+    false, // GCNENC_NONE, // 0011 - illegal
+    true,  // GCNENC_VOP3A, // 0100
+    false, // GCNENC_VINTRP, // 0101
+    true,  // GCNENC_DS,   // 0110
+    true,  // GCNENC_FLAT, // 0111
+    true,  // GCNENC_MUBUF, // 1000
+    false, // GCNENC_NONE,  // 1001 - illegal
+    true,  // GCNENC_MTBUF, // 1010
+    false, // GCNENC_NONE,  // 1011 - illegal
+    true,  // GCNENC_MIMG,  // 1100
+    false, // GCNENC_NONE,  // 1101 - illegal
+    false, // GCNENC_NONE,  // 1110 - illegal
+    false  // GCNENC_NONE   // 1111 - illegal
+};
+
+// classify instruction by high 9 bits of first dword
+static GCNEncodingEntry classifyGCNEncoding(GPUArchitecture arch, cxuint index)
+{
+    const bool isGCN11 = (arch == GPUArchitecture::GCN1_1);
+    const bool isGCN12 = (arch >= GPUArchitecture::GCN1_2);
+    const cxbyte vsrcLiteral = isGCN12 ? GCNLIT_VSRC0_EXT : GCNLIT_VSRC0;
+    if ((index & 0x100) != 0)
+    {
+        if ((index & 0x80) == 0)
+        {
+            // SOP???
+            if ((index & 0x60) != 0x60)
+                return { GCNENC_SOP2, 1, GCNLIT_SSRC01 };
+            // SOP1/SOPK/SOPC/SOPP
+            const cxuint encPart = index & 0x1f;
+            if (encPart == 0x1d)
+                return { GCNENC_SOP1, 1, GCNLIT_SSRC0 };
+            if (encPart == 0x1e)
+                return { GCNENC_SOPC, 1, GCNLIT_SSRC01 };
+            if (encPart == 0x1f)
+                return { GCNENC_SOPP, 1, GCNLIT_NONE };
+            // SOPK: opcode is encPart, s_setreg_imm32_b32 has additional literal
+            const bool withLiteral = (!isGCN12 && encPart == 21) ||
+                    (isGCN12 && encPart == 20);
+            return { GCNENC_SOPK, cxbyte(withLiteral ? 2 : 1), GCNLIT_NONE };
+        }
+        // SMRD and others
+        const cxuint encPart = (index>>3) & 0xf;
+        if (isGCN12)
+            return { gcnEncoding12Table[encPart],
+                    cxbyte(gcnSize12Table[encPart] ? 2 : 1), GCNLIT_NONE };
+        if (encPart == 7 && !isGCN11)
+            return { GCNENC_NONE, 1, GCNLIT_NONE }; // FLAT is illegal in GCN1.0
+        return { gcnEncoding11Table[encPart],
+                cxbyte(gcnSize11Table[encPart] ? 2 : 1), GCNLIT_NONE };
+    }
+    // some vector instructions
+    if ((index & 0xfc) == 0xf8)
+        return { GCNENC_VOPC, 1, vsrcLiteral };
+    if ((index & 0xfc) == 0xfc)
+        return { GCNENC_VOP1, 1, vsrcLiteral };
+    // VOP2
+    const cxuint opcode = (index>>2) & 0x3f;
+    if ((!isGCN12 && (opcode == 32 || opcode == 33)) ||
+        (isGCN12 && (opcode == 23 || opcode == 24 ||
+        opcode == 36 || opcode == 37))) // V_MADMK and V_MADAK
+        return { GCNENC_VOP2, 2, GCNLIT_NONE }; // inline 32-bit constant
+    return { GCNENC_VOP2, 1, vsrcLiteral };
+}
+
+static OnceFlag gcnEncodingOnceFlag;
+// GCN encoding tables for all architectures (filled at first use)
+static GCNEncodingEntry gcnEncodingTables[cxuint(GPUArchitecture::GPUARCH_MAX)+1]
+                [GCNEncodingTableSize];
+
+static void initializeGCNEncodingTables()
+{
+    for (cxuint arch = 0; arch <= cxuint(GPUArchitecture::GPUARCH_MAX); arch++)
+        for (cxuint i = 0; i < GCNEncodingTableSize; i++)
+            gcnEncodingTables[arch][i] = classifyGCNEncoding(GPUArchitecture(arch), i);
+}
+
+const GCNEncodingEntry* CLRX::getGCNEncodingTable(GPUArchitecture arch)
+{
+    callOnce(gcnEncodingOnceFlag, initializeGCNEncodingTables);
+    return gcnEncodingTables[cxuint(arch)];
+}
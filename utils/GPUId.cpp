@@ -22,6 +22,7 @@
 #include <utility>
 #include <cstdint>
 #include <climits>
+#include <algorithm>
 #include <CLRX/utils/Utilities.h>
 #include <CLRX/utils/GPUId.h>
 
@@ -253,6 +254,53 @@ cxuint CLRX::getGPUMaxRegsNumByArchMask(uint16_t archMask, cxuint regType)
         return (archMask&(7U<<int(GPUArchitecture::GCN1_2))) ? 102 : 104;
 }
 
+// maximal number of waves per SIMD
+static const cxuint gpuMaxWavesNum = 10;
+
+// get size of register file (per SIMD, per lane for VGPRs) and allocation granularity
+static void getGPURegFileSize(GPUArchitecture architecture, cxuint regType,
+            cxuint& fileSize, cxuint& granule)
+{
+    if (architecture > GPUArchitecture::GPUARCH_MAX)
+        throw GPUIdException("Unknown GPU architecture");
+    if (regType == REGTYPE_VGPR)
+    {
+        fileSize = 256;
+        granule = 4;
+    }
+    else if (architecture >= GPUArchitecture::GCN1_2)
+    {
+        fileSize = 800;
+        granule = 16;
+    }
+    else
+    {
+        fileSize = 512;
+        granule = 8;
+    }
+}
+
+cxuint CLRX::getGPUMaxRegsNumByWaves(GPUArchitecture architecture, cxuint regType,
+              cxuint wavesNum)
+{
+    cxuint fileSize, granule;
+    getGPURegFileSize(architecture, regType, fileSize, granule);
+    wavesNum = std::max(cxuint(1), std::min(wavesNum, gpuMaxWavesNum));
+    const cxuint regsNum = (fileSize / wavesNum) & ~(granule-1);
+    return std::min(regsNum, getGPUMaxRegistersNum(architecture, regType, 0));
+}
+
+cxuint CLRX::getGPUWavesNumByRegsNum(GPUArchitecture architecture, cxuint regType,
+              cxuint regsNum)
+{
+    cxuint fileSize, granule;
+    getGPURegFileSize(architecture, regType, fileSize, granule);
+    if (regsNum == 0)
+        return gpuMaxWavesNum;
+    regsNum = (regsNum + granule-1) & ~(granule-1);
+    return std::min(fileSize / regsNum, gpuMaxWavesNum);
+}
+
 void CLRX::getGPUSetupMinRegistersNum(GPUArchitecture architecture, cxuint dimMask,
               cxuint userDataNum, Flags flags, cxuint* gprsOut)
 {
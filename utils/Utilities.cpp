@@ -27,7 +27,9 @@
 #include <shlobj.h>
 #else
 #include <pwd.h>
+#include <dirent.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #endif
@@ -35,6 +37,9 @@
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
 #include <cerrno>
 #include <cstring>
 #include <string>
@@ -394,6 +399,17 @@ bool CLRX::isDirectory(const char* path)
 #endif
 }
 
+bool CLRX::isSymbolicLink(const char* path)
+{
+#ifdef HAVE_WINDOWS
+    const DWORD attrs = GetFileAttributes(path);
+    return attrs!=INVALID_FILE_ATTRIBUTES && (attrs&FILE_ATTRIBUTE_REPARSE_POINT)!=0;
+#else
+    struct stat stBuf;
+    return ::lstat(path, &stBuf)==0 && S_ISLNK(stBuf.st_mode);
+#endif
+}
+
 /// returns true if file exists
 bool CLRX::isFileExists(const char* path)
 {
@@ -405,6 +421,45 @@ bool CLRX::isFileExists(const char* path)
 #endif
 }
 
+std::vector<std::string> CLRX::listDirectory(const char* dirname)
+{
+    std::vector<std::string> names;
+#ifdef HAVE_WINDOWS
+    WIN32_FIND_DATA findData;
+    const std::string pattern = joinPaths(dirname, "*");
+    HANDLE handle = FindFirstFile(pattern.c_str(), &findData);
+    if (handle == INVALID_HANDLE_VALUE)
+    {
+        if (GetLastError() == ERROR_FILE_NOT_FOUND)
+            return names; // empty directory
+        throw Exception("Can't open directory");
+    }
+    do {
+        const char* name = findData.cFileName;
+        if (::strcmp(name, ".") != 0 && ::strcmp(name, "..") != 0)
+            names.push_back(name);
+    } while (FindNextFile(handle, &findData));
+    FindClose(handle);
+#else
+    DIR* dir = ::opendir(dirname);
+    if (dir == nullptr)
+        throw Exception("Can't open directory");
+    errno = 0;
+    struct dirent* entry;
+    while ((entry = ::readdir(dir)) != nullptr)
+    {
+        const char* name = entry->d_name;
+        if (::strcmp(name, ".") != 0 && ::strcmp(name, "..") != 0)
+            names.push_back(name);
+    }
+    const bool failed = (errno != 0);
+    ::closedir(dir);
+    if (failed)
+        throw Exception("Can't read directory");
+#endif
+    return names;
+}
+
 Array<cxbyte> CLRX::loadDataFromFile(const char* filename)
 {
     uint64_t size;
@@ -463,6 +518,163 @@ Array<cxbyte> CLRX::loadDataFromFile(const char* filename)
     return buf;
 }
 
+/*
+ * memory mapped file
+ */
+
+MappedFile::MappedFile() : mapData(nullptr), mapSize(0), copyOnWrite(false)
+#ifdef HAVE_WINDOWS
+        , mapHandle(nullptr)
+#endif
+{ }
+
+MappedFile::MappedFile(const char* filename, bool _copyOnWrite)
+        : mapData(nullptr), mapSize(0), copyOnWrite(_copyOnWrite)
+#ifdef HAVE_WINDOWS
+        , mapHandle(nullptr)
+#endif
+{
+    if (isDirectory(filename))
+        throw Exception("This is directory!");
+#ifdef HAVE_WINDOWS
+    HANDLE file = CreateFile(filename, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw Exception("Can't open file");
+    LARGE_INTEGER fileSize;
+    if (GetFileType(file) != FILE_TYPE_DISK || !GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw Exception("Can't map file that is not regular file");
+    }
+    if (uint64_t(fileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(file);
+        throw Exception("File is too big to map");
+    }
+    mapSize = fileSize.QuadPart;
+    if (mapSize == 0)
+    {
+        // empty file can not be mapped
+        CloseHandle(file);
+        return;
+    }
+    mapHandle = CreateFileMapping(file, nullptr,
+                copyOnWrite ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapHandle == nullptr)
+        throw Exception("Can't map file");
+    mapData = reinterpret_cast<cxbyte*>(MapViewOfFile(mapHandle,
+                copyOnWrite ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+    if (mapData == nullptr)
+    {
+        CloseHandle(mapHandle);
+        mapHandle = nullptr;
+        throw Exception("Can't map file");
+    }
+#else
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+        throw Exception("Can't open file");
+    struct stat stBuf;
+    if (::fstat(fd, &stBuf) != 0 || !S_ISREG(stBuf.st_mode))
+    {
+        ::close(fd);
+        throw Exception("Can't map file that is not regular file");
+    }
+    if (uint64_t(stBuf.st_size) > SIZE_MAX)
+    {
+        ::close(fd);
+        throw Exception("File is too big to map");
+    }
+    mapSize = stBuf.st_size;
+    if (mapSize == 0)
+    {
+        // empty file can not be mapped
+        ::close(fd);
+        return;
+    }
+    void* ptr = ::mmap(nullptr, mapSize, copyOnWrite ? (PROT_READ|PROT_WRITE) : PROT_READ,
+                MAP_PRIVATE, fd, 0);
+    ::close(fd);  // mapping is still valid after closing
+    if (ptr == MAP_FAILED)
+    {
+        mapSize = 0;
+        throw Exception("Can't map file");
+    }
+    mapData = reinterpret_cast<cxbyte*>(ptr);
+#endif
+}
+
+MappedFile::MappedFile(MappedFile&& file) noexcept
+        : mapData(file.mapData), mapSize(file.mapSize), copyOnWrite(file.copyOnWrite)
+#ifdef HAVE_WINDOWS
+        , mapHandle(file.mapHandle)
+#endif
+{
+    file.mapData = nullptr;
+    file.mapSize = 0;
+#ifdef HAVE_WINDOWS
+    file.mapHandle = nullptr;
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+    reset();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& file) noexcept
+{
+    if (this == &file)
+        return *this;
+    reset();
+    mapData = file.mapData;
+    mapSize = file.mapSize;
+    copyOnWrite = file.copyOnWrite;
+    file.mapData = nullptr;
+    file.mapSize = 0;
+#ifdef HAVE_WINDOWS
+    mapHandle = file.mapHandle;
+    file.mapHandle = nullptr;
+#endif
+    return *this;
+}
+
+void MappedFile::reset()
+{
+#ifdef HAVE_WINDOWS
+    if (mapData != nullptr)
+        UnmapViewOfFile(mapData);
+    if (mapHandle != nullptr)
+        CloseHandle(mapHandle);
+    mapHandle = nullptr;
+#else
+    if (mapData != nullptr)
+        ::munmap(mapData, mapSize);
+#endif
+    mapData = nullptr;
+    mapSize = 0;
+}
+
+std::pair<cxbyte*, size_t> CLRX::loadDataFromFile(const char* filename,
+            MappedFile& mappedFile, Array<cxbyte>& data, bool copyOnWrite)
+{
+    mappedFile.reset();
+    data.clear();
+    try
+    {
+        mappedFile = MappedFile(filename, copyOnWrite);
+        return std::make_pair(mappedFile.data(), mappedFile.size());
+    }
+    catch(const Exception&)
+    {
+        // not regular file or can't be mapped
+        data = loadDataFromFile(filename);
+        return std::make_pair(data.data(), data.size());
+    }
+}
+
 void CLRX::filesystemPath(char* path)
 {
     while (*path != 0)  // change to native dir separator
@@ -804,3 +1016,49 @@ std::string CLRX::findLLVMConfig()
     }
     return "";
 }
+
+cxuint CLRX::getHardwareThreadsNum()
+{
+    const cxuint threadsNum = std::thread::hardware_concurrency();
+    return threadsNum!=0 ? threadsNum : 1;
+}
+
+void CLRX::runParallel(size_t itemsNum, cxuint threadsNum,
+            const std::function<void(size_t)>& func)
+{
+    if (threadsNum == 0)
+        threadsNum = getHardwareThreadsNum();
+    if (threadsNum > itemsNum)
+        threadsNum = itemsNum;
+    if (threadsNum <= 1)
+    {
+        // sequential run
+        for (size_t i = 0; i < itemsNum; i++)
+            func(i);
+        return;
+    }
+    
+    std::unique_ptr<std::exception_ptr[]> exceptions(new std::exception_ptr[itemsNum]);
+    std::atomic<size_t> nextItem(0);
+    auto worker = [&nextItem, &exceptions, &func, itemsNum]()
+    {
+        size_t i;
+        while ((i = nextItem.fetch_add(1)) < itemsNum)
+            try
+            { func(i); }
+            catch(...)
+            { exceptions[i] = std::current_exception(); }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(threadsNum-1);
+    for (cxuint t = 1; t < threadsNum; t++)
+        threads.push_back(std::thread(worker));
+    worker(); // current thread is also worker
+    for (std::thread& thread: threads)
+        thread.join();
+    
+    // rethrow first exception (by item index)
+    for (size_t i = 0; i < itemsNum; i++)
+        if (exceptions[i])
+            std::rethrow_exception(exceptions[i]);
+}